@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file           : pui_protocol.h
+ * @brief          : L431 CAN protocol: command queue, GPIO, status replies
+ ******************************************************************************
+ * The RX interrupt queues frames, the main loop (L431_ProcessQueue) applies
+ * them and queues the replies, the TX-complete interrupt refills the
+ * mailboxes. Only HAL calls are used, no peripheral init: main.c owns that.
+ ******************************************************************************
+ */
+
+#ifndef __PUI_PROTOCOL_H
+#define __PUI_PROTOCOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+// ==================== L431 CAN Protocol Defines ====================
+#define L431_RX_CAN_ID 0x100        // Receive from Android
+#define L431_TX_CAN_ID 0x101        // Send to Android (ACK)
+#define L431_SYNC_CAN_ID 0x080      // CANopen SYNC: status reply, no action
+// Broadcast is not 0x000: NMT Start [0x01, node] / Stop [0x02, node] there
+// would read as legacy power commands
+#define L431_BROADCAST_CAN_ID 0x102 // Every unit: v2 requests only, no reply
+
+// Command bytes
+#define CMD_POWER_ON 0x01  // PA9=HIGH, PA10=HIGH
+#define CMD_POWER_OFF 0x02 // PA5=HIGH, PA9=LOW, PA10=LOW
+#define CMD_HEARTBEAT 0x03 // Toggle PB6
+#define CMD_STATUS 0x04    // No action, status reply only
+
+// Acknowledgment bytes (legacy single-command frames)
+#define ACK_POWER_ON 0xAA
+#define ACK_POWER_OFF 0xBB
+#define ACK_HEARTBEAT 0xCC
+
+// Sequenced requests (app: l431_link.h)
+// RX: [0x80 | n] [seq] [cmd 1] .. [cmd n]   (n = 1..6)
+// TX: [0x5A] [seq] [executed | rejected << 4] [rails] [tick LE32]
+#define REQ_FLAG_V2 0x80
+#define REQ_COUNT_MASK 0x07
+#define REQ_MAX_COMMANDS 6
+#define REPLY_STATUS 0x5A
+#define REPLY_SYNC 0x5B // Same layout, seq = SYNC counter
+
+// ISR -> main loop and main loop -> mailbox queues (powers of two)
+#define CMD_QUEUE_SIZE 16
+#define TX_QUEUE_SIZE 16
+
+// Rails byte: output latch of each pin
+#define RAIL_PA5 0x01
+#define RAIL_PA9 0x02
+#define RAIL_PA10 0x04
+#define RAIL_PB6 0x08
+
+// Counters, read with the debugger
+typedef struct {
+  uint32_t framesQueued;
+  uint32_t framesDropped;  // Command queue full
+  uint32_t repliesQueued;
+  uint32_t repliesDropped; // TX queue full
+  uint32_t latencyLastUs;  // RX interrupt -> commands applied
+  uint32_t latencyMaxUs;
+} L431_Stats;
+
+extern CAN_HandleTypeDef hcan1;
+extern volatile L431_Stats puiStats;
+
+uint8_t L431_ProcessCommand(uint8_t cmd);
+void L431_ProcessRequest(const uint8_t *data, uint8_t dlc, uint8_t reply);
+void L431_ProcessQueue(void);
+uint8_t L431_RailState(void);
+void L431_SendAck(uint8_t ack_byte);
+void L431_SendStatus(uint8_t type, uint8_t seq, uint8_t executed,
+                     uint8_t rejected);
+void L431_QueueTx(const uint8_t *data, uint8_t dlc);
+void L431_PumpTx(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PUI_PROTOCOL_H */
@@ -21,7 +21,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "pui_protocol.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -31,19 +31,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-// ==================== L431 CAN Protocol Defines ====================
-#define L431_RX_CAN_ID 0x100 // Receive from Android
-#define L431_TX_CAN_ID 0x101 // Send to Android (ACK)
-
-// Command bytes
-#define CMD_POWER_ON 0x01  // PA9=HIGH, PA10=HIGH
-#define CMD_POWER_OFF 0x02 // PA5=HIGH, PA9=LOW, PA10=LOW
-#define CMD_HEARTBEAT 0x03 // Toggle PB6
-
-// Acknowledgment bytes
-#define ACK_POWER_ON 0xAA
-#define ACK_POWER_OFF 0xBB
-#define ACK_HEARTBEAT 0xCC
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -55,14 +43,7 @@
 CAN_HandleTypeDef hcan1;
 
 /* USER CODE BEGIN PV */
-// CAN RX structures
-CAN_RxHeaderTypeDef RxHeader;
-uint8_t RxData[8];
-
-// CAN TX structures
-CAN_TxHeaderTypeDef TxHeader;
-uint8_t TxData[8];
-uint32_t TxMailbox;
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -71,8 +52,6 @@ static void MX_GPIO_Init(void);
 static void MX_CAN1_Init(void);
 /* USER CODE BEGIN PFP */
 void CAN_Filter_Config(void);
-void L431_ProcessCommand(uint8_t cmd);
-void L431_SendAck(uint8_t ack_byte);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -111,7 +90,12 @@ int main(void) {
   MX_GPIO_Init();
   MX_CAN1_Init();
   /* USER CODE BEGIN 2 */
-  // Configure CAN Filter for L431 ID (0x100)
+  // Cycle counter for the RX -> GPIO latency
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  // Configure CAN Filter for the command, SYNC and broadcast IDs
   CAN_Filter_Config();
 
   // Start CAN peripheral
@@ -119,8 +103,9 @@ int main(void) {
     Error_Handler();
   }
 
-  // Enable CAN RX interrupt
-  if (HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING) !=
+  // RX interrupt queues frames; TX-complete refills the mailboxes
+  if (HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING |
+                                               CAN_IT_TX_MAILBOX_EMPTY) !=
       HAL_OK) {
     Error_Handler();
   }
@@ -137,6 +122,7 @@ int main(void) {
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    L431_ProcessQueue();
   }
   /* USER CODE END 3 */
 }
@@ -262,21 +248,22 @@ static void MX_GPIO_Init(void) {
 /* USER CODE BEGIN 4 */
 
 /**
- * @brief Configure CAN Filter to accept only L431 commands (ID = 0x100)
+ * @brief Configure CAN Filter to accept only the L431 IDs
+ *        One bank in 16-bit list mode holds four exact standard IDs:
+ *        commands (0x100), SYNC (0x080), broadcast (0x102).
  */
 void CAN_Filter_Config(void) {
   CAN_FilterTypeDef sFilterConfig;
 
   sFilterConfig.FilterBank = 0;
-  sFilterConfig.FilterMode = CAN_FILTERMODE_IDMASK;
-  sFilterConfig.FilterScale = CAN_FILTERSCALE_32BIT;
+  sFilterConfig.FilterMode = CAN_FILTERMODE_IDLIST;
+  sFilterConfig.FilterScale = CAN_FILTERSCALE_16BIT;
 
-  // Accept only CAN ID 0x100 (L431 commands)
-  sFilterConfig.FilterIdHigh =
-      (L431_RX_CAN_ID << 5); // Standard ID in high bits
-  sFilterConfig.FilterIdLow = 0x0000;
-  sFilterConfig.FilterMaskIdHigh = (0x7FF << 5); // Match exact ID
-  sFilterConfig.FilterMaskIdLow = 0x0000;
+  // 16-bit entry: STID[10:0] << 5 (RTR = 0, IDE = 0)
+  sFilterConfig.FilterIdHigh = (L431_RX_CAN_ID << 5);
+  sFilterConfig.FilterIdLow = (L431_SYNC_CAN_ID << 5);
+  sFilterConfig.FilterMaskIdHigh = (L431_BROADCAST_CAN_ID << 5);
+  sFilterConfig.FilterMaskIdLow = (L431_RX_CAN_ID << 5); // Unused slot
 
   sFilterConfig.FilterFIFOAssignment = CAN_FILTER_FIFO0;
   sFilterConfig.FilterActivation = ENABLE;
@@ -287,72 +274,6 @@ void CAN_Filter_Config(void) {
   }
 }
 
-/**
- * @brief Process received L431 command
- * @param cmd Command byte (0x01=ON, 0x02=OFF, 0x03=Heartbeat)
- */
-void L431_ProcessCommand(uint8_t cmd) {
-  switch (cmd) {
-  case CMD_POWER_ON:
-    // PA9=HIGH, PA10=HIGH, PA5=LOW
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_9 | GPIO_PIN_10, GPIO_PIN_SET);
-    L431_SendAck(ACK_POWER_ON);
-    break;
-
-  case CMD_POWER_OFF:
-    // PA5=HIGH, PA9=LOW, PA10=LOW
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_9 | GPIO_PIN_10, GPIO_PIN_RESET);
-    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);
-    L431_SendAck(ACK_POWER_OFF);
-    break;
-
-  case CMD_HEARTBEAT:
-    // Toggle PB6
-    HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_6);
-    L431_SendAck(ACK_HEARTBEAT);
-    break;
-
-  default:
-    // Unknown command - ignore
-    break;
-  }
-}
-
-/**
- * @brief Send acknowledgment to Android via CAN
- * @param ack_byte Acknowledgment byte to send
- */
-void L431_SendAck(uint8_t ack_byte) {
-  TxHeader.StdId = L431_TX_CAN_ID; // 0x101
-  TxHeader.ExtId = 0;
-  TxHeader.RTR = CAN_RTR_DATA;
-  TxHeader.IDE = CAN_ID_STD;
-  TxHeader.DLC = 1; // 1 byte
-  TxHeader.TransmitGlobalTime = DISABLE;
-
-  TxData[0] = ack_byte;
-
-  // Send (ignore errors for now)
-  HAL_CAN_AddTxMessage(&hcan1, &TxHeader, TxData, &TxMailbox);
-}
-
-/**
- * @brief CAN RX FIFO0 Message Pending Callback
- *        Called when a new CAN message arrives
- */
-void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
-  if (HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &RxHeader, RxData) == HAL_OK) {
-    // Verify it's our ID (filter should already do this)
-    if (RxHeader.StdId == L431_RX_CAN_ID) {
-      // Process the command (first byte)
-      if (RxHeader.DLC >= 1) {
-        L431_ProcessCommand(RxData[0]);
-      }
-    }
-  }
-}
-
 /* USER CODE END 4 */
 
 /**
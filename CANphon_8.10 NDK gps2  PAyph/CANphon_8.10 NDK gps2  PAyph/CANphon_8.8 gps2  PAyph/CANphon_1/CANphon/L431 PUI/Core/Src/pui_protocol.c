@@ -0,0 +1,305 @@
+/**
+ ******************************************************************************
+ * @file           : pui_protocol.c
+ * @brief          : L431 CAN protocol: command queue, GPIO, status replies
+ ******************************************************************************
+ */
+
+#include "pui_protocol.h"
+
+#include <string.h>
+
+// Frame taken from the RX FIFO by the ISR, processed in the main loop
+typedef struct {
+  uint16_t stdId;
+  uint8_t dlc;
+  uint8_t data[8];
+  uint32_t rxCycles; // DWT->CYCCNT at reception
+} L431_RxFrame;
+
+// Reply waiting for a free TX mailbox
+typedef struct {
+  uint8_t dlc;
+  uint8_t data[8];
+} L431_TxFrame;
+
+// Command queue: written by the RX ISR (head), drained by the main loop
+static L431_RxFrame cmdQueue[CMD_QUEUE_SIZE];
+static volatile uint8_t cmdHead = 0;
+static volatile uint8_t cmdTail = 0;
+
+// TX queue: filled by the main loop (head), moved to mailboxes by
+// L431_PumpTx from the main loop or the TX-complete interrupt (tail)
+static L431_TxFrame txQueue[TX_QUEUE_SIZE];
+static volatile uint8_t txHead = 0;
+static volatile uint8_t txTail = 0;
+
+volatile L431_Stats puiStats = {0};
+
+/**
+ * @brief Apply one L431 command
+ * @param cmd Command byte (0x01=ON, 0x02=OFF, 0x03=Heartbeat, 0x04=Status)
+ * @retval Legacy ACK byte, 0 for CMD_STATUS, 0xFF if unknown
+ */
+uint8_t L431_ProcessCommand(uint8_t cmd) {
+  switch (cmd) {
+  case CMD_POWER_ON:
+    // PA9=HIGH, PA10=HIGH, PA5=LOW
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_9 | GPIO_PIN_10, GPIO_PIN_SET);
+    return ACK_POWER_ON;
+
+  case CMD_POWER_OFF:
+    // PA5=HIGH, PA9=LOW, PA10=LOW
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_9 | GPIO_PIN_10, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);
+    return ACK_POWER_OFF;
+
+  case CMD_HEARTBEAT:
+    // Toggle PB6
+    HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_6);
+    return ACK_HEARTBEAT;
+
+  case CMD_STATUS:
+    return 0;
+
+  default:
+    // Unknown command - ignore
+    return 0xFF;
+  }
+}
+
+/**
+ * @brief Process one command frame
+ *        Sequenced request: every command in order, then one status reply.
+ *        Legacy frame: first byte is the command, 1-byte ACK.
+ * @param data  Frame data
+ * @param dlc   Frame length
+ * @param reply 0 for broadcast frames (no ACK / status)
+ */
+void L431_ProcessRequest(const uint8_t *data, uint8_t dlc, uint8_t reply) {
+  if (dlc < 1) {
+    return;
+  }
+
+  if ((data[0] & REQ_FLAG_V2) == 0) {
+    uint8_t ack = L431_ProcessCommand(data[0]);
+    if (reply && ack != 0 && ack != 0xFF) {
+      L431_SendAck(ack);
+    }
+    return;
+  }
+
+  uint8_t count = data[0] & REQ_COUNT_MASK;
+  if (dlc < 2 || count > REQ_MAX_COMMANDS || dlc < 2 + count) {
+    return;
+  }
+
+  uint8_t executed = 0;
+  uint8_t rejected = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (L431_ProcessCommand(data[2 + i]) == 0xFF) {
+      rejected++;
+    } else {
+      executed++;
+    }
+  }
+  if (reply) {
+    L431_SendStatus(REPLY_STATUS, data[1], executed, rejected);
+  }
+}
+
+/**
+ * @brief Main loop service: apply queued frames in arrival order, then
+ *        move queued replies into free mailboxes
+ */
+void L431_ProcessQueue(void) {
+  while (cmdTail != cmdHead) {
+    __DMB(); // Frame contents written before cmdHead
+    const L431_RxFrame *frame = &cmdQueue[cmdTail];
+
+    switch (frame->stdId) {
+    case L431_RX_CAN_ID:
+      L431_ProcessRequest(frame->data, frame->dlc, 1);
+      break;
+
+    case L431_BROADCAST_CAN_ID:
+      // Sequenced framing only: a stray legacy byte must not switch rails
+      if (frame->dlc >= 1 && (frame->data[0] & REQ_FLAG_V2) != 0) {
+        L431_ProcessRequest(frame->data, frame->dlc, 0);
+      }
+      break;
+
+    case L431_SYNC_CAN_ID:
+      L431_SendStatus(REPLY_SYNC, frame->dlc >= 1 ? frame->data[0] : 0, 0, 0);
+      break;
+
+    default:
+      break;
+    }
+
+    uint32_t us = (DWT->CYCCNT - frame->rxCycles) / (SystemCoreClock / 1000000U);
+    puiStats.latencyLastUs = us;
+    if (us > puiStats.latencyMaxUs) {
+      puiStats.latencyMaxUs = us;
+    }
+
+    cmdTail = (uint8_t)((cmdTail + 1) & (CMD_QUEUE_SIZE - 1));
+  }
+
+  L431_PumpTx();
+}
+
+/**
+ * @brief Output latch of the power rails and the heartbeat pin
+ * @retval RAIL_* bits
+ */
+uint8_t L431_RailState(void) {
+  uint32_t odrA = GPIOA->ODR;
+  uint8_t rails = 0;
+
+  if (odrA & GPIO_PIN_5) {
+    rails |= RAIL_PA5;
+  }
+  if (odrA & GPIO_PIN_9) {
+    rails |= RAIL_PA9;
+  }
+  if (odrA & GPIO_PIN_10) {
+    rails |= RAIL_PA10;
+  }
+  if (GPIOB->ODR & GPIO_PIN_6) {
+    rails |= RAIL_PB6;
+  }
+  return rails;
+}
+
+/**
+ * @brief Send acknowledgment to Android via CAN
+ * @param ack_byte Acknowledgment byte to send
+ */
+void L431_SendAck(uint8_t ack_byte) {
+  L431_QueueTx(&ack_byte, 1);
+}
+
+/**
+ * @brief Reply with the rail state
+ * @param type     REPLY_STATUS (request) or REPLY_SYNC
+ * @param seq      Sequence byte of the request / SYNC counter
+ * @param executed Commands applied
+ * @param rejected Unknown command bytes
+ */
+void L431_SendStatus(uint8_t type, uint8_t seq, uint8_t executed,
+                     uint8_t rejected) {
+  uint32_t tick = HAL_GetTick();
+  uint8_t data[8];
+
+  data[0] = type;
+  data[1] = seq;
+  data[2] = (uint8_t)((executed & 0x0F) | (rejected << 4));
+  data[3] = L431_RailState();
+  data[4] = (uint8_t)(tick & 0xFF);
+  data[5] = (uint8_t)((tick >> 8) & 0xFF);
+  data[6] = (uint8_t)((tick >> 16) & 0xFF);
+  data[7] = (uint8_t)((tick >> 24) & 0xFF);
+
+  L431_QueueTx(data, 8);
+}
+
+/**
+ * @brief Queue a reply on L431_TX_CAN_ID (main loop only)
+ * @param data Frame data
+ * @param dlc  Frame length (0-8)
+ */
+void L431_QueueTx(const uint8_t *data, uint8_t dlc) {
+  uint8_t next = (uint8_t)((txHead + 1) & (TX_QUEUE_SIZE - 1));
+  if (next == txTail) {
+    puiStats.repliesDropped++;
+    return;
+  }
+
+  txQueue[txHead].dlc = dlc;
+  memcpy(txQueue[txHead].data, data, dlc);
+  __DMB(); // Frame contents written before txHead
+  txHead = next;
+  puiStats.repliesQueued++;
+}
+
+/**
+ * @brief Move queued replies into free TX mailboxes
+ *        Called from the main loop and the TX-complete interrupt; interrupts
+ *        are masked so both never advance txTail at once.
+ */
+void L431_PumpTx(void) {
+  CAN_TxHeaderTypeDef header;
+  uint32_t mailbox;
+
+  header.StdId = L431_TX_CAN_ID; // 0x101
+  header.ExtId = 0;
+  header.RTR = CAN_RTR_DATA;
+  header.IDE = CAN_ID_STD;
+  header.TransmitGlobalTime = DISABLE;
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  while (txTail != txHead && HAL_CAN_GetTxMailboxesFreeLevel(&hcan1) > 0) {
+    L431_TxFrame *frame = &txQueue[txTail];
+    header.DLC = frame->dlc;
+    if (HAL_CAN_AddTxMessage(&hcan1, &header, frame->data, &mailbox) !=
+        HAL_OK) {
+      break;
+    }
+    txTail = (uint8_t)((txTail + 1) & (TX_QUEUE_SIZE - 1));
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+ * @brief CAN RX FIFO0 Message Pending Callback
+ *        Called when a new CAN message arrives. Only copies the FIFO into
+ *        the command queue; GPIO and replies happen in the main loop.
+ */
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
+  CAN_RxHeaderTypeDef header;
+
+  while (HAL_CAN_GetRxFifoFillLevel(hcan, CAN_RX_FIFO0) > 0) {
+    L431_RxFrame *frame = &cmdQueue[cmdHead];
+    if (HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &header, frame->data) !=
+        HAL_OK) {
+      break;
+    }
+    if (header.IDE != CAN_ID_STD) {
+      continue;
+    }
+
+    uint8_t next = (uint8_t)((cmdHead + 1) & (CMD_QUEUE_SIZE - 1));
+    if (next == cmdTail) {
+      puiStats.framesDropped++; // Slot is reused by the next frame
+      continue;
+    }
+
+    frame->stdId = (uint16_t)header.StdId;
+    frame->dlc = (uint8_t)header.DLC;
+    frame->rxCycles = DWT->CYCCNT;
+    __DMB(); // Frame contents written before cmdHead
+    cmdHead = next;
+    puiStats.framesQueued++;
+  }
+}
+
+/**
+ * @brief CAN TX mailbox complete callbacks: refill from the TX queue
+ */
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan) {
+  (void)hcan;
+  L431_PumpTx();
+}
+
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan) {
+  (void)hcan;
+  L431_PumpTx();
+}
+
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan) {
+  (void)hcan;
+  L431_PumpTx();
+}
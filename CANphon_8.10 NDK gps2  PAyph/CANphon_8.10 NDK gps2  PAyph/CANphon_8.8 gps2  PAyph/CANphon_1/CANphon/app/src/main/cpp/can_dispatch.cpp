@@ -0,0 +1,139 @@
+/**
+ * can_dispatch.cpp
+ * CAN Receive Dispatcher (C++)
+ *
+ * Replaces SharedBusManager.processFrame, which formatted a hex string
+ * and walked the node map for every received frame.
+ */
+
+#define LOG_TAG "NativeDispatch"
+#include "can_dispatch.h"
+#include "can_recorder.h"
+#include "native_log.h"
+#include "series_store.h"
+#include "servo_estimator.h"
+#include <cstdio>
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Dispatcher State
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    CanHandlerFn fn;
+    int arg;
+} CanHandler;
+
+static CanHandler handlers[CAN_STD_ID_COUNT];
+static CanDispatchShared shared;
+
+// Feedback scaling (matches CANServoProtocol.parsePositionFeedback)
+static const float FEEDBACK_RANGE_DEG = 50.0f;
+static const float FEEDBACK_MIN_DEG = -25.0f;
+static const float FEEDBACK_MAX_DEG = 25.0f;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Handlers
+// ═══════════════════════════════════════════════════════════════════════════
+
+// STM32 bridge feedback: [Pos_Low] [Pos_High] [Debug0] [Debug1] ...
+static void handleServoFeedback(const WsCanFrame* frame, int channel, int64_t nowMs) {
+    if (frame->dlc < 2) return;
+
+    int raw = frame->data[0] | (frame->data[1] << 8);
+    float angle = (float)raw / 16383.0f * FEEDBACK_RANGE_DEG + FEEDBACK_MIN_DEG;
+    if (angle < FEEDBACK_MIN_DEG) angle = FEEDBACK_MIN_DEG;
+    if (angle > FEEDBACK_MAX_DEG) angle = FEEDBACK_MAX_DEG;
+
+    CanServoState* s = &shared.servo[channel];
+    s->position = angle;
+    s->frames++;
+    s->lastFeedbackMs = nowMs;
+
+    int64_t nowUs = canRecorderNowUs();
+    servoEstimatorFeedback(channel, angle, nowUs);
+    seriesStoreAppend(SERIES_FEEDBACK(channel), nowUs, angle);
+}
+
+extern "C" void canDispatchClearHandlers() {
+    memset(handlers, 0, sizeof(handlers));
+}
+
+extern "C" void canDispatchReset() {
+    canDispatchClearHandlers();
+    memset(&shared, 0, sizeof(shared));
+    for (int i = 0; i < CAN_DISPATCH_MAX_CHANNELS; i++) {
+        shared.servo[i].position = CAN_FEEDBACK_NONE;
+    }
+    LOGI("✅ CAN dispatcher reset");
+}
+
+extern "C" int canDispatchSetHandler(uint32_t canId, CanHandlerFn handler, int arg) {
+    if (canId >= CAN_STD_ID_COUNT) return 0;
+    handlers[canId].fn = handler;
+    handlers[canId].arg = arg;
+    return 1;
+}
+
+extern "C" int canDispatchSetServoFeedback(uint32_t canId, int channel) {
+    if (channel < 0 || channel >= CAN_DISPATCH_MAX_CHANNELS) return 0;
+    return canDispatchSetHandler(canId, handleServoFeedback, channel);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Dispatch
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int canDispatchFrames(const WsCanFrame* frames, int count, int64_t nowMs) {
+    if (count <= 0) return 0;
+
+    int handled = 0;
+    for (int i = 0; i < count; i++) {
+        const WsCanFrame* f = &frames[i];
+        if (!(f->flags & WS_FLAG_EXT) && f->id < CAN_STD_ID_COUNT) {
+            const CanHandler* h = &handlers[f->id];
+            if (h->fn != nullptr) {
+                h->fn(f, h->arg, nowMs);
+                handled++;
+            }
+        }
+    }
+
+    // Debug view only needs the newest frame
+    const WsCanFrame* last = &frames[count - 1];
+    shared.lastId = last->id;
+    shared.lastDlc = last->dlc;
+    memcpy(shared.lastData, last->data, WS_MAX_DLC);
+
+    shared.framesTotal += count;
+    shared.framesUnhandled += count - handled;
+    return handled;
+}
+
+extern "C" CanDispatchShared* canDispatchShared() {
+    return &shared;
+}
+
+extern "C" int canDispatchOnlineMask(int channelCount, int64_t nowMs, int64_t timeoutMs) {
+    if (channelCount > CAN_DISPATCH_MAX_CHANNELS) channelCount = CAN_DISPATCH_MAX_CHANNELS;
+
+    int mask = 0;
+    for (int i = 0; i < channelCount; i++) {
+        const CanServoState* s = &shared.servo[i];
+        if (s->frames > 0 && nowMs - s->lastFeedbackMs < timeoutMs) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
+
+extern "C" int canDispatchFormatLastFrame(char* out, int outCapacity) {
+    if (outCapacity <= 0) return 0;
+
+    int len = snprintf(out, outCapacity, "ID:0x%X [", shared.lastId);
+    for (int i = 0; i < shared.lastDlc && len < outCapacity; i++) {
+        len += snprintf(out + len, outCapacity - len, i ? " %02X" : "%02X", shared.lastData[i]);
+    }
+    if (len < outCapacity) len += snprintf(out + len, outCapacity - len, "]");
+    return len < outCapacity ? len : outCapacity - 1;
+}
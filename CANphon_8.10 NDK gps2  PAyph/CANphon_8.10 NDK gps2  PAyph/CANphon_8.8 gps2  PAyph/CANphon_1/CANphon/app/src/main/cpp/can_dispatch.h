@@ -0,0 +1,97 @@
+/**
+ * can_dispatch.h
+ * CAN Receive Dispatcher (C++)
+ *
+ * Dense handler table indexed by 11-bit ID. Decoded frames go straight
+ * to their handler; servo feedback lands in a shared state block that
+ * Kotlin reads through a direct ByteBuffer (no per-frame JNI or objects).
+ *
+ * Single writer (the USB read thread), any number of readers.
+ */
+
+#ifndef CAN_DISPATCH_H
+#define CAN_DISPATCH_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAN_STD_ID_COUNT 2048
+#define CAN_DISPATCH_MAX_CHANNELS 16    // SharedBusManager.MAX_CHANNELS
+#define CAN_FEEDBACK_NONE (-999.9f)     // No feedback received yet
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Shared State (layout mirrored in SharedBusManager)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    float position;          // Degrees (-25 to +25), CAN_FEEDBACK_NONE until first frame
+    uint32_t frames;         // Feedback frames received
+    int64_t lastFeedbackMs;  // Receive time (caller's clock)
+} CanServoState;
+
+// Written by servo_estimator on the read thread (32 bytes per channel)
+typedef struct {
+    float commandDeg;        // Last command sent to the channel
+    float velocityDps;       // Filtered feedback velocity (deg/s)
+    float lagMs;             // Feedback trails the command trajectory by this much
+    float steadyErrorDeg;    // Command - feedback once settled
+    float trackingErrorDeg;  // Command - feedback, latest sample
+    float peakRateDps;       // Fastest slew seen (decays slowly)
+    uint32_t flags;          // SERVO_EST_* (servo_estimator.h)
+    uint32_t lagSamples;
+} CanServoEstimate;
+
+typedef struct {
+    CanServoState servo[CAN_DISPATCH_MAX_CHANNELS];
+    uint64_t framesTotal;
+    uint64_t framesUnhandled;  // No handler, or extended ID
+    uint32_t lastId;           // Last received frame (raw, formatted on demand)
+    uint8_t lastDlc;
+    uint8_t reserved[3];
+    uint8_t lastData[WS_MAX_DLC];
+    CanServoEstimate estimate[CAN_DISPATCH_MAX_CHANNELS];
+} CanDispatchShared;
+
+typedef void (*CanHandlerFn)(const WsCanFrame* frame, int arg, int64_t nowMs);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Handler Table
+// ═══════════════════════════════════════════════════════════════════════════
+// Not synchronized with canDispatchFrames: set up before any read thread runs
+
+// Clear all handlers and reset the shared state
+void canDispatchReset();
+
+// Remove all handlers (state is kept)
+void canDispatchClearHandlers();
+
+// Install a handler for one standard ID. Returns 0 if the ID is out of range
+int canDispatchSetHandler(uint32_t canId, CanHandlerFn handler, int arg);
+
+// Route position feedback on canId (0x580 + node) to a layout channel
+int canDispatchSetServoFeedback(uint32_t canId, int channel);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Dispatch
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Dispatch decoded frames. Returns number of frames that had a handler
+int canDispatchFrames(const WsCanFrame* frames, int count, int64_t nowMs);
+
+CanDispatchShared* canDispatchShared();
+
+// Bit N set if channel N had feedback within timeoutMs
+int canDispatchOnlineMask(int channelCount, int64_t nowMs, int64_t timeoutMs);
+
+// Format the last frame as "ID:0x581 [01 02 ...]". Returns string length
+int canDispatchFormatLastFrame(char* out, int outCapacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAN_DISPATCH_H
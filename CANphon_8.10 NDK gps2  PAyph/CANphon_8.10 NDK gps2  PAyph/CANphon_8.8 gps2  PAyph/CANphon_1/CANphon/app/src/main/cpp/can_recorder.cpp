@@ -0,0 +1,482 @@
+/**
+ * can_recorder.cpp
+ * CAN Bus Recorder (C++)
+ *
+ * Multi-producer ring: each logging call reserves its slots with one
+ * fetch_add and publishes every slot through a per-slot sequence number
+ * (seqlock), so the USB read thread and the command thread never wait on
+ * each other or on an export in progress.
+ */
+
+#define LOG_TAG "NativeRecorder"
+#include "can_recorder.h"
+#include "native_log.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <new>
+#include <vector>
+
+static_assert(sizeof(CanLogRecord) == 24, "CanLogRecord layout is part of the log format");
+static_assert(sizeof(CanLogFileHeader) == 16, "CanLogFileHeader layout is part of the log format");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Ring State
+// ═══════════════════════════════════════════════════════════════════════════
+
+// seq = 2*index+1 while slot `index` is written, 2*index+2 once published
+struct RecorderSlot {
+    std::atomic<uint64_t> seq;
+    CanLogRecord record;
+};
+
+#define EXPORT_CHUNK 1024   // Records copied per file write
+
+static RecorderSlot* ring = nullptr;
+static uint64_t ringCapacity = 0;
+static uint64_t ringMask = 0;
+
+// Indices only grow, so a slot left over from an earlier session can never
+// match the sequence number of a new one
+static std::atomic<uint64_t> writeIndex{0};
+static std::atomic<uint64_t> txCount{0};
+static std::atomic<bool> active{false};
+static uint64_t sessionStart = 0;
+static uint64_t sessionTxStart = 0;
+static uint64_t flushIndex = 0;
+static uint64_t flushLost = 0;
+
+// Serializes start/stop/export (never taken by the logging path)
+static std::mutex controlLock;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Recording
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int64_t clockUs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Monotonic clock shifted to the epoch once, so timestamps never step back
+extern "C" int64_t canRecorderNowUs() {
+    static const int64_t offsetUs = clockUs(CLOCK_REALTIME) - clockUs(CLOCK_MONOTONIC);
+    return clockUs(CLOCK_MONOTONIC) + offsetUs;
+}
+
+extern "C" int canRecorderStart(int capacity) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    active.store(false, std::memory_order_relaxed);
+
+    if (ring == nullptr) {
+        if (capacity <= 0) capacity = CAN_RECORDER_DEFAULT_CAPACITY;
+        uint64_t size = 1;
+        while (size < (uint64_t)capacity) size <<= 1;
+
+        ring = new (std::nothrow) RecorderSlot[size];
+        if (ring == nullptr) {
+            LOGW("Recorder: cannot allocate %llu frames", (unsigned long long)size);
+            return 0;
+        }
+        for (uint64_t i = 0; i < size; i++) ring[i].seq.store(0, std::memory_order_relaxed);
+        ringCapacity = size;
+        ringMask = size - 1;
+    }
+
+    canRecorderNowUs();  // Fix the clock offset before the first frame
+    sessionStart = writeIndex.load(std::memory_order_relaxed);
+    sessionTxStart = txCount.load(std::memory_order_relaxed);
+    flushIndex = sessionStart;
+    flushLost = 0;
+    active.store(true, std::memory_order_release);
+
+    LOGI("✅ CAN recorder started (%llu frames, %llu KB)", (unsigned long long)ringCapacity,
+         (unsigned long long)(ringCapacity * sizeof(RecorderSlot) / 1024));
+    return 1;
+}
+
+extern "C" void canRecorderStop() {
+    active.store(false, std::memory_order_relaxed);
+}
+
+extern "C" int canRecorderActive() {
+    return active.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+static inline void publish(uint64_t index, uint32_t id, uint8_t dlc, uint8_t flags,
+                           const void* data, int64_t timestampUs) {
+    RecorderSlot* slot = &ring[index & ringMask];
+    slot->seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    CanLogRecord* r = &slot->record;
+    r->timestampUs = timestampUs;
+    r->id = id;
+    r->dlc = dlc > WS_MAX_DLC ? WS_MAX_DLC : dlc;
+    r->flags = flags;
+    memcpy(r->data, data, WS_MAX_DLC);
+    r->reserved[0] = 0;
+    r->reserved[1] = 0;
+
+    slot->seq.store(2 * index + 2, std::memory_order_release);
+}
+
+// Reserve `count` slots (never more than the ring holds in one call)
+static inline bool reserve(int* count, int tx, uint64_t* first) {
+    if (*count <= 0 || !active.load(std::memory_order_acquire)) return false;
+    if ((uint64_t)*count > ringCapacity) *count = (int)ringCapacity;
+    *first = writeIndex.fetch_add(*count, std::memory_order_relaxed);
+    if (tx) txCount.fetch_add(*count, std::memory_order_relaxed);
+    return true;
+}
+
+extern "C" void canRecorderLogAt(const WsCanFrame* frames, int count, int tx, int64_t timestampUs) {
+    uint64_t first;
+    if (!reserve(&count, tx, &first)) return;
+
+    uint8_t dir = tx ? CAN_LOG_FLAG_TX : 0;
+    for (int i = 0; i < count; i++) {
+        const WsCanFrame* f = &frames[i];
+        publish(first + i, f->id, f->dlc, (uint8_t)(f->flags | dir), f->data, timestampUs);
+    }
+}
+
+extern "C" void canRecorderLog(const WsCanFrame* frames, int count, int tx) {
+    if (!active.load(std::memory_order_relaxed)) return;
+    canRecorderLogAt(frames, count, tx, canRecorderNowUs());
+}
+
+extern "C" void canRecorderLogPacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data, int count, int tx) {
+    if (!active.load(std::memory_order_relaxed)) return;
+    uint64_t first;
+    if (!reserve(&count, tx, &first)) return;
+
+    int64_t now = canRecorderNowUs();
+    uint8_t dir = tx ? CAN_LOG_FLAG_TX : 0;
+    for (int i = 0; i < count; i++) {
+        uint32_t id = (uint32_t)ids[i];
+        uint8_t flags = (uint8_t)((id > 0x7FF ? WS_FLAG_EXT : 0) | dir);
+        publish(first + i, id, (uint8_t)dlcs[i], flags, data + i * WS_MAX_DLC, now);
+    }
+}
+
+extern "C" void canRecorderGetStats(CanRecorderStats* outStats) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    uint64_t total = writeIndex.load(std::memory_order_relaxed) - sessionStart;
+    uint64_t tx = txCount.load(std::memory_order_relaxed) - sessionTxStart;
+
+    outStats->framesRecorded = total;
+    outStats->framesTx = tx;
+    outStats->framesRx = total - tx;
+    outStats->overwritten = total > ringCapacity ? total - ringCapacity : 0;
+    outStats->flushLost = flushLost;
+    outStats->capacity = ringCapacity;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Ring Readout (controlLock held)
+// ═══════════════════════════════════════════════════════════════════════════
+
+enum ReadResult { READ_OK, READ_PENDING, READ_OVERWRITTEN };
+
+static ReadResult readSlot(uint64_t index, CanLogRecord* out) {
+    const RecorderSlot* slot = &ring[index & ringMask];
+    uint64_t expected = 2 * index + 2;
+
+    uint64_t before = slot->seq.load(std::memory_order_acquire);
+    if (before < expected) return READ_PENDING;
+    if (before > expected) return READ_OVERWRITTEN;
+
+    memcpy(out, &slot->record, sizeof(*out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->seq.load(std::memory_order_relaxed) == expected ? READ_OK : READ_OVERWRITTEN;
+}
+
+// Oldest index the ring still holds for this session
+static uint64_t oldestIndex(uint64_t end) {
+    uint64_t oldest = end > ringCapacity ? end - ringCapacity : 0;
+    return oldest > sessionStart ? oldest : sessionStart;
+}
+
+// Copy [*from, end) into out[]; stops at the first frame still being written.
+// Returns records copied, advances *from past everything consumed
+static int readRange(uint64_t* from, uint64_t end, CanLogRecord* out, int maxRecords, uint64_t* lost) {
+    int count = 0;
+    while (*from < end && count < maxRecords) {
+        ReadResult r = readSlot(*from, &out[count]);
+        if (r == READ_PENDING) break;
+        if (r == READ_OK) {
+            count++;
+        } else if (lost != nullptr) {
+            (*lost)++;
+        }
+        (*from)++;
+    }
+    return count;
+}
+
+extern "C" int canRecorderSnapshot(CanLogRecord* out, int maxRecords) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    if (ring == nullptr) return 0;
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    uint64_t from = oldestIndex(end);
+    return readRange(&from, end, out, maxRecords, nullptr);
+}
+
+static FILE* openLog(const char* path, const char* mode) {
+    FILE* file = fopen(path, mode);
+    if (file == nullptr) LOGW("Cannot open %s", path);
+    return file;
+}
+
+static bool writeHeader(FILE* file) {
+    CanLogFileHeader header;
+    memcpy(header.magic, CAN_LOG_MAGIC, sizeof(header.magic));
+    header.recordSize = sizeof(CanLogRecord);
+    header.reserved = 0;
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+// Stream the ring (from its oldest frame) through writeChunk
+template <typename Writer>
+static int exportRing(Writer writeChunk) {
+    if (ring == nullptr) return 0;
+    std::vector<CanLogRecord> chunk(EXPORT_CHUNK);
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    uint64_t from = oldestIndex(end);
+
+    int total = 0;
+    for (;;) {
+        int n = readRange(&from, end, chunk.data(), EXPORT_CHUNK, nullptr);
+        if (n == 0) break;
+        if (!writeChunk(chunk.data(), n)) return -1;
+        total += n;
+    }
+    return total;
+}
+
+extern "C" int canRecorderSave(const char* path) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    FILE* file = openLog(path, "wb");
+    if (file == nullptr) return -1;
+
+    int total = writeHeader(file) ? exportRing([file](const CanLogRecord* r, int n) {
+        return fwrite(r, sizeof(*r), n, file) == (size_t)n;
+    }) : -1;
+    if (fclose(file) != 0) total = -1;
+    LOGI("Recorder: saved %d frames to %s", total, path);
+    return total;
+}
+
+extern "C" int canRecorderFlush(const char* path) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    if (ring == nullptr) return 0;
+
+    FILE* file = openLog(path, "ab");
+    if (file == nullptr) return -1;
+    bool ok = fseek(file, 0, SEEK_END) == 0 && (ftell(file) > 0 || writeHeader(file));
+
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    uint64_t oldest = oldestIndex(end);
+    if (flushIndex < oldest) {
+        flushLost += oldest - flushIndex;
+        flushIndex = oldest;
+    }
+
+    CanLogRecord chunk[EXPORT_CHUNK / 4];
+    int total = 0;
+    while (ok) {
+        int n = readRange(&flushIndex, end, chunk, EXPORT_CHUNK / 4, &flushLost);
+        if (n == 0) break;
+        ok = fwrite(chunk, sizeof(chunk[0]), n, file) == (size_t)n;
+        total += n;
+    }
+    if (fclose(file) != 0) ok = false;
+    return ok ? total : -1;
+}
+
+extern "C" int canRecorderExportCandump(const char* path, const char* iface) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    FILE* file = openLog(path, "w");
+    if (file == nullptr) return -1;
+
+    char line[CAN_LOG_LINE_MAX];
+    int total = exportRing([file, iface, &line](const CanLogRecord* r, int n) {
+        for (int i = 0; i < n; i++) {
+            int len = canLogFormatCandump(&r[i], iface, line, sizeof(line));
+            if (fwrite(line, 1, len, file) != (size_t)len) return false;
+        }
+        return true;
+    });
+    if (fclose(file) != 0) total = -1;
+    LOGI("Recorder: exported %d frames to %s", total, path);
+    return total;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// candump -l Text
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+extern "C" int canLogFormatCandump(const CanLogRecord* r, const char* iface, char* out, int capacity) {
+    if (capacity < CAN_LOG_LINE_MAX) return 0;
+
+    long long sec = (long long)(r->timestampUs / 1000000);
+    long long usec = (long long)(r->timestampUs % 1000000);
+    int ext = (r->flags & WS_FLAG_EXT) != 0;
+    int len = snprintf(out, capacity, ext ? "(%010lld.%06lld) %.16s %08X#" : "(%010lld.%06lld) %.16s %03X#",
+                       sec, usec, iface, ext ? (r->id & 0x1FFFFFFF) : (r->id & 0x7FF));
+
+    int dlc = r->dlc > WS_MAX_DLC ? WS_MAX_DLC : r->dlc;
+    if (r->flags & WS_FLAG_RTR) {
+        out[len++] = 'R';
+        if (dlc > 0) out[len++] = (char)('0' + dlc);
+    } else {
+        for (int i = 0; i < dlc; i++) {
+            out[len++] = HEX_DIGITS[r->data[i] >> 4];
+            out[len++] = HEX_DIGITS[r->data[i] & 0x0F];
+        }
+    }
+    out[len++] = ' ';
+    out[len++] = (r->flags & CAN_LOG_FLAG_TX) ? 'T' : 'R';
+    out[len++] = '\n';
+    out[len] = '\0';
+    return len;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static const char* skipSpaces(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+extern "C" int canLogParseCandump(const char* line, CanLogRecord* out) {
+    const char* p = skipSpaces(line);
+    if (*p != '(') return 0;
+
+    // (seconds.fraction)
+    char* end;
+    long long sec = strtoll(p + 1, &end, 10);
+    if (*end != '.') return 0;
+    p = end + 1;
+    long long usec = 0;
+    int digits = 0;
+    for (; *p >= '0' && *p <= '9'; p++, digits++) {
+        if (digits < 6) usec = usec * 10 + (*p - '0');
+    }
+    for (; digits < 6; digits++) usec *= 10;
+    if (*p != ')') return 0;
+
+    // Interface name (not kept)
+    p = skipSpaces(p + 1);
+    while (*p != '\0' && *p != ' ' && *p != '\t') p++;
+    p = skipSpaces(p);
+
+    // <id>#<data> | <id>#R[len] ; CAN FD (<id>##<flags><data>) is skipped
+    memset(out, 0, sizeof(*out));
+    int idDigits = 0;
+    for (int v; (v = hexValue(*p)) >= 0; p++, idDigits++) out->id = (out->id << 4) | (uint32_t)v;
+    if (*p != '#' || idDigits == 0 || idDigits > 8) return 0;
+    p++;
+    if (*p == '#') return 0;
+    if (idDigits > 3) out->flags |= WS_FLAG_EXT;
+
+    if (*p == 'R' || *p == 'r') {
+        out->flags |= WS_FLAG_RTR;
+        p++;
+        if (*p >= '0' && *p <= '8') out->dlc = (uint8_t)(*p++ - '0');
+    } else {
+        while (out->dlc < WS_MAX_DLC) {
+            if (*p == '.') p++;
+            int hi = hexValue(p[0]);
+            int lo = hi < 0 ? -1 : hexValue(p[1]);
+            if (lo < 0) break;
+            out->data[out->dlc++] = (uint8_t)((hi << 4) | lo);
+            p += 2;
+        }
+    }
+
+    p = skipSpaces(p);
+    if (*p == 'T') out->flags |= CAN_LOG_FLAG_TX;
+    out->timestampUs = sec * 1000000 + usec;
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Log Files
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" CanLogRecord* canLogLoad(const char* path, int* outCount) {
+    *outCount = 0;
+    FILE* file = openLog(path, "rb");
+    if (file == nullptr) return nullptr;
+
+    std::vector<CanLogRecord> records;
+    CanLogFileHeader header;
+    bool binary = fread(&header, sizeof(header), 1, file) == 1 &&
+                  memcmp(header.magic, CAN_LOG_MAGIC, sizeof(header.magic)) == 0;
+
+    if (binary) {
+        if (header.recordSize != sizeof(CanLogRecord)) {
+            LOGW("%s: record size %u, expected %zu", path, header.recordSize, sizeof(CanLogRecord));
+            fclose(file);
+            return nullptr;
+        }
+        CanLogRecord chunk[EXPORT_CHUNK / 4];
+        size_t n;
+        while ((n = fread(chunk, sizeof(chunk[0]), EXPORT_CHUNK / 4, file)) > 0) {
+            records.insert(records.end(), chunk, chunk + n);
+        }
+    } else {
+        rewind(file);
+        char line[256];
+        CanLogRecord r;
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            if (canLogParseCandump(line, &r)) records.push_back(r);
+        }
+    }
+    fclose(file);
+
+    CanLogRecord* result = (CanLogRecord*)malloc((records.size() > 0 ? records.size() : 1) * sizeof(CanLogRecord));
+    if (result == nullptr) return nullptr;
+    if (!records.empty()) memcpy(result, records.data(), records.size() * sizeof(CanLogRecord));
+    *outCount = (int)records.size();
+    return result;
+}
+
+extern "C" void canLogFree(CanLogRecord* records) {
+    free(records);
+}
+
+extern "C" int canLogSave(const char* path, const CanLogRecord* records, int count) {
+    FILE* file = openLog(path, "wb");
+    if (file == nullptr) return -1;
+    bool ok = writeHeader(file) && fwrite(records, sizeof(CanLogRecord), count, file) == (size_t)count;
+    if (fclose(file) != 0) ok = false;
+    return ok ? 0 : -1;
+}
+
+extern "C" int canLogExportCandump(const char* path, const CanLogRecord* records, int count, const char* iface) {
+    FILE* file = openLog(path, "w");
+    if (file == nullptr) return -1;
+
+    char line[CAN_LOG_LINE_MAX];
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++) {
+        int len = canLogFormatCandump(&records[i], iface, line, sizeof(line));
+        ok = fwrite(line, 1, len, file) == (size_t)len;
+    }
+    if (fclose(file) != 0) ok = false;
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,125 @@
+/**
+ * can_recorder.h
+ * CAN Bus Recorder (C++)
+ *
+ * Timestamps every frame sent to / received from the bus into a fixed
+ * in-memory ring. Writers never block or allocate; the ring is dumped
+ * to a binary log or exported as `candump -l` text on demand.
+ *
+ * Binary log: CanLogFileHeader followed by CanLogRecord[] (native endian).
+ * candump -l: "(1436509052.249713) can0 581#2A1F000000000000 R"
+ *             (trailing T/R = direction, as written by candump -l -x)
+ */
+
+#ifndef CAN_RECORDER_H
+#define CAN_RECORDER_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAN_LOG_FLAG_TX 0x80              // Record flags: WS_FLAG_EXT | WS_FLAG_RTR | CAN_LOG_FLAG_TX
+#define CAN_RECORDER_DEFAULT_CAPACITY 65536  // Frames (~16 s at 4 kframes/s), 1.5 MB
+#define CAN_LOG_MAGIC "CANPLOG1"
+#define CAN_LOG_LINE_MAX 72               // Longest candump -l line (with a 16-char iface)
+
+typedef struct {
+    int64_t timestampUs;    // Wall clock (microseconds since the epoch)
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t flags;
+    uint8_t data[WS_MAX_DLC];
+    uint8_t reserved[2];
+} CanLogRecord;             // 24 bytes
+
+typedef struct {
+    char magic[8];          // CAN_LOG_MAGIC
+    uint32_t recordSize;    // sizeof(CanLogRecord)
+    uint32_t reserved;
+} CanLogFileHeader;
+
+typedef struct {
+    uint64_t framesRecorded;
+    uint64_t framesTx;
+    uint64_t framesRx;
+    uint64_t overwritten;   // Older frames the ring no longer holds
+    uint64_t flushLost;     // Overwritten before canRecorderFlush() saved them
+    uint64_t capacity;
+} CanRecorderStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Recording
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Start (or restart) recording into an empty ring. The ring is allocated on
+// the first start (capacity rounded up to a power of two) and kept after.
+// Returns 1 on success
+int canRecorderStart(int capacity);
+
+void canRecorderStop();
+
+int canRecorderActive();
+
+// Record frames with the current time. No-op while stopped.
+// Safe from any number of threads
+void canRecorderLog(const WsCanFrame* frames, int count, int tx);
+
+// Same with an explicit timestamp (replay, synthetic logs)
+void canRecorderLogAt(const WsCanFrame* frames, int count, int tx, int64_t timestampUs);
+
+// Flat-array variant (JNI): ids[count], dlcs[count], data[count * 8]
+void canRecorderLogPacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data, int count, int tx);
+
+// Wall-clock microseconds, monotonic while the process runs
+int64_t canRecorderNowUs();
+
+void canRecorderGetStats(CanRecorderStats* outStats);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Export
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Copy up to maxRecords of the oldest frames still in the ring.
+// Returns records copied
+int canRecorderSnapshot(CanLogRecord* out, int maxRecords);
+
+// Write the ring as a binary log. Returns records written, -1 on I/O error
+int canRecorderSave(const char* path);
+
+// Append frames recorded since the previous flush (creates the file with
+// a header). Call periodically to persist a long session.
+// Returns records appended, -1 on I/O error
+int canRecorderFlush(const char* path);
+
+// Write the ring as candump -l text on interface `iface` (e.g. "can0")
+int canRecorderExportCandump(const char* path, const char* iface);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Log Files
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Format one record as a candump -l line (with '\n'). Returns length
+int canLogFormatCandump(const CanLogRecord* record, const char* iface, char* out, int capacity);
+
+// Parse one candump -l line. Returns 1 on success, 0 for comments,
+// CAN FD and malformed lines
+int canLogParseCandump(const char* line, CanLogRecord* out);
+
+// Load a binary or candump -l log (detected from the content).
+// Returns a malloc'd array (free with canLogFree), NULL on error
+CanLogRecord* canLogLoad(const char* path, int* outCount);
+
+void canLogFree(CanLogRecord* records);
+
+// Write records as a binary log / candump -l text. Returns 0, -1 on I/O error
+int canLogSave(const char* path, const CanLogRecord* records, int count);
+int canLogExportCandump(const char* path, const CanLogRecord* records, int count, const char* iface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAN_RECORDER_H
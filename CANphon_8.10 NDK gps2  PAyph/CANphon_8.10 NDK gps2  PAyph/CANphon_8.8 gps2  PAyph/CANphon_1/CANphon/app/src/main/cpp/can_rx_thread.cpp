@@ -0,0 +1,217 @@
+/**
+ * can_rx_thread.cpp
+ * Native CAN Receive Thread (C++)
+ *
+ * Transport → can_dispatch without crossing JNI. Per wakeup the thread
+ * does one wait, one decode of everything buffered and one dispatch call.
+ */
+
+#define LOG_TAG "NativeCanRx"
+#include "can_rx_thread.h"
+#include "can_dispatch.h"
+#include "can_recorder.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include "thread_sched.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Thread State
+// ═══════════════════════════════════════════════════════════════════════════
+
+static pthread_mutex_t controlLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t sendLock = PTHREAD_MUTEX_INITIALIZER;   // Sends vs close on stop
+static pthread_t thread;
+static bool started = false;
+
+static CanTransport* transport = nullptr;
+static CanRxThreadConfig config;
+static std::atomic<bool> stopRequested(false);
+static std::atomic<bool> running(false);
+
+// Written by the thread only
+static std::atomic<uint64_t> wakeups(0);
+static std::atomic<uint64_t> timeouts(0);
+static std::atomic<uint64_t> frames(0);
+static std::atomic<uint64_t> errors(0);
+static std::atomic<int32_t> threadTid(0);
+static std::atomic<int32_t> realtime(0);
+
+static int64_t startUs = 0;
+static std::atomic<int64_t> stopUs(0);
+static std::atomic<int64_t> cpuTimeAtExitUs(0);
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t threadCpuUs(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Receive Loop
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void* receiveLoop(void*) {
+    int tid = (int)syscall(SYS_gettid);
+    threadTid.store(tid, std::memory_order_relaxed);
+    realtime.store(threadApplyScheduling(tid, config.niceValue, config.rtPriority, config.cpuMask),
+                   std::memory_order_relaxed);
+
+    traceSetThreadName("can-rx");
+
+    WsCanFrame batch[CAN_TRANSPORT_MAX_BATCH];
+    int consecutiveErrors = 0;
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        int n = canTransportReceive(transport, batch, CAN_TRANSPORT_MAX_BATCH, config.timeoutMs);
+        if (n > 0) {
+            TRACE_ZONE("can.rx.dispatch");
+            TRACE_COUNTER("can.rx.batch", n);
+            canDispatchFrames(batch, n, canRecorderNowUs() / 1000);
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+            frames.fetch_add((uint64_t)n, std::memory_order_relaxed);
+            consecutiveErrors = 0;
+        } else if (n == 0) {
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+            consecutiveErrors = 0;
+        } else {
+            errors.fetch_add(1, std::memory_order_relaxed);
+            if (++consecutiveErrors >= CAN_RX_MAX_ERRORS) {
+                LOGW("❌ %s: %d receive errors in a row, stopping", canTransportName(transport), consecutiveErrors);
+                break;
+            }
+            usleep(10000);
+        }
+    }
+
+    cpuTimeAtExitUs = threadCpuUs(CLOCK_THREAD_CPUTIME_ID);
+    stopUs = monotonicUs();
+    running.store(false, std::memory_order_release);
+    return nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void canRxThreadDefaultConfig(CanRxThreadConfig* c) {
+    c->niceValue = CAN_RX_DEFAULT_NICE;
+    c->rtPriority = 0;
+    c->cpuMask = 0;
+    c->timeoutMs = CAN_RX_DEFAULT_TIMEOUT_MS;
+}
+
+extern "C" int canRxThreadStart(CanTransport* t, const CanRxThreadConfig* c) {
+    if (t == nullptr) return 0;
+
+    pthread_mutex_lock(&controlLock);
+    if (started) {
+        pthread_mutex_unlock(&controlLock);
+        LOGW("Receive thread already running");
+        return 0;
+    }
+
+    pthread_mutex_lock(&sendLock);
+    transport = t;
+    pthread_mutex_unlock(&sendLock);
+    if (c != nullptr) config = *c;
+    else canRxThreadDefaultConfig(&config);
+    if (config.timeoutMs <= 0) config.timeoutMs = CAN_RX_DEFAULT_TIMEOUT_MS;
+    canTransportSetRecording(t, 1);
+
+    wakeups = 0;
+    timeouts = 0;
+    frames = 0;
+    errors = 0;
+    threadTid = 0;
+    realtime = 0;
+    cpuTimeAtExitUs = 0;
+    stopRequested = false;
+    running = true;
+    startUs = monotonicUs();
+
+    if (pthread_create(&thread, nullptr, receiveLoop, nullptr) != 0) {
+        running = false;
+        pthread_mutex_lock(&sendLock);
+        transport = nullptr;
+        pthread_mutex_unlock(&sendLock);
+        pthread_mutex_unlock(&controlLock);
+        LOGW("❌ pthread_create failed: %s", strerror(errno));
+        return 0;
+    }
+    started = true;
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("✅ Receive thread on %s (nice %d, rt %d, cpus 0x%X)",
+         canTransportName(t), config.niceValue, config.rtPriority, config.cpuMask);
+    return 1;
+}
+
+extern "C" void canRxThreadStop() {
+    pthread_mutex_lock(&controlLock);
+    if (!started) {
+        pthread_mutex_unlock(&controlLock);
+        return;
+    }
+
+    stopRequested = true;
+    pthread_join(thread, nullptr);
+    started = false;
+
+    pthread_mutex_lock(&sendLock);
+    canTransportClose(transport);
+    transport = nullptr;
+    pthread_mutex_unlock(&sendLock);
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("Receive thread stopped: %llu frames, %llu wakeups, cpu %lld us",
+         (unsigned long long)frames.load(), (unsigned long long)wakeups.load(), (long long)cpuTimeAtExitUs.load());
+}
+
+extern "C" int canRxThreadRunning() {
+    return running.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+extern "C" int canRxThreadSend(const WsCanFrame* batch, int count) {
+    pthread_mutex_lock(&sendLock);
+    int sent = transport != nullptr && running.load(std::memory_order_acquire)
+                   ? canTransportSend(transport, batch, count)
+                   : -1;
+    pthread_mutex_unlock(&sendLock);
+    return sent;
+}
+
+extern "C" void canRxThreadGetStats(CanRxThreadStats* out) {
+    pthread_mutex_lock(&controlLock);
+    out->wakeups = wakeups.load(std::memory_order_relaxed);
+    out->timeouts = timeouts.load(std::memory_order_relaxed);
+    out->frames = frames.load(std::memory_order_relaxed);
+    out->errors = errors.load(std::memory_order_relaxed);
+    out->tid = threadTid.load(std::memory_order_relaxed);
+    out->realtime = realtime.load(std::memory_order_relaxed);
+    out->running = canRxThreadRunning();
+
+    // CPU time of the live thread is read through its clock, no work in the loop
+    out->cpuTimeUs = cpuTimeAtExitUs.load(std::memory_order_relaxed);
+    out->runTimeUs = 0;
+    if (started) {
+        clockid_t clock;
+        if (out->running && pthread_getcpuclockid(thread, &clock) == 0) out->cpuTimeUs = threadCpuUs(clock);
+        out->runTimeUs = (out->running ? monotonicUs() : stopUs.load()) - startUs;
+    } else if (startUs != 0) {
+        out->runTimeUs = stopUs.load() - startUs;
+    }
+    pthread_mutex_unlock(&controlLock);
+}
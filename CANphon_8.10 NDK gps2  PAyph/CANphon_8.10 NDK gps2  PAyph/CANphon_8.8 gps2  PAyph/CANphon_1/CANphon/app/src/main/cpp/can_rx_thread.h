@@ -0,0 +1,68 @@
+/**
+ * can_rx_thread.h
+ * Native CAN Receive Thread (C++)
+ *
+ * Replaces the Kotlin readExecutor in SharedBusManager: one native thread
+ * waits on the transport, decodes and dispatches every frame into
+ * can_dispatch's shared buffer. Kotlin only reads that snapshot.
+ *
+ * The thread runs with its own nice value (or SCHED_FIFO when allowed)
+ * and an optional CPU affinity mask.
+ */
+
+#ifndef CAN_RX_THREAD_H
+#define CAN_RX_THREAD_H
+
+#include <cstdint>
+#include "can_transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAN_RX_DEFAULT_NICE (-8)            // Process.THREAD_PRIORITY_URGENT_DISPLAY
+#define CAN_RX_DEFAULT_TIMEOUT_MS 100       // Receive wait, bounds stop latency
+#define CAN_RX_MAX_ERRORS 50                // Consecutive errors before the thread exits
+
+typedef struct {
+    int niceValue;          // setpriority() value (-20..19), used without SCHED_FIFO
+    int rtPriority;         // SCHED_FIFO priority (1..99), 0 = normal scheduling
+    uint32_t cpuMask;       // Bit N = may run on CPU N, 0 = any CPU
+    int timeoutMs;
+} CanRxThreadConfig;
+
+typedef struct {
+    uint64_t wakeups;       // Receive calls that returned frames
+    uint64_t timeouts;
+    uint64_t frames;
+    uint64_t errors;
+    int64_t cpuTimeUs;      // Thread CPU time
+    int64_t runTimeUs;      // Wall time since start
+    int32_t tid;
+    int32_t realtime;       // 1 = SCHED_FIFO granted
+    int32_t running;
+} CanRxThreadStats;
+
+void canRxThreadDefaultConfig(CanRxThreadConfig* config);
+
+// Start the thread on `t` (ownership passes to the thread; closed on stop).
+// Frames received are recorded when can_recorder is running.
+// Returns 1 on success, 0 if already running or the thread cannot start
+int canRxThreadStart(CanTransport* t, const CanRxThreadConfig* config);
+
+// Stop and join (returns within timeoutMs), close the transport
+void canRxThreadStop();
+
+int canRxThreadRunning();
+
+// Send on the thread's transport (the transport's one sender, e.g. the
+// control thread). Returns frames sent, -1 if not running or on error
+int canRxThreadSend(const WsCanFrame* frames, int count);
+
+void canRxThreadGetStats(CanRxThreadStats* outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAN_RX_THREAD_H
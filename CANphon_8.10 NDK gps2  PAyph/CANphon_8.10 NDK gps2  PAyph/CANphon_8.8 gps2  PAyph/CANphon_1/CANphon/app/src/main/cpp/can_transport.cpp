@@ -0,0 +1,532 @@
+/**
+ * can_transport.cpp
+ * CAN Transport Interface (C++)
+ *
+ * Each backend derives from CanTransport; the C API dispatches through
+ * the virtual calls so callers never see the concrete type.
+ *
+ * The sender and the receiver thread both count into the same stats
+ * (errors from either side), so the counters are relaxed atomics and
+ * canTransportGetStats takes a snapshot.
+ */
+
+#define LOG_TAG "NativeTransport"
+#include "can_transport.h"
+#include "can_recorder.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include "serial_port.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <linux/usbdevice_fs.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#endif
+
+// CanTransportStats, written from the send and the receive thread
+struct TransportCounters {
+    std::atomic<uint64_t> framesSent{0};
+    std::atomic<uint64_t> framesReceived{0};
+    std::atomic<uint64_t> framesDropped{0};
+    std::atomic<uint64_t> sendCalls{0};
+    std::atomic<uint64_t> receiveCalls{0};
+    std::atomic<uint64_t> errors{0};
+};
+
+static inline void countUp(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+struct CanTransport {
+    const char* name;
+    TransportCounters stats;
+    bool recording = false;
+
+    explicit CanTransport(const char* backendName) : name(backendName) {}
+    virtual ~CanTransport() {}
+    virtual int send(const WsCanFrame* frames, int count) = 0;
+    virtual int receive(WsCanFrame* out, int maxFrames, int timeoutMs) = 0;
+};
+
+// Wait for fd readiness. Returns 1 ready, 0 timeout, -1 error
+static int waitFd(int fd, short events, int timeoutMs) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = events;
+    pfd.revents = 0;
+
+    int r;
+    do {
+        r = poll(&pfd, 1, timeoutMs);
+    } while (r < 0 && errno == EINTR);
+
+    if (r < 0) return -1;
+    if (r == 0) return 0;
+    return (pfd.revents & (POLLERR | POLLNVAL)) ? -1 : 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Waveshare Serial Backend
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct WaveshareTransport : CanTransport {
+    SerialPort* port;
+    WsCodec codec;
+    uint8_t txBuffer[CAN_TRANSPORT_MAX_BATCH * WS_MAX_FRAME_BYTES];
+    uint8_t rxBuffer[WS_RX_BUFFER_SIZE];
+
+    explicit WaveshareTransport(SerialPort* serial) : CanTransport("waveshare"), port(serial) {
+        wsCodecInit(&codec);
+    }
+
+    ~WaveshareTransport() override {
+        serialClose(port);
+    }
+
+    int send(const WsCanFrame* frames, int count) override {
+        if (count > CAN_TRANSPORT_MAX_BATCH) count = CAN_TRANSPORT_MAX_BATCH;
+        int length = wsCodecEncode(&codec, frames, count, txBuffer, sizeof(txBuffer));
+
+        // One burst; only blocks while the tty buffer is full
+        if (serialWrite(port, txBuffer, length, 100) < length) {
+            countUp(stats.errors);
+            countUp(stats.framesDropped, count);
+            return -1;
+        }
+        return count;
+    }
+
+    int receive(WsCanFrame* out, int maxFrames, int timeoutMs) override {
+        // Frames still buffered from an earlier read come first
+        int count = wsCodecDecode(&codec, nullptr, 0, out, maxFrames);
+        if (count > 0) return count;
+
+        // Never read more than the codec can hold, so nothing is dropped
+        int n = serialRead(port, rxBuffer, WS_RX_BUFFER_SIZE - codec.rxLength, timeoutMs);
+        if (n <= 0) {
+            if (n < 0) countUp(stats.errors);
+            return n;
+        }
+        return wsCodecDecode(&codec, rxBuffer, n, out, maxFrames);
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Waveshare over usbfs (Android UsbDeviceConnection fd)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifdef __linux__
+// Several bulk IN URBs stay queued, so the adapter never waits for the
+// reader to resubmit; completions are signalled through poll(POLLOUT)
+struct UsbBulkTransport : CanTransport {
+    int fd;
+    unsigned int epIn;
+    unsigned int epOut;
+    WsCodec codec;
+    struct usbdevfs_urb urbs[CAN_USB_RX_URBS];
+    bool queued[CAN_USB_RX_URBS];
+    uint8_t rxBuffers[CAN_USB_RX_URBS][CAN_USB_URB_SIZE];
+    uint8_t txBuffer[CAN_TRANSPORT_MAX_BATCH * WS_MAX_FRAME_BYTES];
+
+    UsbBulkTransport(int usbFd, int inAddress, int outAddress)
+        : CanTransport("usb"), fd(usbFd), epIn((unsigned)inAddress), epOut((unsigned)outAddress) {
+        wsCodecInit(&codec);
+        memset(queued, 0, sizeof(queued));
+    }
+
+    ~UsbBulkTransport() override {
+        // Cancel, then collect every queued URB before its buffer goes away
+        int pending = 0;
+        for (int i = 0; i < CAN_USB_RX_URBS; i++) {
+            if (!queued[i]) continue;
+            ioctl(fd, USBDEVFS_DISCARDURB, &urbs[i]);
+            pending++;
+        }
+        while (pending > 0) {
+            void* reaped = nullptr;
+            if (ioctl(fd, USBDEVFS_REAPURB, &reaped) < 0 && errno != EINTR) break;
+            if (reaped != nullptr) pending--;
+        }
+    }
+
+    bool submit(int i) {
+        struct usbdevfs_urb* urb = &urbs[i];
+        memset(urb, 0, sizeof(*urb));
+        urb->type = USBDEVFS_URB_TYPE_BULK;
+        urb->endpoint = (unsigned char)epIn;
+        urb->buffer = rxBuffers[i];
+        urb->buffer_length = CAN_USB_URB_SIZE;
+        urb->usercontext = (void*)(intptr_t)i;
+        queued[i] = ioctl(fd, USBDEVFS_SUBMITURB, urb) == 0;
+        return queued[i];
+    }
+
+    bool start() {
+        for (int i = 0; i < CAN_USB_RX_URBS; i++) {
+            if (!submit(i)) {
+                LOGW("usbfs: submit URB on ep 0x%02X failed: %s", epIn, strerror(errno));
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int send(const WsCanFrame* frames, int count) override {
+        if (count > CAN_TRANSPORT_MAX_BATCH) count = CAN_TRANSPORT_MAX_BATCH;
+        int length = wsCodecEncode(&codec, frames, count, txBuffer, sizeof(txBuffer));
+
+        struct usbdevfs_bulktransfer bulk;
+        bulk.ep = epOut;
+        bulk.len = (unsigned)length;
+        bulk.timeout = 100;
+        bulk.data = txBuffer;
+        if (ioctl(fd, USBDEVFS_BULK, &bulk) != length) {
+            countUp(stats.errors);
+            countUp(stats.framesDropped, count);
+            return -1;
+        }
+        return count;
+    }
+
+    int receive(WsCanFrame* out, int maxFrames, int timeoutMs) override {
+        int count = wsCodecDecode(&codec, nullptr, 0, out, maxFrames);
+        if (count > 0) return count;
+
+        int ready = waitFd(fd, POLLOUT, timeoutMs);
+        if (ready <= 0) {
+            if (ready < 0) countUp(stats.errors);
+            return ready;
+        }
+
+        // Every completed URB: decode its bytes, queue it again
+        void* reaped = nullptr;
+        while (ioctl(fd, USBDEVFS_REAPURBNDELAY, &reaped) == 0) {
+            struct usbdevfs_urb* urb = (struct usbdevfs_urb*)reaped;
+            int i = (int)(intptr_t)urb->usercontext;
+            queued[i] = false;
+
+            if (urb->status == -ENODEV || urb->status == -ESHUTDOWN) {
+                countUp(stats.errors);
+                return -1;
+            }
+            if (urb->status == 0 && urb->actual_length > 0) {
+                count += wsCodecDecode(&codec, rxBuffers[i], urb->actual_length, out + count, maxFrames - count);
+            }
+            if (!submit(i)) {
+                countUp(stats.errors);
+                return count > 0 ? count : -1;
+            }
+        }
+        return count;
+    }
+};
+#endif
+
+extern "C" CanTransport* canTransportOpenUsb(int fd, int epIn, int epOut) {
+#ifdef __linux__
+    if (fd < 0) return nullptr;
+    UsbBulkTransport* t = new UsbBulkTransport(fd, epIn, epOut);
+    if (!t->start()) {
+        delete t;
+        return nullptr;
+    }
+    LOGI("✅ usbfs transport: fd %d, IN 0x%02X, OUT 0x%02X, %d URBs x %d B", fd, epIn, epOut,
+         CAN_USB_RX_URBS, CAN_USB_URB_SIZE);
+    return t;
+#else
+    LOGW("usbfs not supported on this platform (fd %d)", fd);
+    return nullptr;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// SocketCAN Backend
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifdef __linux__
+static const int SOCKETCAN_SEND_WAIT_MS = 10;          // Per send call while the TX queue is full
+static const int SOCKETCAN_ENOBUFS_BACKOFF_US = 500;
+
+struct SocketCanTransport : CanTransport {
+    int fd;
+
+    explicit SocketCanTransport(int socketFd) : CanTransport("socketcan"), fd(socketFd) {}
+
+    ~SocketCanTransport() override {
+        close(fd);
+    }
+
+    static void toSocketCan(const WsCanFrame* f, struct can_frame* cf) {
+        memset(cf, 0, sizeof(*cf));
+        cf->can_id = (f->flags & WS_FLAG_EXT) ? ((f->id & CAN_EFF_MASK) | CAN_EFF_FLAG) : (f->id & CAN_SFF_MASK);
+        if (f->flags & WS_FLAG_RTR) cf->can_id |= CAN_RTR_FLAG;
+        cf->can_dlc = f->dlc > WS_MAX_DLC ? WS_MAX_DLC : f->dlc;
+        memcpy(cf->data, f->data, cf->can_dlc);
+    }
+
+    static void fromSocketCan(const struct can_frame* cf, WsCanFrame* f) {
+        int ext = (cf->can_id & CAN_EFF_FLAG) != 0;
+        f->id = ext ? (cf->can_id & CAN_EFF_MASK) : (cf->can_id & CAN_SFF_MASK);
+        f->flags = (uint8_t)((ext ? WS_FLAG_EXT : 0) | ((cf->can_id & CAN_RTR_FLAG) ? WS_FLAG_RTR : 0));
+        f->dlc = cf->can_dlc > WS_MAX_DLC ? WS_MAX_DLC : cf->can_dlc;
+        memset(f->data, 0, WS_MAX_DLC);
+        memcpy(f->data, cf->data, f->dlc);
+    }
+
+    int send(const WsCanFrame* frames, int count) override {
+        int sent = 0;
+        struct can_frame cf;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SOCKETCAN_SEND_WAIT_MS);
+        while (sent < count) {
+            toSocketCan(&frames[sent], &cf);
+            ssize_t n = write(fd, &cf, sizeof(cf));
+            if (n == (ssize_t)sizeof(cf)) {
+                sent++;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == ENOBUFS)) {
+                // TX queue full (or bus-off): retry until the deadline, then
+                // report a partial send. ENOBUFS comes from the qdisc while
+                // the socket still polls writable, so back off instead
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+                if (left <= 0) break;
+                if (errno == ENOBUFS) {
+                    usleep(SOCKETCAN_ENOBUFS_BACKOFF_US);
+                } else if (waitFd(fd, POLLOUT, (int)left) <= 0) {
+                    break;
+                }
+            } else {
+                countUp(stats.errors);
+                return sent > 0 ? sent : -1;
+            }
+        }
+        countUp(stats.framesDropped, count - sent);
+        return sent;
+    }
+
+    int receive(WsCanFrame* out, int maxFrames, int timeoutMs) override {
+        int ready = waitFd(fd, POLLIN, timeoutMs);
+        if (ready <= 0) {
+            if (ready < 0) countUp(stats.errors);
+            return ready;
+        }
+
+        // Drain everything already queued without blocking
+        int count = 0;
+        struct can_frame cf;
+        while (count < maxFrames) {
+            ssize_t n = recv(fd, &cf, sizeof(cf), MSG_DONTWAIT);
+            if (n != (ssize_t)sizeof(cf)) break;
+            if (cf.can_id & CAN_ERR_FLAG) continue;
+            fromSocketCan(&cf, &out[count++]);
+        }
+        return count;
+    }
+};
+#endif
+
+extern "C" CanTransport* canTransportOpenSocketCan(const char* ifname) {
+#ifdef __linux__
+    int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) {
+        LOGW("SocketCAN unavailable: %s", strerror(errno));
+        return nullptr;
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        LOGW("SocketCAN interface %s not found: %s", ifname, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOGW("SocketCAN bind %s failed: %s", ifname, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    LOGI("✅ SocketCAN open on %s", ifname);
+    return new SocketCanTransport(fd);
+#else
+    LOGW("SocketCAN not supported on this platform (%s)", ifname);
+    return nullptr;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Loopback Backend
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Bounded frame queue for one direction
+struct LoopbackQueue {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::unique_ptr<WsCanFrame[]> frames;
+    int capacity;
+    int head = 0;
+    int count = 0;
+
+    explicit LoopbackQueue(int depth) : frames(new WsCanFrame[depth]), capacity(depth) {}
+};
+
+struct LoopbackTransport : CanTransport {
+    std::shared_ptr<LoopbackQueue> tx;
+    std::shared_ptr<LoopbackQueue> rx;
+
+    LoopbackTransport(std::shared_ptr<LoopbackQueue> txQueue, std::shared_ptr<LoopbackQueue> rxQueue)
+        : CanTransport("loopback"), tx(std::move(txQueue)), rx(std::move(rxQueue)) {}
+
+    int send(const WsCanFrame* frames, int count) override {
+        int sent = 0;
+        {
+            std::lock_guard<std::mutex> guard(tx->lock);
+            while (sent < count && tx->count < tx->capacity) {
+                tx->frames[(tx->head + tx->count) % tx->capacity] = frames[sent++];
+                tx->count++;
+            }
+        }
+        if (sent > 0) tx->ready.notify_one();
+        countUp(stats.framesDropped, count - sent);
+        return sent;
+    }
+
+    int receive(WsCanFrame* out, int maxFrames, int timeoutMs) override {
+        std::unique_lock<std::mutex> guard(rx->lock);
+        if (rx->count == 0) {
+            if (timeoutMs < 0) {
+                rx->ready.wait(guard, [this] { return rx->count > 0; });
+            } else if (!rx->ready.wait_for(guard, std::chrono::milliseconds(timeoutMs),
+                                           [this] { return rx->count > 0; })) {
+                return 0;
+            }
+        }
+
+        int count = 0;
+        while (count < maxFrames && rx->count > 0) {
+            out[count++] = rx->frames[rx->head];
+            rx->head = (rx->head + 1) % rx->capacity;
+            rx->count--;
+        }
+        return count;
+    }
+};
+
+extern "C" int canTransportOpenLoopbackPair(CanTransport** a, CanTransport** b, int depth) {
+    if (depth <= 0) depth = CAN_TRANSPORT_LOOPBACK_DEPTH;
+
+    auto aToB = std::make_shared<LoopbackQueue>(depth);
+    auto bToA = std::make_shared<LoopbackQueue>(depth);
+    *a = new LoopbackTransport(aToB, bToA);
+    *b = new LoopbackTransport(bToA, aToB);
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// C API
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" CanTransport* canTransportOpenWaveshare(int fd, int ownsFd) {
+    if (fd < 0) return nullptr;
+    SerialPort* port = serialWrap(fd, ownsFd);
+    if (port == nullptr) return nullptr;
+    return new WaveshareTransport(port);
+}
+
+// "serial:<fd>" or "serial:/dev/ttyUSB0[@baud]" (default WS_SERIAL_BAUD)
+static CanTransport* openSerialSpec(const char* target) {
+    if (target[0] >= '0' && target[0] <= '9') {
+        return canTransportOpenWaveshare(atoi(target), 0);
+    }
+
+    char path[SERIAL_PATH_MAX];
+    strncpy(path, target, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+
+    int baud = WS_SERIAL_BAUD;
+    char* at = strchr(path, '@');
+    if (at != nullptr) {
+        *at = '\0';
+        baud = atoi(at + 1);
+    }
+
+    SerialPort* port = serialOpen(path, baud);
+    if (port == nullptr) return nullptr;
+    return new WaveshareTransport(port);
+}
+
+extern "C" CanTransport* canTransportOpen(const char* spec) {
+    if (strncmp(spec, "socketcan:", 10) == 0) {
+        return canTransportOpenSocketCan(spec + 10);
+    }
+    if (strncmp(spec, "serial:", 7) == 0) {
+        return openSerialSpec(spec + 7);
+    }
+    LOGW("Unknown transport: %s", spec);
+    return nullptr;
+}
+
+extern "C" int canTransportSend(CanTransport* t, const WsCanFrame* frames, int count) {
+    if (count <= 0) return 0;
+    TRACE_ZONE("can.send");
+    countUp(t->stats.sendCalls);
+    int sent = t->send(frames, count);
+    if (sent > 0) {
+        countUp(t->stats.framesSent, sent);
+        if (t->recording) canRecorderLog(frames, sent, 1);
+    }
+    return sent;
+}
+
+extern "C" int canTransportReceive(CanTransport* t, WsCanFrame* out, int maxFrames, int timeoutMs) {
+    if (maxFrames <= 0) return 0;
+    countUp(t->stats.receiveCalls);
+    int count = t->receive(out, maxFrames, timeoutMs);
+    if (count > 0) {
+        countUp(t->stats.framesReceived, count);
+        if (t->recording) canRecorderLog(out, count, 0);
+    }
+    return count;
+}
+
+extern "C" void canTransportSetRecording(CanTransport* t, int enabled) {
+    t->recording = enabled != 0;
+}
+
+extern "C" const char* canTransportName(const CanTransport* t) {
+    return t->name;
+}
+
+extern "C" void canTransportGetStats(const CanTransport* t, CanTransportStats* outStats) {
+    const TransportCounters& c = t->stats;
+    outStats->framesSent = c.framesSent.load(std::memory_order_relaxed);
+    outStats->framesReceived = c.framesReceived.load(std::memory_order_relaxed);
+    outStats->framesDropped = c.framesDropped.load(std::memory_order_relaxed);
+    outStats->sendCalls = c.sendCalls.load(std::memory_order_relaxed);
+    outStats->receiveCalls = c.receiveCalls.load(std::memory_order_relaxed);
+    outStats->errors = c.errors.load(std::memory_order_relaxed);
+}
+
+extern "C" void canTransportClose(CanTransport* t) {
+    delete t;
+}
@@ -0,0 +1,92 @@
+/**
+ * can_transport.h
+ * CAN Transport Interface (C++)
+ *
+ * One send/receive API over four backends:
+ *   - Waveshare USB-CAN-A serial protocol on a file descriptor
+ *   - The same protocol straight on the adapter's USB bulk endpoints (usbfs)
+ *   - Linux SocketCAN (e.g. vcan0 on a dev machine)
+ *   - In-process loopback pair
+ *
+ * Lets the native receive path and host tools run without hardware.
+ * A transport is used by one sender and one receiver thread at most.
+ */
+
+#ifndef CAN_TRANSPORT_H
+#define CAN_TRANSPORT_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CAN_TRANSPORT_MAX_BATCH 64          // Frames per send/receive call
+#define CAN_TRANSPORT_LOOPBACK_DEPTH 1024   // Default frames queued per direction
+#define WS_SERIAL_BAUD 2000000              // WaveshareAdapter.BAUD_RATE
+#define CAN_USB_RX_URBS 4                   // Bulk IN transfers kept queued
+#define CAN_USB_URB_SIZE 512                // Bytes per bulk IN transfer
+
+typedef struct CanTransport CanTransport;
+
+typedef struct {
+    uint64_t framesSent;
+    uint64_t framesReceived;
+    uint64_t framesDropped;   // Loopback queue full / partial serial write
+    uint64_t sendCalls;
+    uint64_t receiveCalls;
+    uint64_t errors;
+} CanTransportStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Backends
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Waveshare protocol on an open serial/pty fd (closed on canTransportClose if ownsFd).
+// I/O goes through serial_port (epoll reads, writev)
+CanTransport* canTransportOpenWaveshare(int fd, int ownsFd);
+
+// Waveshare protocol on the bulk endpoints of a usbfs fd
+// (UsbDeviceConnection.getFileDescriptor(), interface already claimed).
+// The fd is not closed. Returns NULL if the IN transfers cannot be queued
+CanTransport* canTransportOpenUsb(int fd, int epIn, int epOut);
+
+// SocketCAN raw socket bound to ifname. Returns NULL if unavailable
+CanTransport* canTransportOpenSocketCan(const char* ifname);
+
+// Two connected endpoints: frames sent on one are received on the other.
+// Returns 1 on success
+int canTransportOpenLoopbackPair(CanTransport** a, CanTransport** b, int depth);
+
+// "socketcan:<if>", "serial:/dev/ttyUSB0[@baud]" or "serial:<fd>";
+// loopback needs canTransportOpenLoopbackPair
+CanTransport* canTransportOpen(const char* spec);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Operations
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Returns frames sent (may be fewer than count), or -1 on error
+int canTransportSend(CanTransport* t, const WsCanFrame* frames, int count);
+
+// Wait up to timeoutMs (-1 = forever) and return all frames available,
+// up to maxFrames. Returns 0 on timeout, -1 on error
+int canTransportReceive(CanTransport* t, WsCanFrame* out, int maxFrames, int timeoutMs);
+
+// Log every frame sent/received on this transport to can_recorder
+// (while the recorder is running)
+void canTransportSetRecording(CanTransport* t, int enabled);
+
+// Backend name ("waveshare", "usb", "socketcan", "loopback")
+const char* canTransportName(const CanTransport* t);
+
+void canTransportGetStats(const CanTransport* t, CanTransportStats* outStats);
+
+void canTransportClose(CanTransport* t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CAN_TRANSPORT_H
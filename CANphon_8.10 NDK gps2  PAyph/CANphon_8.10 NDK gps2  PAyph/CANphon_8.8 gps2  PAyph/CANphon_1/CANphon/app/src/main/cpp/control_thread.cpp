@@ -0,0 +1,557 @@
+/**
+ * control_thread.cpp
+ * Native Control Thread (C++)
+ *
+ * Ticks come from an absolute CLOCK_MONOTONIC timerfd, so a late wake-up
+ * does not shift the following ticks; the expiration count read back
+ * tells how many were missed. Inputs are exchanged through seqlocks: the
+ * sensor and camera callbacks never wait for the control thread.
+ *
+ * Guidance runs on every tick against the latest tracking error,
+ * extrapolated along the last two camera samples (at most one camera
+ * interval ahead) so the PID derivative sees a ramp rather than steps.
+ *
+ * While it runs the thread owns the guidance / fusion / telemetry state
+ * (core_owner.h): each tick applies the queued commands first and
+ * publishes the snapshot last.
+ *
+ * Guidance and sends are timed as the guide / send stages
+ * (deadline_monitor.h). Under the predict policy the extrapolation runs
+ * up to the stale timeout instead of one camera interval; under the
+ * hold policy changed commands stay unsent except for periodic probes.
+ */
+
+#define LOG_TAG "NativeControl"
+#include "control_thread.h"
+#include "can_recorder.h"
+#include "core_owner.h"
+#include "deadline_monitor.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include "servo_estimator.h"
+#include "thread_sched.h"
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// guidance_controller.cpp
+extern "C" {
+    void guidanceUpdate(float errorX, float errorY, float dt);
+    void guidanceGetCommands(float* pitch, float* yaw);
+}
+
+// Position command (CANServoProtocol.createPositionCommand)
+static const uint32_t POSITION_COMMAND_BASE_ID = 0x600;
+static const uint8_t SDO_WRITE = 0x22;
+static const int64_t MAX_SAMPLE_GAP_US = 200000; // Longer camera gaps are not extrapolated across
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Inputs (seqlocks: odd sequence = write in progress)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    std::atomic<uint32_t> seq;
+    std::atomic<float> roll, pitch, yaw;
+} AttitudeInput;
+
+typedef struct {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> updates;      // Changes once per new error sample
+    std::atomic<float> errorX, errorY;
+    std::atomic<int64_t> timeUs;
+} TrackingInput;
+
+static AttitudeInput attitude;
+static TrackingInput tracking;
+static std::atomic<int> mode(CONTROL_MODE_HOLD);
+
+// Layout: written under layoutLock, copied by the thread when the generation moves
+static pthread_mutex_t layoutLock = PTHREAD_MUTEX_INITIALIZER;
+static std::atomic<uint32_t> layoutGeneration(0);
+static int layoutCount = 0;
+static int layoutNode[CONTROL_MAX_CHANNELS];
+static float layoutRollGain[CONTROL_MAX_CHANNELS];
+static float layoutPitchGain[CONTROL_MAX_CHANNELS];
+
+// Last commands sent, readable from any thread
+static std::atomic<float> commandSent[CONTROL_MAX_CHANNELS];
+
+static void seqWriteBegin(std::atomic<uint32_t>* seq) {
+    seq->fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void seqWriteEnd(std::atomic<uint32_t>* seq) {
+    seq->fetch_add(1, std::memory_order_release);
+}
+
+extern "C" int controlSetLayout(const int* nodeIds, const float* rollGains, const float* pitchGains, int count) {
+    if (count < 0 || count > CONTROL_MAX_CHANNELS) return 0;
+    pthread_mutex_lock(&layoutLock);
+    for (int i = 0; i < count; i++) {
+        layoutNode[i] = nodeIds[i];
+        layoutRollGain[i] = rollGains[i];
+        layoutPitchGain[i] = pitchGains[i];
+    }
+    layoutCount = count;
+    layoutGeneration.fetch_add(1, std::memory_order_release);
+    pthread_mutex_unlock(&layoutLock);
+    return 1;
+}
+
+extern "C" void controlSetMode(int m) {
+    if (m < CONTROL_MODE_HOLD || m > CONTROL_MODE_TRACKING) return;
+    mode.store(m, std::memory_order_release);
+}
+
+extern "C" void controlSetAttitude(float roll, float pitch, float yaw) {
+    seqWriteBegin(&attitude.seq);
+    attitude.roll.store(roll, std::memory_order_relaxed);
+    attitude.pitch.store(pitch, std::memory_order_relaxed);
+    attitude.yaw.store(yaw, std::memory_order_relaxed);
+    seqWriteEnd(&attitude.seq);
+}
+
+extern "C" void controlSetTrackingError(float errorX, float errorY, int64_t timeUs) {
+    TRACE_ZONE("control.setTrackingError");
+    if (timeUs == 0) timeUs = canRecorderNowUs();
+    seqWriteBegin(&tracking.seq);
+    tracking.errorX.store(errorX, std::memory_order_relaxed);
+    tracking.errorY.store(errorY, std::memory_order_relaxed);
+    tracking.timeUs.store(timeUs, std::memory_order_relaxed);
+    uint32_t update = tracking.updates.fetch_add(1, std::memory_order_relaxed) + 1;
+    seqWriteEnd(&tracking.seq);
+    TRACE_FLOW_BEGIN("tracking", update);     // Ends in the control tick that picks it up
+}
+
+static void readAttitude(float* roll, float* pitch) {
+    uint32_t s;
+    do {
+        s = attitude.seq.load(std::memory_order_acquire);
+        *roll = attitude.roll.load(std::memory_order_relaxed);
+        *pitch = attitude.pitch.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((s & 1) || s != attitude.seq.load(std::memory_order_relaxed));
+}
+
+static void readTracking(float* errorX, float* errorY, int64_t* timeUs, uint32_t* updates) {
+    uint32_t s;
+    do {
+        s = tracking.seq.load(std::memory_order_acquire);
+        *errorX = tracking.errorX.load(std::memory_order_relaxed);
+        *errorY = tracking.errorY.load(std::memory_order_relaxed);
+        *timeUs = tracking.timeUs.load(std::memory_order_relaxed);
+        *updates = tracking.updates.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((s & 1) || s != tracking.seq.load(std::memory_order_relaxed));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Thread State
+// ═══════════════════════════════════════════════════════════════════════════
+
+static pthread_mutex_t controlLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t thread;
+static bool started = false;
+
+static ControlThreadConfig config;
+static ControlSendFn sendFn = nullptr;
+static int timerFd = -1;
+static std::atomic<bool> stopRequested(false);
+static std::atomic<bool> running(false);
+
+// Written by the thread only
+static std::atomic<uint64_t> ticks(0);
+static std::atomic<uint64_t> overruns(0);
+static std::atomic<uint64_t> sends(0);
+static std::atomic<uint64_t> framesSent(0);
+static std::atomic<uint64_t> sendErrors(0);
+static std::atomic<uint64_t> staleTicks(0);
+static std::atomic<int64_t> jitterLastUs(0);
+static std::atomic<int64_t> jitterSumUs(0);
+static std::atomic<int64_t> jitterMaxUs(0);
+static std::atomic<int64_t> workSumUs(0);
+static std::atomic<int64_t> workMaxUs(0);
+static std::atomic<uint32_t> jitterHistogram[CONTROL_JITTER_BUCKETS];
+static std::atomic<int32_t> threadTid(0);
+static std::atomic<int32_t> realtime(0);
+
+static int64_t startUs = 0;
+static std::atomic<int64_t> stopUs(0);
+static std::atomic<int64_t> cpuTimeAtExitUs(0);
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t threadCpuUs(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) return 0;
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void recordMax(std::atomic<int64_t>* max, int64_t value) {
+    if (value > max->load(std::memory_order_relaxed)) max->store(value, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control Loop
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void positionCommand(int nodeId, float angle, WsCanFrame* f) {
+    if (angle < -CONTROL_TRAVEL_DEG) angle = -CONTROL_TRAVEL_DEG;
+    if (angle > CONTROL_TRAVEL_DEG) angle = CONTROL_TRAVEL_DEG;
+    int target = (int)((angle + CONTROL_TRAVEL_DEG) / (2 * CONTROL_TRAVEL_DEG) * 16383.0f);
+    if (target < 0) target = 0;
+    if (target > 16383) target = 16383;
+    int32_t value = (target - 8191) / 4;
+
+    f->id = POSITION_COMMAND_BASE_ID + (uint32_t)nodeId;
+    f->dlc = 8;
+    f->flags = 0;
+    f->data[0] = SDO_WRITE;
+    f->data[1] = 0x03;   // Index 0x6003 (position target), LE
+    f->data[2] = 0x60;
+    f->data[3] = 0x00;
+    f->data[4] = (uint8_t)value;
+    f->data[5] = (uint8_t)(value >> 8);
+    f->data[6] = (uint8_t)(value >> 16);
+    f->data[7] = (uint8_t)(value >> 24);
+}
+
+typedef struct {
+    int count;
+    int node[CONTROL_MAX_CHANNELS];
+    float rollGain[CONTROL_MAX_CHANNELS];
+    float pitchGain[CONTROL_MAX_CHANNELS];
+    uint32_t generation;
+} LayoutCopy;
+
+static void refreshLayout(LayoutCopy* l, float* lastSent, bool* haveSent) {
+    uint32_t generation = layoutGeneration.load(std::memory_order_acquire);
+    if (generation == l->generation) return;
+    pthread_mutex_lock(&layoutLock);
+    l->count = layoutCount;
+    memcpy(l->node, layoutNode, sizeof(l->node));
+    memcpy(l->rollGain, layoutRollGain, sizeof(l->rollGain));
+    memcpy(l->pitchGain, layoutPitchGain, sizeof(l->pitchGain));
+    l->generation = layoutGeneration.load(std::memory_order_relaxed);
+    pthread_mutex_unlock(&layoutLock);
+
+    // New layout: every channel goes out on the next tick
+    for (int i = 0; i < CONTROL_MAX_CHANNELS; i++) {
+        lastSent[i] = 0;
+        haveSent[i] = false;
+    }
+}
+
+static void recordJitter(int64_t jitterUs) {
+    if (jitterUs < 0) jitterUs = 0;
+    jitterLastUs.store(jitterUs, std::memory_order_relaxed);
+    jitterSumUs.fetch_add(jitterUs, std::memory_order_relaxed);
+    recordMax(&jitterMaxUs, jitterUs);
+    int64_t bucket = jitterUs / CONTROL_JITTER_BUCKET_US;
+    if (bucket >= CONTROL_JITTER_BUCKETS) bucket = CONTROL_JITTER_BUCKETS - 1;
+    jitterHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* controlLoop(void*) {
+    int tid = (int)syscall(SYS_gettid);
+    threadTid.store(tid, std::memory_order_relaxed);
+    realtime.store(threadApplyScheduling(tid, config.niceValue, config.rtPriority, config.cpuMask),
+                   std::memory_order_relaxed);
+
+    traceSetThreadName("control");
+    coreClaim();
+
+    LayoutCopy layout = {};
+    layout.generation = layoutGeneration.load(std::memory_order_relaxed) - 1;   // Copy on the first tick
+    float lastSent[CONTROL_MAX_CHANNELS];
+    bool haveSent[CONTROL_MAX_CHANNELS];
+    WsCanFrame batch[CONTROL_MAX_CHANNELS];
+    int batchChannel[CONTROL_MAX_CHANNELS];
+    float batchAngle[CONTROL_MAX_CHANNELS];
+
+    float roll = 0, pitch = 0;
+
+    // Last two tracking samples (extrapolation) and the last guidance update
+    uint32_t trackingUpdates = tracking.updates.load(std::memory_order_relaxed);
+    float lastErrorX = 0, lastErrorY = 0, prevErrorX = 0, prevErrorY = 0;
+    int64_t lastErrorUs = 0, prevErrorUs = 0;
+    int64_t guidanceUs = 0;
+
+    // First expiry one period after start, then every period (absolute)
+    int64_t periodUs = config.periodUs;
+    int64_t firstUs = monotonicUs() + periodUs;
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = firstUs / 1000000;
+    spec.it_value.tv_nsec = (firstUs % 1000000) * 1000;
+    spec.it_interval.tv_sec = periodUs / 1000000;
+    spec.it_interval.tv_nsec = (periodUs % 1000000) * 1000;
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    uint64_t expiry = 0;
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        uint64_t expirations = 0;
+        if (read(timerFd, &expirations, sizeof(expirations)) != (ssize_t)sizeof(expirations)) {
+            if (errno == EINTR) continue;
+            LOGW("❌ timerfd read failed: %s", strerror(errno));
+            break;
+        }
+        int64_t wakeUs = monotonicUs();
+        TRACE_ZONE("control.tick");
+        expiry += expirations;
+        recordJitter(wakeUs - (firstUs + (int64_t)(expiry - 1) * periodUs));
+        if (expirations > 1) overruns.fetch_add(expirations - 1, std::memory_order_relaxed);
+        ticks.fetch_add(1, std::memory_order_relaxed);
+
+        refreshLayout(&layout, lastSent, haveSent);
+        coreDrain();
+        int m = mode.load(std::memory_order_acquire);
+        if (m == CONTROL_MODE_ATTITUDE) {
+            readAttitude(&roll, &pitch);
+        } else if (m == CONTROL_MODE_TRACKING) {
+            float errorX, errorY;
+            int64_t errorUs;
+            uint32_t updates;
+            readTracking(&errorX, &errorY, &errorUs, &updates);
+            if (updates != trackingUpdates) {
+                TRACE_FLOW_END("tracking", updates);
+                prevErrorX = lastErrorX;
+                prevErrorY = lastErrorY;
+                prevErrorUs = lastErrorUs;
+                lastErrorX = errorX;
+                lastErrorY = errorY;
+                lastErrorUs = errorUs;
+                trackingUpdates = updates;
+            }
+
+            DeadlineScope guide(DEADLINE_STAGE_GUIDE);
+            int64_t nowUs = canRecorderNowUs();
+            if (lastErrorUs == 0 || nowUs - lastErrorUs > CONTROL_TRACKING_TIMEOUT_US) {
+                staleTicks.fetch_add(1, std::memory_order_relaxed);   // Hold the last commands
+                guidanceUs = 0;
+            } else {
+                float ex = lastErrorX, ey = lastErrorY;
+                int64_t intervalUs = lastErrorUs - prevErrorUs;
+                if (prevErrorUs > 0 && intervalUs > 0 && intervalUs <= MAX_SAMPLE_GAP_US) {
+                    // Camera late: keep following the last motion (up to the timeout)
+                    int64_t aheadUs = nowUs - lastErrorUs;
+                    if (aheadUs > intervalUs) {
+                        if (deadlinePolicyActive(DEADLINE_POLICY_PREDICT)) deadlineCountPredicted();
+                        else aheadUs = intervalUs;
+                    }
+                    float k = (float)aheadUs / (float)intervalUs;
+                    ex += (lastErrorX - prevErrorX) * k;
+                    ey += (lastErrorY - prevErrorY) * k;
+                }
+                float dt = guidanceUs > 0 ? (float)(wakeUs - guidanceUs) * 1e-6f : (float)periodUs * 1e-6f;
+                guidanceUpdate(ex, ey, dt);
+                guidanceUs = wakeUs;
+            }
+            // GuidanceController: yaw drives the roll mix, pitch the pitch mix
+            float pitchCmd, yawCmd;
+            guidanceGetCommands(&pitchCmd, &yawCmd);
+            roll = yawCmd;
+            pitch = pitchCmd;
+        }
+
+        int n = 0;
+        if (m != CONTROL_MODE_HOLD && sendFn != nullptr) {
+            for (int i = 0; i < layout.count; i++) {
+                float angle = layout.rollGain[i] * roll + layout.pitchGain[i] * pitch;
+                if (angle < -CONTROL_TRAVEL_DEG) angle = -CONTROL_TRAVEL_DEG;
+                if (angle > CONTROL_TRAVEL_DEG) angle = CONTROL_TRAVEL_DEG;
+                if (haveSent[i] && fabsf(angle - lastSent[i]) <= config.sendThresholdDeg) continue;
+                batchChannel[n] = i;
+                batchAngle[n] = angle;
+                positionCommand(layout.node[i], angle, &batch[n++]);
+            }
+        }
+        // Held: the servos keep the last commands, these go out on a later tick
+        if (n > 0 && deadlineAdmit(DEADLINE_STAGE_SEND)) {
+            for (int k = 0; k < n; k++) {
+                int i = batchChannel[k];
+                lastSent[i] = batchAngle[k];
+                haveSent[i] = true;
+                commandSent[i].store(batchAngle[k], std::memory_order_relaxed);
+            }
+            int64_t sendStartUs = canRecorderNowUs();
+            int sent = sendFn(batch, n);
+            deadlineRecord(DEADLINE_STAGE_SEND, canRecorderNowUs() - sendStartUs);
+            if (sent < 0) {
+                sendErrors.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                servoEstimatorCommandFrames(batch, n, canRecorderNowUs());
+                sends.fetch_add(1, std::memory_order_relaxed);
+                framesSent.fetch_add((uint64_t)sent, std::memory_order_relaxed);
+            }
+        }
+
+        corePublish();
+
+        int64_t workUs = monotonicUs() - wakeUs;
+        workSumUs.fetch_add(workUs, std::memory_order_relaxed);
+        recordMax(&workMaxUs, workUs);
+    }
+
+    coreRelease();
+    cpuTimeAtExitUs = threadCpuUs(CLOCK_THREAD_CPUTIME_ID);
+    stopUs = monotonicUs();
+    running.store(false, std::memory_order_release);
+    return nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void controlThreadDefaultConfig(ControlThreadConfig* c) {
+    c->periodUs = CONTROL_DEFAULT_PERIOD_US;
+    c->niceValue = CONTROL_DEFAULT_NICE;
+    c->rtPriority = 0;
+    c->cpuMask = 0;
+    c->sendThresholdDeg = CONTROL_DEFAULT_SEND_THRESHOLD_DEG;
+}
+
+extern "C" int controlThreadStart(const ControlThreadConfig* c, ControlSendFn send) {
+    if (send == nullptr) return 0;
+
+    pthread_mutex_lock(&controlLock);
+    if (started) {
+        pthread_mutex_unlock(&controlLock);
+        LOGW("Control thread already running");
+        return 0;
+    }
+
+    if (c != nullptr) config = *c;
+    else controlThreadDefaultConfig(&config);
+    if (config.periodUs < 500) config.periodUs = CONTROL_DEFAULT_PERIOD_US;
+    if (config.sendThresholdDeg < 0) config.sendThresholdDeg = 0;
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timerFd < 0) {
+        pthread_mutex_unlock(&controlLock);
+        LOGW("❌ timerfd_create failed: %s", strerror(errno));
+        return 0;
+    }
+    sendFn = send;
+
+    ticks = 0;
+    overruns = 0;
+    sends = 0;
+    framesSent = 0;
+    sendErrors = 0;
+    staleTicks = 0;
+    jitterLastUs = 0;
+    jitterSumUs = 0;
+    jitterMaxUs = 0;
+    workSumUs = 0;
+    workMaxUs = 0;
+    for (auto& b : jitterHistogram) b.store(0, std::memory_order_relaxed);
+    threadTid = 0;
+    realtime = 0;
+    cpuTimeAtExitUs = 0;
+    stopRequested = false;
+    running = true;
+    startUs = monotonicUs();
+
+    if (pthread_create(&thread, nullptr, controlLoop, nullptr) != 0) {
+        running = false;
+        close(timerFd);
+        timerFd = -1;
+        pthread_mutex_unlock(&controlLock);
+        LOGW("❌ pthread_create failed: %s", strerror(errno));
+        return 0;
+    }
+    started = true;
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("✅ Control thread every %d us (nice %d, rt %d, cpus 0x%X)",
+         config.periodUs, config.niceValue, config.rtPriority, config.cpuMask);
+    return 1;
+}
+
+extern "C" void controlThreadStop() {
+    pthread_mutex_lock(&controlLock);
+    if (!started) {
+        pthread_mutex_unlock(&controlLock);
+        return;
+    }
+
+    stopRequested = true;
+    pthread_join(thread, nullptr);
+    started = false;
+    close(timerFd);
+    timerFd = -1;
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("Control thread stopped: %llu ticks, %llu overruns, jitter max %lld us",
+         (unsigned long long)ticks.load(), (unsigned long long)overruns.load(), (long long)jitterMaxUs.load());
+}
+
+extern "C" int controlThreadRunning() {
+    return running.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+static int64_t jitterPercentileUs(double p) {
+    uint64_t total = 0;
+    for (const auto& b : jitterHistogram) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)ceil(p * (double)total);
+    uint64_t seen = 0;
+    for (int i = 0; i < CONTROL_JITTER_BUCKETS; i++) {
+        seen += jitterHistogram[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return (int64_t)(i + 1) * CONTROL_JITTER_BUCKET_US;   // Bucket upper bound
+    }
+    return (int64_t)CONTROL_JITTER_BUCKETS * CONTROL_JITTER_BUCKET_US;
+}
+
+extern "C" void controlThreadGetStats(ControlThreadStats* out) {
+    pthread_mutex_lock(&controlLock);
+    out->ticks = ticks.load(std::memory_order_relaxed);
+    out->overruns = overruns.load(std::memory_order_relaxed);
+    out->sends = sends.load(std::memory_order_relaxed);
+    out->framesSent = framesSent.load(std::memory_order_relaxed);
+    out->sendErrors = sendErrors.load(std::memory_order_relaxed);
+    out->staleTicks = staleTicks.load(std::memory_order_relaxed);
+    out->jitterLastUs = jitterLastUs.load(std::memory_order_relaxed);
+    out->jitterMeanUs = out->ticks > 0 ? jitterSumUs.load(std::memory_order_relaxed) / (int64_t)out->ticks : 0;
+    out->jitterP99Us = jitterPercentileUs(0.99);
+    out->jitterMaxUs = jitterMaxUs.load(std::memory_order_relaxed);
+    out->workMeanUs = out->ticks > 0 ? workSumUs.load(std::memory_order_relaxed) / (int64_t)out->ticks : 0;
+    out->workMaxUs = workMaxUs.load(std::memory_order_relaxed);
+    out->tid = threadTid.load(std::memory_order_relaxed);
+    out->realtime = realtime.load(std::memory_order_relaxed);
+    out->running = controlThreadRunning();
+
+    out->cpuTimeUs = cpuTimeAtExitUs.load(std::memory_order_relaxed);
+    out->runTimeUs = 0;
+    if (started) {
+        clockid_t clock;
+        if (out->running && pthread_getcpuclockid(thread, &clock) == 0) out->cpuTimeUs = threadCpuUs(clock);
+        out->runTimeUs = (out->running ? monotonicUs() : stopUs.load()) - startUs;
+    } else if (startUs != 0) {
+        out->runTimeUs = stopUs.load() - startUs;
+    }
+    pthread_mutex_unlock(&controlLock);
+}
+
+extern "C" int controlGetCommands(float* out, int maxChannels) {
+    int n = maxChannels < CONTROL_MAX_CHANNELS ? maxChannels : CONTROL_MAX_CHANNELS;
+    for (int i = 0; i < n; i++) out[i] = commandSent[i].load(std::memory_order_relaxed);
+    return n < 0 ? 0 : n;
+}
+
+extern "C" float controlGetCommand(int channel) {
+    if (channel < 0 || channel >= CONTROL_MAX_CHANNELS) return 0.0f;
+    return commandSent[channel].load(std::memory_order_relaxed);
+}
@@ -0,0 +1,116 @@
+/**
+ * control_thread.h
+ * Native Control Thread (C++)
+ *
+ * Replaces the main-looper control loops (GraphActivity.controlRunnable,
+ * guidance inside the camera analyzer): one native thread woken by a
+ * timerfd at a fixed period, independent of UI redraws and camera rate.
+ *
+ * Each tick reads the latest attitude / tracking error (published by the
+ * sensor and camera callbacks), runs guidance, mixes the layout and hands
+ * changed position commands to the sender (can_rx_thread's transport in
+ * the app). Wake-up jitter, overruns and work time are measured per tick.
+ * The thread holds the native core (core_owner.h) from start to stop.
+ * Guidance and sends are the guide / send stages of deadline_monitor.h.
+ */
+
+#ifndef CONTROL_THREAD_H
+#define CONTROL_THREAD_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTROL_DEFAULT_PERIOD_US 5000          // 200 Hz, rotation vector at SENSOR_DELAY_FASTEST
+#define CONTROL_DEFAULT_NICE (-10)              // Process.THREAD_PRIORITY_DISPLAY - 6 (above the rx thread)
+#define CONTROL_DEFAULT_SEND_THRESHOLD_DEG 1.0f // SharedBusManager's jitter filter
+#define CONTROL_TRACKING_TIMEOUT_US 200000      // Tracking error older than this is not used
+#define CONTROL_MAX_CHANNELS 16                 // CAN_DISPATCH_MAX_CHANNELS
+#define CONTROL_TRAVEL_DEG 25.0f
+#define CONTROL_JITTER_BUCKET_US 10             // Histogram resolution
+#define CONTROL_JITTER_BUCKETS 512
+
+// What drives the servos
+#define CONTROL_MODE_HOLD 0                     // Keep the last commands
+#define CONTROL_MODE_ATTITUDE 1                 // roll / pitch from the IMU (GraphActivity)
+#define CONTROL_MODE_TRACKING 2                 // guidanceUpdate on the tracking error (GuidanceController)
+
+// Sender for the commands of one tick. Returns frames sent, -1 on error
+typedef int (*ControlSendFn)(const WsCanFrame* frames, int count);
+
+typedef struct {
+    int periodUs;
+    int niceValue;          // setpriority() value, used without SCHED_FIFO
+    int rtPriority;         // SCHED_FIFO priority (1..99), 0 = normal scheduling
+    uint32_t cpuMask;       // Bit N = may run on CPU N, 0 = any CPU
+    float sendThresholdDeg; // Send a channel only when it moved more than this
+} ControlThreadConfig;
+
+typedef struct {
+    uint64_t ticks;         // Timer expirations handled
+    uint64_t overruns;      // Expirations missed (work or wake-up took > period)
+    uint64_t sends;         // Ticks that sent commands
+    uint64_t framesSent;
+    uint64_t sendErrors;
+    uint64_t staleTicks;    // Tracking mode without a fresh tracking error
+    int64_t jitterLastUs;   // Wake-up time - scheduled expiry
+    int64_t jitterMeanUs;
+    int64_t jitterP99Us;
+    int64_t jitterMaxUs;
+    int64_t workMeanUs;     // Guidance + mixing + send per tick
+    int64_t workMaxUs;
+    int64_t cpuTimeUs;
+    int64_t runTimeUs;
+    int32_t tid;
+    int32_t realtime;       // 1 = SCHED_FIFO granted
+    int32_t running;
+} ControlThreadStats;
+
+void controlThreadDefaultConfig(ControlThreadConfig* config);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Inputs (any thread, latest value wins)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Actuator layout: CAN node per channel and its roll / pitch mixing gains
+// (SharedBusManager.servoLayout). Returns 0 if count is out of range
+int controlSetLayout(const int* nodeIds, const float* rollGains, const float* pitchGains, int count);
+
+void controlSetMode(int mode);
+
+// Attitude in degrees (GyroManager)
+void controlSetAttitude(float roll, float pitch, float yaw);
+
+// Normalized tracking error (-1..+1), with its capture time on the
+// canRecorderNowUs() clock (0 = now)
+void controlSetTrackingError(float errorX, float errorY, int64_t timeUs);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Start the periodic thread. Returns 1 on success, 0 if already running,
+// the timer cannot be created or the thread cannot start
+int controlThreadStart(const ControlThreadConfig* config, ControlSendFn send);
+
+// Stop and join (returns within one period)
+void controlThreadStop();
+
+int controlThreadRunning();
+
+void controlThreadGetStats(ControlThreadStats* outStats);
+
+// Last command sent per channel (degrees). Returns channels written
+int controlGetCommands(float* out, int maxChannels);
+
+// Last command sent on one channel (degrees), 0 if out of range
+float controlGetCommand(int channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTROL_THREAD_H
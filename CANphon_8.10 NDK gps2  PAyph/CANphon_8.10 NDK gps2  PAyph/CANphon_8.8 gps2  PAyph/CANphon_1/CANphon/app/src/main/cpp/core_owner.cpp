@@ -0,0 +1,340 @@
+/**
+ * core_owner.cpp
+ * Native Core Ownership (C++)
+ *
+ * Queue: bounded MPSC ring with a sequence per cell. Cell i stores its
+ * sequence minus i, so the zero-initialized ring is already "free for
+ * lap 0" (no init call needed before the first submit). A producer
+ * reserves a position with a CAS on the tail, writes the command and
+ * releases the cell; the owner reads cells in order and stops at the
+ * first one still being written (its producer pumps once done).
+ *
+ * Ownership is a token. The control thread holds it for its whole run;
+ * otherwise a submitter takes it with a try-lock, drains, publishes and
+ * gives it back, then looks again for a written head cell (its producer
+ * may have found the token taken). Token acquire / release orders the
+ * owned state between successive owners.
+ */
+
+#define LOG_TAG "NativeCoreOwner"
+#include "core_owner.h"
+#include "native_log.h"
+#include <atomic>
+#include <cstring>
+#include <sched.h>
+
+static const uint32_t MASK = CORE_QUEUE_CAPACITY - 1;
+
+// Measurements (updates, samples, setters) may fill the queue up to here;
+// the rest is kept for state commands (init / start / stop / reset), so a
+// flood of samples never drops a stop
+static const uint32_t MEASUREMENT_LIMIT = CORE_QUEUE_CAPACITY - CORE_QUEUE_CAPACITY / 4;
+static const int WORDS = (sizeof(CoreSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+static_assert((CORE_QUEUE_CAPACITY & MASK) == 0, "capacity must be a power of two");
+
+// guidance_controller.cpp
+extern "C" {
+    void guidanceInit();
+    void guidanceStart();
+    void guidanceStop();
+    void guidanceUpdate(float errorX, float errorY, float dt);
+    void guidanceGetCommands(float* pitch, float* yaw);
+    void guidanceGetServoAngles(float* angles);
+    bool guidanceIsTracking();
+    void pidInit(int axis, float kp, float ki, float kd, float outputMin, float outputMax, float alpha);
+    float pidUpdate(int axis, float error, float dt);
+    void pidReset(int axis);
+    void fusionInit(float alpha);
+    void fusionUpdateGps(double lat, double lon, double alt, int64_t timestamp);
+    void fusionIntegrateImu(float accelN, float accelE, float accelD, float dt);
+    void fusionGetPosition(double* lat, double* lon, double* alt);
+    void fusionGetVelocity(double* velN, double* velE, double* velD);
+    bool fusionHasFix();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Command Queue
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct alignas(64) Cell {
+    std::atomic<uint32_t> seq;      // Sequence - cell index
+    CoreCommand command;
+};
+
+static Cell cells[CORE_QUEUE_CAPACITY];
+alignas(64) static std::atomic<uint32_t> tail{0};     // Next position to reserve
+alignas(64) static std::atomic<uint32_t> head{0};     // Next position to apply (owner writes)
+
+static std::atomic<uint64_t> submitted{0};
+static std::atomic<uint64_t> applied{0};
+static std::atomic<uint64_t> dropped{0};
+static std::atomic<uint64_t> drains{0};
+static std::atomic<uint64_t> ownerDrains{0};
+static std::atomic<uint64_t> published{0};
+static std::atomic<uint64_t> snapshotRetries{0};
+static std::atomic<uint64_t> violations{0};
+static std::atomic<uint32_t> queueHighWater{0};
+
+static bool enqueue(const CoreCommand* command, uint32_t limit) {
+    uint32_t pos = tail.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        // Signed: pos may be stale and the owner already past it
+        if ((int32_t)(pos - head.load(std::memory_order_relaxed)) >= (int32_t)limit) return false;
+        cell = &cells[pos & MASK];
+        uint32_t seq = cell->seq.load(std::memory_order_acquire) + (pos & MASK);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;                               // A lap behind: full
+        } else {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+    cell->command = *command;
+    cell->seq.store(pos + 1 - (pos & MASK), std::memory_order_release);
+
+    int32_t depth = (int32_t)(pos + 1 - head.load(std::memory_order_relaxed));
+    uint32_t high = queueHighWater.load(std::memory_order_relaxed);
+    while (depth > (int32_t)high && !queueHighWater.compare_exchange_weak(high, (uint32_t)depth, std::memory_order_relaxed)) {}
+    return true;
+}
+
+// Owner only
+static bool dequeue(CoreCommand* out) {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    Cell* cell = &cells[pos & MASK];
+    uint32_t seq = cell->seq.load(std::memory_order_acquire) + (pos & MASK);
+    if ((int32_t)(seq - (pos + 1)) < 0) return false;  // Empty, or still being written
+    *out = cell->command;
+    cell->seq.store(pos + CORE_QUEUE_CAPACITY - (pos & MASK), std::memory_order_release);
+    head.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+static bool isStateCommand(uint32_t type) {
+    switch (type) {
+        case CORE_CMD_GUIDANCE_INIT:
+        case CORE_CMD_GUIDANCE_START:
+        case CORE_CMD_GUIDANCE_STOP:
+        case CORE_CMD_PID_INIT:
+        case CORE_CMD_PID_RESET:
+        case CORE_CMD_FUSION_INIT:
+        case CORE_CMD_TELEM_INIT:
+            return true;
+    }
+    return false;
+}
+
+// The next cell to apply has been written (a reserved cell still being
+// written does not count: its producer pumps once done)
+static bool headReady() {
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    uint32_t seq = cells[pos & MASK].seq.load(std::memory_order_acquire) + (pos & MASK);
+    return (int32_t)(seq - (pos + 1)) >= 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Ownership
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define HOLDER_NONE 0
+#define HOLDER_SUBMITTER 1
+#define HOLDER_CONTROL 2
+
+static std::atomic<int> holder{HOLDER_NONE};
+static thread_local bool holding = false;
+static std::atomic<bool> violationLogged{false};
+
+// Owned state not kept by the modules themselves
+static float pidOutput[2] = {0, 0};
+
+static void apply(const CoreCommand* c) {
+    const double* v = c->v;
+    switch (c->type) {
+        case CORE_CMD_GUIDANCE_INIT: guidanceInit(); break;
+        case CORE_CMD_GUIDANCE_START: guidanceStart(); break;
+        case CORE_CMD_GUIDANCE_STOP: guidanceStop(); break;
+        case CORE_CMD_GUIDANCE_UPDATE: guidanceUpdate((float)v[0], (float)v[1], (float)v[2]); break;
+        case CORE_CMD_PID_INIT:
+            pidInit(c->arg, (float)v[0], (float)v[1], (float)v[2], (float)v[3], (float)v[4], (float)v[5]);
+            break;
+        case CORE_CMD_PID_UPDATE: pidOutput[c->arg] = pidUpdate(c->arg, (float)v[0], (float)v[1]); break;
+        case CORE_CMD_PID_RESET: pidReset(c->arg); break;
+        case CORE_CMD_FUSION_INIT: fusionInit((float)v[0]); break;
+        case CORE_CMD_FUSION_GPS: fusionUpdateGps(v[0], v[1], v[2], (int64_t)v[3]); break;
+        case CORE_CMD_FUSION_IMU: fusionIntegrateImu((float)v[0], (float)v[1], (float)v[2], (float)v[3]); break;
+        case CORE_CMD_TELEM_INIT: telemetryInit(); break;
+        case CORE_CMD_TELEM_TIMESTAMP: telemetrySetTimestamp((uint32_t)v[0]); break;
+        case CORE_CMD_TELEM_ORIENTATION: telemetrySetOrientation((float)v[0], (float)v[1], (float)v[2]); break;
+        case CORE_CMD_TELEM_ACCEL: telemetrySetAccelerometer((float)v[0], (float)v[1], (float)v[2]); break;
+        case CORE_CMD_TELEM_PRESSURE: telemetrySetPressure((float)v[0], (float)v[1]); break;
+        case CORE_CMD_TELEM_GPS:
+            telemetrySetGPS(v[0], v[1], (float)v[2], (float)v[3], (float)v[4], (int)v[5], (int)v[6], (float)v[7]);
+            break;
+        case CORE_CMD_TELEM_SERVO_CMD:
+            telemetrySetServoCmd((float)v[0], (float)v[1], (float)v[2], (float)v[3]);
+            break;
+        case CORE_CMD_TELEM_SERVO_FB:
+            telemetrySetServoFb((float)v[0], (float)v[1], (float)v[2], (float)v[3]);
+            break;
+        case CORE_CMD_TELEM_SERVO_STATUS: telemetrySetServoStatus((int)v[0]); break;
+        case CORE_CMD_TELEM_TRACKING: telemetrySetTracking((int)v[0], (int)v[1], (int)v[2], (int)v[3]); break;
+        case CORE_CMD_TELEM_BATTERY: telemetrySetBattery((int)v[0], (int)v[1], (int)v[2]); break;
+        case CORE_CMD_TELEM_TEMPERATURE: telemetrySetTemperature((float)v[0]); break;
+    }
+}
+
+extern "C" int coreDrain() {
+    CoreCommand c;
+    int n = 0;
+    while (dequeue(&c)) {
+        apply(&c);
+        n++;
+    }
+    if (n > 0) {
+        applied.fetch_add((uint64_t)n, std::memory_order_relaxed);
+        if (holder.load(std::memory_order_relaxed) == HOLDER_CONTROL) ownerDrains.fetch_add(1, std::memory_order_relaxed);
+        else drains.fetch_add(1, std::memory_order_relaxed);
+    }
+    return n;
+}
+
+// Take the token if free, drain, publish, hand it back; again while the
+// head cell is ready. A producer that finds the token taken leaves its
+// command to the holder, who looks again after handing the token back:
+// the fences make either the producer's CAS see the token free or the
+// holder's look see the written cell
+static void pump() {
+    for (;;) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!headReady()) return;
+        int expected = HOLDER_NONE;
+        if (!holder.compare_exchange_strong(expected, HOLDER_SUBMITTER, std::memory_order_acquire)) return;
+        holding = true;
+        int n = coreDrain();
+        if (n > 0) corePublish();
+        holding = false;
+        holder.store(HOLDER_NONE, std::memory_order_release);
+    }
+}
+
+extern "C" void coreClaim() {
+    if (holding) return;
+    for (;;) {
+        int expected = HOLDER_NONE;
+        if (holder.compare_exchange_weak(expected, HOLDER_CONTROL, std::memory_order_acquire)) break;
+        sched_yield();      // A submitter is draining (microseconds)
+    }
+    holding = true;
+    coreDrain();
+    corePublish();
+}
+
+extern "C" void coreRelease() {
+    if (!holding) return;
+    coreDrain();
+    corePublish();
+    holding = false;
+    holder.store(HOLDER_NONE, std::memory_order_release);
+    pump();
+}
+
+extern "C" int coreIsOwner() {
+    return holding ? 1 : 0;
+}
+
+extern "C" void coreCheckOwner(const char* function) {
+    if (holding || holder.load(std::memory_order_relaxed) == HOLDER_NONE) return;
+    violations.fetch_add(1, std::memory_order_relaxed);
+    if (!violationLogged.exchange(true, std::memory_order_relaxed)) {
+        LOGW("❌ %s called off the core owner thread (state is owned, use coreSubmit)", function);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Submit
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int coreSubmit(const CoreCommand* command) {
+    if (command->type == 0 || command->type >= CORE_CMD_COUNT) return 0;
+    if ((command->type == CORE_CMD_PID_INIT || command->type == CORE_CMD_PID_UPDATE ||
+         command->type == CORE_CMD_PID_RESET) && (command->arg < 0 || command->arg > 1)) {
+        return 0;
+    }
+    if (!enqueue(command, isStateCommand(command->type) ? CORE_QUEUE_CAPACITY : MEASUREMENT_LIMIT)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    if (holding) {
+        coreDrain();        // Submitted from the owner (e.g. a param listener): apply in order now
+        return 1;
+    }
+    pump();
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Snapshot (seqlock: odd sequence = publish in progress)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static std::atomic<uint32_t> snapshotSeq{0};
+static std::atomic<uint64_t> snapshotWords[WORDS];
+
+extern "C" void corePublish() {
+    CoreSnapshot s;
+    memset(&s, 0, sizeof(s));
+    s.sequence = published.load(std::memory_order_relaxed) + 1;
+    s.applied = applied.load(std::memory_order_relaxed);
+    s.tracking = guidanceIsTracking() ? 1 : 0;
+    guidanceGetCommands(&s.pitchCmd, &s.yawCmd);
+    guidanceGetServoAngles(s.servoAngles);
+    s.pidOutput[0] = pidOutput[0];
+    s.pidOutput[1] = pidOutput[1];
+    s.hasFix = fusionHasFix() ? 1 : 0;
+    fusionGetPosition(&s.lat, &s.lon, &s.alt);
+    fusionGetVelocity(&s.velN, &s.velE, &s.velD);
+    telemetryGetData(&s.telemetry);
+
+    uint64_t raw[WORDS] = {};
+    memcpy(raw, &s, sizeof(s));
+    snapshotSeq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < WORDS; i++) snapshotWords[i].store(raw[i], std::memory_order_relaxed);
+    snapshotSeq.fetch_add(1, std::memory_order_release);
+    published.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" void coreSnapshot(CoreSnapshot* out) {
+    uint64_t raw[WORDS];
+    for (;;) {
+        uint32_t s = snapshotSeq.load(std::memory_order_acquire);
+        if (!(s & 1)) {
+            for (int i = 0; i < WORDS; i++) raw[i] = snapshotWords[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s == snapshotSeq.load(std::memory_order_relaxed)) break;
+        }
+        snapshotRetries.fetch_add(1, std::memory_order_relaxed);
+    }
+    memcpy(out, raw, sizeof(*out));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void coreOwnerGetStats(CoreOwnerStats* out) {
+    out->submitted = submitted.load(std::memory_order_relaxed);
+    out->applied = applied.load(std::memory_order_relaxed);
+    out->dropped = dropped.load(std::memory_order_relaxed);
+    out->drains = drains.load(std::memory_order_relaxed);
+    out->ownerDrains = ownerDrains.load(std::memory_order_relaxed);
+    out->published = published.load(std::memory_order_relaxed);
+    out->snapshotRetries = snapshotRetries.load(std::memory_order_relaxed);
+    out->violations = violations.load(std::memory_order_relaxed);
+    out->queueHighWater = queueHighWater.load(std::memory_order_relaxed);
+    out->ownedByControl = holder.load(std::memory_order_relaxed) == HOLDER_CONTROL ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * core_owner.h
+ * Native Core Ownership (C++)
+ *
+ * The estimator / controller state (guidance + PID, IMU / GPS fusion, the
+ * telemetry record) is plain static data with exactly one owner at a time:
+ * the control thread while it runs, otherwise whichever caller currently
+ * holds the core. Every other thread (camera analyzer, sensor callbacks,
+ * UI, streamer) talks to it through:
+ *
+ *   - a bounded lock-free command queue (MPSC): set-points, measurements,
+ *     init / start / stop. Applied by the owner in submission order.
+ *   - a published snapshot (seqlock over atomic words) of the outputs,
+ *     taken after each drain / control tick. Readers never block the owner.
+ *
+ * With no control thread the submitting thread takes the core for the
+ * drain (try-lock, never waits), so single-threaded callers see their
+ * command applied when coreSubmit returns.
+ *
+ * Vision state (tracker, its Kalman filter, discriminator) belongs to the
+ * camera analyzer thread, filter tables (filters.cpp) to the caller of
+ * each id; they are not routed through here.
+ */
+
+#ifndef CORE_OWNER_H
+#define CORE_OWNER_H
+
+#include <cstdint>
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CORE_QUEUE_CAPACITY 1024            // Commands (power of two)
+#define CORE_COMMAND_VALUES 8
+
+// Commands (v[] in the order of the owner-side function's arguments)
+#define CORE_CMD_GUIDANCE_INIT 1            // Controller reset from the parameter store
+#define CORE_CMD_GUIDANCE_START 2
+#define CORE_CMD_GUIDANCE_STOP 3
+#define CORE_CMD_GUIDANCE_UPDATE 4          // errorX, errorY, dt
+#define CORE_CMD_PID_INIT 5                 // arg = axis; kp, ki, kd, outputMin, outputMax, alpha
+#define CORE_CMD_PID_UPDATE 6               // arg = axis; error, dt
+#define CORE_CMD_PID_RESET 7                // arg = axis
+#define CORE_CMD_FUSION_INIT 8              // alpha
+#define CORE_CMD_FUSION_GPS 9               // lat, lon, alt, timestamp
+#define CORE_CMD_FUSION_IMU 10              // accelN, accelE, accelD, dt
+#define CORE_CMD_TELEM_INIT 11
+#define CORE_CMD_TELEM_TIMESTAMP 12         // ts
+#define CORE_CMD_TELEM_ORIENTATION 13       // roll, pitch, yaw
+#define CORE_CMD_TELEM_ACCEL 14             // x, y, z
+#define CORE_CMD_TELEM_PRESSURE 15          // hPa, altitude
+#define CORE_CMD_TELEM_GPS 16               // lat, lon, alt, speed, heading, satellites, fix, hdop
+#define CORE_CMD_TELEM_SERVO_CMD 17         // s1..s4
+#define CORE_CMD_TELEM_SERVO_FB 18          // s1..s4
+#define CORE_CMD_TELEM_SERVO_STATUS 19      // online mask
+#define CORE_CMD_TELEM_TRACKING 20          // x, y, w, h
+#define CORE_CMD_TELEM_BATTERY 21           // percent, charging, mV
+#define CORE_CMD_TELEM_TEMPERATURE 22       // °C
+#define CORE_CMD_COUNT 23
+
+typedef struct {
+    uint32_t type;
+    int32_t arg;
+    double v[CORE_COMMAND_VALUES];
+} CoreCommand;
+
+// Outputs of the owned state, as of one drain / tick
+typedef struct {
+    uint64_t sequence;          // Publishes since start (0 = nothing published yet)
+    uint64_t applied;           // Commands applied when it was taken
+    // Guidance
+    int32_t tracking;
+    float pitchCmd, yawCmd;
+    float servoAngles[4];
+    float pidOutput[2];         // Last CORE_CMD_PID_UPDATE result per axis
+    // Fusion
+    int32_t hasFix;
+    double lat, lon, alt;
+    double velN, velE, velD;
+    // Telemetry record
+    TelemetryData telemetry;
+} CoreSnapshot;
+
+typedef struct {
+    uint64_t submitted;
+    uint64_t applied;
+    uint64_t dropped;           // Queue full (measurements past 3/4)
+    uint64_t drains;            // Drains by a submitting thread (no control thread)
+    uint64_t ownerDrains;       // Drains by the control thread
+    uint64_t published;
+    uint64_t snapshotRetries;   // Reader copies that raced a publish
+    uint64_t violations;        // Owner-side calls from a thread not holding the core
+    uint32_t queueHighWater;
+    int32_t ownedByControl;     // 1 = the control thread holds the core
+} CoreOwnerStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Any thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Queue a command. Returns 1 if queued, 0 if the queue is full (dropped,
+// counted) or the type is unknown. Measurements see the queue full at
+// three quarters, init / start / stop / reset only when it really is
+int coreSubmit(const CoreCommand* command);
+
+// Latest published outputs (never blocks; retries while a publish runs)
+void coreSnapshot(CoreSnapshot* out);
+
+void coreOwnerGetStats(CoreOwnerStats* outStats);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Owner
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Take the core for the calling thread until coreRelease (the control
+// thread, for its whole run). Waits out a draining submitter
+void coreClaim();
+
+// Drain, publish and hand the core back
+void coreRelease();
+
+// Apply everything queued so far. Returns commands applied
+int coreDrain();
+
+// Copy the owned state into the snapshot
+void corePublish();
+
+// 1 if the calling thread holds the core
+int coreIsOwner();
+
+// Owner-side entry points call this: a call from another thread while the
+// core is held is counted (and logged once). With nobody holding the core
+// direct calls are single-threaded use (host tools) and pass
+void coreCheckOwner(const char* function);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define CORE_CHECK_OWNER() coreCheckOwner(__func__)
+
+#endif // CORE_OWNER_H
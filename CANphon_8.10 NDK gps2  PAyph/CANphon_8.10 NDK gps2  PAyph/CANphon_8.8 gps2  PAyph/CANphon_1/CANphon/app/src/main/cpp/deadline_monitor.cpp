@@ -0,0 +1,277 @@
+/**
+ * deadline_monitor.cpp
+ * Pipeline Stage Deadlines (C++)
+ *
+ * Counters are relaxed atomics written by the stage's own thread. A
+ * policy belongs to the stages of one thread (predict: camera analyzer,
+ * hold: control thread, skip: detect), so engaging and releasing it
+ * never races another writer. Overruns go to a ring of seqlock slots
+ * tagged with their index; a reader skips a slot that is being written
+ * or already reused.
+ */
+
+#define LOG_TAG "NativeDeadline"
+#include "deadline_monitor.h"
+#include "can_recorder.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include <atomic>
+
+static const char* const STAGE_NAMES[DEADLINE_STAGES] = {
+    "capture", "preprocess", "detect", "track", "guide", "send"
+};
+static const char* const STAGE_TRACE_NAMES[DEADLINE_STAGES] = {
+    "deadline.capture", "deadline.preprocess", "deadline.detect",
+    "deadline.track", "deadline.guide", "deadline.send"
+};
+static const char* const POLICY_NAMES[DEADLINE_POLICIES] = {
+    "skipping detection", "holding commands", "predicting"
+};
+
+static const int STAGE_POLICY[DEADLINE_STAGES] = {
+    DEADLINE_POLICY_PREDICT,            // capture
+    DEADLINE_POLICY_PREDICT,            // preprocess
+    DEADLINE_POLICY_SKIP_DETECTION,     // detect
+    DEADLINE_POLICY_PREDICT,            // track
+    DEADLINE_POLICY_HOLD_COMMAND,       // guide
+    DEADLINE_POLICY_HOLD_COMMAND,       // send
+};
+
+// 30 fps camera + half a frame; YOLO on a mid-range phone; control tick at 200 Hz
+static const int64_t DEFAULT_BUDGET_US[DEADLINE_STAGES] = { 50000, 15000, 45000, 5000, 1000, 2000 };
+static const int DEFAULT_MISS_LIMIT[DEADLINE_STAGES] = { 3, 3, 2, 3, 5, 3 };
+
+// ═══════════════════════════════════════════════════════════════════════════
+// State
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct StageState {
+    std::atomic<int64_t> budgetUs;     // 0 = default
+    std::atomic<int32_t> missLimit;    // Limit + 1, 0 = default
+    std::atomic<uint64_t> runs;
+    std::atomic<uint64_t> misses;
+    std::atomic<int64_t> lastUs;
+    std::atomic<int64_t> maxUs;
+    std::atomic<uint32_t> consecutive;
+    std::atomic<uint32_t> gated;        // deadlineAdmit calls since the policy engaged
+};
+
+struct RingSlot {
+    std::atomic<uint32_t> seq;          // Odd = write in progress
+    std::atomic<uint64_t> index;        // Overrun number held (+1, 0 = empty)
+    std::atomic<int64_t> timeUs;
+    std::atomic<int64_t> durationUs;
+    std::atomic<int64_t> budgetUs;
+    std::atomic<int32_t> stage;
+    std::atomic<int32_t> consecutive;
+};
+
+static StageState stages[DEADLINE_STAGES];
+static RingSlot ring[DEADLINE_RING_SIZE];
+static std::atomic<uint64_t> overruns(0);
+static std::atomic<uint32_t> activePolicies(0);
+static std::atomic<uint64_t> engaged[DEADLINE_POLICIES];
+static std::atomic<uint64_t> detectionsSkipped(0);
+static std::atomic<uint64_t> sendsHeld(0);
+static std::atomic<uint64_t> predictedTicks(0);
+
+static bool validStage(int stage) {
+    return stage >= 0 && stage < DEADLINE_STAGES;
+}
+
+static int64_t budgetOf(int stage) {
+    int64_t b = stages[stage].budgetUs.load(std::memory_order_relaxed);
+    return b > 0 ? b : DEFAULT_BUDGET_US[stage];
+}
+
+static int missLimitOf(int stage) {
+    int32_t limit = stages[stage].missLimit.load(std::memory_order_relaxed);
+    return limit > 0 ? limit - 1 : DEFAULT_MISS_LIMIT[stage];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int deadlineConfigure(int stage, int64_t budgetUs, int missLimit) {
+    if (!validStage(stage) || budgetUs <= 0 || missLimit < 0) return 0;
+    stages[stage].budgetUs.store(budgetUs, std::memory_order_relaxed);
+    stages[stage].missLimit.store(missLimit + 1, std::memory_order_relaxed);
+    LOGI("Deadline %s: %lld us, policy after %d misses", STAGE_NAMES[stage], (long long)budgetUs, missLimit);
+    return 1;
+}
+
+extern "C" void deadlineReset() {
+    for (int i = 0; i < DEADLINE_STAGES; i++) {
+        StageState& s = stages[i];
+        s.runs.store(0, std::memory_order_relaxed);
+        s.misses.store(0, std::memory_order_relaxed);
+        s.lastUs.store(0, std::memory_order_relaxed);
+        s.maxUs.store(0, std::memory_order_relaxed);
+        s.consecutive.store(0, std::memory_order_relaxed);
+        s.gated.store(0, std::memory_order_relaxed);
+    }
+    for (auto& slot : ring) slot.index.store(0, std::memory_order_relaxed);
+    for (auto& e : engaged) e.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    activePolicies.store(0, std::memory_order_relaxed);
+    detectionsSkipped.store(0, std::memory_order_relaxed);
+    sendsHeld.store(0, std::memory_order_relaxed);
+    predictedTicks.store(0, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stages
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void recordOverrun(int stage, int64_t durationUs, int64_t budgetUs, uint32_t consecutive) {
+    uint64_t index = overruns.fetch_add(1, std::memory_order_relaxed);
+    RingSlot& slot = ring[index & (DEADLINE_RING_SIZE - 1)];
+    slot.seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.index.store(index + 1, std::memory_order_relaxed);
+    slot.timeUs.store(canRecorderNowUs(), std::memory_order_relaxed);
+    slot.durationUs.store(durationUs, std::memory_order_relaxed);
+    slot.budgetUs.store(budgetUs, std::memory_order_relaxed);
+    slot.stage.store(stage, std::memory_order_relaxed);
+    slot.consecutive.store((int32_t)consecutive, std::memory_order_relaxed);
+    slot.seq.fetch_add(1, std::memory_order_release);
+}
+
+// No stage of the policy still at its limit
+static bool policyClear(int policy) {
+    for (int i = 0; i < DEADLINE_STAGES; i++) {
+        if (STAGE_POLICY[i] != policy) continue;
+        int limit = missLimitOf(i);
+        if (limit > 0 && stages[i].consecutive.load(std::memory_order_relaxed) >= (uint32_t)limit) return false;
+    }
+    return true;
+}
+
+extern "C" int deadlineRecord(int stage, int64_t durationUs) {
+    if (!validStage(stage)) return 0;
+    StageState& s = stages[stage];
+    int64_t budgetUs = budgetOf(stage);
+    int policy = STAGE_POLICY[stage];
+    uint32_t bit = 1u << policy;
+
+    s.runs.fetch_add(1, std::memory_order_relaxed);
+    s.lastUs.store(durationUs, std::memory_order_relaxed);
+    if (durationUs > s.maxUs.load(std::memory_order_relaxed)) s.maxUs.store(durationUs, std::memory_order_relaxed);
+
+    if (durationUs <= budgetUs) {
+        if (s.consecutive.load(std::memory_order_relaxed) == 0) return 0;
+        s.consecutive.store(0, std::memory_order_relaxed);
+        if ((activePolicies.load(std::memory_order_relaxed) & bit) && policyClear(policy)) {
+            activePolicies.fetch_and(~bit, std::memory_order_relaxed);
+            LOGI("Deadline %s back within budget (%lld us): no longer %s",
+                 STAGE_NAMES[stage], (long long)durationUs, POLICY_NAMES[policy]);
+        }
+        return 0;
+    }
+
+    uint32_t consecutive = s.consecutive.load(std::memory_order_relaxed) + 1;
+    s.consecutive.store(consecutive, std::memory_order_relaxed);
+    s.misses.fetch_add(1, std::memory_order_relaxed);
+    recordOverrun(stage, durationUs, budgetUs, consecutive);
+    if (traceActive.load(std::memory_order_relaxed)) traceInstant(STAGE_TRACE_NAMES[stage]);
+
+    int limit = missLimitOf(stage);
+    if (limit > 0 && consecutive >= (uint32_t)limit &&
+        !(activePolicies.fetch_or(bit, std::memory_order_relaxed) & bit)) {
+        s.gated.store(0, std::memory_order_relaxed);
+        engaged[policy].fetch_add(1, std::memory_order_relaxed);
+        LOGW("⚠️ Deadline %s missed %u in a row (%lld us > %lld us): %s",
+             STAGE_NAMES[stage], consecutive, (long long)durationUs, (long long)budgetUs, POLICY_NAMES[policy]);
+    }
+    return 1;
+}
+
+extern "C" int deadlineAdmit(int stage) {
+    int every;
+    std::atomic<uint64_t>* refused;
+    if (stage == DEADLINE_STAGE_DETECT) {
+        every = DEADLINE_SKIP_DETECTION_EVERY;
+        refused = &detectionsSkipped;
+    } else if (stage == DEADLINE_STAGE_SEND) {
+        every = DEADLINE_HOLD_PROBE_TICKS;
+        refused = &sendsHeld;
+    } else {
+        return 1;
+    }
+    if (!(activePolicies.load(std::memory_order_relaxed) & (1u << STAGE_POLICY[stage]))) return 1;
+
+    // Probe on every N-th call: the run that tells whether the stage recovered
+    uint32_t n = stages[stage].gated.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (n % (uint32_t)every == 0) return 1;
+    refused->fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+extern "C" int deadlinePolicyActive(int policy) {
+    if (policy < 0 || policy >= DEADLINE_POLICIES) return 0;
+    return (activePolicies.load(std::memory_order_relaxed) >> policy) & 1;
+}
+
+extern "C" void deadlineCountPredicted() {
+    predictedTicks.fetch_add(1, std::memory_order_relaxed);
+}
+
+DeadlineScope::DeadlineScope(int s) : stage(s), startUs(canRecorderNowUs()) {}
+
+DeadlineScope::~DeadlineScope() {
+    deadlineRecord(stage, canRecorderNowUs() - startUs);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void deadlineGetStats(DeadlineStats* out) {
+    for (int i = 0; i < DEADLINE_STAGES; i++) {
+        const StageState& s = stages[i];
+        out->runs[i] = s.runs.load(std::memory_order_relaxed);
+        out->misses[i] = s.misses.load(std::memory_order_relaxed);
+        out->lastUs[i] = s.lastUs.load(std::memory_order_relaxed);
+        out->maxUs[i] = s.maxUs.load(std::memory_order_relaxed);
+        out->budgetUs[i] = budgetOf(i);
+        out->consecutive[i] = s.consecutive.load(std::memory_order_relaxed);
+    }
+    for (int p = 0; p < DEADLINE_POLICIES; p++) out->engaged[p] = engaged[p].load(std::memory_order_relaxed);
+    out->detectionsSkipped = detectionsSkipped.load(std::memory_order_relaxed);
+    out->sendsHeld = sendsHeld.load(std::memory_order_relaxed);
+    out->predictedTicks = predictedTicks.load(std::memory_order_relaxed);
+    out->overruns = overruns.load(std::memory_order_relaxed);
+    out->activePolicies = activePolicies.load(std::memory_order_relaxed);
+}
+
+extern "C" int deadlineRecentOverruns(DeadlineOverrun* out, int max) {
+    if (out == nullptr || max <= 0) return 0;
+    uint64_t total = overruns.load(std::memory_order_acquire);
+    uint64_t want = (uint64_t)max < total ? (uint64_t)max : total;
+    if (want > DEADLINE_RING_SIZE) want = DEADLINE_RING_SIZE;
+
+    int n = 0;
+    for (uint64_t index = total - want; index < total; index++) {
+        const RingSlot& slot = ring[index & (DEADLINE_RING_SIZE - 1)];
+        DeadlineOverrun o;
+        uint32_t s;
+        uint64_t held;
+        do {
+            s = slot.seq.load(std::memory_order_acquire);
+            held = slot.index.load(std::memory_order_relaxed);
+            o.timeUs = slot.timeUs.load(std::memory_order_relaxed);
+            o.durationUs = slot.durationUs.load(std::memory_order_relaxed);
+            o.budgetUs = slot.budgetUs.load(std::memory_order_relaxed);
+            o.stage = slot.stage.load(std::memory_order_relaxed);
+            o.consecutive = slot.consecutive.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((s & 1) || s != slot.seq.load(std::memory_order_relaxed));
+        if (held == index + 1) out[n++] = o;      // Not yet written / already reused: skipped
+    }
+    return n;
+}
+
+extern "C" const char* deadlineStageName(int stage) {
+    return validStage(stage) ? STAGE_NAMES[stage] : "?";
+}
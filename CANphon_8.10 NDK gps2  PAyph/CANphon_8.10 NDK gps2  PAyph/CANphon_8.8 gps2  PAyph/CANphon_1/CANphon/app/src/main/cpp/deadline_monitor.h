@@ -0,0 +1,131 @@
+/**
+ * deadline_monitor.h
+ * Pipeline Stage Deadlines (C++)
+ *
+ * Each stage of the tracking pipeline has a time budget:
+ *
+ *   capture     camera frame interval at the analyzer (GC pauses, camera stalls)
+ *   preprocess  ImageProxy -> bitmap
+ *   detect      YOLO
+ *   track       target selection, tracking error hand-off
+ *   guide       guidance update on the control thread
+ *   send        servo command write on the control thread
+ *
+ * Every run is recorded against it; an overrun is counted and kept
+ * (time-stamped) in a ring. A stage that misses missLimit times in a row
+ * engages its policy until it comes back within budget:
+ *
+ *   detect              -> skip detection (run it on every 2nd frame only)
+ *   capture, preprocess,
+ *   track               -> predict (the control thread keeps extrapolating
+ *                          the tracking error up to the stale timeout)
+ *   guide, send         -> hold (keep the last servo commands, probe with
+ *                          one send every DEADLINE_HOLD_PROBE_TICKS ticks)
+ *
+ * Each stage is recorded by one thread (camera analyzer / control thread);
+ * stats and the ring are read from any thread.
+ */
+
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEADLINE_STAGE_CAPTURE 0
+#define DEADLINE_STAGE_PREPROCESS 1
+#define DEADLINE_STAGE_DETECT 2
+#define DEADLINE_STAGE_TRACK 3
+#define DEADLINE_STAGE_GUIDE 4
+#define DEADLINE_STAGE_SEND 5
+#define DEADLINE_STAGES 6
+
+// Policies (bit N of the active mask = policy N)
+#define DEADLINE_POLICY_SKIP_DETECTION 0
+#define DEADLINE_POLICY_HOLD_COMMAND 1
+#define DEADLINE_POLICY_PREDICT 2
+#define DEADLINE_POLICIES 3
+
+#define DEADLINE_RING_SIZE 64                   // Overruns kept (power of two), oldest overwritten
+#define DEADLINE_SKIP_DETECTION_EVERY 2         // Detection on 1 frame in N while skipping
+#define DEADLINE_HOLD_PROBE_TICKS 10            // One send in N ticks while holding (50 ms at 200 Hz)
+
+typedef struct {
+    int64_t timeUs;         // End of the run (canRecorderNowUs clock)
+    int64_t durationUs;
+    int64_t budgetUs;
+    int32_t stage;
+    int32_t consecutive;    // Misses in a row including this one
+} DeadlineOverrun;
+
+typedef struct {
+    uint64_t runs[DEADLINE_STAGES];
+    uint64_t misses[DEADLINE_STAGES];
+    int64_t lastUs[DEADLINE_STAGES];
+    int64_t maxUs[DEADLINE_STAGES];
+    int64_t budgetUs[DEADLINE_STAGES];
+    uint32_t consecutive[DEADLINE_STAGES];      // Current run of misses
+    uint64_t engaged[DEADLINE_POLICIES];        // Times each policy kicked in
+    uint64_t detectionsSkipped;
+    uint64_t sendsHeld;
+    uint64_t predictedTicks;                    // Control ticks extrapolated past one camera interval
+    uint64_t overruns;                          // All misses (ring holds the last DEADLINE_RING_SIZE)
+    uint32_t activePolicies;                    // Bit mask
+} DeadlineStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Budget and the misses in a row that engage the stage's policy
+// (0 = count only). Returns 0 for a bad stage or budget
+int deadlineConfigure(int stage, int64_t budgetUs, int missLimit);
+
+// Counters and ring cleared, no policy active (budgets kept)
+void deadlineReset();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stages (each from its own thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// One run of a stage that just ended. Returns 1 if it was over budget
+int deadlineRecord(int stage, int64_t durationUs);
+
+// Whether to run a gated stage now (detect, send): 0 while its policy
+// skips / holds, except for the periodic probe. Other stages: always 1
+int deadlineAdmit(int stage);
+
+int deadlinePolicyActive(int policy);
+
+// The control thread counts ticks it extrapolated under the predict policy
+void deadlineCountPredicted();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats (any thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void deadlineGetStats(DeadlineStats* outStats);
+
+// Up to max most recent overruns, oldest first. Returns the count
+int deadlineRecentOverruns(DeadlineOverrun* out, int max);
+
+const char* deadlineStageName(int stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Times a native stage from construction to the end of the scope
+struct DeadlineScope {
+    int stage;
+    int64_t startUs;
+    explicit DeadlineScope(int s);
+    ~DeadlineScope();
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+};
+
+#endif // DEADLINE_MONITOR_H
@@ -0,0 +1,191 @@
+/**
+ * frame_arena.cpp
+ * Per-Frame Bump Arena (C++)
+ *
+ * One block per arena. An allocation that does not fit goes to its own
+ * heap chunk (kept on a list until the reset); the reset frees the chunks
+ * and, if the frame needed more than the block, replaces the block with
+ * one a quarter above the high-water mark.
+ */
+
+#define LOG_TAG "NativeArena"
+#include "frame_arena.h"
+#include "native_log.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+static const size_t DEFAULT_ALIGN = 16;
+static const size_t GROW_GRANULE = 4096;
+
+struct FrameArenaChunk {
+    FrameArenaChunk* next;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Registry (stats copied at each reset, read from any thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct RegistryEntry {
+    std::atomic<bool> active;
+    char name[24];
+    std::atomic<uint64_t> capacity;
+    std::atomic<uint64_t> highWater;
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> spills;
+    std::atomic<uint64_t> grows;
+};
+
+static RegistryEntry registry[FRAME_ARENA_MAX_ARENAS];
+
+// Serializes init / destroy (never taken by alloc or reset)
+static std::mutex controlLock;
+
+static void publishStats(const FrameArena* a) {
+    if (a->slot <= 0) return;
+    RegistryEntry& e = registry[a->slot - 1];
+    e.capacity.store(a->capacity, std::memory_order_relaxed);
+    e.highWater.store(a->highWater, std::memory_order_relaxed);
+    e.frames.store(a->frames, std::memory_order_relaxed);
+    e.spills.store(a->spills, std::memory_order_relaxed);
+    e.grows.store(a->grows, std::memory_order_relaxed);
+}
+
+static size_t roundUp(size_t value, size_t granule) {
+    return (value + granule - 1) / granule * granule;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Arena
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int frameArenaInit(FrameArena* a, const char* name, size_t bytes) {
+    if (!a) return 0;
+    memset(a, 0, sizeof(*a));
+    strncpy(a->name, name ? name : "arena", sizeof(a->name) - 1);
+    if (bytes == 0) bytes = FRAME_ARENA_DEFAULT_BYTES;
+    a->base = new (std::nothrow) uint8_t[bytes];
+    if (!a->base) return 0;
+    a->capacity = bytes;
+
+    std::lock_guard<std::mutex> lock(controlLock);
+    for (int i = 0; i < FRAME_ARENA_MAX_ARENAS; i++) {
+        if (!registry[i].active.load(std::memory_order_relaxed)) {
+            memcpy(registry[i].name, a->name, sizeof(registry[i].name));
+            a->slot = i + 1;
+            publishStats(a);
+            registry[i].active.store(true, std::memory_order_release);
+            break;
+        }
+    }
+    return 1;
+}
+
+static void freeSpill(FrameArena* a) {
+    while (a->spill) {
+        FrameArenaChunk* next = a->spill->next;
+        delete[] reinterpret_cast<uint8_t*>(a->spill);
+        a->spill = next;
+    }
+}
+
+extern "C" void frameArenaDestroy(FrameArena* a) {
+    if (!a) return;
+    freeSpill(a);
+    delete[] a->base;
+    if (a->slot > 0) {
+        std::lock_guard<std::mutex> lock(controlLock);
+        registry[a->slot - 1].active.store(false, std::memory_order_release);
+    }
+    memset(a, 0, sizeof(*a));
+}
+
+extern "C" void* frameArenaAlloc(FrameArena* a, size_t bytes, size_t align) {
+    if (align == 0) align = DEFAULT_ALIGN;
+
+    if (a->base) {
+        uintptr_t start = reinterpret_cast<uintptr_t>(a->base);
+        uintptr_t p = (start + a->used + align - 1) & ~(uintptr_t)(align - 1);
+        size_t end = (size_t)(p - start) + bytes;
+        if (end <= a->capacity) {
+            a->frameBytes += end - a->used;
+            a->used = end;
+            return reinterpret_cast<void*>(p);
+        }
+    }
+
+    // Spill: this frame only, the reset grows the block past it
+    size_t chunkBytes = sizeof(FrameArenaChunk) + bytes + align;
+    uint8_t* raw = new (std::nothrow) uint8_t[chunkBytes];
+    if (!raw) return nullptr;
+    FrameArenaChunk* chunk = reinterpret_cast<FrameArenaChunk*>(raw);
+    chunk->next = a->spill;
+    a->spill = chunk;
+    a->spills++;
+    a->frameBytes += bytes + align;
+    uintptr_t p = reinterpret_cast<uintptr_t>(raw + sizeof(FrameArenaChunk));
+    p = (p + align - 1) & ~(uintptr_t)(align - 1);
+    return reinterpret_cast<void*>(p);
+}
+
+extern "C" void frameArenaReset(FrameArena* a) {
+    if (a->frameBytes > a->highWater) a->highWater = a->frameBytes;
+    freeSpill(a);
+
+    if (a->highWater > a->capacity) {
+        size_t bytes = roundUp(a->highWater + a->highWater / 4, GROW_GRANULE);
+        uint8_t* block = new (std::nothrow) uint8_t[bytes];
+        if (block) {
+            delete[] a->base;
+            a->base = block;
+            a->capacity = bytes;
+            a->grows++;
+            LOGI("Arena %s: frame needed %zu B, block grown to %zu KB", a->name, a->highWater, bytes / 1024);
+        }
+    }
+
+    a->used = 0;
+    a->frameBytes = 0;
+    a->frames++;
+    publishStats(a);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void frameArenaGetStats(const FrameArena* a, FrameArenaStats* out) {
+    if (!a || !out) return;
+    memcpy(out->name, a->name, sizeof(out->name));
+    out->capacity = a->capacity;
+    out->highWater = a->frameBytes > a->highWater ? a->frameBytes : a->highWater;
+    out->frames = a->frames;
+    out->spills = a->spills;
+    out->grows = a->grows;
+}
+
+extern "C" int frameArenaCount() {
+    int count = 0;
+    for (int i = 0; i < FRAME_ARENA_MAX_ARENAS; i++) {
+        if (registry[i].active.load(std::memory_order_acquire)) count++;
+    }
+    return count;
+}
+
+// index-th active arena (0 .. frameArenaCount() - 1). Returns 0 if none
+extern "C" int frameArenaStatsAt(int index, FrameArenaStats* out) {
+    if (!out || index < 0) return 0;
+    for (int i = 0; i < FRAME_ARENA_MAX_ARENAS; i++) {
+        const RegistryEntry& e = registry[i];
+        if (!e.active.load(std::memory_order_acquire) || index-- > 0) continue;
+        memcpy(out->name, e.name, sizeof(out->name));
+        out->capacity = e.capacity.load(std::memory_order_relaxed);
+        out->highWater = e.highWater.load(std::memory_order_relaxed);
+        out->frames = e.frames.load(std::memory_order_relaxed);
+        out->spills = e.spills.load(std::memory_order_relaxed);
+        out->grows = e.grows.load(std::memory_order_relaxed);
+        return 1;
+    }
+    return 0;
+}
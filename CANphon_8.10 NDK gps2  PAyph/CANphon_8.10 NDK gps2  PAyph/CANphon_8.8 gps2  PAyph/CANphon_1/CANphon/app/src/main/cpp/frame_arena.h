@@ -0,0 +1,89 @@
+/**
+ * frame_arena.h
+ * Per-Frame Bump Arena (C++)
+ *
+ * Scratch memory for work whose size changes frame to frame (detections,
+ * score tables, pairwise matrices). Allocation is a pointer bump; a reset
+ * at the end of the frame drops everything at once. Nothing is capped:
+ * a frame that outgrows the block spills into heap chunks, and the reset
+ * after it grows the block to the high-water mark, so the steady state
+ * does no heap calls at all.
+ *
+ * An arena belongs to one thread. Pointers are valid until the next reset.
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_ARENA_DEFAULT_BYTES (64 * 1024)
+#define FRAME_ARENA_MAX_ARENAS 16           // Registered for frameArenaStatsAt
+
+typedef struct FrameArenaChunk FrameArenaChunk;
+
+typedef struct {
+    char name[24];
+    uint8_t* base;
+    size_t capacity;
+    size_t used;                // In the block
+    size_t frameBytes;          // This frame, block + spill
+    size_t highWater;           // Largest frameBytes since init
+    FrameArenaChunk* spill;     // Heap chunks of this frame (freed at reset)
+    uint64_t frames;            // Resets
+    uint64_t spills;            // Allocations that did not fit the block
+    uint64_t grows;             // Block reallocations at reset
+    int32_t slot;               // Registry index + 1, 0 = not registered
+} FrameArena;
+
+typedef struct {
+    char name[24];
+    uint64_t capacity;
+    uint64_t highWater;
+    uint64_t frames;
+    uint64_t spills;
+    uint64_t grows;
+} FrameArenaStats;
+
+// Allocate the block and register the arena for stats. Returns 0 if the
+// allocation fails
+int frameArenaInit(FrameArena* arena, const char* name, size_t bytes);
+void frameArenaDestroy(FrameArena* arena);
+
+// `bytes` aligned to `align` (power of two, 0 = 16). NULL only if the heap
+// is exhausted
+void* frameArenaAlloc(FrameArena* arena, size_t bytes, size_t align);
+
+// End of frame: everything allocated since the last reset is released
+void frameArenaReset(FrameArena* arena);
+
+void frameArenaGetStats(const FrameArena* arena, FrameArenaStats* outStats);
+
+// Registered arenas (for the high-water report)
+int frameArenaCount();
+int frameArenaStatsAt(int index, FrameArenaStats* outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+template <typename T>
+static inline T* frameArenaArray(FrameArena* arena, size_t count) {
+    return static_cast<T*>(frameArenaAlloc(arena, count * sizeof(T), alignof(T)));
+}
+
+// Resets the arena at the end of a scope (one frame of work)
+struct FrameArenaFrame {
+    FrameArena* arena;
+    explicit FrameArenaFrame(FrameArena* a) : arena(a) {}
+    ~FrameArenaFrame() { frameArenaReset(arena); }
+    FrameArenaFrame(const FrameArenaFrame&) = delete;
+    FrameArenaFrame& operator=(const FrameArenaFrame&) = delete;
+};
+
+#endif // FRAME_ARENA_H
@@ -6,13 +6,18 @@
  * - PID Controller
  * - X-Mixing للـ Servos
  * - Low-Pass Filter للتنعيم
+ *
+ * State here is owned by the core owner (core_owner.h): the control
+ * thread, or the submitter draining the command queue. Other threads
+ * go through coreSubmit / coreSnapshot.
  */
 
-#include <cmath>
-#include <android/log.h>
-
 #define LOG_TAG "NativeGuidance"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#include "core_owner.h"
+#include "native_log.h"
+#include "param_store.h"
+#include <cmath>
+#include <cstdint>
 
 // ═══════════════════════════════════════════════════════════════════════════
 // PID Controller
@@ -39,8 +44,19 @@ struct PIDController {
 
 static PIDController pidX = {0}, pidY = {0};
 
+// Filter alphas are tuned per camera frame; other update rates get the
+// same time constant (the control thread updates at IMU rate)
+static const float TUNED_DT = 0.033f;
+
+static float alphaForDt(float alpha, float dt) {
+    if (fabsf(dt - TUNED_DT) < 1e-4f) return alpha;
+    return 1.0f - powf(1.0f - alpha, dt / TUNED_DT);
+}
+
+// Gains set here hold until the next parameter change
 extern "C" void pidInit(int axis, float kp, float ki, float kd, 
                         float outputMin, float outputMax, float alpha) {
+    CORE_CHECK_OWNER();
     PIDController* pid = (axis == 0) ? &pidX : &pidY;
     
     pid->kp = kp;
@@ -61,6 +77,7 @@ extern "C" void pidInit(int axis, float kp, float ki, float kd,
 }
 
 extern "C" float pidUpdate(int axis, float error, float dt) {
+    CORE_CHECK_OWNER();
     PIDController* pid = (axis == 0) ? &pidX : &pidY;
     
     if (!pid->initialized) return 0;
@@ -84,7 +101,8 @@ extern "C" float pidUpdate(int axis, float error, float dt) {
     float output = pTerm + iTerm + dTerm;
     
     // Low-pass filter
-    output = pid->alpha * output + (1.0f - pid->alpha) * pid->prevOutput;
+    float a = alphaForDt(pid->alpha, dt);
+    output = a * output + (1.0f - a) * pid->prevOutput;
     pid->prevOutput = output;
     
     // Clamp
@@ -95,6 +113,7 @@ extern "C" float pidUpdate(int axis, float error, float dt) {
 }
 
 extern "C" void pidReset(int axis) {
+    CORE_CHECK_OWNER();
     PIDController* pid = (axis == 0) ? &pidX : &pidY;
     pid->integral = 0;
     pid->prevError = 0;
@@ -134,19 +153,68 @@ static GuidanceState guidance = {
     .tracking = false
 };
 
-extern "C" void guidanceInit(float alpha, float cmdMax) {
-    guidance.alpha = alpha;
-    guidance.cmdMax = cmdMax;
-    guidance.cmdMin = -cmdMax;
+// Parameter generation the guidance / PID values were taken from
+static uint32_t appliedGeneration = 0;
+
+static void takeParams(const ParamPin& p, PIDController* pid) {
+    float cmdMax = p.f(PARAM_GUIDANCE_CMD_MAX);
+    pid->kp = p.f(PARAM_PID_KP);
+    pid->ki = p.f(PARAM_PID_KI);
+    pid->kd = p.f(PARAM_PID_KD);
+    pid->alpha = p.f(PARAM_PID_ALPHA);
+    pid->outputMin = -cmdMax;
+    pid->outputMax = cmdMax;
+    pid->integralMax = cmdMax * 0.5f;
+    if (pid->integral > pid->integralMax) pid->integral = pid->integralMax;
+    if (pid->integral < -pid->integralMax) pid->integral = -pid->integralMax;
+}
+
+// Tuning changed: new gains / limits in place, integrators and filters
+// keep their state (one relaxed load per update otherwise)
+static void applyParams() {
+    if (paramGeneration() == appliedGeneration) return;
+    ParamPin p;
+    guidance.alpha = p.f(PARAM_GUIDANCE_ALPHA);
+    guidance.cmdMax = p.f(PARAM_GUIDANCE_CMD_MAX);
+    guidance.cmdMin = -guidance.cmdMax;
+    takeParams(p, &pidX);
+    takeParams(p, &pidY);
+    appliedGeneration = p.snapshot->generation;
+    LOGI("Guidance parameters (generation %u): Kp=%.2f, Ki=%.2f, Kd=%.2f, α=%.2f, cmdMax=%.1f°",
+         appliedGeneration, pidX.kp, pidX.ki, pidX.kd, guidance.alpha, guidance.cmdMax);
+}
+
+// Stores alpha / cmdMax as parameters. Any thread (the store orders its
+// writers), so the caller's own later changes (saved tuning) win
+extern "C" void guidanceSetParams(float alpha, float cmdMax) {
+    const int ids[3] = {PARAM_GUIDANCE_ALPHA, PARAM_PID_ALPHA, PARAM_GUIDANCE_CMD_MAX};
+    const float values[3] = {alpha, alpha, cmdMax};
+    if (paramSetMany(ids, values, 3) < 0) {
+        LOGW("Guidance α=%.2f, cmdMax=%.1f° rejected, keeping the current parameters", alpha, cmdMax);
+    }
+}
+
+// Resets the controller state with the store's current values (never
+// writes the store: a queued init must not undo tuning loaded meanwhile)
+extern "C" void guidanceInit() {
+    CORE_CHECK_OWNER();
+    ParamPin p;
+    guidance.alpha = p.f(PARAM_GUIDANCE_ALPHA);
+    guidance.cmdMax = p.f(PARAM_GUIDANCE_CMD_MAX);
+    guidance.cmdMin = -guidance.cmdMax;
     
     // Initialize PIDs
-    pidInit(0, 0.5f, 0.0f, 0.1f, -cmdMax, cmdMax, alpha);  // Yaw (X axis)
-    pidInit(1, 0.5f, 0.0f, 0.1f, -cmdMax, cmdMax, alpha);  // Pitch (Y axis)
+    for (int axis = 0; axis < 2; axis++) {  // Yaw (X axis), Pitch (Y axis)
+        pidInit(axis, p.f(PARAM_PID_KP), p.f(PARAM_PID_KI), p.f(PARAM_PID_KD),
+                -guidance.cmdMax, guidance.cmdMax, p.f(PARAM_PID_ALPHA));
+    }
+    appliedGeneration = p.snapshot->generation;
     
-    LOGI("Guidance initialized: α=%.2f, cmdMax=%.1f°", alpha, cmdMax);
+    LOGI("Guidance initialized: α=%.2f, cmdMax=%.1f°", guidance.alpha, guidance.cmdMax);
 }
 
 extern "C" void guidanceStart() {
+    CORE_CHECK_OWNER();
     guidance.tracking = true;
     guidance.filteredErrorX = 0;
     guidance.filteredErrorY = 0;
@@ -156,6 +224,7 @@ extern "C" void guidanceStart() {
 }
 
 extern "C" void guidanceStop() {
+    CORE_CHECK_OWNER();
     guidance.tracking = false;
     guidance.pitchCmd = 0;
     guidance.yawCmd = 0;
@@ -166,13 +235,16 @@ extern "C" void guidanceStop() {
 }
 
 extern "C" void guidanceUpdate(float errorX, float errorY, float dt) {
+    CORE_CHECK_OWNER();
     if (!guidance.tracking) return;
+    applyParams();
+    if (dt <= 0) dt = TUNED_DT;
     
     guidance.rawErrorX = errorX;
     guidance.rawErrorY = errorY;
     
     // Low-pass filter
-    float a = guidance.alpha;
+    float a = alphaForDt(guidance.alpha, dt);
     guidance.filteredErrorX = a * errorX + (1-a) * guidance.filteredErrorX;
     guidance.filteredErrorY = a * errorY + (1-a) * guidance.filteredErrorY;
     
@@ -200,6 +272,10 @@ extern "C" void guidanceUpdate(float errorX, float errorY, float dt) {
     guidance.servoAngles[3] = (s3 < min) ? min : (s3 > max) ? max : s3;
 }
 
+extern "C" bool guidanceIsTracking() {
+    return guidance.tracking;
+}
+
 extern "C" void guidanceGetCommands(float* pitch, float* yaw) {
     *pitch = guidance.pitchCmd;
     *yaw = guidance.yawCmd;
@@ -229,19 +305,20 @@ struct SensorFusionState {
     // Fused position
     double fusedLat, fusedLon, fusedAlt;
     
-    // Complementary filter alpha
-    float alpha;
+    // Complementary filter alpha: PARAM_FUSION_ALPHA
     
     bool hasGpsFix;
 };
 
 static SensorFusionState fusion = {
-    .alpha = 0.98f,  // 98% IMU, 2% GPS correction
     .hasGpsFix = false
 };
 
 extern "C" void fusionInit(float alpha) {
-    fusion.alpha = alpha;
+    CORE_CHECK_OWNER();
+    if (paramSet(PARAM_FUSION_ALPHA, alpha) < 0) {
+        LOGW("Fusion α=%.2f rejected, keeping %.2f", alpha, paramGetFloat(PARAM_FUSION_ALPHA));
+    }
     fusion.hasGpsFix = false;
     fusion.offsetN = 0;
     fusion.offsetE = 0;
@@ -249,24 +326,27 @@ extern "C" void fusionInit(float alpha) {
     fusion.velN = 0;
     fusion.velE = 0;
     fusion.velD = 0;
-    LOGI("Sensor Fusion initialized: α=%.2f", alpha);
+    LOGI("Sensor Fusion initialized: α=%.2f", paramGetFloat(PARAM_FUSION_ALPHA));
 }
 
 extern "C" void fusionUpdateGps(double lat, double lon, double alt, int64_t timestamp) {
+    CORE_CHECK_OWNER();
     fusion.gpsLat = lat;
     fusion.gpsLon = lon;
     fusion.gpsAlt = alt;
     fusion.gpsTimestamp = timestamp;
     
-    // Reset offsets on GPS update (correction)
-    fusion.offsetN *= (1.0 - (1.0 - fusion.alpha));
-    fusion.offsetE *= (1.0 - (1.0 - fusion.alpha));
-    fusion.offsetD *= (1.0 - (1.0 - fusion.alpha));
+    // Reset offsets on GPS update (correction, 98% IMU / 2% GPS by default)
+    double alpha = paramGetFloat(PARAM_FUSION_ALPHA);
+    fusion.offsetN *= (1.0 - (1.0 - alpha));
+    fusion.offsetE *= (1.0 - (1.0 - alpha));
+    fusion.offsetD *= (1.0 - (1.0 - alpha));
     
     fusion.hasGpsFix = true;
 }
 
 extern "C" void fusionIntegrateImu(float accelN, float accelE, float accelD, float dt) {
+    CORE_CHECK_OWNER();
     if (!fusion.hasGpsFix) return;
     
     // Integrate acceleration to velocity
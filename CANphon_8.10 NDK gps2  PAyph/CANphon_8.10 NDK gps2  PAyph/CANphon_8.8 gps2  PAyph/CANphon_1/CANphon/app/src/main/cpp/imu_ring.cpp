@@ -0,0 +1,145 @@
+/**
+ * imu_ring.cpp
+ * IMU Sample Ring (C++)
+ *
+ * head is written by the producer only, tail by the consumer only; each
+ * publishes its index with release after touching the slots.
+ */
+
+#include "imu_ring.h"
+#include <atomic>
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Ring State
+// ═══════════════════════════════════════════════════════════════════════════
+
+static ImuSample slots[IMU_RING_CAPACITY];
+static std::atomic<uint64_t> head(0);       // Next slot to write
+static std::atomic<uint64_t> tail(0);       // Next slot to read
+
+// Written by the producer only
+static std::atomic<uint64_t> pushed(0);
+static std::atomic<uint64_t> dropped(0);
+static std::atomic<uint64_t> drains(0);
+static std::atomic<uint64_t> emptyWakeups(0);
+static std::atomic<uint32_t> maxBurst(0);
+static std::atomic<uint32_t> highWater(0);
+static std::atomic<int64_t> cpuNs(0);
+static std::atomic<int64_t> firstTimestampNs(0);
+static std::atomic<int64_t> lastTimestampNs(0);
+
+// Written by the consumer only
+static std::atomic<uint64_t> readCount(0);
+
+extern "C" void imuRingReset() {
+    head = 0;
+    tail = 0;
+    pushed = 0;
+    dropped = 0;
+    drains = 0;
+    emptyWakeups = 0;
+    maxBurst = 0;
+    highWater = 0;
+    cpuNs = 0;
+    firstTimestampNs = 0;
+    lastTimestampNs = 0;
+    readCount = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Producer
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int imuRingPush(const ImuSample* samples, int count) {
+    if (samples == nullptr || count <= 0) return 0;
+
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    uint64_t room = IMU_RING_CAPACITY - (h - t);
+    int n = (uint64_t)count < room ? count : (int)room;
+
+    for (int i = 0; i < n; i++) {
+        slots[(h + i) & (IMU_RING_CAPACITY - 1)] = samples[i];
+    }
+    head.store(h + n, std::memory_order_release);
+
+    if (n > 0) {
+        if (firstTimestampNs.load(std::memory_order_relaxed) == 0) {
+            firstTimestampNs.store(samples[0].timestampNs, std::memory_order_relaxed);
+        }
+        lastTimestampNs.store(samples[n - 1].timestampNs, std::memory_order_relaxed);
+        pushed.fetch_add((uint64_t)n, std::memory_order_relaxed);
+        uint32_t depth = (uint32_t)(h + n - t);
+        if (depth > highWater.load(std::memory_order_relaxed)) {
+            highWater.store(depth, std::memory_order_relaxed);
+        }
+    }
+    if (n < count) dropped.fetch_add((uint64_t)(count - n), std::memory_order_relaxed);
+    return n;
+}
+
+extern "C" void imuRingNoteDrain(int samples, int64_t threadCpuNs) {
+    if (samples > 0) {
+        drains.fetch_add(1, std::memory_order_relaxed);
+        if ((uint32_t)samples > maxBurst.load(std::memory_order_relaxed)) {
+            maxBurst.store((uint32_t)samples, std::memory_order_relaxed);
+        }
+    } else {
+        emptyWakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+    cpuNs.store(threadCpuNs, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Consumer
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int imuRingRead(ImuSample* out, int max) {
+    if (out == nullptr || max <= 0) return 0;
+
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    uint64_t h = head.load(std::memory_order_acquire);
+    uint64_t pending = h - t;
+    int n = (uint64_t)max < pending ? max : (int)pending;
+
+    for (int i = 0; i < n; i++) {
+        out[i] = slots[(t + i) & (IMU_RING_CAPACITY - 1)];
+    }
+    tail.store(t + n, std::memory_order_release);
+    readCount.fetch_add((uint64_t)n, std::memory_order_relaxed);
+    return n;
+}
+
+extern "C" int imuRingPending() {
+    uint64_t t = tail.load(std::memory_order_acquire);
+    uint64_t h = head.load(std::memory_order_acquire);
+    return (int)(h - t);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void imuRingGetStats(ImuRingStats* out) {
+    if (out == nullptr) return;
+    memset(out, 0, sizeof(*out));
+    out->pushed = pushed.load(std::memory_order_relaxed);
+    out->read = readCount.load(std::memory_order_relaxed);
+    out->dropped = dropped.load(std::memory_order_relaxed);
+    out->drains = drains.load(std::memory_order_relaxed);
+    out->emptyWakeups = emptyWakeups.load(std::memory_order_relaxed);
+    out->maxBurst = maxBurst.load(std::memory_order_relaxed);
+    out->highWater = highWater.load(std::memory_order_relaxed);
+    out->cpuNs = cpuNs.load(std::memory_order_relaxed);
+    int64_t first = firstTimestampNs.load(std::memory_order_relaxed);
+    int64_t last = lastTimestampNs.load(std::memory_order_relaxed);
+    out->spanNs = first != 0 && last > first ? last - first : 0;
+}
+
+extern "C" double imuRingCpuUsPer1000(const ImuRingStats* stats) {
+    if (stats == nullptr) return 0.0;
+    uint64_t drained = stats->pushed + stats->dropped;
+    if (drained == 0) return 0.0;
+    return (double)stats->cpuNs / (double)drained;   // ns per sample = µs per 1000
+}
@@ -0,0 +1,82 @@
+/**
+ * imu_ring.h
+ * IMU Sample Ring (C++)
+ *
+ * Hardware-timestamped accelerometer / gyroscope / magnetometer samples
+ * between the sensor drain thread (producer) and pollSensors (consumer).
+ * The drain thread pushes each burst it gets from the sensor hub FIFO in
+ * one call; the consumer takes everything pending in one call. Single
+ * producer, single consumer, no locks.
+ *
+ * The producer also accounts its own CPU time per drain, so each sensor
+ * profile (one wakeup per sample vs FIFO batches) reports the CPU it costs
+ * per 1000 samples.
+ */
+
+#ifndef IMU_RING_H
+#define IMU_RING_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMU_RING_CAPACITY 4096              // Samples (power of two), ~1 s of accel + gyro at 2 kHz
+#define IMU_RING_MAX_BURST 256              // Samples pushed / read per call at most
+
+typedef struct {
+    int64_t timestampNs;    // Sensor hub timestamp (ASensorEvent.timestamp, CLOCK_BOOTTIME)
+    int32_t type;           // ASENSOR_TYPE_*
+    float v[3];
+} ImuSample;
+
+typedef struct {
+    uint64_t pushed;
+    uint64_t read;
+    uint64_t dropped;           // Ring full (consumer behind), newest samples lost
+    uint64_t drains;            // Producer wakeups that delivered samples
+    uint64_t emptyWakeups;      // Wakeups with nothing to drain
+    uint32_t maxBurst;          // Largest burst in one drain
+    uint32_t highWater;         // Deepest the ring got
+    int64_t cpuNs;              // Producer thread CPU time since reset
+    int64_t spanNs;             // Newest - oldest sample timestamp pushed
+} ImuRingStats;
+
+// Empty the ring and clear the stats (no producer / consumer running)
+void imuRingReset();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Producer (sensor drain thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Append a burst. Returns samples stored (fewer if the ring is full)
+int imuRingPush(const ImuSample* samples, int count);
+
+// One wakeup done: `samples` drained (0 = empty wakeup), producer thread
+// CPU time so far since its start
+void imuRingNoteDrain(int samples, int64_t threadCpuNs);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Consumer
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Oldest pending samples, up to max. Returns the count
+int imuRingRead(ImuSample* out, int max);
+
+int imuRingPending();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stats (any thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void imuRingGetStats(ImuRingStats* outStats);
+
+// Producer CPU per 1000 samples drained (µs), 0 before the first sample
+double imuRingCpuUsPer1000(const ImuRingStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMU_RING_H
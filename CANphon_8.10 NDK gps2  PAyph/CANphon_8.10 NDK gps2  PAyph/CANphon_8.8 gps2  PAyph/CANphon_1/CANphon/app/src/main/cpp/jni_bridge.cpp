@@ -8,6 +8,24 @@
 #include <jni.h>
 #include <android/log.h>
 #include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include "waveshare_codec.h"
+#include "can_dispatch.h"
+#include "can_recorder.h"
+#include "can_rx_thread.h"
+#include "control_thread.h"
+#include "core_owner.h"
+#include "deadline_monitor.h"
+#include "frame_arena.h"
+#include "l431_link.h"
+#include "native_trace.h"
+#include "param_store.h"
+#include "series_store.h"
+#include "servo_estimator.h"
+#include "telemetry_bus.h"
+#include "telemetry_publisher.h"
+#include "usb_tx_coalescer.h"
 
 #define LOG_TAG "JNI_Bridge"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -20,6 +38,8 @@
 extern "C" {
     int initNativeSensors();
     int startSensors(int usDelay);
+    int startSensorsBatched(int usDelay, int profile, int64_t maxBatchLatencyUs);
+    void getSensorBatchStats(int64_t* out);
     int pollSensors(float* accel, float* gyro, float* mag, float* rate);
     void stopSensors();
     void cleanupNativeSensors();
@@ -52,23 +72,25 @@ extern "C" {
     float clampf(float value, float min, float max);
 }
 
-// guidance_controller.cpp
+// guidance_controller.cpp / telemetry.cpp: owned state, reached through
+// coreSubmit (commands) and coreSnapshot (outputs), see core_owner.h
+
+// guidance_controller.cpp: parameter store writes (any thread)
 extern "C" {
-    void guidanceInit(float alpha, float cmdMax);
-    void guidanceStart();
-    void guidanceStop();
-    void guidanceUpdate(float errorX, float errorY, float dt);
-    void guidanceGetCommands(float* pitch, float* yaw);
-    void guidanceGetServoAngles(float* angles);
-    void pidInit(int axis, float kp, float ki, float kd, float outputMin, float outputMax, float alpha);
-    float pidUpdate(int axis, float error, float dt);
-    void pidReset(int axis);
-    void fusionInit(float alpha);
-    void fusionUpdateGps(double lat, double lon, double alt, int64_t timestamp);
-    void fusionIntegrateImu(float accelN, float accelE, float accelD, float dt);
-    void fusionGetPosition(double* lat, double* lon, double* alt);
-    void fusionGetVelocity(double* velN, double* velE, double* velD);
-    bool fusionHasFix();
+    void guidanceSetParams(float alpha, float cmdMax);
+}
+
+// Queue a command for the core owner
+static void submit(uint32_t type, int32_t arg = 0, std::initializer_list<double> values = {}) {
+    CoreCommand c;
+    memset(&c, 0, sizeof(c));
+    c.type = type;
+    c.arg = arg;
+    int i = 0;
+    for (double v : values) {
+        if (i < CORE_COMMAND_VALUES) c.v[i++] = v;
+    }
+    coreSubmit(&c);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -85,6 +107,25 @@ Java_com_example_canphon_native_1sensors_NativeSensorManager_startNative(JNIEnv*
     return startSensors(usDelay);
 }
 
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeSensorManager_startBatchedNative(JNIEnv* env, jobject, jint usDelay,
+                                                                               jint profile, jlong maxBatchLatencyUs) {
+    return startSensorsBatched(usDelay, profile, maxBatchLatencyUs);
+}
+
+// profile, latencyUs, accel / gyro periodUs, accel / gyro FIFO, samples,
+// dropped, drains, empty wakeups, max burst, high-water, cpu ns, span ns
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeSensorManager_getBatchStatsNative(JNIEnv* env, jobject) {
+    int64_t v[14];
+    getSensorBatchStats(v);
+    jlong values[14];
+    for (int i = 0; i < 14; i++) values[i] = (jlong)v[i];
+    jlongArray result = env->NewLongArray(14);
+    env->SetLongArrayRegion(result, 0, 14, values);
+    return result;
+}
+
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeSensorManager_pollNative(JNIEnv* env, jobject) {
     float accel[3], gyro[3], mag[3], rate;
@@ -234,56 +275,64 @@ Java_com_example_canphon_native_1sensors_NativeCore_clampf(JNIEnv* env, jobject,
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceInit(JNIEnv* env, jobject, jfloat alpha, jfloat cmdMax) {
-    guidanceInit(alpha, cmdMax);
+    // Store written here, in the caller's order; the owner only resets
+    guidanceSetParams(alpha, cmdMax);
+    submit(CORE_CMD_GUIDANCE_INIT);
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceStart(JNIEnv* env, jobject) {
-    guidanceStart();
+    submit(CORE_CMD_GUIDANCE_START);
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceStop(JNIEnv* env, jobject) {
-    guidanceStop();
+    submit(CORE_CMD_GUIDANCE_STOP);
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceUpdate(JNIEnv* env, jobject, jfloat ex, jfloat ey, jfloat dt) {
-    guidanceUpdate(ex, ey, dt);
+    submit(CORE_CMD_GUIDANCE_UPDATE, 0, {ex, ey, dt});
 }
 
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceGetCommands(JNIEnv* env, jobject) {
-    float pitch, yaw;
-    guidanceGetCommands(&pitch, &yaw);
+    CoreSnapshot s;
+    coreSnapshot(&s);
     jfloatArray result = env->NewFloatArray(2);
-    float out[2] = {pitch, yaw};
+    float out[2] = {s.pitchCmd, s.yawCmd};
     env->SetFloatArrayRegion(result, 0, 2, out);
     return result;
 }
 
 extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_guidanceGetServoAngles(JNIEnv* env, jobject) {
-    float angles[4];
-    guidanceGetServoAngles(angles);
+    CoreSnapshot s;
+    coreSnapshot(&s);
     jfloatArray result = env->NewFloatArray(4);
-    env->SetFloatArrayRegion(result, 0, 4, angles);
+    env->SetFloatArrayRegion(result, 0, 4, s.servoAngles);
     return result;
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_pidInit(JNIEnv* env, jobject, jint axis, jfloat kp, jfloat ki, jfloat kd, jfloat omin, jfloat omax, jfloat alpha) {
-    pidInit(axis, kp, ki, kd, omin, omax, alpha);
+    submit(CORE_CMD_PID_INIT, axis, {kp, ki, kd, omin, omax, alpha});
 }
 
+// Output as of the latest snapshot: this update's own result unless the
+// control thread holds the core (then the one of its next tick)
 extern "C" JNIEXPORT jfloat JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_pidUpdate(JNIEnv* env, jobject, jint axis, jfloat error, jfloat dt) {
-    return pidUpdate(axis, error, dt);
+    if (axis < 0 || axis > 1) return 0;
+    submit(CORE_CMD_PID_UPDATE, axis, {error, dt});
+    CoreSnapshot s;
+    coreSnapshot(&s);
+    return s.pidOutput[axis];
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_pidReset(JNIEnv* env, jobject, jint axis) {
-    pidReset(axis);
+    submit(CORE_CMD_PID_RESET, axis);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -292,42 +341,44 @@ Java_com_example_canphon_native_1sensors_NativeCore_pidReset(JNIEnv* env, jobjec
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionInit(JNIEnv* env, jobject, jfloat alpha) {
-    fusionInit(alpha);
+    submit(CORE_CMD_FUSION_INIT, 0, {alpha});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionUpdateGps(JNIEnv* env, jobject, jdouble lat, jdouble lon, jdouble alt, jlong ts) {
-    fusionUpdateGps(lat, lon, alt, ts);
+    submit(CORE_CMD_FUSION_GPS, 0, {lat, lon, alt, (double)ts});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionIntegrateImu(JNIEnv* env, jobject, jfloat an, jfloat ae, jfloat ad, jfloat dt) {
-    fusionIntegrateImu(an, ae, ad, dt);
+    submit(CORE_CMD_FUSION_IMU, 0, {an, ae, ad, dt});
 }
 
 extern "C" JNIEXPORT jdoubleArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionGetPosition(JNIEnv* env, jobject) {
-    double lat, lon, alt;
-    fusionGetPosition(&lat, &lon, &alt);
+    CoreSnapshot s;
+    coreSnapshot(&s);
     jdoubleArray result = env->NewDoubleArray(3);
-    double out[3] = {lat, lon, alt};
+    double out[3] = {s.lat, s.lon, s.alt};
     env->SetDoubleArrayRegion(result, 0, 3, out);
     return result;
 }
 
 extern "C" JNIEXPORT jdoubleArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionGetVelocity(JNIEnv* env, jobject) {
-    double vn, ve, vd;
-    fusionGetVelocity(&vn, &ve, &vd);
+    CoreSnapshot s;
+    coreSnapshot(&s);
     jdoubleArray result = env->NewDoubleArray(3);
-    double out[3] = {vn, ve, vd};
+    double out[3] = {s.velN, s.velE, s.velD};
     env->SetDoubleArrayRegion(result, 0, 3, out);
     return result;
 }
 
 extern "C" JNIEXPORT jboolean JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_fusionHasFix(JNIEnv* env, jobject) {
-    return fusionHasFix() ? JNI_TRUE : JNI_FALSE;
+    CoreSnapshot s;
+    coreSnapshot(&s);
+    return s.hasFix ? JNI_TRUE : JNI_FALSE;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -360,6 +411,15 @@ extern "C" {
     void discriminatorReset();
 }
 
+// Scratch of the per-frame tracker / discriminator calls (camera thread,
+// like the tracker state). Each call is one frame: reset on return
+static FrameArena* visionArena() {
+    static FrameArena arena;
+    static bool ready = frameArenaInit(&arena, "vision-jni", FRAME_ARENA_DEFAULT_BYTES) != 0;
+    (void)ready;
+    return &arena;
+}
+
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_trackerInit(JNIEnv* env, jobject) {
     trackerInit();
@@ -377,20 +437,23 @@ Java_com_example_canphon_native_1sensors_NativeCore_trackerSetImageSize(JNIEnv*
 
 extern "C" JNIEXPORT jintArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_trackerUpdate(JNIEnv* env, jobject, jintArray detections) {
+    TRACE_ZONE("jni.trackerUpdate");
+    FrameArenaFrame frame(visionArena());
+    
     // Get detection count
     jsize len = env->GetArrayLength(detections);
     int count = len / 4;
     
-    // Get detection data
-    jint* rects = env->GetIntArrayElements(detections, NULL);
+    // Get detection data (copied into the frame arena, no per-frame heap copy)
+    jint* rects = frameArenaArray<jint>(frame.arena, count * 4);
+    if (!rects) count = 0;
+    else env->GetIntArrayRegion(detections, 0, count * 4, rects);
     
     // Update tracker
-    int outX, outY, outW, outH;
-    float confidence;
+    int outX = 0, outY = 0, outW = 0, outH = 0;
+    float confidence = 0.0f;
     int found = trackerUpdate((int*)rects, count, &outX, &outY, &outW, &outH, &confidence);
     
-    env->ReleaseIntArrayElements(detections, rects, 0);
-    
     // Return [found, x, y, w, h, confidence*100]
     jintArray result = env->NewIntArray(6);
     jint out[6] = {found, outX, outY, outW, outH, (int)(confidence * 100)};
@@ -465,20 +528,19 @@ extern "C" JNIEXPORT jfloatArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_discriminatorEvaluateMultiple(JNIEnv* env, jobject,
     jintArray rects, jint lastX, jint lastY, jint lastW, jint lastH, jint imgW, jint imgH) {
     
+    FrameArenaFrame frame(visionArena());
     jsize len = env->GetArrayLength(rects);
     int count = len / 4;
     
-    jint* rectData = env->GetIntArrayElements(rects, NULL);
+    jint* rectData = frameArenaArray<jint>(frame.arena, count * 4);
+    float* scores = frameArenaArray<float>(frame.arena, count);
+    if (!rectData || !scores) count = 0;
+    else env->GetIntArrayRegion(rects, 0, count * 4, rectData);
     
-    float* scores = new float[count];
     discriminatorEvaluateMultiple((int*)rectData, count, lastX, lastY, lastW, lastH, imgW, imgH, scores);
     
-    env->ReleaseIntArrayElements(rects, rectData, 0);
-    
     jfloatArray result = env->NewFloatArray(count);
     env->SetFloatArrayRegion(result, 0, count, scores);
-    
-    delete[] scores;
     return result;
 }
 
@@ -486,13 +548,13 @@ extern "C" JNIEXPORT jint JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_discriminatorSelectBest(JNIEnv* env, jobject,
     jfloatArray scores, jfloat minScore) {
     
+    FrameArenaFrame frame(visionArena());
     jsize count = env->GetArrayLength(scores);
-    jfloat* scoreData = env->GetFloatArrayElements(scores, NULL);
-    
-    int best = discriminatorSelectBest(scoreData, count, minScore);
+    jfloat* scoreData = frameArenaArray<jfloat>(frame.arena, count);
+    if (!scoreData) return -1;
+    env->GetFloatArrayRegion(scores, 0, count, scoreData);
     
-    env->ReleaseFloatArrayElements(scores, scoreData, 0);
-    return best;
+    return discriminatorSelectBest(scoreData, count, minScore);
 }
 
 extern "C" JNIEXPORT void JNICALL
@@ -504,74 +566,59 @@ Java_com_example_canphon_native_1sensors_NativeCore_discriminatorReset(JNIEnv* e
 // NativeCore JNI - Telemetry (Phase 2)
 // ═══════════════════════════════════════════════════════════════════════════
 
-// telemetry.cpp
-extern "C" {
-    void telemetryInit();
-    void telemetrySetTimestamp(uint32_t ts);
-    void telemetrySetOrientation(float roll, float pitch, float yaw);
-    void telemetrySetAccelerometer(float x, float y, float z);
-    void telemetrySetPressure(float pressureHpa, float altitudeM);
-    void telemetrySetGPS(double lat, double lon, float alt, float speed, float heading,
-                         int satellites, int fix, float hdop);
-    void telemetrySetServoCmd(float s1, float s2, float s3, float s4);
-    void telemetrySetServoFb(float s1, float s2, float s3, float s4);
-    void telemetrySetServoStatus(int online);
-    void telemetrySetTracking(int x, int y, int w, int h);
-    void telemetrySetBattery(int percent, int charging, int voltageMv);
-    void telemetrySetTemperature(float tempC);
-    int telemetryBuildFrame(uint8_t* outBuffer, int maxLen);
-}
-
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetryInit(JNIEnv* env, jobject) {
-    telemetryInit();
+    submit(CORE_CMD_TELEM_INIT);
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetOrientation(JNIEnv* env, jobject, jfloat r, jfloat p, jfloat y) {
-    telemetrySetOrientation(r, p, y);
+    submit(CORE_CMD_TELEM_ORIENTATION, 0, {r, p, y});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetAccelerometer(JNIEnv* env, jobject, jfloat x, jfloat y, jfloat z) {
-    telemetrySetAccelerometer(x, y, z);
+    submit(CORE_CMD_TELEM_ACCEL, 0, {x, y, z});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetGPS(JNIEnv* env, jobject,
     jdouble lat, jdouble lon, jfloat alt, jfloat spd, jfloat hdg, jint sats, jint fix, jfloat hdop) {
-    telemetrySetGPS(lat, lon, alt, spd, hdg, sats, fix, hdop);
+    submit(CORE_CMD_TELEM_GPS, 0, {lat, lon, alt, spd, hdg, (double)sats, (double)fix, hdop});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetServoCmd(JNIEnv* env, jobject, jfloat s1, jfloat s2, jfloat s3, jfloat s4) {
-    telemetrySetServoCmd(s1, s2, s3, s4);
+    submit(CORE_CMD_TELEM_SERVO_CMD, 0, {s1, s2, s3, s4});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetServoFb(JNIEnv* env, jobject, jfloat s1, jfloat s2, jfloat s3, jfloat s4) {
-    telemetrySetServoFb(s1, s2, s3, s4);
+    submit(CORE_CMD_TELEM_SERVO_FB, 0, {s1, s2, s3, s4});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetServoStatus(JNIEnv* env, jobject, jint online) {
-    telemetrySetServoStatus(online);
+    submit(CORE_CMD_TELEM_SERVO_STATUS, 0, {(double)online});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetTracking(JNIEnv* env, jobject, jint x, jint y, jint w, jint h) {
-    telemetrySetTracking(x, y, w, h);
+    submit(CORE_CMD_TELEM_TRACKING, 0, {(double)x, (double)y, (double)w, (double)h});
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetrySetBattery(JNIEnv* env, jobject, jint pct, jint chg, jint mv) {
-    telemetrySetBattery(pct, chg, mv);
+    submit(CORE_CMD_TELEM_BATTERY, 0, {(double)pct, (double)chg, (double)mv});
 }
 
+// From the published record (the streamer never touches the owned one)
 extern "C" JNIEXPORT jbyteArray JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_telemetryBuildFrame(JNIEnv* env, jobject) {
+    CoreSnapshot s;
+    coreSnapshot(&s);
     uint8_t buffer[128];
-    int len = telemetryBuildFrame(buffer, 128);
+    int len = telemetryBuildFrameFrom(&s.telemetry, buffer, 128);
     
     if (len <= 0) {
         return env->NewByteArray(0);
@@ -582,6 +629,22 @@ Java_com_example_canphon_native_1sensors_NativeCore_telemetryBuildFrame(JNIEnv*
     return result;
 }
 
+// [submitted, applied, dropped, drains, ownerDrains, published, snapshotRetries,
+//  violations, queueHighWater, ownedByControl]
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_coreOwnerGetStats(JNIEnv* env, jobject) {
+    CoreOwnerStats s;
+    coreOwnerGetStats(&s);
+    jlong values[10] = {
+        (jlong)s.submitted, (jlong)s.applied, (jlong)s.dropped, (jlong)s.drains, (jlong)s.ownerDrains,
+        (jlong)s.published, (jlong)s.snapshotRetries, (jlong)s.violations, (jlong)s.queueHighWater,
+        (jlong)s.ownedByControl
+    };
+    jlongArray result = env->NewLongArray(10);
+    env->SetLongArrayRegion(result, 0, 10, values);
+    return result;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // NativeCore JNI - Servo Protocol (Phase 3)
 // ═══════════════════════════════════════════════════════════════════════════
@@ -624,3 +687,881 @@ extern "C" JNIEXPORT jfloat JNICALL
 Java_com_example_canphon_native_1sensors_NativeCore_servoPositionToAngle(JNIEnv* env, jobject, jint position) {
     return servoPositionToAngle(position);
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NativeCore JNI - Waveshare USB-CAN Codec
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define WS_JNI_MAX_FRAMES 256
+
+static uint8_t wsJniInput[WS_RX_BUFFER_SIZE];
+static WsCanFrame wsJniFrames[WS_JNI_MAX_FRAMES];
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_wsEncode(JNIEnv* env, jobject, jintArray ids, jbyteArray dlcs, jbyteArray data, jint count, jbyteArray out) {
+    jsize outLen = env->GetArrayLength(out);
+    if (count <= 0 || env->GetArrayLength(ids) < count || env->GetArrayLength(dlcs) < count ||
+        env->GetArrayLength(data) < count * WS_MAX_DLC) {
+        return 0;
+    }
+
+    jint* idPtr = env->GetIntArrayElements(ids, NULL);
+    jbyte* dlcPtr = env->GetByteArrayElements(dlcs, NULL);
+    jbyte* dataPtr = env->GetByteArrayElements(data, NULL);
+    jbyte* outPtr = env->GetByteArrayElements(out, NULL);
+
+    int len = wsEncodePacked(idPtr, dlcPtr, dataPtr, count, (uint8_t*)outPtr, outLen);
+    if (len > 0) {
+        canRecorderLogPacked(idPtr, dlcPtr, dataPtr, count, 1);
+        servoEstimatorCommandPacked(idPtr, dlcPtr, dataPtr, count, canRecorderNowUs());
+    }
+
+    env->ReleaseByteArrayElements(out, outPtr, 0);
+    env->ReleaseByteArrayElements(data, dataPtr, JNI_ABORT);
+    env->ReleaseByteArrayElements(dlcs, dlcPtr, JNI_ABORT);
+    env->ReleaseIntArrayElements(ids, idPtr, JNI_ABORT);
+    return len;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_wsDecode(JNIEnv* env, jobject, jbyteArray input, jint length, jintArray outIds, jbyteArray outDlcs, jbyteArray outData) {
+    int len = length;
+    if (len > WS_RX_BUFFER_SIZE) len = WS_RX_BUFFER_SIZE;
+    if (len > env->GetArrayLength(input)) len = env->GetArrayLength(input);
+    if (len > 0) {
+        env->GetByteArrayRegion(input, 0, len, (jbyte*)wsJniInput);
+    }
+
+    int maxFrames = env->GetArrayLength(outIds);
+    if (maxFrames > env->GetArrayLength(outDlcs)) maxFrames = env->GetArrayLength(outDlcs);
+    if (maxFrames > env->GetArrayLength(outData) / WS_MAX_DLC) maxFrames = env->GetArrayLength(outData) / WS_MAX_DLC;
+    if (maxFrames > WS_JNI_MAX_FRAMES) maxFrames = WS_JNI_MAX_FRAMES;
+
+    int count = wsDecode(wsJniInput, len, wsJniFrames, maxFrames);
+    if (count <= 0) return 0;
+    canRecorderLog(wsJniFrames, count, 0);
+
+    jint* idPtr = env->GetIntArrayElements(outIds, NULL);
+    jbyte* dlcPtr = env->GetByteArrayElements(outDlcs, NULL);
+    jbyte* dataPtr = env->GetByteArrayElements(outData, NULL);
+    for (int i = 0; i < count; i++) {
+        idPtr[i] = (jint)wsJniFrames[i].id;
+        dlcPtr[i] = (jbyte)wsJniFrames[i].dlc;
+        memcpy(dataPtr + i * WS_MAX_DLC, wsJniFrames[i].data, WS_MAX_DLC);
+    }
+    env->ReleaseByteArrayElements(outData, dataPtr, 0);
+    env->ReleaseByteArrayElements(outDlcs, dlcPtr, 0);
+    env->ReleaseIntArrayElements(outIds, idPtr, 0);
+    return count;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_wsDecoderReset(JNIEnv* env, jobject) {
+    wsDecoderReset();
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_wsGetStats(JNIEnv* env, jobject) {
+    WsCodecStats s;
+    wsGetStats(&s);
+    jlong values[7] = {
+        (jlong)s.framesEncoded, (jlong)s.framesDecoded, (jlong)s.bytesIn,
+        (jlong)s.bytesDropped, (jlong)s.garbageBytes, (jlong)s.badFrames,
+        (jlong)s.encodeOverflows
+    };
+    jlongArray result = env->NewLongArray(7);
+    env->SetLongArrayRegion(result, 0, 7, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NativeCore JNI - CAN Receive Dispatcher
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jobject JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canDispatchInit(JNIEnv* env, jobject) {
+    canDispatchReset();
+    return env->NewDirectByteBuffer(canDispatchShared(), sizeof(CanDispatchShared));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canDispatchClear(JNIEnv* env, jobject) {
+    canDispatchClearHandlers();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canDispatchSetServo(JNIEnv* env, jobject, jint canId, jint channel) {
+    return canDispatchSetServoFeedback((uint32_t)canId, channel) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_wsDecodeDispatch(JNIEnv* env, jobject, jbyteArray input, jint length, jlong nowMs) {
+    int len = length;
+    if (len > WS_RX_BUFFER_SIZE) len = WS_RX_BUFFER_SIZE;
+    if (len > env->GetArrayLength(input)) len = env->GetArrayLength(input);
+    if (len > 0) {
+        env->GetByteArrayRegion(input, 0, len, (jbyte*)wsJniInput);
+    }
+
+    // Frames never leave native code: decode and dispatch until drained
+    int total = 0;
+    int count = wsDecode(wsJniInput, len, wsJniFrames, WS_JNI_MAX_FRAMES);
+    while (count > 0) {
+        canRecorderLog(wsJniFrames, count, 0);
+        canDispatchFrames(wsJniFrames, count, nowMs);
+        total += count;
+        if (count < WS_JNI_MAX_FRAMES) break;
+        count = wsDecode(NULL, 0, wsJniFrames, WS_JNI_MAX_FRAMES);
+    }
+    return total;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canDispatchOnlineMask(JNIEnv* env, jobject, jint channelCount, jlong nowMs, jlong timeoutMs) {
+    return canDispatchOnlineMask(channelCount, nowMs, timeoutMs);
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canDispatchLastFrame(JNIEnv* env, jobject) {
+    char text[64];
+    canDispatchFormatLastFrame(text, sizeof(text));
+    return env->NewStringUTF(text);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// NativeCore JNI - CAN Bus Recorder
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderStart(JNIEnv* env, jobject, jint capacity) {
+    return canRecorderStart(capacity) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderStop(JNIEnv* env, jobject) {
+    canRecorderStop();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderSave(JNIEnv* env, jobject, jstring path) {
+    const char* p = env->GetStringUTFChars(path, NULL);
+    int result = canRecorderSave(p);
+    env->ReleaseStringUTFChars(path, p);
+    return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderFlush(JNIEnv* env, jobject, jstring path) {
+    const char* p = env->GetStringUTFChars(path, NULL);
+    int result = canRecorderFlush(p);
+    env->ReleaseStringUTFChars(path, p);
+    return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderExportCandump(JNIEnv* env, jobject, jstring path, jstring iface) {
+    const char* p = env->GetStringUTFChars(path, NULL);
+    const char* i = env->GetStringUTFChars(iface, NULL);
+    int result = canRecorderExportCandump(p, i);
+    env->ReleaseStringUTFChars(iface, i);
+    env->ReleaseStringUTFChars(path, p);
+    return result;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRecorderGetStats(JNIEnv* env, jobject) {
+    CanRecorderStats s;
+    canRecorderGetStats(&s);
+    jlong values[6] = {
+        (jlong)s.framesRecorded, (jlong)s.framesTx, (jlong)s.framesRx,
+        (jlong)s.overwritten, (jlong)s.flushLost, (jlong)s.capacity
+    };
+    jlongArray result = env->NewLongArray(6);
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CAN Receive Thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRxThreadStartUsb(
+        JNIEnv*, jobject, jint fd, jint epIn, jint epOut, jint niceValue, jint rtPriority, jint cpuMask) {
+    CanTransport* t = canTransportOpenUsb(fd, epIn, epOut);
+    if (t == nullptr) return JNI_FALSE;
+
+    CanRxThreadConfig config;
+    canRxThreadDefaultConfig(&config);
+    config.niceValue = niceValue;
+    config.rtPriority = rtPriority;
+    config.cpuMask = (uint32_t)cpuMask;
+    if (!canRxThreadStart(t, &config)) {
+        canTransportClose(t);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRxThreadStop(JNIEnv*, jobject) {
+    canRxThreadStop();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRxThreadRunning(JNIEnv*, jobject) {
+    return canRxThreadRunning() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_canRxThreadGetStats(JNIEnv* env, jobject) {
+    CanRxThreadStats s;
+    canRxThreadGetStats(&s);
+    jlong values[9] = {
+        (jlong)s.wakeups, (jlong)s.timeouts, (jlong)s.frames, (jlong)s.errors,
+        (jlong)s.cpuTimeUs, (jlong)s.runTimeUs, (jlong)s.tid, (jlong)s.realtime, (jlong)s.running
+    };
+    jlongArray result = env->NewLongArray(9);
+    env->SetLongArrayRegion(result, 0, 9, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Native Control Thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlThreadStart(
+        JNIEnv*, jobject, jint periodUs, jint niceValue, jint rtPriority, jint cpuMask, jfloat sendThresholdDeg) {
+    ControlThreadConfig config;
+    controlThreadDefaultConfig(&config);
+    config.periodUs = periodUs;
+    config.niceValue = niceValue;
+    config.rtPriority = rtPriority;
+    config.cpuMask = (uint32_t)cpuMask;
+    config.sendThresholdDeg = sendThresholdDeg;
+
+    // Commands go out on the receive thread's transport
+    if (!canRxThreadRunning()) return JNI_FALSE;
+    return controlThreadStart(&config, canRxThreadSend) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlThreadStop(JNIEnv*, jobject) {
+    controlThreadStop();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlThreadRunning(JNIEnv*, jobject) {
+    return controlThreadRunning() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlSetLayout(
+        JNIEnv* env, jobject, jintArray nodeIds, jfloatArray rollGains, jfloatArray pitchGains) {
+    int count = env->GetArrayLength(nodeIds);
+    if (count > CONTROL_MAX_CHANNELS || env->GetArrayLength(rollGains) != count ||
+        env->GetArrayLength(pitchGains) != count) {
+        return JNI_FALSE;
+    }
+    jint nodes[CONTROL_MAX_CHANNELS];
+    float roll[CONTROL_MAX_CHANNELS];
+    float pitch[CONTROL_MAX_CHANNELS];
+    env->GetIntArrayRegion(nodeIds, 0, count, nodes);
+    env->GetFloatArrayRegion(rollGains, 0, count, roll);
+    env->GetFloatArrayRegion(pitchGains, 0, count, pitch);
+    return controlSetLayout((const int*)nodes, roll, pitch, count) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlSetMode(JNIEnv*, jobject, jint mode) {
+    controlSetMode(mode);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlSetAttitude(
+        JNIEnv*, jobject, jfloat roll, jfloat pitch, jfloat yaw) {
+    controlSetAttitude(roll, pitch, yaw);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlSetTrackingError(
+        JNIEnv*, jobject, jfloat errorX, jfloat errorY) {
+    controlSetTrackingError(errorX, errorY, 0);
+}
+
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlGetCommands(JNIEnv* env, jobject, jint channels) {
+    float values[CONTROL_MAX_CHANNELS];
+    int n = controlGetCommands(values, channels);
+    jfloatArray result = env->NewFloatArray(n);
+    env->SetFloatArrayRegion(result, 0, n, values);
+    return result;
+}
+
+extern "C" JNIEXPORT jfloat JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlGetCommand(JNIEnv*, jobject, jint channel) {
+    return controlGetCommand(channel);
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_controlThreadGetStats(JNIEnv* env, jobject) {
+    ControlThreadStats s;
+    controlThreadGetStats(&s);
+    jlong values[17] = {
+        (jlong)s.ticks, (jlong)s.overruns, (jlong)s.sends, (jlong)s.framesSent, (jlong)s.sendErrors,
+        (jlong)s.staleTicks, s.jitterLastUs, s.jitterMeanUs, s.jitterP99Us, s.jitterMaxUs,
+        s.workMeanUs, s.workMaxUs, s.cpuTimeUs, s.runTimeUs, (jlong)s.tid, (jlong)s.realtime, (jlong)s.running
+    };
+    jlongArray result = env->NewLongArray(17);
+    env->SetLongArrayRegion(result, 0, 17, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// L431 Power Unit Link
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_l431Init(JNIEnv*, jobject, jint timeoutMs) {
+    l431LinkReset(timeoutMs);
+    return l431LinkInstall() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_l431Install(JNIEnv*, jobject) {
+    return l431LinkInstall() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_l431Submit(JNIEnv* env, jobject, jbyteArray commands) {
+    int count = env->GetArrayLength(commands);
+    if (count < 1 || count > L431_MAX_COMMANDS) return -1;
+
+    uint8_t buffer[L431_MAX_COMMANDS];
+    env->GetByteArrayRegion(commands, 0, count, (jbyte*)buffer);
+    return l431LinkSubmit(buffer, count);
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_l431GetStats(JNIEnv* env, jobject) {
+    L431LinkStats s;
+    l431LinkGetStats(&s);
+    jlong values[16] = {
+        (jlong)s.requests, (jlong)s.replies, (jlong)s.timeouts, (jlong)s.unmatched,
+        (jlong)s.legacyAcks, (jlong)s.windowFull, (jlong)s.rejectedCommands, s.inFlight,
+        s.rttLastUs, s.rttMinUs, s.rttMaxUs, s.rttMeanUs,
+        s.rails, s.deviceTickMs, s.lastReplyAgeMs, (jlong)s.syncReplies
+    };
+    jlongArray result = env->NewLongArray(16);
+    env->SetLongArrayRegion(result, 0, 16, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Servo Response Estimator
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_servoEstReset(JNIEnv*, jobject) {
+    servoEstimatorReset();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_servoEstSetChannel(JNIEnv*, jobject, jint commandId, jint channel) {
+    return servoEstimatorSetChannel((uint32_t)commandId, channel) ? JNI_TRUE : JNI_FALSE;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Chart Series Store
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_seriesInit(JNIEnv*, jobject, jint seriesCount, jint capacity) {
+    return seriesStoreInit(seriesCount, capacity) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_seriesClear(JNIEnv*, jobject) {
+    seriesStoreClear();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_seriesAppend(JNIEnv*, jobject, jint series, jfloat value) {
+    seriesStoreAppend(series, canRecorderNowUs(), value);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_seriesDecimate(
+        JNIEnv* env, jobject, jint series, jlong windowMs, jint method, jint maxPoints,
+        jfloatArray outX, jfloatArray outY) {
+    if (env->GetArrayLength(outX) < maxPoints) maxPoints = env->GetArrayLength(outX);
+    if (env->GetArrayLength(outY) < maxPoints) maxPoints = env->GetArrayLength(outY);
+    int64_t toUs = canRecorderNowUs();
+
+    // Written straight into the caller's reused arrays
+    float* x = (float*)env->GetPrimitiveArrayCritical(outX, nullptr);
+    float* y = (float*)env->GetPrimitiveArrayCritical(outY, nullptr);
+    int n = 0;
+    if (x != nullptr && y != nullptr) n = seriesStoreDecimate(series, toUs - windowMs * 1000, toUs, method, maxPoints, x, y);
+    if (y != nullptr) env->ReleasePrimitiveArrayCritical(outY, y, 0);
+    if (x != nullptr) env->ReleasePrimitiveArrayCritical(outX, x, 0);
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Telemetry Publisher (UDP / TCP subscribers)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryPublisherStart(
+        JNIEnv* env, jobject, jstring udpTargets, jint tcpPort, jboolean tcpLoopbackOnly,
+        jint multicastTtl, jint maxBatch, jint maxDelayUs) {
+    TelemetryPublisherConfig config;
+    telemetryPublisherDefaultConfig(&config);
+    config.udpTargets[0] = '\0';
+    if (udpTargets != nullptr) {
+        const char* t = env->GetStringUTFChars(udpTargets, NULL);
+        strncpy(config.udpTargets, t, sizeof(config.udpTargets) - 1);
+        env->ReleaseStringUTFChars(udpTargets, t);
+    }
+    config.tcpPort = tcpPort;
+    config.tcpLoopbackOnly = tcpLoopbackOnly ? 1 : 0;
+    config.multicastTtl = multicastTtl;
+    config.maxBatch = maxBatch;
+    config.maxDelayUs = maxDelayUs;
+    return telemetryPublisherStart(&config) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryPublisherStop(JNIEnv*, jobject) {
+    telemetryPublisherStop();
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryPublish(JNIEnv* env, jobject, jbyteArray frame, jint length) {
+    if (length != TELEMETRY_FRAME_SIZE || env->GetArrayLength(frame) < length) return -1;
+    uint8_t buffer[TELEMETRY_FRAME_SIZE];
+    env->GetByteArrayRegion(frame, 0, length, (jbyte*)buffer);
+    return telemetryPublisherPublish(buffer, length);
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryPublisherGetStats(JNIEnv* env, jobject) {
+    TelemetryPublisherStats s;
+    telemetryPublisherGetStats(&s);
+    jlong values[14] = {
+        (jlong)s.published, (jlong)s.queueDrops, (jlong)s.udpDatagrams, (jlong)s.udpCalls,
+        (jlong)s.udpErrors, (jlong)s.tcpAccepted, (jlong)s.tcpDisconnects, (jlong)s.tcpBytes,
+        (jlong)s.tcpDrops, s.latencyMeanUs, s.latencyMaxUs, s.tcpClients, s.udpTargets, s.running
+    };
+    jlongArray result = env->NewLongArray(14);
+    env->SetLongArrayRegion(result, 0, 14, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Telemetry Radio USB Writes (coalesced)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static UsbTxCoalescer* telemetryUsb = nullptr;
+static std::mutex telemetryUsbLock;     // Writes vs close
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryUsbOpen(
+        JNIEnv*, jobject, jint fd, jint epOut, jint packetSize, jint transferSize, jint maxDelayUs) {
+    std::lock_guard<std::mutex> guard(telemetryUsbLock);
+    if (telemetryUsb != nullptr) usbTxClose(telemetryUsb);
+    UsbTxConfig config;
+    usbTxDefaultConfig(&config);
+    if (packetSize > 0) config.packetSize = packetSize;
+    if (transferSize > 0) config.transferSize = transferSize;
+    if (maxDelayUs >= 0) config.maxDelayUs = maxDelayUs;
+    telemetryUsb = usbTxOpenUsb(fd, epOut, &config);
+    return telemetryUsb != nullptr ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryUsbWrite(JNIEnv* env, jobject, jbyteArray data, jint length) {
+    if (length <= 0 || length > 256 || env->GetArrayLength(data) < length) return 0;
+    uint8_t buffer[256];
+    env->GetByteArrayRegion(data, 0, length, (jbyte*)buffer);
+    std::lock_guard<std::mutex> guard(telemetryUsbLock);
+    if (telemetryUsb == nullptr) return -1;
+    return usbTxWrite(telemetryUsb, buffer, length);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryUsbClose(JNIEnv*, jobject) {
+    std::lock_guard<std::mutex> guard(telemetryUsbLock);
+    if (telemetryUsb == nullptr) return;
+    usbTxClose(telemetryUsb);
+    telemetryUsb = nullptr;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryUsbGetStats(JNIEnv* env, jobject) {
+    UsbTxStats s;
+    {
+        std::lock_guard<std::mutex> guard(telemetryUsbLock);
+        usbTxGetStats(telemetryUsb, &s);
+    }
+    jlong values[14] = {
+        (jlong)s.framesQueued, (jlong)s.framesDropped, (jlong)s.framesSent, (jlong)s.transfers,
+        (jlong)s.bytes, (jlong)s.sizeFlushes, (jlong)s.deadlineFlushes, (jlong)s.writeErrors,
+        s.delayMeanUs, s.delayP99Us, s.delayMaxUs, s.runTimeUs, s.pendingBytes, s.failed
+    };
+    jlongArray result = env->NewLongArray(14);
+    env->SetLongArrayRegion(result, 0, 14, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Telemetry Bus (typed records, one producer, a cursor per consumer)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const int BUS_STRIDE = 3 + TELEMETRY_BUS_VALUES;     // sequence, timeUs, type, values
+
+static void busRecordToDoubles(const TelemetryBusRecord& r, jdouble* out) {
+    out[0] = (jdouble)r.sequence;
+    out[1] = (jdouble)r.timeUs;
+    out[2] = (jdouble)r.type;
+    for (int i = 0; i < TELEMETRY_BUS_VALUES; i++) out[3 + i] = r.values[i];
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusPublish(
+        JNIEnv* env, jobject, jint type, jdoubleArray values, jint count) {
+    if (count < 0 || count > TELEMETRY_BUS_VALUES || env->GetArrayLength(values) < count) return 0;
+    jdouble buffer[TELEMETRY_BUS_VALUES];
+    env->GetDoubleArrayRegion(values, 0, count, buffer);
+    return (jlong)telemetryBusPublish((uint32_t)type, canRecorderNowUs(), buffer, count);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusSubscribe(
+        JNIEnv* env, jobject, jstring name, jint typeMask, jboolean fromOldest) {
+    const char* nameChars = env->GetStringUTFChars(name, nullptr);
+    int id = telemetryBusSubscribe(nameChars, (uint32_t)typeMask, fromOldest ? 1 : 0);
+    env->ReleaseStringUTFChars(name, nameChars);
+    return id;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusUnsubscribe(JNIEnv*, jobject, jint id) {
+    telemetryBusUnsubscribe(id);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusRead(
+        JNIEnv* env, jobject, jint id, jdoubleArray out, jint maxRecords) {
+    int capacity = env->GetArrayLength(out) / BUS_STRIDE;
+    if (maxRecords > capacity) maxRecords = capacity;
+    TelemetryBusRecord batch[32];
+    jdouble flat[32 * BUS_STRIDE];
+    int total = 0;
+    while (total < maxRecords) {
+        int want = maxRecords - total < 32 ? maxRecords - total : 32;
+        int n = telemetryBusRead(id, batch, want);
+        if (n < 0) return total > 0 ? total : -1;
+        for (int i = 0; i < n; i++) busRecordToDoubles(batch[i], &flat[i * BUS_STRIDE]);
+        env->SetDoubleArrayRegion(out, total * BUS_STRIDE, n * BUS_STRIDE, flat);
+        total += n;
+        if (n < want) break;
+    }
+    return total;
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusLatest(
+        JNIEnv* env, jobject, jint type, jdoubleArray out) {
+    TelemetryBusRecord r;
+    if (env->GetArrayLength(out) < BUS_STRIDE || !telemetryBusLatest((uint32_t)type, &r)) return 0;
+    jdouble flat[BUS_STRIDE];
+    busRecordToDoubles(r, flat);
+    env->SetDoubleArrayRegion(out, 0, BUS_STRIDE, flat);
+    return (jlong)r.sequence;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_telemetryBusGetStats(JNIEnv* env, jobject, jint id) {
+    TelemetryBusConsumerStats s;
+    telemetryBusConsumerStats(id, &s);
+    jlong values[4] = {(jlong)s.published, (jlong)s.received, (jlong)s.skipped, (jlong)s.lag};
+    jlongArray result = env->NewLongArray(4);
+    env->SetLongArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Timeline Tracing (names interned once, then passed by index)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceStart(JNIEnv*, jobject, jint eventsPerThread) {
+    traceStart(eventsPerThread);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceStop(JNIEnv*, jobject) {
+    traceStop();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceName(JNIEnv* env, jobject, jstring name) {
+    const char* nameChars = env->GetStringUTFChars(name, nullptr);
+    int index = traceInternName(nameChars);
+    env->ReleaseStringUTFChars(name, nameChars);
+    return index;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceBegin(JNIEnv*, jobject, jint name) {
+    traceBegin(traceNameAt(name));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceEnd(JNIEnv*, jobject) {
+    traceEnd();
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceCounter(JNIEnv*, jobject, jint name, jlong value) {
+    TRACE_COUNTER(traceNameAt(name), value);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceWriteChrome(JNIEnv* env, jobject, jstring path) {
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    int events = traceWriteChrome(pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return events;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_traceGetStats(JNIEnv* env, jobject) {
+    TraceStats s;
+    traceGetStats(&s);
+    jlong values[5] = {(jlong)s.events, (jlong)s.overwritten, (jlong)s.dropped, s.threads, s.recording};
+    jlongArray result = env->NewLongArray(5);
+    env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Runtime Parameters (live tuning, no controller reset)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramCount(JNIEnv*, jobject) {
+    return PARAM_COUNT;
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramName(JNIEnv* env, jobject, jint id) {
+    const ParamInfo* info = paramInfo(id);
+    return info ? env->NewStringUTF(info->name) : nullptr;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramFind(JNIEnv* env, jobject, jstring name) {
+    const char* nameChars = env->GetStringUTFChars(name, nullptr);
+    int id = paramFind(nameChars);
+    env->ReleaseStringUTFChars(name, nameChars);
+    return id;
+}
+
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramRange(JNIEnv* env, jobject, jint id) {
+    const ParamInfo* info = paramInfo(id);
+    if (!info) return nullptr;
+    jfloat values[4] = {info->defaultValue, info->minValue, info->maxValue, (jfloat)info->type};
+    jfloatArray result = env->NewFloatArray(4);
+    env->SetFloatArrayRegion(result, 0, 4, values);
+    return result;
+}
+
+extern "C" JNIEXPORT jfloat JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramGet(JNIEnv*, jobject, jint id) {
+    return paramGetFloat(id);
+}
+
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramGetAll(JNIEnv* env, jobject) {
+    jfloat values[PARAM_COUNT];
+    {
+        ParamPin pin;
+        for (int id = 0; id < PARAM_COUNT; id++) {
+            values[id] = paramInfo(id)->type == PARAM_TYPE_INT ? (jfloat)pin.i(id) : pin.f(id);
+        }
+    }
+    jfloatArray result = env->NewFloatArray(PARAM_COUNT);
+    env->SetFloatArrayRegion(result, 0, PARAM_COUNT, values);
+    return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramSet(JNIEnv*, jobject, jint id, jfloat value) {
+    return paramSet(id, value);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramSetMany(JNIEnv* env, jobject, jintArray ids, jfloatArray values) {
+    int count = env->GetArrayLength(ids);
+    if (count != env->GetArrayLength(values) || count > PARAM_COUNT) return -1;
+    jint idBuf[PARAM_COUNT];
+    jfloat valueBuf[PARAM_COUNT];
+    env->GetIntArrayRegion(ids, 0, count, idBuf);
+    env->GetFloatArrayRegion(values, 0, count, valueBuf);
+    int idInts[PARAM_COUNT];
+    for (int i = 0; i < count; i++) idInts[i] = idBuf[i];
+    return paramSetMany(idInts, valueBuf, count);
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramResetDefaults(JNIEnv*, jobject) {
+    return paramResetDefaults();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramGeneration(JNIEnv*, jobject) {
+    return (jint)paramGeneration();
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramSave(JNIEnv* env, jobject, jstring path) {
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    int saved = paramSave(pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return saved;
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramLoad(JNIEnv* env, jobject, jstring path) {
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    int applied = paramLoad(pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return applied;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_paramGetStats(JNIEnv* env, jobject) {
+    ParamStats s;
+    paramGetStats(&s);
+    jlong values[5] = {(jlong)s.generation, (jlong)s.swaps, (jlong)s.rejected, (jlong)s.slotWaits, s.pinned};
+    jlongArray result = env->NewLongArray(5);
+    env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Frame Arenas (per-frame scratch high-water report)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_arenaCount(JNIEnv*, jobject) {
+    return frameArenaCount();
+}
+
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_arenaName(JNIEnv* env, jobject, jint index) {
+    FrameArenaStats s;
+    return frameArenaStatsAt(index, &s) ? env->NewStringUTF(s.name) : nullptr;
+}
+
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_arenaGetStats(JNIEnv* env, jobject, jint index) {
+    FrameArenaStats s;
+    if (!frameArenaStatsAt(index, &s)) return nullptr;
+    jlong values[5] = {(jlong)s.capacity, (jlong)s.highWater, (jlong)s.frames, (jlong)s.spills, (jlong)s.grows};
+    jlongArray result = env->NewLongArray(5);
+    env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Pipeline Stage Deadlines
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineConfigure(
+        JNIEnv*, jobject, jint stage, jlong budgetUs, jint missLimit) {
+    return deadlineConfigure(stage, budgetUs, missLimit) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineReset(JNIEnv*, jobject) {
+    deadlineReset();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineRecord(JNIEnv*, jobject, jint stage, jlong durationUs) {
+    return deadlineRecord(stage, durationUs) ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineAdmit(JNIEnv*, jobject, jint stage) {
+    return deadlineAdmit(stage) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Per stage: runs, misses, last, max, budget (us); then engaged per policy,
+// detections skipped, sends held, predicted ticks, overruns, active mask
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineGetStats(JNIEnv* env, jobject) {
+    DeadlineStats s;
+    deadlineGetStats(&s);
+    const int count = DEADLINE_STAGES * 5 + DEADLINE_POLICIES + 5;
+    jlong values[count];
+    int n = 0;
+    for (int i = 0; i < DEADLINE_STAGES; i++) {
+        values[n++] = (jlong)s.runs[i];
+        values[n++] = (jlong)s.misses[i];
+        values[n++] = s.lastUs[i];
+        values[n++] = s.maxUs[i];
+        values[n++] = s.budgetUs[i];
+    }
+    for (int p = 0; p < DEADLINE_POLICIES; p++) values[n++] = (jlong)s.engaged[p];
+    values[n++] = (jlong)s.detectionsSkipped;
+    values[n++] = (jlong)s.sendsHeld;
+    values[n++] = (jlong)s.predictedTicks;
+    values[n++] = (jlong)s.overruns;
+    values[n++] = (jlong)s.activePolicies;
+    jlongArray result = env->NewLongArray(count);
+    env->SetLongArrayRegion(result, 0, count, values);
+    return result;
+}
+
+// Most recent overruns, oldest first: timeUs, stage, duration, budget, misses in a row
+extern "C" JNIEXPORT jlongArray JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineGetOverruns(JNIEnv* env, jobject, jint max) {
+    DeadlineOverrun ring[DEADLINE_RING_SIZE];
+    int n = deadlineRecentOverruns(ring, max < DEADLINE_RING_SIZE ? max : DEADLINE_RING_SIZE);
+    jlong values[DEADLINE_RING_SIZE * 5];
+    for (int i = 0; i < n; i++) {
+        values[i * 5 + 0] = ring[i].timeUs;
+        values[i * 5 + 1] = ring[i].stage;
+        values[i * 5 + 2] = ring[i].durationUs;
+        values[i * 5 + 3] = ring[i].budgetUs;
+        values[i * 5 + 4] = ring[i].consecutive;
+    }
+    jlongArray result = env->NewLongArray(n * 5);
+    env->SetLongArrayRegion(result, 0, n * 5, values);
+    return result;
+}
+
+// Values of a TELEMETRY_BUS_DEADLINE record (the streamer publishes it). Returns the count
+extern "C" JNIEXPORT jint JNICALL
+Java_com_example_canphon_native_1sensors_NativeCore_deadlineBusValues(JNIEnv* env, jobject, jdoubleArray out) {
+    const int count = DEADLINE_STAGES + 4;
+    if (env->GetArrayLength(out) < count) return 0;
+    DeadlineStats s;
+    deadlineGetStats(&s);
+    jdouble values[count];
+    for (int i = 0; i < DEADLINE_STAGES; i++) values[i] = (jdouble)s.misses[i];
+    values[DEADLINE_STAGES + 0] = (jdouble)s.activePolicies;
+    values[DEADLINE_STAGES + 1] = (jdouble)s.detectionsSkipped;
+    values[DEADLINE_STAGES + 2] = (jdouble)s.sendsHeld;
+    values[DEADLINE_STAGES + 3] = (jdouble)s.predictedTicks;
+    env->SetDoubleArrayRegion(out, 0, count, values);
+    return count;
+}
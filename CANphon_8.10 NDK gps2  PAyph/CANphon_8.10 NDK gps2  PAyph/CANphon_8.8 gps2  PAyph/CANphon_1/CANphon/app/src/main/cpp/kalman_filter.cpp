@@ -6,6 +6,7 @@
  * محسّن لتتبع الأهداف فائقة السرعة (صواريخ، طائرات)
  */
 
+#include "param_store.h"
 #include <cmath>
 #include <cstring>
 #include <android/log.h>
@@ -30,6 +31,9 @@ struct KalmanState {
     // Measurement noise
     double measurementNoise;
     
+    // Parameter generation the noise values belong to
+    uint32_t noiseGeneration;
+    
     // Initialized flag
     bool initialized;
 };
@@ -77,6 +81,16 @@ inline void matMul4x4(const double a[4][4], const double b[4][4], double out[4][
 // Kalman Filter Functions
 // ═══════════════════════════════════════════════════════════════════════════
 
+// Tuning changed: new noise values, state and covariance are kept
+static inline void refreshNoise() {
+    if (paramGeneration() == kalman.noiseGeneration) return;
+    ParamPin p;
+    kalman.processNoise = p.f(PARAM_KALMAN_PROCESS_NOISE);
+    kalman.measurementNoise = p.f(PARAM_KALMAN_MEASUREMENT_NOISE);
+    kalman.noiseGeneration = p.snapshot->generation;
+}
+
+// Noise passed here holds until the next parameter change
 extern "C" void kalmanInit(double x, double y, double processNoise, double measurementNoise) {
     kalman.state[0] = x;
     kalman.state[1] = y;
@@ -85,6 +99,7 @@ extern "C" void kalmanInit(double x, double y, double processNoise, double measu
     
     kalman.processNoise = processNoise;
     kalman.measurementNoise = measurementNoise;
+    kalman.noiseGeneration = paramGeneration();
     
     // Initialize covariance matrix
     memset(kalman.P, 0, sizeof(kalman.P));
@@ -103,6 +118,7 @@ extern "C" void kalmanPredict(double* outX, double* outY) {
         *outY = 0;
         return;
     }
+    refreshNoise();
     
     // State prediction: x' = F * x
     double predictedState[4];
@@ -137,9 +153,11 @@ extern "C" void kalmanPredict(double* outX, double* outY) {
 
 extern "C" void kalmanUpdate(double measuredX, double measuredY) {
     if (!kalman.initialized) {
-        kalmanInit(measuredX, measuredY, 300.0, 1.0);
+        kalmanInit(measuredX, measuredY, paramGetFloat(PARAM_KALMAN_PROCESS_NOISE),
+                   paramGetFloat(PARAM_KALMAN_MEASUREMENT_NOISE));
         return;
     }
+    refreshNoise();
     
     // Innovation: y = z - H * x
     double innovation[2];
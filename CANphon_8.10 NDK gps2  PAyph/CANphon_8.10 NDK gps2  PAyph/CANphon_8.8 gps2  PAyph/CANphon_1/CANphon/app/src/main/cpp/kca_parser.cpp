@@ -0,0 +1,197 @@
+/**
+ * kca_parser.cpp
+ * KCA GNSS Protocol Parser (C++)
+ *
+ * Converted from KcaParser.kt. The payload is copied in bulk and the
+ * CRC is table-driven; frame acceptance is unchanged.
+ */
+
+#define LOG_TAG "NativeKca"
+#include "kca_parser.h"
+#include "native_log.h"
+#include <cstring>
+
+enum {
+    KCA_STATE_UNINIT = 0,
+    KCA_STATE_GOT_SYNC1,
+    KCA_STATE_GOT_SYNC2,     // Payload in progress
+    KCA_STATE_GOT_PAYLOAD    // CRC in progress
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CRC-16 CCITT (X^16 + X^12 + X^5 + 1)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint16_t crcTable[256];
+static bool crcTableReady = false;
+
+static void buildCrcTable() {
+    for (int i = 0; i < 256; i++) {
+        uint16_t crc = (uint16_t)(i << 8);
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+        crcTable[i] = crc;
+    }
+    crcTableReady = true;
+}
+
+extern "C" uint16_t kcaCrc16(const uint8_t* data, int length) {
+    if (!crcTableReady) buildCrcTable();
+    uint16_t crc = 0;
+    for (int i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 8) ^ crcTable[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Payload Decoding
+// ═══════════════════════════════════════════════════════════════════════════
+
+template <typename T>
+static inline T readLE(const uint8_t*& p) {
+    T value;
+    memcpy(&value, p, sizeof(T));   // Host and ARM are little-endian
+    p += sizeof(T);
+    return value;
+}
+
+static int countBits(uint32_t value) {
+    return __builtin_popcount(value);
+}
+
+extern "C" void kcaDecodeNav(const uint8_t* payload, KcaNavData* nav) {
+    const uint8_t* p = payload;
+
+    nav->msgType = readLE<uint8_t>(p);
+    nav->state = readLE<int8_t>(p);
+    nav->temperature = readLE<int8_t>(p);
+    nav->utcTime = readLE<uint32_t>(p);
+    nav->visibleSatellites = readLE<uint32_t>(p);
+    nav->usedSatellites = readLE<uint32_t>(p);
+    nav->glonassVisibleSat = readLE<uint32_t>(p);
+    nav->glonassUsedSat = readLE<uint32_t>(p);
+
+    float* floats[] = {
+        &nav->x, &nav->xProp, &nav->y, &nav->yProp, &nav->z, &nav->zProp,
+        &nav->latitude, &nav->latProp, &nav->longitude, &nav->lonProp, &nav->altitude, &nav->altProp,
+        &nav->vx, &nav->vxProp, &nav->vy, &nav->vyProp, &nav->vz, &nav->vzProp,
+        &nav->ax, &nav->ay, &nav->az
+    };
+    for (float* f : floats) *f = readLE<float>(p);
+
+    memcpy(nav->snr, p, 12);
+    p += 12;
+    memcpy(nav->glonassSnr, p, 12);
+    p += 12;
+
+    nav->weekNumber = readLE<uint16_t>(p);
+    nav->utcOffset = readLE<uint16_t>(p);
+    nav->localTime = readLE<uint32_t>(p);
+    nav->packDelay = readLE<int32_t>(p);
+    nav->gdop = readLE<int8_t>(p);
+    nav->pdop = readLE<int8_t>(p);
+    nav->hdop = readLE<int8_t>(p);
+    nav->vdop = readLE<int8_t>(p);
+    nav->tdop = readLE<int8_t>(p);
+
+    nav->usedSatCount = 0;
+    nav->glonassUsedSatCount = 0;
+}
+
+// Same acceptance rules as KcaParser.processMessage
+static void processMessage(KcaParser* parser) {
+    parser->messages++;
+
+    KcaNavData nav;
+    kcaDecodeNav(parser->payload, &nav);
+
+    if (nav.state == 0) {
+        parser->gFlag = 0;
+    } else if (nav.state >= 0x01) {
+        parser->gFlag++;
+    }
+
+    if (nav.state >= 0x01 && parser->gFlag > KCA_MIN_FIX_MESSAGES) {
+        nav.usedSatCount = countBits(nav.usedSatellites & nav.visibleSatellites);
+        nav.glonassUsedSatCount = countBits(nav.glonassUsedSat & nav.glonassVisibleSat);
+
+        if (nav.usedSatCount + nav.glonassUsedSatCount > 4 &&
+            (nav.usedSatCount > 3 || nav.glonassUsedSatCount > 3)) {
+            parser->navAccepted++;
+            if (parser->onNav != nullptr) parser->onNav(&nav, parser->user);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Parser
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void kcaParserInit(KcaParser* parser, KcaNavCallback onNav, void* user) {
+    memset(parser, 0, sizeof(*parser));
+    parser->state = KCA_STATE_UNINIT;
+    parser->onNav = onNav;
+    parser->user = user;
+    if (!crcTableReady) buildCrcTable();
+}
+
+extern "C" int kcaParse(KcaParser* parser, const uint8_t* data, int length) {
+    int frames = 0;
+    parser->bytes += length;
+
+    for (int i = 0; i < length; i++) {
+        uint8_t c = data[i];
+
+        switch (parser->state) {
+            case KCA_STATE_UNINIT:
+                if (c == KCA_SYNC1) parser->state = KCA_STATE_GOT_SYNC1;
+                break;
+
+            case KCA_STATE_GOT_SYNC1:
+                if (c == KCA_SYNC2) {
+                    parser->state = KCA_STATE_GOT_SYNC2;
+                    parser->payloadIndex = 0;
+                } else {
+                    parser->frameErrors++;
+                    parser->state = KCA_STATE_UNINIT;
+                }
+                break;
+
+            case KCA_STATE_GOT_SYNC2: {
+                // Copy as much of the payload as this chunk holds
+                int need = KCA_MAX_PAYLOAD - parser->payloadIndex;
+                int take = length - i;
+                if (take > need) take = need;
+                memcpy(parser->payload + parser->payloadIndex, data + i, take);
+                parser->payloadIndex += take;
+                i += take - 1;
+
+                if (parser->payloadIndex >= KCA_MAX_PAYLOAD) {
+                    parser->crc = kcaCrc16(parser->payload, KCA_MAX_PAYLOAD);
+                    parser->crcIndex = 0;
+                    parser->state = KCA_STATE_GOT_PAYLOAD;
+                }
+                break;
+            }
+
+            case KCA_STATE_GOT_PAYLOAD: {
+                uint8_t expected = parser->crcIndex == 0 ? (uint8_t)(parser->crc & 0xFF)
+                                                         : (uint8_t)(parser->crc >> 8);
+                if (c != expected) {
+                    parser->frameErrors++;
+                    parser->state = KCA_STATE_UNINIT;
+                } else if (parser->crcIndex == 0) {
+                    parser->crcIndex = 1;
+                } else {
+                    processMessage(parser);
+                    frames++;
+                    parser->state = KCA_STATE_UNINIT;
+                }
+                break;
+            }
+        }
+    }
+    return frames;
+}
@@ -0,0 +1,96 @@
+/**
+ * kca_parser.h
+ * KCA GNSS Protocol Parser (C++)
+ *
+ * Converted from KcaParser.kt (same state machine and acceptance rules)
+ *
+ * Frame: [0x81] [0x7E] [PAYLOAD: 160 bytes] [CRC16 LE]
+ * CRC-16 CCITT (poly 0x1021, init 0) over the payload
+ */
+
+#ifndef KCA_PARSER_H
+#define KCA_PARSER_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KCA_SYNC1 0x81
+#define KCA_SYNC2 0x7E
+#define KCA_MAX_PAYLOAD 160
+#define KCA_FRAME_SIZE (2 + KCA_MAX_PAYLOAD + 2)
+#define KCA_MIN_FIX_MESSAGES 75    // Consecutive fix messages before output (gFlag)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Data Structures
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Navigation message (payload layout, little-endian; see NavData.kt)
+typedef struct {
+    uint8_t msgType;
+    int8_t state;                // 0 = no fix
+    int8_t temperature;
+    uint32_t utcTime;
+    uint32_t visibleSatellites;  // GPS bitmask
+    uint32_t usedSatellites;
+    uint32_t glonassVisibleSat;
+    uint32_t glonassUsedSat;
+    float x, xProp, y, yProp, z, zProp;
+    float latitude, latProp, longitude, lonProp, altitude, altProp;
+    float vx, vxProp, vy, vyProp, vz, vzProp;
+    float ax, ay, az;
+    int8_t snr[12];
+    int8_t glonassSnr[12];
+    uint16_t weekNumber;
+    uint16_t utcOffset;
+    uint32_t localTime;
+    int32_t packDelay;
+    int8_t gdop, pdop, hdop, vdop, tdop;
+
+    // Filled by the parser
+    int usedSatCount;
+    int glonassUsedSatCount;
+} KcaNavData;
+
+typedef void (*KcaNavCallback)(const KcaNavData* nav, void* user);
+
+typedef struct {
+    int state;
+    int payloadIndex;
+    int crcIndex;
+    uint16_t crc;
+    uint8_t payload[KCA_MAX_PAYLOAD];
+    long gFlag;
+
+    KcaNavCallback onNav;        // Called for accepted fixes (may be NULL)
+    void* user;
+
+    // Statistics
+    uint64_t bytes;
+    uint64_t messages;           // CRC-valid frames
+    uint64_t frameErrors;
+    uint64_t navAccepted;        // Passed fix / satellite checks
+} KcaParser;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Parser
+// ═══════════════════════════════════════════════════════════════════════════
+
+void kcaParserInit(KcaParser* parser, KcaNavCallback onNav, void* user);
+
+// Feed any number of bytes. Returns CRC-valid frames completed in this call
+int kcaParse(KcaParser* parser, const uint8_t* data, int length);
+
+// Decode a 160-byte payload (no acceptance checks)
+void kcaDecodeNav(const uint8_t* payload, KcaNavData* nav);
+
+// CRC-16 CCITT as used on the wire (for tools that build frames)
+uint16_t kcaCrc16(const uint8_t* data, int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KCA_PARSER_H
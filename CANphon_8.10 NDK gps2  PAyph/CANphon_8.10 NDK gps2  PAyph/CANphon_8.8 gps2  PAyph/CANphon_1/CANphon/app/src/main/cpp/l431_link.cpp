@@ -0,0 +1,229 @@
+/**
+ * l431_link.cpp
+ * L431 Power Unit Link (C++)
+ *
+ * Replaces the fire-and-forget L431Protocol frames: every request carries
+ * a sequence number, replies are matched in the dispatch handler, and the
+ * round trip is measured from submit to reply.
+ */
+
+#define LOG_TAG "NativeL431"
+#include "l431_link.h"
+#include "can_dispatch.h"
+#include "native_log.h"
+#include <atomic>
+#include <cstring>
+#include <ctime>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Tracker State
+// ═══════════════════════════════════════════════════════════════════════════
+
+// One slot per sequence number
+typedef struct {
+    std::atomic<int> pending;   // 0 = free, 1 = waiting for the reply, 2 = being claimed
+    std::atomic<int64_t> sentUs;
+} PendingSlot;
+
+static PendingSlot slots[256];
+static std::atomic<uint32_t> nextSeq(0);
+static std::atomic<int64_t> inFlight(0);
+static int64_t timeoutUs = L431_LINK_DEFAULT_TIMEOUT_MS * 1000;
+
+static std::atomic<uint64_t> requests(0);
+static std::atomic<uint64_t> replies(0);
+static std::atomic<uint64_t> timeouts(0);
+static std::atomic<uint64_t> unmatched(0);
+static std::atomic<uint64_t> legacyAcks(0);
+static std::atomic<uint64_t> windowFull(0);
+static std::atomic<uint64_t> rejectedCommands(0);
+static std::atomic<uint64_t> syncReplies(0);
+
+// Written by the read thread only
+static std::atomic<int64_t> rttLastUs(0);
+static std::atomic<int64_t> rttMinUs(0);
+static std::atomic<int64_t> rttMaxUs(0);
+static std::atomic<int64_t> rttSumUs(0);
+static std::atomic<int64_t> rails(-1);
+static std::atomic<int64_t> deviceTickMs(0);
+static std::atomic<int64_t> lastReplyUs(0);
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Frames
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int l431FormatRequest(uint8_t seq, const uint8_t* commands, int count, WsCanFrame* out) {
+    if (count < 1 || count > L431_MAX_COMMANDS) return 0;
+
+    out->id = L431_REQUEST_ID;
+    out->dlc = (uint8_t)(2 + count);
+    out->flags = 0;
+    memset(out->data, 0, WS_MAX_DLC);
+    out->data[0] = (uint8_t)(L431_FRAME_V2 | count);
+    out->data[1] = seq;
+    memcpy(out->data + 2, commands, count);
+    return 1;
+}
+
+extern "C" int l431ParseStatus(const WsCanFrame* frame, L431Status* out) {
+    if (frame->id != L431_REPLY_ID || frame->dlc < 8) return 0;
+    if (frame->data[0] != L431_REPLY_STATUS && frame->data[0] != L431_REPLY_SYNC) return 0;
+
+    const uint8_t* d = frame->data;
+    out->seq = d[1];
+    out->executed = d[2] & 0x0F;
+    out->rejected = d[2] >> 4;
+    out->rails = d[3];
+    out->deviceTickMs = (uint32_t)d[4] | ((uint32_t)d[5] << 8) | ((uint32_t)d[6] << 16) | ((uint32_t)d[7] << 24);
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Reply Handler (read thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void handleReply(const WsCanFrame* frame, int, int64_t) {
+    L431Status status;
+    if (!l431ParseStatus(frame, &status)) {
+        if (frame->dlc >= 1 && (frame->data[0] == L431_ACK_POWER_ON || frame->data[0] == L431_ACK_POWER_OFF ||
+                                frame->data[0] == L431_ACK_HEARTBEAT)) {
+            legacyAcks.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    int64_t now = monotonicUs();
+    rails.store(status.rails, std::memory_order_relaxed);
+    deviceTickMs.store(status.deviceTickMs, std::memory_order_relaxed);
+    lastReplyUs.store(now, std::memory_order_relaxed);
+    if (status.rejected) rejectedCommands.fetch_add(status.rejected, std::memory_order_relaxed);
+
+    // SYNC replies carry the SYNC counter, not a request sequence number
+    if (frame->data[0] == L431_REPLY_SYNC) {
+        syncReplies.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    PendingSlot* slot = &slots[status.seq];
+    int expected = 1;
+    if (!slot->pending.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        unmatched.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    inFlight.fetch_sub(1, std::memory_order_relaxed);
+
+    int64_t rtt = now - slot->sentUs.load(std::memory_order_relaxed);
+    uint64_t n = replies.fetch_add(1, std::memory_order_relaxed) + 1;
+    rttLastUs.store(rtt, std::memory_order_relaxed);
+    rttSumUs.fetch_add(rtt, std::memory_order_relaxed);
+    if (n == 1 || rtt < rttMinUs.load(std::memory_order_relaxed)) rttMinUs.store(rtt, std::memory_order_relaxed);
+    if (rtt > rttMaxUs.load(std::memory_order_relaxed)) rttMaxUs.store(rtt, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Request Tracker
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void l431LinkReset(int timeoutMs) {
+    for (int i = 0; i < 256; i++) {
+        slots[i].pending.store(0, std::memory_order_relaxed);
+        slots[i].sentUs.store(0, std::memory_order_relaxed);
+    }
+    timeoutUs = (int64_t)(timeoutMs > 0 ? timeoutMs : L431_LINK_DEFAULT_TIMEOUT_MS) * 1000;
+    inFlight = 0;
+    requests = 0;
+    replies = 0;
+    timeouts = 0;
+    unmatched = 0;
+    legacyAcks = 0;
+    windowFull = 0;
+    rejectedCommands = 0;
+    syncReplies = 0;
+    rttLastUs = 0;
+    rttMinUs = 0;
+    rttMaxUs = 0;
+    rttSumUs = 0;
+    rails = -1;
+    deviceTickMs = 0;
+    lastReplyUs = 0;
+}
+
+extern "C" int l431LinkInstall() {
+    return canDispatchSetHandler(L431_REPLY_ID, handleReply, 0);
+}
+
+extern "C" int l431LinkPoll() {
+    int64_t now = monotonicUs();
+    for (int i = 0; i < 256; i++) {
+        PendingSlot* slot = &slots[i];
+        if (slot->pending.load(std::memory_order_acquire) != 1) continue;
+        if (now - slot->sentUs.load(std::memory_order_relaxed) < timeoutUs) continue;
+
+        int expected = 1;
+        if (slot->pending.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+            inFlight.fetch_sub(1, std::memory_order_relaxed);
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return (int)inFlight.load(std::memory_order_relaxed);
+}
+
+extern "C" int l431LinkSubmit(const uint8_t* commands, int count) {
+    if (commands == nullptr || count < 1 || count > L431_MAX_COMMANDS) return -1;
+
+    // Concurrent submits may overshoot the window by a few; slots cannot collide
+    if (inFlight.load(std::memory_order_relaxed) >= L431_LINK_WINDOW && l431LinkPoll() >= L431_LINK_WINDOW) {
+        windowFull.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    inFlight.fetch_add(1, std::memory_order_relaxed);
+
+    // Fast replies can lap a lost request still waiting for its timeout:
+    // skip sequence numbers whose slot is taken
+    for (int attempt = 0; attempt < 256; attempt++) {
+        uint8_t seq = (uint8_t)nextSeq.fetch_add(1, std::memory_order_relaxed);
+        PendingSlot* slot = &slots[seq];
+        int expected = 0;
+        if (!slot->pending.compare_exchange_strong(expected, 2, std::memory_order_acquire)) continue;
+
+        slot->sentUs.store(monotonicUs(), std::memory_order_relaxed);
+        slot->pending.store(1, std::memory_order_release);
+        requests.fetch_add(1, std::memory_order_relaxed);
+        return seq;
+    }
+    inFlight.fetch_sub(1, std::memory_order_relaxed);
+    return -1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Statistics
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void l431LinkGetStats(L431LinkStats* out) {
+    l431LinkPoll();
+
+    out->requests = requests.load(std::memory_order_relaxed);
+    out->replies = replies.load(std::memory_order_relaxed);
+    out->timeouts = timeouts.load(std::memory_order_relaxed);
+    out->unmatched = unmatched.load(std::memory_order_relaxed);
+    out->legacyAcks = legacyAcks.load(std::memory_order_relaxed);
+    out->windowFull = windowFull.load(std::memory_order_relaxed);
+    out->rejectedCommands = rejectedCommands.load(std::memory_order_relaxed);
+    out->inFlight = inFlight.load(std::memory_order_relaxed);
+    out->rttLastUs = rttLastUs.load(std::memory_order_relaxed);
+    out->rttMinUs = rttMinUs.load(std::memory_order_relaxed);
+    out->rttMaxUs = rttMaxUs.load(std::memory_order_relaxed);
+    out->rttMeanUs = out->replies > 0 ? rttSumUs.load(std::memory_order_relaxed) / (int64_t)out->replies : 0;
+    out->rails = rails.load(std::memory_order_relaxed);
+    out->deviceTickMs = deviceTickMs.load(std::memory_order_relaxed);
+
+    int64_t last = lastReplyUs.load(std::memory_order_relaxed);
+    out->lastReplyAgeMs = last > 0 ? (monotonicUs() - last) / 1000 : -1;
+    out->syncReplies = syncReplies.load(std::memory_order_relaxed);
+}
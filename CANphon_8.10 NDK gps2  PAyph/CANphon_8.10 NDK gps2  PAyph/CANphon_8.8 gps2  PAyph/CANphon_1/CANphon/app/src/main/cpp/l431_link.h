@@ -0,0 +1,121 @@
+/**
+ * l431_link.h
+ * L431 Power Unit Link (C++)
+ *
+ * Request/reply protocol of the L431 PUI board (L431 PUI/Core/Src/pui_protocol.c)
+ * and the phone-side request tracker.
+ *
+ * Request (0x100): [0x80 | n] [seq] [cmd 1] .. [cmd n]       n = 1..6
+ * Reply   (0x101): [0x5A] [seq] [executed | rejected << 4] [rails]
+ *                  [tick 0..3]                               8 bytes, LE
+ *
+ * SYNC    (0x080): [counter]           → reply 0x5B, same layout, seq = counter
+ * Broadcast (0x102): request layout      → applied, no reply (v2 framing only)
+ *
+ * Legacy single-command frames ([cmd], 1-byte ACK 0xAA/0xBB/0xCC) are
+ * still served by the firmware; their ACKs are counted but cannot be
+ * matched to a request.
+ *
+ * Requests are matched to replies by sequence number on the read thread,
+ * so senders never wait; unanswered requests expire after a timeout.
+ */
+
+#ifndef L431_LINK_H
+#define L431_LINK_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define L431_REQUEST_ID 0x100           // Phone → L431
+#define L431_REPLY_ID 0x101             // L431 → phone
+#define L431_SYNC_ID 0x080              // CANopen SYNC, answered with L431_REPLY_SYNC
+#define L431_BROADCAST_ID 0x102         // v2 requests to every unit, no reply
+
+#define L431_CMD_POWER_ON 0x01          // PA9=HIGH, PA10=HIGH, PA5=LOW
+#define L431_CMD_POWER_OFF 0x02         // PA5=HIGH, PA9=LOW, PA10=LOW
+#define L431_CMD_HEARTBEAT 0x03         // Toggle PB6
+#define L431_CMD_STATUS 0x04            // No action, reply only
+
+#define L431_FRAME_V2 0x80              // Request byte 0: flag | command count
+#define L431_MAX_COMMANDS 6
+#define L431_REPLY_STATUS 0x5A
+#define L431_REPLY_SYNC 0x5B
+#define L431_ACK_POWER_ON 0xAA          // Legacy ACKs
+#define L431_ACK_POWER_OFF 0xBB
+#define L431_ACK_HEARTBEAT 0xCC
+
+// Reply rails byte: output latch of each pin
+#define L431_RAIL_PA5 0x01
+#define L431_RAIL_PA9 0x02
+#define L431_RAIL_PA10 0x04
+#define L431_RAIL_PB6 0x08
+
+#define L431_LINK_WINDOW 16             // Requests in flight
+#define L431_LINK_DEFAULT_TIMEOUT_MS 100
+
+typedef struct {
+    uint8_t seq;
+    uint8_t executed;       // Commands applied
+    uint8_t rejected;       // Unknown command bytes
+    uint8_t rails;          // L431_RAIL_* bits after the request
+    uint32_t deviceTickMs;  // HAL_GetTick() when the request was processed
+} L431Status;
+
+typedef struct {
+    uint64_t requests;
+    uint64_t replies;        // Matched to a pending request
+    uint64_t timeouts;
+    uint64_t unmatched;      // Late (after timeout) or duplicate replies
+    uint64_t legacyAcks;
+    uint64_t windowFull;     // Submits refused, L431_LINK_WINDOW in flight
+    uint64_t rejectedCommands;
+    int64_t inFlight;
+    int64_t rttLastUs;
+    int64_t rttMinUs;
+    int64_t rttMaxUs;
+    int64_t rttMeanUs;
+    int64_t rails;           // -1 until the first status reply
+    int64_t deviceTickMs;
+    int64_t lastReplyAgeMs;  // -1 until the first status reply
+    uint64_t syncReplies;    // Status replies to SYNC (rails/tick only)
+} L431LinkStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Frames
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Build a request frame. Returns 0 if count is not 1..L431_MAX_COMMANDS
+int l431FormatRequest(uint8_t seq, const uint8_t* commands, int count, WsCanFrame* out);
+
+// Parse a status or SYNC reply. Returns 1 on success, 0 for legacy ACKs / other frames
+int l431ParseStatus(const WsCanFrame* frame, L431Status* out);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Request Tracker
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Forget all requests and statistics
+void l431LinkReset(int timeoutMs);
+
+// Install the reply handler in can_dispatch (again after canDispatchClearHandlers)
+int l431LinkInstall();
+
+// Register a request and return its sequence number (the caller sends
+// l431FormatRequest(seq, ...)), -1 if the window is full or count invalid.
+// Any thread
+int l431LinkSubmit(const uint8_t* commands, int count);
+
+// Expire requests older than the timeout. Returns requests still in flight
+int l431LinkPoll();
+
+void l431LinkGetStats(L431LinkStats* outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // L431_LINK_H
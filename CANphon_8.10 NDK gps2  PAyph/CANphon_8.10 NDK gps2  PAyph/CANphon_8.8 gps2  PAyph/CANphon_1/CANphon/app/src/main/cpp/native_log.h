@@ -0,0 +1,30 @@
+/**
+ * native_log.h
+ * Logging for modules that also build on the host (host_tools/)
+ *
+ * Android → logcat, host → stderr.
+ * Define LOG_TAG before including.
+ */
+
+#ifndef NATIVE_LOG_H
+#define NATIVE_LOG_H
+
+#ifndef LOG_TAG
+#define LOG_TAG "CANphonNative"
+#endif
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#else
+#include <cstdio>
+#define NATIVE_LOG_(level, ...) \
+    do { fprintf(stderr, "%s/%s: ", level, LOG_TAG); fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } while (0)
+#define LOGI(...) NATIVE_LOG_("I", __VA_ARGS__)
+#define LOGD(...) do { } while (0)
+#define LOGW(...) NATIVE_LOG_("W", __VA_ARGS__)
+#endif
+
+#endif // NATIVE_LOG_H
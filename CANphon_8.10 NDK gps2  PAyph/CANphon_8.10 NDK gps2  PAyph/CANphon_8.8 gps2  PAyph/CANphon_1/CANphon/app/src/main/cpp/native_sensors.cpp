@@ -4,18 +4,41 @@
  * 
  * هذا الكود يستخدم ASensorManager للوصول المباشر للحساسات
  * بأقصى تردد ممكن (SENSOR_DELAY_FASTEST)
+ *
+ * Two ways to run the sensors:
+ *   - startSensors: enableSensor + setEventRate, events read by the
+ *     caller's pollSensors loop (one delivery per sample).
+ *   - startSensorsBatched: ASensorEventQueue_registerSensor with a
+ *     maxBatchReportLatencyUs on a native drain thread. The sensor hub
+ *     keeps samples in its FIFO and hands them over in bursts; the thread
+ *     wakes once per burst and pushes it into imu_ring, pollSensors then
+ *     takes everything pending. SENSOR_PROFILE_LOW_LATENCY (latency 0,
+ *     one wakeup per sample) vs SENSOR_PROFILE_BATCHED; the thread's CPU
+ *     time per 1000 samples is in getSensorBatchStats.
  */
 
 #include <android/sensor.h>
 #include <android/looper.h>
 #include <android/log.h>
+#include <atomic>
 #include <cstring>
 #include <cmath>
+#include <ctime>
+#include <pthread.h>
+#include "imu_ring.h"
 
 #define LOG_TAG "NativeSensors"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+// Profiles for startSensorsBatched (NativeSensorManager.PROFILE_*)
+#define SENSOR_PROFILE_LOW_LATENCY 0        // maxBatchReportLatencyUs 0: one wakeup per sample
+#define SENSOR_PROFILE_BATCHED 1            // Samples held in the hub FIFO up to the latency
+#define SENSOR_BATCH_DEFAULT_LATENCY_US 100000  // Batched profile when 0 is passed (10 Hz wakeups)
+#define SENSOR_MAG_PERIOD_US 10000          // 100 Hz max for mag
+#define SENSOR_DRAIN_IDENT 1                // Looper ident of the drain thread's queue
+#define SENSOR_DRAIN_TIMEOUT_MS 500         // pollOnce wait (stop wakes the looper directly)
+
 // Sensor data structure
 struct SensorData {
     float accel[3];      // Accelerometer X, Y, Z
@@ -42,6 +65,78 @@ static int64_t lastGyroTimestamp = 0;
 static int gyroSampleCount = 0;
 static float measuredGyroRate = 0.0f;
 
+// Batched drain thread
+static pthread_t drainThread;
+static bool drainStarted = false;
+static ALooper* drainLooper = nullptr;
+static std::atomic<bool> drainStopRequested(false);
+static pthread_mutex_t drainSetupLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t drainSetupCond = PTHREAD_COND_INITIALIZER;
+static int drainSetupResult = 0;           // 0 pending, 1 running, -1 failed
+static int drainProfile = SENSOR_PROFILE_LOW_LATENCY;
+static int drainAccelPeriodUs = 0;
+static int drainGyroPeriodUs = 0;
+static int64_t drainLatencyUs = 0;
+
+static int64_t threadCpuNs() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Latest values and the measured gyro rate, from one event (either path)
+static void applySample(int type, int64_t timestampNs, const float* v) {
+    switch (type) {
+        case ASENSOR_TYPE_ACCELEROMETER:
+            memcpy(latestData.accel, v, sizeof(float) * 3);
+            break;
+
+        case ASENSOR_TYPE_GYROSCOPE:
+            memcpy(latestData.gyro, v, sizeof(float) * 3);
+            latestData.timestamp = timestampNs;
+
+            // Calculate actual sample rate
+            if (lastGyroTimestamp > 0) {
+                int64_t deltaT = timestampNs - lastGyroTimestamp;
+                if (deltaT > 0) {
+                    float instantRate = 1000000000.0f / deltaT;
+                    measuredGyroRate = measuredGyroRate * 0.9f + instantRate * 0.1f;
+                }
+            }
+            lastGyroTimestamp = timestampNs;
+            gyroSampleCount++;
+            break;
+
+        case ASENSOR_TYPE_MAGNETIC_FIELD:
+            memcpy(latestData.mag, v, sizeof(float) * 3);
+            break;
+    }
+}
+
+// Event -> ring sample. Returns 0 for sensor types we don't keep
+static int toSample(const ASensorEvent& e, ImuSample* out) {
+    out->timestampNs = e.timestamp;
+    out->type = e.type;
+    switch (e.type) {
+        case ASENSOR_TYPE_ACCELEROMETER:
+            out->v[0] = e.acceleration.x;
+            out->v[1] = e.acceleration.y;
+            out->v[2] = e.acceleration.z;
+            return 1;
+        case ASENSOR_TYPE_GYROSCOPE:
+            out->v[0] = e.uncalibrated_gyro.x_uncalib;
+            out->v[1] = e.uncalibrated_gyro.y_uncalib;
+            out->v[2] = e.uncalibrated_gyro.z_uncalib;
+            return 1;
+        case ASENSOR_TYPE_MAGNETIC_FIELD:
+            out->v[0] = e.magnetic.x;
+            out->v[1] = e.magnetic.y;
+            out->v[2] = e.magnetic.z;
+            return 1;
+    }
+    return 0;
+}
+
 /**
  * Initialize native sensor access
  * Returns: 0 on success, -1 on failure
@@ -103,11 +198,15 @@ extern "C" int initNativeSensors() {
  * Start sensor polling at maximum rate
  * usDelay: Delay in microseconds (0 = FASTEST)
  */
+extern "C" void stopSensors();
+
 extern "C" int startSensors(int usDelay) {
     if (!sensorsInitialized) {
         LOGE("Sensors not initialized!");
         return -1;
     }
+    if (drainStarted) stopSensors();
+    imuRingReset();     // Batch stats describe the last batched run only
     
     // Use minimum delay if 0 is passed (FASTEST)
     int accelDelay = usDelay > 0 ? usDelay : ASensor_getMinDelay(accelerometer);
@@ -124,13 +223,179 @@ extern "C" int startSensors(int usDelay) {
     
     if (magnetometer) {
         ASensorEventQueue_enableSensor(eventQueue, magnetometer);
-        ASensorEventQueue_setEventRate(eventQueue, magnetometer, 10000); // 100 Hz max for mag
+        ASensorEventQueue_setEventRate(eventQueue, magnetometer, SENSOR_MAG_PERIOD_US);
     }
     
     LOGI("Sensors started at maximum rate!");
     return 0;
 }
 
+// ═══════════════════════════════════════════════════════════════════════════
+// Batched Sensors (registerSensor + drain thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void drainSetupDone(int result) {
+    pthread_mutex_lock(&drainSetupLock);
+    drainSetupResult = result;
+    pthread_cond_signal(&drainSetupCond);
+    pthread_mutex_unlock(&drainSetupLock);
+}
+
+static void* drainLoop(void*) {
+    int64_t cpuStartNs = threadCpuNs();
+
+    // The queue belongs to this thread's looper so pollOnce sleeps until
+    // the hub delivers a burst
+    ALooper* threadLooper = ALooper_prepare(ALOOPER_PREPARE_ALLOW_NON_CALLBACKS);
+    ASensorEventQueue* queue = threadLooper
+        ? ASensorManager_createEventQueue(sensorManager, threadLooper, SENSOR_DRAIN_IDENT, nullptr, nullptr)
+        : nullptr;
+    if (!queue) {
+        LOGE("Drain thread: no looper / event queue!");
+        drainSetupDone(-1);
+        return nullptr;
+    }
+
+    if (ASensorEventQueue_registerSensor(queue, accelerometer, drainAccelPeriodUs, drainLatencyUs) < 0 ||
+        ASensorEventQueue_registerSensor(queue, gyroscope, drainGyroPeriodUs, drainLatencyUs) < 0) {
+        LOGE("registerSensor failed (period %d / %d μs, latency %lld μs)",
+             drainAccelPeriodUs, drainGyroPeriodUs, (long long)drainLatencyUs);
+        ASensorEventQueue_disableSensor(queue, accelerometer);
+        ASensorManager_destroyEventQueue(sensorManager, queue);
+        drainSetupDone(-1);
+        return nullptr;
+    }
+    if (magnetometer) {
+        ASensorEventQueue_registerSensor(queue, magnetometer, SENSOR_MAG_PERIOD_US, drainLatencyUs);
+    }
+
+    ALooper_acquire(threadLooper);
+    drainLooper = threadLooper;
+    drainSetupDone(1);
+
+    ASensorEvent events[IMU_RING_MAX_BURST];
+    ImuSample samples[IMU_RING_MAX_BURST];
+
+    while (!drainStopRequested.load(std::memory_order_relaxed)) {
+        ALooper_pollOnce(SENSOR_DRAIN_TIMEOUT_MS, nullptr, nullptr, nullptr);
+
+        // Whole burst in as few getEvents calls as the FIFO needs
+        int drained = 0;
+        int n;
+        while ((n = ASensorEventQueue_getEvents(queue, events, IMU_RING_MAX_BURST)) > 0) {
+            int kept = 0;
+            for (int i = 0; i < n; i++) {
+                if (toSample(events[i], &samples[kept])) kept++;
+            }
+            imuRingPush(samples, kept);
+            drained += kept;
+        }
+        imuRingNoteDrain(drained, threadCpuNs() - cpuStartNs);
+    }
+
+    ASensorEventQueue_disableSensor(queue, accelerometer);
+    ASensorEventQueue_disableSensor(queue, gyroscope);
+    if (magnetometer) ASensorEventQueue_disableSensor(queue, magnetometer);
+    ASensorManager_destroyEventQueue(sensorManager, queue);
+    return nullptr;
+}
+
+/**
+ * Start sensors on the drain thread through the hub FIFO
+ * usDelay: sampling period in microseconds (0 = FASTEST)
+ * profile: SENSOR_PROFILE_LOW_LATENCY / SENSOR_PROFILE_BATCHED
+ * maxBatchLatencyUs: batched profile only (0 = SENSOR_BATCH_DEFAULT_LATENCY_US)
+ */
+extern "C" int startSensorsBatched(int usDelay, int profile, int64_t maxBatchLatencyUs) {
+    if (!sensorsInitialized) {
+        LOGE("Sensors not initialized!");
+        return -1;
+    }
+    stopSensors();
+
+    drainProfile = profile == SENSOR_PROFILE_BATCHED ? SENSOR_PROFILE_BATCHED : SENSOR_PROFILE_LOW_LATENCY;
+    drainAccelPeriodUs = usDelay > 0 ? usDelay : ASensor_getMinDelay(accelerometer);
+    drainGyroPeriodUs = usDelay > 0 ? usDelay : ASensor_getMinDelay(gyroscope);
+    drainLatencyUs = 0;
+    if (drainProfile == SENSOR_PROFILE_BATCHED) {
+        drainLatencyUs = maxBatchLatencyUs > 0 ? maxBatchLatencyUs : SENSOR_BATCH_DEFAULT_LATENCY_US;
+    }
+
+    // No FIFO: the hub reports continuously whatever latency is asked for
+    int accelFifo = ASensor_getFifoMaxEventCount(accelerometer);
+    int gyroFifo = ASensor_getFifoMaxEventCount(gyroscope);
+    if (drainLatencyUs > 0 && (accelFifo == 0 || gyroFifo == 0)) {
+        LOGI("No hardware FIFO (accel %d, gyro %d events): batching has no effect", accelFifo, gyroFifo);
+    }
+
+    imuRingReset();
+    drainStopRequested = false;
+    drainSetupResult = 0;
+
+    if (pthread_create(&drainThread, nullptr, drainLoop, nullptr) != 0) {
+        LOGE("Failed to start the drain thread!");
+        return -1;
+    }
+
+    pthread_mutex_lock(&drainSetupLock);
+    while (drainSetupResult == 0) pthread_cond_wait(&drainSetupCond, &drainSetupLock);
+    int result = drainSetupResult;
+    pthread_mutex_unlock(&drainSetupLock);
+
+    if (result < 0) {
+        pthread_join(drainThread, nullptr);
+        return -1;
+    }
+    drainStarted = true;
+
+    LOGI("Sensors batched (%s): Accel %d μs, Gyro %d μs, latency %lld μs, FIFO %d / %d events",
+         drainProfile == SENSOR_PROFILE_BATCHED ? "batched" : "low latency",
+         drainAccelPeriodUs, drainGyroPeriodUs, (long long)drainLatencyUs, accelFifo, gyroFifo);
+    return 0;
+}
+
+static void stopDrainThread() {
+    if (!drainStarted) return;
+
+    drainStopRequested = true;
+    ALooper_wake(drainLooper);
+    pthread_join(drainThread, nullptr);
+    ALooper_release(drainLooper);
+    drainLooper = nullptr;
+    drainStarted = false;
+
+    ImuRingStats s;
+    imuRingGetStats(&s);
+    LOGI("Drain thread stopped (%s): %llu samples in %llu drains (max burst %u), cpu %.1f μs / 1000 samples",
+         drainProfile == SENSOR_PROFILE_BATCHED ? "batched" : "low latency",
+         (unsigned long long)s.pushed, (unsigned long long)s.drains, s.maxBurst, imuRingCpuUsPer1000(&s));
+}
+
+/**
+ * Batched drain stats (14 values, kept after stop until the
+ * next start): profile, latencyUs, accel / gyro periodUs, accel / gyro FIFO
+ * size, samples, dropped, drains, empty wakeups, max burst, ring high-water,
+ * drain thread CPU ns, sample timestamp span ns
+ */
+extern "C" void getSensorBatchStats(int64_t* out) {
+    ImuRingStats s;
+    imuRingGetStats(&s);
+    out[0] = drainProfile;
+    out[1] = drainLatencyUs;
+    out[2] = drainAccelPeriodUs;
+    out[3] = drainGyroPeriodUs;
+    out[4] = accelerometer ? ASensor_getFifoMaxEventCount(accelerometer) : 0;
+    out[5] = gyroscope ? ASensor_getFifoMaxEventCount(gyroscope) : 0;
+    out[6] = (int64_t)s.pushed;
+    out[7] = (int64_t)s.dropped;
+    out[8] = (int64_t)s.drains;
+    out[9] = (int64_t)s.emptyWakeups;
+    out[10] = s.maxBurst;
+    out[11] = s.highWater;
+    out[12] = s.cpuNs;
+    out[13] = s.spanNs;
+}
+
 /**
  * Poll sensors and get latest data
  * Returns: Number of events processed
@@ -140,46 +405,30 @@ extern "C" int pollSensors(float* accel, float* gyro, float* mag, float* rate) {
         return -1;
     }
     
-    ASensorEvent events[100];
-    int eventCount = 0;
     int totalEvents = 0;
     
-    // Poll all available events
-    while ((eventCount = ASensorEventQueue_getEvents(eventQueue, events, 100)) > 0) {
-        for (int i = 0; i < eventCount; i++) {
-            switch (events[i].type) {
-                case ASENSOR_TYPE_ACCELEROMETER:
-                    latestData.accel[0] = events[i].acceleration.x;
-                    latestData.accel[1] = events[i].acceleration.y;
-                    latestData.accel[2] = events[i].acceleration.z;
-                    break;
-                    
-                case ASENSOR_TYPE_GYROSCOPE:
-                    latestData.gyro[0] = events[i].uncalibrated_gyro.x_uncalib;
-                    latestData.gyro[1] = events[i].uncalibrated_gyro.y_uncalib;
-                    latestData.gyro[2] = events[i].uncalibrated_gyro.z_uncalib;
-                    latestData.timestamp = events[i].timestamp;
-                    
-                    // Calculate actual sample rate
-                    if (lastGyroTimestamp > 0) {
-                        int64_t deltaT = events[i].timestamp - lastGyroTimestamp;
-                        if (deltaT > 0) {
-                            float instantRate = 1000000000.0f / deltaT;
-                            measuredGyroRate = measuredGyroRate * 0.9f + instantRate * 0.1f;
-                        }
-                    }
-                    lastGyroTimestamp = events[i].timestamp;
-                    gyroSampleCount++;
-                    break;
-                    
-                case ASENSOR_TYPE_MAGNETIC_FIELD:
-                    latestData.mag[0] = events[i].magnetic.x;
-                    latestData.mag[1] = events[i].magnetic.y;
-                    latestData.mag[2] = events[i].magnetic.z;
-                    break;
+    if (drainStarted) {
+        // Batched: everything the drain thread pushed since the last poll
+        ImuSample samples[IMU_RING_MAX_BURST];
+        int n;
+        while ((n = imuRingRead(samples, IMU_RING_MAX_BURST)) > 0) {
+            for (int i = 0; i < n; i++) {
+                applySample(samples[i].type, samples[i].timestampNs, samples[i].v);
+            }
+            totalEvents += n;
+        }
+    } else {
+        ASensorEvent events[100];
+        int eventCount = 0;
+        
+        // Poll all available events
+        while ((eventCount = ASensorEventQueue_getEvents(eventQueue, events, 100)) > 0) {
+            for (int i = 0; i < eventCount; i++) {
+                ImuSample s;
+                if (toSample(events[i], &s)) applySample(s.type, s.timestampNs, s.v);
             }
+            totalEvents += eventCount;
         }
-        totalEvents += eventCount;
     }
     
     // Copy data to output
@@ -203,6 +452,7 @@ extern "C" int pollSensors(float* accel, float* gyro, float* mag, float* rate) {
  * Stop sensors
  */
 extern "C" void stopSensors() {
+    stopDrainThread();
     if (eventQueue) {
         if (accelerometer) ASensorEventQueue_disableSensor(eventQueue, accelerometer);
         if (gyroscope) ASensorEventQueue_disableSensor(eventQueue, gyroscope);
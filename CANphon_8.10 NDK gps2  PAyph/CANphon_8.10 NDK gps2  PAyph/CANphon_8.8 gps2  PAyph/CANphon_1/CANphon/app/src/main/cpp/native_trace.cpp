@@ -0,0 +1,396 @@
+/**
+ * native_trace.cpp
+ * Timeline Tracing (C++)
+ *
+ * A thread gets a ring the first time it records; only that thread
+ * writes it (event, then head with release). Zones are stored once, at
+ * end, as a complete event (start + duration), so a wrapped ring never
+ * holds half a zone. traceStart bumps a generation and each thread
+ * resets its own ring on its next event, so no ring is ever cleared
+ * under its writer.
+ */
+
+#define LOG_TAG "NativeTrace"
+#include "native_trace.h"
+#include "native_log.h"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+#include <android/trace.h>
+#include <dlfcn.h>
+#endif
+
+enum EventKind : uint32_t {
+    EVENT_ZONE = 0,         // ns = start, value = duration
+    EVENT_COUNTER,
+    EVENT_FLOW_BEGIN,       // value = flow id
+    EVENT_FLOW_END,
+    EVENT_INSTANT
+};
+
+struct Event {
+    int64_t ns;
+    int64_t value;
+    const char* name;
+    uint32_t kind;
+    uint32_t reserved;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Trace State
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct ThreadRing {
+    Event* events;
+    uint64_t mask;
+    std::atomic<uint64_t> head;         // Events ever written this generation
+    std::atomic<uint64_t> generation;
+    std::atomic<bool> ownerAlive;
+    int tid;
+    char name[32];
+};
+
+struct OpenZone {
+    const char* name;
+    int64_t startNs;        // 0 = not recording when it began
+    bool atrace;
+};
+
+struct ThreadState {
+    ThreadRing* ring = nullptr;
+    OpenZone stack[TRACE_MAX_DEPTH];
+    int depth = 0;                      // May exceed TRACE_MAX_DEPTH (those zones are dropped)
+    char pendingName[32] = {0};
+    ~ThreadState() {
+        if (ring != nullptr) ring->ownerAlive.store(false, std::memory_order_release);
+    }
+};
+
+#ifdef __ANDROID__
+std::atomic<bool> traceActive{true};    // ATrace may be switched on at any time
+#else
+std::atomic<bool> traceActive{false};
+#endif
+
+static std::atomic<bool> recording{false};
+static std::atomic<uint64_t> generation{0};
+static std::atomic<uint64_t> dropped{0};
+static ThreadRing rings[TRACE_MAX_THREADS];
+static std::atomic<int> ringCount{0};
+static uint64_t ringEvents = 0;         // Fixed by the first traceStart
+static thread_local ThreadState self;
+
+static char names[TRACE_MAX_NAMES][48];
+static std::atomic<int> nameCount{0};
+
+// Serializes start / stop / ring claims / interning / export
+static std::mutex controlLock;
+
+static int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// ATrace (API 23 sections; counters and async sections are API 29)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifdef __ANDROID__
+typedef void (*ATraceCounterFn)(const char*, int64_t);
+typedef void (*ATraceAsyncFn)(const char*, int32_t);
+
+static ATraceCounterFn atraceSetCounter = nullptr;
+static ATraceAsyncFn atraceBeginAsync = nullptr;
+static ATraceAsyncFn atraceEndAsync = nullptr;
+static std::once_flag atraceOnce;
+
+static bool atraceOn() {
+    std::call_once(atraceOnce, [] {
+        void* lib = dlopen("libandroid.so", RTLD_NOW | RTLD_NOLOAD);
+        if (lib == nullptr) return;
+        atraceSetCounter = (ATraceCounterFn)dlsym(lib, "ATrace_setCounter");
+        atraceBeginAsync = (ATraceAsyncFn)dlsym(lib, "ATrace_beginAsyncSection");
+        atraceEndAsync = (ATraceAsyncFn)dlsym(lib, "ATrace_endAsyncSection");
+    });
+    return ATrace_isEnabled();
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Recording
+// ═══════════════════════════════════════════════════════════════════════════
+
+static ThreadRing* claimRing() {
+    std::lock_guard<std::mutex> guard(controlLock);
+    if (!recording.load(std::memory_order_relaxed)) return nullptr;
+    uint64_t current = generation.load(std::memory_order_relaxed);
+    ThreadRing* ring = nullptr;
+    int count = ringCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count && ring == nullptr; i++) {
+        // Reuse rings of exited threads once their events are from an older session
+        if (!rings[i].ownerAlive.load(std::memory_order_acquire) &&
+            rings[i].generation.load(std::memory_order_relaxed) != current) {
+            ring = &rings[i];
+        }
+    }
+    if (ring == nullptr) {
+        if (count == TRACE_MAX_THREADS) return nullptr;
+        ring = &rings[count];
+        ring->events = new (std::nothrow) Event[ringEvents];
+        if (ring->events == nullptr) return nullptr;
+        ring->mask = ringEvents - 1;
+        ringCount.store(count + 1, std::memory_order_release);
+    }
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->generation.store(current, std::memory_order_relaxed);
+    ring->ownerAlive.store(true, std::memory_order_relaxed);
+    ring->tid = (int)syscall(SYS_gettid);
+    if (self.pendingName[0] != 0) {
+        memcpy(ring->name, self.pendingName, sizeof(ring->name));
+    } else if (pthread_getname_np(pthread_self(), ring->name, sizeof(ring->name)) != 0) {
+        snprintf(ring->name, sizeof(ring->name), "thread %d", ring->tid);
+    }
+    return ring;
+}
+
+static void record(uint32_t kind, const char* name, int64_t ns, int64_t value) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+    ThreadRing* ring = self.ring;
+    uint64_t current = generation.load(std::memory_order_acquire);
+    if (ring == nullptr) {
+        ring = self.ring = claimRing();
+        if (ring == nullptr) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } else if (ring->generation.load(std::memory_order_relaxed) != current) {
+        ring->head.store(0, std::memory_order_relaxed);
+        ring->generation.store(current, std::memory_order_relaxed);
+    }
+    uint64_t h = ring->head.load(std::memory_order_relaxed);
+    Event& e = ring->events[h & ring->mask];
+    e.ns = ns;
+    e.value = value;
+    e.name = name;
+    e.kind = kind;
+    ring->head.store(h + 1, std::memory_order_release);
+}
+
+extern "C" void traceBegin(const char* name) {
+    int depth = self.depth++;
+    if (depth >= TRACE_MAX_DEPTH) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    OpenZone& z = self.stack[depth];
+    z.name = name;
+    z.startNs = recording.load(std::memory_order_relaxed) ? monotonicNs() : 0;
+    z.atrace = false;
+#ifdef __ANDROID__
+    if (atraceOn()) {
+        ATrace_beginSection(name);
+        z.atrace = true;
+    }
+#endif
+}
+
+extern "C" void traceEnd() {
+    if (self.depth == 0) return;
+    int depth = --self.depth;
+    if (depth >= TRACE_MAX_DEPTH) return;
+    const OpenZone& z = self.stack[depth];
+#ifdef __ANDROID__
+    if (z.atrace) ATrace_endSection();
+#endif
+    if (z.startNs != 0) record(EVENT_ZONE, z.name, z.startNs, monotonicNs() - z.startNs);
+}
+
+extern "C" void traceCounter(const char* name, int64_t value) {
+#ifdef __ANDROID__
+    if (atraceOn() && atraceSetCounter != nullptr) atraceSetCounter(name, value);
+#endif
+    record(EVENT_COUNTER, name, monotonicNs(), value);
+}
+
+extern "C" void traceFlowBegin(const char* name, uint64_t id) {
+#ifdef __ANDROID__
+    if (atraceOn() && atraceBeginAsync != nullptr) atraceBeginAsync(name, (int32_t)id);
+#endif
+    record(EVENT_FLOW_BEGIN, name, monotonicNs(), (int64_t)id);
+}
+
+extern "C" void traceFlowEnd(const char* name, uint64_t id) {
+#ifdef __ANDROID__
+    if (atraceOn() && atraceEndAsync != nullptr) atraceEndAsync(name, (int32_t)id);
+#endif
+    record(EVENT_FLOW_END, name, monotonicNs(), (int64_t)id);
+}
+
+extern "C" void traceInstant(const char* name) {
+#ifdef __ANDROID__
+    if (atraceOn()) {
+        ATrace_beginSection(name);
+        ATrace_endSection();
+    }
+#endif
+    record(EVENT_INSTANT, name, monotonicNs(), 0);
+}
+
+extern "C" void traceSetThreadName(const char* name) {
+    strncpy(self.pendingName, name, sizeof(self.pendingName) - 1);
+    self.pendingName[sizeof(self.pendingName) - 1] = 0;
+    if (self.ring != nullptr) {
+        std::lock_guard<std::mutex> guard(controlLock);
+        memcpy(self.ring->name, self.pendingName, sizeof(self.ring->name));
+    }
+}
+
+extern "C" int traceInternName(const char* name) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    int count = nameCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (strncmp(names[i], name, sizeof(names[i]) - 1) == 0) return i;
+    }
+    if (count == TRACE_MAX_NAMES) return -1;
+    strncpy(names[count], name, sizeof(names[count]) - 1);
+    names[count][sizeof(names[count]) - 1] = 0;
+    nameCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+extern "C" const char* traceNameAt(int index) {
+    if (index < 0 || index >= nameCount.load(std::memory_order_acquire)) return "?";
+    return names[index];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void traceStart(int eventsPerThread) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    if (ringEvents == 0) {
+        if (eventsPerThread <= 0) eventsPerThread = TRACE_DEFAULT_EVENTS;
+        ringEvents = 64;
+        while (ringEvents < (uint64_t)eventsPerThread) ringEvents <<= 1;
+    } else if (eventsPerThread > 0 && (uint64_t)eventsPerThread > ringEvents) {
+        LOGW("Trace rings stay at %llu events per thread", (unsigned long long)ringEvents);
+    }
+    generation.fetch_add(1, std::memory_order_release);
+    dropped.store(0, std::memory_order_relaxed);
+    recording.store(true, std::memory_order_release);
+    traceActive.store(true, std::memory_order_relaxed);
+    LOGI("✅ Tracing: %llu events per thread", (unsigned long long)ringEvents);
+}
+
+extern "C" void traceStop() {
+    std::lock_guard<std::mutex> guard(controlLock);
+    recording.store(false, std::memory_order_release);
+#ifndef __ANDROID__
+    traceActive.store(false, std::memory_order_relaxed);
+#endif
+}
+
+extern "C" void traceGetStats(TraceStats* outStats) {
+    memset(outStats, 0, sizeof(*outStats));
+    uint64_t current = generation.load(std::memory_order_acquire);
+    int count = ringCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        const ThreadRing& r = rings[i];
+        if (r.generation.load(std::memory_order_relaxed) != current) continue;
+        uint64_t h = r.head.load(std::memory_order_acquire);
+        outStats->events += h;
+        if (h > r.mask + 1) outStats->overwritten += h - (r.mask + 1);
+        outStats->threads++;
+    }
+    outStats->dropped = dropped.load(std::memory_order_relaxed);
+    outStats->recording = recording.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Chrome Trace-Event JSON
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void writeName(FILE* f, const char* s) {
+    fputc('"', f);
+    for (; *s != 0; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+extern "C" int traceWriteChrome(const char* path) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) {
+        LOGW("Trace: cannot create %s", path);
+        return -1;
+    }
+
+    int pid = (int)getpid();
+    uint64_t current = generation.load(std::memory_order_acquire);
+    int count = ringCount.load(std::memory_order_acquire);
+
+    // Timestamps relative to the first event kept, in microseconds
+    int64_t originNs = INT64_MAX;
+    for (int i = 0; i < count; i++) {
+        const ThreadRing& r = rings[i];
+        if (r.generation.load(std::memory_order_relaxed) != current) continue;
+        uint64_t h = r.head.load(std::memory_order_acquire);
+        for (uint64_t k = h > r.mask + 1 ? h - (r.mask + 1) : 0; k < h; k++) {
+            if (r.events[k & r.mask].ns < originNs) originNs = r.events[k & r.mask].ns;
+        }
+    }
+
+    int written = 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"args\":{\"name\":\"canphon\"}}", pid);
+    for (int i = 0; i < count; i++) {
+        const ThreadRing& r = rings[i];
+        if (r.generation.load(std::memory_order_relaxed) != current) continue;
+        fprintf(f, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", pid, r.tid);
+        writeName(f, r.name);
+        fprintf(f, "}}");
+
+        uint64_t h = r.head.load(std::memory_order_acquire);
+        for (uint64_t k = h > r.mask + 1 ? h - (r.mask + 1) : 0; k < h; k++) {
+            const Event& e = r.events[k & r.mask];
+            double ts = (double)(e.ns - originNs) / 1000.0;
+            fprintf(f, ",\n{\"name\":");
+            writeName(f, e.name);
+            switch (e.kind) {
+            case EVENT_ZONE:
+                fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", ts, (double)e.value / 1000.0);
+                break;
+            case EVENT_COUNTER:
+                fprintf(f, ",\"ph\":\"C\",\"ts\":%.3f,\"args\":{\"value\":%lld}", ts, (long long)e.value);
+                break;
+            case EVENT_FLOW_BEGIN:
+                fprintf(f, ",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%llu,\"ts\":%.3f", (unsigned long long)e.value, ts);
+                break;
+            case EVENT_FLOW_END:
+                fprintf(f, ",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,\"ts\":%.3f",
+                        (unsigned long long)e.value, ts);
+                break;
+            default:
+                fprintf(f, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", ts);
+                break;
+            }
+            fprintf(f, ",\"pid\":%d,\"tid\":%d}", pid, r.tid);
+            written++;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    LOGI("Trace: %d events -> %s", written, path);
+    return written;
+}
@@ -0,0 +1,93 @@
+/**
+ * native_trace.h
+ * Timeline Tracing (C++)
+ *
+ * Zones (nested begin / end on one thread), counters and flows (an arrow
+ * from where something is produced to where it is consumed, on another
+ * thread). Each thread records into its own ring with no locks; the rings
+ * are written out as Chrome trace-event JSON (chrome://tracing, Perfetto
+ * UI). On Android every event also goes to ATrace while a system trace
+ * (Perfetto / systrace) is capturing.
+ *
+ * Names must be string literals or come from traceInternName.
+ */
+
+#ifndef NATIVE_TRACE_H
+#define NATIVE_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_DEFAULT_EVENTS 8192           // Per thread (32 B each), oldest overwritten
+#define TRACE_MAX_THREADS 64
+#define TRACE_MAX_DEPTH 32                  // Open zones per thread
+#define TRACE_MAX_NAMES 256                 // traceInternName table
+
+typedef struct {
+    uint64_t events;        // Recorded since traceStart
+    uint64_t overwritten;   // Lost to ring wrap (oldest first)
+    uint64_t dropped;       // No buffer (thread limit) or zone stack full
+    int32_t threads;
+    int32_t recording;
+} TraceStats;
+
+// Record from now on into fresh per-thread rings of eventsPerThread (0 = default)
+void traceStart(int eventsPerThread);
+
+// Stop recording (rings are kept for traceWriteChrome)
+void traceStop();
+
+void traceGetStats(TraceStats* outStats);
+
+// Write what the rings hold as Chrome trace-event JSON. Call after
+// traceStop. Returns events written, -1 if the file cannot be created
+int traceWriteChrome(const char* path);
+
+// Stable copy of a runtime name (JNI strings). Returns its index, -1 if full
+int traceInternName(const char* name);
+const char* traceNameAt(int index);
+
+// Thread name in the export (default: the pthread name when first seen)
+void traceSetThreadName(const char* name);
+
+void traceBegin(const char* name);
+void traceEnd();
+void traceCounter(const char* name, int64_t value);
+void traceFlowBegin(const char* name, uint64_t id);     // Inside a zone
+void traceFlowEnd(const char* name, uint64_t id);       // Inside a zone, same name and id
+void traceInstant(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Fast path: nothing past this load unless recording or a system trace is on
+extern std::atomic<bool> traceActive;
+
+struct TraceZone {
+    bool open;
+    explicit TraceZone(const char* name) : open(traceActive.load(std::memory_order_relaxed)) {
+        if (open) traceBegin(name);
+    }
+    ~TraceZone() {
+        if (open) traceEnd();
+    }
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) \
+    do { if (traceActive.load(std::memory_order_relaxed)) traceCounter(name, (int64_t)(value)); } while (0)
+#define TRACE_FLOW_BEGIN(name, id) \
+    do { if (traceActive.load(std::memory_order_relaxed)) traceFlowBegin(name, (uint64_t)(id)); } while (0)
+#define TRACE_FLOW_END(name, id) \
+    do { if (traceActive.load(std::memory_order_relaxed)) traceFlowEnd(name, (uint64_t)(id)); } while (0)
+
+#endif // NATIVE_TRACE_H
@@ -8,6 +8,7 @@
 
 #include "object_tracker.h"
 #include "target_discriminator.h"
+#include "param_store.h"
 #include <cmath>
 #include <cstring>
 #include <android/log.h>
@@ -120,7 +121,8 @@ extern "C" void trackerStartTracking(int x, int y, int w, int h) {
     tracker.confidence = 1.0f;
     
     // Initialize Kalman filter with initial position
-    kalmanInit((double)x, (double)y, 300.0, 1.0);
+    kalmanInit((double)x, (double)y, paramGetFloat(PARAM_KALMAN_PROCESS_NOISE),
+               paramGetFloat(PARAM_KALMAN_MEASUREMENT_NOISE));
     
     LOGI("✅ Started tracking: (%d, %d) size %dx%d", x, y, w, h);
 }
@@ -192,11 +194,19 @@ extern "C" void trackerProcessDetections(int* rects, int count) {
                 }
             }
             
-            // Add new object if not matched
-            if (!matched && tracker.objectCount < MAX_TRACKED_OBJECTS) {
-                TrackedObject* obj = &tracker.objects[tracker.objectCount++];
+            // Add new object if not matched, in the slot of a dropped one
+            // first (otherwise the table fills up for good)
+            int slot = -1;
+            if (!matched) {
+                for (int j = 0; j < tracker.objectCount && slot < 0; j++) {
+                    if (tracker.objects[j].historyCount == 0) slot = j;
+                }
+                if (slot < 0 && tracker.objectCount < MAX_TRACKED_OBJECTS) slot = tracker.objectCount++;
+            }
+            if (slot >= 0) {
+                TrackedObject* obj = &tracker.objects[slot];
                 memset(obj, 0, sizeof(TrackedObject));
-                obj->id = tracker.objectCount;
+                obj->id = slot + 1;
                 obj->current.x = x;
                 obj->current.y = y;
                 obj->current.w = w;
@@ -209,6 +219,7 @@ extern "C" void trackerProcessDetections(int* rects, int count) {
     }
     
     // Mark lost objects
+    int lostLimit = paramGetInt(PARAM_TRACKER_LOST_LIMIT);
     for (int i = 0; i < tracker.objectCount; i++) {
         ObjectState* last = (tracker.objects[i].historyCount > 0) ?
                             &tracker.objects[i].history[tracker.objects[i].historyCount - 1] : NULL;
@@ -217,7 +228,7 @@ extern "C" void trackerProcessDetections(int* rects, int count) {
                 last->status = 0;  // close
             } else {
                 last->lostCount++;
-                if (last->lostCount > 6) {
+                if (last->lostCount > lostLimit) {
                     // Remove object
                     tracker.objects[i].historyCount = 0;
                 }
@@ -256,7 +267,7 @@ extern "C" int trackerUpdate(int* detectedRects, int detectedCount,
         }
         
         double uncertainty = kalmanGetUncertainty();
-        if (uncertainty < 200.0) {
+        if (uncertainty < paramGetFloat(PARAM_TRACKER_PREDICT_UNCERTAINTY)) {
             *outX = tracker.predictedX;
             *outY = tracker.predictedY;
             *outW = tracker.lastW;
@@ -271,7 +282,7 @@ extern "C" int trackerUpdate(int* detectedRects, int detectedCount,
     
     // 3. Find closest detection to prediction
     float searchRadius = (float)fmax(tracker.imageWidth / 2, tracker.imageHeight / 2);
-    searchRadius = fmax(searchRadius, 500.0f);
+    searchRadius = fmax(searchRadius, paramGetFloat(PARAM_TRACKER_SEARCH_RADIUS));
     
     int bestIdx = -1;
     float bestDist = searchRadius;
@@ -427,11 +438,12 @@ extern "C" void trackerEnablePrediction(int enable) {
 }
 
 extern "C" int trackerGetAllObjects(ObjectState* objects, int maxCount) {
+    int showLost = paramGetInt(PARAM_TRACKER_SHOW_LOST);
     int count = 0;
     for (int i = 0; i < tracker.objectCount && count < maxCount; i++) {
         if (tracker.objects[i].historyCount > 0) {
             ObjectState* last = &tracker.objects[i].history[tracker.objects[i].historyCount - 1];
-            if (last->status == 1 || last->lostCount < 3) {
+            if (last->status == 1 || last->lostCount < showLost) {
                 objects[count++] = *last;
             }
         }
@@ -0,0 +1,393 @@
+/**
+ * param_store.cpp
+ * Runtime Parameter Store (C++)
+ *
+ * Snapshots live in a small fixed pool with a pin count each. A reader
+ * bumps the count of the slot `current` names and re-checks `current`;
+ * if it moved meanwhile the pin is dropped and retried. A writer fills a
+ * slot that is neither current nor pinned, then stores `current`. Pin
+ * and check on one side, store and count check on the other are all
+ * sequentially consistent, so a writer never refills a slot a reader
+ * got through the check with (the grace period is the pin count).
+ */
+
+#define LOG_TAG "NativeParams"
+#include "param_store.h"
+#include "native_log.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+#define PARAM_FILE_MAGIC 0x4D525043u        // "CPRM"
+#define PARAM_FILE_VERSION 1
+#define PARAM_FILE_MAX_BYTES 4096
+
+static_assert(PARAM_COUNT <= 64, "changed masks are 64-bit");
+
+// Writer retries before giving up on a fully pinned pool
+static const int SLOT_RETRIES = 1000;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Registry
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const ParamInfo PARAMS[PARAM_COUNT] = {
+    {"guidance.alpha", PARAM_TYPE_FLOAT, 0.6f, 0.01f, 1.0f},
+    {"guidance.cmdMax", PARAM_TYPE_FLOAT, 25.0f, 1.0f, 45.0f},
+    {"pid.kp", PARAM_TYPE_FLOAT, 0.5f, 0.0f, 20.0f},
+    {"pid.ki", PARAM_TYPE_FLOAT, 0.0f, 0.0f, 20.0f},
+    {"pid.kd", PARAM_TYPE_FLOAT, 0.1f, 0.0f, 20.0f},
+    {"pid.alpha", PARAM_TYPE_FLOAT, 0.6f, 0.01f, 1.0f},
+    {"fusion.alpha", PARAM_TYPE_FLOAT, 0.98f, 0.0f, 1.0f},
+    {"kalman.processNoise", PARAM_TYPE_FLOAT, 300.0f, 0.001f, 100000.0f},
+    {"kalman.measurementNoise", PARAM_TYPE_FLOAT, 1.0f, 0.001f, 100000.0f},
+    {"disc.minSize", PARAM_TYPE_INT, 20, 1, 4096},
+    {"disc.maxSize", PARAM_TYPE_INT, 500, 2, 8192},
+    {"disc.minAspect", PARAM_TYPE_FLOAT, 0.3f, 0.01f, 100.0f},
+    {"disc.maxAspect", PARAM_TYPE_FLOAT, 3.0f, 0.01f, 100.0f},
+    {"disc.stabilityFrames", PARAM_TYPE_INT, 3, 1, 5},
+    {"tracker.searchRadius", PARAM_TYPE_FLOAT, 500.0f, 1.0f, 10000.0f},
+    {"tracker.lostLimit", PARAM_TYPE_INT, 6, 0, 1000},
+    {"tracker.showLost", PARAM_TYPE_INT, 3, 0, 1000},
+    {"tracker.predictUncertainty", PARAM_TYPE_FLOAT, 200.0f, 0.0f, 100000.0f},
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Snapshot Pool
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct alignas(64) Slot {
+    std::atomic<int32_t> pins;
+    ParamSnapshot snapshot;
+};
+
+struct Listener {
+    ParamListener fn;
+    void* user;
+};
+
+static Slot slots[PARAM_SNAPSHOT_SLOTS];
+static std::atomic<int> current{0};
+static std::atomic<uint32_t> generation{1};     // Of `current`, for cheap polling
+
+static std::atomic<uint64_t> swaps{0};
+static std::atomic<uint64_t> rejected{0};
+static std::atomic<uint64_t> slotWaits{0};
+
+// Serializes changes, save / load and listeners (never taken by readers)
+static std::mutex controlLock;
+static Listener listeners[PARAM_MAX_LISTENERS];
+
+static ParamValue defaultValue(int id) {
+    ParamValue v;
+    if (PARAMS[id].type == PARAM_TYPE_INT) v.i = (int32_t)PARAMS[id].defaultValue;
+    else v.f = PARAMS[id].defaultValue;
+    return v;
+}
+
+// Slot 0 holds the defaults before anything can read
+[[maybe_unused]] static const bool defaultsReady = [] {
+    slots[0].snapshot.generation = 1;
+    for (int id = 0; id < PARAM_COUNT; id++) slots[0].snapshot.values[id] = defaultValue(id);
+    return true;
+}();
+
+static bool sameValue(ParamValue a, ParamValue b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Exponent bits, not std::isfinite: the app builds with -ffast-math, which
+// lets the compiler assume NaN / Inf never occur and fold that check away
+static bool finiteBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x7F800000u) != 0x7F800000u;
+}
+
+// Float → typed value within range (int parameters round)
+static bool toValue(int id, float value, ParamValue* out) {
+    const ParamInfo& p = PARAMS[id];
+    if (!finiteBits(value)) return false;
+    if (p.type == PARAM_TYPE_INT) value = roundf(value);
+    if (value < p.minValue || value > p.maxValue) return false;
+    if (p.type == PARAM_TYPE_INT) out->i = (int32_t)value;
+    else out->f = value;
+    return true;
+}
+
+static bool validValue(int id, ParamValue v) {
+    const ParamInfo& p = PARAMS[id];
+    float value = (p.type == PARAM_TYPE_INT) ? (float)v.i : v.f;
+    return finiteBits(value) && value >= p.minValue && value <= p.maxValue;
+}
+
+// Publish `values` as the next generation. controlLock held
+static int publishLocked(const ParamValue* values, uint64_t changedMask) {
+    int cur = current.load(std::memory_order_relaxed);
+    if (changedMask == 0) return (int)slots[cur].snapshot.generation;
+
+    int next = -1;
+    for (int attempt = 0; attempt < SLOT_RETRIES && next < 0; attempt++) {
+        for (int s = 0; s < PARAM_SNAPSHOT_SLOTS; s++) {
+            if (s != cur && slots[s].pins.load(std::memory_order_seq_cst) == 0) {
+                next = s;
+                break;
+            }
+        }
+        if (next < 0) {
+            slotWaits.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+    if (next < 0) {
+        LOGW("⚠️ Every parameter snapshot pinned, change dropped");
+        return -1;
+    }
+
+    ParamSnapshot* snapshot = &slots[next].snapshot;
+    memcpy(snapshot->values, values, sizeof(snapshot->values));
+    snapshot->generation = slots[cur].snapshot.generation + 1;
+    current.store(next, std::memory_order_seq_cst);
+    generation.store(snapshot->generation, std::memory_order_release);
+    swaps.fetch_add(1, std::memory_order_relaxed);
+
+    for (int i = 0; i < PARAM_MAX_LISTENERS; i++) {
+        if (listeners[i].fn) listeners[i].fn(snapshot, changedMask, listeners[i].user);
+    }
+    return (int)snapshot->generation;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Readers
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" const ParamInfo* paramInfo(int id) {
+    return (id >= 0 && id < PARAM_COUNT) ? &PARAMS[id] : nullptr;
+}
+
+extern "C" int paramFind(const char* name) {
+    if (!name) return -1;
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        if (strcmp(PARAMS[id].name, name) == 0) return id;
+    }
+    return -1;
+}
+
+extern "C" const ParamSnapshot* paramPin() {
+    for (;;) {
+        int s = current.load(std::memory_order_seq_cst);
+        slots[s].pins.fetch_add(1, std::memory_order_seq_cst);
+        if (current.load(std::memory_order_seq_cst) == s) return &slots[s].snapshot;
+        slots[s].pins.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+extern "C" void paramUnpin(const ParamSnapshot* snapshot) {
+    if (!snapshot) return;
+    for (int s = 0; s < PARAM_SNAPSHOT_SLOTS; s++) {
+        if (&slots[s].snapshot == snapshot) {
+            slots[s].pins.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+extern "C" float paramGetFloat(int id) {
+    if (id < 0 || id >= PARAM_COUNT) return 0.0f;
+    ParamPin pin;
+    return PARAMS[id].type == PARAM_TYPE_INT ? (float)pin.i(id) : pin.f(id);
+}
+
+extern "C" int32_t paramGetInt(int id) {
+    if (id < 0 || id >= PARAM_COUNT) return 0;
+    ParamPin pin;
+    return PARAMS[id].type == PARAM_TYPE_INT ? pin.i(id) : (int32_t)lroundf(pin.f(id));
+}
+
+extern "C" uint32_t paramGeneration() {
+    return generation.load(std::memory_order_acquire);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Writers
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int paramSetMany(const int* ids, const float* values, int count) {
+    if (!ids || !values || count < 0) return -1;
+    std::lock_guard<std::mutex> lock(controlLock);
+
+    ParamValue next[PARAM_COUNT];
+    memcpy(next, slots[current.load(std::memory_order_relaxed)].snapshot.values, sizeof(next));
+    uint64_t changed = 0;
+    for (int k = 0; k < count; k++) {
+        int id = ids[k];
+        ParamValue v;
+        if (id < 0 || id >= PARAM_COUNT || !toValue(id, values[k], &v)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            LOGW("⚠️ Parameter %d = %g rejected", id, values[k]);
+            return -1;
+        }
+        if (!sameValue(next[id], v)) changed |= 1ull << id;
+        next[id] = v;
+    }
+    return publishLocked(next, changed);
+}
+
+extern "C" int paramSet(int id, float value) {
+    return paramSetMany(&id, &value, 1);
+}
+
+extern "C" int paramResetDefaults() {
+    std::lock_guard<std::mutex> lock(controlLock);
+    const ParamValue* cur = slots[current.load(std::memory_order_relaxed)].snapshot.values;
+    ParamValue next[PARAM_COUNT];
+    uint64_t changed = 0;
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        next[id] = defaultValue(id);
+        if (!sameValue(cur[id], next[id])) changed |= 1ull << id;
+    }
+    return publishLocked(next, changed);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Persistence
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Little-endian: u32 magic, u16 version, u16 count, then per parameter
+// u16 id, u16 type, u32 value bits; u32 CRC-32 of everything before.
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+static uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+extern "C" int paramSave(const char* path) {
+    if (!path) return -1;
+    std::lock_guard<std::mutex> lock(controlLock);
+    const ParamSnapshot* snapshot = &slots[current.load(std::memory_order_relaxed)].snapshot;
+
+    uint8_t buf[8 + PARAM_COUNT * 8 + 4];
+    put32(buf, PARAM_FILE_MAGIC);
+    put16(buf + 4, PARAM_FILE_VERSION);
+    put16(buf + 6, PARAM_COUNT);
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        uint8_t* e = buf + 8 + id * 8;
+        uint32_t bits;
+        memcpy(&bits, &snapshot->values[id], sizeof(bits));
+        put16(e, (uint16_t)id);
+        put16(e + 2, (uint16_t)PARAMS[id].type);
+        put32(e + 4, bits);
+    }
+    put32(buf + sizeof(buf) - 4, crc32(buf, sizeof(buf) - 4));
+
+    char tmp[512];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return -1;
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        LOGW("⚠️ Cannot create %s", tmp);
+        return -1;
+    }
+    bool ok = fwrite(buf, 1, sizeof(buf), f) == sizeof(buf) && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        LOGW("⚠️ Cannot write %s", path);
+        return -1;
+    }
+    LOGI("💾 Parameters saved (generation %u) → %s", snapshot->generation, path);
+    return PARAM_COUNT;
+}
+
+extern "C" int paramLoad(const char* path) {
+    if (!path) return -1;
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    uint8_t buf[PARAM_FILE_MAX_BYTES];
+    size_t size = fread(buf, 1, sizeof(buf), f);
+    bool truncated = !feof(f);
+    fclose(f);
+
+    if (truncated || size < 12 || get32(buf) != PARAM_FILE_MAGIC || get16(buf + 4) != PARAM_FILE_VERSION) {
+        LOGW("⚠️ %s is not a parameter file", path);
+        return -1;
+    }
+    size_t count = get16(buf + 6);
+    if (size != 8 + count * 8 + 4 || get32(buf + size - 4) != crc32(buf, size - 4)) {
+        LOGW("⚠️ %s is corrupt (size / CRC)", path);
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(controlLock);
+    ParamValue next[PARAM_COUNT];
+    memcpy(next, slots[current.load(std::memory_order_relaxed)].snapshot.values, sizeof(next));
+    uint64_t changed = 0;
+    int applied = 0;
+    for (size_t k = 0; k < count; k++) {
+        const uint8_t* e = buf + 8 + k * 8;
+        int id = get16(e);
+        uint32_t bits = get32(e + 4);
+        ParamValue v;
+        memcpy(&v, &bits, sizeof(v));
+        // Entries of other app versions (unknown id, changed type) are skipped
+        if (id >= PARAM_COUNT || get16(e + 2) != (uint16_t)PARAMS[id].type || !validValue(id, v)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (!sameValue(next[id], v)) changed |= 1ull << id;
+        next[id] = v;
+        applied++;
+    }
+    if (publishLocked(next, changed) < 0) return -1;
+    LOGI("📂 Parameters loaded: %d of %zu applied from %s", applied, count, path);
+    return applied;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Listeners / Stats
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int paramAddListener(ParamListener listener, void* user) {
+    if (!listener) return -1;
+    std::lock_guard<std::mutex> lock(controlLock);
+    for (int i = 0; i < PARAM_MAX_LISTENERS; i++) {
+        if (!listeners[i].fn) {
+            listeners[i].fn = listener;
+            listeners[i].user = user;
+            return i;
+        }
+    }
+    return -1;
+}
+
+extern "C" void paramRemoveListener(int handle) {
+    if (handle < 0 || handle >= PARAM_MAX_LISTENERS) return;
+    std::lock_guard<std::mutex> lock(controlLock);
+    listeners[handle].fn = nullptr;
+    listeners[handle].user = nullptr;
+}
+
+extern "C" void paramGetStats(ParamStats* outStats) {
+    if (!outStats) return;
+    outStats->generation = paramGeneration();
+    outStats->swaps = swaps.load(std::memory_order_relaxed);
+    outStats->rejected = rejected.load(std::memory_order_relaxed);
+    outStats->slotWaits = slotWaits.load(std::memory_order_relaxed);
+    int32_t pinned = 0;
+    for (int s = 0; s < PARAM_SNAPSHOT_SLOTS; s++) {
+        if (slots[s].pins.load(std::memory_order_relaxed) > 0) pinned++;
+    }
+    outStats->pinned = pinned;
+}
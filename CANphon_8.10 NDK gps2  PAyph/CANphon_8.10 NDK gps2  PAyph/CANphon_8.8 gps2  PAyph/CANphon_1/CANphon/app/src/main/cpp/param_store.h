@@ -0,0 +1,139 @@
+/**
+ * param_store.h
+ * Runtime Parameter Store (C++)
+ *
+ * Typed registry of the tuning values (guidance / PID gains, filter
+ * alphas, Kalman noise, discriminator and tracker limits). The current
+ * values form an immutable snapshot; a change copies it, edits the copy
+ * and swaps the pointer, RCU style. Readers pin the snapshot they see
+ * (two atomic ops, no lock, never wait for a writer) and get one
+ * consistent generation for as long as they hold it; writers reuse a
+ * snapshot only once nobody pins it.
+ *
+ * Consumers keep their filter / integrator state across changes: they
+ * compare paramGeneration() with the one they last applied and pick up
+ * the new values in place. Listeners are also called on every change.
+ *
+ * Ids are stable (the binary file stores them): append, never renumber.
+ */
+
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PARAM_GUIDANCE_ALPHA 0              // Error low-pass alpha (per 33 ms frame)
+#define PARAM_GUIDANCE_CMD_MAX 1            // Servo command limit (°)
+#define PARAM_PID_KP 2
+#define PARAM_PID_KI 3
+#define PARAM_PID_KD 4
+#define PARAM_PID_ALPHA 5                   // PID output low-pass alpha
+#define PARAM_FUSION_ALPHA 6                // IMU weight of the IMU / GPS fusion
+#define PARAM_KALMAN_PROCESS_NOISE 7
+#define PARAM_KALMAN_MEASUREMENT_NOISE 8
+#define PARAM_DISC_MIN_SIZE 9               // px (side of the smallest target)
+#define PARAM_DISC_MAX_SIZE 10              // px
+#define PARAM_DISC_MIN_ASPECT 11            // w / h
+#define PARAM_DISC_MAX_ASPECT 12
+#define PARAM_DISC_STABILITY_FRAMES 13      // History needed before scoring stability
+#define PARAM_TRACKER_SEARCH_RADIUS 14      // px, lower bound of the match radius
+#define PARAM_TRACKER_LOST_LIMIT 15         // Missed frames before an object is dropped
+#define PARAM_TRACKER_SHOW_LOST 16          // Missed frames an object is still listed
+#define PARAM_TRACKER_PREDICT_UNCERTAINTY 17 // Coast on prediction below this
+#define PARAM_COUNT 18
+
+#define PARAM_TYPE_FLOAT 0
+#define PARAM_TYPE_INT 1
+
+#define PARAM_SNAPSHOT_SLOTS 8              // Current + pinned + retired snapshots
+#define PARAM_MAX_LISTENERS 8
+
+typedef struct {
+    const char* name;
+    int32_t type;
+    float defaultValue;
+    float minValue;
+    float maxValue;
+} ParamInfo;
+
+typedef union {
+    float f;
+    int32_t i;
+} ParamValue;
+
+typedef struct {
+    uint32_t generation;
+    ParamValue values[PARAM_COUNT];
+} ParamSnapshot;
+
+typedef struct {
+    uint32_t generation;
+    uint64_t swaps;         // Snapshots published
+    uint64_t rejected;      // Unknown id, wrong type or out of range
+    uint64_t slotWaits;     // Writer found every snapshot pinned
+    int32_t pinned;         // Snapshots pinned right now
+} ParamStats;
+
+// Called on the writer's thread after the swap, in change order. Must not
+// change parameters itself
+typedef void (*ParamListener)(const ParamSnapshot* snapshot, uint64_t changedMask, void* user);
+
+// Descriptor of `id`, NULL if unknown
+const ParamInfo* paramInfo(int id);
+
+// Id of a parameter by name, -1 if unknown
+int paramFind(const char* name);
+
+// Pin the current snapshot (never NULL, never blocks). Unpin when done
+const ParamSnapshot* paramPin();
+void paramUnpin(const ParamSnapshot* snapshot);
+
+// One value from the current snapshot (pins for the read)
+float paramGetFloat(int id);
+int32_t paramGetInt(int id);
+
+// Generation of the current snapshot (starts at 1, +1 per change)
+uint32_t paramGeneration();
+
+// Change one / several values in one snapshot (all or nothing). Values of
+// int parameters are rounded. Returns the new generation, -1 if a value
+// is rejected or every snapshot stays pinned
+int paramSet(int id, float value);
+int paramSetMany(const int* ids, const float* values, int count);
+
+// Every parameter back to its default (one change)
+int paramResetDefaults();
+
+// Compact binary file: header, (id, type, value) per parameter, CRC-32.
+// Save writes a temporary file and renames it over `path`. Load applies
+// the known, valid entries as one change and returns how many, -1 if the
+// file is missing or corrupt (the values are then left alone)
+int paramSave(const char* path);
+int paramLoad(const char* path);
+
+// Returns a handle for paramRemoveListener, -1 if the table is full
+int paramAddListener(ParamListener listener, void* user);
+void paramRemoveListener(int handle);
+
+void paramGetStats(ParamStats* outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Pins the current snapshot for a scope
+struct ParamPin {
+    const ParamSnapshot* snapshot;
+    ParamPin() : snapshot(paramPin()) {}
+    ~ParamPin() { paramUnpin(snapshot); }
+    float f(int id) const { return snapshot->values[id].f; }
+    int32_t i(int id) const { return snapshot->values[id].i; }
+    ParamPin(const ParamPin&) = delete;
+    ParamPin& operator=(const ParamPin&) = delete;
+};
+
+#endif // PARAM_STORE_H
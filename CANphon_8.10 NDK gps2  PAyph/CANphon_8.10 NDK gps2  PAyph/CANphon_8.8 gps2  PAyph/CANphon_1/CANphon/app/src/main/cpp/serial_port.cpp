@@ -0,0 +1,255 @@
+/**
+ * serial_port.cpp
+ * Native Serial Port (termios + epoll)
+ */
+
+#define LOG_TAG "NativeSerial"
+#include "serial_port.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define SERIAL_MAX_IOV 64
+
+struct SerialPort {
+    int fd;
+    int ownsFd;
+    int epollFd;
+    SerialStats stats;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Open / Configure
+// ═══════════════════════════════════════════════════════════════════════════
+
+static speed_t baudToSpeed(int baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        default: return 0;
+    }
+}
+
+extern "C" int serialConfigureRaw(int fd, int baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) < 0) return -1;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;    // Non-blocking reads; waiting is done in epoll
+    tio.c_cc[VTIME] = 0;
+
+    if (baud > 0) {
+        speed_t speed = baudToSpeed(baud);
+        if (speed == 0) {
+            LOGW("Unsupported baud rate %d", baud);
+            return -1;
+        }
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+
+    if (tcsetattr(fd, TCSANOW, &tio) < 0) return -1;
+    tcflush(fd, TCIOFLUSH);
+    return 0;
+}
+
+extern "C" SerialPort* serialWrap(int fd, int ownsFd) {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) return nullptr;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(epollFd);
+        return nullptr;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    SerialPort* port = (SerialPort*)calloc(1, sizeof(SerialPort));
+    port->fd = fd;
+    port->ownsFd = ownsFd;
+    port->epollFd = epollFd;
+    return port;
+}
+
+extern "C" SerialPort* serialOpen(const char* path, int baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        LOGW("Cannot open %s: %s", path, strerror(errno));
+        return nullptr;
+    }
+    if (serialConfigureRaw(fd, baud) < 0) {
+        LOGW("Cannot configure %s: %s", path, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    SerialPort* port = serialWrap(fd, 1);
+    if (port == nullptr) {
+        close(fd);
+        return nullptr;
+    }
+    LOGI("✅ Serial open: %s @ %d", path, baud);
+    return port;
+}
+
+extern "C" int serialOpenPty(SerialPty* pty) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    if (grantpt(fd) < 0 || unlockpt(fd) < 0 || ptsname_r(fd, pty->slavePath, sizeof(pty->slavePath)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Raw on the master too, so written bytes are never translated
+    serialConfigureRaw(fd, 0);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    pty->masterFd = fd;
+    return 0;
+}
+
+extern "C" void serialClose(SerialPort* port) {
+    if (port == nullptr) return;
+    close(port->epollFd);
+    if (port->ownsFd) close(port->fd);
+    free(port);
+}
+
+extern "C" int serialFd(const SerialPort* port) {
+    return port->fd;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// I/O
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int serialRead(SerialPort* port, uint8_t* buffer, int capacity, int timeoutMs) {
+    int total = 0;
+
+    // Try first: data is usually already waiting when called in a loop.
+    // A short read means the fd is drained, so no extra EAGAIN round trip
+    while (total < capacity) {
+        ssize_t n = read(port->fd, buffer + total, capacity - total);
+        if (n > 0) {
+            total += (int)n;
+            port->stats.readCalls++;
+            if (n < capacity - (total - n)) break;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EIO) {
+            port->stats.errors++;
+            return total > 0 ? total : -1;
+        }
+        break;  // Drained (EAGAIN), or EOF / pty hangup (n == 0, EIO)
+    }
+    if (total > 0 || timeoutMs == 0) {
+        port->stats.bytesRead += total;
+        return total;
+    }
+
+    struct epoll_event ev;
+    int r;
+    do {
+        port->stats.waits++;
+        r = epoll_wait(port->epollFd, &ev, 1, timeoutMs);
+    } while (r < 0 && errno == EINTR);
+    if (r <= 0) return r;
+
+    while (total < capacity) {
+        ssize_t n = read(port->fd, buffer + total, capacity - total);
+        if (n > 0) {
+            total += (int)n;
+            port->stats.readCalls++;
+            if (n < capacity - (total - n)) break;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+
+    // Readable but nothing to read: the other end has gone
+    if (total == 0 && (ev.events & (EPOLLHUP | EPOLLERR))) {
+        port->stats.errors++;
+        return -1;
+    }
+    port->stats.bytesRead += total;
+    return total;
+}
+
+extern "C" int serialWritev(SerialPort* port, const struct iovec* iov, int iovcnt, int timeoutMs) {
+    if (iovcnt <= 0) return 0;
+    if (iovcnt > SERIAL_MAX_IOV) iovcnt = SERIAL_MAX_IOV;
+
+    // Local copy so partial writes can advance through the list
+    struct iovec vec[SERIAL_MAX_IOV];
+    memcpy(vec, iov, iovcnt * sizeof(struct iovec));
+    struct iovec* cur = vec;
+    int remaining = iovcnt;
+    int total = 0;
+
+    while (remaining > 0) {
+        ssize_t n = writev(port->fd, cur, remaining);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = {port->fd, POLLOUT, 0};
+                if (poll(&pfd, 1, timeoutMs) <= 0) break;
+                continue;
+            }
+            port->stats.errors++;
+            return total > 0 ? total : -1;
+        }
+
+        port->stats.writeCalls++;
+        total += (int)n;
+
+        // Skip fully written entries, trim the partially written one
+        size_t done = (size_t)n;
+        while (remaining > 0 && done >= cur->iov_len) {
+            done -= cur->iov_len;
+            cur++;
+            remaining--;
+        }
+        if (remaining > 0) {
+            cur->iov_base = (uint8_t*)cur->iov_base + done;
+            cur->iov_len -= done;
+            port->stats.partialWrites++;
+        }
+    }
+
+    port->stats.bytesWritten += total;
+    return total;
+}
+
+extern "C" int serialWrite(SerialPort* port, const uint8_t* data, int length, int timeoutMs) {
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = (size_t)length;
+    return serialWritev(port, &iov, 1, timeoutMs);
+}
+
+extern "C" void serialGetStats(const SerialPort* port, SerialStats* outStats) {
+    *outStats = port->stats;
+}
@@ -0,0 +1,84 @@
+/**
+ * serial_port.h
+ * Native Serial Port (termios + epoll)
+ *
+ * Raw 8N1 serial I/O for the servo (115200), GNSS/KCA (115200) and
+ * Waveshare (2 Mbps) links on Linux. Reads are non-blocking and wait
+ * on epoll; writes take an iovec list so header/payload/CRC can go
+ * out in one syscall. Pseudo-terminals stand in for the devices on a
+ * dev machine.
+ */
+
+#ifndef SERIAL_PORT_H
+#define SERIAL_PORT_H
+
+#include <cstdint>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SERIAL_READ_CHUNK 16384   // Bytes per read() call
+#define SERIAL_PATH_MAX 128
+
+typedef struct SerialPort SerialPort;
+
+typedef struct {
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+    uint64_t readCalls;       // read() calls that returned data
+    uint64_t waits;           // epoll waits
+    uint64_t writeCalls;      // writev() calls
+    uint64_t partialWrites;   // writev() that had to be resumed
+    uint64_t errors;
+} SerialStats;
+
+// Pseudo-terminal pair: master = device side, slavePath = what the app opens
+typedef struct {
+    int masterFd;
+    char slavePath[SERIAL_PATH_MAX];
+} SerialPty;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Open / Configure
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Put an fd in raw 8N1 mode at baud (0 = keep speed). Returns 0 on success
+int serialConfigureRaw(int fd, int baud);
+
+// Open and configure a tty (or pty slave). Returns NULL on failure
+SerialPort* serialOpen(const char* path, int baud);
+
+// Wrap an already-open fd (closed on serialClose if ownsFd)
+SerialPort* serialWrap(int fd, int ownsFd);
+
+// Create a raw, non-blocking pty. Returns 0 on success
+int serialOpenPty(SerialPty* pty);
+
+void serialClose(SerialPort* port);
+
+int serialFd(const SerialPort* port);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// I/O
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Wait up to timeoutMs (-1 = forever) for data, then read until the
+// buffer is full or the fd is drained. Returns bytes read, 0 on timeout,
+// -1 on error/hangup
+int serialRead(SerialPort* port, uint8_t* buffer, int capacity, int timeoutMs);
+
+// Write all iovecs, resuming partial writes. Gives up after timeoutMs
+// without progress. Returns bytes written, -1 on error
+int serialWritev(SerialPort* port, const struct iovec* iov, int iovcnt, int timeoutMs);
+
+int serialWrite(SerialPort* port, const uint8_t* data, int length, int timeoutMs);
+
+void serialGetStats(const SerialPort* port, SerialStats* outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIAL_PORT_H
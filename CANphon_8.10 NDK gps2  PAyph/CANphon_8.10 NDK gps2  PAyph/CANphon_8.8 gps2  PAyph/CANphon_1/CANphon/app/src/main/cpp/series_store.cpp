@@ -0,0 +1,252 @@
+/**
+ * series_store.cpp
+ * Chart Series Store (C++)
+ *
+ * Each series is a power-of-two ring indexed by an ever-growing sample
+ * index. A reader only trusts the newest (capacity - margin) samples and
+ * checks afterwards that the writer did not advance by more than the
+ * margin meanwhile; otherwise it decimates again.
+ */
+
+#define LOG_TAG "NativeSeries"
+#include "series_store.h"
+#include "native_log.h"
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <new>
+
+static const int MAX_READ_ATTEMPTS = 3;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Store State
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Series {
+    std::atomic<uint64_t> head;     // Samples ever appended
+    std::atomic<uint64_t> base;     // First index after the last clear
+    int64_t lastUs;                 // Writer only
+};
+
+static Series* series = nullptr;
+static int64_t* times = nullptr;    // [series][capacity]
+static float* values = nullptr;
+static int seriesCount = 0;
+static uint64_t capacity = 0;
+static uint64_t mask = 0;
+static std::atomic<bool> ready{false};
+
+// Serializes init / clear (never taken by appends or reads)
+static std::mutex controlLock;
+
+extern "C" int seriesStoreInit(int count, int requested) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    if (series != nullptr) {
+        for (int s = 0; s < seriesCount; s++) series[s].base.store(series[s].head.load());
+        return 1;
+    }
+    if (count <= 0 || count > SERIES_MAX_SERIES) return 0;
+    if (requested <= 0) requested = SERIES_DEFAULT_CAPACITY;
+
+    uint64_t size = 16;
+    while (size < (uint64_t)requested) size <<= 1;
+    series = new (std::nothrow) Series[count];
+    times = new (std::nothrow) int64_t[count * size];
+    values = new (std::nothrow) float[count * size];
+    if (series == nullptr || times == nullptr || values == nullptr) {
+        delete[] series;
+        delete[] times;
+        delete[] values;
+        series = nullptr;
+        times = nullptr;
+        values = nullptr;
+        LOGW("Series store: cannot allocate %d x %llu samples", count, (unsigned long long)size);
+        return 0;
+    }
+    for (int s = 0; s < count; s++) {
+        series[s].head.store(0, std::memory_order_relaxed);
+        series[s].base.store(0, std::memory_order_relaxed);
+        series[s].lastUs = INT64_MIN;
+    }
+    seriesCount = count;
+    capacity = size;
+    mask = size - 1;
+    ready.store(true, std::memory_order_release);
+
+    LOGI("✅ Series store: %d series x %llu samples (%llu KB)", count, (unsigned long long)size,
+         (unsigned long long)(count * size * (sizeof(int64_t) + sizeof(float)) / 1024));
+    return 1;
+}
+
+extern "C" void seriesStoreClear() {
+    std::lock_guard<std::mutex> guard(controlLock);
+    for (int s = 0; s < seriesCount; s++) series[s].base.store(series[s].head.load());
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Append (one writer per series)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void seriesStoreAppend(int s, int64_t timeUs, float value) {
+    if (!ready.load(std::memory_order_acquire) || s < 0 || s >= seriesCount) return;
+    Series* p = &series[s];
+    if (timeUs < p->lastUs) timeUs = p->lastUs;
+    p->lastUs = timeUs;
+
+    uint64_t index = p->head.load(std::memory_order_relaxed);
+    uint64_t slot = (uint64_t)s * capacity + (index & mask);
+    times[slot] = timeUs;
+    values[slot] = value;
+    p->head.store(index + 1, std::memory_order_release);
+}
+
+extern "C" int seriesStoreCount(int s) {
+    if (!ready.load(std::memory_order_acquire) || s < 0 || s >= seriesCount) return 0;
+    uint64_t head = series[s].head.load(std::memory_order_acquire);
+    uint64_t held = head - series[s].base.load(std::memory_order_relaxed);
+    return (int)(held < capacity ? held : capacity);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Decimation
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Samples [first, first + count) of one series, by sample index
+struct Window {
+    const int64_t* t;
+    const float* v;
+    uint64_t first;
+    uint64_t count;
+    int64_t fromUs;
+    int64_t toUs;
+
+    int64_t time(uint64_t i) const { return t[(first + i) & mask]; }
+    float value(uint64_t i) const { return v[(first + i) & mask]; }
+};
+
+static void emit(const Window& w, uint64_t i, float* outX, float* outY, int* n) {
+    int64_t t = w.time(i);
+    if (t < w.fromUs) t = w.fromUs;   // Sample before the window: drawn at its edge
+    outX[*n] = (float)(t - w.toUs) * 1e-6f;
+    outY[*n] = w.value(i);
+    (*n)++;
+}
+
+// First index in [lo, hi) whose time is > limit (strict) or >= limit
+static uint64_t search(const Window& w, uint64_t lo, uint64_t hi, int64_t limit, bool strict) {
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        int64_t t = w.time(mid);
+        if (strict ? t <= limit : t < limit) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int lttb(const Window& w, int m, float* outX, float* outY) {
+    int n = 0;
+    if ((uint64_t)m >= w.count || m < 3) {
+        if ((uint64_t)m >= w.count) {
+            for (uint64_t i = 0; i < w.count; i++) emit(w, i, outX, outY, &n);
+        } else {
+            emit(w, 0, outX, outY, &n);
+            if (m == 2) emit(w, w.count - 1, outX, outY, &n);
+        }
+        return n;
+    }
+
+    // First and last are kept; the rest is split into m - 2 buckets
+    double bucket = (double)(w.count - 2) / (m - 2);
+    uint64_t a = 0;
+    emit(w, a, outX, outY, &n);
+    for (int b = 0; b < m - 2; b++) {
+        uint64_t start = 1 + (uint64_t)(b * bucket);
+        uint64_t end = 1 + (uint64_t)((b + 1) * bucket);
+        if (end > w.count - 1) end = w.count - 1;
+
+        // Third vertex: average of the next bucket (or the last point)
+        uint64_t nextStart = end;
+        uint64_t nextEnd = 1 + (uint64_t)((b + 2) * bucket);
+        if (nextEnd > w.count) nextEnd = w.count;
+        if (nextEnd <= nextStart) nextEnd = nextStart + 1;
+        double avgT = 0, avgV = 0;
+        for (uint64_t i = nextStart; i < nextEnd; i++) {
+            avgT += (double)(w.time(i) - w.toUs);
+            avgV += w.value(i);
+        }
+        avgT /= (double)(nextEnd - nextStart);
+        avgV /= (double)(nextEnd - nextStart);
+
+        double at = (double)(w.time(a) - w.toUs);
+        double av = w.value(a);
+        double bestArea = -1;
+        uint64_t best = start;
+        for (uint64_t i = start; i < end; i++) {
+            double area = fabs((at - avgT) * (w.value(i) - av) - (at - (double)(w.time(i) - w.toUs)) * (avgV - av));
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+        emit(w, best, outX, outY, &n);
+        a = best;
+    }
+    emit(w, w.count - 1, outX, outY, &n);
+    return n;
+}
+
+static int minMax(const Window& w, int m, float* outX, float* outY) {
+    int n = 0;
+    if ((uint64_t)m >= w.count || m < 2) {
+        uint64_t count = (uint64_t)m >= w.count ? w.count : (uint64_t)m;
+        for (uint64_t i = 0; i < count; i++) emit(w, i, outX, outY, &n);
+        return n;
+    }
+
+    int buckets = m / 2;
+    for (int b = 0; b < buckets; b++) {
+        uint64_t start = w.count * (uint64_t)b / (uint64_t)buckets;
+        uint64_t end = w.count * (uint64_t)(b + 1) / (uint64_t)buckets;
+        uint64_t lo = start, hi = start;
+        for (uint64_t i = start + 1; i < end; i++) {
+            if (w.value(i) < w.value(lo)) lo = i;
+            if (w.value(i) > w.value(hi)) hi = i;
+        }
+        uint64_t first = lo < hi ? lo : hi;
+        uint64_t second = lo < hi ? hi : lo;
+        emit(w, first, outX, outY, &n);
+        if (second != first) emit(w, second, outX, outY, &n);
+    }
+    return n;
+}
+
+extern "C" int seriesStoreDecimate(int s, int64_t fromUs, int64_t toUs, int method, int maxPoints,
+                                   float* outX, float* outY) {
+    if (!ready.load(std::memory_order_acquire) || s < 0 || s >= seriesCount || maxPoints <= 0) return 0;
+    if (toUs < fromUs) return 0;
+    const Series* p = &series[s];
+    uint64_t margin = capacity / 8;
+
+    int n = 0;
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+        uint64_t head = p->head.load(std::memory_order_acquire);
+        uint64_t lo = p->base.load(std::memory_order_relaxed);
+        if (head > capacity - margin && lo < head - (capacity - margin)) lo = head - (capacity - margin);
+
+        Window w = {times + (uint64_t)s * capacity, values + (uint64_t)s * capacity, 0, 0, fromUs, toUs};
+        uint64_t begin = search(w, lo, head, fromUs, false);
+        uint64_t end = search(w, begin, head, toUs, true);
+        if (begin > lo) begin--;
+        if (end <= begin) return 0;
+        w.first = begin;
+        w.count = end - begin;
+
+        n = method == SERIES_DECIMATE_MINMAX ? minMax(w, maxPoints, outX, outY) : lttb(w, maxPoints, outX, outY);
+
+        // Samples read must not have been overwritten meanwhile
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (p->head.load(std::memory_order_relaxed) - head <= margin) return n;
+    }
+    LOGW("Series %d: writer outran %d reads", s, MAX_READ_ATTEMPTS);
+    return 0;
+}
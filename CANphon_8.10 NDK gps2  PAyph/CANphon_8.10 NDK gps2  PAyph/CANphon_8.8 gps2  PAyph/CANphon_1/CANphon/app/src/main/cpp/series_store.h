@@ -0,0 +1,62 @@
+/**
+ * series_store.h
+ * Chart Series Store (C++)
+ *
+ * Fixed-capacity time series per channel (allocated once), filled at the
+ * source rate by the native senders and the receive thread, and reduced
+ * on request to exactly the points a chart can draw:
+ *   LTTB    - Largest-Triangle-Three-Buckets, keeps the visual shape
+ *   MINMAX  - min and max per bucket, keeps every peak (envelope)
+ *
+ * The chart then draws a constant number of points however long the
+ * history is; only the decimation pass scales with the window.
+ *
+ * One writer per series (a full ring overwrites the oldest samples);
+ * readers never block the writer.
+ */
+
+#ifndef SERIES_STORE_H
+#define SERIES_STORE_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SERIES_DEFAULT_CAPACITY 8192        // Samples per series (~80 s of 100 Hz feedback)
+#define SERIES_MAX_SERIES 64
+
+// Series of actuator channel `ch` (servo_estimator / can_dispatch feed these)
+#define SERIES_COMMAND(ch) (2 * (ch))
+#define SERIES_FEEDBACK(ch) (2 * (ch) + 1)
+
+#define SERIES_DECIMATE_LTTB 0
+#define SERIES_DECIMATE_MINMAX 1
+
+// Allocate `seriesCount` series of `capacity` samples (rounded up to a
+// power of two) on the first call; later calls only clear. Returns 0 if
+// the allocation fails or the counts are out of range
+int seriesStoreInit(int seriesCount, int capacity);
+
+// Drop all samples (the allocation is kept)
+void seriesStoreClear();
+
+// Append a sample. Timestamps of a series must not go back (earlier ones
+// are moved up to the last). No-op before seriesStoreInit
+void seriesStoreAppend(int series, int64_t timeUs, float value);
+
+// Samples currently held by a series
+int seriesStoreCount(int series);
+
+// Reduce the samples of [fromUs, toUs] (plus the one before fromUs, so
+// the line starts at the left edge) to at most maxPoints. outX is seconds
+// relative to toUs (<= 0). Returns points written
+int seriesStoreDecimate(int series, int64_t fromUs, int64_t toUs, int method, int maxPoints,
+                        float* outX, float* outY);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIES_STORE_H
@@ -0,0 +1,254 @@
+/**
+ * servo_estimator.cpp
+ * Servo Response Estimator (C++)
+ *
+ * Lag is measured by matching each feedback sample, while the servo
+ * moves, to the newest point where the command trajectory passed through
+ * the same position in the same direction. Streamed commands (updates
+ * closer than STREAM_GAP_US) are interpolated; an isolated step
+ * counts from the moment it was sent.
+ */
+
+#define LOG_TAG "NativeServoEst"
+#include "servo_estimator.h"
+#include "can_dispatch.h"
+#include "native_log.h"
+#include "series_store.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+static const int COMMAND_RING_SIZE = 16;        // Sender → read thread, per channel
+static const int HISTORY_SIZE = 64;             // Command trajectory kept for lag matching
+static const int64_t STREAM_GAP_US = 100000;    // Closer updates form a continuous trajectory
+static const int64_t MAX_FEEDBACK_GAP_US = 200000;  // Longer gaps restart the velocity filter
+static const int64_t MIN_SETTLE_US = 150000;
+static const float ALPHA = 0.5f;                // Alpha-beta position / velocity gains
+static const float BETA = 0.1f;
+static const float LAG_GAIN = 0.05f;            // EWMA weights
+static const float STEADY_GAIN = 0.1f;
+static const float PEAK_DECAY_S = 10.0f;        // Peak rate forgets over ~10 s
+static const float RATE_LIMIT_FRACTION = 0.85f;
+static const float MIN_PEAK_RATE_DPS = 20.0f;
+
+// Position command (CANServoProtocol.createPositionCommand)
+static const uint8_t SDO_WRITE = 0x22;
+static const uint16_t INDEX_POSITION_TARGET = 0x6003;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Estimator State
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    int64_t timeUs;
+    float angle;
+} CommandSample;
+
+// Single producer (sender), single consumer (read thread)
+typedef struct {
+    std::atomic<uint32_t> head;
+    uint32_t tail;
+    CommandSample samples[COMMAND_RING_SIZE];
+} CommandRing;
+
+// Read thread only
+typedef struct {
+    CommandSample history[HISTORY_SIZE];
+    int historyCount;
+    int historyNext;
+    float command;
+    int64_t commandUs;          // Last change of the command
+    int haveCommand;
+
+    int haveFeedback;
+    int64_t feedbackUs;
+    float position;             // Filtered
+    float velocity;
+    int64_t stallSinceUs;       // 0 = not stalling
+} ChannelState;
+
+static CommandRing rings[CAN_DISPATCH_MAX_CHANNELS];
+static ChannelState channels[CAN_DISPATCH_MAX_CHANNELS];
+static uint8_t commandChannel[CAN_STD_ID_COUNT];    // Channel + 1, 0 = not a servo command ID
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Setup
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void servoEstimatorReset() {
+    for (int i = 0; i < CAN_DISPATCH_MAX_CHANNELS; i++) {
+        rings[i].head.store(0, std::memory_order_relaxed);
+        rings[i].tail = 0;
+    }
+    memset(channels, 0, sizeof(channels));
+    memset(commandChannel, 0, sizeof(commandChannel));
+    memset(canDispatchShared()->estimate, 0, sizeof(canDispatchShared()->estimate));
+}
+
+extern "C" int servoEstimatorSetChannel(uint32_t commandId, int channel) {
+    if (commandId >= CAN_STD_ID_COUNT || channel < 0 || channel >= CAN_DISPATCH_MAX_CHANNELS) return 0;
+    commandChannel[commandId] = (uint8_t)(channel + 1);
+    return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Commands (sender thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int servoEstimatorParseCommand(uint8_t dlc, const uint8_t* data, float* outAngleDeg) {
+    if (dlc < 8 || data[0] != SDO_WRITE || (data[1] | (data[2] << 8)) != INDEX_POSITION_TARGET) return 0;
+
+    // Bridge: pos = value * 4 + 8191 (0..16383 over -25..+25°)
+    int32_t value = (int32_t)((uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) |
+                              ((uint32_t)data[7] << 24));
+    float position = (float)(value * 4 + 8191);
+    *outAngleDeg = position / 16383.0f * (2 * SERVO_EST_TRAVEL_DEG) - SERVO_EST_TRAVEL_DEG;
+    return 1;
+}
+
+extern "C" void servoEstimatorCommand(int channel, float angleDeg, int64_t timeUs) {
+    if (channel < 0 || channel >= CAN_DISPATCH_MAX_CHANNELS) return;
+
+    // A full ring overwrites the oldest; the reader skips what it missed
+    CommandRing* r = &rings[channel];
+    uint32_t head = r->head.load(std::memory_order_relaxed);
+    r->samples[head % COMMAND_RING_SIZE] = {timeUs, angleDeg};
+    r->head.store(head + 1, std::memory_order_release);
+
+    seriesStoreAppend(SERIES_COMMAND(channel), timeUs, angleDeg);   // Chart history
+}
+
+static void commandFrame(uint32_t id, uint8_t dlc, const uint8_t* data, int64_t timeUs) {
+    if (id >= CAN_STD_ID_COUNT || commandChannel[id] == 0) return;
+    float angle;
+    if (servoEstimatorParseCommand(dlc, data, &angle)) servoEstimatorCommand(commandChannel[id] - 1, angle, timeUs);
+}
+
+extern "C" void servoEstimatorCommandFrames(const WsCanFrame* frames, int count, int64_t timeUs) {
+    for (int i = 0; i < count; i++) {
+        if (!(frames[i].flags & WS_FLAG_EXT)) commandFrame(frames[i].id, frames[i].dlc, frames[i].data, timeUs);
+    }
+}
+
+extern "C" void servoEstimatorCommandPacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data, int count,
+                                            int64_t timeUs) {
+    for (int i = 0; i < count; i++) {
+        commandFrame((uint32_t)ids[i], (uint8_t)dlcs[i], (const uint8_t*)data + i * WS_MAX_DLC, timeUs);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Estimation (read thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void drainCommands(int channel, ChannelState* s) {
+    CommandRing* r = &rings[channel];
+    uint32_t head = r->head.load(std::memory_order_acquire);
+    if (head - r->tail > (uint32_t)COMMAND_RING_SIZE) r->tail = head - COMMAND_RING_SIZE;
+
+    for (; r->tail != head; r->tail++) {
+        CommandSample c = r->samples[r->tail % COMMAND_RING_SIZE];
+        if (s->haveCommand && fabsf(c.angle - s->command) < 0.01f) continue;   // Repeat
+
+        s->history[s->historyNext] = c;
+        s->historyNext = (s->historyNext + 1) % HISTORY_SIZE;
+        if (s->historyCount < HISTORY_SIZE) s->historyCount++;
+        s->command = c.angle;
+        s->commandUs = c.timeUs;
+        s->haveCommand = 1;
+    }
+}
+
+// Newest time the command trajectory passed through `position` moving in
+// the direction of `velocity`. Returns -1 if not found
+static int64_t matchCommand(const ChannelState* s, float position, float velocity) {
+    for (int k = 0; k + 1 < s->historyCount; k++) {
+        const CommandSample* b = &s->history[(s->historyNext - 1 - k + 2 * HISTORY_SIZE) % HISTORY_SIZE];
+        const CommandSample* a = &s->history[(s->historyNext - 2 - k + 2 * HISTORY_SIZE) % HISTORY_SIZE];
+        float delta = b->angle - a->angle;
+        if ((delta > 0) != (velocity > 0)) continue;
+        if (position < fminf(a->angle, b->angle) || position > fmaxf(a->angle, b->angle)) continue;
+
+        if (b->timeUs - a->timeUs > STREAM_GAP_US) return b->timeUs;   // Step
+        return a->timeUs + (int64_t)((position - a->angle) / delta * (float)(b->timeUs - a->timeUs));
+    }
+    return -1;
+}
+
+extern "C" void servoEstimatorFeedback(int channel, float angleDeg, int64_t timeUs) {
+    if (channel < 0 || channel >= CAN_DISPATCH_MAX_CHANNELS) return;
+    ChannelState* s = &channels[channel];
+    CanServoEstimate* e = &canDispatchShared()->estimate[channel];
+
+    drainCommands(channel, s);
+
+    // Velocity: alpha-beta filter over the real sample interval
+    int64_t gapUs = timeUs - s->feedbackUs;
+    if (!s->haveFeedback || gapUs > MAX_FEEDBACK_GAP_US) {
+        s->position = angleDeg;
+        s->velocity = 0;
+        s->haveFeedback = 1;
+    } else if (gapUs > 0) {
+        float dt = (float)gapUs * 1e-6f;
+        float predicted = s->position + s->velocity * dt;
+        float residual = angleDeg - predicted;
+        s->position = predicted + ALPHA * residual;
+        s->velocity += BETA / dt * residual;
+
+        float speed = fabsf(s->velocity);
+        e->peakRateDps *= 1.0f - dt / PEAK_DECAY_S;
+        if (speed > e->peakRateDps) e->peakRateDps = speed;
+    } else {
+        s->position = angleDeg;
+    }
+    s->feedbackUs = timeUs;
+
+    uint32_t flags = SERVO_EST_FEEDBACK;
+    int moving = fabsf(s->velocity) >= SERVO_EST_MOVING_DPS;
+    if (moving) flags |= SERVO_EST_MOVING;
+
+    int saturated = fabsf(angleDeg) >= SERVO_EST_TRAVEL_DEG - 0.1f;
+    if (s->haveCommand) {
+        float error = s->command - angleDeg;
+        saturated = saturated || fabsf(s->command) >= SERVO_EST_TRAVEL_DEG - 0.1f;
+
+        // Lag: only while moving, otherwise any past command matches
+        if (moving) {
+            int64_t matched = matchCommand(s, angleDeg, s->velocity);
+            int64_t lagUs = matched >= 0 ? timeUs - matched : -1;
+            if (lagUs >= 0 && lagUs <= SERVO_EST_MAX_LAG_MS * 1000) {
+                float lagMs = (float)lagUs / 1000.0f;
+                e->lagMs = e->lagSamples == 0 ? lagMs : e->lagMs + LAG_GAIN * (lagMs - e->lagMs);
+                e->lagSamples++;
+            }
+        }
+
+        // Steady state: command held for a few lags and the servo at rest
+        int64_t settleUs = (int64_t)(3000.0f * e->lagMs);
+        if (settleUs < MIN_SETTLE_US) settleUs = MIN_SETTLE_US;
+        if (!moving && timeUs - s->commandUs >= settleUs) {
+            flags |= SERVO_EST_SETTLED;
+            e->steadyErrorDeg += STEADY_GAIN * (error - e->steadyErrorDeg);
+        }
+
+        // Stall: far from the command, not moving, and not held by a travel limit
+        if (fabsf(error) > SERVO_EST_STALL_ERROR_DEG && !moving && !saturated) {
+            if (s->stallSinceUs == 0) s->stallSinceUs = timeUs;
+            if (timeUs - s->stallSinceUs >= SERVO_EST_STALL_MS * 1000) flags |= SERVO_EST_STALLED;
+        } else {
+            s->stallSinceUs = 0;
+        }
+
+        if (fabsf(error) > SERVO_EST_STALL_ERROR_DEG && e->peakRateDps >= MIN_PEAK_RATE_DPS &&
+            fabsf(s->velocity) >= RATE_LIMIT_FRACTION * e->peakRateDps) {
+            flags |= SERVO_EST_RATE_LIMITED;
+        }
+
+        e->commandDeg = s->command;
+        e->trackingErrorDeg = error;
+    }
+    if (saturated) flags |= SERVO_EST_SATURATED;
+
+    e->velocityDps = s->velocity;
+    e->flags = flags;
+}
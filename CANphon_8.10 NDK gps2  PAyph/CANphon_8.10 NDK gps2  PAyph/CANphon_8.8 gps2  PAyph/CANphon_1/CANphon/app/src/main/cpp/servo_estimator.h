@@ -0,0 +1,79 @@
+/**
+ * servo_estimator.h
+ * Servo Response Estimator (C++)
+ *
+ * Per-channel model of how each actuator follows its commands, built from
+ * the position commands sent (0x600 + node SDO writes) and the timestamped
+ * feedback (0x580 + node):
+ *   velocity      - alpha-beta filter on feedback position
+ *   lag           - time by which feedback trails the command trajectory
+ *   steady error  - command - feedback once the servo has settled
+ *   stall         - large error, no motion, not at a travel limit
+ *   saturation    - command or feedback at the ±25° travel limit
+ *
+ * Commands may come from any one sender thread; they pass to the read
+ * thread through a small lock-free ring. All estimation runs on the read
+ * thread and lands in CanDispatchShared.estimate[] (can_dispatch.h).
+ */
+
+#ifndef SERVO_ESTIMATOR_H
+#define SERVO_ESTIMATOR_H
+
+#include <cstdint>
+#include "waveshare_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CanServoEstimate.flags
+#define SERVO_EST_FEEDBACK 0x01      // At least one feedback sample
+#define SERVO_EST_MOVING 0x02        // |velocity| above SERVO_EST_MOVING_DPS
+#define SERVO_EST_SETTLED 0x04       // Command held and servo at rest
+#define SERVO_EST_STALLED 0x08
+#define SERVO_EST_SATURATED 0x10     // Command or feedback at the travel limit
+#define SERVO_EST_RATE_LIMITED 0x20  // Slewing at the peak rate with a large error
+
+#define SERVO_EST_TRAVEL_DEG 25.0f
+#define SERVO_EST_MOVING_DPS 5.0f
+#define SERVO_EST_STALL_ERROR_DEG 3.0f
+#define SERVO_EST_STALL_MS 300
+#define SERVO_EST_MAX_LAG_MS 1000
+
+#define SERVO_EST_COMMAND_BASE_ID 0x600  // CANServoProtocol.TX_OFFSET
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Setup
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Forget every channel's history and command mapping
+void servoEstimatorReset();
+
+// Route position commands on commandId (0x600 + node) to a channel.
+// Returns 0 if the ID or channel is out of range
+int servoEstimatorSetChannel(uint32_t commandId, int channel);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Inputs (timestamps: canRecorderNowUs() or any common microsecond clock)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Command sent to a channel. Sender thread
+void servoEstimatorCommand(int channel, float angleDeg, int64_t timeUs);
+
+// Pick position commands out of outgoing frames (others are ignored)
+void servoEstimatorCommandFrames(const WsCanFrame* frames, int count, int64_t timeUs);
+
+// Flat-array variant (JNI): ids[count], dlcs[count], data[count * 8]
+void servoEstimatorCommandPacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data, int count, int64_t timeUs);
+
+// Feedback position of a channel. Read thread (can_dispatch calls this)
+void servoEstimatorFeedback(int channel, float angleDeg, int64_t timeUs);
+
+// Decode a position command frame into degrees. Returns 0 for other frames
+int servoEstimatorParseCommand(uint8_t dlc, const uint8_t* data, float* outAngleDeg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERVO_ESTIMATOR_H
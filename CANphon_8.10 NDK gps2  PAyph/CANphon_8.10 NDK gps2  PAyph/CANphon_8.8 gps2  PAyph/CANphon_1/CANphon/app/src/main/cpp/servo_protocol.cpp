@@ -9,11 +9,9 @@
  * [Syncid] [Id] [Hpos] [Lpos] [Checksum]
  */
 
-#include "servo_protocol.h"
-#include <android/log.h>
-
 #define LOG_TAG "NativeServoProtocol"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#include "servo_protocol.h"
+#include "native_log.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Utility Functions
@@ -156,3 +154,58 @@ extern "C" int servoParseFeedback(const uint8_t* data, int length, ServoFeedback
     
     return 1;
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stream Feedback Parser (7-byte serial feedback, FeedbackParser.kt)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void servoStreamInit(ServoStreamParser* parser) {
+    parser->index = 0;
+    parser->checkXor = 0;
+    parser->framesParsed = 0;
+    parser->checksumErrors = 0;
+}
+
+static void servoStreamDecode(const uint8_t* frame, ServoStreamEvent* event) {
+    int raw = (frame[2] & 0x7F) * 128 + (frame[3] & 0x7F);
+
+    event->servoId = (frame[0] & 0x03) * 128 + (frame[1] & 0x7F);
+    event->opcode = frame[0] & 0xFC;
+    event->raw = raw;
+    switch (event->opcode) {
+        case SERVO_FB_OPCODE_POSITION: event->value = (raw - POSITION_CENTER) / UNITS_PER_DEGREE; break;
+        case SERVO_FB_OPCODE_TEMPERATURE: event->value = (raw - POSITION_CENTER) * 0.1f; break;
+        case SERVO_FB_OPCODE_CURRENT: event->value = (raw - POSITION_CENTER) * 0.05f; break;
+        default: event->value = 0.0f; break;
+    }
+}
+
+extern "C" int servoStreamParse(ServoStreamParser* parser, const uint8_t* data, int length,
+                                ServoStreamEvent* out, int maxEvents) {
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        uint8_t b = data[i];
+
+        if (parser->index == 0) {
+            // Waiting for sync (bit 7 set)
+            if (b & 0x80) {
+                parser->frame[0] = b;
+                parser->checkXor = b;
+                parser->index = 1;
+            }
+        } else if (parser->index < SERVO_FEEDBACK_FRAME_SIZE - 1) {
+            parser->frame[parser->index++] = b;
+            parser->checkXor ^= b;
+        } else {
+            uint8_t expected = (uint8_t)((parser->checkXor & 0x7F) | 0x40);
+            if (b == expected) {
+                parser->framesParsed++;
+                if (count < maxEvents) servoStreamDecode(parser->frame, &out[count++]);
+            } else {
+                parser->checksumErrors++;
+            }
+            parser->index = 0;
+        }
+    }
+    return count;
+}
@@ -59,6 +59,40 @@ typedef struct {
 // Returns 1 if valid, 0 if invalid
 int servoParseFeedback(const uint8_t* data, int length, ServoFeedback* outFeedback);
 
+// ═══════════════════════════════════════════════════════════════════════════
+// Stream Feedback Parser
+// ═══════════════════════════════════════════════════════════════════════════
+
+// 7-byte serial feedback: [B0] [B1] [B2] [B3] [B4] [B5] [Checksum]
+// ID = (B0 & 0x03) * 128 + (B1 & 0x7F), OpCode = B0 & 0xFC
+// Checksum = (XOR of B0..B5 & 0x7F) | 0x40
+#define SERVO_FEEDBACK_FRAME_SIZE 7
+#define SERVO_FB_OPCODE_POSITION 0x88
+#define SERVO_FB_OPCODE_CURRENT 0x8C
+#define SERVO_FB_OPCODE_TEMPERATURE 0x90
+
+typedef struct {
+    uint8_t frame[SERVO_FEEDBACK_FRAME_SIZE];
+    int index;              // 0 = waiting for sync
+    uint8_t checkXor;
+    uint64_t framesParsed;
+    uint64_t checksumErrors;
+} ServoStreamParser;
+
+typedef struct {
+    int servoId;
+    int opcode;             // SERVO_FB_OPCODE_*
+    int raw;                // 14-bit value
+    float value;            // Degrees / °C / A depending on opcode
+} ServoStreamEvent;
+
+void servoStreamInit(ServoStreamParser* parser);
+
+// Feed any number of bytes; partial frames carry over to the next call.
+// Returns events written to out (frames beyond maxEvents are counted only)
+int servoStreamParse(ServoStreamParser* parser, const uint8_t* data, int length,
+                     ServoStreamEvent* out, int maxEvents);
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Utility
 // ═══════════════════════════════════════════════════════════════════════════
@@ -7,6 +7,8 @@
  */
 
 #include "target_discriminator.h"
+#include "frame_arena.h"
+#include "param_store.h"
 #include <cmath>
 #include <cstring>
 #include <android/log.h>
@@ -15,16 +17,6 @@
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 
-// ═══════════════════════════════════════════════════════════════════════════
-// Configuration (matching Kotlin values)
-// ═══════════════════════════════════════════════════════════════════════════
-
-static const int MIN_SIZE = 20;
-static const int MAX_SIZE = 500;
-static const float MIN_ASPECT_RATIO = 0.3f;
-static const float MAX_ASPECT_RATIO = 3.0f;
-static const int STABILITY_FRAMES = 3;
-
 // ═══════════════════════════════════════════════════════════════════════════
 // Target History (for stability calculation)
 // ═══════════════════════════════════════════════════════════════════════════
@@ -37,14 +29,20 @@ struct TargetHistory {
     int centerY[MAX_HISTORY_FRAMES];
     int count;
     int hash;  // Simple identifier
+    uint32_t lastSeen;  // Batch of the last evaluation (eviction order)
 };
 
 static TargetHistory historyBuffer[MAX_HISTORY_TARGETS];
 static int historyCount = 0;
+static uint32_t batch = 0;
 
-// Last evaluated scores (for detailed retrieval)
-static TargetScore lastScores[32];
+// Scores of the last discriminatorEvaluateMultiple batch (for detailed
+// retrieval). They live in the score arena, reset when the next batch starts
+static FrameArena scoreArena;
+static bool inBatch = false;
+static TargetScore* lastScores = nullptr;
 static int lastScoreCount = 0;
+static int lastScoreCapacity = 0;
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Helper Functions
@@ -75,16 +73,32 @@ static TargetHistory* getHistory(int hash) {
         }
     }
     
-    // Create new if space available
+    // Create new if space available, else replace the least recently seen
+    TargetHistory* h;
     if (historyCount < MAX_HISTORY_TARGETS) {
-        TargetHistory* h = &historyBuffer[historyCount++];
-        memset(h, 0, sizeof(TargetHistory));
-        h->hash = hash;
-        return h;
+        h = &historyBuffer[historyCount++];
+    } else {
+        h = &historyBuffer[0];
+        for (int i = 1; i < historyCount; i++) {
+            if (historyBuffer[i].lastSeen < h->lastSeen) h = &historyBuffer[i];
+        }
     }
-    
-    // Overwrite oldest if full
-    return &historyBuffer[0];
+    memset(h, 0, sizeof(TargetHistory));
+    h->hash = hash;
+    return h;
+}
+
+// Keep a score for discriminatorGetScore (the table doubles in the arena)
+static void recordScore(const TargetScore& score) {
+    if (lastScoreCount == lastScoreCapacity) {
+        int capacity = lastScoreCapacity > 0 ? lastScoreCapacity * 2 : 32;
+        TargetScore* grown = frameArenaArray<TargetScore>(&scoreArena, capacity);
+        if (!grown) return;
+        if (lastScoreCount > 0) memcpy(grown, lastScores, lastScoreCount * sizeof(TargetScore));
+        lastScores = grown;
+        lastScoreCapacity = capacity;
+    }
+    lastScores[lastScoreCount++] = score;
 }
 
 // Add point to history
@@ -109,8 +123,11 @@ static void addToHistory(TargetHistory* h, int centerX, int centerY) {
 // ═══════════════════════════════════════════════════════════════════════════
 
 extern "C" void discriminatorInit() {
+    if (!scoreArena.base) frameArenaInit(&scoreArena, "discriminator", 16 * 1024);
     historyCount = 0;
     lastScoreCount = 0;
+    lastScoreCapacity = 0;
+    frameArenaReset(&scoreArena);
     memset(historyBuffer, 0, sizeof(historyBuffer));
     LOGI("✅ Target Discriminator initialized");
 }
@@ -120,18 +137,21 @@ extern "C" float discriminatorEvaluate(
     int lastX, int lastY, int lastW, int lastH,
     int imageWidth, int imageHeight
 ) {
+    // Limits are tuning parameters (PARAM_DISC_*, defaults match the Kotlin
+    // values), one snapshot per evaluation
+    ParamPin params;
     int area = w * h;
     int centerX = x;
     int centerY = y;
     
     // 1. SIZE SCORE - Medium-sized targets are preferred
     float sizeScore;
-    int minArea = MIN_SIZE * MIN_SIZE;
-    int maxArea = MAX_SIZE * MAX_SIZE;
+    int minArea = params.i(PARAM_DISC_MIN_SIZE) * params.i(PARAM_DISC_MIN_SIZE);
+    int maxArea = params.i(PARAM_DISC_MAX_SIZE) * params.i(PARAM_DISC_MAX_SIZE);
     
     if (area < minArea) {
         sizeScore = 0.0f;  // Too small
-    } else if (area > maxArea) {
+    } else if (area > maxArea || maxArea <= minArea) {
         sizeScore = 0.3f;  // Too large
     } else {
         float normalizedSize = (float)(area - minArea) / (float)(maxArea - minArea);
@@ -142,7 +162,7 @@ extern "C" float discriminatorEvaluate(
     float aspectRatio = (h > 0) ? (float)w / (float)h : 1.0f;
     float aspectScore;
     
-    if (aspectRatio < MIN_ASPECT_RATIO || aspectRatio > MAX_ASPECT_RATIO) {
+    if (aspectRatio < params.f(PARAM_DISC_MIN_ASPECT) || aspectRatio > params.f(PARAM_DISC_MAX_ASPECT)) {
         aspectScore = 0.2f;
     } else if (aspectRatio >= 0.8f && aspectRatio <= 1.2f) {
         aspectScore = 1.0f;  // Square-ish (preferred for tanks/vehicles)
@@ -161,10 +181,11 @@ extern "C" float discriminatorEvaluate(
     // 4. STABILITY SCORE - Stable targets are better
     int hash = rectHash(x, y, w, h);
     TargetHistory* hist = getHistory(hash);
+    hist->lastSeen = batch;
     addToHistory(hist, centerX, centerY);
     
     float stabilityScore;
-    if (hist->count >= STABILITY_FRAMES) {
+    if (hist->count >= params.i(PARAM_DISC_STABILITY_FRAMES)) {
         // Calculate variance
         float avgX = 0, avgY = 0;
         for (int i = 0; i < hist->count; i++) {
@@ -215,16 +236,15 @@ extern "C" float discriminatorEvaluate(
     );
     
     // Store for later retrieval
-    if (lastScoreCount < 32) {
-        TargetScore* s = &lastScores[lastScoreCount++];
-        s->x = x; s->y = y; s->w = w; s->h = h;
-        s->confidence = confidence;
-        s->sizeScore = sizeScore;
-        s->positionScore = positionScore;
-        s->stabilityScore = stabilityScore;
-        s->motionScore = motionScore;
-        s->totalScore = totalScore;
-    }
+    TargetScore s;
+    s.x = x; s.y = y; s.w = w; s.h = h;
+    s.confidence = confidence;
+    s.sizeScore = sizeScore;
+    s.positionScore = positionScore;
+    s.stabilityScore = stabilityScore;
+    s.motionScore = motionScore;
+    s.totalScore = totalScore;
+    if (inBatch) recordScore(s);
     
     LOGD("🎯 Eval: size=%.2f, aspect=%.2f, pos=%.2f, stab=%.2f, motion=%.2f → total=%.2f",
          sizeScore, aspectScore, positionScore, stabilityScore, motionScore, totalScore);
@@ -239,7 +259,13 @@ extern "C" void discriminatorEvaluateMultiple(
     int imageWidth, int imageHeight,
     float* outScores
 ) {
-    lastScoreCount = 0;  // Reset for new batch
+    // Reset for new batch: the previous scores go with the arena
+    frameArenaReset(&scoreArena);
+    batch++;
+    lastScoreCount = 0;
+    lastScores = frameArenaArray<TargetScore>(&scoreArena, count > 0 ? count : 1);
+    lastScoreCapacity = lastScores ? (count > 0 ? count : 1) : 0;
+    inBatch = true;
     
     for (int i = 0; i < count; i++) {
         int x = rects[i * 4 + 0];
@@ -253,6 +279,7 @@ extern "C" void discriminatorEvaluateMultiple(
             imageWidth, imageHeight
         );
     }
+    inBatch = false;
 }
 
 extern "C" int discriminatorSelectBest(float* scores, int count, float minScore) {
@@ -278,6 +305,8 @@ extern "C" void discriminatorGetScore(int index, TargetScore* outScore) {
 extern "C" void discriminatorReset() {
     historyCount = 0;
     lastScoreCount = 0;
+    lastScoreCapacity = 0;
+    frameArenaReset(&scoreArena);
     memset(historyBuffer, 0, sizeof(historyBuffer));
     LOGI("🔄 Target Discriminator reset");
 }
@@ -5,29 +5,33 @@
  * Protocol: 73-byte binary frame @ 60Hz
  * Converted from TelemetryStreamer.kt - frame building only
  * 
- * USB Serial handling remains in Kotlin (requires Android API)
+ * USB Serial handling remains in Kotlin (requires Android API);
+ * network subscribers are served by telemetry_publisher.cpp
+ *
+ * The record is owned by the core owner (core_owner.h); other threads
+ * queue the setters and build frames from the published snapshot.
  */
 
+#define LOG_TAG "NativeTelemetry"
 #include "telemetry.h"
+#include "core_owner.h"
+#include "native_log.h"
+#include <atomic>
 #include <cstring>
-#include <android/log.h>
-
-#define LOG_TAG "NativeTelemetry"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Global Telemetry State
 // ═══════════════════════════════════════════════════════════════════════════
 
 static TelemetryData telem = {0};
-static uint64_t frameCount = 0;
+static std::atomic<uint64_t> frameCount{0};
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Initialization
 // ═══════════════════════════════════════════════════════════════════════════
 
 extern "C" void telemetryInit() {
+    CORE_CHECK_OWNER();
     memset(&telem, 0, sizeof(TelemetryData));
     frameCount = 0;
     LOGI("✅ Native Telemetry initialized");
@@ -38,28 +42,33 @@ extern "C" void telemetryInit() {
 // ═══════════════════════════════════════════════════════════════════════════
 
 extern "C" void telemetrySetTimestamp(uint32_t ts) {
+    CORE_CHECK_OWNER();
     telem.timestamp = ts;
 }
 
 extern "C" void telemetrySetOrientation(float roll, float pitch, float yaw) {
+    CORE_CHECK_OWNER();
     telem.roll = (int16_t)(roll * 10.0f);
     telem.pitch = (int16_t)(pitch * 10.0f);
     telem.yaw = (int16_t)(yaw * 10.0f);
 }
 
 extern "C" void telemetrySetAccelerometer(float x, float y, float z) {
+    CORE_CHECK_OWNER();
     telem.accX = (int16_t)(x * 100.0f);
     telem.accY = (int16_t)(y * 100.0f);
     telem.accZ = (int16_t)(z * 100.0f);
 }
 
 extern "C" void telemetrySetPressure(float pressureHpa, float altitudeM) {
+    CORE_CHECK_OWNER();
     telem.pressure = (uint16_t)pressureHpa;
     telem.baroAltitude = (int16_t)(altitudeM * 10.0f);
 }
 
 extern "C" void telemetrySetGPS(double lat, double lon, float alt, float speed, float heading,
                                  int satellites, int fix, float hdop) {
+    CORE_CHECK_OWNER();
     telem.latitude = (int32_t)(lat * 10000000.0);
     telem.longitude = (int32_t)(lon * 10000000.0);
     telem.gpsAltitude = (int16_t)alt;
@@ -71,6 +80,7 @@ extern "C" void telemetrySetGPS(double lat, double lon, float alt, float speed,
 }
 
 extern "C" void telemetrySetServoCmd(float s1, float s2, float s3, float s4) {
+    CORE_CHECK_OWNER();
     telem.s1Cmd = (int16_t)(s1 * 10.0f);
     telem.s2Cmd = (int16_t)(s2 * 10.0f);
     telem.s3Cmd = (int16_t)(s3 * 10.0f);
@@ -78,6 +88,7 @@ extern "C" void telemetrySetServoCmd(float s1, float s2, float s3, float s4) {
 }
 
 extern "C" void telemetrySetServoFb(float s1, float s2, float s3, float s4) {
+    CORE_CHECK_OWNER();
     telem.s1Fb = (int16_t)(s1 * 10.0f);
     telem.s2Fb = (int16_t)(s2 * 10.0f);
     telem.s3Fb = (int16_t)(s3 * 10.0f);
@@ -85,10 +96,12 @@ extern "C" void telemetrySetServoFb(float s1, float s2, float s3, float s4) {
 }
 
 extern "C" void telemetrySetServoStatus(int online) {
+    CORE_CHECK_OWNER();
     telem.servoOnline = (uint8_t)online;
 }
 
 extern "C" void telemetrySetTracking(int x, int y, int w, int h) {
+    CORE_CHECK_OWNER();
     telem.targetX = (int16_t)x;
     telem.targetY = (int16_t)y;
     telem.targetW = (uint16_t)w;
@@ -96,12 +109,14 @@ extern "C" void telemetrySetTracking(int x, int y, int w, int h) {
 }
 
 extern "C" void telemetrySetBattery(int percent, int charging, int voltageMv) {
+    CORE_CHECK_OWNER();
     telem.batteryPercent = (uint8_t)percent;
     telem.isCharging = (uint8_t)charging;
     telem.batteryVoltage = (uint16_t)voltageMv;
 }
 
 extern "C" void telemetrySetTemperature(float tempC) {
+    CORE_CHECK_OWNER();
     telem.temperature = (int16_t)(tempC * 10.0f);
 }
 
@@ -137,7 +152,8 @@ static inline void writeLE32U(uint8_t* buf, uint32_t val) {
     buf[3] = (val >> 24) & 0xFF;
 }
 
-extern "C" int telemetryBuildFrame(uint8_t* outBuffer, int maxLen) {
+extern "C" int telemetryBuildFrameFrom(const TelemetryData* t, uint8_t* outBuffer, int maxLen) {
+    const TelemetryData& telem = *t;
     if (maxLen < TELEMETRY_FRAME_SIZE) {
         return -1;
     }
@@ -231,17 +247,21 @@ extern "C" int telemetryBuildFrame(uint8_t* outBuffer, int maxLen) {
     }
     outBuffer[idx++] = checksum;
     
-    frameCount++;
+    uint64_t count = frameCount.fetch_add(1, std::memory_order_relaxed) + 1;
     
     // Log every 60 frames
-    if (frameCount % 60 == 0) {
+    if (count % 60 == 0) {
         LOGD("📡 Frame %llu built, roll=%d, pitch=%d", 
-             (unsigned long long)frameCount, telem.roll, telem.pitch);
+             (unsigned long long)count, telem.roll, telem.pitch);
     }
     
     return idx;
 }
 
+extern "C" int telemetryBuildFrame(uint8_t* outBuffer, int maxLen) {
+    return telemetryBuildFrameFrom(&telem, outBuffer, maxLen);
+}
+
 extern "C" void telemetryGetData(TelemetryData* outData) {
     *outData = telem;
 }
@@ -106,6 +106,9 @@ void telemetrySetTemperature(float tempC);
 // Build frame (returns frame size, writes to buffer)
 int telemetryBuildFrame(uint8_t* outBuffer, int maxLen);
 
+// Same, from a copy of the record (CoreSnapshot.telemetry)
+int telemetryBuildFrameFrom(const TelemetryData* data, uint8_t* outBuffer, int maxLen);
+
 // Get raw telemetry data struct
 void telemetryGetData(TelemetryData* outData);
 
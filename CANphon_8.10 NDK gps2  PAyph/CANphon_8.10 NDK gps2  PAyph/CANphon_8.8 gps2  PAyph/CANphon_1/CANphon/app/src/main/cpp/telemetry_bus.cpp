@@ -0,0 +1,213 @@
+/**
+ * telemetry_bus.cpp
+ * Telemetry Broadcast Ring (C++)
+ *
+ * Record N (from 1) lives in slot N & mask. The slot version is 2N-1
+ * while the producer writes it and 2N once written, so a reader knows
+ * from the version alone whether the slot still holds the record it
+ * wants, a newer one (it has been lapped), and whether the copy it took
+ * was torn. Records are copied as 64-bit atomic words.
+ */
+
+#define LOG_TAG "NativeTelemetryBus"
+#include "telemetry_bus.h"
+#include "native_log.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+// A lapped reader restarts this many records short of the oldest one, so
+// it is not overwritten again while the reader catches up
+static const uint64_t SKIP_MARGIN = TELEMETRY_BUS_CAPACITY / 16;
+static const uint64_t MASK = TELEMETRY_BUS_CAPACITY - 1;
+static const int WORDS = sizeof(TelemetryBusRecord) / sizeof(uint64_t);
+
+static_assert((TELEMETRY_BUS_CAPACITY & MASK) == 0, "capacity must be a power of two");
+static_assert(sizeof(TelemetryBusRecord) % sizeof(uint64_t) == 0, "record must be whole words");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Bus State
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct alignas(64) Slot {
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> words[WORDS];
+};
+
+struct alignas(64) LatestSlot {
+    std::atomic<uint32_t> seq;
+    std::atomic<uint64_t> words[WORDS];
+};
+
+struct alignas(64) Consumer {
+    std::atomic<bool> active;
+    uint32_t typeMask;
+    std::atomic<uint64_t> next;         // Next sequence to read (owner thread writes)
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> skipped;
+    char name[24];
+};
+
+static Slot ring[TELEMETRY_BUS_CAPACITY];
+static LatestSlot latest[TELEMETRY_BUS_TYPES];
+static Consumer consumers[TELEMETRY_BUS_MAX_CONSUMERS];
+static std::atomic<uint64_t> head{0};      // Last sequence published
+
+// Serializes subscribe / unsubscribe (never taken by publish or read)
+static std::mutex controlLock;
+
+static void storeWords(std::atomic<uint64_t>* words, const TelemetryBusRecord* record) {
+    uint64_t raw[WORDS];
+    memcpy(raw, record, sizeof(raw));
+    for (int i = 0; i < WORDS; i++) words[i].store(raw[i], std::memory_order_relaxed);
+}
+
+static void loadWords(const std::atomic<uint64_t>* words, TelemetryBusRecord* record) {
+    uint64_t raw[WORDS];
+    for (int i = 0; i < WORDS; i++) raw[i] = words[i].load(std::memory_order_relaxed);
+    memcpy(record, raw, sizeof(raw));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Producer
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" uint64_t telemetryBusPublish(uint32_t type, int64_t timeUs, const double* values, int count) {
+    if (type >= TELEMETRY_BUS_TYPES) return 0;
+    if (count < 0) count = 0;
+    if (count > TELEMETRY_BUS_VALUES) count = TELEMETRY_BUS_VALUES;
+
+    TelemetryBusRecord record;
+    memset(&record, 0, sizeof(record));
+    record.sequence = head.load(std::memory_order_relaxed) + 1;
+    record.timeUs = timeUs;
+    record.type = type;
+    record.count = (uint32_t)count;
+    if (count > 0) memcpy(record.values, values, count * sizeof(double));
+
+    Slot& slot = ring[record.sequence & MASK];
+    slot.version.store(2 * record.sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(slot.words, &record);
+    slot.version.store(2 * record.sequence, std::memory_order_release);
+    head.store(record.sequence, std::memory_order_release);
+
+    LatestSlot& last = latest[type];
+    last.seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(last.words, &record);
+    last.seq.fetch_add(1, std::memory_order_release);
+    return record.sequence;
+}
+
+extern "C" uint64_t telemetryBusPublished() {
+    return head.load(std::memory_order_acquire);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Consumers
+// ═══════════════════════════════════════════════════════════════════════════
+
+// First sequence still safe to read with the producer at h
+static uint64_t oldestReadable(uint64_t h) {
+    uint64_t keep = TELEMETRY_BUS_CAPACITY - SKIP_MARGIN;
+    return h >= keep ? h + 1 - keep : 1;
+}
+
+extern "C" int telemetryBusSubscribe(const char* name, uint32_t typeMask, int fromOldest) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    for (int id = 0; id < TELEMETRY_BUS_MAX_CONSUMERS; id++) {
+        Consumer& c = consumers[id];
+        if (c.active.load(std::memory_order_relaxed)) continue;
+        uint64_t h = head.load(std::memory_order_acquire);
+        c.typeMask = typeMask & TELEMETRY_BUS_ALL_TYPES;
+        c.next.store(fromOldest ? oldestReadable(h) : h + 1, std::memory_order_relaxed);
+        c.received.store(0, std::memory_order_relaxed);
+        c.skipped.store(0, std::memory_order_relaxed);
+        strncpy(c.name, name != nullptr ? name : "", sizeof(c.name) - 1);
+        c.name[sizeof(c.name) - 1] = 0;
+        c.active.store(true, std::memory_order_release);
+        LOGI("Telemetry bus: consumer %d '%s' (types 0x%x)", id, c.name, c.typeMask);
+        return id;
+    }
+    LOGW("Telemetry bus: no free consumer for '%s'", name != nullptr ? name : "");
+    return -1;
+}
+
+extern "C" void telemetryBusUnsubscribe(int id) {
+    if (id < 0 || id >= TELEMETRY_BUS_MAX_CONSUMERS) return;
+    std::lock_guard<std::mutex> guard(controlLock);
+    Consumer& c = consumers[id];
+    if (!c.active.load(std::memory_order_relaxed)) return;
+    c.active.store(false, std::memory_order_release);
+    LOGI("Telemetry bus: consumer %d '%s' closed (%llu received, %llu skipped)", id, c.name,
+         (unsigned long long)c.received.load(std::memory_order_relaxed),
+         (unsigned long long)c.skipped.load(std::memory_order_relaxed));
+}
+
+extern "C" int telemetryBusRead(int id, TelemetryBusRecord* out, int max) {
+    if (id < 0 || id >= TELEMETRY_BUS_MAX_CONSUMERS || out == nullptr) return -1;
+    Consumer& c = consumers[id];
+    if (!c.active.load(std::memory_order_acquire)) return -1;
+
+    uint64_t next = c.next.load(std::memory_order_relaxed);
+    uint64_t received = 0, skipped = 0;
+    uint64_t h = head.load(std::memory_order_acquire);
+    int n = 0;
+    while (n < max && next <= h) {
+        if (next < oldestReadable(h)) {
+            skipped += oldestReadable(h) - next;
+            next = oldestReadable(h);
+            continue;
+        }
+        const Slot& slot = ring[next & MASK];
+        uint64_t v = slot.version.load(std::memory_order_acquire);
+        if (v == 2 * next) {
+            loadWords(slot.words, &out[n]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == v) {
+                if (c.typeMask & (1u << out[n].type)) {
+                    n++;
+                    received++;
+                }
+                next++;
+                continue;
+            }
+        }
+        // Overwritten while we got here: the producer is at least a ring ahead
+        h = head.load(std::memory_order_acquire);
+        uint64_t target = oldestReadable(h > next + MASK ? h : next + MASK);
+        skipped += target - next;
+        next = target;
+    }
+
+    c.next.store(next, std::memory_order_relaxed);
+    if (received > 0) c.received.fetch_add(received, std::memory_order_relaxed);
+    if (skipped > 0) c.skipped.fetch_add(skipped, std::memory_order_relaxed);
+    return n;
+}
+
+extern "C" void telemetryBusConsumerStats(int id, TelemetryBusConsumerStats* outStats) {
+    memset(outStats, 0, sizeof(*outStats));
+    uint64_t h = head.load(std::memory_order_acquire);
+    outStats->published = h;
+    if (id < 0 || id >= TELEMETRY_BUS_MAX_CONSUMERS) return;
+    const Consumer& c = consumers[id];
+    if (!c.active.load(std::memory_order_acquire)) return;
+    uint64_t next = c.next.load(std::memory_order_relaxed);
+    outStats->received = c.received.load(std::memory_order_relaxed);
+    outStats->skipped = c.skipped.load(std::memory_order_relaxed);
+    outStats->lag = h + 1 > next ? h + 1 - next : 0;
+}
+
+extern "C" int telemetryBusLatest(uint32_t type, TelemetryBusRecord* out) {
+    if (type >= TELEMETRY_BUS_TYPES || out == nullptr) return 0;
+    const LatestSlot& last = latest[type];
+    uint32_t s;
+    do {
+        s = last.seq.load(std::memory_order_acquire);
+        loadWords(last.words, out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((s & 1) || s != last.seq.load(std::memory_order_relaxed));
+    return s != 0;
+}
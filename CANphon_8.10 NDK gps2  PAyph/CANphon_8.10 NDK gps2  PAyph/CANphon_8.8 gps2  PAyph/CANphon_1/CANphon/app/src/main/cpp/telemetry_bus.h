@@ -0,0 +1,88 @@
+/**
+ * telemetry_bus.h
+ * Telemetry Broadcast Ring (C++)
+ *
+ * One producer publishes typed telemetry records (attitude, servo, GPS,
+ * tracking, power, stage deadlines) into a fixed ring; any number of
+ * consumers (USB / CSV logger / charts / UI) read them through their own
+ * cursor at their own rate. Nothing is locked: every slot is a seqlock,
+ * so the producer never waits for a reader, and a reader that falls a
+ * whole ring behind skips ahead to the oldest record still there
+ * (counted as skipped).
+ *
+ * The latest record of each type is also kept on its own, for readers
+ * that only show current values.
+ */
+
+#ifndef TELEMETRY_BUS_H
+#define TELEMETRY_BUS_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_BUS_CAPACITY 1024         // Records (power of two, ~3 s of all types at 60 Hz)
+#define TELEMETRY_BUS_VALUES 12
+#define TELEMETRY_BUS_MAX_CONSUMERS 16
+
+// Record types (bit N of a consumer's type mask = type N)
+#define TELEMETRY_BUS_ATTITUDE 0            // roll, pitch, yaw (°), accX, accY, accZ (g)
+#define TELEMETRY_BUS_SERVO 1               // cmd 1-4 (°), feedback 1-4 (°), online mask
+#define TELEMETRY_BUS_GPS 2                 // lat, lon (°), alt (m), speed (m/s), heading (°), satellites, fix, hdop
+#define TELEMETRY_BUS_TRACKING 3            // x, y, w, h (px, x = -1 without target)
+#define TELEMETRY_BUS_POWER 4               // battery %, charging, voltage (mV), temperature (°C), pressure (hPa), baro alt (m)
+#define TELEMETRY_BUS_DEADLINE 5            // misses per stage (6), active policy mask, detections skipped, sends held, predicted ticks
+#define TELEMETRY_BUS_TYPES 6
+#define TELEMETRY_BUS_ALL_TYPES ((1u << TELEMETRY_BUS_TYPES) - 1)
+
+typedef struct {
+    uint64_t sequence;      // Set by telemetryBusPublish, from 1
+    int64_t timeUs;         // Producer's clock (canRecorderNowUs in the app)
+    uint32_t type;
+    uint32_t count;         // Values used
+    double values[TELEMETRY_BUS_VALUES];
+} TelemetryBusRecord;
+
+typedef struct {
+    uint64_t published;
+    uint64_t received;      // Per consumer: records handed out (after the type filter)
+    uint64_t skipped;       // Records overwritten before this consumer got to them
+    uint64_t lag;           // Records published but not yet read
+} TelemetryBusConsumerStats;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Producer (one thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Returns the record's sequence number
+uint64_t telemetryBusPublish(uint32_t type, int64_t timeUs, const double* values, int count);
+
+uint64_t telemetryBusPublished();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Consumers (each id used by one thread)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Register a consumer reading the types in typeMask, from the next record
+// published (fromOldest = 0) or from the oldest still in the ring.
+// Returns its id, -1 if all TELEMETRY_BUS_MAX_CONSUMERS are taken
+int telemetryBusSubscribe(const char* name, uint32_t typeMask, int fromOldest);
+
+void telemetryBusUnsubscribe(int id);
+
+// Copy up to max records after this consumer's cursor (oldest first) and
+// advance it. Returns the count, 0 if nothing new, -1 for a bad id
+int telemetryBusRead(int id, TelemetryBusRecord* out, int max);
+
+void telemetryBusConsumerStats(int id, TelemetryBusConsumerStats* outStats);
+
+// Newest record of a type (any thread, no cursor). Returns 0 if none yet
+int telemetryBusLatest(uint32_t type, TelemetryBusRecord* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_BUS_H
@@ -0,0 +1,578 @@
+/**
+ * telemetry_publisher.cpp
+ * Network Telemetry Publisher (C++)
+ *
+ * Callers stamp and queue records under a short lock and poke an
+ * eventfd. The publisher thread takes up to maxBatch records at a time,
+ * sends them to every UDP target in one sendmmsg call, and appends them
+ * to each TCP client's buffer, which is drained without blocking.
+ */
+
+#define LOG_TAG "NativeTelemetryPub"
+#include "telemetry_publisher.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Publisher State
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint8_t bytes[TELEMETRY_PUB_RECORD_SIZE];
+    int64_t queuedUs;       // Monotonic, for the latency stats
+} Record;
+
+typedef struct {
+    int fd;                 // -1 = free slot
+    int length;
+    uint8_t buffer[TELEMETRY_PUB_CLIENT_BUFFER];
+} Client;
+
+static pthread_mutex_t controlLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t thread;
+static bool started = false;
+
+static TelemetryPublisherConfig config;
+static int wakeFd = -1;
+static int udpFd = -1;
+static int listenFd = -1;
+static struct sockaddr_in targets[TELEMETRY_PUB_MAX_TARGETS];
+static int targetCount = 0;
+static std::atomic<bool> stopRequested(false);
+static std::atomic<bool> running(false);
+
+// Queue (callers and the thread, under queueLock)
+static pthread_mutex_t queueLock = PTHREAD_MUTEX_INITIALIZER;
+static Record queue[TELEMETRY_PUB_QUEUE];
+static uint32_t queueHead = 0;
+static uint32_t queueTail = 0;
+static uint32_t nextSequence = 0;
+static bool accepting = false;      // wakeFd is open
+
+// Thread only
+static Client clients[TELEMETRY_PUB_MAX_CLIENTS];
+
+static std::atomic<uint64_t> published(0);
+static std::atomic<uint64_t> queueDrops(0);
+static std::atomic<uint64_t> udpDatagrams(0);
+static std::atomic<uint64_t> udpCalls(0);
+static std::atomic<uint64_t> udpErrors(0);
+static std::atomic<uint64_t> tcpAccepted(0);
+static std::atomic<uint64_t> tcpDisconnects(0);
+static std::atomic<uint64_t> tcpBytes(0);
+static std::atomic<uint64_t> tcpDrops(0);
+static std::atomic<uint64_t> latencyCount(0);
+static std::atomic<int64_t> latencySumUs(0);
+static std::atomic<int64_t> latencyMaxUs(0);
+static std::atomic<int32_t> tcpClients(0);
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+extern "C" int64_t telemetryPublisherClockUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void writeLE32(uint8_t* buf, uint32_t val) {
+    buf[0] = val & 0xFF;
+    buf[1] = (val >> 8) & 0xFF;
+    buf[2] = (val >> 16) & 0xFF;
+    buf[3] = (val >> 24) & 0xFF;
+}
+
+static inline uint32_t readLE32(const uint8_t* buf) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Sockets
+// ═══════════════════════════════════════════════════════════════════════════
+
+// "host[:port],host[:port]" → targets. Returns the count, -1 on a bad entry
+static int parseTargets(const char* list, int defaultPort) {
+    char copy[sizeof(config.udpTargets)];
+    strncpy(copy, list, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = '\0';
+
+    int count = 0;
+    char* save = nullptr;
+    for (char* item = strtok_r(copy, ",", &save); item != nullptr; item = strtok_r(nullptr, ",", &save)) {
+        while (*item == ' ') item++;
+        if (*item == '\0') continue;
+        if (count == TELEMETRY_PUB_MAX_TARGETS) return -1;
+
+        int port = defaultPort;
+        char* colon = strchr(item, ':');
+        if (colon != nullptr) {
+            *colon = '\0';
+            port = atoi(colon + 1);
+        }
+        struct sockaddr_in* addr = &targets[count];
+        memset(addr, 0, sizeof(*addr));
+        addr->sin_family = AF_INET;
+        addr->sin_port = htons((uint16_t)port);
+        if (port <= 0 || port > 65535 || inet_pton(AF_INET, item, &addr->sin_addr) != 1) {
+            LOGW("Bad UDP target '%s'", item);
+            return -1;
+        }
+        count++;
+    }
+    return count;
+}
+
+static int openUdp() {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    for (int i = 0; i < targetCount; i++) {
+        if (!IN_MULTICAST(ntohl(targets[i].sin_addr.s_addr))) continue;
+        int ttl = config.multicastTtl > 0 ? config.multicastTtl : 1;
+        int loop = 1;   // Subscribers on this host see the group too
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        break;
+    }
+    return fd;
+}
+
+static int openListener() {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)config.tcpPort);
+    addr.sin_addr.s_addr = htonl(config.tcpLoopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, TELEMETRY_PUB_MAX_CLIENTS) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void closeClient(Client* c) {
+    close(c->fd);
+    c->fd = -1;
+    c->length = 0;
+    tcpClients.fetch_sub(1, std::memory_order_relaxed);
+    tcpDisconnects.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void acceptClients() {
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+
+        Client* slot = nullptr;
+        for (auto& c : clients) {
+            if (c.fd < 0) {
+                slot = &c;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            close(fd);
+            LOGW("TCP subscriber refused: %d connected", TELEMETRY_PUB_MAX_CLIENTS);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        slot->fd = fd;
+        slot->length = 0;
+        tcpClients.fetch_add(1, std::memory_order_relaxed);
+        tcpAccepted.fetch_add(1, std::memory_order_relaxed);
+        LOGI("TCP subscriber connected (%d)", tcpClients.load(std::memory_order_relaxed));
+    }
+}
+
+// Send what the socket takes now; the rest waits for POLLOUT
+static void flushClient(Client* c) {
+    int offset = 0;
+    while (offset < c->length) {
+        ssize_t n = send(c->fd, c->buffer + offset, (size_t)(c->length - offset), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            offset += (int)n;
+            tcpBytes.fetch_add((uint64_t)n, std::memory_order_relaxed);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeClient(c);
+            return;
+        }
+    }
+    if (offset > 0) {
+        memmove(c->buffer, c->buffer + offset, (size_t)(c->length - offset));
+        c->length -= offset;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Publisher Thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void sendBatch(const Record* batch, int count) {
+    TRACE_ZONE("publish.send");
+    if (udpFd >= 0 && targetCount > 0) {
+        struct iovec iov[TELEMETRY_PUB_MAX_BATCH];
+        struct mmsghdr msgs[TELEMETRY_PUB_MAX_BATCH * TELEMETRY_PUB_MAX_TARGETS];
+        int total = 0;
+        for (int r = 0; r < count; r++) {
+            iov[r].iov_base = (void*)batch[r].bytes;
+            iov[r].iov_len = TELEMETRY_PUB_RECORD_SIZE;
+            for (int t = 0; t < targetCount; t++) {
+                struct msghdr* h = &msgs[total].msg_hdr;
+                memset(h, 0, sizeof(*h));
+                h->msg_name = &targets[t];
+                h->msg_namelen = sizeof(targets[t]);
+                h->msg_iov = &iov[r];
+                h->msg_iovlen = 1;
+                total++;
+            }
+        }
+        int offset = 0;
+        while (offset < total) {
+            int sent = sendmmsg(udpFd, msgs + offset, (unsigned)(total - offset), MSG_DONTWAIT);
+            udpCalls.fetch_add(1, std::memory_order_relaxed);
+            if (sent > 0) {
+                offset += sent;
+                udpDatagrams.fetch_add((uint64_t)sent, std::memory_order_relaxed);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                offset++;   // Skip the datagram that failed (full buffer, unreachable target)
+                udpErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (auto& c : clients) {
+        if (c.fd < 0) continue;
+        for (int r = 0; r < count; r++) {
+            if (c.length + TELEMETRY_PUB_RECORD_SIZE > TELEMETRY_PUB_CLIENT_BUFFER) {
+                tcpDrops.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            memcpy(c.buffer + c.length, batch[r].bytes, TELEMETRY_PUB_RECORD_SIZE);
+            c.length += TELEMETRY_PUB_RECORD_SIZE;
+        }
+        flushClient(&c);
+    }
+
+    int64_t nowUs = monotonicUs();
+    for (int r = 0; r < count; r++) {
+        int64_t latencyUs = nowUs - batch[r].queuedUs;
+        latencySumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+        if (latencyUs > latencyMaxUs.load(std::memory_order_relaxed)) {
+            latencyMaxUs.store(latencyUs, std::memory_order_relaxed);
+        }
+    }
+    latencyCount.fetch_add((uint64_t)count, std::memory_order_relaxed);
+}
+
+static void* publisherLoop(void*) {
+    static Record batch[TELEMETRY_PUB_MAX_BATCH];
+    struct pollfd fds[2 + TELEMETRY_PUB_MAX_CLIENTS];
+    Client* polled[TELEMETRY_PUB_MAX_CLIENTS];
+    traceSetThreadName("telemetry-pub");
+
+    while (!stopRequested.load(std::memory_order_acquire)) {
+        // Send when a batch is full or the oldest record is due
+        pthread_mutex_lock(&queueLock);
+        uint32_t pending = queueHead - queueTail;
+        int64_t oldestUs = pending > 0 ? queue[queueTail % TELEMETRY_PUB_QUEUE].queuedUs : 0;
+        int64_t waitUs = -1;
+        if (pending > 0) {
+            waitUs = pending >= (uint32_t)config.maxBatch ? 0 : oldestUs + config.maxDelayUs - monotonicUs();
+            if (waitUs <= 0) {
+                int count = (int)(pending < (uint32_t)config.maxBatch ? pending : (uint32_t)config.maxBatch);
+                for (int i = 0; i < count; i++) batch[i] = queue[(queueTail + i) % TELEMETRY_PUB_QUEUE];
+                queueTail += (uint32_t)count;
+                pthread_mutex_unlock(&queueLock);
+                sendBatch(batch, count);
+                continue;
+            }
+        }
+        pthread_mutex_unlock(&queueLock);
+
+        int n = 0;
+        fds[n++] = {wakeFd, POLLIN, 0};
+        if (listenFd >= 0) fds[n++] = {listenFd, POLLIN, 0};
+        int firstClient = n;
+        for (auto& c : clients) {
+            if (c.fd < 0) continue;
+            polled[n - firstClient] = &c;
+            fds[n++] = {c.fd, (short)(POLLIN | (c.length > 0 ? POLLOUT : 0)), 0};
+        }
+
+        struct timespec timeout = {(time_t)(waitUs / 1000000), (long)(waitUs % 1000000) * 1000};
+        int ready = ppoll(fds, (nfds_t)n, waitUs >= 0 ? &timeout : nullptr, nullptr);
+        if (ready <= 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            uint64_t value;
+            ssize_t ignored = read(wakeFd, &value, sizeof(value));
+            (void)ignored;
+        }
+        if (listenFd >= 0 && (fds[1].revents & POLLIN)) acceptClients();
+        for (int i = firstClient; i < n; i++) {
+            Client* c = polled[i - firstClient];
+            if (c->fd < 0 || fds[i].revents == 0) continue;
+            if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                closeClient(c);
+                continue;
+            }
+            if (fds[i].revents & POLLIN) {
+                // Subscribers do not send; a read of 0 is the hang-up
+                uint8_t scratch[256];
+                ssize_t r = recv(c->fd, scratch, sizeof(scratch), MSG_DONTWAIT);
+                if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    closeClient(c);
+                    continue;
+                }
+            }
+            if (fds[i].revents & POLLOUT) flushClient(c);
+        }
+    }
+
+    running.store(false, std::memory_order_release);
+    return nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void closeSockets() {
+    for (auto& c : clients) {
+        if (c.fd >= 0) close(c.fd);
+        c.fd = -1;
+        c.length = 0;
+    }
+    tcpClients = 0;
+    if (listenFd >= 0) close(listenFd);
+    if (udpFd >= 0) close(udpFd);
+    if (wakeFd >= 0) close(wakeFd);
+    listenFd = -1;
+    udpFd = -1;
+    wakeFd = -1;
+    targetCount = 0;
+}
+
+extern "C" void telemetryPublisherDefaultConfig(TelemetryPublisherConfig* c) {
+    memset(c, 0, sizeof(*c));
+    snprintf(c->udpTargets, sizeof(c->udpTargets), "127.0.0.1:%d", TELEMETRY_PUB_DEFAULT_UDP_PORT);
+    c->multicastTtl = 1;
+    c->tcpPort = TELEMETRY_PUB_DEFAULT_TCP_PORT;
+    c->tcpLoopbackOnly = 1;
+    c->maxBatch = 8;
+    c->maxDelayUs = 0;
+}
+
+extern "C" int telemetryPublisherStart(const TelemetryPublisherConfig* c) {
+    pthread_mutex_lock(&controlLock);
+    if (started) {
+        pthread_mutex_unlock(&controlLock);
+        LOGW("Telemetry publisher already running");
+        return 0;
+    }
+
+    if (c != nullptr) config = *c;
+    else telemetryPublisherDefaultConfig(&config);
+    config.udpTargets[sizeof(config.udpTargets) - 1] = '\0';
+    if (config.maxBatch < 1) config.maxBatch = 1;
+    if (config.maxBatch > TELEMETRY_PUB_MAX_BATCH) config.maxBatch = TELEMETRY_PUB_MAX_BATCH;
+    if (config.maxDelayUs < 0) config.maxDelayUs = 0;
+    for (auto& client : clients) {
+        client.fd = -1;
+        client.length = 0;
+    }
+
+    targetCount = parseTargets(config.udpTargets, TELEMETRY_PUB_DEFAULT_UDP_PORT);
+    if (targetCount < 0 || (targetCount == 0 && config.tcpPort <= 0)) {
+        targetCount = 0;
+        pthread_mutex_unlock(&controlLock);
+        LOGW("❌ Telemetry publisher: no usable UDP target or TCP port");
+        return 0;
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (targetCount > 0) udpFd = openUdp();
+    if (config.tcpPort > 0) listenFd = openListener();
+    if (wakeFd < 0 || (targetCount > 0 && udpFd < 0) || (config.tcpPort > 0 && listenFd < 0)) {
+        LOGW("❌ Telemetry publisher sockets: %s", strerror(errno));
+        closeSockets();
+        pthread_mutex_unlock(&controlLock);
+        return 0;
+    }
+
+    published = 0;
+    queueDrops = 0;
+    udpDatagrams = 0;
+    udpCalls = 0;
+    udpErrors = 0;
+    tcpAccepted = 0;
+    tcpDisconnects = 0;
+    tcpBytes = 0;
+    tcpDrops = 0;
+    latencyCount = 0;
+    latencySumUs = 0;
+    latencyMaxUs = 0;
+    stopRequested = false;
+    running = true;
+
+    pthread_mutex_lock(&queueLock);
+    queueHead = 0;
+    queueTail = 0;
+    nextSequence = 0;
+    accepting = true;
+    pthread_mutex_unlock(&queueLock);
+
+    if (pthread_create(&thread, nullptr, publisherLoop, nullptr) != 0) {
+        pthread_mutex_lock(&queueLock);
+        accepting = false;
+        pthread_mutex_unlock(&queueLock);
+        running = false;
+        closeSockets();
+        pthread_mutex_unlock(&controlLock);
+        LOGW("❌ pthread_create failed: %s", strerror(errno));
+        return 0;
+    }
+    started = true;
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("✅ Telemetry publisher: UDP '%s' (%d targets), TCP %s:%d, batch %d / %d us",
+         config.udpTargets, targetCount, config.tcpLoopbackOnly ? "127.0.0.1" : "*", config.tcpPort,
+         config.maxBatch, config.maxDelayUs);
+    return 1;
+}
+
+extern "C" void telemetryPublisherStop() {
+    pthread_mutex_lock(&controlLock);
+    if (!started) {
+        pthread_mutex_unlock(&controlLock);
+        return;
+    }
+
+    pthread_mutex_lock(&queueLock);
+    accepting = false;
+    pthread_mutex_unlock(&queueLock);
+
+    stopRequested = true;
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+    pthread_join(thread, nullptr);
+    started = false;
+    closeSockets();
+    pthread_mutex_unlock(&controlLock);
+
+    LOGI("Telemetry publisher stopped: %llu records, %llu datagrams in %llu calls, %llu TCP bytes",
+         (unsigned long long)published.load(), (unsigned long long)udpDatagrams.load(),
+         (unsigned long long)udpCalls.load(), (unsigned long long)tcpBytes.load());
+}
+
+extern "C" int telemetryPublisherRunning() {
+    return running.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+extern "C" int64_t telemetryPublisherPublish(const uint8_t* frame, int length) {
+    if (frame == nullptr || length != TELEMETRY_FRAME_SIZE) return -1;
+    int64_t publishUs = telemetryPublisherClockUs();
+    int64_t queuedUs = monotonicUs();
+
+    pthread_mutex_lock(&queueLock);
+    if (!accepting) {
+        pthread_mutex_unlock(&queueLock);
+        return -1;
+    }
+    if (queueHead - queueTail >= TELEMETRY_PUB_QUEUE) {
+        pthread_mutex_unlock(&queueLock);
+        queueDrops.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+    uint32_t sequence = nextSequence++;
+    Record* r = &queue[queueHead % TELEMETRY_PUB_QUEUE];
+    r->bytes[0] = TELEMETRY_PUB_MAGIC & 0xFF;
+    r->bytes[1] = TELEMETRY_PUB_MAGIC >> 8;
+    r->bytes[2] = TELEMETRY_PUB_VERSION;
+    r->bytes[3] = 0;
+    writeLE32(&r->bytes[4], sequence);
+    writeLE32(&r->bytes[8], (uint32_t)publishUs);
+    writeLE32(&r->bytes[12], (uint32_t)((uint64_t)publishUs >> 32));
+    memcpy(&r->bytes[TELEMETRY_PUB_HEADER_SIZE], frame, TELEMETRY_FRAME_SIZE);
+    r->queuedUs = queuedUs;
+    queueHead++;
+
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+    pthread_mutex_unlock(&queueLock);
+
+    published.fetch_add(1, std::memory_order_relaxed);
+    return sequence;
+}
+
+extern "C" void telemetryPublisherGetStats(TelemetryPublisherStats* out) {
+    out->published = published.load(std::memory_order_relaxed);
+    out->queueDrops = queueDrops.load(std::memory_order_relaxed);
+    out->udpDatagrams = udpDatagrams.load(std::memory_order_relaxed);
+    out->udpCalls = udpCalls.load(std::memory_order_relaxed);
+    out->udpErrors = udpErrors.load(std::memory_order_relaxed);
+    out->tcpAccepted = tcpAccepted.load(std::memory_order_relaxed);
+    out->tcpDisconnects = tcpDisconnects.load(std::memory_order_relaxed);
+    out->tcpBytes = tcpBytes.load(std::memory_order_relaxed);
+    out->tcpDrops = tcpDrops.load(std::memory_order_relaxed);
+    uint64_t sent = latencyCount.load(std::memory_order_relaxed);
+    out->latencyMeanUs = sent > 0 ? latencySumUs.load(std::memory_order_relaxed) / (int64_t)sent : 0;
+    out->latencyMaxUs = latencyMaxUs.load(std::memory_order_relaxed);
+    out->tcpClients = tcpClients.load(std::memory_order_relaxed);
+    out->udpTargets = targetCount;
+    out->running = telemetryPublisherRunning();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Record Parsing (subscribers)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" int telemetryRecordParse(const uint8_t* record, int length, uint32_t* outSequence,
+                                    int64_t* outPublishUs, const uint8_t** outFrame) {
+    if (length < TELEMETRY_PUB_RECORD_SIZE) return 0;
+    if (record[0] != (TELEMETRY_PUB_MAGIC & 0xFF) || record[1] != (TELEMETRY_PUB_MAGIC >> 8)) return 0;
+    if (record[2] != TELEMETRY_PUB_VERSION) return 0;
+
+    const uint8_t* frame = record + TELEMETRY_PUB_HEADER_SIZE;
+    if (frame[0] != TELEMETRY_HEADER_1 || frame[1] != TELEMETRY_HEADER_2) return 0;
+    uint8_t checksum = 0;
+    for (int i = 0; i < TELEMETRY_FRAME_SIZE - 1; i++) checksum ^= frame[i];
+    if (checksum != frame[TELEMETRY_FRAME_SIZE - 1]) return 0;
+
+    if (outSequence != nullptr) *outSequence = readLE32(record + 4);
+    if (outPublishUs != nullptr) {
+        *outPublishUs = (int64_t)((uint64_t)readLE32(record + 8) | ((uint64_t)readLE32(record + 12) << 32));
+    }
+    if (outFrame != nullptr) *outFrame = frame;
+    return 1;
+}
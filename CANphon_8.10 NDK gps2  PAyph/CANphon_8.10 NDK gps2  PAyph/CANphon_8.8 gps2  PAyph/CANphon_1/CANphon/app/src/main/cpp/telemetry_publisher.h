@@ -0,0 +1,102 @@
+/**
+ * telemetry_publisher.h
+ * Network Telemetry Publisher (C++)
+ *
+ * Publishes the 73-byte telemetry frame (telemetry.h / TelemetryStreamer)
+ * to any number of subscribers next to the USB-serial radio:
+ *   UDP  - unicast and / or multicast targets, batched with sendmmsg
+ *   TCP  - listener, the same records back to back on each connection
+ *
+ * Every record carries a header with a sequence number and the publish
+ * time, so subscribers can measure rate, loss and latency:
+ *   [magic 2B "CT"][version 1B][flags 1B][sequence 4B][publish time 8B]
+ *   [telemetry frame 73B]                                   all LE
+ *
+ * publish() only copies into a queue; a publisher thread does all
+ * socket work. A slow TCP client loses whole records, never the stream
+ * framing, and never delays UDP or the caller.
+ */
+
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <cstdint>
+#include "telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_PUB_MAGIC 0x5443              // "CT"
+#define TELEMETRY_PUB_VERSION 1
+#define TELEMETRY_PUB_HEADER_SIZE 16
+#define TELEMETRY_PUB_RECORD_SIZE (TELEMETRY_PUB_HEADER_SIZE + TELEMETRY_FRAME_SIZE)
+
+#define TELEMETRY_PUB_DEFAULT_UDP_PORT 14573
+#define TELEMETRY_PUB_DEFAULT_TCP_PORT 14574
+#define TELEMETRY_PUB_MAX_TARGETS 4             // UDP destinations
+#define TELEMETRY_PUB_MAX_CLIENTS 4             // TCP connections
+#define TELEMETRY_PUB_MAX_BATCH 32              // Records per sendmmsg
+#define TELEMETRY_PUB_QUEUE 256                 // Records waiting for the thread (~4 s at 60 Hz)
+#define TELEMETRY_PUB_CLIENT_BUFFER 16384       // Unsent bytes kept per TCP client
+
+typedef struct {
+    // Comma-separated "host[:port]" IPv4 targets, unicast or multicast
+    // group (e.g. "127.0.0.1,239.255.0.73"). Empty = no UDP
+    char udpTargets[128];
+    int multicastTtl;       // Hops for multicast targets (1 = local network)
+    int tcpPort;            // Listening port, 0 = no TCP
+    int tcpLoopbackOnly;    // Listen on 127.0.0.1 only (adb forward), else any address
+    int maxBatch;           // Records per sendmmsg call (1..TELEMETRY_PUB_MAX_BATCH)
+    int maxDelayUs;         // Hold a record up to this long to fill a batch, 0 = send at once
+} TelemetryPublisherConfig;
+
+typedef struct {
+    uint64_t published;     // Records accepted by telemetryPublisherPublish
+    uint64_t queueDrops;    // Records dropped because the queue was full
+    uint64_t udpDatagrams;
+    uint64_t udpCalls;      // sendmmsg calls (datagrams / calls = batching)
+    uint64_t udpErrors;
+    uint64_t tcpAccepted;
+    uint64_t tcpDisconnects;
+    uint64_t tcpBytes;
+    uint64_t tcpDrops;      // Records not queued for a client that fell behind
+    int64_t latencyMeanUs;  // Publish call → handed to the sockets
+    int64_t latencyMaxUs;
+    int32_t tcpClients;
+    int32_t udpTargets;
+    int32_t running;
+} TelemetryPublisherStats;
+
+void telemetryPublisherDefaultConfig(TelemetryPublisherConfig* config);
+
+// Open the sockets and start the publisher thread. Returns 1 on success,
+// 0 if already running, nothing is configured, a target does not parse
+// or a socket cannot be opened
+int telemetryPublisherStart(const TelemetryPublisherConfig* config);
+
+// Stop the thread and close every socket
+void telemetryPublisherStop();
+
+int telemetryPublisherRunning();
+
+// Queue one frame (any thread). Returns its sequence number, or -1 if
+// not running, the frame size is wrong or the queue is full
+int64_t telemetryPublisherPublish(const uint8_t* frame, int length);
+
+void telemetryPublisherGetStats(TelemetryPublisherStats* outStats);
+
+// Split a received record. Returns 1 if magic, version and the frame
+// checksum are valid
+int telemetryRecordParse(const uint8_t* record, int length, uint32_t* outSequence, int64_t* outPublishUs,
+                         const uint8_t** outFrame);
+
+// Wall clock in microseconds (record publish time, so subscribers on
+// another host can compare against their own synchronized clock)
+int64_t telemetryPublisherClockUs();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_PUBLISHER_H
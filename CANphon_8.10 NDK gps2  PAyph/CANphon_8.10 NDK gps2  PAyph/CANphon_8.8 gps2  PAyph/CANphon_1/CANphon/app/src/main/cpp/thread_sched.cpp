@@ -0,0 +1,40 @@
+/**
+ * thread_sched.cpp
+ * Native Worker Thread Scheduling (C++)
+ */
+
+#define LOG_TAG "NativeSched"
+#include "thread_sched.h"
+#include "native_log.h"
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+
+extern "C" int threadApplyScheduling(int tid, int niceValue, int rtPriority, uint32_t cpuMask) {
+    if (cpuMask != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 32; cpu++) {
+            if (cpuMask & (1u << cpu)) CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            LOGW("CPU mask 0x%X not applied: %s", cpuMask, strerror(errno));
+        }
+    }
+
+    if (rtPriority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = rtPriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) return 1;
+        LOGW("SCHED_FIFO %d refused (%s), using nice %d", rtPriority, strerror(errno), niceValue);
+    }
+
+    // Linux nice is per thread when addressed by tid
+    if (setpriority(PRIO_PROCESS, (id_t)tid, niceValue) != 0) {
+        LOGW("nice %d not applied: %s", niceValue, strerror(errno));
+    }
+    return 0;
+}
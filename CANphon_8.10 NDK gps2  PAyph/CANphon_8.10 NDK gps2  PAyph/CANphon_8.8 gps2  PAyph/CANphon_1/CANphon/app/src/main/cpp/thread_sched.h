@@ -0,0 +1,27 @@
+/**
+ * thread_sched.h
+ * Native Worker Thread Scheduling (C++)
+ *
+ * Shared by the receive and control threads: CPU affinity, then SCHED_FIFO
+ * when requested and allowed, otherwise a per-thread nice value.
+ */
+
+#ifndef THREAD_SCHED_H
+#define THREAD_SCHED_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Apply to the calling thread (tid = gettid()). rtPriority 0 = nice only,
+// cpuMask bit N = may run on CPU N, 0 = any CPU.
+// Returns 1 if SCHED_FIFO was granted
+int threadApplyScheduling(int tid, int niceValue, int rtPriority, uint32_t cpuMask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREAD_SCHED_H
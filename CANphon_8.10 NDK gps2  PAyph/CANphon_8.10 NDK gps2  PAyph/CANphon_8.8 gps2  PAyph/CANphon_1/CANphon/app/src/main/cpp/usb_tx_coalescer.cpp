@@ -0,0 +1,327 @@
+/**
+ * usb_tx_coalescer.cpp
+ * USB Write Coalescer (C++)
+ *
+ * A byte ring (callers append under the lock) plus a mark per frame with
+ * its end offset and queue time. The thread takes at most one transfer
+ * out of the ring at a time, writes it without the lock, then retires
+ * every frame whose last byte went out and records its queueing delay.
+ */
+
+#define LOG_TAG "NativeUsbTx"
+#include "usb_tx_coalescer.h"
+#include "native_log.h"
+#include "native_trace.h"
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/usbdevice_fs.h>
+#include <sys/ioctl.h>
+#endif
+
+#define USB_TX_MARKS 1024   // Frames pending at most (power of two)
+
+typedef struct {
+    uint64_t end;           // Stream offset after the frame's last byte
+    int64_t queuedUs;
+} FrameMark;
+
+struct UsbTxCoalescer {
+    UsbTxConfig config;
+    UsbTxWriteFn writeFn = nullptr;
+    void* context = nullptr;
+    int usbFd = -1;         // usbTxOpenUsb
+    unsigned int epOut = 0;
+
+    std::mutex lock;
+    std::condition_variable wake;       // Work for the thread
+    std::condition_variable drained;    // Everything written (usbTxFlush)
+    std::thread thread;
+    bool stop = false;
+    bool failed = false;
+    bool flushRequested = false;
+
+    // Stream offsets: queued by callers, taken by the thread, written to the device
+    uint8_t* ring = nullptr;
+    uint64_t ringMask = 0;
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    uint64_t done = 0;
+    FrameMark marks[USB_TX_MARKS];
+    uint64_t markHead = 0;
+    uint64_t markTail = 0;
+
+    UsbTxStats stats;
+    int64_t delaySumUs = 0;
+    uint32_t histogram[USB_TX_DELAY_BUCKETS];
+    int64_t startUs = 0;
+    uint8_t tx[USB_TX_MAX_TRANSFER];
+};
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int usbBulkWrite(void* context, const uint8_t* data, int length, int timeoutMs) {
+#ifdef __linux__
+    UsbTxCoalescer* c = (UsbTxCoalescer*)context;
+    struct usbdevfs_bulktransfer bulk;
+    bulk.ep = c->epOut;
+    bulk.len = (unsigned)length;
+    bulk.timeout = (unsigned)timeoutMs;
+    bulk.data = (void*)data;
+    return ioctl(c->usbFd, USBDEVFS_BULK, &bulk);
+#else
+    (void)context;
+    (void)data;
+    (void)length;
+    (void)timeoutMs;
+    errno = ENODEV;
+    return -1;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Coalescer Thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void retireFrames(UsbTxCoalescer* c, int64_t writtenUs) {
+    while (c->markTail != c->markHead) {
+        const FrameMark* m = &c->marks[c->markTail & (USB_TX_MARKS - 1)];
+        if (m->end > c->done) break;
+        int64_t delayUs = writtenUs - m->queuedUs;
+        c->delaySumUs += delayUs;
+        if (delayUs > c->stats.delayMaxUs) c->stats.delayMaxUs = delayUs;
+        int64_t bucket = delayUs / USB_TX_DELAY_BUCKET_US;
+        c->histogram[bucket < USB_TX_DELAY_BUCKETS ? bucket : USB_TX_DELAY_BUCKETS - 1]++;
+        c->stats.framesSent++;
+        c->markTail++;
+    }
+}
+
+static void coalescerLoop(UsbTxCoalescer* c) {
+    const uint64_t transferSize = (uint64_t)c->config.transferSize;
+    traceSetThreadName("usb-tx");
+    std::unique_lock<std::mutex> guard(c->lock);
+
+    for (;;) {
+        uint64_t pending = c->head - c->tail;
+        if (pending == 0) {
+            c->flushRequested = false;
+            c->drained.notify_all();
+            if (c->stop) break;
+            c->wake.wait(guard);
+            continue;
+        }
+
+        // Oldest pending byte: the first frame not completely written
+        bool full = pending >= transferSize;
+        if (!full && !c->stop && !c->flushRequested && c->config.maxDelayUs > 0) {
+            int64_t deadlineUs = c->marks[c->markTail & (USB_TX_MARKS - 1)].queuedUs + c->config.maxDelayUs;
+            int64_t waitUs = deadlineUs - nowUs();
+            if (waitUs > 0) {
+                c->wake.wait_for(guard, std::chrono::microseconds(waitUs));
+                continue;
+            }
+        }
+
+        int length = (int)(full ? transferSize : pending);
+        uint64_t offset = c->tail & c->ringMask;
+        uint64_t first = c->ringMask + 1 - offset;
+        if (first > (uint64_t)length) first = (uint64_t)length;
+        memcpy(c->tx, c->ring + offset, first);
+        memcpy(c->tx + first, c->ring, (size_t)length - first);
+        c->tail += (uint64_t)length;
+
+        guard.unlock();
+        TRACE_COUNTER("usb.pending", pending);
+        int written, error;
+        {
+            TRACE_ZONE(full ? "usb.transfer" : "usb.transfer.deadline");
+            written = c->writeFn(c->context, c->tx, length, c->config.writeTimeoutMs);
+            error = errno;
+        }
+        int64_t writtenUs = nowUs();
+        guard.lock();
+
+        c->stats.transfers++;
+        if (full) c->stats.sizeFlushes++;
+        else c->stats.deadlineFlushes++;
+        if (written > 0) c->stats.bytes += (uint64_t)written;
+        if (written != length) {
+            c->stats.writeErrors++;
+            if (written < 0 && (error == ENODEV || error == ESHUTDOWN || error == EBADF)) {
+                c->failed = true;
+                c->head = c->tail;
+                c->done = c->tail;
+                c->markTail = c->markHead;
+                c->drained.notify_all();
+                LOGW("❌ USB write failed: %s, coalescer stopped", strerror(error));
+                break;
+            }
+            // Timeout / short write: those bytes are lost, the receiver resyncs on the header
+        }
+        c->done = c->tail;
+        retireFrames(c, writtenUs);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// API
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void usbTxDefaultConfig(UsbTxConfig* config) {
+    config->packetSize = USB_TX_DEFAULT_PACKET;
+    config->transferSize = USB_TX_DEFAULT_TRANSFER;
+    config->maxDelayUs = USB_TX_DEFAULT_DELAY_US;
+    config->bufferSize = USB_TX_DEFAULT_BUFFER;
+    config->writeTimeoutMs = 100;
+}
+
+extern "C" UsbTxCoalescer* usbTxOpen(UsbTxWriteFn write, void* context, const UsbTxConfig* config) {
+    if (write == nullptr) return nullptr;
+    UsbTxCoalescer* c = new (std::nothrow) UsbTxCoalescer();
+    if (c == nullptr) return nullptr;
+
+    if (config != nullptr) c->config = *config;
+    else usbTxDefaultConfig(&c->config);
+    UsbTxConfig* cfg = &c->config;
+    if (cfg->packetSize <= 0) cfg->packetSize = USB_TX_DEFAULT_PACKET;
+    if (cfg->transferSize > USB_TX_MAX_TRANSFER) cfg->transferSize = USB_TX_MAX_TRANSFER;
+    cfg->transferSize -= cfg->transferSize % cfg->packetSize;
+    if (cfg->transferSize <= 0) cfg->transferSize = cfg->packetSize;
+    if (cfg->maxDelayUs < 0) cfg->maxDelayUs = 0;
+    if (cfg->writeTimeoutMs <= 0) cfg->writeTimeoutMs = 100;
+
+    uint64_t size = 1024;
+    while (size < (uint64_t)cfg->bufferSize || size < (uint64_t)cfg->transferSize) size <<= 1;
+    c->ring = new (std::nothrow) uint8_t[size];
+    if (c->ring == nullptr) {
+        delete c;
+        return nullptr;
+    }
+    cfg->bufferSize = (int)size;
+    c->ringMask = size - 1;
+    c->writeFn = write;
+    c->context = context != nullptr ? context : c;
+    memset(&c->stats, 0, sizeof(c->stats));
+    memset(c->histogram, 0, sizeof(c->histogram));
+    c->startUs = nowUs();
+
+    try {
+        c->thread = std::thread(coalescerLoop, c);
+    } catch (...) {
+        delete[] c->ring;
+        delete c;
+        LOGW("❌ USB coalescer thread did not start");
+        return nullptr;
+    }
+    LOGI("✅ USB coalescer: %d B packets, %d B transfers, %d us deadline, %d B buffer",
+         cfg->packetSize, cfg->transferSize, cfg->maxDelayUs, cfg->bufferSize);
+    return c;
+}
+
+extern "C" UsbTxCoalescer* usbTxOpenUsb(int fd, int epOut, const UsbTxConfig* config) {
+    if (fd < 0) return nullptr;
+    UsbTxConfig cfg;
+    if (config != nullptr) cfg = *config;
+    else usbTxDefaultConfig(&cfg);
+
+    // context NULL = the coalescer itself, which carries fd / endpoint
+    UsbTxCoalescer* c = usbTxOpen(usbBulkWrite, nullptr, &cfg);
+    if (c == nullptr) return nullptr;
+    std::lock_guard<std::mutex> guard(c->lock);
+    c->usbFd = fd;
+    c->epOut = (unsigned)epOut;
+    return c;
+}
+
+extern "C" int usbTxWrite(UsbTxCoalescer* c, const uint8_t* data, int length) {
+    if (c == nullptr || data == nullptr || length <= 0) return 0;
+    int64_t queuedUs = nowUs();
+
+    std::lock_guard<std::mutex> guard(c->lock);
+    if (c->failed) return -1;
+    uint64_t pending = c->head - c->tail;
+    if (pending + (uint64_t)length > c->ringMask + 1 || c->markHead - c->markTail >= USB_TX_MARKS) {
+        c->stats.framesDropped++;
+        return 0;
+    }
+
+    uint64_t offset = c->head & c->ringMask;
+    uint64_t first = c->ringMask + 1 - offset;
+    if (first > (uint64_t)length) first = (uint64_t)length;
+    memcpy(c->ring + offset, data, first);
+    memcpy(c->ring, data + first, (size_t)length - first);
+    c->head += (uint64_t)length;
+    c->marks[c->markHead & (USB_TX_MARKS - 1)] = {c->head, queuedUs};
+    c->markHead++;
+    c->stats.framesQueued++;
+
+    // Wake for a new deadline or a full transfer; otherwise the thread is already timed
+    if (pending == 0 || pending + (uint64_t)length >= (uint64_t)c->config.transferSize ||
+        c->config.maxDelayUs == 0) {
+        c->wake.notify_one();
+    }
+    return 1;
+}
+
+extern "C" void usbTxFlush(UsbTxCoalescer* c, int timeoutMs) {
+    if (c == nullptr) return;
+    std::unique_lock<std::mutex> guard(c->lock);
+    c->flushRequested = true;
+    c->wake.notify_one();
+    c->drained.wait_for(guard, std::chrono::milliseconds(timeoutMs),
+                        [c] { return c->failed || c->done == c->head; });
+}
+
+static int64_t delayPercentileUs(const UsbTxCoalescer* c, double p) {
+    uint64_t total = 0;
+    for (uint32_t b : c->histogram) total += b;
+    if (total == 0) return 0;
+    uint64_t rank = (uint64_t)((double)total * p + 0.999999);
+    uint64_t seen = 0;
+    for (int i = 0; i < USB_TX_DELAY_BUCKETS; i++) {
+        seen += c->histogram[i];
+        if (seen >= rank) return (int64_t)(i + 1) * USB_TX_DELAY_BUCKET_US;   // Bucket upper bound
+    }
+    return (int64_t)USB_TX_DELAY_BUCKETS * USB_TX_DELAY_BUCKET_US;
+}
+
+extern "C" void usbTxGetStats(UsbTxCoalescer* c, UsbTxStats* out) {
+    if (c == nullptr) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    std::lock_guard<std::mutex> guard(c->lock);
+    *out = c->stats;
+    out->delayMeanUs = c->stats.framesSent > 0 ? c->delaySumUs / (int64_t)c->stats.framesSent : 0;
+    out->delayP99Us = delayPercentileUs(c, 0.99);
+    out->runTimeUs = nowUs() - c->startUs;
+    out->pendingBytes = (int32_t)(c->head - c->done);
+    out->failed = c->failed ? 1 : 0;
+}
+
+extern "C" void usbTxClose(UsbTxCoalescer* c) {
+    if (c == nullptr) return;
+    {
+        std::lock_guard<std::mutex> guard(c->lock);
+        c->stop = true;
+        c->wake.notify_one();
+    }
+    c->thread.join();
+
+    LOGI("USB coalescer closed: %llu frames in %llu transfers (%llu B), %llu dropped, %llu errors",
+         (unsigned long long)c->stats.framesSent, (unsigned long long)c->stats.transfers,
+         (unsigned long long)c->stats.bytes, (unsigned long long)c->stats.framesDropped,
+         (unsigned long long)c->stats.writeErrors);
+    delete[] c->ring;
+    delete c;
+}
@@ -0,0 +1,89 @@
+/**
+ * usb_tx_coalescer.h
+ * USB Write Coalescer (C++)
+ *
+ * Collects frames written by the caller into one byte stream and hands it
+ * to the device in as few bulk transfers as possible: a transfer goes out
+ * when transferSize bytes (whole USB packets) are pending, or when the
+ * oldest pending byte has waited maxDelayUs. The caller never blocks on
+ * USB; one coalescer thread does all transfers.
+ *
+ * Serial dongles (FTDI / CH340 / CP210x) turn bulk OUT data back into a
+ * plain UART byte stream, so a frame may span two transfers.
+ */
+
+#ifndef USB_TX_COALESCER_H
+#define USB_TX_COALESCER_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define USB_TX_DEFAULT_PACKET 64            // Full-speed bulk max packet (FTDI / CH340)
+#define USB_TX_DEFAULT_TRANSFER 512         // Bytes per transfer when full
+#define USB_TX_DEFAULT_DELAY_US 2000        // Flush deadline for a partial transfer
+#define USB_TX_DEFAULT_BUFFER 8192          // Pending bytes (rounded up to a power of two)
+#define USB_TX_MAX_TRANSFER 16384
+#define USB_TX_DELAY_BUCKET_US 50           // Queueing delay histogram resolution
+#define USB_TX_DELAY_BUCKETS 256
+
+typedef struct UsbTxCoalescer UsbTxCoalescer;
+
+// Device write used by the coalescer thread. Returns bytes written, -1 on
+// error (the coalescer stops after a fatal error, see usbTxWrite)
+typedef int (*UsbTxWriteFn)(void* context, const uint8_t* data, int length, int timeoutMs);
+
+typedef struct {
+    int packetSize;         // wMaxPacketSize of the OUT endpoint (64 full speed, 512 high speed)
+    int transferSize;       // Size trigger, rounded down to whole packets
+    int maxDelayUs;         // Deadline trigger, 0 = flush whatever is pending at once
+    int bufferSize;         // Frames that do not fit are dropped whole
+    int writeTimeoutMs;
+} UsbTxConfig;
+
+typedef struct {
+    uint64_t framesQueued;
+    uint64_t framesDropped;     // Buffer full
+    uint64_t framesSent;        // Last byte written to the device
+    uint64_t transfers;
+    uint64_t bytes;
+    uint64_t sizeFlushes;       // Transfers sent full
+    uint64_t deadlineFlushes;   // Partial transfers sent on the deadline
+    uint64_t writeErrors;
+    int64_t delayMeanUs;        // usbTxWrite → last byte transferred, per frame
+    int64_t delayP99Us;
+    int64_t delayMaxUs;
+    int64_t runTimeUs;
+    int32_t pendingBytes;
+    int32_t failed;             // Fatal write error, coalescer stopped
+} UsbTxStats;
+
+void usbTxDefaultConfig(UsbTxConfig* config);
+
+// Coalescer over a write function. Returns NULL if the thread cannot start
+UsbTxCoalescer* usbTxOpen(UsbTxWriteFn write, void* context, const UsbTxConfig* config);
+
+// Coalescer on the bulk OUT endpoint of a usbfs fd
+// (UsbDeviceConnection.getFileDescriptor(), interface already claimed).
+// The fd is not closed. packetSize 0 = config / default
+UsbTxCoalescer* usbTxOpenUsb(int fd, int epOut, const UsbTxConfig* config);
+
+// Queue one frame (any thread, never blocks on USB). Returns 1 queued,
+// 0 dropped (buffer full), -1 after a fatal write error
+int usbTxWrite(UsbTxCoalescer* c, const uint8_t* data, int length);
+
+// Send everything pending now and wait for it (up to timeoutMs)
+void usbTxFlush(UsbTxCoalescer* c, int timeoutMs);
+
+void usbTxGetStats(UsbTxCoalescer* c, UsbTxStats* outStats);
+
+// Flush (up to the write timeout), stop the thread and free
+void usbTxClose(UsbTxCoalescer* c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // USB_TX_COALESCER_H
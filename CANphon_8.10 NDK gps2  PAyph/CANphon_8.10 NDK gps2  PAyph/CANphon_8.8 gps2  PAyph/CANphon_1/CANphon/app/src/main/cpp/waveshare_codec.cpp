@@ -0,0 +1,217 @@
+/**
+ * waveshare_codec.cpp
+ * Waveshare USB-CAN-A Framing Codec (C++)
+ *
+ * Replaces the per-frame Kotlin packet builder and single-frame parser
+ * in WaveshareAdapter.kt: batches are encoded into one buffer and every
+ * complete frame of a USB read is decoded in one call.
+ */
+
+#define LOG_TAG "NativeWaveshare"
+#include "waveshare_codec.h"
+#include "native_log.h"
+#include <cstring>
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Global Codec State
+// ═══════════════════════════════════════════════════════════════════════════
+
+static WsCodec defaultCodec;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Encoding
+// ═══════════════════════════════════════════════════════════════════════════
+
+static inline int frameSize(int ext, int rtr, int dlc) {
+    return 2 + (ext ? 4 : 2) + (rtr ? 0 : dlc) + 1;
+}
+
+extern "C" int wsEncodeFrame(const WsCanFrame* frame, uint8_t* out, int outCapacity) {
+    int ext = (frame->flags & WS_FLAG_EXT) != 0;
+    int rtr = (frame->flags & WS_FLAG_RTR) != 0;
+    int dlc = frame->dlc > WS_MAX_DLC ? WS_MAX_DLC : frame->dlc;
+    int size = frameSize(ext, rtr, dlc);
+    if (size > outCapacity) return 0;
+
+    int i = 0;
+    out[i++] = WS_FRAME_HEADER;
+    out[i++] = (uint8_t)(WS_TYPE_BASE | (ext ? WS_TYPE_EXT : 0) | (rtr ? WS_TYPE_RTR : 0) | dlc);
+    out[i++] = (uint8_t)(frame->id & 0xFF);
+    out[i++] = (uint8_t)((frame->id >> 8) & 0xFF);
+    if (ext) {
+        out[i++] = (uint8_t)((frame->id >> 16) & 0xFF);
+        out[i++] = (uint8_t)((frame->id >> 24) & 0xFF);
+    }
+    if (!rtr) {
+        memcpy(out + i, frame->data, dlc);
+        i += dlc;
+    }
+    out[i++] = WS_FRAME_FOOTER;
+    return i;
+}
+
+extern "C" int wsCodecEncode(WsCodec* codec, const WsCanFrame* frames, int count, uint8_t* out, int outCapacity) {
+    int length = 0;
+    for (int k = 0; k < count; k++) {
+        int n = wsEncodeFrame(&frames[k], out + length, outCapacity - length);
+        if (n == 0) {
+            codec->stats.encodeOverflows += count - k;
+            break;
+        }
+        length += n;
+        codec->stats.framesEncoded++;
+    }
+    return length;
+}
+
+extern "C" int wsEncodeFrames(const WsCanFrame* frames, int count, uint8_t* out, int outCapacity) {
+    return wsCodecEncode(&defaultCodec, frames, count, out, outCapacity);
+}
+
+extern "C" int wsEncodePacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data,
+                              int count, uint8_t* out, int outCapacity) {
+    int length = 0;
+    WsCanFrame frame;
+    for (int k = 0; k < count; k++) {
+        frame.id = (uint32_t)ids[k];
+        frame.dlc = (uint8_t)dlcs[k];
+        frame.flags = (frame.id > 0x7FF) ? WS_FLAG_EXT : 0;
+        memcpy(frame.data, data + k * WS_MAX_DLC, WS_MAX_DLC);
+
+        int n = wsEncodeFrame(&frame, out + length, outCapacity - length);
+        if (n == 0) {
+            defaultCodec.stats.encodeOverflows += count - k;
+            break;
+        }
+        length += n;
+        defaultCodec.stats.framesEncoded++;
+    }
+    return length;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Decoding
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void wsCodecInit(WsCodec* codec) {
+    codec->rxLength = 0;
+    memset(&codec->stats, 0, sizeof(codec->stats));
+}
+
+extern "C" void wsDecoderReset() {
+    wsCodecInit(&defaultCodec);
+    LOGI("✅ Waveshare codec reset");
+}
+
+extern "C" int wsDecoderPending() {
+    return defaultCodec.rxLength;
+}
+
+// Make room for `length` new bytes by discarding the oldest ones
+static void appendInput(WsCodec* c, const uint8_t* in, int length) {
+    if (length >= WS_RX_BUFFER_SIZE) {
+        int skip = length - WS_RX_BUFFER_SIZE;
+        c->stats.bytesDropped += c->rxLength + skip;
+        memcpy(c->rxBuffer, in + skip, WS_RX_BUFFER_SIZE);
+        c->rxLength = WS_RX_BUFFER_SIZE;
+        return;
+    }
+
+    int overflow = c->rxLength + length - WS_RX_BUFFER_SIZE;
+    if (overflow > 0) {
+        memmove(c->rxBuffer, c->rxBuffer + overflow, c->rxLength - overflow);
+        c->rxLength -= overflow;
+        c->stats.bytesDropped += overflow;
+    }
+
+    memcpy(c->rxBuffer + c->rxLength, in, length);
+    c->rxLength += length;
+}
+
+// Parse buffered frames into out[], keep the unparsed tail at the front
+static int parseBuffered(WsCodec* c, WsCanFrame* out, int maxFrames) {
+    int pos = 0;
+    int count = 0;
+
+    // Minimal frame: Header + Type + ID(2) + Footer
+    while (count < maxFrames && c->rxLength - pos >= 5) {
+        const uint8_t* p = c->rxBuffer + pos;
+
+        if (p[0] != WS_FRAME_HEADER) {
+            pos++;
+            c->stats.garbageBytes++;
+            continue;
+        }
+
+        uint8_t type = p[1];
+        int dlc = type & 0x0F;
+        if ((type & 0xC0) != WS_TYPE_BASE || dlc > WS_MAX_DLC) {
+            pos++;
+            c->stats.badFrames++;
+            continue;
+        }
+
+        int ext = (type & WS_TYPE_EXT) != 0;
+        int rtr = (type & WS_TYPE_RTR) != 0;
+        int size = frameSize(ext, rtr, dlc);
+        if (c->rxLength - pos < size) break;  // Wait for more data
+
+        if (p[size - 1] != WS_FRAME_FOOTER) {
+            pos++;
+            c->stats.badFrames++;
+            continue;
+        }
+
+        WsCanFrame* f = &out[count++];
+        f->id = (uint32_t)p[2] | ((uint32_t)p[3] << 8);
+        if (ext) f->id |= ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24);
+        f->dlc = (uint8_t)dlc;
+        f->flags = (uint8_t)((ext ? WS_FLAG_EXT : 0) | (rtr ? WS_FLAG_RTR : 0));
+        memset(f->data, 0, WS_MAX_DLC);
+        if (!rtr) memcpy(f->data, p + (ext ? 6 : 4), dlc);
+
+        pos += size;
+    }
+
+    if (pos > 0) {
+        memmove(c->rxBuffer, c->rxBuffer + pos, c->rxLength - pos);
+        c->rxLength -= pos;
+    }
+    return count;
+}
+
+extern "C" int wsCodecDecode(WsCodec* c, const uint8_t* in, int length, WsCanFrame* out, int maxFrames) {
+    if (in == nullptr || length < 0) length = 0;
+    c->stats.bytesIn += length;
+
+    // Feed the buffer as it drains, so a large read never overflows it
+    // while free frame slots remain
+    int count = parseBuffered(c, out, maxFrames);
+    while (length > 0 && count < maxFrames) {
+        int take = WS_RX_BUFFER_SIZE - c->rxLength;
+        if (take > length) take = length;
+        memcpy(c->rxBuffer + c->rxLength, in, take);
+        c->rxLength += take;
+        in += take;
+        length -= take;
+        count += parseBuffered(c, out + count, maxFrames - count);
+    }
+
+    // Output full: keep what is left, oldest bytes go first
+    if (length > 0) appendInput(c, in, length);
+
+    c->stats.framesDecoded += count;
+    return count;
+}
+
+extern "C" int wsDecode(const uint8_t* in, int length, WsCanFrame* out, int maxFrames) {
+    return wsCodecDecode(&defaultCodec, in, length, out, maxFrames);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Statistics
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" void wsGetStats(WsCodecStats* outStats) {
+    *outStats = defaultCodec.stats;
+}
@@ -0,0 +1,113 @@
+/**
+ * waveshare_codec.h
+ * Waveshare USB-CAN-A Framing Codec (C++)
+ *
+ * Variable-length serial frame:
+ * [0xAA] [TYPE] [ID: 2 or 4 bytes LE] [DATA: DLC bytes] [0x55]
+ *
+ * TYPE = 0xC0 | EXT<<5 | RTR<<4 | DLC
+ * Remote (RTR) frames carry no data bytes.
+ */
+
+#ifndef WAVESHARE_CODEC_H
+#define WAVESHARE_CODEC_H
+
+#include <cstdint>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Protocol constants
+#define WS_FRAME_HEADER 0xAA
+#define WS_FRAME_FOOTER 0x55
+#define WS_TYPE_BASE 0xC0
+#define WS_TYPE_EXT 0x20
+#define WS_TYPE_RTR 0x10
+#define WS_MAX_DLC 8
+#define WS_MAX_FRAME_BYTES 15   // Extended ID + 8 data bytes
+
+// Decoder buffer (holds unparsed bytes between USB reads)
+#define WS_RX_BUFFER_SIZE 4096
+
+// Frame flags
+#define WS_FLAG_EXT 0x01
+#define WS_FLAG_RTR 0x02
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Data Structures
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t id;
+    uint8_t dlc;
+    uint8_t flags;          // WS_FLAG_*
+    uint8_t data[WS_MAX_DLC];
+} WsCanFrame;
+
+typedef struct {
+    uint64_t framesEncoded;
+    uint64_t framesDecoded;
+    uint64_t bytesIn;
+    uint64_t bytesDropped;     // Decoder buffer full: oldest bytes discarded
+    uint64_t garbageBytes;     // Bytes skipped while searching for a header
+    uint64_t badFrames;        // Header found but footer/type invalid
+    uint64_t encodeOverflows;  // Frames not encoded (output buffer full)
+} WsCodecStats;
+
+// One codec per byte stream (the global functions below use a default one)
+typedef struct {
+    uint8_t rxBuffer[WS_RX_BUFFER_SIZE];
+    int rxLength;
+    WsCodecStats stats;
+} WsCodec;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Encoding
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Encode one frame. Returns bytes written, or 0 if outCapacity is too small
+int wsEncodeFrame(const WsCanFrame* frame, uint8_t* out, int outCapacity);
+
+// Encode a batch into one contiguous buffer. Returns bytes written;
+// frames that do not fit are counted in encodeOverflows
+int wsEncodeFrames(const WsCanFrame* frames, int count, uint8_t* out, int outCapacity);
+
+// Flat-array variant (JNI): ids[count], dlcs[count], data[count * 8]
+int wsEncodePacked(const int32_t* ids, const int8_t* dlcs, const int8_t* data,
+                   int count, uint8_t* out, int outCapacity);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Decoding
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Reset decoder buffer and statistics
+void wsDecoderReset();
+
+// Append one USB read and decode every complete frame into out[] (up to
+// maxFrames). Frames beyond maxFrames stay buffered for the next call.
+// Returns number of frames written
+int wsDecode(const uint8_t* in, int length, WsCanFrame* out, int maxFrames);
+
+// Bytes currently buffered (partial frame or undelivered frames)
+int wsDecoderPending();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Statistics
+// ═══════════════════════════════════════════════════════════════════════════
+
+void wsGetStats(WsCodecStats* outStats);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Per-Stream Codec (transports, host tools)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void wsCodecInit(WsCodec* codec);
+int wsCodecEncode(WsCodec* codec, const WsCanFrame* frames, int count, uint8_t* out, int outCapacity);
+int wsCodecDecode(WsCodec* codec, const uint8_t* in, int length, WsCanFrame* out, int maxFrames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAVESHARE_CODEC_H
@@ -12,6 +12,7 @@ import android.os.Build
 import android.os.Environment
 import android.provider.MediaStore
 import android.util.Log
+import com.example.canphon.native_sensors.NativeCore
 import java.io.File
 import java.io.FileOutputStream
 import java.io.OutputStreamWriter
@@ -23,11 +24,16 @@ import java.util.*
  * 
  * Saves feedback data to CSV file in Downloads folder
  * Compatible with Android 10+ (Scoped Storage)
+ * 
+ * Rows come from the telemetry bus (one per servo record, with the latest
+ * attitude record before it), so the CSV holds the same values as the
+ * telemetry frames whatever rate drainBus() is called at.
  */
 class DataLogger(private val context: Context) {
     
     companion object {
         private const val TAG = "DataLogger"
+        private const val BUS_BATCH = 64
     }
     
     private var writer: OutputStreamWriter? = null
@@ -36,6 +42,13 @@ class DataLogger(private val context: Context) {
     private var recordCount = 0
     private var startTime = 0L
     
+    // Telemetry bus cursor (attitude + servo records)
+    private var busConsumer = -1
+    private val busRecords = DoubleArray(BUS_BATCH * NativeCore.BUS_STRIDE)
+    private var busStartUs = -1L
+    private var lastRoll = 0f
+    private var lastPitch = 0f
+    
     /**
      * Start recording to a new CSV file
      */
@@ -82,6 +95,10 @@ class DataLogger(private val context: Context) {
             isRecording = true
             recordCount = 0
             startTime = System.currentTimeMillis()
+            busStartUs = -1L
+            busConsumer = NativeCore.telemetryBusSubscribe(
+                "csv", NativeCore.busMask(NativeCore.BUS_ATTITUDE, NativeCore.BUS_SERVO), false)
+            if (busConsumer < 0) Log.w(TAG, "No telemetry bus cursor - rows only from logData()")
             
             Log.i(TAG, "📝 Started recording to $fileName")
             return true
@@ -93,7 +110,49 @@ class DataLogger(private val context: Context) {
     }
     
     /**
-     * Log a data row
+     * Write a row for every servo record published since the last call
+     * (call from any one thread, at any rate). Returns rows written
+     */
+    fun drainBus(): Int {
+        if (!isRecording || writer == null || busConsumer < 0) return 0
+        
+        var rows = 0
+        while (true) {
+            val n = NativeCore.telemetryBusRead(busConsumer, busRecords, BUS_BATCH)
+            if (n <= 0) break
+            for (i in 0 until n) {
+                val base = i * NativeCore.BUS_STRIDE
+                val timeUs = busRecords[base + 1].toLong()
+                val v = base + 3
+                when (busRecords[base + 2].toInt()) {
+                    NativeCore.BUS_ATTITUDE -> {
+                        lastRoll = busRecords[v].toFloat()
+                        lastPitch = busRecords[v + 1].toFloat()
+                    }
+                    NativeCore.BUS_SERVO -> {
+                        if (busStartUs < 0) busStartUs = timeUs
+                        val elapsed = (timeUs - busStartUs) / 1000
+                        writeRow(startTime + elapsed, elapsed, lastRoll, lastPitch,
+                            busRecords[v].toFloat(), busRecords[v + 1].toFloat(),
+                            busRecords[v + 2].toFloat(), busRecords[v + 3].toFloat(),
+                            busRecords[v + 4].toFloat(), busRecords[v + 5].toFloat(),
+                            busRecords[v + 6].toFloat(), busRecords[v + 7].toFloat())
+                        rows++
+                    }
+                }
+            }
+            if (n < BUS_BATCH) break
+        }
+        return rows
+    }
+    
+    /**
+     * Bus cursor state: [published, received, skipped, lag], null when not recording
+     */
+    fun getBusStats(): LongArray? = if (busConsumer >= 0) NativeCore.telemetryBusGetStats(busConsumer) else null
+    
+    /**
+     * Log a data row (callers without the telemetry bus)
      */
     fun logData(
         roll: Float,
@@ -108,10 +167,19 @@ class DataLogger(private val context: Context) {
         servo4Fb: Float = 0f
     ) {
         if (!isRecording || writer == null) return
-        
+        val now = System.currentTimeMillis()
+        writeRow(now, now - startTime, roll, pitch,
+            servo1Cmd, servo2Cmd, servo3Cmd, servo4Cmd,
+            servo1Fb, servo2Fb, servo3Fb, servo4Fb)
+    }
+    
+    private fun writeRow(
+        wallMs: Long, elapsed: Long, roll: Float, pitch: Float,
+        servo1Cmd: Float, servo2Cmd: Float, servo3Cmd: Float, servo4Cmd: Float,
+        servo1Fb: Float, servo2Fb: Float, servo3Fb: Float, servo4Fb: Float
+    ) {
         try {
-            val elapsed = System.currentTimeMillis() - startTime
-            val timestamp = SimpleDateFormat("HH:mm:ss.SSS", Locale.getDefault()).format(Date())
+            val timestamp = SimpleDateFormat("HH:mm:ss.SSS", Locale.getDefault()).format(Date(wallMs))
             
             val line = String.format(
                 Locale.US,
@@ -141,6 +209,12 @@ class DataLogger(private val context: Context) {
     fun stopRecording(): String {
         if (!isRecording) return ""
         
+        drainBus()
+        if (busConsumer >= 0) {
+            NativeCore.telemetryBusUnsubscribe(busConsumer)
+            busConsumer = -1
+        }
+        
         try {
             writer?.flush()
             writer?.close()
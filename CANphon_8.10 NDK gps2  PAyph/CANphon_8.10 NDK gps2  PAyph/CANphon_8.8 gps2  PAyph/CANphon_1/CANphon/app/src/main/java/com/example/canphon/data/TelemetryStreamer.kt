@@ -5,8 +5,11 @@ import com.example.canphon.managers.*
 import com.example.canphon.protocols.*
 import com.example.canphon.drivers.*
 import com.example.canphon.data.*
+import com.example.canphon.native_sensors.NativeCore
+import com.example.canphon.native_sensors.NativeTrace
 
 import android.content.Context
+import android.hardware.usb.UsbDeviceConnection
 import android.hardware.usb.UsbManager
 import android.util.Log
 import com.hoho.android.usbserial.driver.UsbSerialPort
@@ -42,6 +45,11 @@ object TelemetryStreamer {
     // Baud rate
     const val BAUD_RATE = 115200
     
+    // Native USB writes: a bulk transfer goes out when this many bytes are pending,
+    // or when the oldest pending frame has waited USB_MAX_DELAY_US
+    const val USB_TRANSFER_SIZE = 512
+    const val USB_MAX_DELAY_US = 2000
+    
     // Known telemetry radio VIDs (will try to connect to any non-Waveshare device)
     private val WAVESHARE_VID = 0x1A86  // CH340 - Waveshare CAN adapter
     
@@ -54,6 +62,9 @@ object TelemetryStreamer {
     private var storedUsbManager: UsbManager? = null
     private var storedContext: android.content.Context? = null
     
+    // Frames coalesced natively into bulk transfers (else port.write on writeExecutor)
+    @Volatile private var nativeUsb = false
+    
     // Background thread for serial writes
     private val writeExecutor = Executors.newSingleThreadExecutor()
     private val isWriting = AtomicBoolean(false)
@@ -240,6 +251,7 @@ object TelemetryStreamer {
             }
             
             serialPort = port
+            nativeUsb = openNativeUsb(connection, port)
             connectedDeviceName = deviceName
             isConnected = true
             startTime = System.currentTimeMillis()
@@ -259,10 +271,69 @@ object TelemetryStreamer {
         }
     }
     
+    // ═══════════════════════════════════════════════════════════════════════
+    // Network Publisher (desk testing / several ground-station consumers)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    // Records = 16-byte header (magic "CT", version, sequence, publish time µs) + frame.
+    // Host: host_tools/telemetry_subscriber, e.g. after `adb forward tcp:14574 tcp:14574`
+    const val PUBLISH_UDP_TARGETS = "127.0.0.1:14573"  // Comma-separated, multicast groups allowed
+    const val PUBLISH_TCP_PORT = 14574
+    const val PUBLISH_MAX_BATCH = 8
+    
+    @Volatile private var publishing = false
+    
+    /**
+     * Start publishing every frame over UDP / TCP (runs with or without the radio)
+     * @param tcpLoopbackOnly Listen on 127.0.0.1 only (reachable through adb forward)
+     */
+    fun startPublisher(
+        udpTargets: String = PUBLISH_UDP_TARGETS,
+        tcpPort: Int = PUBLISH_TCP_PORT,
+        tcpLoopbackOnly: Boolean = true,
+        multicastTtl: Int = 1
+    ): Boolean {
+        if (publishing) return true
+        publishing = try {
+            NativeCore.telemetryPublisherStart(udpTargets, tcpPort, tcpLoopbackOnly, multicastTtl, PUBLISH_MAX_BATCH, 0)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native publisher unavailable: ${e.message}")
+            false
+        }
+        if (publishing) {
+            if (startTime == 0L) startTime = System.currentTimeMillis()
+            Log.i(TAG, "✅ Publishing telemetry: UDP $udpTargets, TCP $tcpPort")
+        }
+        return publishing
+    }
+    
+    fun stopPublisher() {
+        if (!publishing) return
+        publishing = false
+        NativeCore.telemetryPublisherStop()
+    }
+    
+    fun isPublishing(): Boolean = publishing
+    
+    /**
+     * Publisher stats (see NativeCore.telemetryPublisherGetStats), null when not publishing
+     */
+    fun getPublisherStats(): LongArray? = if (publishing) NativeCore.telemetryPublisherGetStats() else null
+    
+    fun getPublisherStatsString(): String {
+        val s = getPublisherStats() ?: return "Publisher: off"
+        return "Publisher: ${s[0]} frames, ${s[2]} datagrams / ${s[3]} calls, ${s[11]} TCP clients, " +
+            "drops ${s[1] + s[8]}, latency ${s[9]}/${s[10]} µs"
+    }
+    
     /**
      * Disconnect from telemetry device
      */
     fun disconnect() {
+        if (nativeUsb) {
+            nativeUsb = false
+            NativeCore.telemetryUsbClose()  // Flushes pending frames before the port closes
+        }
         try {
             serialPort?.close()
         } catch (e: Exception) {
@@ -273,6 +344,57 @@ object TelemetryStreamer {
         Log.i(TAG, "Disconnected")
     }
     
+    private fun openNativeUsb(connection: UsbDeviceConnection, port: UsbSerialPort): Boolean {
+        val endpoint = port.writeEndpoint ?: return false
+        return try {
+            NativeCore.telemetryUsbOpen(connection.fileDescriptor, endpoint.address, endpoint.maxPacketSize,
+                USB_TRANSFER_SIZE, USB_MAX_DELAY_US)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native USB writes unavailable: ${e.message}")
+            false
+        }
+    }
+    
+    private fun writeNative(frameData: ByteArray) {
+        when (NativeCore.telemetryUsbWrite(frameData, TOTAL_FRAME_SIZE)) {
+            1 -> {
+                frameCount++
+                consecutiveErrors = 0
+                if (frameCount % 600 == 0L) {
+                    Log.d(TAG, "📡 $frameCount frames, ${getUsbWriteStatsString()}")
+                }
+            }
+            0 -> {
+                // Buffer full: the radio is slower than the frame rate
+                consecutiveErrors++
+                if (consecutiveErrors % 60 == 1) Log.w(TAG, "USB write buffer full, frame dropped")
+            }
+            else -> {
+                // Device gone
+                consecutiveErrors++
+                if (consecutiveErrors == 1) {
+                    Log.w(TAG, "USB write failed - reconnecting...")
+                    android.os.Handler(android.os.Looper.getMainLooper()).post {
+                        reconnect()
+                    }
+                }
+            }
+        }
+    }
+    
+    /**
+     * Native USB write stats (see NativeCore.telemetryUsbGetStats), null when not in use
+     */
+    fun getUsbWriteStats(): LongArray? = if (nativeUsb) NativeCore.telemetryUsbGetStats() else null
+    
+    fun getUsbWriteStatsString(): String {
+        val s = getUsbWriteStats() ?: return "USB writes: port.write"
+        val transfersPerSec = if (s[11] > 0) s[3] * 1_000_000.0 / s[11] else 0.0
+        val bytesPerTransfer = if (s[3] > 0) s[4] / s[3] else 0
+        return "USB writes: %.1f transfers/s, %d B/transfer, delay %d/%d/%d µs, dropped %d, errors %d".format(
+            transfersPerSec, bytesPerTransfer, s[8], s[9], s[10], s[1], s[7])
+    }
+    
     /**
      * Reconnect to telemetry device
      */
@@ -339,14 +461,56 @@ object TelemetryStreamer {
         return true  // Return true = write queued
     }
     
+    // ═══════════════════════════════════════════════════════════════════════
+    // Telemetry Bus (this tick is the only producer)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    private val busValues = DoubleArray(NativeCore.BUS_VALUES)
+    
+    /**
+     * Publish this tick's values as typed records, whether or not a link is
+     * up: the CSV logger and the UI read them through their own bus cursors
+     */
+    private fun publishBus() {
+        val v = busValues
+        v[0] = roll.toDouble(); v[1] = pitch.toDouble(); v[2] = yaw.toDouble()
+        v[3] = accX.toDouble(); v[4] = accY.toDouble(); v[5] = accZ.toDouble()
+        NativeCore.telemetryBusPublish(NativeCore.BUS_ATTITUDE, v, 6)
+    
+        v[0] = s1Cmd.toDouble(); v[1] = s2Cmd.toDouble(); v[2] = s3Cmd.toDouble(); v[3] = s4Cmd.toDouble()
+        v[4] = s1Fb.toDouble(); v[5] = s2Fb.toDouble(); v[6] = s3Fb.toDouble(); v[7] = s4Fb.toDouble()
+        v[8] = servoOnline.toDouble()
+        NativeCore.telemetryBusPublish(NativeCore.BUS_SERVO, v, 9)
+    
+        v[0] = latitude; v[1] = longitude; v[2] = gpsAltitude.toDouble()
+        v[3] = speed.toDouble(); v[4] = heading.toDouble()
+        v[5] = satellites.toDouble(); v[6] = gpsFix.toDouble(); v[7] = hdop.toDouble()
+        NativeCore.telemetryBusPublish(NativeCore.BUS_GPS, v, 8)
+    
+        v[0] = targetX.toDouble(); v[1] = targetY.toDouble(); v[2] = targetW.toDouble(); v[3] = targetH.toDouble()
+        NativeCore.telemetryBusPublish(NativeCore.BUS_TRACKING, v, 4)
+    
+        v[0] = batteryPercent.toDouble(); v[1] = if (isCharging) 1.0 else 0.0; v[2] = batteryVoltage.toDouble()
+        v[3] = temperature.toDouble(); v[4] = pressure.toDouble(); v[5] = baroAltitude.toDouble()
+        NativeCore.telemetryBusPublish(NativeCore.BUS_POWER, v, 6)
+    
+        // Pipeline stage misses and the policies they engaged
+        NativeCore.telemetryBusPublish(NativeCore.BUS_DEADLINE, v, NativeCore.deadlineBusValues(v))
+    }
+    
     /**
      * Build and send telemetry frame @ 60Hz
      * Uses background thread for writes
      */
     private var frameCount = 0L
     
-    fun sendFrame() {
-        if (!isConnected || serialPort == null) {
+    fun sendFrame() = NativeTrace.zone(NativeTrace.TELEMETRY_FRAME) { publishAndSend() }
+    
+    private fun publishAndSend() {
+        publishBus()
+        
+        val serialReady = isConnected && serialPort != null
+        if (!serialReady && !publishing) {
             // Log every 60 frames (1 second) to avoid spam
             if (frameCount % 60 == 0L) {
                 Log.w(TAG, "sendFrame skipped: isConnected=$isConnected, serialPort=${serialPort != null}")
@@ -355,8 +519,8 @@ object TelemetryStreamer {
             return
         }
         
-        // Skip if previous write still in progress
-        if (isWriting.get()) {
+        // Skip if previous write still in progress (subscribers get every frame)
+        if (isWriting.get() && !publishing) {
             return
         }
         
@@ -456,6 +620,21 @@ object TelemetryStreamer {
             
             // Copy frame data for background thread
             val frameData = frameBuffer.array().copyOf()
+            
+            // Network subscribers: queued natively, sent off this thread
+            if (publishing) {
+                NativeCore.telemetryPublish(frameData, TOTAL_FRAME_SIZE)
+            }
+            if (!serialReady) {
+                return
+            }
+            if (nativeUsb) {
+                writeNative(frameData)
+                return
+            }
+            if (isWriting.get()) {
+                return
+            }
             val currentFrameCount = frameCount
             val currentRoll = roll
             val currentPitch = pitch
@@ -7,6 +7,7 @@ import com.example.canphon.drivers.*
 import com.example.canphon.data.*
 
 import android.util.Log
+import com.example.canphon.native_sensors.NativeCore
 import com.hoho.android.usbserial.driver.UsbSerialPort
 import java.io.IOException
 
@@ -17,19 +18,27 @@ import java.io.IOException
  * [0xAA] [INFO] [ID_LOW] [ID_HIGH] [DATA...8 bytes] [0x55]
  * 
  * INFO Byte: 0xC0 | DLC (e.g., 0xC8 for 8-byte payload)
+ * 
+ * Encoding/decoding runs in the native codec (waveshare_codec.cpp):
+ * a batch is encoded into one buffer, and every complete frame of a
+ * USB read is decoded in one call into preallocated arrays.
  */
 class WaveshareAdapter(private val port: UsbSerialPort) {
 
     companion object {
         const val BAUD_RATE = 2000000 // 2Mbps
         private const val TAG = "WaveshareAdapter"
-        private const val FRAME_HEADER = 0xAA.toByte()
-        private const val FRAME_FOOTER = 0x55.toByte()
         private const val WRITE_TIMEOUT = 50  // Increased for USB stability
         private const val READ_TIMEOUT = 10 // Increased for stability
         
-        // Circular Buffer Size (2KB is enough for ~150 frames)
-        private const val BUFFER_SIZE = 2048
+        // One USB read (several bulk packets at full rate)
+        private const val READ_BUFFER_SIZE = 1024
+        
+        // Largest encoded frame: Header + Info + ID(4) + 8 data + Footer
+        const val MAX_FRAME_BYTES = 15
+        const val MAX_BATCH_FRAMES = 16
+        const val MAX_RX_FRAMES = 128
+        const val MAX_DLC = 8
     }
     
     // Statistics
@@ -40,158 +49,153 @@ class WaveshareAdapter(private val port: UsbSerialPort) {
     var errors = 0L
         private set
     
-    // Read buffer (Circular)
-    private val buffer = ByteArray(BUFFER_SIZE)
-    private var head = 0 // Write index
-    private var tail = 0 // Read index
-    private var count = 0 // Number of bytes in buffer
-    
     // Temp buffer for USB reads
-    private val paramsBuffer = ByteArray(64)
+    private val readBuffer = ByteArray(READ_BUFFER_SIZE)
+    
+    // Decoded frames of the last readFrames() call (reused, valid up to the returned count)
+    val rxIds = IntArray(MAX_RX_FRAMES)
+    val rxDlcs = ByteArray(MAX_RX_FRAMES)
+    val rxData = ByteArray(MAX_RX_FRAMES * MAX_DLC)
+    private var rxBacklog = false  // Last decode filled every slot, more frames are buffered
+    
+    // readFrame() compatibility cursor
+    private var rxIndex = 0
+    private var rxCount = 0
+    
+    // Reused buffers for batched writes
+    private val txIds = IntArray(MAX_BATCH_FRAMES)
+    private val txDlcs = ByteArray(MAX_BATCH_FRAMES)
+    private val txData = ByteArray(MAX_BATCH_FRAMES * MAX_DLC)
+    private val batchBuffer = ByteArray(MAX_FRAME_BYTES * MAX_BATCH_FRAMES)
+    private val txLock = Any()
+    
+    init {
+        NativeCore.wsDecoderReset()
+    }
     
     /**
-     * Send a CAN frame via Waveshare adapter
+     * Copy a frame into the native encoder input at slot [k]
      */
-    fun sendFrame(frame: CANFrame): Boolean {
-        try {
-            // Build packet
-            val packet = mutableListOf<Byte>()
-            
-            // Header
-            packet.add(FRAME_HEADER)
-            
-            // INFO/Type byte: 0xC0 | DLC
-            val info = 0xC0 or (frame.data.size and 0x0F)
-            packet.add(info.toByte())
-            
-            // CAN ID (little endian)
-            packet.add((frame.id and 0xFF).toByte())
-            packet.add(((frame.id shr 8) and 0xFF).toByte())
-            
-            // Data payload
-            frame.data.forEach { packet.add(it) }
-            
-            // Footer
-            packet.add(FRAME_FOOTER)
-            
-            // Direct write to serial port
-            port.write(packet.toByteArray(), WRITE_TIMEOUT)
-            framesSent++
-            
-            return true
-            
-        } catch (e: Exception) {
-            Log.e(TAG, "Send FAILED: ${e.message}")
-            errors++
-            return false
-        }
+    private fun stageFrame(frame: CANFrame, k: Int) {
+        val dlc = minOf(frame.data.size, MAX_DLC)
+        txIds[k] = frame.id
+        txDlcs[k] = dlc.toByte()
+        System.arraycopy(frame.data, 0, txData, k * MAX_DLC, dlc)
     }
     
     /**
-     * Read incoming frames (Robust Stream)
+     * Encode the first [n] staged frames and write them in one USB transfer
+     */
+    private fun writeStaged(n: Int): Boolean {
+        val len = NativeCore.wsEncode(txIds, txDlcs, txData, n, batchBuffer)
+        if (len <= 0) return false
+        port.write(batchBuffer, len, WRITE_TIMEOUT)
+        return true
+    }
+    
+    /**
+     * Send several CAN frames in a single USB write (one burst on the bus)
      * 
-     * Reads from USB into circular buffer, then parses the next valid frame.
-     * Returns NULL only if no complete frame is available after reading.
+     * @return number of frames sent (0 on failure)
      */
-    fun readFrame(): CANFrame? {
-        try {
-            // 1. Read from USB into temp buffer
-            val len = port.read(paramsBuffer, READ_TIMEOUT)
-            if (len > 0) {
-                pushBytes(paramsBuffer, len)
+    fun sendFrames(frames: List<CANFrame>): Int {
+        if (frames.isEmpty()) return 0
+        val n = minOf(frames.size, MAX_BATCH_FRAMES)
+        synchronized(txLock) {
+            try {
+                for (k in 0 until n) {
+                    stageFrame(frames[k], k)
+                }
+                if (!writeStaged(n)) {
+                    errors++
+                    return 0
+                }
+                framesSent += n
+                return n
+            } catch (e: Exception) {
+                Log.e(TAG, "Batch send FAILED: ${e.message}")
+                errors++
+                return 0
             }
-            
-            // 2. Try to parse a frame from the circular buffer
-            return parseNextFrame()
-            
-        } catch (e: IOException) {
-            return null // Normal timeout or error
         }
     }
     
     /**
-     * Push bytes into circular buffer
+     * Send a CAN frame via Waveshare adapter
      */
-    private fun pushBytes(data: ByteArray, length: Int) {
-        for (i in 0 until length) {
-            if (count < BUFFER_SIZE) {
-                buffer[head] = data[i]
-                head = (head + 1) % BUFFER_SIZE
-                count++
-            } else {
-                // Buffer overflow - discard oldest byte (advance tail)
-                tail = (tail + 1) % BUFFER_SIZE
-                // Overwrite head
-                buffer[head] = data[i]
-                head = (head + 1) % BUFFER_SIZE
-                // Count stays max
+    fun sendFrame(frame: CANFrame): Boolean {
+        synchronized(txLock) {
+            try {
+                stageFrame(frame, 0)
+                if (!writeStaged(1)) {
+                    errors++
+                    return false
+                }
+                framesSent++
+                return true
+            } catch (e: Exception) {
+                Log.e(TAG, "Send FAILED: ${e.message}")
+                errors++
+                return false
             }
         }
     }
     
     /**
-     * Peek byte at offset from tail
+     * Read incoming frames (Robust Stream)
+     * 
+     * One USB read, then every complete frame is decoded into
+     * rxIds / rxDlcs / rxData (frame i data at i * MAX_DLC).
+     * Partial frames stay in the native buffer for the next call.
+     * 
+     * @return number of frames decoded (0 on timeout)
      */
-    private fun peek(offset: Int): Byte {
-        return buffer[(tail + offset) % BUFFER_SIZE]
+    fun readFrames(): Int {
+        try {
+            // Frames left over from a full decode are delivered before reading again
+            val len = if (rxBacklog) 0 else port.read(readBuffer, READ_TIMEOUT)
+            val n = NativeCore.wsDecode(readBuffer, maxOf(len, 0), rxIds, rxDlcs, rxData)
+            rxBacklog = n == MAX_RX_FRAMES
+            framesReceived += n
+            return n
+        } catch (e: IOException) {
+            rxBacklog = false
+            return 0 // Normal timeout or error
+        }
     }
     
     /**
-     * Advance tail by n bytes
+     * Read and dispatch in native code (see can_dispatch.h)
+     * 
+     * Frames go straight to the handler table; nothing is copied back.
+     * 
+     * @return number of frames decoded (0 on timeout)
      */
-    private fun consume(n: Int) {
-        tail = (tail + n) % BUFFER_SIZE
-        count -= n
+    fun readAndDispatch(nowMs: Long): Int {
+        try {
+            val len = port.read(readBuffer, READ_TIMEOUT)
+            val n = NativeCore.wsDecodeDispatch(readBuffer, maxOf(len, 0), nowMs)
+            framesReceived += n
+            return n
+        } catch (e: IOException) {
+            return 0 // Normal timeout or error
+        }
     }
     
     /**
-     * Parse next valid CAN frame from buffer
+     * Read the next frame (allocates; kept for single-frame callers)
+     * 
+     * @return next decoded frame, or null if none after one USB read
      */
-    private fun parseNextFrame(): CANFrame? {
-        // Need at least 5 bytes for minimal frame (Header+Info+ID+ID+Footer)
-        while (count >= 5) {
-            // Check for Header
-            if (peek(0) != FRAME_HEADER) {
-                consume(1) // Skip garbage
-                continue
-            }
-            
-            // We have a header. Check INFO byte for length
-            val info = peek(1).toInt() and 0xFF
-            val dlc = info and 0x0F
-            
-            // Total frame length: Header(1) + Info(1) + ID(2) + Data(DLC) + Footer(1)
-            val frameLen = 1 + 1 + 2 + dlc + 1
-            
-            if (count < frameLen) {
-                // Wait for more data
-                return null
-            }
-            
-            // Check Footer
-            if (peek(frameLen - 1) != FRAME_FOOTER) {
-                // Invalid frame structure, skip header and retry
-                consume(1)
-                continue
-            }
-            
-            // Valid Frame! Extract data
-            val idLow = peek(2).toInt() and 0xFF
-            val idHigh = peek(3).toInt() and 0xFF
-            val canId = idLow or (idHigh shl 8)
-            
-            val data = ByteArray(dlc)
-            for (i in 0 until dlc) {
-                data[i] = peek(4 + i)
-            }
-            
-            // Consume this frame
-            consume(frameLen)
-            framesReceived++
-            
-            return CANFrame(canId, data)
+    fun readFrame(): CANFrame? {
+        if (rxIndex >= rxCount) {
+            rxCount = readFrames()
+            rxIndex = 0
+            if (rxCount == 0) return null
         }
-        return null
+        val i = rxIndex++
+        val dlc = rxDlcs[i].toInt()
+        return CANFrame(rxIds[i], rxData.copyOfRange(i * MAX_DLC, i * MAX_DLC + dlc))
     }
     
     /**
@@ -207,8 +211,16 @@ class WaveshareAdapter(private val port: UsbSerialPort) {
         }
     }
     
+    /**
+     * Native codec counters:
+     * [encoded, decoded, bytesIn, bytesDropped, garbage, badFrames, encodeOverflows]
+     */
+    fun getCodecStats(): LongArray = NativeCore.wsGetStats()
+    
     fun getStats(): String {
-        return "TX: $framesSent, RX: $framesReceived, ERR: $errors"
+        val codec = getCodecStats()
+        return "TX: $framesSent, RX: $framesReceived, ERR: $errors, " +
+            "DROP: ${codec[3]}B, BAD: ${codec[5]}, SKIP: ${codec[4]}B"
     }
 
     fun close() {
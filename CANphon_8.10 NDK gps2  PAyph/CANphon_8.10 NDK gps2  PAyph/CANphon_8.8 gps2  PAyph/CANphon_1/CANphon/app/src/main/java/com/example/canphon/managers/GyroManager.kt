@@ -147,6 +147,9 @@ class GyroManager(context: Context) : SensorEventListener {
         pitch = calibratedPitch
         yaw = smoothedYaw
         
+        // Latest attitude for the native control thread (read on its next tick)
+        NativeCore.controlSetAttitude(roll, pitch, yaw)
+        
         onOrientationChanged?.invoke(roll, pitch, yaw)
     }
 
@@ -18,8 +18,15 @@ import com.hoho.android.usbserial.driver.UsbSerialPort
 import com.hoho.android.usbserial.driver.UsbSerialProber
 import com.example.canphon.protocols.UnifiedProtocol
 import com.example.canphon.protocols.FeedbackParser
+import com.example.canphon.native_sensors.NativeCore
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.util.concurrent.Executors
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.TimeUnit
 import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicIntegerArray
 
 /**
  * Hybrid Bus Manager for CAN + Serial Servo Communication
@@ -43,6 +50,50 @@ class SharedBusManager private constructor() {
         // Serial mode baud rate
         private const val SERIAL_BAUD_RATE = 115200
         
+        // Upper bound on actuators across all bridges on the bus
+        const val MAX_CHANNELS = WaveshareAdapter.MAX_BATCH_FRAMES
+        
+        // Native receive state layout (CanDispatchShared in can_dispatch.h)
+        private const val RX_STATE_STRIDE = 16          // Per channel: position(f32) frames(u32) lastMs(i64)
+        private const val RX_FRAMES_TOTAL = MAX_CHANNELS * RX_STATE_STRIDE
+        private const val RX_ESTIMATE_BASE = RX_FRAMES_TOTAL + 32  // After counters + last frame
+        private const val RX_ESTIMATE_STRIDE = 32       // CanServoEstimate: 6 × f32, flags(u32), lagSamples(u32)
+        private const val EST_VELOCITY = 4
+        private const val EST_LAG_MS = 8
+        private const val EST_STEADY_ERROR = 12
+        private const val EST_TRACKING_ERROR = 16
+        private const val EST_FLAGS = 24
+        
+        // CanServoEstimate.flags (servo_estimator.h)
+        const val SERVO_STALLED = 0x08
+        const val SERVO_SATURATED = 0x10
+        const val SERVO_RATE_LIMITED = 0x20
+        
+        // CAN bus log: native ring, exported as candump -l on disconnect
+        private const val CAN_LOG_CAPACITY = 262144     // Frames (~1 min at 4 kframes/s)
+        private const val CAN_LOG_DIR = "can_logs"
+        private const val CAN_LOG_IFACE = "can0"
+        
+        // Native receive thread (usbfs): Process.THREAD_PRIORITY_URGENT_DISPLAY,
+        // no SCHED_FIFO (refused for apps), any CPU
+        private const val RX_THREAD_NICE = -8
+        private const val RX_THREAD_RT_PRIORITY = 0
+        private const val RX_THREAD_CPU_MASK = 0
+        
+        // Native control thread: 200 Hz (rotation vector at SENSOR_DELAY_FASTEST),
+        // one step above the receive thread, same 1° send filter as sendAllServoCommands
+        private const val CONTROL_PERIOD_US = 5000
+        private const val CONTROL_THREAD_NICE = -10
+        private const val CONTROL_THREAD_RT_PRIORITY = 0
+        private const val CONTROL_THREAD_CPU_MASK = 0
+        private const val CONTROL_SEND_THRESHOLD_DEG = 1.0f
+        
+        // Chart history: command + feedback series per channel (~80 s of 100 Hz feedback)
+        private const val SERIES_CAPACITY = 8192
+        
+        // L431 power unit reply timeout
+        private const val L431_TIMEOUT_MS = 100
+        
         @Volatile
         private var instance: SharedBusManager? = null
         
@@ -67,6 +118,40 @@ class SharedBusManager private constructor() {
     var connectedServos = 4
         private set
     
+    // ==================== Servo Layout ====================
+    
+    // Actuators across all bridges, in command order (default: 1 bridge, X-mix)
+    val servoLayout: List<CANServoProtocol.ServoChannel> = CANServoProtocol.X_LAYOUT
+    
+    // Feedback written by the native dispatcher on the read thread
+    private val rxState: ByteBuffer = NativeCore.canDispatchInit().order(ByteOrder.nativeOrder())
+    
+    init {
+        NativeCore.l431Init(L431_TIMEOUT_MS)
+        NativeCore.seriesInit(2 * MAX_CHANNELS, SERIES_CAPACITY)
+        installRxHandlers(servoLayout)
+    }
+    
+    /**
+     * Route feedback IDs (0x580 + node) of the layout to their channels.
+     * Runs once, from init: the dispatch table and estimator state are not
+     * guarded against a running read thread, and no read thread exists yet.
+     */
+    private fun installRxHandlers(layout: List<CANServoProtocol.ServoChannel>) {
+        NativeCore.canDispatchClear()
+        NativeCore.l431Install()
+        NativeCore.servoEstReset()
+        NativeCore.seriesClear()
+        layout.forEachIndexed { i, ch ->
+            NativeCore.canDispatchSetServo(CANServoProtocol.getRxId(ch.nodeId), i)
+            NativeCore.servoEstSetChannel(CANServoProtocol.getTxId(ch.nodeId), i)
+        }
+        NativeCore.controlSetLayout(
+            IntArray(layout.size) { layout[it].nodeId },
+            FloatArray(layout.size) { layout[it].rollGain },
+            FloatArray(layout.size) { layout[it].pitchGain })
+    }
+    
     var lastError: String = ""
         private set
     
@@ -74,36 +159,68 @@ class SharedBusManager private constructor() {
     
     // ==================== Telemetry Tracking ====================
     
-    // Last commanded servo positions
-    @Volatile var lastS1Cmd: Float = 0f
-        private set
-    @Volatile var lastS2Cmd: Float = 0f
-        private set
-    @Volatile var lastS3Cmd: Float = 0f
-        private set
-    @Volatile var lastS4Cmd: Float = 0f
-        private set
+    // Per-channel state, indexed like servoLayout. lastCmd holds float bits:
+    // written on canExecutor / by stopNativeControl, read from the UI
+    private val lastCmd = AtomicIntegerArray(MAX_CHANNELS)
+    private val mixed = FloatArray(MAX_CHANNELS)
+    private val batch = ArrayList<CANFrame>(MAX_CHANNELS)
+    
+    // Last commanded servo positions (first four channels)
+    val lastS1Cmd: Float get() = getCommand(0)
+    val lastS2Cmd: Float get() = getCommand(1)
+    val lastS3Cmd: Float get() = getCommand(2)
+    val lastS4Cmd: Float get() = getCommand(3)
     
     // Servo feedback (actual positions from CAN)
-    @Volatile var s1Feedback: Float = -999.9f
-        private set
-    @Volatile var s2Feedback: Float = -999.9f
-        private set
-    @Volatile var s3Feedback: Float = -999.9f
-        private set
-    @Volatile var s4Feedback: Float = -999.9f
-        private set
+    val s1Feedback: Float get() = getFeedback(0)
+    val s2Feedback: Float get() = getFeedback(1)
+    val s3Feedback: Float get() = getFeedback(2)
+    val s4Feedback: Float get() = getFeedback(3)
+    
+    fun getCommand(channel: Int): Float =
+        if (nativeControl) NativeCore.controlGetCommand(channel) else Float.fromBits(lastCmd.get(channel))
+    fun getFeedback(channel: Int): Float = rxState.getFloat(channel * RX_STATE_STRIDE)  // -999.9 = none yet
+    
+    // Response estimates (native, from sent commands + timestamped feedback)
+    private fun estimate(channel: Int, field: Int) = RX_ESTIMATE_BASE + channel * RX_ESTIMATE_STRIDE + field
+    fun getVelocity(channel: Int): Float = rxState.getFloat(estimate(channel, EST_VELOCITY))  // deg/s
+    fun getLagMs(channel: Int): Float = rxState.getFloat(estimate(channel, EST_LAG_MS))
+    fun getSteadyError(channel: Int): Float = rxState.getFloat(estimate(channel, EST_STEADY_ERROR))  // deg
+    fun getTrackingError(channel: Int): Float = rxState.getFloat(estimate(channel, EST_TRACKING_ERROR))  // deg
+    fun getServoFlags(channel: Int): Int = rxState.getInt(estimate(channel, EST_FLAGS))  // SERVO_* bits
+    
+    /**
+     * Command or feedback history of a channel over the last [windowMs],
+     * reduced to at most [maxPoints] (x = seconds before now)
+     * 
+     * @param method NativeCore.SERIES_DECIMATE_*
+     * @return points written to outX / outY
+     */
+    fun getChartSeries(channel: Int, feedback: Boolean, windowMs: Long, method: Int, maxPoints: Int,
+                       outX: FloatArray, outY: FloatArray): Int {
+        val series = if (feedback) NativeCore.seriesFeedback(channel) else NativeCore.seriesCommand(channel)
+        return NativeCore.seriesDecimate(series, windowMs, method, maxPoints, outX, outY)
+    }
     
-    // Servo online status (bitmask: bit0=S1, bit1=S2, bit2=S3, bit3=S4)
+    /**
+     * Serial mode has no native command / feedback path: sample the first
+     * four channels into the chart history instead
+     */
+    fun sampleSerialChartSeries() {
+        if (!isSerialMode) return
+        for (ch in 0 until 4) {
+            NativeCore.seriesAppend(NativeCore.seriesCommand(ch), Float.fromBits(lastCmd.get(ch)))
+            val fb = getFeedback(ch)
+            if (fb > -900) NativeCore.seriesAppend(NativeCore.seriesFeedback(ch), fb)
+        }
+    }
+    
+    // Servo online status (bitmask: bit N = layout channel N)
     var servoOnlineStatus: Int = 0
         private set
     
     // Feedback timeout tracking (ms)
     private val feedbackTimeout = 500L
-    private var lastS1FeedbackTime: Long = 0
-    private var lastS2FeedbackTime: Long = 0
-    private var lastS3FeedbackTime: Long = 0
-    private var lastS4FeedbackTime: Long = 0
     
     // Serial mode connection and protocols
     private var serialConnection: UsbDeviceConnection? = null
@@ -113,11 +230,17 @@ class SharedBusManager private constructor() {
     private val extraProtocol = UnifiedProtocol.createExtra()
     private val serialFeedbackParser = FeedbackParser()
     
-    // Raw CAN debug - stores last received frames for display
-    @Volatile var lastRawCanFrame: String = "No CAN data"
-        private set
-    @Volatile var rawFrameCount: Int = 0
-        private set
+    // Raw CAN debug - formatted only when the UI asks
+    val rawFrameCount: Int
+        get() = rxState.getLong(RX_FRAMES_TOTAL).toInt()
+    val lastRawCanFrame: String
+        get() {
+            val count = rawFrameCount
+            return if (count == 0) "No CAN data" else "${NativeCore.canDispatchLastFrame()} #$count"
+        }
+        
+    // Where saveCanLog() writes (app files dir, known once connected with a Context)
+    private var canLogDir: File? = null
         
     // Debug Counters
     @Volatile var txCount: Long = 0
@@ -132,30 +255,43 @@ class SharedBusManager private constructor() {
         java.util.concurrent.ArrayBlockingQueue(1), // AGGRESSIVE: Keep only 1 latest command
         java.util.concurrent.ThreadPoolExecutor.DiscardOldestPolicy()
     )
-    private val readExecutor = Executors.newSingleThreadExecutor() // READ only
+    private val readExecutor = Executors.newSingleThreadExecutor() // READ only (fallback)
     private val isWriting = AtomicBoolean(false)
+    
+    // CAN mode USB connection (its fd feeds the native receive thread)
+    private var usbConnection: UsbDeviceConnection? = null
+    @Volatile private var nativeReadLoop = false
+    
+    // Servo commands sent by the native control thread (sendAllServoCommands is a no-op)
+    @Volatile var nativeControl = false
+        private set
+    
+    // Kotlin read loop cost, for comparison with canRxThreadGetStats
+    @Volatile private var readLoopCpuNs = 0L
+    @Volatile private var readLoopWallNs = 0L
 
 
 
     /**
-     * Start the continuous read loop
+     * Start the continuous read loop: the native receive thread on the
+     * adapter's bulk endpoints, or the Kotlin loop if that cannot start
      */
     private fun startReadLoop() {
+        if (startNativeReadLoop()) return
+        
         readExecutor.execute {
             Log.i(TAG, "🔄 Read Loop Started")
+            val cpuStart = android.os.Debug.threadCpuTimeNanos()
+            val wallStart = System.nanoTime()
             while (isConnected) {
                 try {
-                    // Blocking read (or with timeout)
-                    // If no data, readFrame returns null (after timeout)
-                    val frame = waveshare?.readFrame()
-                    
-                    if (frame != null) {
-                        processFrame(frame)
-                    } else {
-                        // Optional: Small sleep if needed to prevent CPU spin 
-                        // (only if readFrame is non-blocking and returns immediately)
-                        // If underlying read has timeout, this isn't strictly necessary.
-                    }
+                    // One USB read (with timeout), frames decoded and dispatched natively
+                    val adapter = waveshare ?: break
+                    val now = System.currentTimeMillis()
+                    adapter.readAndDispatch(now)
+                    updateServoOnlineStatus(now)
+                    readLoopCpuNs = android.os.Debug.threadCpuTimeNanos() - cpuStart
+                    readLoopWallNs = System.nanoTime() - wallStart
                 } catch (e: Exception) {
                     if (isConnected) {
                         Log.e(TAG, "Read loop error: ${e.message}")
@@ -167,61 +303,27 @@ class SharedBusManager private constructor() {
             Log.i(TAG, "⏹ Read Loop Stopped")
         }
     }
-
+    
     /**
-     * Process a single received frame
+     * Hand the USB IN endpoint to the native receive thread.
+     * Frames land in rxState; nothing is read through serialPort after this
      */
-    private fun processFrame(frame: CANFrame) {
-        try {
-            val currentTime = System.currentTimeMillis()
-            
-            // Store raw frame for debug display
-            rawFrameCount++
-            // Optimization: Only format string if debug logging is enabled or needed for UI
-            // match UI expectations for "lastRawCanFrame"
-            val hexData = frame.data.joinToString(" ") { 
-                String.format("%02X", it.toInt() and 0xFF) 
-            }
-            lastRawCanFrame = "ID:0x${frame.id.toString(16).uppercase()} [${hexData}] #$rawFrameCount"
-            
-            // Parse feedback based on CAN ID (0x581-0x584)
-            val nodeId = frame.id - CANServoProtocol.RX_OFFSET
-            
-            // Check if this is a valid servo feedback ID
-            if (nodeId in 1..4) {
-                val position = CANServoProtocol.parsePositionFeedback(frame.data)
-                
-                if (position != null) {
-                    when (nodeId) {
-                        CANServoProtocol.SERVO_1 -> {
-                            s1Feedback = position
-                            lastS1FeedbackTime = currentTime
-                        }
-                        CANServoProtocol.SERVO_2 -> {
-                            s2Feedback = position
-                            lastS2FeedbackTime = currentTime
-                        }
-                        CANServoProtocol.SERVO_3 -> {
-                            s3Feedback = position
-                            lastS3FeedbackTime = currentTime
-                        }
-                        CANServoProtocol.SERVO_4 -> {
-                            s4Feedback = position
-                            lastS4FeedbackTime = currentTime
-                        }
-                    }
-                }
-            }
-            
-            // Update online status periodically (not every frame to save CPU?)
-            // Or just do it here, it's cheap bitwise ops.
-            updateServoOnlineStatus(currentTime)
-            
-        } catch (e: Exception) {
-            Log.w(TAG, "Frame processing error: ${e.message}")
+    private fun startNativeReadLoop(): Boolean {
+        val port = serialPort ?: return false
+        val connection = usbConnection ?: return false
+        val epIn = port.readEndpoint?.address ?: return false
+        val epOut = port.writeEndpoint?.address ?: return false
+        
+        nativeReadLoop = NativeCore.canRxThreadStartUsb(connection.fileDescriptor, epIn, epOut,
+            RX_THREAD_NICE, RX_THREAD_RT_PRIORITY, RX_THREAD_CPU_MASK)
+        if (nativeReadLoop) {
+            Log.i(TAG, "🔄 Native read thread started (IN 0x${epIn.toString(16)})")
+        } else {
+            Log.w(TAG, "Native read thread unavailable, using the Kotlin read loop")
         }
+        return nativeReadLoop
     }
-    
+
     // Legacy method - kept for compatibility but empties as loop handles it
     fun processFeedback() {
         // No-op: Reading is now handled by the background read loop
@@ -296,6 +398,7 @@ class SharedBusManager private constructor() {
             return false
         }
         
+        usbConnection = connection
         serialPort = driver.ports[0].apply {
             open(connection)
             setParameters(WaveshareAdapter.BAUD_RATE, 8, UsbSerialPort.STOPBITS_1, UsbSerialPort.PARITY_NONE)
@@ -313,6 +416,9 @@ class SharedBusManager private constructor() {
         connectedDeviceName = device.deviceName
         lastError = ""
         
+        context?.let { canLogDir = File(it.filesDir, CAN_LOG_DIR) }
+        NativeCore.canRecorderStart(CAN_LOG_CAPACITY)
+        
         Log.i(TAG, "✅ Connected to ${device.deviceName} in CAN MODE at ${WaveshareAdapter.BAUD_RATE} baud")
         onConnectionChanged?.invoke(true, "CAN Mode Connected")
         
@@ -386,66 +492,50 @@ class SharedBusManager private constructor() {
     }
     
     /**
-     * Send commands to all 4 servos using X-Configuration Mixing
+     * Send commands to every servo in servoLayout
      * 
-     * ORIGINAL PROJECT FORMULA:
+     * Each channel is mixed as rollGain*Roll + pitchGain*Pitch. The default
+     * layout is the ORIGINAL PROJECT X-FORMULA:
      * Servo 1 (Front-Left):  -Roll + Pitch
      * Servo 2 (Front-Right): +Roll + Pitch
      * Servo 3 (Back-Left):   -Roll - Pitch
      * Servo 4 (Back-Right):  +Roll - Pitch
+     * 
+     * CAN mode sends all changed channels, across all bridges, as one
+     * batched USB write (one burst on the bus) per call.
      */
     fun sendAllServoCommands(roll: Float, pitch: Float, yaw: Float) {
-        // X-Configuration Mixing (Original Formula, ±25° range)
-        val s1 = (-roll + pitch).coerceIn(-25f, 25f)  // Front-Left
-        val s2 = (+roll + pitch).coerceIn(-25f, 25f)  // Front-Right
-        val s3 = (-roll - pitch).coerceIn(-25f, 25f)  // Back-Left
-        val s4 = (+roll - pitch).coerceIn(-25f, 25f)  // Back-Right
-        
-        // Store last commanded positions for telemetry
-        // Store last commanded positions for telemetry - MOVED TO SEND BLOCK
-        // lastS1Cmd = s1
-        // lastS2Cmd = s2
-        // lastS3Cmd = s3
-        // lastS4Cmd = s4
-        
-        if (!isConnected) return
+        if (!isConnected || nativeControl) return
         
-        // Skip if previous write still in progress (prevents USB buffer overflow)
-        if (isWriting.get()) return
+        // Skip if a previous write (or a heartbeat flush) still owns the
+        // adapter; claimed atomically, like flushL431Heartbeat
+        if (!isWriting.compareAndSet(false, true)) return
         
         // Send on background thread - NO BLOCKING on main thread!
-        isWriting.set(true)
         canExecutor.execute {
             try {
+                val layout = servoLayout
+                mixServos(layout, roll, pitch, mixed)
+                
                 if (isSerialMode) {
-                    // Serial Mode: Use UnifiedProtocol
-                    sendSerialCommands(s1, s2, s3, s4)
+                    // Serial Mode: Use UnifiedProtocol (first four channels)
+                    sendSerialCommands(mixed[0], mixed[1], mixed[2], mixed[3])
                 } else {
                     // CAN Mode: Use CANServoProtocol WITH AGGRESSIVE JITTER FILTER
                     // Filter: Only send if change > 1.0 degrees (Ignore small noise)
-                    if (Math.abs(s1 - lastS1Cmd) > 1.0f) {
-                        sendServoCommand(CANServoProtocol.SERVO_1, s1)
-                        lastS1Cmd = s1
-                        Thread.sleep(2)  // Prevent USB buffer overflow
-                    }
-                    
-                    if (Math.abs(s2 - lastS2Cmd) > 1.0f) {
-                        sendServoCommand(CANServoProtocol.SERVO_2, s2)
-                        lastS2Cmd = s2
-                        Thread.sleep(2)
+                    batch.clear()
+                    for (i in layout.indices) {
+                        if (Math.abs(mixed[i] - Float.fromBits(lastCmd.get(i))) > 1.0f) {
+                            batch.add(CANServoProtocol.createPositionCommand(layout[i].nodeId, mixed[i]))
+                            lastCmd.set(i, mixed[i].toRawBits())
+                        }
                     }
                     
-                    if (Math.abs(s3 - lastS3Cmd) > 1.0f) {
-                        sendServoCommand(CANServoProtocol.SERVO_3, s3)
-                        lastS3Cmd = s3
-                        Thread.sleep(2)
-                    }
+                    // Pending L431 heartbeat rides along in the same USB write
+                    appendL431Heartbeat(batch)
                     
-                    if (Math.abs(s4 - lastS4Cmd) > 1.0f) {
-                        sendServoCommand(CANServoProtocol.SERVO_4, s4)
-                        lastS4Cmd = s4
-                        Thread.sleep(2)
-                    }
+                    // Single write for all bridges; each bridge paces its own serial bus
+                    waveshare?.sendFrames(batch)
                 }
                 
                 // Increment TX Count
@@ -456,6 +546,8 @@ class SharedBusManager private constructor() {
                 errorCount++
             } finally {
                 isWriting.set(false)
+                // Queued after this batch had taken its frames: send it now
+                if (l431HeartbeatPending.get()) flushL431Heartbeat()
             }
         }
     }
@@ -476,21 +568,88 @@ class SharedBusManager private constructor() {
     }
     
     /**
-     * Get servo positions for UI
+     * Mix roll/pitch into per-channel angles (±25° range)
+     */
+    private fun mixServos(layout: List<CANServoProtocol.ServoChannel>, roll: Float, pitch: Float, out: FloatArray) {
+        for (i in layout.indices) {
+            val ch = layout[i]
+            out[i] = (ch.rollGain * roll + ch.pitchGain * pitch).coerceIn(-25f, 25f)
+        }
+    }
+    
+    // ==================== Native Control Thread ====================
+    
+    /**
+     * Hand servo commands to the native control thread: it mixes and sends
+     * every CONTROL_PERIOD_US from the latest NativeCore.controlSetAttitude /
+     * controlSetTrackingError, independent of the UI looper. Needs the native
+     * receive thread (commands go out on its transport). Switches the mode
+     * if already running
+     * 
+     * @param mode NativeCore.CONTROL_MODE_*
+     * @return false if native control is not available (keep the Kotlin loop)
+     */
+    fun startNativeControl(mode: Int): Boolean {
+        if (!isConnected || isSerialMode || !nativeReadLoop) return false
+        NativeCore.controlSetMode(mode)
+        if (nativeControl && NativeCore.controlThreadRunning()) return true
+        
+        nativeControl = NativeCore.controlThreadStart(CONTROL_PERIOD_US, CONTROL_THREAD_NICE,
+            CONTROL_THREAD_RT_PRIORITY, CONTROL_THREAD_CPU_MASK, CONTROL_SEND_THRESHOLD_DEG)
+        if (nativeControl) Log.i(TAG, "🎮 Native control thread started (mode $mode)")
+        return nativeControl
+    }
+    
+    /**
+     * Stop the native control thread; sendAllServoCommands sends again,
+     * continuing from the commands the thread sent last
+     */
+    fun stopNativeControl() {
+        if (!nativeControl) return
+        NativeCore.controlSetMode(NativeCore.CONTROL_MODE_HOLD)
+        NativeCore.controlThreadStop()
+        NativeCore.controlGetCommands(servoLayout.size).forEachIndexed { i, cmd -> lastCmd.set(i, cmd.toRawBits()) }
+        nativeControl = false
+        Log.i(TAG, "⏹ Native control thread stopped: ${getControlStats()} | ${getCoreStats()}")
+    }
+    
+    /**
+     * Control loop timing: wake-up jitter against the timer, overruns, work per tick
+     */
+    fun getControlStats(): String {
+        val s = NativeCore.controlThreadGetStats()
+        if (s[0] == 0L) return "CTRL: not started"
+        val cpu = if (s[13] > 0) 100.0 * s[12] / s[13] else 0.0
+        return String.format(java.util.Locale.US,
+            "CTRL: %d ticks, %d overruns, jitter p99 %dus max %dus, work %dus, cpu %.2f%%, %d sends%s",
+            s[0], s[1], s[8], s[9], s[10], cpu, s[2],
+            (if (s[5] > 0) ", ${s[5]} stale" else "") + if (s[16] == 0L) " (stopped)" else "")
+    }
+    
+    /**
+     * Commands into the native core (guidance / fusion / telemetry) and who applied them
+     */
+    fun getCoreStats(): String {
+        val s = NativeCore.coreOwnerGetStats()
+        return "CORE: %d applied in %d control / %d caller drains, %d dropped, queue max %d, %d off-owner calls".format(
+            s[1], s[4], s[3], s[2], s[8], s[7])
+    }
+    
+    /**
+     * Get servo positions for UI (always at least 4 entries)
      */
     fun getServoPositions(roll: Float, pitch: Float): FloatArray {
-        return floatArrayOf(
-            (-roll + pitch).coerceIn(-25f, 25f),
-            (+roll + pitch).coerceIn(-25f, 25f),
-            (-roll - pitch).coerceIn(-25f, 25f),
-            (+roll - pitch).coerceIn(-25f, 25f)
-        )
+        val layout = servoLayout
+        val out = FloatArray(maxOf(4, layout.size))
+        mixServos(layout, roll, pitch, out)
+        return out
     }
     
     /**
      * Read feedback from servos
      */
     fun readFeedback(): CANFrame? {
+        if (nativeReadLoop) return null  // The native thread owns the IN endpoint
         return waveshare?.readFrame()
     }
     
@@ -498,7 +657,25 @@ class SharedBusManager private constructor() {
      * Get adapter statistics
      */
     fun getStats(): String {
-        return waveshare?.getStats() ?: "Not connected"
+        val adapter = waveshare ?: return "Not connected"
+        val control = if (nativeControl) " | ${getControlStats()}" else ""
+        return "${adapter.getStats()} | ${getReadLoopStats()}$control"
+    }
+    
+    /**
+     * Receive path cost: CPU share of the read thread and frames per wakeup
+     */
+    fun getReadLoopStats(): String {
+        if (nativeReadLoop) {
+            val s = NativeCore.canRxThreadGetStats()
+            val cpu = if (s[5] > 0) 100.0 * s[4] / s[5] else 0.0
+            val perWakeup = if (s[0] > 0) s[2].toDouble() / s[0] else 0.0
+            return String.format(java.util.Locale.US, "RX native: cpu %.2f%%, %d frames, %.1f/wakeup, %d err%s",
+                cpu, s[2], perWakeup, s[3], if (s[8] == 0L) " (stopped)" else "")
+        }
+        val wall = readLoopWallNs
+        val cpu = if (wall > 0) 100.0 * readLoopCpuNs / wall else 0.0
+        return String.format(java.util.Locale.US, "RX kotlin: cpu %.2f%%", cpu)
     }
 
     /**
@@ -506,9 +683,18 @@ class SharedBusManager private constructor() {
      */
     fun disconnect() {
         try {
+            if (waveshare != null) saveCanLog()
+            // The control thread sends on the receive thread's transport
+            stopNativeControl()
+            // URBs are released before the port gives up the interface
+            if (nativeReadLoop) {
+                NativeCore.canRxThreadStop()
+                nativeReadLoop = false
+            }
             waveshare?.close()
             waveshare = null
             serialPort = null
+            usbConnection = null
             isConnected = false
             isSerialMode = false
             Log.i(TAG, "Disconnected")
@@ -517,6 +703,25 @@ class SharedBusManager private constructor() {
         }
     }
     
+    /**
+     * Export the recorded CAN traffic (newest ring contents) as candump -l text
+     * @return the log file, or null if nothing was recorded / no files dir
+     */
+    fun saveCanLog(): File? {
+        val dir = canLogDir ?: return null
+        if (!dir.isDirectory && !dir.mkdirs()) return null
+        
+        val stamp = java.text.SimpleDateFormat("yyyyMMdd_HHmmss", java.util.Locale.US).format(java.util.Date())
+        val file = File(dir, "can_$stamp.log")
+        val frames = NativeCore.canRecorderExportCandump(file.absolutePath, CAN_LOG_IFACE)
+        if (frames <= 0) {
+            file.delete()
+            return null
+        }
+        Log.i(TAG, "💾 CAN log: $frames frames → ${file.name}")
+        return file
+    }
+    
     fun getPermissionAction(): String = ACTION_USB_PERMISSION
     
     /**
@@ -534,20 +739,8 @@ class SharedBusManager private constructor() {
      * Update servo online status bitmask based on feedback timeout
      */
     private fun updateServoOnlineStatus(currentTime: Long) {
-        var status = 0
-        
-        if (currentTime - lastS1FeedbackTime < feedbackTimeout) {
-            status = status or 0x01  // Bit 0 = Servo 1
-        }
-        if (currentTime - lastS2FeedbackTime < feedbackTimeout) {
-            status = status or 0x02  // Bit 1 = Servo 2
-        }
-        if (currentTime - lastS3FeedbackTime < feedbackTimeout) {
-            status = status or 0x04  // Bit 2 = Servo 3
-        }
-        if (currentTime - lastS4FeedbackTime < feedbackTimeout) {
-            status = status or 0x08  // Bit 3 = Servo 4
-        }
+        // Bit N = channel N
+        val status = NativeCore.canDispatchOnlineMask(servoLayout.size, currentTime, feedbackTimeout)
         
         servoOnlineStatus = status
         
@@ -559,20 +752,61 @@ class SharedBusManager private constructor() {
      * Update TelemetryStreamer with current servo data
      */
     fun updateTelemetry() {
+        // The native receive thread does not refresh the status itself
+        if (nativeReadLoop) updateServoOnlineStatus(System.currentTimeMillis())
         TelemetryStreamer.updateServoCommands(lastS1Cmd, lastS2Cmd, lastS3Cmd, lastS4Cmd)
         TelemetryStreamer.updateServoFeedback(s1Feedback, s2Feedback, s3Feedback, s4Feedback)
         TelemetryStreamer.updateServoStatus(servoOnlineStatus)
     }
     
+    // ==================== Bridge Node Config ====================
+    
     // ==================== L431 Power Control ====================
     
+    // Periodic heartbeat (0 = only on sendL431Heartbeat). Rides along with a
+    // servo batch when one is due, otherwise its own timer sends it
+    @Volatile var l431HeartbeatIntervalMs = 0L
+        set(value) {
+            field = value
+            scheduleL431Heartbeat(value)
+        }
+    
+    // Heartbeat requested / last sent
+    private val l431HeartbeatPending = AtomicBoolean(false)
+    @Volatile private var l431LastHeartbeatMs = 0L
+    
+    private val l431Timer = Executors.newSingleThreadScheduledExecutor { r ->
+        Thread(r, "l431-heartbeat").apply { isDaemon = true }
+    }
+    private var l431TimerTask: ScheduledFuture<*>? = null
+    
+    /**
+     * Send a sequenced request to the L431; the status reply is matched
+     * natively, so this never waits for it (see getL431Stats)
+     * 
+     * @return false if not connected, too many requests in flight, or the write failed
+     */
+    fun sendL431(vararg commands: Byte): Boolean {
+        if (!isConnected || isSerialMode || waveshare == null) return false
+        val frame = buildL431Request(commands) ?: return false
+        return waveshare?.sendFrame(frame) ?: false
+    }
+    
+    private fun buildL431Request(commands: ByteArray): CANFrame? {
+        val seq = NativeCore.l431Submit(commands)
+        if (seq < 0) {
+            Log.w(TAG, "L431: too many requests in flight")
+            return null
+        }
+        return L431Protocol.createRequest(seq, commands)
+    }
+    
     fun sendL431PowerOn(): Boolean {
         if (!isConnected || isSerialMode || waveshare == null) {
             Log.w(TAG, "L431 PowerOn: CAN not connected")
             return false
         }
-        val frame = L431Protocol.createPowerOnCommand()
-        val success = waveshare?.sendFrame(frame) ?: false
+        val success = sendL431(L431Protocol.CMD_POWER_ON)
         if (success) Log.i(TAG, "⚡ L431 Power ON sent")
         return success
     }
@@ -582,16 +816,85 @@ class SharedBusManager private constructor() {
             Log.w(TAG, "L431 PowerOff: CAN not connected")
             return false
         }
-        val frame = L431Protocol.createPowerOffCommand()
-        val success = waveshare?.sendFrame(frame) ?: false
+        val success = sendL431(L431Protocol.CMD_POWER_OFF)
         if (success) Log.i(TAG, "🔴 L431 Power OFF sent")
         return success
     }
     
+    /**
+     * Send a heartbeat off the caller's thread: with the servo batch in
+     * flight if there is one, otherwise in its own USB write right away
+     */
     fun sendL431Heartbeat(): Boolean {
         if (!isConnected || isSerialMode || waveshare == null) return false
-        val frame = L431Protocol.createHeartbeatCommand()
-        return waveshare?.sendFrame(frame) ?: false
+        l431HeartbeatPending.set(true)
+        flushL431Heartbeat()
+        return true
+    }
+    
+    /**
+     * Send a queued or due heartbeat on its own. A servo batch in flight
+     * takes it instead (or flushes it once done)
+     */
+    private fun flushL431Heartbeat() {
+        if (!isWriting.compareAndSet(false, true)) return
+        canExecutor.execute {
+            try {
+                val frames = ArrayList<CANFrame>(1)
+                appendL431Heartbeat(frames)
+                if (frames.isNotEmpty()) waveshare?.sendFrames(frames)
+            } catch (e: Exception) {
+                Log.e(TAG, "L431 heartbeat error: ${e.message}")
+            } finally {
+                isWriting.set(false)
+            }
+        }
+    }
+    
+    private fun scheduleL431Heartbeat(intervalMs: Long) {
+        synchronized(l431Timer) {
+            l431TimerTask?.cancel(false)
+            l431TimerTask = if (intervalMs > 0) {
+                l431Timer.scheduleAtFixedRate({
+                    if (isConnected && !isSerialMode && waveshare != null) flushL431Heartbeat()
+                }, intervalMs, intervalMs, TimeUnit.MILLISECONDS)
+            } else null
+        }
+    }
+    
+    /**
+     * Add a heartbeat request to a CAN batch when one is queued or due
+     */
+    private fun appendL431Heartbeat(frames: MutableList<CANFrame>) {
+        val now = System.currentTimeMillis()
+        val interval = l431HeartbeatIntervalMs
+        val due = interval > 0 && now - l431LastHeartbeatMs >= interval
+        if (!l431HeartbeatPending.getAndSet(false) && !due) return
+        if (frames.size >= MAX_CHANNELS) {
+            l431HeartbeatPending.set(true)  // Next batch
+            return
+        }
+        buildL431Request(byteArrayOf(L431Protocol.CMD_HEARTBEAT))?.let {
+            frames.add(it)
+            l431LastHeartbeatMs = now
+        }
+    }
+    
+    /**
+     * L431 link: round trip and last reported rail state
+     */
+    fun getL431Stats(): String {
+        val s = NativeCore.l431GetStats()
+        val rails = if (s[12] < 0) "?" else {
+            val r = s[12].toInt()
+            (if (r and L431Protocol.RAIL_PA9 != 0) "PA9 " else "") +
+                (if (r and L431Protocol.RAIL_PA10 != 0) "PA10 " else "") +
+                (if (r and L431Protocol.RAIL_PA5 != 0) "PA5" else "")
+        }
+        return "L431: ${s[1]}/${s[0]} replies, ${s[2]} timeouts, ${s[7]} in flight, " +
+            "RTT ${s[11] / 1000.0}ms (min ${s[9] / 1000.0}, max ${s[10] / 1000.0}), rails [${rails.trim()}]" +
+            (if (s[4] > 0) ", ${s[4]} legacy ACKs" else "") +
+            if (s[15] > 0) ", ${s[15]} SYNC replies" else ""
     }
 }
 
@@ -67,9 +67,11 @@ object NativeCore {
     external fun maUpdate(id: Int, input: Float): Float
     
     // ═══════════════════════════════════════════════════════════════════════
-    // Guidance Controller
+    // Guidance Controller (queued to the core owner, getters read its snapshot)
     // ═══════════════════════════════════════════════════════════════════════
     
+    // alpha / cmdMax go into the parameter store now; the queued reset reads
+    // the store, so tuning loaded right after is kept
     external fun guidanceInit(alpha: Float, cmdMax: Float)
     external fun guidanceStart()
     external fun guidanceStop()
@@ -83,11 +85,11 @@ object NativeCore {
     
     external fun pidInit(axis: Int, kp: Float, ki: Float, kd: Float, 
                         outputMin: Float, outputMax: Float, alpha: Float)
-    external fun pidUpdate(axis: Int, error: Float, dt: Float): Float
+    external fun pidUpdate(axis: Int, error: Float, dt: Float): Float  // Output as of the latest core snapshot
     external fun pidReset(axis: Int)
     
     // ═══════════════════════════════════════════════════════════════════════
-    // Sensor Fusion (GPS + IMU)
+    // Sensor Fusion (GPS + IMU, queued like guidance)
     // ═══════════════════════════════════════════════════════════════════════
     
     external fun fusionInit(alpha: Float)
@@ -165,5 +167,219 @@ object NativeCore {
     external fun servoFormatFeedbackRequest(servoId: Int): ByteArray  // Returns 5-byte request
     external fun servoAngleToPosition(angleDegrees: Float): Int  // -25° to +25° → 0-16383
     external fun servoPositionToAngle(position: Int): Float  // 0-16383 → -25° to +25°
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Waveshare USB-CAN Codec
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun wsEncode(ids: IntArray, dlcs: ByteArray, data: ByteArray, count: Int, out: ByteArray): Int  // data: 8 bytes per frame, returns bytes written
+    external fun wsDecode(input: ByteArray, length: Int, outIds: IntArray, outDlcs: ByteArray, outData: ByteArray): Int  // Returns frames decoded
+    external fun wsDecoderReset()
+    external fun wsGetStats(): LongArray  // [encoded, decoded, bytesIn, bytesDropped, garbage, badFrames, encodeOverflows]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // CAN Receive Dispatcher
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun canDispatchInit(): java.nio.ByteBuffer  // Shared state (layout: can_dispatch.h), resets handlers
+    external fun canDispatchClear()
+    external fun canDispatchSetServo(canId: Int, channel: Int): Boolean  // Feedback on canId → channel
+    external fun wsDecodeDispatch(input: ByteArray, length: Int, nowMs: Long): Int  // Returns frames decoded
+    external fun canDispatchOnlineMask(channelCount: Int, nowMs: Long, timeoutMs: Long): Int
+    external fun canDispatchLastFrame(): String  // "ID:0x581 [..]" (formatted on demand)
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // CAN Bus Recorder (every frame through wsEncode / wsDecode*)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun canRecorderStart(capacity: Int): Boolean  // Frames kept in the ring (allocated once)
+    external fun canRecorderStop()
+    external fun canRecorderSave(path: String): Int  // Binary log, returns frames written (-1 = I/O error)
+    external fun canRecorderFlush(path: String): Int  // Appends frames since the last flush
+    external fun canRecorderExportCandump(path: String, iface: String): Int  // candump -l text
+    external fun canRecorderGetStats(): LongArray  // [recorded, tx, rx, overwritten, flushLost, capacity]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // CAN Receive Thread (usbfs read → decode → dispatch, no JNI per read)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun canRxThreadStartUsb(fd: Int, epIn: Int, epOut: Int,
+                                     niceValue: Int, rtPriority: Int, cpuMask: Int): Boolean  // rtPriority 0 = nice only, cpuMask 0 = any CPU
+    external fun canRxThreadStop()  // Joins the thread, releases the URBs (fd stays open)
+    external fun canRxThreadRunning(): Boolean
+    external fun canRxThreadGetStats(): LongArray  // [wakeups, timeouts, frames, errors, cpuUs, runUs, tid, realtime, running]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Native Control Thread (timerfd tick → guidance → mix → send, off the UI looper)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const val CONTROL_MODE_HOLD = 0       // Keep the last commands
+    const val CONTROL_MODE_ATTITUDE = 1   // controlSetAttitude roll / pitch
+    const val CONTROL_MODE_TRACKING = 2   // guidanceUpdate on controlSetTrackingError
+    
+    external fun controlThreadStart(periodUs: Int, niceValue: Int, rtPriority: Int, cpuMask: Int,
+                                    sendThresholdDeg: Float): Boolean  // Needs the CAN receive thread (its transport)
+    external fun controlThreadStop()
+    external fun controlThreadRunning(): Boolean
+    external fun controlSetLayout(nodeIds: IntArray, rollGains: FloatArray, pitchGains: FloatArray): Boolean
+    external fun controlSetMode(mode: Int)
+    external fun controlSetAttitude(roll: Float, pitch: Float, yaw: Float)  // Degrees, any thread
+    external fun controlSetTrackingError(errorX: Float, errorY: Float)  // Normalized -1..+1, any thread
+    external fun controlGetCommands(channels: Int): FloatArray  // Last sent per channel (degrees)
+    external fun controlGetCommand(channel: Int): Float  // Same, one channel, no allocation
+    external fun controlThreadGetStats(): LongArray  // [ticks, overruns, sends, frames, sendErrors, staleTicks,
+                                                     //  jitterLastUs, jitterMeanUs, jitterP99Us, jitterMaxUs,
+                                                     //  workMeanUs, workMaxUs, cpuUs, runUs, tid, realtime, running]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // L431 Power Unit Link (sequenced requests, replies matched on the read thread)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun l431Init(timeoutMs: Int): Boolean  // Reset tracker, install reply handler
+    external fun l431Install(): Boolean  // Reinstall after canDispatchClear
+    external fun l431Submit(commands: ByteArray): Int  // 1-6 commands, returns seq for the frame (-1 = window full)
+    external fun l431GetStats(): LongArray  // [requests, replies, timeouts, unmatched, legacyAcks, windowFull, rejected, inFlight,
+                                            //  rttLastUs, rttMinUs, rttMaxUs, rttMeanUs, rails, deviceTickMs, lastReplyAgeMs,
+                                            //  syncReplies]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Servo Response Estimator (results in the canDispatchInit buffer)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun servoEstReset()  // Clears history and command routing
+    external fun servoEstSetChannel(commandId: Int, channel: Int): Boolean  // Position commands on commandId → channel
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Chart Series Store (command / feedback history, decimated for drawing)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const val SERIES_DECIMATE_LTTB = 0    // Largest-Triangle-Three-Buckets (shape)
+    const val SERIES_DECIMATE_MINMAX = 1  // Min + max per bucket (every peak)
+    
+    fun seriesCommand(channel: Int) = 2 * channel   // Fed by the command senders
+    fun seriesFeedback(channel: Int) = 2 * channel + 1  // Fed by the receive path
+    
+    external fun seriesInit(seriesCount: Int, capacity: Int): Boolean  // Allocates once, later calls clear
+    external fun seriesClear()
+    external fun seriesAppend(series: Int, value: Float)  // Now; for Kotlin-only sources (serial mode)
+    external fun seriesDecimate(series: Int, windowMs: Long, method: Int, maxPoints: Int,
+                                outX: FloatArray, outY: FloatArray): Int  // Into the reused arrays, x = s before now
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Telemetry Publisher (same 73-byte frames + sequence / time over UDP and TCP)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun telemetryPublisherStart(udpTargets: String, tcpPort: Int, tcpLoopbackOnly: Boolean,
+                                         multicastTtl: Int, maxBatch: Int, maxDelayUs: Int): Boolean  // "host[:port],..." ("" = no UDP), tcpPort 0 = no TCP
+    external fun telemetryPublisherStop()
+    external fun telemetryPublish(frame: ByteArray, length: Int): Long  // Sequence number, -1 = not running / queue full
+    external fun telemetryPublisherGetStats(): LongArray  // [published, queueDrops, udpDatagrams, udpCalls, udpErrors,
+                                                          //  tcpAccepted, tcpDisconnects, tcpBytes, tcpDrops,
+                                                          //  latencyMeanUs, latencyMaxUs, tcpClients, udpTargets, running]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Telemetry Radio USB Writes (frames coalesced into bulk transfers)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun telemetryUsbOpen(fd: Int, epOut: Int, packetSize: Int, transferSize: Int,
+                                  maxDelayUs: Int): Boolean  // usbfs fd of the radio, interface claimed
+    external fun telemetryUsbWrite(data: ByteArray, length: Int): Int  // 1 queued, 0 dropped, -1 device gone / not open
+    external fun telemetryUsbClose()  // Flushes what is pending
+    external fun telemetryUsbGetStats(): LongArray  // [framesQueued, framesDropped, framesSent, transfers, bytes,
+                                                    //  sizeFlushes, deadlineFlushes, writeErrors, delayMeanUs,
+                                                    //  delayP99Us, delayMaxUs, runTimeUs, pendingBytes, failed]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Telemetry Bus (typed records from the telemetry tick, a cursor per consumer)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const val BUS_ATTITUDE = 0  // roll, pitch, yaw, accX, accY, accZ
+    const val BUS_SERVO = 1     // cmd 1-4, feedback 1-4, online mask
+    const val BUS_GPS = 2       // lat, lon, alt, speed, heading, satellites, fix, hdop
+    const val BUS_TRACKING = 3  // x, y, w, h
+    const val BUS_POWER = 4     // battery %, charging, voltage mV, temperature, pressure, baro alt
+    const val BUS_DEADLINE = 5  // misses per stage (6), active policy mask, detections skipped, sends held, predicted ticks
+    const val BUS_VALUES = 12
+    const val BUS_STRIDE = 3 + BUS_VALUES  // Per record in read buffers: sequence, timeUs, type, values
+    
+    fun busMask(vararg types: Int) = types.fold(0) { mask, type -> mask or (1 shl type) }
+    
+    external fun telemetryBusPublish(type: Int, values: DoubleArray, count: Int): Long  // Producer thread only; sequence, 0 = bad type
+    external fun telemetryBusSubscribe(name: String, typeMask: Int, fromOldest: Boolean): Int  // Consumer id, -1 = none free
+    external fun telemetryBusUnsubscribe(id: Int)
+    external fun telemetryBusRead(id: Int, out: DoubleArray, maxRecords: Int): Int  // Records copied (BUS_STRIDE each), -1 = bad id
+    external fun telemetryBusLatest(type: Int, out: DoubleArray): Long  // Newest of a type, no cursor; sequence, 0 = none yet
+    external fun telemetryBusGetStats(id: Int): LongArray  // [published, received, skipped, lag]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Timeline Tracing (zones → ATrace while a system trace runs, rings → Chrome JSON)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun traceStart(eventsPerThread: Int)  // 0 = default; per-thread rings, oldest overwritten
+    external fun traceStop()
+    external fun traceName(name: String): Int  // Intern once, pass the index (-1 = table full)
+    external fun traceBegin(name: Int)  // Zone on the calling thread, nests
+    external fun traceEnd()
+    external fun traceCounter(name: Int, value: Long)
+    external fun traceWriteChrome(path: String): Int  // After traceStop; events written, -1 = cannot create
+    external fun traceGetStats(): LongArray  // [events, overwritten, dropped, threads, recording]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Runtime Parameters (tuning applied in place, no controller reset)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun paramCount(): Int
+    external fun paramName(id: Int): String?  // "pid.kp", "tracker.lostLimit", ... (ids are stable)
+    external fun paramFind(name: String): Int  // -1 = unknown
+    external fun paramRange(id: Int): FloatArray?  // [default, min, max, type (0 float, 1 int)]
+    external fun paramGet(id: Int): Float
+    external fun paramGetAll(): FloatArray  // One consistent snapshot, indexed by id
+    external fun paramSet(id: Int, value: Float): Int  // New generation, -1 = rejected (range / id)
+    external fun paramSetMany(ids: IntArray, values: FloatArray): Int  // All or nothing, one generation
+    external fun paramResetDefaults(): Int
+    external fun paramGeneration(): Int  // +1 per change; poll to notice tuning
+    external fun paramSave(path: String): Int  // Parameters written, -1 = cannot write
+    external fun paramLoad(path: String): Int  // Entries applied, -1 = missing / corrupt (values untouched)
+    external fun paramGetStats(): LongArray  // [generation, swaps, rejected, slotWaits, pinned]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Frame Arenas (per-frame native scratch, grows to the high-water mark)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun arenaCount(): Int
+    external fun arenaName(index: Int): String?
+    external fun arenaGetStats(index: Int): LongArray?  // [capacity, highWater, frames, spills, grows] (bytes)
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Core Ownership (guidance / fusion / telemetry: queued in, snapshot out)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    external fun coreOwnerGetStats(): LongArray  // [submitted, applied, dropped, drains, ownerDrains, published,
+                                                 //  snapshotRetries, violations, queueHighWater, ownedByControl]
+    
+    // ═══════════════════════════════════════════════════════════════════════
+    // Pipeline Stage Deadlines (budgets, overrun ring, skip / hold / predict)
+    // ═══════════════════════════════════════════════════════════════════════
+    
+    const val STAGE_CAPTURE = 0     // Camera frame interval at the analyzer
+    const val STAGE_PREPROCESS = 1  // ImageProxy → bitmap
+    const val STAGE_DETECT = 2      // YOLO; gated by deadlineAdmit (skip detection)
+    const val STAGE_TRACK = 3       // Target selection, tracking error hand-off
+    const val STAGE_GUIDE = 4       // Native control thread
+    const val STAGE_SEND = 5        // Native control thread; held while writes overrun
+    const val STAGES = 6
+    
+    const val POLICY_SKIP_DETECTION = 0  // Bits of the active policy mask
+    const val POLICY_HOLD_COMMAND = 1
+    const val POLICY_PREDICT = 2
+    
+    external fun deadlineConfigure(stage: Int, budgetUs: Long, missLimit: Int): Boolean  // missLimit 0 = count only
+    external fun deadlineReset()  // Counters and ring cleared, budgets kept
+    external fun deadlineRecord(stage: Int, durationUs: Long): Boolean  // true = over budget
+    external fun deadlineAdmit(stage: Int): Boolean  // false = skip this run (policy engaged, not a probe)
+    external fun deadlineGetStats(): LongArray  // Per stage [runs, misses, lastUs, maxUs, budgetUs] × STAGES, then
+                                                // [engaged × 3 policies, detectionsSkipped, sendsHeld,
+                                                //  predictedTicks, overruns, activePolicies]
+    external fun deadlineGetOverruns(max: Int): LongArray  // Oldest first, 5 each: [timeUs, stage, durationUs, budgetUs, inARow]
+    external fun deadlineBusValues(out: DoubleArray): Int  // BUS_DEADLINE record values, returns the count
 }
-
@@ -0,0 +1,41 @@
+package com.example.canphon.native_sensors
+
+/**
+ * NativeDeadline - camera pipeline stages against their native budgets
+ *
+ * The analyzer times capture / preprocess / detect / track here; guide and
+ * send are timed on the native control thread. Overruns land in the
+ * native ring and, when a stage keeps missing, its policy engages there
+ * (detection skipped on alternate frames, servo commands held, tracking
+ * error extrapolated) until the stage is back within budget.
+ */
+object NativeDeadline {
+
+    private val STAGE_NAMES = arrayOf("capture", "preprocess", "detect", "track", "guide", "send")
+
+    inline fun <T> stage(stage: Int, block: () -> T): T {
+        val startNs = System.nanoTime()
+        try {
+            return block()
+        } finally {
+            NativeCore.deadlineRecord(stage, (System.nanoTime() - startNs) / 1000)
+        }
+    }
+
+    /**
+     * One line per stage that ran, then what the policies did
+     */
+    fun summary(): String {
+        val s = NativeCore.deadlineGetStats()
+        val sb = StringBuilder("DEADLINES:")
+        for (i in 0 until NativeCore.STAGES) {
+            val b = i * 5
+            if (s[b] == 0L) continue
+            sb.append(" ${STAGE_NAMES[i]} ${s[b + 1]}/${s[b]} over ${s[b + 4] / 1000} ms (max ${s[b + 3] / 1000} ms);")
+        }
+        val p = NativeCore.STAGES * 5
+        sb.append(" skip detection ×${s[p]} (${s[p + 3]} frames), hold ×${s[p + 1]} (${s[p + 4]} sends)," +
+                  " predict ×${s[p + 2]} (${s[p + 5]} ticks)")
+        return sb.toString()
+    }
+}
@@ -0,0 +1,64 @@
+package com.example.canphon.native_sensors
+
+import android.content.Context
+import android.util.Log
+import java.io.File
+
+/**
+ * NativeParams - live tuning through the native parameter store
+ *
+ * A change is one atomic snapshot swap: the control thread, tracker and
+ * discriminator pick it up on their next update with their filter and
+ * integrator state intact. Saved values live in a small binary file in
+ * the app's files directory and are applied over the defaults at start.
+ */
+object NativeParams {
+
+    private const val TAG = "NativeParams"
+    private const val FILE_NAME = "params.bin"
+
+    private fun file(context: Context) = File(context.filesDir, FILE_NAME)
+
+    /**
+     * Apply the saved values (if any). Returns entries applied, -1 if none saved / unreadable
+     */
+    fun load(context: Context): Int {
+        val path = file(context)
+        if (!path.exists()) return -1
+        val applied = NativeCore.paramLoad(path.absolutePath)
+        Log.i(TAG, "📂 Parameters: $applied applied (generation ${NativeCore.paramGeneration()})")
+        return applied
+    }
+
+    fun save(context: Context): Boolean {
+        return NativeCore.paramSave(file(context).absolutePath) >= 0
+    }
+
+    /**
+     * Change one value by name, live. False if unknown or out of range
+     */
+    fun set(name: String, value: Float): Boolean {
+        val id = NativeCore.paramFind(name)
+        if (id < 0) {
+            Log.w(TAG, "Unknown parameter $name")
+            return false
+        }
+        return NativeCore.paramSet(id, value) >= 0
+    }
+
+    fun get(name: String): Float? {
+        val id = NativeCore.paramFind(name)
+        return if (id < 0) null else NativeCore.paramGet(id)
+    }
+
+    /**
+     * Name → value of every parameter, from one snapshot
+     */
+    fun all(): Map<String, Float> {
+        val values = NativeCore.paramGetAll()
+        return values.indices.associate { id -> (NativeCore.paramName(id) ?: "#$id") to values[id] }
+    }
+
+    val generation: Int
+        get() = NativeCore.paramGeneration()
+}
@@ -24,6 +24,13 @@ import android.util.Log
  * nativeSensors.stop()
  * nativeSensors.cleanup()
  * ```
+ *
+ * startBatched() registers the sensors with a batch report latency instead:
+ * the sensor hub FIFO collects hardware-timestamped samples and a native
+ * thread drains each burst into the native ring, poll() then takes
+ * everything pending. PROFILE_LOW_LATENCY wakes once per sample,
+ * PROFILE_BATCHED once per latency period for a fraction of the CPU
+ * (batchStats() has the CPU per 1000 samples of the running profile).
  */
 class NativeSensorManager {
     
@@ -35,6 +42,11 @@ class NativeSensorManager {
         const val SENSOR_TYPE_GYROSCOPE = 4
         const val SENSOR_TYPE_MAGNETIC_FIELD = 2
         
+        // Batching profiles (native_sensors.cpp SENSOR_PROFILE_*)
+        const val PROFILE_LOW_LATENCY = 0
+        const val PROFILE_BATCHED = 1
+        const val DEFAULT_BATCH_LATENCY_US = 100_000L
+        
         init {
             try {
                 System.loadLibrary("canphon_native")
@@ -57,6 +69,27 @@ class NativeSensorManager {
         val eventCount: Int
     )
     
+    // Batched drain stats (since the last startBatched)
+    data class BatchStats(
+        val profile: Int,
+        val latencyUs: Long,
+        val accelPeriodUs: Long,
+        val gyroPeriodUs: Long,
+        val accelFifo: Long,
+        val gyroFifo: Long,
+        val samples: Long,
+        val dropped: Long,
+        val drains: Long,
+        val emptyWakeups: Long,
+        val maxBurst: Long,
+        val ringHighWater: Long,
+        val cpuNs: Long,
+        val spanNs: Long
+    ) {
+        val samplesPerDrain: Double get() = if (drains > 0) samples.toDouble() / drains else 0.0
+        val cpuUsPer1000: Double get() = if (samples + dropped > 0) cpuNs.toDouble() / (samples + dropped) else 0.0
+    }
+    
     private var isInitialized = false
     private var isRunning = false
     
@@ -103,6 +136,38 @@ class NativeSensorManager {
         return isRunning
     }
     
+    /**
+     * Start sensors through the hub FIFO on the native drain thread
+     * @param profile PROFILE_LOW_LATENCY or PROFILE_BATCHED
+     * @param usDelay Sampling period in microseconds (0 = FASTEST)
+     * @param maxBatchLatencyUs Batch report latency for PROFILE_BATCHED
+     */
+    fun startBatched(profile: Int = PROFILE_BATCHED, usDelay: Int = 0,
+                     maxBatchLatencyUs: Long = DEFAULT_BATCH_LATENCY_US): Boolean {
+        if (!isInitialized) {
+            Log.e(TAG, "Not initialized! Call initialize() first")
+            return false
+        }
+        
+        val result = startBatchedNative(usDelay, profile, maxBatchLatencyUs)
+        isRunning = (result == 0)
+        
+        if (isRunning) {
+            Log.i(TAG, "Sensors started batched (profile $profile, latency $maxBatchLatencyUs μs)")
+        }
+        
+        return isRunning
+    }
+    
+    /**
+     * Batched drain stats, kept after stop() until the next startBatched()
+     */
+    fun batchStats(): BatchStats {
+        val s = if (isInitialized) getBatchStatsNative() else null
+        if (s == null || s.size < 14) return BatchStats(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        return BatchStats(s[0].toInt(), s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10], s[11], s[12], s[13])
+    }
+    
     /**
      * Poll sensors and get latest data
      * Should be called in a loop (e.g., from a background thread)
@@ -133,7 +198,13 @@ class NativeSensorManager {
         if (isRunning) {
             stopNative()
             isRunning = false
-            Log.i(TAG, "Sensors stopped")
+            val b = batchStats()
+            if (b.samples > 0) {
+                Log.i(TAG, "Sensors stopped: ${b.samples} samples in ${b.drains} drains " +
+                           "(%.1f / drain), cpu %.1f μs / 1000 samples".format(b.samplesPerDrain, b.cpuUsPer1000))
+            } else {
+                Log.i(TAG, "Sensors stopped")
+            }
         }
     }
     
@@ -172,6 +243,8 @@ class NativeSensorManager {
     // Native methods
     private external fun initNative(): Int
     private external fun startNative(usDelay: Int): Int
+    private external fun startBatchedNative(usDelay: Int, profile: Int, maxBatchLatencyUs: Long): Int
+    private external fun getBatchStatsNative(): LongArray?
     private external fun pollNative(): FloatArray?
     private external fun stopNative()
     private external fun cleanupNative()
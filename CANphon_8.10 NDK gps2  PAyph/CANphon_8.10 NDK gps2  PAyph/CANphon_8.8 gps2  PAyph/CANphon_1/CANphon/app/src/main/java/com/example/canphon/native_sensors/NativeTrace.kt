@@ -0,0 +1,56 @@
+package com.example.canphon.native_sensors
+
+import android.content.Context
+import android.util.Log
+import java.io.File
+import java.text.SimpleDateFormat
+import java.util.Date
+import java.util.Locale
+
+/**
+ * NativeTrace - Kotlin zones on the native timeline
+ *
+ * Camera / YOLO / telemetry zones land on the same per-thread rings as the
+ * native threads (CAN receive, control tick, USB writes), so one trace
+ * shows how they interleave. While Perfetto / systrace captures, the
+ * zones also appear there through ATrace.
+ */
+object NativeTrace {
+
+    private const val TAG = "NativeTrace"
+
+    val CAMERA_FRAME by lazy { NativeCore.traceName("camera.frame") }
+    val YOLO_DETECT by lazy { NativeCore.traceName("yolo.detect") }
+    val TELEMETRY_FRAME by lazy { NativeCore.traceName("telemetry.frame") }
+
+    inline fun <T> zone(name: Int, block: () -> T): T {
+        NativeCore.traceBegin(name)
+        try {
+            return block()
+        } finally {
+            NativeCore.traceEnd()
+        }
+    }
+
+    /**
+     * Start recording (events per thread, 0 = native default)
+     */
+    fun start(eventsPerThread: Int = 0) {
+        NativeCore.traceStart(eventsPerThread)
+    }
+
+    /**
+     * Stop and write the rings as Chrome trace JSON into the app's files
+     * directory (open in ui.perfetto.dev). Returns the path, null on failure
+     */
+    fun stopAndWrite(context: Context): String? {
+        NativeCore.traceStop()
+        val dir = context.getExternalFilesDir(null) ?: context.filesDir
+        val stamp = SimpleDateFormat("yyyyMMdd_HHmmss", Locale.US).format(Date())
+        val file = File(dir, "trace_$stamp.json")
+        val events = NativeCore.traceWriteChrome(file.absolutePath)
+        if (events < 0) return null
+        Log.i(TAG, "📝 Trace: $events events -> ${file.absolutePath}")
+        return file.absolutePath
+    }
+}
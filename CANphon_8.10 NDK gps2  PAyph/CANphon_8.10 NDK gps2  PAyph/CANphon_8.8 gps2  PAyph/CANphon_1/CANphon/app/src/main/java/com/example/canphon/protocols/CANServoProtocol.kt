@@ -50,6 +50,9 @@ object CANServoProtocol {
     const val INDEX_REPORT_INTERVAL_LOW = 0x00.toByte()  // 0x2200
     const val INDEX_REPORT_INTERVAL_HIGH = 0x22.toByte()
     
+    // Highest node ID a bridge may own (STM32 node_config.h); 0x599 is the bridge debug ID
+    const val MAX_NODE_ID = 0x18
+    
     // ============ Angle Limits ============
     const val MIN_ANGLE = -25f  // Configurable limit
     const val MAX_ANGLE = 25f   // Configurable limit
@@ -103,7 +106,7 @@ object CANServoProtocol {
      * 
      * Angle ±25° maps to position 0-16383 (14-bit servo range)
      * 
-     * @param nodeId Servo Node ID (0x01-0x04)
+     * @param nodeId Servo Node ID (0x01-MAX_NODE_ID)
      * @param angleDegrees Target angle in degrees
      * @return CANFrame ready to send via Waveshare adapter to STM32
      */
@@ -156,7 +159,7 @@ object CANServoProtocol {
     /**
      * Parse position feedback from STM32 Bridge
      * 
-     * STM32 Feedback Format (CAN ID 0x581-0x584):
+     * STM32 Feedback Format (CAN ID 0x580 + node):
      * [Pos_Low] [Pos_High] [Debug0] [Debug1] [0] [0] [0] [0]
      * 
      * Position is 14-bit (0-16383) where:
@@ -165,12 +168,18 @@ object CANServoProtocol {
      * @param data 8-byte CAN feedback payload
      * @return Position in degrees, or null if invalid
      */
-    fun parsePositionFeedback(data: ByteArray): Float? {
-        if (data.size < 2) return null
+    fun parsePositionFeedback(data: ByteArray): Float? = parsePositionFeedback(data, 0, data.size)
+    
+    /**
+     * Same as above for a payload stored at [offset] inside a larger buffer
+     * (frames decoded in place by WaveshareAdapter.readFrames)
+     */
+    fun parsePositionFeedback(data: ByteArray, offset: Int, dlc: Int): Float? {
+        if (dlc < 2) return null
         
         // Extract 14-bit position from first 2 bytes
-        val posLow = data[0].toInt() and 0xFF
-        val posHigh = data[1].toInt() and 0xFF
+        val posLow = data[offset].toInt() and 0xFF
+        val posHigh = data[offset + 1].toInt() and 0xFF
         val rawPosition = posLow or (posHigh shl 8)
         
         // Convert 14-bit position (0-16383) to angle (-25° to +25°)
@@ -205,5 +214,20 @@ object CANServoProtocol {
     enum class Axis {
         ROLL, PITCH, YAW, AUX
     }
+    
+    /**
+     * One actuator on the bus: node ID plus its roll/pitch mixing gains
+     */
+    data class ServoChannel(val nodeId: Int, val rollGain: Float, val pitchGain: Float)
+    
+    /**
+     * Default X-Configuration (single bridge, nodes 1-4)
+     */
+    val X_LAYOUT = listOf(
+        ServoChannel(SERVO_1, -1f, +1f),  // Front-Left:  -Roll + Pitch
+        ServoChannel(SERVO_2, +1f, +1f),  // Front-Right: +Roll + Pitch
+        ServoChannel(SERVO_3, -1f, -1f),  // Back-Left:   -Roll - Pitch
+        ServoChannel(SERVO_4, +1f, -1f)   // Back-Right:  +Roll - Pitch
+    )
 }
 
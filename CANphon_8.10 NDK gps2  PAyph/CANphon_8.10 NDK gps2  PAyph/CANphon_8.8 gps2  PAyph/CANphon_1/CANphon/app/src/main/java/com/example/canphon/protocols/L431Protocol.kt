@@ -15,11 +15,19 @@ import com.example.canphon.data.*
  * CAN IDs:
  * - TX (Android → L431): 0x100
  * - RX (L431 → Android): 0x101
+ * - SYNC: 0x080 (board replies 0x5B with the rails, seq = SYNC counter)
+ * - Broadcast: 0x102 (sequenced layout of 0x100 only, applied without a reply)
  * 
  * Commands:
  * - 0x01: ON  - PA9=HIGH, PA10=HIGH
  * - 0x02: OFF - PA5=HIGH, PA9=LOW, PA10=LOW
  * - 0x03: Heartbeat - Toggle PB6
+ * - 0x04: Status - no action, reply only
+ * 
+ * Sequenced request (several commands, one status reply; see l431_link.h):
+ * - TX: [0x80 | n] [seq] [cmd 1] .. [cmd n]          n = 1..6
+ * - RX: [0x5A] [seq] [executed | rejected << 4] [rails] [tick LE32]
+ * Replies are matched natively on the read thread (NativeCore.l431*).
  */
 object L431Protocol {
     
@@ -28,11 +36,26 @@ object L431Protocol {
     // ============ CAN IDs (Unique for L431, away from servo range) ============
     const val L431_TX_ID = 0x100   // Android → L431
     const val L431_RX_ID = 0x101   // L431 → Android (Acknowledgment)
+    const val L431_SYNC_ID = 0x080       // SYNC, answered with REPLY_SYNC
+    const val L431_BROADCAST_ID = 0x102  // Every unit, v2 requests only, no reply
     
     // ============ Commands ============
     const val CMD_POWER_ON: Byte = 0x01     // Turn ON: PA9=HIGH, PA10=HIGH
     const val CMD_POWER_OFF: Byte = 0x02    // Turn OFF: PA5=HIGH, PA9=LOW, PA10=LOW  
     const val CMD_HEARTBEAT: Byte = 0x03    // Toggle PB6 (Servo feedback indicator)
+    const val CMD_STATUS: Byte = 0x04       // Status reply only
+    
+    // ============ Sequenced requests ============
+    const val FRAME_V2 = 0x80               // Byte 0: flag | command count
+    const val MAX_COMMANDS = 6
+    const val REPLY_STATUS: Byte = 0x5A
+    const val REPLY_SYNC: Byte = 0x5B
+    
+    // Status reply rails byte
+    const val RAIL_PA5 = 0x01
+    const val RAIL_PA9 = 0x02
+    const val RAIL_PA10 = 0x04
+    const val RAIL_PB6 = 0x08
     
     // ============ Acknowledgment responses ============
     const val ACK_POWER_ON: Byte = 0xAA.toByte()
@@ -81,6 +104,27 @@ object L431Protocol {
         )
     }
     
+    /**
+     * Create a sequenced request carrying up to MAX_COMMANDS commands
+     * @param seq Sequence number from NativeCore.l431Submit
+     */
+    fun createRequest(seq: Int, commands: ByteArray): CANFrame {
+        require(commands.size in 1..MAX_COMMANDS) { "1..$MAX_COMMANDS commands" }
+        val data = ByteArray(2 + commands.size)
+        data[0] = (FRAME_V2 or commands.size).toByte()
+        data[1] = seq.toByte()
+        commands.copyInto(data, 2)
+        return CANFrame(L431_TX_ID, data)
+    }
+    
+    /**
+     * Create a SYNC frame; every board answers with a REPLY_SYNC status
+     * @param counter Echoed in the reply's seq byte
+     */
+    fun createSync(counter: Int): CANFrame {
+        return CANFrame(L431_SYNC_ID, byteArrayOf(counter.toByte()))
+    }
+    
     /**
      * Parse acknowledgment from L431
      * @param frame Received CAN frame
@@ -5,6 +5,7 @@ import com.example.canphon.managers.*
 import com.example.canphon.protocols.*
 import com.example.canphon.managers.SharedBusManager
 import com.example.canphon.native_sensors.NativeCore
+import com.example.canphon.native_sensors.NativeParams
 import com.example.canphon.data.*
 
 import android.content.Context
@@ -34,6 +35,9 @@ class GuidanceController(
     // Current tracking state
     private var isTracking = false
     
+    // Guidance runs on the native control thread (errors are only forwarded)
+    private var nativeControl = false
+    
     // Servo angles cache
     private var servoAngles = floatArrayOf(0f, 0f, 0f, 0f)
     private var currentPitchCmd = 0f
@@ -42,6 +46,9 @@ class GuidanceController(
     fun init(): Boolean {
         // Initialize native guidance controller
         NativeCore.guidanceInit(ALPHA, CMD_MAX)
+        // Saved tuning over these defaults (the queued reset reads the store,
+        // whenever the core owner gets to it)
+        NativeParams.load(context)
         Log.i(TAG, "✅ Native GuidanceController initialized (α=$ALPHA, cmdMax=$CMD_MAX)")
         Log.i(TAG, "CAN Connected: ${busManager.isConnected}")
         return true
@@ -50,11 +57,16 @@ class GuidanceController(
     fun startTracking() {
         isTracking = true
         NativeCore.guidanceStart()
-        Log.i(TAG, "Tracking started - CAN: ${busManager.isConnected}")
+        nativeControl = busManager.startNativeControl(NativeCore.CONTROL_MODE_TRACKING)
+        Log.i(TAG, "Tracking started - CAN: ${busManager.isConnected}, native control: $nativeControl")
     }
     
     fun stopTracking() {
         isTracking = false
+        if (nativeControl) {
+            busManager.stopNativeControl()
+            nativeControl = false
+        }
         NativeCore.guidanceStop()
         currentPitchCmd = 0f
         currentYawCmd = 0f
@@ -75,6 +87,16 @@ class GuidanceController(
     fun updateTrackingError(errorX: Float, errorY: Float) {
         if (!isTracking) return
         
+        // Control thread runs guidance and sends; keep the UI copy of its output
+        if (nativeControl) {
+            NativeCore.controlSetTrackingError(errorX, errorY)
+            val commands = NativeCore.guidanceGetCommands()
+            currentPitchCmd = commands[0]
+            currentYawCmd = commands[1]
+            servoAngles = NativeCore.guidanceGetServoAngles()
+            return
+        }
+        
         // Update native guidance (all processing in C++)
         NativeCore.guidanceUpdate(errorX, errorY, 0.033f)  // ~30fps
         
@@ -4,6 +4,7 @@ import com.example.canphon.ui.*
 import com.example.canphon.managers.*
 import com.example.canphon.protocols.*
 import com.example.canphon.native_sensors.NativeCore
+import com.example.canphon.native_sensors.NativeParams
 import com.example.canphon.data.*
 
 /**
@@ -23,11 +24,14 @@ import com.example.canphon.data.*
 class KalmanFilter {
     
     init {
-        NativeCore.kalmanInit(0.0, 0.0, 300.0, 1.0)
+        initialize(0.0, 0.0)
     }
     
+    // Noise from the parameter store (kalman.processNoise / measurementNoise)
     fun initialize(x: Double, y: Double) {
-        NativeCore.kalmanInit(x, y, 300.0, 1.0)
+        NativeCore.kalmanInit(x, y,
+            (NativeParams.get("kalman.processNoise") ?: 300f).toDouble(),
+            (NativeParams.get("kalman.measurementNoise") ?: 1f).toDouble())
     }
     
     fun predict(): Pair<Double, Double> {
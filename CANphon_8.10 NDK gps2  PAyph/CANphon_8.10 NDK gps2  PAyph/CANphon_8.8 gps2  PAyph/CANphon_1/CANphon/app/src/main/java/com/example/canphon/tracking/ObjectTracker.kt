@@ -259,6 +259,19 @@ class ObjectTracker {
     fun stop() {
         NativeCore.trackerStop()
         Log.i(TAG, "⏹️ Tracking stopped")
+        logArenas()
+    }
+    
+    /**
+     * High-water mark of the native per-frame scratch (spills / grows
+     * stop once the arenas have seen the largest frame)
+     */
+    private fun logArenas() {
+        for (i in 0 until NativeCore.arenaCount()) {
+            val s = NativeCore.arenaGetStats(i) ?: continue
+            Log.i(TAG, "Arena ${NativeCore.arenaName(i)}: high water ${s[1] / 1024} KB of ${s[0] / 1024} KB, " +
+                    "${s[2]} frames, ${s[3]} spills, ${s[4]} grows")
+        }
     }
     
     /**
@@ -21,6 +21,9 @@ import androidx.camera.view.PreviewView
 import androidx.core.app.ActivityCompat
 import androidx.core.content.ContextCompat
 
+import com.example.canphon.native_sensors.NativeCore
+import com.example.canphon.native_sensors.NativeDeadline
+import com.example.canphon.native_sensors.NativeTrace
 import com.example.canphon.tracking.GuidanceController
 import java.util.concurrent.ExecutorService
 import java.util.concurrent.Executors
@@ -64,6 +67,7 @@ class TrackingActivity : AppCompatActivity(), TrackingController.TrackingCommand
     private var currentFPS = 0
     private var imWidth = 1280
     private var imHeight = 720
+    private var lastFrameNs = 0L  // Capture stage: analyzer frame-to-frame interval
     
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
@@ -231,73 +235,28 @@ class TrackingActivity : AppCompatActivity(), TrackingController.TrackingCommand
         }, ContextCompat.getMainExecutor(this))
     }
     
-    private fun processFrame(imageProxy: ImageProxy) {
+    private fun processFrame(imageProxy: ImageProxy): Unit = NativeTrace.zone(NativeTrace.CAMERA_FRAME) {
         try {
             // تحديث أبعاد الصورة
             imWidth = imageProxy.width
             imHeight = imageProxy.height
             
             if (isTracking) {
-                // Convert to bitmap for detection
-                val bitmap = imageProxy.toBitmap()
+                val nowNs = System.nanoTime()
+                if (lastFrameNs != 0L) NativeCore.deadlineRecord(NativeCore.STAGE_CAPTURE, (nowNs - lastFrameNs) / 1000)
+                lastFrameNs = nowNs
                 
-                // Run YOLO detection
-                val detections = yoloDetector.detect(bitmap)
-                
-                // تحويل إلى Rect list
-                val rects = detections.map { it }
-                
-                // تحديث الـ tracker
-                if (rects.isNotEmpty()) {
-                    val bestTarget = rects.maxByOrNull { it.width() * it.height() }
+                // YOLO behind its budget: every other frame only, the control thread predicts in between
+                if (NativeCore.deadlineAdmit(NativeCore.STAGE_DETECT)) {
+                    // Convert to bitmap for detection
+                    val bitmap = NativeDeadline.stage(NativeCore.STAGE_PREPROCESS) { imageProxy.toBitmap() }
                     
-                    if (bestTarget != null) {
-                        // حساب خطأ التتبع
-                        val centerX = imWidth / 2f
-                        val centerY = imHeight / 2f
-                        val targetCenterX = bestTarget.centerX().toFloat()
-                        val targetCenterY = bestTarget.centerY().toFloat()
-                        
-                        val errorX = (targetCenterX - centerX) / centerX
-                        val errorY = (targetCenterY - centerY) / centerY
-                        
-                        // تحديث التحكم
-                        guidanceController.updateTrackingError(errorX, errorY)
-                        
-                        // Get servo angles for display (scale to ±15 for HUD)
-                        val servoAngles = guidanceController.getServoAngles()
-                        // Use normalized error * 15 for scale display
-                        val yaw = (errorX * 15f).coerceIn(-15f, 15f)
-                        val pitch = (-errorY * 15f).coerceIn(-15f, 15f)
-                        
-                        // تحديث HUD
-                        handler.post {
-                            trackingOverlay.setImageDimensions(imWidth, imHeight)
-                            trackingOverlay.updateTrackingRects(listOf(bestTarget))
-                            trackingOverlay.setTrackingMode(true)
-                            trackingOverlay.yawValue = yaw
-                            trackingOverlay.pitchValue = pitch
-                            trackingOverlay.standStatus = "TRACK"
-                            trackingOverlay.trackStatus = "ON"
-                            trackingOverlay.txValue = bestTarget.centerX()
-                            trackingOverlay.tyValue = bestTarget.centerY()
-                            trackingOverlay.twValue = bestTarget.width()
-                            trackingOverlay.thValue = bestTarget.height()
-                            trackingOverlay.invalidate()  // إعادة الرسم!
-                        }
-                    }
-                } else {
-                    // لا توجد أهداف
-                    handler.post {
-                        trackingOverlay.setImageDimensions(imWidth, imHeight)
-                        trackingOverlay.updateTrackingRects(emptyList())
-                        trackingOverlay.setTrackingMode(false)
-                        trackingOverlay.standStatus = "SEARCH"
-                        trackingOverlay.trackStatus = "OFF"
-                        trackingOverlay.yawValue = 0f
-                        trackingOverlay.pitchValue = 0f
-                        trackingOverlay.invalidate()  // إعادة الرسم!
+                    // Run YOLO detection
+                    val detections = NativeDeadline.stage(NativeCore.STAGE_DETECT) {
+                        NativeTrace.zone(NativeTrace.YOLO_DETECT) { yoloDetector.detect(bitmap) }
                     }
+                    
+                    NativeDeadline.stage(NativeCore.STAGE_TRACK) { handleDetections(detections) }
                 }
             }
             
@@ -311,6 +270,64 @@ class TrackingActivity : AppCompatActivity(), TrackingController.TrackingCommand
         }
     }
     
+    private fun handleDetections(detections: List<Rect>) {
+        // تحويل إلى Rect list
+        val rects = detections.map { it }
+        
+        // تحديث الـ tracker
+        if (rects.isNotEmpty()) {
+            val bestTarget = rects.maxByOrNull { it.width() * it.height() }
+            
+            if (bestTarget != null) {
+                // حساب خطأ التتبع
+                val centerX = imWidth / 2f
+                val centerY = imHeight / 2f
+                val targetCenterX = bestTarget.centerX().toFloat()
+                val targetCenterY = bestTarget.centerY().toFloat()
+                
+                val errorX = (targetCenterX - centerX) / centerX
+                val errorY = (targetCenterY - centerY) / centerY
+                
+                // تحديث التحكم
+                guidanceController.updateTrackingError(errorX, errorY)
+                
+                // Get servo angles for display (scale to ±15 for HUD)
+                val servoAngles = guidanceController.getServoAngles()
+                // Use normalized error * 15 for scale display
+                val yaw = (errorX * 15f).coerceIn(-15f, 15f)
+                val pitch = (-errorY * 15f).coerceIn(-15f, 15f)
+                
+                // تحديث HUD
+                handler.post {
+                    trackingOverlay.setImageDimensions(imWidth, imHeight)
+                    trackingOverlay.updateTrackingRects(listOf(bestTarget))
+                    trackingOverlay.setTrackingMode(true)
+                    trackingOverlay.yawValue = yaw
+                    trackingOverlay.pitchValue = pitch
+                    trackingOverlay.standStatus = "TRACK"
+                    trackingOverlay.trackStatus = "ON"
+                    trackingOverlay.txValue = bestTarget.centerX()
+                    trackingOverlay.tyValue = bestTarget.centerY()
+                    trackingOverlay.twValue = bestTarget.width()
+                    trackingOverlay.thValue = bestTarget.height()
+                    trackingOverlay.invalidate()  // إعادة الرسم!
+                }
+            }
+        } else {
+            // لا توجد أهداف
+            handler.post {
+                trackingOverlay.setImageDimensions(imWidth, imHeight)
+                trackingOverlay.updateTrackingRects(emptyList())
+                trackingOverlay.setTrackingMode(false)
+                trackingOverlay.standStatus = "SEARCH"
+                trackingOverlay.trackStatus = "OFF"
+                trackingOverlay.yawValue = 0f
+                trackingOverlay.pitchValue = 0f
+                trackingOverlay.invalidate()  // إعادة الرسم!
+            }
+        }
+    }
+    
     private fun updateFps() {
         frameCount++
         val now = System.currentTimeMillis()
@@ -328,6 +345,8 @@ class TrackingActivity : AppCompatActivity(), TrackingController.TrackingCommand
     
     private fun startTracking() {
         isTracking = true
+        lastFrameNs = 0L
+        NativeCore.deadlineReset()
         guidanceController.startTracking()
         
         trackingOverlay.standStatus = "SEARCH"
@@ -339,6 +358,7 @@ class TrackingActivity : AppCompatActivity(), TrackingController.TrackingCommand
     private fun stopTracking() {
         isTracking = false
         guidanceController.stopTracking()
+        Log.i(TAG, NativeDeadline.summary())
         
         trackingOverlay.standStatus = "STAND"
         trackingOverlay.trackStatus = "OFF"
@@ -5,6 +5,7 @@ import com.example.canphon.managers.*
 import com.example.canphon.protocols.*
 import com.example.canphon.drivers.*
 import com.example.canphon.data.*
+import com.example.canphon.native_sensors.NativeCore
 
 import android.graphics.Color
 import android.os.Bundle
@@ -50,6 +51,34 @@ class GraphActivity : AppCompatActivity() {
     private val UPDATE_INTERVAL = 50L // 20Hz for graphs
     private val CONTROL_INTERVAL = 16L // 60Hz for servo commands
     private val VISIBLE_RANGE = 10f   // 10 seconds window
+    
+    // Points per series: one per pixel column of the chart (native decimation)
+    private val MIN_CHART_POINTS = 64
+    private val MAX_CHART_POINTS = 2048
+    
+    /**
+     * Reused buffers of one drawn series: native output and the Entry objects
+     * handed to the chart (no allocation per update)
+     */
+    private inner class ChartSeries {
+        val x = FloatArray(MAX_CHART_POINTS + 1)
+        val y = FloatArray(MAX_CHART_POINTS + 1)
+        private val pool = Array(MAX_CHART_POINTS + 1) { Entry() }
+        val entries = ArrayList<Entry>(MAX_CHART_POINTS + 1)
+        
+        fun fill(count: Int) {
+            entries.clear()
+            for (i in 0 until count) {
+                val e = pool[i]
+                e.x = x[i]
+                e.y = y[i]
+                entries.add(e)
+            }
+        }
+    }
+    
+    private val cmdSeries = Array(4) { ChartSeries() }
+    private val fbSeries = Array(4) { ChartSeries() }
 
     // Colors
     private val CMD_COLOR = Color.parseColor("#4ECCA3")  // Green
@@ -182,6 +211,9 @@ class GraphActivity : AppCompatActivity() {
             textColor = Color.GRAY
             textSize = 8f
             setDrawGridLines(false)
+            // Seconds before now
+            axisMinimum = -VISIBLE_RANGE
+            axisMaximum = 0f
         }
 
         chart.axisLeft.apply {
@@ -196,7 +228,9 @@ class GraphActivity : AppCompatActivity() {
         chart.axisRight.isEnabled = false
         chart.legend.isEnabled = false
 
-        chart.data = LineData()
+        // Commands hold between sends (stepped), feedback is sampled (linear)
+        chart.data = LineData(createSet("Cmd", CMD_COLOR, LineDataSet.Mode.STEPPED),
+            createSet("Fb", FB_COLOR, LineDataSet.Mode.LINEAR))
     }
 
     private fun startGraphing() {
@@ -237,6 +271,8 @@ class GraphActivity : AppCompatActivity() {
     }
 
     private fun startControlLoop() {
+        // Native control thread (200 Hz, off the looper) when available
+        if (busManager.startNativeControl(NativeCore.CONTROL_MODE_ATTITUDE)) return
         handler.post(controlRunnable)
     }
     
@@ -288,59 +324,54 @@ class GraphActivity : AppCompatActivity() {
     }
 
     private fun addEntries() {
-        val timeSec = (System.currentTimeMillis() - startTime) / 1000f
-
-        // Servo 1
-        addEntry(chart1, timeSec, busManager.lastS1Cmd, busManager.s1Feedback)
-        
-        // Servo 2
-        addEntry(chart2, timeSec, busManager.lastS2Cmd, busManager.s2Feedback)
-        
-        // Servo 3
-        addEntry(chart3, timeSec, busManager.lastS3Cmd, busManager.s3Feedback)
-        
-        // Servo 4
-        addEntry(chart4, timeSec, busManager.lastS4Cmd, busManager.s4Feedback)
+        busManager.sampleSerialChartSeries()
+        updateChart(chart1, 0)
+        updateChart(chart2, 1)
+        updateChart(chart3, 2)
+        updateChart(chart4, 3)
     }
 
-    private fun addEntry(chart: LineChart, time: Float, cmd: Float, feedback: Float) {
+    /**
+     * Redraw one chart from the native history: each series is decimated to
+     * the chart's pixel width, so the cost does not grow with the history
+     */
+    private fun updateChart(chart: LineChart, channel: Int) {
         val data = chart.data ?: return
-
-        var setCmd = data.getDataSetByIndex(0)
-        var setFb = data.getDataSetByIndex(1)
-
-        if (setCmd == null) {
-            setCmd = createSet("Cmd", CMD_COLOR)
-            data.addDataSet(setCmd)
-        }
+        val points = chart.viewPortHandler.contentWidth().toInt().coerceIn(MIN_CHART_POINTS, MAX_CHART_POINTS)
+        val windowMs = (VISIBLE_RANGE * 1000).toLong()
         
-        if (setFb == null) {
-            setFb = createSet("Fb", FB_COLOR)
-            data.addDataSet(setFb)
+        val cmd = cmdSeries[channel]
+        var n = busManager.getChartSeries(channel, false, windowMs,
+            NativeCore.SERIES_DECIMATE_LTTB, points, cmd.x, cmd.y)
+        if (n > 0) {
+            // Last command still holds now
+            cmd.x[n] = 0f
+            cmd.y[n] = cmd.y[n - 1]
+            n++
         }
-
-        // Add Command
-        data.addEntry(Entry(time, cmd), 0)
-
-        // Add Feedback (use 0 if invalid)
-        val fb = if (feedback < -900) 0f else feedback
-        data.addEntry(Entry(time, fb), 1)
-
+        cmd.fill(n)
+        
+        // Envelope keeps every overshoot of the feedback
+        val fb = fbSeries[channel]
+        fb.fill(busManager.getChartSeries(channel, true, windowMs,
+            NativeCore.SERIES_DECIMATE_MINMAX, points, fb.x, fb.y))
+        
+        (data.getDataSetByIndex(0) as LineDataSet).values = cmd.entries
+        (data.getDataSetByIndex(1) as LineDataSet).values = fb.entries
         data.notifyDataChanged()
         chart.notifyDataSetChanged()
-        chart.setVisibleXRangeMaximum(VISIBLE_RANGE)
-        chart.moveViewToX(data.entryCount.toFloat())
+        chart.invalidate()
     }
 
-    private fun createSet(label: String, color: Int): LineDataSet {
-        return LineDataSet(null, label).apply {
+    private fun createSet(label: String, color: Int, drawMode: LineDataSet.Mode): LineDataSet {
+        return LineDataSet(ArrayList(), label).apply {
             this.color = color
             setCircleColor(color)
             lineWidth = 2f
             circleRadius = 0f
             setDrawCircles(false)
             setDrawValues(false)
-            mode = LineDataSet.Mode.CUBIC_BEZIER
+            mode = drawMode
         }
     }
 
@@ -349,6 +380,7 @@ class GraphActivity : AppCompatActivity() {
         isRunning = false
         handler.removeCallbacks(updateRunnable)
         handler.removeCallbacks(controlRunnable)
+        busManager.stopNativeControl()
         gyroManager.stop()
     }
 }
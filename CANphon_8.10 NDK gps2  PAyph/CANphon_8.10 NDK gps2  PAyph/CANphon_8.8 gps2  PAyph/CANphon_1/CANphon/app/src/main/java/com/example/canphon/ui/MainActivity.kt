@@ -146,18 +146,10 @@ class MainActivity : AppCompatActivity() {
                 updateServoPositions()
             }
             
-            // Log data if recording
-            if (dataLogger.isRecording()) {
-                val positions = busManager.getServoPositions(roll, pitch)
-                dataLogger.logData(
-                    roll = roll,
-                    pitch = pitch,
-                    servo1Cmd = positions[0],
-                    servo2Cmd = positions[1],
-                    servo3Cmd = positions[2],
-                    servo4Cmd = positions[3]
-                )
-                if (dataLogger.getRecordCount() % 60 == 0) {
+            // Log data if recording: rows come from the telemetry bus, drained @ 10Hz
+            if (dataLogger.isRecording() && uiUpdateCounter % 10 == 0) {
+                dataLogger.drainBus()
+                if (uiUpdateCounter % 60 == 0) {
                     updateRecordButton()
                 }
             }
@@ -525,6 +517,9 @@ class MainActivity : AppCompatActivity() {
             Log.w(TAG, "Telemetry not found (excluded: $excludedForTelemetry)")
         }
         
+        // Network subscribers (recorder / plotter / scripts) on top of, or instead of, the radio
+        TelemetryStreamer.startPublisher()
+        
         // ===================================
         // PRIORITY 4: External GPS (Excludes all above)
         // ===================================
@@ -719,6 +714,7 @@ class MainActivity : AppCompatActivity() {
         busManager.disconnect()
         stm32Manager.disconnect()
         TelemetryStreamer.disconnect()
+        TelemetryStreamer.stopPublisher()
         
         try {
             unregisterReceiver(usbReceiver)
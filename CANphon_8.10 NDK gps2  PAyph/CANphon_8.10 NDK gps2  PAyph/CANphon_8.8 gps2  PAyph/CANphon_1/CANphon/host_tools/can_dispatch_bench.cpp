@@ -0,0 +1,165 @@
+/**
+ * can_dispatch_bench.cpp
+ * CAN Receive Dispatch Benchmark (host)
+ *
+ * Frames/s on one core for:
+ *   before - model of the old SharedBusManager.processFrame: hex string
+ *            and debug line built per frame, node map lookup, parse,
+ *            online-status scan per frame
+ *   after  - can_dispatch handler table, online mask once per USB read
+ *
+ * "before" is a C++ model of the Kotlin path (same work, no JVM/GC
+ * cost), so the real on-device gap is larger.
+ *
+ * Usage: can_dispatch_bench [frames]
+ */
+
+#include "can_dispatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int CHANNELS = 4;
+static const int FRAMES_PER_READ = 64;   // ~1 KB USB read of 8-byte frames
+static const int MAX_NODE_ID = 0x18;
+static const int64_t FEEDBACK_TIMEOUT_MS = 500;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedSeconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static std::vector<WsCanFrame> makeFrames(int count) {
+    std::vector<WsCanFrame> frames(count);
+    uint32_t seed = 0xC0FFEE;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        WsCanFrame& f = frames[i];
+        memset(&f, 0, sizeof(f));
+        // Mostly feedback from 4 servos, some bridge debug / foreign traffic
+        f.id = (i % 8 == 7) ? 0x599 : 0x581 + (seed >> 30);
+        f.dlc = 8;
+        f.data[0] = (uint8_t)seed;
+        f.data[1] = (uint8_t)((seed >> 8) & 0x3F);
+        f.data[2] = (uint8_t)(seed >> 16);
+    }
+    return frames;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Before: per-frame work of the old Kotlin processFrame
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct LegacyState {
+    int nodeToChannel[MAX_NODE_ID + 1];
+    float feedback[CHANNELS];
+    int64_t lastFeedbackTime[CHANNELS];
+    std::string lastRawCanFrame;
+    int rawFrameCount;
+    int onlineStatus;
+};
+
+static void legacyProcessFrame(LegacyState* st, const WsCanFrame& f, int64_t now) {
+    st->rawFrameCount++;
+
+    // joinToString(" ") { String.format("%02X", it) }
+    std::string hexData;
+    for (int i = 0; i < f.dlc; i++) {
+        char byteText[4];
+        snprintf(byteText, sizeof(byteText), "%02X", f.data[i]);
+        if (i) hexData += " ";
+        hexData += byteText;
+    }
+    char idText[16];
+    snprintf(idText, sizeof(idText), "%X", f.id);
+    st->lastRawCanFrame = std::string("ID:0x") + idText + " [" + hexData + "] #" + std::to_string(st->rawFrameCount);
+
+    int nodeId = (int)f.id - 0x580;
+    if (nodeId >= 1 && nodeId <= MAX_NODE_ID) {
+        int channel = st->nodeToChannel[nodeId];
+        if (channel >= 0 && f.dlc >= 2) {
+            int raw = f.data[0] | (f.data[1] << 8);
+            float angle = (float)raw / 16383.0f * 50.0f - 25.0f;
+            st->feedback[channel] = angle < -25.0f ? -25.0f : (angle > 25.0f ? 25.0f : angle);
+            st->lastFeedbackTime[channel] = now;
+        }
+    }
+
+    int status = 0;
+    for (int i = 0; i < CHANNELS; i++) {
+        if (now - st->lastFeedbackTime[i] < FEEDBACK_TIMEOUT_MS) status |= 1 << i;
+    }
+    st->onlineStatus = status;
+}
+
+static double runBefore(const std::vector<WsCanFrame>& frames, float* check) {
+    LegacyState st;
+    for (int i = 0; i <= MAX_NODE_ID; i++) st.nodeToChannel[i] = -1;
+    for (int i = 0; i < CHANNELS; i++) {
+        st.nodeToChannel[i + 1] = i;
+        st.feedback[i] = CAN_FEEDBACK_NONE;
+        st.lastFeedbackTime[i] = 0;
+    }
+    st.rawFrameCount = 0;
+    st.onlineStatus = 0;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < frames.size(); i++) {
+        legacyProcessFrame(&st, frames[i], 1000 + (int64_t)(i / FRAMES_PER_READ));
+    }
+    double seconds = elapsedSeconds(start);
+    *check = st.feedback[0] + st.feedback[3] + (float)st.lastRawCanFrame.size();
+    return frames.size() / seconds;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// After: native handler table
+// ═══════════════════════════════════════════════════════════════════════════
+
+static double runAfter(const std::vector<WsCanFrame>& frames, float* check) {
+    canDispatchReset();
+    for (int i = 0; i < CHANNELS; i++) canDispatchSetServoFeedback(0x581 + i, i);
+
+    int mask = 0;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < frames.size(); i += FRAMES_PER_READ) {
+        int n = (int)((frames.size() - i) < (size_t)FRAMES_PER_READ ? frames.size() - i : FRAMES_PER_READ);
+        int64_t now = 1000 + (int64_t)(i / FRAMES_PER_READ);
+        canDispatchFrames(&frames[i], n, now);
+        mask |= canDispatchOnlineMask(CHANNELS, now, FEEDBACK_TIMEOUT_MS);
+    }
+    double seconds = elapsedSeconds(start);
+
+    // What the UI asks for, once
+    char text[64];
+    int len = canDispatchFormatLastFrame(text, sizeof(text));
+    const CanDispatchShared* s = canDispatchShared();
+    *check = s->servo[0].position + s->servo[3].position + (float)len + (float)mask;
+    return frames.size() / seconds;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 2000000;
+    if (count <= 0) count = 2000000;
+
+    std::vector<WsCanFrame> frames = makeFrames(count);
+
+    float checkBefore = 0.0f;
+    float checkAfter = 0.0f;
+    double before = runBefore(frames, &checkBefore);
+    double after = runAfter(frames, &checkAfter);
+
+    const CanDispatchShared* s = canDispatchShared();
+    printf("Frames: %d (%d servos, 1/8 unhandled)\n", count, CHANNELS);
+    printf("before (per-frame strings): %12.0f frames/s/core\n", before);
+    printf("after  (handler table):     %12.0f frames/s/core  (%.1fx)\n", after, after / before);
+    printf("handled %llu, unhandled %llu, servo1 %.2f deg (%u frames)\n",
+           (unsigned long long)(s->framesTotal - s->framesUnhandled),
+           (unsigned long long)s->framesUnhandled, s->servo[0].position, s->servo[0].frames);
+    printf("sink %.1f / %.1f\n", checkBefore, checkAfter);  // Keeps both runs live
+    return 0;
+}
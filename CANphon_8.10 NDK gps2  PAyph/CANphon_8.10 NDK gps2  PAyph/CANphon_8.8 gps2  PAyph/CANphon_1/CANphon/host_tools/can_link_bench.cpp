@@ -0,0 +1,225 @@
+/**
+ * can_link_bench.cpp
+ * End-to-End CAN Link Benchmark (host)
+ *
+ * Controller side: position commands for N servos (SDO write 0x600+node),
+ * feedback received through the can_dispatch handler table.
+ * Bridge side: stand-in for the STM32 bridge that answers every position
+ * write with feedback on 0x580+node (same scaling as can_bridge.c).
+ *
+ * Both ends talk through a can_transport backend, so the same run works
+ * in-process or over a virtual bus:
+ *
+ *   can_link_bench loopback [seconds] [cycles/s] [servos]
+ *   can_link_bench serial-pair ...      (Waveshare protocol over a socketpair)
+ *   can_link_bench socketcan:vcan0 ...
+ *
+ * cycles/s = 0 floods with a bounded number of commands in flight.
+ * (vcan0: ip link add dev vcan0 type vcan && ip link set up vcan0)
+ */
+
+#include "can_dispatch.h"
+#include "can_transport.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <thread>
+#include <vector>
+
+static const int SERVO_CENTER_POS = 8191;
+static const int VALUE_RANGE = 2047;           // canValue in [-2047, 2047]
+static const int FLOOD_WINDOW_CYCLES = 8;      // Commands in flight per servo when flooding
+
+typedef std::chrono::steady_clock Clock;
+static const Clock::time_point epoch = Clock::now();
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Bridge Stand-In
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void runBridge(CanTransport* t, std::atomic<bool>* running) {
+    WsCanFrame rx[CAN_TRANSPORT_MAX_BATCH];
+    WsCanFrame tx[CAN_TRANSPORT_MAX_BATCH];
+
+    while (running->load(std::memory_order_relaxed)) {
+        int n = canTransportReceive(t, rx, CAN_TRANSPORT_MAX_BATCH, 50);
+        int replies = 0;
+        for (int i = 0; i < n; i++) {
+            const WsCanFrame& f = rx[i];
+            if (f.id <= 0x600 || f.id > 0x600 + 0x18 || f.dlc != 8) continue;
+            if (f.data[0] != 0x22 || f.data[1] != 0x03 || f.data[2] != 0x60) continue;
+
+            int32_t canValue = (int32_t)(f.data[4] | (f.data[5] << 8) | (f.data[6] << 16) | ((uint32_t)f.data[7] << 24));
+            int position = canValue * 4 + SERVO_CENTER_POS;
+
+            WsCanFrame& r = tx[replies++];
+            memset(&r, 0, sizeof(r));
+            r.id = 0x580 + (f.id - 0x600);
+            r.dlc = 8;
+            r.data[0] = (uint8_t)(position & 0xFF);
+            r.data[1] = (uint8_t)((position >> 8) & 0x3F);
+        }
+        if (replies > 0) canTransportSend(t, tx, replies);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Controller
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct LatencyLog {
+    int64_t sentUs[2 * VALUE_RANGE + 1];
+    std::vector<int32_t> samplesUs;
+    uint64_t unmatched;
+};
+
+static LatencyLog latency;
+
+// Feedback handler: the echoed position identifies the command
+static void onFeedback(const WsCanFrame* frame, int channel, int64_t nowMicros) {
+    (void)channel;
+    int position = frame->data[0] | (frame->data[1] << 8);
+    int key = (position - SERVO_CENTER_POS) / 4 + VALUE_RANGE;
+    if (key < 0 || key > 2 * VALUE_RANGE || latency.sentUs[key] == 0) {
+        latency.unmatched++;
+        return;
+    }
+    latency.samplesUs.push_back((int32_t)(nowMicros - latency.sentUs[key]));
+    latency.sentUs[key] = 0;
+}
+
+static void buildCommand(WsCanFrame* f, int node, int32_t canValue) {
+    memset(f, 0, sizeof(*f));
+    f->id = 0x600 + node;
+    f->dlc = 8;
+    f->data[0] = 0x22;
+    f->data[1] = 0x03;
+    f->data[2] = 0x60;
+    f->data[4] = (uint8_t)(canValue & 0xFF);
+    f->data[5] = (uint8_t)((canValue >> 8) & 0xFF);
+    f->data[6] = (uint8_t)((canValue >> 16) & 0xFF);
+    f->data[7] = (uint8_t)((canValue >> 24) & 0xFF);
+}
+
+static int32_t percentile(std::vector<int32_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char** argv) {
+    const char* spec = argc > 1 ? argv[1] : "loopback";
+    int seconds = argc > 2 ? atoi(argv[2]) : 3;
+    int rate = argc > 3 ? atoi(argv[3]) : 1000;
+    int servos = argc > 4 ? atoi(argv[4]) : 4;
+    if (seconds <= 0) seconds = 3;
+    if (servos < 1 || servos > CAN_DISPATCH_MAX_CHANNELS) servos = 4;
+
+    CanTransport* controller = nullptr;
+    CanTransport* bridge = nullptr;
+    if (strcmp(spec, "loopback") == 0) {
+        canTransportOpenLoopbackPair(&controller, &bridge, CAN_TRANSPORT_LOOPBACK_DEPTH);
+    } else if (strcmp(spec, "serial-pair") == 0) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+            fcntl(sv[0], F_SETFL, O_NONBLOCK);
+            fcntl(sv[1], F_SETFL, O_NONBLOCK);
+            controller = canTransportOpenWaveshare(sv[0], 1);
+            bridge = canTransportOpenWaveshare(sv[1], 1);
+        }
+    } else {
+        controller = canTransportOpen(spec);
+        bridge = canTransportOpen(spec);
+    }
+    if (controller == nullptr || bridge == nullptr) {
+        fprintf(stderr, "Cannot open transport %s\n", spec);
+        return 2;
+    }
+
+    canDispatchReset();
+    for (int i = 0; i < servos; i++) canDispatchSetHandler(0x581 + i, onFeedback, i);
+    latency.samplesUs.reserve((size_t)(rate > 0 ? rate : 20000) * servos * seconds);
+
+    std::atomic<bool> running(true);
+    std::thread bridgeThread(runBridge, bridge, &running);
+
+    WsCanFrame cmd[CAN_DISPATCH_MAX_CHANNELS];
+    WsCanFrame rx[CAN_TRANSPORT_MAX_BATCH];
+    int64_t periodUs = rate > 0 ? 1000000 / rate : 0;
+    int64_t start = nowUs();
+    int64_t end = start + (int64_t)seconds * 1000000;
+    int64_t nextCycle = start;
+    uint64_t cycle = 0;
+    uint64_t commandsSent = 0;
+
+    while (true) {
+        int64_t now = nowUs();
+        if (now >= end) break;
+
+        uint64_t inFlight = commandsSent - latency.samplesUs.size();
+        bool due = rate > 0 ? now >= nextCycle : inFlight < (uint64_t)(FLOOD_WINDOW_CYCLES * servos);
+        if (due) {
+            for (int i = 0; i < servos; i++) {
+                int32_t value = (int32_t)((cycle * servos + i) % (2 * VALUE_RANGE + 1)) - VALUE_RANGE;
+                buildCommand(&cmd[i], i + 1, value);
+                latency.sentUs[value + VALUE_RANGE] = now;
+            }
+            int sent = canTransportSend(controller, cmd, servos);
+            if (sent > 0) commandsSent += sent;
+            cycle++;
+            nextCycle += periodUs;
+        }
+
+        int timeoutMs = 0;
+        if (rate > 0 && nextCycle > now + 1000) timeoutMs = (int)((nextCycle - now) / 1000);
+        int n = canTransportReceive(controller, rx, CAN_TRANSPORT_MAX_BATCH, timeoutMs);
+        if (n > 0) canDispatchFrames(rx, n, nowUs());
+    }
+
+    // Collect stragglers
+    int64_t drainEnd = nowUs() + 200000;
+    while (nowUs() < drainEnd && latency.samplesUs.size() < commandsSent) {
+        int n = canTransportReceive(controller, rx, CAN_TRANSPORT_MAX_BATCH, 10);
+        if (n > 0) canDispatchFrames(rx, n, nowUs());
+    }
+    double elapsed = (nowUs() - start) / 1e6;
+
+    running = false;
+    bridgeThread.join();
+
+    CanTransportStats cs, bs;
+    canTransportGetStats(controller, &cs);
+    canTransportGetStats(bridge, &bs);
+    size_t received = latency.samplesUs.size();
+
+    printf("Transport: %s, %d servos, %s\n", canTransportName(controller), servos,
+           rate > 0 ? "paced" : "flood");
+    if (rate > 0) printf("Rate: %d cycles/s (%d frames/s each way)\n", rate, rate * servos);
+    printf("Commands: %llu sent, %zu answered, %llu lost, %llu unmatched\n",
+           (unsigned long long)commandsSent, received,
+           (unsigned long long)(commandsSent - received), (unsigned long long)latency.unmatched);
+    printf("Throughput: %.0f frames/s each way (%.2f s)\n", received / elapsed, elapsed);
+    printf("Round trip (us): p50 %d  p90 %d  p99 %d  max %d\n",
+           percentile(latency.samplesUs, 0.50), percentile(latency.samplesUs, 0.90),
+           percentile(latency.samplesUs, 0.99), percentile(latency.samplesUs, 1.0));
+    printf("Controller: sent %llu, received %llu, dropped %llu, errors %llu\n",
+           (unsigned long long)cs.framesSent, (unsigned long long)cs.framesReceived,
+           (unsigned long long)cs.framesDropped, (unsigned long long)cs.errors);
+    printf("Bridge:     sent %llu, received %llu, dropped %llu, errors %llu\n",
+           (unsigned long long)bs.framesSent, (unsigned long long)bs.framesReceived,
+           (unsigned long long)bs.framesDropped, (unsigned long long)bs.errors);
+
+    canTransportClose(controller);
+    canTransportClose(bridge);
+    return 0;
+}
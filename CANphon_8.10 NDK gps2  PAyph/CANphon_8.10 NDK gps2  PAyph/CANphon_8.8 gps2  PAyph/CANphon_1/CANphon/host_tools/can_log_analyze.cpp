@@ -0,0 +1,624 @@
+/**
+ * can_log_analyze.cpp
+ * CAN Log Analyzer (host)
+ *
+ * Offline statistics over can_recorder logs (binary or candump -l text):
+ *   - per-ID frame rate, inter-arrival interval percentiles and jitter
+ *   - bus utilisation from the exact bit length of every frame
+ *     (CRC-15 computed, stuff bits counted, EOF/IFS included)
+ *   - position command (0x600+node, SDO 0x6003) → feedback (0x580+node)
+ *     latency per servo
+ *   - gaps: intervals longer than gap-factor × the ID's median interval
+ *
+ *   can_log_analyze <log> [--bitrate 500000] [--window-ms 100]
+ *                         [--gap-factor 3] [--threads N]
+ *
+ * The log is memory-mapped and split into one chunk per thread; each chunk
+ * is parsed and analysed independently, then the partial results are
+ * merged (intervals and pending commands across chunk boundaries included).
+ */
+
+#include "can_recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+static const int CAN_STD_IDS = 2048;
+static const uint32_t SDO_TX_BASE = 0x600;
+static const uint32_t SDO_RX_BASE = 0x580;
+static const int MAX_NODES = 0x80;
+static const int MIN_FRAMES_FOR_GAPS = 10;
+static const int TOP_GAPS = 10;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Log-Linear Histogram (~1.5% resolution, mergeable)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Histogram {
+    static const int SUB = 64;
+    static const int BUCKETS = SUB + 58 * SUB;
+
+    std::vector<uint32_t> counts;
+    uint64_t total = 0;
+
+    static int bucketOf(uint64_t v) {
+        if (v < SUB) return (int)v;
+        int e = 63 - __builtin_clzll(v);
+        return SUB + (e - 6) * SUB + (int)((v >> (e - 6)) & (SUB - 1));
+    }
+
+    static uint64_t lowerBound(int b) {
+        if (b < SUB) return (uint64_t)b;
+        int e = (b - SUB) / SUB + 6;
+        return (uint64_t)(SUB + (b - SUB) % SUB) << (e - 6);
+    }
+
+    void add(uint64_t v) {
+        if (counts.empty()) counts.assign(BUCKETS, 0);
+        counts[bucketOf(v)]++;
+        total++;
+    }
+
+    void merge(const Histogram& o) {
+        if (o.counts.empty()) return;
+        if (counts.empty()) counts.assign(BUCKETS, 0);
+        for (int i = 0; i < BUCKETS; i++) counts[i] += o.counts[i];
+        total += o.total;
+    }
+
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)(p * (total - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen > rank) return lowerBound(i);
+        }
+        return 0;
+    }
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Exact Frame Length (classic CAN 2.0A/B)
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Stuffing state: 0 = no bit yet, 1..4 = run of zeros, 5..8 = run of ones.
+// A stuff bit (the complement) follows every 5 equal bits and starts the
+// next run; stuffing covers SOF through the last CRC bit
+static inline int stuffStep(int state, int bit, int* stuff) {
+    int last = state > 4 ? 1 : (state > 0 ? 0 : -1);
+    int run = state > 4 ? state - 4 : state;
+    if (bit == last) {
+        run++;
+    } else {
+        last = bit;
+        run = 1;
+    }
+    if (run == 5) {
+        (*stuff)++;
+        last = !last;
+        run = 1;
+    }
+    return last ? 4 + run : run;
+}
+
+// Byte-at-a-time CRC-15 and stuffing, so a frame costs ~16 lookups
+// instead of ~120 single-bit steps
+struct BitTables {
+    uint16_t crc[256];
+    uint8_t stuff[9][256];   // (next state << 4) | stuff bits
+
+    BitTables() {
+        for (int b = 0; b < 256; b++) {
+            uint32_t crcValue = 0;
+            for (int i = 7; i >= 0; i--) {
+                uint32_t next = ((b >> i) & 1) ^ ((crcValue >> 14) & 1);
+                crcValue = (crcValue << 1) & 0x7FFF;
+                if (next) crcValue ^= 0x4599;
+            }
+            crc[b] = (uint16_t)crcValue;
+        }
+        for (int state = 0; state < 9; state++) {
+            for (int b = 0; b < 256; b++) {
+                int count = 0;
+                int st = state;
+                for (int i = 7; i >= 0; i--) st = stuffStep(st, (b >> i) & 1, &count);
+                stuff[state][b] = (uint8_t)((st << 4) | count);
+            }
+        }
+    }
+};
+
+static const BitTables bitTables;
+
+// Bits on the wire: stuffed SOF..CRC plus CRC delimiter, ACK, EOF and IFS.
+// Returns total bits, stuff bits in *stuffBits
+static int frameBits(const CanLogRecord& r, int* stuffBits) {
+    typedef unsigned __int128 Bits;
+    int rtr = (r.flags & WS_FLAG_RTR) != 0;
+    int dlc = r.dlc > WS_MAX_DLC ? WS_MAX_DLC : r.dlc;
+
+    // SOF (0) is the leading bit of `length`; zero bits above it change
+    // neither the CRC (initial value 0) nor the packing
+    Bits acc;
+    int length;
+    if (r.flags & WS_FLAG_EXT) {
+        acc = (r.id >> 18) & 0x7FF;
+        acc = (acc << 2) | 3;                        // SRR, IDE
+        acc = (acc << 18) | (r.id & 0x3FFFF);
+        acc = (acc << 3) | ((uint32_t)rtr << 2);     // RTR, r1, r0
+        length = 1 + 11 + 2 + 18 + 3;
+    } else {
+        acc = r.id & 0x7FF;
+        acc = (acc << 3) | ((uint32_t)rtr << 2);     // RTR, IDE, r0
+        length = 1 + 11 + 3;
+    }
+    acc = (acc << 4) | (uint32_t)dlc;
+    length += 4;
+    if (!rtr) {
+        for (int i = 0; i < dlc; i++) acc = (acc << 8) | r.data[i];
+        length += 8 * dlc;
+    }
+
+    uint32_t crc = 0;
+    for (int b = (length + 7) / 8 - 1; b >= 0; b--) {
+        uint8_t byte = (uint8_t)(acc >> (8 * b));
+        crc = ((crc << 8) ^ bitTables.crc[((crc >> 7) ^ byte) & 0xFF]) & 0x7FFF;
+    }
+    acc = (acc << 15) | crc;
+    length += 15;
+
+    // Leading partial byte bit by bit, then whole bytes through the table
+    int stuff = 0;
+    int state = 0;
+    int top = (length + 7) / 8 - 1;
+    int lead = length - 8 * top;
+    uint8_t first = (uint8_t)(acc >> (8 * top));
+    for (int i = lead - 1; i >= 0; i--) state = stuffStep(state, (first >> i) & 1, &stuff);
+    for (int b = top - 1; b >= 0; b--) {
+        uint8_t step = bitTables.stuff[state][(uint8_t)(acc >> (8 * b))];
+        state = step >> 4;
+        stuff += step & 0x0F;
+    }
+
+    *stuffBits = stuff;
+    return length + stuff + 1 + 2 + 7 + 3;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Per-Chunk Partial Results
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Gap {
+    uint32_t id;
+    int64_t atUs;
+    int64_t lengthUs;
+};
+
+struct IdStats {
+    uint32_t id = 0;
+    uint64_t frames = 0;
+    uint64_t txFrames = 0;
+    int64_t firstUs = 0;
+    int64_t lastUs = 0;
+    double sumInterval = 0;
+    double sumSqInterval = 0;
+    Histogram intervals;
+    int64_t medianUs = 0;         // Pass 2 (merged over all chunks)
+    int64_t gapThresholdUs = 0;
+    uint64_t gaps = 0;
+    uint64_t missingFrames = 0;
+    int64_t longestGapUs = 0;
+
+    void addInterval(int64_t us) {
+        if (us < 0) us = 0;  // Threads timestamp slightly out of order
+        sumInterval += (double)us;
+        sumSqInterval += (double)us * us;
+        intervals.add((uint64_t)us);
+    }
+};
+
+struct NodeLatency {
+    int64_t pendingUs = -1;       // Unanswered command at the end of the chunk
+    int64_t leadFeedbackUs = -1;  // Feedback before the chunk's first command
+    bool commandSeen = false;
+    uint64_t commands = 0;
+    uint64_t answered = 0;
+    uint64_t superseded = 0;      // New command before feedback to the previous one
+    Histogram latency;
+};
+
+struct Chunk {
+    std::vector<CanLogRecord> parsed;   // Text logs only
+    const CanLogRecord* records = nullptr;
+    size_t count = 0;
+
+    std::vector<IdStats> ids;
+    int16_t stdSlot[CAN_STD_IDS];
+    std::unordered_map<uint32_t, int> extSlot;
+
+    int64_t windowBase = 0;              // Absolute window number of windowBits[0]
+    std::vector<uint64_t> windowBits;
+    uint64_t bits = 0;
+    uint64_t stuffBits = 0;
+
+    NodeLatency nodes[MAX_NODES];
+    std::vector<Gap> topGaps;
+
+    Chunk() { memset(stdSlot, -1, sizeof(stdSlot)); }
+
+    IdStats& stats(uint32_t id, uint8_t flags) {
+        int slot;
+        if (!(flags & WS_FLAG_EXT) && id < (uint32_t)CAN_STD_IDS) {
+            slot = stdSlot[id];
+            if (slot < 0) slot = stdSlot[id] = (int16_t)newSlot(id);
+        } else {
+            auto it = extSlot.find(id | 0x80000000u);
+            slot = it != extSlot.end() ? it->second : (extSlot[id | 0x80000000u] = newSlot(id | 0x80000000u));
+        }
+        return ids[slot];
+    }
+
+    int newSlot(uint32_t key) {
+        ids.emplace_back();
+        ids.back().id = key;
+        return (int)ids.size() - 1;
+    }
+};
+
+static void keepTopGap(std::vector<Gap>& top, const Gap& g) {
+    if ((int)top.size() < TOP_GAPS) {
+        top.push_back(g);
+    } else {
+        auto shortest = std::min_element(top.begin(), top.end(),
+                                         [](const Gap& a, const Gap& b) { return a.lengthUs < b.lengthUs; });
+        if (g.lengthUs > shortest->lengthUs) *shortest = g;
+    }
+}
+
+// Pass 1: rates, intervals, bus bits, latency
+static void analyseChunk(Chunk* c, int64_t windowUs) {
+    if (c->count == 0) return;
+    c->windowBase = c->records[0].timestampUs / windowUs;
+
+    for (size_t i = 0; i < c->count; i++) {
+        const CanLogRecord& r = c->records[i];
+        IdStats& s = c->stats(r.id, r.flags);
+        if (s.frames == 0) s.firstUs = r.timestampUs;
+        else s.addInterval(r.timestampUs - s.lastUs);
+        s.lastUs = r.timestampUs;
+        s.frames++;
+        if (r.flags & CAN_LOG_FLAG_TX) s.txFrames++;
+
+        int stuff;
+        int bits = frameBits(r, &stuff);
+        c->bits += bits;
+        c->stuffBits += stuff;
+        int64_t w = r.timestampUs / windowUs - c->windowBase;
+        if (w < 0) w = 0;
+        if ((size_t)w >= c->windowBits.size()) c->windowBits.resize(w + 1, 0);
+        c->windowBits[w] += bits;
+
+        if (r.flags & WS_FLAG_EXT) continue;
+        if (r.id > SDO_TX_BASE && r.id < SDO_TX_BASE + MAX_NODES && r.dlc == 8 &&
+            r.data[0] == 0x22 && r.data[1] == 0x03 && r.data[2] == 0x60) {
+            NodeLatency& n = c->nodes[r.id - SDO_TX_BASE];
+            if (n.pendingUs >= 0) n.superseded++;
+            n.pendingUs = r.timestampUs;
+            n.commandSeen = true;
+            n.commands++;
+        } else if (r.id > SDO_RX_BASE && r.id < SDO_RX_BASE + MAX_NODES) {
+            NodeLatency& n = c->nodes[r.id - SDO_RX_BASE];
+            if (n.pendingUs >= 0) {
+                n.latency.add((uint64_t)std::max<int64_t>(0, r.timestampUs - n.pendingUs));
+                n.answered++;
+                n.pendingUs = -1;
+            } else if (!n.commandSeen && n.leadFeedbackUs < 0) {
+                n.leadFeedbackUs = r.timestampUs;
+            }
+        }
+    }
+}
+
+// Pass 2: gaps against the merged median interval of each ID
+static void findGaps(Chunk* c, const std::unordered_map<uint32_t, int64_t>* medians, double gapFactor) {
+    for (IdStats& s : c->ids) {
+        auto it = medians->find(s.id);
+        s.medianUs = it != medians->end() ? it->second : 0;
+        s.gapThresholdUs = (int64_t)(s.medianUs * gapFactor);
+    }
+
+    std::vector<int64_t> last(c->ids.size(), -1);
+    for (size_t i = 0; i < c->count; i++) {
+        const CanLogRecord& r = c->records[i];
+        IdStats& s = c->stats(r.id, r.flags);
+        size_t slot = &s - c->ids.data();
+        if (last[slot] >= 0 && s.gapThresholdUs > 0) {
+            int64_t interval = r.timestampUs - last[slot];
+            if (interval > s.gapThresholdUs) {
+                s.gaps++;
+                s.missingFrames += interval / std::max<int64_t>(1, s.medianUs) - 1;
+                s.longestGapUs = std::max(s.longestGapUs, interval);
+                keepTopGap(c->topGaps, Gap{s.id, last[slot], interval});
+            }
+        }
+        last[slot] = r.timestampUs;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Loading (mmap; text chunks split at line boundaries and parsed in place)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void parseText(Chunk* c, const char* begin, const char* end) {
+    char line[256];
+    CanLogRecord r;
+    c->parsed.reserve((end - begin) / 45);
+    while (begin < end) {
+        const char* nl = (const char*)memchr(begin, '\n', end - begin);
+        const char* lineEnd = nl != nullptr ? nl : end;
+        size_t len = std::min<size_t>(lineEnd - begin, sizeof(line) - 1);
+        memcpy(line, begin, len);
+        line[len] = '\0';
+        if (canLogParseCandump(line, &r)) c->parsed.push_back(r);
+        begin = lineEnd + 1;
+    }
+    c->records = c->parsed.data();
+    c->count = c->parsed.size();
+}
+
+template <typename Fn>
+static void runParallel(int threads, Fn fn) {
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(fn, t);
+    fn(0);
+    for (auto& th : pool) th.join();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Report
+// ═══════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: can_log_analyze <log> [--bitrate 500000] [--window-ms 100] "
+                        "[--gap-factor 3] [--threads N]\n");
+        return 1;
+    }
+    const char* path = argv[1];
+    int bitrate = 500000;   // hcan1: Prescaler 10, 1+13+2 tq @ 80 MHz
+    int windowMs = 100;
+    double gapFactor = 3.0;
+    int threads = (int)std::thread::hardware_concurrency();
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--bitrate") == 0) bitrate = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--window-ms") == 0) windowMs = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--gap-factor") == 0) gapFactor = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = atoi(argv[i + 1]);
+    }
+    if (threads < 1) threads = 1;
+    if (bitrate <= 0 || windowMs <= 0 || gapFactor <= 1.0) return 1;
+    int64_t windowUs = (int64_t)windowMs * 1000;
+
+    auto t0 = std::chrono::steady_clock::now();
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 2;
+    }
+    size_t size = (size_t)st.st_size;
+    const char* data = (const char*)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 2;
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    bool binary = size >= sizeof(CanLogFileHeader) && memcmp(data, CAN_LOG_MAGIC, 8) == 0;
+    if (binary && ((const CanLogFileHeader*)data)->recordSize != sizeof(CanLogRecord)) {
+        fprintf(stderr, "%s: unsupported record size\n", path);
+        return 2;
+    }
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int t = 0; t < threads; t++) chunks.emplace_back(new Chunk());
+
+    // Binary: records used in place. Text: byte ranges cut after a newline
+    const CanLogRecord* recs = (const CanLogRecord*)(data + sizeof(CanLogFileHeader));
+    size_t totalRecs = binary ? (size - sizeof(CanLogFileHeader)) / sizeof(CanLogRecord) : 0;
+    std::vector<size_t> cuts(threads + 1, size);
+    cuts[0] = 0;
+    for (int t = 1; t < threads && !binary; t++) {
+        size_t at = size * t / threads;
+        const char* nl = (const char*)memchr(data + at, '\n', size - at);
+        cuts[t] = std::max(cuts[t - 1], nl != nullptr ? (size_t)(nl - data) + 1 : size);
+    }
+
+    runParallel(threads, [&](int t) {
+        Chunk* c = chunks[t].get();
+        if (binary) {
+            size_t from = totalRecs * t / threads;
+            c->records = recs + from;
+            c->count = totalRecs * (t + 1) / threads - from;
+        } else {
+            parseText(c, data + cuts[t], data + cuts[t + 1]);
+        }
+        analyseChunk(c, windowUs);
+    });
+
+    // ── Merge pass 1 (chunks in time order) ──
+    std::unordered_map<uint32_t, IdStats> ids;
+    std::vector<uint64_t> windows;
+    int64_t windowBase = -1;
+    uint64_t frames = 0, bits = 0, stuffBits = 0;
+    int64_t firstUs = 0, lastUs = 0;
+    NodeLatency nodes[MAX_NODES];
+
+    for (auto& cp : chunks) {
+        Chunk* c = cp.get();
+        if (c->count == 0) continue;
+        if (frames == 0) firstUs = c->records[0].timestampUs;
+        lastUs = c->records[c->count - 1].timestampUs;
+        frames += c->count;
+        bits += c->bits;
+        stuffBits += c->stuffBits;
+
+        for (const IdStats& s : c->ids) {
+            auto it = ids.find(s.id);
+            if (it == ids.end()) {
+                ids.emplace(s.id, s);
+                continue;
+            }
+            IdStats& m = it->second;
+            m.addInterval(s.firstUs - m.lastUs);   // Across the chunk boundary
+            m.frames += s.frames;
+            m.txFrames += s.txFrames;
+            m.lastUs = s.lastUs;
+            m.sumInterval += s.sumInterval;
+            m.sumSqInterval += s.sumSqInterval;
+            m.intervals.merge(s.intervals);
+        }
+
+        if (windowBase < 0) windowBase = c->windowBase;
+        size_t offset = (size_t)std::max<int64_t>(0, c->windowBase - windowBase);
+        if (windows.size() < offset + c->windowBits.size()) windows.resize(offset + c->windowBits.size(), 0);
+        for (size_t w = 0; w < c->windowBits.size(); w++) windows[offset + w] += c->windowBits[w];
+
+        for (int n = 1; n < MAX_NODES; n++) {
+            NodeLatency& m = nodes[n];
+            const NodeLatency& s = c->nodes[n];
+            if (m.pendingUs >= 0 && s.leadFeedbackUs >= 0) {
+                m.latency.add((uint64_t)std::max<int64_t>(0, s.leadFeedbackUs - m.pendingUs));
+                m.answered++;
+                m.pendingUs = -1;
+            } else if (m.pendingUs >= 0 && s.commandSeen) {
+                m.superseded++;
+            }
+            if (s.commandSeen) m.pendingUs = s.pendingUs;
+            m.commands += s.commands;
+            m.answered += s.answered;
+            m.superseded += s.superseded;
+            m.latency.merge(s.latency);
+        }
+    }
+    if (frames == 0) {
+        fprintf(stderr, "%s: no frames\n", path);
+        return 2;
+    }
+
+    // ── Pass 2: gaps ──
+    std::unordered_map<uint32_t, int64_t> medians;
+    for (auto& kv : ids) {
+        if (kv.second.frames >= MIN_FRAMES_FOR_GAPS) {
+            medians[kv.first] = (int64_t)kv.second.intervals.percentile(0.5);
+        }
+    }
+    runParallel(threads, [&](int t) { findGaps(chunks[t].get(), &medians, gapFactor); });
+
+    std::vector<Gap> topGaps;
+    std::unordered_map<uint32_t, int64_t> lastSeen;
+    for (auto& cp : chunks) {
+        Chunk* c = cp.get();
+        for (const IdStats& s : c->ids) {
+            IdStats& m = ids[s.id];
+            auto prev = lastSeen.find(s.id);
+            if (prev != lastSeen.end() && s.gapThresholdUs > 0 && s.firstUs - prev->second > s.gapThresholdUs) {
+                int64_t interval = s.firstUs - prev->second;
+                m.gaps++;
+                m.missingFrames += interval / std::max<int64_t>(1, s.medianUs) - 1;
+                m.longestGapUs = std::max(m.longestGapUs, interval);
+                keepTopGap(topGaps, Gap{s.id, prev->second, interval});
+            }
+            m.gaps += s.gaps;
+            m.missingFrames += s.missingFrames;
+            m.longestGapUs = std::max(m.longestGapUs, s.longestGapUs);
+            lastSeen[s.id] = s.lastUs;
+        }
+        for (const Gap& g : c->topGaps) keepTopGap(topGaps, g);
+    }
+    double analysisSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double seconds = (lastUs - firstUs) / 1e6;
+    if (seconds <= 0) seconds = 1e-6;
+
+    // ── Bus load ──
+    std::vector<double> loads;
+    loads.reserve(windows.size());
+    for (uint64_t b : windows) loads.push_back(100.0 * b / ((double)bitrate * windowMs / 1000.0));
+    std::vector<double> sortedLoads = loads;
+    std::sort(sortedLoads.begin(), sortedLoads.end());
+    auto loadAt = [&](double p) { return sortedLoads.empty() ? 0.0 : sortedLoads[(size_t)(p * (sortedLoads.size() - 1))]; };
+
+    printf("Log: %s (%s), %llu frames over %.3f s\n", path, binary ? "binary" : "candump -l",
+           (unsigned long long)frames, seconds);
+    printf("Analysed in %.3f s with %d threads (%.1f Mframes/s)\n\n", analysisSeconds, threads,
+           frames / analysisSeconds / 1e6);
+
+    printf("Bus load @ %d bit/s, %d ms windows: mean %.2f%%  p50 %.2f%%  p99 %.2f%%  peak %.2f%%\n",
+           bitrate, windowMs, 100.0 * bits / (bitrate * seconds), loadAt(0.5), loadAt(0.99), loadAt(1.0));
+    printf("Bits: %llu (%.1f per frame), stuff bits %.2f%%\n\n", (unsigned long long)bits,
+           (double)bits / frames, 100.0 * stuffBits / bits);
+
+    // ── Per ID ──
+    std::vector<IdStats*> order;
+    for (auto& kv : ids) order.push_back(&kv.second);
+    std::sort(order.begin(), order.end(), [](const IdStats* a, const IdStats* b) { return a->id < b->id; });
+
+    printf("%-10s %3s %9s %9s %9s %9s %9s %9s %5s %7s %9s\n", "ID", "DIR", "FRAMES", "RATE/s",
+           "MEAN ms", "P50 ms", "P99 ms", "JITTER ms", "GAPS", "MISSING", "LONGEST");
+    for (IdStats* s : order) {
+        uint64_t n = s->intervals.total;
+        double mean = n > 0 ? s->sumInterval / n : 0;
+        double var = n > 1 ? std::max(0.0, s->sumSqInterval / n - mean * mean) : 0;
+        const char* dir = s->txFrames == s->frames ? "TX" : (s->txFrames == 0 ? "RX" : "T/R");
+        char idText[16];
+        if (s->id & 0x80000000u) snprintf(idText, sizeof(idText), "%08X", s->id & 0x1FFFFFFF);
+        else snprintf(idText, sizeof(idText), "%03X", s->id);
+        printf("%-10s %3s %9llu %9.1f %9.3f %9.3f %9.3f %9.3f %5llu %7llu %7.1fms\n", idText, dir,
+               (unsigned long long)s->frames, s->frames / seconds, mean / 1000.0,
+               s->intervals.percentile(0.5) / 1000.0, s->intervals.percentile(0.99) / 1000.0,
+               std::sqrt(var) / 1000.0, (unsigned long long)s->gaps,
+               (unsigned long long)s->missingFrames, s->longestGapUs / 1000.0);
+    }
+
+    // ── Command → feedback ──
+    bool header = false;
+    for (int n = 1; n < MAX_NODES; n++) {
+        NodeLatency& m = nodes[n];
+        if (m.commands == 0) continue;
+        if (!header) {
+            printf("\nCommand → feedback latency (0x600+node SDO 0x6003 → next 0x580+node)\n");
+            printf("%-6s %9s %9s %10s %9s %9s %9s %9s\n", "NODE", "COMMANDS", "ANSWERED", "SUPERSEDED",
+                   "P50 ms", "P90 ms", "P99 ms", "MAX ms");
+            header = true;
+        }
+        printf("0x%02X   %9llu %9llu %10llu %9.3f %9.3f %9.3f %9.3f\n", n, (unsigned long long)m.commands,
+               (unsigned long long)m.answered, (unsigned long long)m.superseded,
+               m.latency.percentile(0.5) / 1000.0, m.latency.percentile(0.9) / 1000.0,
+               m.latency.percentile(0.99) / 1000.0, m.latency.percentile(1.0) / 1000.0);
+    }
+
+    // ── Gaps ──
+    if (!topGaps.empty()) {
+        std::sort(topGaps.begin(), topGaps.end(), [](const Gap& a, const Gap& b) { return a.lengthUs > b.lengthUs; });
+        printf("\nLongest gaps (> %.1f x median interval)\n", gapFactor);
+        for (const Gap& g : topGaps) {
+            int64_t median = std::max<int64_t>(1, medians[g.id]);
+            printf("  %03X at +%.3f s: %.1f ms (median %.3f ms, ~%lld frames missing)\n", g.id & 0x1FFFFFFF,
+                   (g.atUs - firstUs) / 1e6, g.lengthUs / 1000.0, median / 1000.0,
+                   (long long)(g.lengthUs / median - 1));
+        }
+    }
+
+    munmap((void*)data, size);
+    return 0;
+}
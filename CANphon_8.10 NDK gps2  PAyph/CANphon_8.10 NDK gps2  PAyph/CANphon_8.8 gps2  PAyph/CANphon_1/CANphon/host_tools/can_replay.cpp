@@ -0,0 +1,354 @@
+/**
+ * can_replay.cpp
+ * CAN Log Recorder / Replayer (host)
+ *
+ * Works on can_recorder logs (binary) and candump -l text:
+ *
+ *   can_replay gen <out> [seconds] [servos] [cycles/s]
+ *       Synthetic flight traffic (position writes 0x600+node, feedback
+ *       0x580+node 0.8-1.5 ms later) logged through the native recorder
+ *   can_replay convert <in> <out> [iface]
+ *   can_replay play <log> <target> [--fast] [--speed X] [--dir tx|rx|all] [--record out]
+ *                   [--trace out.json]
+ *
+ * Targets: loopback | pty (Waveshare framing through a pseudo-terminal)
+ *          | socketcan:<if> | serial:/dev/ttyX[@baud]
+ * For every target but serial:, a second endpoint receives the replay and
+ * checks it frame by frame; --record logs what it received.
+ * Output files ending in .log / .txt are candump -l text, others binary.
+ */
+
+#include "can_recorder.h"
+#include "can_transport.h"
+#include "native_trace.h"
+#include "serial_port.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int64_t SPIN_US = 100;          // Busy-wait the last stretch before a frame is due
+static const int PEER_IDLE_TIMEOUT_MS = 1000;
+
+static int64_t monoUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleepUntilUs(int64_t targetUs) {
+    if (targetUs - monoUs() > SPIN_US) {
+        int64_t wakeUs = targetUs - SPIN_US;
+        struct timespec ts;
+        ts.tv_sec = wakeUs / 1000000;
+        ts.tv_nsec = (wakeUs % 1000000) * 1000;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+    }
+    while (monoUs() < targetUs) {
+    }
+}
+
+static bool isTextLog(const char* path) {
+    size_t n = strlen(path);
+    return (n > 4 && (strcmp(path + n - 4, ".log") == 0 || strcmp(path + n - 4, ".txt") == 0));
+}
+
+static int writeLog(const char* path, const CanLogRecord* records, int count, const char* iface) {
+    return isTextLog(path) ? canLogExportCandump(path, records, count, iface)
+                           : canLogSave(path, records, count);
+}
+
+static int32_t percentile(std::vector<int32_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void toFrame(const CanLogRecord& r, WsCanFrame* f) {
+    f->id = r.id;
+    f->dlc = r.dlc;
+    f->flags = (uint8_t)(r.flags & (WS_FLAG_EXT | WS_FLAG_RTR));
+    memcpy(f->data, r.data, WS_MAX_DLC);
+    if (f->flags & WS_FLAG_RTR) memset(f->data, 0, WS_MAX_DLC);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// gen
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int runGenerate(int argc, char** argv) {
+    if (argc < 3) return 1;
+    const char* out = argv[2];
+    int seconds = argc > 3 ? atoi(argv[3]) : 10;
+    int servos = argc > 4 ? atoi(argv[4]) : 4;
+    int rate = argc > 5 ? atoi(argv[5]) : 100;
+    if (seconds <= 0 || servos <= 0 || servos > 16 || rate <= 0) return 1;
+
+    int64_t cycles = (int64_t)seconds * rate;
+    int64_t frames = cycles * servos * 2;
+    if (!canRecorderStart((int)frames)) return 2;
+
+    int64_t periodUs = 1000000 / rate;
+    int64_t t0 = canRecorderNowUs();
+    uint32_t lcg = 12345;
+    WsCanFrame f;
+    memset(&f, 0, sizeof(f));
+    f.dlc = 8;
+
+    int64_t start = monoUs();
+    for (int64_t c = 0; c < cycles; c++) {
+        int64_t cycleUs = t0 + c * periodUs;
+        for (int s = 0; s < servos; s++) {
+            int32_t value = (int32_t)((c * 7 + s * 300) % 4095) - 2047;
+            f.id = 0x601 + s;
+            f.data[0] = 0x22;
+            f.data[1] = 0x03;
+            f.data[2] = 0x60;
+            f.data[3] = 0;
+            memcpy(&f.data[4], &value, 4);
+            canRecorderLogAt(&f, 1, 1, cycleUs + s * 60);
+
+            lcg = lcg * 1103515245u + 12345u;
+            int position = value * 4 + 8191;
+            f.id = 0x581 + s;
+            memset(f.data, 0, WS_MAX_DLC);
+            f.data[0] = (uint8_t)(position & 0xFF);
+            f.data[1] = (uint8_t)((position >> 8) & 0x3F);
+            canRecorderLogAt(&f, 1, 0, cycleUs + s * 60 + 800 + (lcg >> 16) % 700);
+        }
+    }
+    int64_t elapsedUs = monoUs() - start;
+
+    // Feedback of one servo may land after the next command; keep the log in time order
+    std::vector<CanLogRecord> records((size_t)frames);
+    int count = canRecorderSnapshot(records.data(), (int)frames);
+    records.resize(count);
+    std::stable_sort(records.begin(), records.end(),
+                     [](const CanLogRecord& a, const CanLogRecord& b) { return a.timestampUs < b.timestampUs; });
+
+    if (writeLog(out, records.data(), count, "can0") != 0) return 2;
+    printf("Generated %d frames (%d s, %d servos, %d cycles/s) -> %s\n", count, seconds, servos, rate, out);
+    printf("Recorder: %.1f ns/frame\n", elapsedUs * 1000.0 / (frames > 0 ? frames : 1));
+    return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// convert
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int runConvert(int argc, char** argv) {
+    if (argc < 4) return 1;
+    const char* iface = argc > 4 ? argv[4] : "can0";
+
+    int count = 0;
+    CanLogRecord* records = canLogLoad(argv[2], &count);
+    if (records == nullptr) return 2;
+    int result = writeLog(argv[3], records, count, iface);
+    canLogFree(records);
+    if (result != 0) return 2;
+    printf("Converted %d frames: %s -> %s\n", count, argv[2], argv[3]);
+    return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// play
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct PeerResult {
+    uint64_t received = 0;
+    uint64_t mismatched = 0;
+};
+
+// Receive the replay on the far endpoint and compare it with what was sent
+static void runPeer(CanTransport* peer, const std::vector<WsCanFrame>* expected,
+                    std::atomic<bool>* senderDone, PeerResult* result) {
+    WsCanFrame rx[CAN_TRANSPORT_MAX_BATCH];
+    size_t next = 0;
+    int64_t lastRxUs = monoUs();
+    traceSetThreadName("replay-peer");
+
+    while (next < expected->size()) {
+        int n = canTransportReceive(peer, rx, CAN_TRANSPORT_MAX_BATCH, 50);
+        if (n < 0) break;
+        if (n == 0) {
+            if (senderDone->load() && monoUs() - lastRxUs > PEER_IDLE_TIMEOUT_MS * 1000) break;
+            continue;
+        }
+        lastRxUs = monoUs();
+        TRACE_ZONE("replay.check");
+        TRACE_COUNTER("replay.rx.batch", n);
+        for (int i = 0; i < n && next < expected->size(); i++, next++) {
+            const WsCanFrame& e = (*expected)[next];
+            const WsCanFrame& r = rx[i];
+            if (r.id != e.id || r.dlc != e.dlc || (r.flags & WS_FLAG_RTR) != (e.flags & WS_FLAG_RTR) ||
+                memcmp(r.data, e.data, e.dlc) != 0) {
+                result->mismatched++;
+            }
+        }
+    }
+    result->received = next;
+}
+
+static int runPlay(int argc, char** argv) {
+    if (argc < 4) return 1;
+    const char* logPath = argv[2];
+    const char* target = argv[3];
+    bool fast = false;
+    double speed = 1.0;
+    const char* dir = "all";
+    const char* recordPath = nullptr;
+    const char* tracePath = nullptr;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--fast") == 0) fast = true;
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) dir = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else return 1;
+    }
+    if (speed <= 0) speed = 1.0;
+
+    int total = 0;
+    CanLogRecord* records = canLogLoad(logPath, &total);
+    if (records == nullptr) return 2;
+
+    std::vector<WsCanFrame> frames;
+    std::vector<int64_t> timesUs;
+    frames.reserve(total);
+    timesUs.reserve(total);
+    for (int i = 0; i < total; i++) {
+        bool tx = (records[i].flags & CAN_LOG_FLAG_TX) != 0;
+        if ((strcmp(dir, "tx") == 0 && !tx) || (strcmp(dir, "rx") == 0 && tx)) continue;
+        WsCanFrame f;
+        toFrame(records[i], &f);
+        frames.push_back(f);
+        timesUs.push_back(records[i].timestampUs);
+    }
+    canLogFree(records);
+    if (frames.empty()) {
+        fprintf(stderr, "%s: no frames to replay\n", logPath);
+        return 2;
+    }
+
+    // Sender and (when reachable) a receiving endpoint
+    CanTransport* sender = nullptr;
+    CanTransport* peer = nullptr;
+    if (strcmp(target, "loopback") == 0) {
+        canTransportOpenLoopbackPair(&sender, &peer, CAN_TRANSPORT_LOOPBACK_DEPTH);
+    } else if (strcmp(target, "pty") == 0) {
+        SerialPty pty;
+        if (serialOpenPty(&pty) == 0) {
+            sender = canTransportOpenWaveshare(pty.masterFd, 1);
+            std::string spec = std::string("serial:") + pty.slavePath;
+            peer = canTransportOpen(spec.c_str());
+        }
+    } else {
+        sender = canTransportOpen(target);
+        if (strncmp(target, "socketcan:", 10) == 0) peer = canTransportOpen(target);
+    }
+    if (sender == nullptr) {
+        fprintf(stderr, "Cannot open transport %s\n", target);
+        return 2;
+    }
+
+    if (recordPath != nullptr && peer != nullptr) {
+        canRecorderStart((int)frames.size());
+        canTransportSetRecording(peer, 1);
+    }
+
+    if (tracePath != nullptr) {
+        traceStart(0);
+        traceSetThreadName("replay-send");
+    }
+
+    std::atomic<bool> senderDone(false);
+    PeerResult peerResult;
+    std::thread peerThread;
+    if (peer != nullptr) peerThread = std::thread(runPeer, peer, &frames, &senderDone, &peerResult);
+
+    // Original timing: frame i is due at start + (t_i - t_0) / speed; frames
+    // already due go out together. Fast: full batches back to back
+    std::vector<int32_t> lateUs;
+    lateUs.reserve(frames.size());
+    size_t next = 0;
+    int64_t start = monoUs();
+    while (next < frames.size()) {
+        size_t batchEnd = next + 1;
+        if (fast) {
+            batchEnd = std::min(frames.size(), next + CAN_TRANSPORT_MAX_BATCH);
+        } else {
+            int64_t due = start + (int64_t)((timesUs[next] - timesUs[0]) / speed);
+            sleepUntilUs(due);
+            int64_t now = monoUs();
+            while (batchEnd < frames.size() && batchEnd - next < CAN_TRANSPORT_MAX_BATCH &&
+                   start + (int64_t)((timesUs[batchEnd] - timesUs[0]) / speed) <= now) {
+                batchEnd++;
+            }
+            for (size_t i = next; i < batchEnd; i++) {
+                lateUs.push_back((int32_t)(now - start - (int64_t)((timesUs[i] - timesUs[0]) / speed)));
+            }
+        }
+
+        if (!lateUs.empty()) TRACE_COUNTER("replay.lateUs", lateUs.back());
+        int sent = canTransportSend(sender, &frames[next], (int)(batchEnd - next));
+        if (sent < 0) break;
+        if (sent == 0) std::this_thread::yield();  // Queue full: the receiver catches up
+        next += sent;
+    }
+    int64_t elapsedUs = monoUs() - start;
+    senderDone = true;
+    if (peerThread.joinable()) peerThread.join();
+
+    double logSeconds = (timesUs.back() - timesUs[0]) / 1e6;
+    printf("Replay: %zu of %zu frames on %s (%s, %s)\n", next, frames.size(), canTransportName(sender),
+           fast ? "as fast as possible" : "original timing", dir);
+    printf("Time: %.3f s (log spans %.3f s), %.0f frames/s\n", elapsedUs / 1e6, logSeconds,
+           next * 1e6 / (elapsedUs > 0 ? elapsedUs : 1));
+    if (!fast) {
+        printf("Send lateness (us): p50 %d  p99 %d  max %d\n", percentile(lateUs, 0.50),
+               percentile(lateUs, 0.99), percentile(lateUs, 1.0));
+    }
+    if (peer != nullptr) {
+        printf("Peer: %llu received, %llu missing, %llu mismatched\n",
+               (unsigned long long)peerResult.received,
+               (unsigned long long)(frames.size() - peerResult.received),
+               (unsigned long long)peerResult.mismatched);
+    }
+
+    if (tracePath != nullptr) {
+        traceStop();
+        printf("Trace: %d events -> %s\n", traceWriteChrome(tracePath), tracePath);
+    }
+
+    if (recordPath != nullptr && peer != nullptr) {
+        canRecorderStop();
+        int n = isTextLog(recordPath) ? canRecorderExportCandump(recordPath, "can0") : canRecorderSave(recordPath);
+        printf("Recorded %d received frames -> %s\n", n, recordPath);
+    }
+
+    canTransportClose(sender);
+    if (peer != nullptr) canTransportClose(peer);
+    return peer != nullptr && (peerResult.received != frames.size() || peerResult.mismatched > 0) ? 3 : 0;
+}
+
+int main(int argc, char** argv) {
+    int result = 1;
+    if (argc > 1 && strcmp(argv[1], "gen") == 0) result = runGenerate(argc, argv);
+    else if (argc > 1 && strcmp(argv[1], "convert") == 0) result = runConvert(argc, argv);
+    else if (argc > 1 && strcmp(argv[1], "play") == 0) result = runPlay(argc, argv);
+
+    if (result == 1) {
+        fprintf(stderr,
+                "Usage: can_replay gen <out> [seconds] [servos] [cycles/s]\n"
+                "       can_replay convert <in> <out> [iface]\n"
+                "       can_replay play <log> <loopback|pty|socketcan:IF|serial:DEV[@baud]>\n"
+                "                  [--fast] [--speed X] [--dir tx|rx|all] [--record out] [--trace out.json]\n");
+    }
+    return result;
+}
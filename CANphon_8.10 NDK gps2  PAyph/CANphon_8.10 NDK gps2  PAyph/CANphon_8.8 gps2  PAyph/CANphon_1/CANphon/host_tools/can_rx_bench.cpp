@@ -0,0 +1,260 @@
+/**
+ * can_rx_bench.cpp
+ * CAN Receive Path Benchmark (host)
+ *
+ * Bridge feedback is written into a pty (the adapter side) at a fixed
+ * rate; the app side receives, decodes and dispatches it with:
+ *   kotlin - model of SharedBusManager's readExecutor loop: one 1 KB read
+ *            with a 10 ms timeout, wsDecodeDispatch, online mask, repeat
+ *   native - can_rx_thread on a Waveshare transport (epoll wait, decode
+ *            everything buffered, dispatch), with its nice value / CPU mask
+ *
+ * Reports the reader's CPU share and feedback latency (write into the pty
+ * to handler call; the send time travels in the frame's data bytes).
+ *
+ * "kotlin" runs the same native calls without the JVM, JNI crossings or
+ * usb-serial's UsbRequest handling, so on the device its cost is higher.
+ * On the device, compare with can_log_analyze on recorded logs instead.
+ *
+ * Usage: can_rx_bench [kotlin|native|both] [--servos N] [--rate HZ]
+ *                     [--seconds S] [--nice N] [--cpus MASK]
+ */
+
+#include "can_dispatch.h"
+#include "can_rx_thread.h"
+#include "can_transport.h"
+#include "serial_port.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const uint32_t FEEDBACK_BASE_ID = 0x581;
+static const int KOTLIN_READ_SIZE = 1024;      // WaveshareAdapter.readBuffer
+static const int KOTLIN_READ_TIMEOUT_MS = 10;  // WaveshareAdapter.READ_TIMEOUT
+static const int64_t FEEDBACK_TIMEOUT_MS = 500;
+
+typedef std::chrono::steady_clock Clock;
+static const Clock::time_point epoch = Clock::now();
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count();
+}
+
+static int64_t threadCpuUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Bridge (adapter side of the pty)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct BenchConfig {
+    int servos = 4;
+    int rateHz = 500;          // Feedback frames per servo per second
+    double seconds = 3.0;
+    int niceValue = CAN_RX_DEFAULT_NICE;
+    uint32_t cpuMask = 0;
+};
+
+// One burst per period, every servo's feedback with the send time in data[2..7]
+static long runBridge(int masterFd, const BenchConfig& cfg) {
+    std::vector<WsCanFrame> burst(cfg.servos);
+    std::vector<uint8_t> bytes(cfg.servos * WS_MAX_FRAME_BYTES);
+    Clock::duration period = std::chrono::microseconds(1000000 / cfg.rateHz);
+    Clock::time_point next = Clock::now();
+    Clock::time_point end = next + std::chrono::microseconds((int64_t)(cfg.seconds * 1e6));
+    long sent = 0;
+
+    while (next < end) {
+        std::this_thread::sleep_until(next);
+        next += period;
+
+        int64_t t = nowUs();
+        for (int i = 0; i < cfg.servos; i++) {
+            WsCanFrame& f = burst[i];
+            f.id = FEEDBACK_BASE_ID + i;
+            f.dlc = 8;
+            f.flags = 0;
+            f.data[0] = (uint8_t)sent;
+            f.data[1] = 0x10;
+            for (int b = 0; b < 6; b++) f.data[2 + b] = (uint8_t)(t >> (8 * b));
+        }
+        int length = wsEncodeFrames(burst.data(), cfg.servos, bytes.data(), (int)bytes.size());
+        int off = 0;
+        while (off < length) {
+            ssize_t n = write(masterFd, bytes.data() + off, length - off);
+            if (n < 0 && errno != EINTR && errno != EAGAIN) return sent;
+            if (n > 0) off += (int)n;
+        }
+        sent += cfg.servos;
+    }
+    return sent;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// App Side
+// ═══════════════════════════════════════════════════════════════════════════
+
+static std::vector<int64_t> latencyUs;
+
+static void latencyHandler(const WsCanFrame* frame, int, int64_t) {
+    int64_t sent = 0;
+    for (int b = 0; b < 6; b++) sent |= (int64_t)frame->data[2 + b] << (8 * b);
+    latencyUs.push_back(nowUs() - sent);
+}
+
+static int openAppSide(const char* path) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0 || serialConfigureRaw(fd, WS_SERIAL_BAUD) != 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+struct RunResult {
+    long sent;
+    size_t received;
+    int64_t cpuUs;
+    int64_t wallUs;
+    uint64_t wakeups;
+};
+
+// readExecutor { readAndDispatch(now); updateServoOnlineStatus(now) }
+static void kotlinLoop(SerialPort* port, int servos, std::atomic<bool>* stop, int64_t* cpuUs, uint64_t* reads) {
+    uint8_t buffer[KOTLIN_READ_SIZE];
+    WsCanFrame frames[CAN_TRANSPORT_MAX_BATCH];
+    int64_t cpuStart = threadCpuUs();
+
+    while (!stop->load(std::memory_order_relaxed)) {
+        int64_t now = nowUs() / 1000;
+        int len = serialRead(port, buffer, sizeof(buffer), KOTLIN_READ_TIMEOUT_MS);
+        int n = wsDecode(buffer, len > 0 ? len : 0, frames, CAN_TRANSPORT_MAX_BATCH);
+        canDispatchFrames(frames, n, now);
+        canDispatchOnlineMask(servos, now, FEEDBACK_TIMEOUT_MS);
+        (*reads)++;
+    }
+    *cpuUs = threadCpuUs() - cpuStart;
+}
+
+static bool runMode(bool native, const BenchConfig& cfg, RunResult* result) {
+    SerialPty pty;
+    if (serialOpenPty(&pty) != 0) {
+        perror("pty");
+        return false;
+    }
+    int fd = openAppSide(pty.slavePath);
+    if (fd < 0) {
+        close(pty.masterFd);
+        return false;
+    }
+
+    canDispatchReset();
+    wsDecoderReset();
+    for (int i = 0; i < cfg.servos; i++) canDispatchSetHandler(FEEDBACK_BASE_ID + i, latencyHandler, i);
+    latencyUs.clear();
+    latencyUs.reserve((size_t)(cfg.servos * cfg.rateHz * (cfg.seconds + 1)));
+
+    std::atomic<bool> stop(false);
+    std::thread reader;
+    SerialPort* port = nullptr;
+    int64_t kotlinCpuUs = 0;
+    uint64_t kotlinReads = 0;
+
+    if (native) {
+        CanRxThreadConfig rx;
+        canRxThreadDefaultConfig(&rx);
+        rx.niceValue = cfg.niceValue;
+        rx.cpuMask = cfg.cpuMask;
+        if (!canRxThreadStart(canTransportOpenWaveshare(fd, 1), &rx)) return false;
+    } else {
+        port = serialWrap(fd, 1);
+        reader = std::thread(kotlinLoop, port, cfg.servos, &stop, &kotlinCpuUs, &kotlinReads);
+    }
+
+    int64_t start = nowUs();
+    result->sent = runBridge(pty.masterFd, cfg);
+    usleep(50000);   // Let the reader drain
+
+    if (native) {
+        CanRxThreadStats s;
+        canRxThreadGetStats(&s);
+        result->cpuUs = s.cpuTimeUs;
+        result->wakeups = s.wakeups + s.timeouts;
+        canRxThreadStop();
+    } else {
+        stop = true;
+        reader.join();
+        result->cpuUs = kotlinCpuUs;
+        result->wakeups = kotlinReads;
+        serialClose(port);
+    }
+    result->wallUs = nowUs() - start;
+    result->received = latencyUs.size();
+    close(pty.masterFd);
+    return true;
+}
+
+static void report(const char* name, const BenchConfig& cfg, RunResult& r) {
+    printf("%-7s %8ld sent %8zu received%s  cpu %6.2f%%  %7.0f wakeups/s  latency us: p50 %6.0f  p99 %6.0f  max %6.0f\n",
+           name, r.sent, r.received, (long)r.received == r.sent ? "" : " (MISSING)",
+           100.0 * r.cpuUs / r.wallUs, r.wakeups / (r.wallUs / 1e6),
+           (double)percentile(latencyUs, 0.50), (double)percentile(latencyUs, 0.99),
+           (double)percentile(latencyUs, 1.0));
+    (void)cfg;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    const char* mode = "both";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--servos") == 0 && i + 1 < argc) cfg.servos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) cfg.rateHz = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) cfg.seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--nice") == 0 && i + 1 < argc) cfg.niceValue = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) cfg.cpuMask = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        else if (argv[i][0] != '-') mode = argv[i];
+        else {
+            fprintf(stderr, "Usage: %s [kotlin|native|both] [--servos N] [--rate HZ] [--seconds S] [--nice N] [--cpus MASK]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.servos < 1 || cfg.servos > CAN_TRANSPORT_MAX_BATCH || cfg.rateHz < 1 || cfg.rateHz > 100000) {
+        fprintf(stderr, "servos 1..%d, rate 1..100000\n", CAN_TRANSPORT_MAX_BATCH);
+        return 2;
+    }
+
+    printf("%d servos x %d Hz (%d frames/s) for %.1f s over a pty\n",
+           cfg.servos, cfg.rateHz, cfg.servos * cfg.rateHz, cfg.seconds);
+
+    bool ok = true;
+    RunResult r;
+    if (strcmp(mode, "kotlin") == 0 || strcmp(mode, "both") == 0) {
+        ok = runMode(false, cfg, &r) && ok;
+        report("kotlin", cfg, r);
+    }
+    if (strcmp(mode, "native") == 0 || strcmp(mode, "both") == 0) {
+        ok = runMode(true, cfg, &r) && ok;
+        report("native", cfg, r);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/**
+ * control_jitter_bench.cpp
+ * Control Loop Timing Benchmark (host)
+ *
+ * Runs the native control thread (timerfd, absolute ticks) in attitude
+ * mode against a sender that only counts frames, while a feeder thread
+ * publishes a ±20° roll / pitch sweep at IMU rate. For comparison, the
+ * looper pattern of GraphActivity.controlRunnable is replayed on a plain
+ * thread: work, then sleep CONTROL_INTERVAL (relative, so lateness adds up).
+ *
+ * --load N adds N busy threads (UI redraw / camera stand-in).
+ * --tracking feeds tracking errors from a 30 fps camera stand-in (15 ms
+ * of detection per frame) instead of attitude.
+ * --trace out.json records the native run as a Chrome trace.
+ *
+ *   control_jitter_bench [--seconds S] [--period US] [--load N] [--tracking] [--trace out.json]
+ */
+
+#include "control_thread.h"
+#include "native_trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+static const int LOOPER_INTERVAL_US = 16000;    // GraphActivity.CONTROL_INTERVAL
+static const int IMU_PERIOD_US = 5000;          // SENSOR_DELAY_FASTEST rotation vector
+static const int CAMERA_PERIOD_US = 33333;
+static const int DETECT_US = 15000;
+
+static std::atomic<bool> stop(false);
+static std::atomic<uint64_t> framesOut(0);
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int countingSend(const WsCanFrame*, int count) {
+    framesOut.fetch_add((uint64_t)count, std::memory_order_relaxed);
+    return count;
+}
+
+static double sweep(int64_t us) {
+    return 20.0 * sin(2 * M_PI * 0.5 * (double)us * 1e-6);
+}
+
+static void feeder() {
+    int64_t start = monotonicUs();
+    while (!stop.load(std::memory_order_relaxed)) {
+        int64_t t = monotonicUs() - start;
+        controlSetAttitude((float)sweep(t), (float)sweep(t + 500000), 0);
+        std::this_thread::sleep_for(std::chrono::microseconds(IMU_PERIOD_US));
+    }
+}
+
+// Camera analyzer stand-in: frame → detection → tracking error
+static void camera() {
+    traceSetThreadName("camera");
+    int64_t start = monotonicUs();
+    while (!stop.load(std::memory_order_relaxed)) {
+        {
+            TRACE_ZONE("camera.frame");
+            int64_t t = monotonicUs() - start;
+            {
+                TRACE_ZONE("yolo.detect");
+                int64_t until = monotonicUs() + DETECT_US;
+                while (monotonicUs() < until) {
+                }
+            }
+            controlSetTrackingError((float)sweep(t) / 20.0f, (float)sweep(t + 500000) / 20.0f, 0);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(CAMERA_PERIOD_US - DETECT_US));
+    }
+}
+
+static void busy() {
+    volatile double x = 1;
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 100000; i++) x = x * 1.0000001 + 1e-9;
+    }
+}
+
+static int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// Looper pattern: how far each period overshoots CONTROL_INTERVAL (it accumulates)
+static void looperPattern(int seconds, std::vector<int64_t>* periodErrorUs, int64_t* ticks, int64_t* expected) {
+    int64_t start = monotonicUs();
+    int64_t last = start;
+    int64_t end = start + (int64_t)seconds * 1000000;
+    while (monotonicUs() < end) {
+        std::this_thread::sleep_for(std::chrono::microseconds(LOOPER_INTERVAL_US));
+        int64_t now = monotonicUs();
+        periodErrorUs->push_back(now - last - LOOPER_INTERVAL_US);
+        last = now;
+        (*ticks)++;
+    }
+    *expected = (int64_t)seconds * 1000000 / LOOPER_INTERVAL_US;
+}
+
+int main(int argc, char** argv) {
+    int seconds = 5;
+    int periodUs = CONTROL_DEFAULT_PERIOD_US;
+    int load = 0;
+    bool trackingMode = false;
+    const char* tracePath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--period") == 0 && i + 1 < argc) periodUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) load = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tracking") == 0) trackingMode = true;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--period US] [--load N] [--tracking] [--trace out.json]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (seconds < 1 || periodUs < 500 || load < 0) return 2;
+
+    // X layout (CANServoProtocol.X_LAYOUT)
+    int nodes[4] = {1, 2, 3, 4};
+    float rollGains[4] = {-1, 1, 1, -1};
+    float pitchGains[4] = {1, 1, -1, -1};
+    controlSetLayout(nodes, rollGains, pitchGains, 4);
+    controlSetMode(trackingMode ? CONTROL_MODE_TRACKING : CONTROL_MODE_ATTITUDE);
+    if (tracePath != nullptr) traceStart(0);
+
+    std::vector<std::thread> threads;
+    threads.emplace_back(trackingMode ? camera : feeder);
+    for (int i = 0; i < load; i++) threads.emplace_back(busy);
+
+    ControlThreadConfig config;
+    controlThreadDefaultConfig(&config);
+    config.periodUs = periodUs;
+    config.niceValue = 0;   // Unprivileged on the host
+    if (!controlThreadStart(&config, countingSend)) {
+        fprintf(stderr, "control thread did not start\n");
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    ControlThreadStats s;
+    controlThreadGetStats(&s);
+    controlThreadStop();
+    if (tracePath != nullptr) {
+        traceStop();
+        TraceStats ts;
+        traceGetStats(&ts);
+        int written = traceWriteChrome(tracePath);
+        printf("trace: %d events from %d threads -> %s (%llu overwritten)\n", written, ts.threads, tracePath,
+               (unsigned long long)ts.overwritten);
+    }
+
+    std::vector<int64_t> looperError;
+    int64_t looperTicks = 0, looperExpected = 0;
+    looperPattern(seconds, &looperError, &looperTicks, &looperExpected);
+
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    printf("%d s, %d busy threads, %u CPUs\n", seconds, load, std::thread::hardware_concurrency());
+    printf("native  %5d us: %llu ticks, %llu overruns, jitter mean %lld p99 %lld max %lld us, "
+           "work mean %lld max %lld us, cpu %.2f%%, %llu frames\n",
+           periodUs, (unsigned long long)s.ticks, (unsigned long long)s.overruns, (long long)s.jitterMeanUs,
+           (long long)s.jitterP99Us, (long long)s.jitterMaxUs, (long long)s.workMeanUs, (long long)s.workMaxUs,
+           s.runTimeUs > 0 ? 100.0 * s.cpuTimeUs / s.runTimeUs : 0.0, (unsigned long long)framesOut.load());
+    printf("looper  %5d us: %lld runs (%lld at a fixed rate), period error p50 %lld p99 %lld max %lld us\n",
+           LOOPER_INTERVAL_US, (long long)looperTicks, (long long)looperExpected,
+           (long long)percentile(looperError, 0.5), (long long)percentile(looperError, 0.99),
+           (long long)percentile(looperError, 1.0));
+    return 0;
+}
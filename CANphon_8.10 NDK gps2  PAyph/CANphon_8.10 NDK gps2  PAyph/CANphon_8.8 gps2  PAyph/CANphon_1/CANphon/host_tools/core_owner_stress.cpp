@@ -0,0 +1,339 @@
+/**
+ * core_owner_stress.cpp
+ * Core Ownership Stress Test (host)
+ *
+ * Every thread of the app that touches the native core, at full speed:
+ * camera (tracking errors), IMU and GPS callbacks (fusion), telemetry
+ * setters, UI (start / stop, live PID gains) and the streamer (frames
+ * built from snapshots), against
+ *
+ *   1. no control thread: submitters drain the queue themselves
+ *   2. the control thread at 1 kHz holding the core
+ *
+ * Snapshots are checked for internal consistency (servo mix of the same
+ * pitch / yaw, equal fusion axes fed equal accelerations, telemetry
+ * fields written by one command), sequences never go back, every queued
+ * command is applied, start / stop is never refused while samples flood
+ * the queue, and nothing owner-side runs off the owner. Then
+ * one command script is applied by the submitting thread and again by
+ * the control thread under reader load: the resulting states must be
+ * identical (order of application is the order of submission).
+ *
+ * Build the host tools with -DCANPHON_HOST_TSAN=ON to run it under
+ * ThreadSanitizer.
+ *
+ *   core_owner_stress [--seconds S] [--script N]
+ */
+
+#include "control_thread.h"
+#include "core_owner.h"
+#include "param_store.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+static const float CMD_MAX = 25.0f;
+
+static std::atomic<bool> running(false);
+
+static int nullSend(const WsCanFrame*, int count) {
+    return count;
+}
+
+static CoreCommand command(uint32_t type, std::initializer_list<double> values, int32_t arg = 0) {
+    CoreCommand c;
+    memset(&c, 0, sizeof(c));
+    c.type = type;
+    c.arg = arg;
+    int i = 0;
+    for (double v : values) c.v[i++] = v;
+    return c;
+}
+
+static int submit(uint32_t type, std::initializer_list<double> values = {}, int32_t arg = 0) {
+    CoreCommand c = command(type, values, arg);
+    return coreSubmit(&c);
+}
+
+static float clampCmd(float v) {
+    return v < -CMD_MAX ? -CMD_MAX : v > CMD_MAX ? CMD_MAX : v;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Threads
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Counts {
+    std::atomic<uint64_t> submits{0};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> inconsistent{0};
+    std::atomic<uint64_t> regressions{0};
+    std::atomic<uint64_t> badFrames{0};
+    std::atomic<uint64_t> stateDrops{0};    // Start / stop refused (must stay 0)
+};
+
+// Invariants of one snapshot (anything torn breaks one of them)
+static bool consistent(const CoreSnapshot& s) {
+    float p = s.pitchCmd, y = s.yawCmd;
+    if (s.servoAngles[0] != clampCmd(p + y) || s.servoAngles[1] != clampCmd(p - y) ||
+        s.servoAngles[2] != clampCmd(-p - y) || s.servoAngles[3] != clampCmd(-p + y)) {
+        return false;
+    }
+    if (s.velN != s.velE || s.velE != s.velD) return false;
+    const TelemetryData& t = s.telemetry;
+    if (t.roll != t.pitch || t.pitch != t.yaw) return false;
+    if (t.s1Cmd != t.s2Cmd || t.s2Cmd != t.s3Cmd || t.s3Cmd != t.s4Cmd) return false;
+    return true;
+}
+
+static void reader(Counts* c) {
+    uint64_t last = 0;
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    while (running.load(std::memory_order_relaxed)) {
+        CoreSnapshot s;
+        coreSnapshot(&s);
+        if (!consistent(s)) c->inconsistent.fetch_add(1, std::memory_order_relaxed);
+        if (s.sequence < last) c->regressions.fetch_add(1, std::memory_order_relaxed);
+        last = s.sequence;
+
+        // Streamer: frame from the snapshot's record
+        int n = telemetryBuildFrameFrom(&s.telemetry, frame, sizeof(frame));
+        uint8_t x = 0;
+        for (int i = 0; i < n - 1; i++) x ^= frame[i];
+        if (n != TELEMETRY_FRAME_SIZE || x != frame[n - 1] || frame[7] != frame[9] || frame[8] != frame[10]) {
+            c->badFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        c->reads.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Camera analyzer: guidance updates (or tracking errors for the control thread)
+static void camera(Counts* c, bool control) {
+    uint32_t i = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        float e = (float)((int)(i++ % 200) - 100) / 100.0f;
+        if (control) controlSetTrackingError(e, -e, 0);
+        else submit(CORE_CMD_GUIDANCE_UPDATE, {e, -e, 0.033});
+        CoreSnapshot s;
+        coreSnapshot(&s);
+        if (!consistent(s)) c->inconsistent.fetch_add(1, std::memory_order_relaxed);
+        c->submits.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void imu(Counts* c) {
+    uint32_t i = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        double a = (double)(i++ % 7) * 0.1 - 0.3;
+        submit(CORE_CMD_FUSION_IMU, {a, a, a, 0.005});
+        submit(CORE_CMD_TELEM_ORIENTATION, {a * 10, a * 10, a * 10});
+        c->submits.fetch_add(2, std::memory_order_relaxed);
+    }
+}
+
+static void gps(Counts* c) {
+    uint32_t i = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        double d = (double)(i++ % 100) * 1e-5;
+        submit(CORE_CMD_FUSION_GPS, {24.7 + d, 46.7 + d, 600.0, (double)i});
+        submit(CORE_CMD_TELEM_GPS, {24.7 + d, 46.7 + d, 600, 1.5, 90, 9, 2, 0.9});
+        c->submits.fetch_add(2, std::memory_order_relaxed);
+        std::this_thread::yield();
+    }
+}
+
+static void servoFeedback(Counts* c) {
+    uint32_t i = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        double v = (double)(i++ % 50) - 25;
+        submit(CORE_CMD_TELEM_SERVO_CMD, {v, v, v, v});
+        submit(CORE_CMD_TELEM_SERVO_FB, {v, -v, v, -v});
+        c->submits.fetch_add(2, std::memory_order_relaxed);
+    }
+}
+
+// UI: start / stop tracking, retune live
+static void ui(Counts* c) {
+    uint32_t i = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        if (!submit((i & 1) ? CORE_CMD_GUIDANCE_STOP : CORE_CMD_GUIDANCE_START)) {
+            c->stateDrops.fetch_add(1, std::memory_order_relaxed);
+        }
+        paramSet(PARAM_PID_KP, (i & 2) ? 0.8f : 0.5f);
+        c->submits.fetch_add(1, std::memory_order_relaxed);
+        i++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+static bool runPhase(const char* name, bool control, int seconds) {
+    Counts c;
+    CoreOwnerStats before;
+    coreOwnerGetStats(&before);
+
+    if (control) {
+        ControlThreadConfig config;
+        controlThreadDefaultConfig(&config);
+        config.periodUs = 1000;
+        config.niceValue = 0;
+        controlSetMode(CONTROL_MODE_TRACKING);
+        if (!controlThreadStart(&config, nullSend)) {
+            printf("%s: control thread did not start\n", name);
+            return false;
+        }
+    }
+
+    running.store(true);
+    std::vector<std::thread> threads;
+    threads.emplace_back(camera, &c, control);
+    threads.emplace_back(imu, &c);
+    threads.emplace_back(gps, &c);
+    threads.emplace_back(servoFeedback, &c);
+    threads.emplace_back(ui, &c);
+    threads.emplace_back(reader, &c);
+    threads.emplace_back(reader, &c);
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running.store(false);
+    for (auto& t : threads) t.join();
+
+    ControlThreadStats cs = {};
+    if (control) {
+        controlThreadGetStats(&cs);
+        controlThreadStop();            // Releases the core after a last drain
+        controlSetMode(CONTROL_MODE_HOLD);
+    }
+
+    CoreOwnerStats s;
+    coreOwnerGetStats(&s);
+    uint64_t submitted = s.submitted - before.submitted;
+    uint64_t applied = s.applied - before.applied;
+    uint64_t dropped = s.dropped - before.dropped;
+    uint64_t violations = s.violations - before.violations;
+
+    printf("%-10s | %9llu submitted, %9llu applied, %7llu dropped, queue max %4u | drains %llu caller / %llu control",
+           name, (unsigned long long)submitted, (unsigned long long)applied, (unsigned long long)dropped,
+           s.queueHighWater, (unsigned long long)(s.drains - before.drains),
+           (unsigned long long)(s.ownerDrains - before.ownerDrains));
+    if (control) printf(", %llu ticks", (unsigned long long)cs.ticks);
+    printf("\n           | %9llu snapshot reads, %llu inconsistent, %llu regressions, %llu bad frames, %llu off-owner calls, %llu start / stop dropped\n",
+           (unsigned long long)c.reads.load(), (unsigned long long)c.inconsistent.load(),
+           (unsigned long long)c.regressions.load(), (unsigned long long)c.badFrames.load(),
+           (unsigned long long)violations, (unsigned long long)c.stateDrops.load());
+
+    return applied == submitted && c.inconsistent == 0 && c.regressions == 0 && c.badFrames == 0 &&
+           violations == 0 && c.stateDrops == 0 && s.ownedByControl == 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Determinism: same script, caller-applied vs control-thread-applied
+// ═══════════════════════════════════════════════════════════════════════════
+
+static std::vector<CoreCommand> buildScript(int length) {
+    std::vector<CoreCommand> s;
+    s.push_back(command(CORE_CMD_TELEM_INIT, {}));
+    s.push_back(command(CORE_CMD_FUSION_INIT, {0.98}));
+    s.push_back(command(CORE_CMD_GUIDANCE_INIT, {}));
+    s.push_back(command(CORE_CMD_GUIDANCE_START, {}));
+    uint32_t rng = 42;
+    for (int i = 0; i < length; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        double r = (double)(rng >> 8) / (double)(1u << 24) * 2.0 - 1.0;
+        switch ((rng >> 4) % 5) {
+            case 0: s.push_back(command(CORE_CMD_GUIDANCE_UPDATE, {r, r * 0.5, 0.005})); break;
+            case 1: s.push_back(command(CORE_CMD_FUSION_IMU, {r, r, r, 0.005})); break;
+            case 2: s.push_back(command(CORE_CMD_FUSION_GPS, {24.7 + r * 1e-4, 46.7, 600.0, (double)i})); break;
+            case 3: s.push_back(command(CORE_CMD_TELEM_ORIENTATION, {r * 90, r * 90, r * 90})); break;
+            case 4: s.push_back(command(CORE_CMD_PID_UPDATE, {r, 0.005}, (int32_t)(rng & 1))); break;
+        }
+    }
+    return s;
+}
+
+// Owned outputs only (sequence / applied differ between runs)
+static bool sameState(const CoreSnapshot& a, const CoreSnapshot& b) {
+    const size_t from = offsetof(CoreSnapshot, tracking);
+    return memcmp((const uint8_t*)&a + from, (const uint8_t*)&b + from, sizeof(CoreSnapshot) - from) == 0;
+}
+
+static void waitApplied(uint64_t target) {
+    CoreOwnerStats s;
+    for (;;) {
+        coreOwnerGetStats(&s);
+        if (s.applied >= target) return;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+static bool determinism(int length) {
+    paramResetDefaults();
+    std::vector<CoreCommand> script = buildScript(length);
+
+    // Caller-applied (no control thread)
+    for (const CoreCommand& c : script) coreSubmit(&c);
+    CoreSnapshot direct;
+    coreSnapshot(&direct);
+
+    // Control-thread-applied, the script fed in bursts while readers run
+    ControlThreadConfig config;
+    controlThreadDefaultConfig(&config);
+    config.periodUs = 1000;
+    config.niceValue = 0;
+    controlSetMode(CONTROL_MODE_HOLD);      // The thread only drains / publishes
+    if (!controlThreadStart(&config, nullSend)) return false;
+    Counts c;
+    running.store(true);
+    std::thread r1(reader, &c), r2(reader, &c);
+
+    CoreOwnerStats s;
+    coreOwnerGetStats(&s);
+    uint64_t target = s.applied;
+    for (size_t i = 0; i < script.size(); i++) {
+        while (!coreSubmit(&script[i])) std::this_thread::yield();     // Queue full: wait, keep the order
+        target++;
+        if (i % 64 == 63) std::this_thread::yield();
+    }
+    waitApplied(target);
+    controlThreadStop();
+    running.store(false);
+    r1.join();
+    r2.join();
+    CoreSnapshot owned;
+    coreSnapshot(&owned);
+
+    bool same = sameState(direct, owned);
+    printf("Script     | %zu commands: caller-applied vs control-thread-applied state %s"
+           " (pitch %.4f / %.4f, velN %.6f / %.6f)\n",
+           script.size(), same ? "identical" : "DIFFERENT", direct.pitchCmd, owned.pitchCmd, direct.velN, owned.velN);
+    return same && c.inconsistent == 0;
+}
+
+int main(int argc, char** argv) {
+    int seconds = 2;
+    int scriptLength = 20000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) scriptLength = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--script N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds < 1 || scriptLength < 1) return 2;
+
+    // Initial state through the queue, like the app's init
+    submit(CORE_CMD_TELEM_INIT);
+    submit(CORE_CMD_FUSION_INIT, {0.98});
+    submit(CORE_CMD_GUIDANCE_INIT);
+
+    bool ok = runPhase("caller", false, seconds);
+    ok = runPhase("control", true, seconds) && ok;
+    ok = determinism(scriptLength) && ok;
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+/**
+ * deadline_monitor_sim.cpp
+ * Stage Deadline Simulation (host)
+ *
+ *   1. Scripted camera pipeline (synthetic stage times, no clock): a YOLO
+ *      burst, a single GC pause and a slow-camera stretch. Detection must
+ *      be skipped on alternate frames from the 2nd slow detect until the
+ *      first probe back within budget; one pause alone must not engage
+ *      anything, three late frames in a row must engage predict.
+ *   2. The control thread in tracking mode at 200 Hz against a sender that
+ *      stalls for a while: commands are held (probe every
+ *      DEADLINE_HOLD_PROBE_TICKS ticks) and released when writes recover,
+ *      while a camera thread slows down into the predict policy.
+ *   3. Cost of deadlineRecord.
+ *
+ *   deadline_monitor_sim [--stall-ms MS]
+ */
+
+#include "control_thread.h"
+#include "core_owner.h"
+#include "deadline_monitor.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <thread>
+#include <time.h>
+
+static int64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void submit(uint32_t type, std::initializer_list<double> values = {}) {
+    CoreCommand c;
+    memset(&c, 0, sizeof(c));
+    c.type = type;
+    int i = 0;
+    for (double v : values) c.v[i++] = v;
+    coreSubmit(&c);
+}
+
+static void printStages(const DeadlineStats& s) {
+    printf("  stage      |     runs   misses | budget us   max us\n");
+    for (int i = 0; i < DEADLINE_STAGES; i++) {
+        if (s.runs[i] == 0) continue;
+        printf("  %-10s | %8llu %8llu | %9lld %8lld\n", deadlineStageName(i),
+               (unsigned long long)s.runs[i], (unsigned long long)s.misses[i],
+               (long long)s.budgetUs[i], (long long)s.maxUs[i]);
+    }
+    printf("  policies engaged: skip detection %llu, hold %llu, predict %llu | %llu detections skipped,"
+           " %llu sends held, %llu predicted ticks\n",
+           (unsigned long long)s.engaged[DEADLINE_POLICY_SKIP_DETECTION],
+           (unsigned long long)s.engaged[DEADLINE_POLICY_HOLD_COMMAND],
+           (unsigned long long)s.engaged[DEADLINE_POLICY_PREDICT],
+           (unsigned long long)s.detectionsSkipped, (unsigned long long)s.sendsHeld,
+           (unsigned long long)s.predictedTicks);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 1. Scripted camera pipeline
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const int FRAMES = 300;
+static const int BURST_FIRST = 100, BURST_LAST = 109;      // YOLO at 70 ms
+static const int GC_PAUSE = 200;                            // One 180 ms frame gap
+static const int SLOW_FIRST = 250, SLOW_LAST = 254;         // Camera at 80 ms
+
+static bool scripted() {
+    deadlineReset();
+    int skipFirst = -1, skipLast = -1, predictFirst = -1, predictLast = -1;
+    int detectRuns = 0, detectsInBurst = 0;
+    bool gcEngaged = false;
+
+    for (int f = 0; f < FRAMES; f++) {
+        int64_t interval = 33333;
+        if (f == GC_PAUSE) interval = 180000;
+        if (f >= SLOW_FIRST && f <= SLOW_LAST) interval = 80000;
+        deadlineRecord(DEADLINE_STAGE_CAPTURE, interval);
+        if (f == GC_PAUSE) gcEngaged = deadlinePolicyActive(DEADLINE_POLICY_PREDICT);
+
+        if (deadlineAdmit(DEADLINE_STAGE_DETECT)) {
+            deadlineRecord(DEADLINE_STAGE_PREPROCESS, 6000);
+            deadlineRecord(DEADLINE_STAGE_DETECT, (f >= BURST_FIRST && f <= BURST_LAST) ? 70000 : 30000);
+            deadlineRecord(DEADLINE_STAGE_TRACK, 400);
+            detectRuns++;
+            if (f >= BURST_FIRST && f <= BURST_LAST) detectsInBurst++;
+        }
+
+        bool skip = deadlinePolicyActive(DEADLINE_POLICY_SKIP_DETECTION);
+        if (skip && skipFirst < 0) skipFirst = f;
+        if (!skip && skipFirst >= 0 && skipLast < 0) skipLast = f;
+        bool predict = deadlinePolicyActive(DEADLINE_POLICY_PREDICT);
+        if (predict && predictFirst < 0) predictFirst = f;
+        if (!predict && predictFirst >= 0 && predictLast < 0) predictLast = f;
+    }
+
+    DeadlineStats s;
+    deadlineGetStats(&s);
+    DeadlineOverrun ring[DEADLINE_RING_SIZE];
+    int n = deadlineRecentOverruns(ring, DEADLINE_RING_SIZE);
+    bool ringOrdered = n == (int)s.overruns;
+    for (int i = 1; i < n; i++) ringOrdered = ringOrdered && ring[i].timeUs >= ring[i - 1].timeUs;
+
+    printf("Scripted pipeline: %d frames, YOLO 70 ms on %d-%d, GC pause at %d, camera 80 ms on %d-%d\n",
+           FRAMES, BURST_FIRST, BURST_LAST, GC_PAUSE, SLOW_FIRST, SLOW_LAST);
+    printStages(s);
+    printf("  skip detection frames %d-%d (%d of %d burst frames detected), predict frames %d-%d,"
+           " %d overruns in the ring\n",
+           skipFirst, skipLast, detectsInBurst, BURST_LAST - BURST_FIRST + 1, predictFirst, predictLast, n);
+
+    // 2nd slow detect engages; alternate frames detect while skipping; the first probe after the burst releases
+    bool ok = skipFirst == BURST_FIRST + 1 && skipLast > BURST_LAST && skipLast <= BURST_LAST + DEADLINE_SKIP_DETECTION_EVERY;
+    ok = ok && detectsInBurst <= 2 + (BURST_LAST - BURST_FIRST) / DEADLINE_SKIP_DETECTION_EVERY;
+    ok = ok && !gcEngaged && predictFirst == SLOW_FIRST + 2 && predictLast == SLOW_LAST + 1;
+    ok = ok && s.engaged[DEADLINE_POLICY_SKIP_DETECTION] == 1 && s.engaged[DEADLINE_POLICY_PREDICT] == 1;
+    ok = ok && s.activePolicies == 0 && ringOrdered && detectRuns + (int)s.detectionsSkipped == FRAMES;
+    return ok;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 2. Control thread
+// ═══════════════════════════════════════════════════════════════════════════
+
+static std::atomic<bool> stalling(false);
+static std::atomic<bool> stop(false);
+static std::atomic<uint64_t> sendCalls(0);
+static std::atomic<uint64_t> stallSendCalls(0);
+static int stallUs = 5000;
+
+static int stallingSend(const WsCanFrame*, int count) {
+    sendCalls.fetch_add(1, std::memory_order_relaxed);
+    if (stalling.load(std::memory_order_relaxed)) {
+        stallSendCalls.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_for(std::chrono::microseconds(stallUs));
+    }
+    return count;
+}
+
+// 30 fps target sweep; from slowAtUs the frames come at alternately 60 / 100 ms
+static void camera(int64_t startUs, int64_t slowAtUs, int64_t slowUntilUs) {
+    int64_t lastUs = monotonicUs();
+    int frame = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        int64_t t = monotonicUs() - startUs;
+        bool slow = t >= slowAtUs && t < slowUntilUs;
+        std::this_thread::sleep_for(std::chrono::microseconds(slow ? (frame % 2 ? 100000 : 60000) : 33333));
+        int64_t nowUs = monotonicUs();
+        deadlineRecord(DEADLINE_STAGE_CAPTURE, nowUs - lastUs);
+        lastUs = nowUs;
+        float e = 0.5f * (float)sin(2 * M_PI * 0.5 * (double)(nowUs - startUs) * 1e-6);
+        controlSetTrackingError(e, -e, 0);
+        frame++;
+    }
+}
+
+static bool controlRun(int stallMs) {
+    deadlineReset();
+    stallUs = stallMs * 1000;
+    submit(CORE_CMD_GUIDANCE_INIT);
+    submit(CORE_CMD_GUIDANCE_START);
+
+    int nodes[4] = {1, 2, 3, 4};
+    float rollGains[4] = {1, -1, 1, -1};
+    float pitchGains[4] = {1, 1, -1, -1};
+    controlSetLayout(nodes, rollGains, pitchGains, 4);
+    controlSetMode(CONTROL_MODE_TRACKING);
+
+    ControlThreadConfig config;
+    controlThreadDefaultConfig(&config);
+    config.niceValue = 0;
+    config.sendThresholdDeg = 0;            // Every tick with motion sends
+    if (!controlThreadStart(&config, stallingSend)) return false;
+
+    int64_t startUs = monotonicUs();
+    std::thread cam(camera, startUs, 1500000, 2200000);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    uint64_t callsBefore = sendCalls.load();
+    stalling.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    bool heldDuringStall = deadlinePolicyActive(DEADLINE_POLICY_HOLD_COMMAND);
+    stalling.store(false);
+    uint64_t callsStall = sendCalls.load() - callsBefore;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1300));
+    bool heldAfter = deadlinePolicyActive(DEADLINE_POLICY_HOLD_COMMAND);
+
+    stop.store(true);
+    cam.join();
+    controlThreadStop();
+    controlSetMode(CONTROL_MODE_HOLD);
+    submit(CORE_CMD_GUIDANCE_STOP);
+
+    DeadlineStats s;
+    deadlineGetStats(&s);
+    ControlThreadStats cs;
+    controlThreadGetStats(&cs);
+    printf("Control thread: 200 Hz tracking, sends stall %d ms for 600 ms, camera at 60 / 100 ms for 700 ms\n", stallMs);
+    printStages(s);
+    printf("  %llu ticks, %llu send calls in the 600 ms stall (%llu stalled), hold %s during the stall,"
+           " %s after\n",
+           (unsigned long long)cs.ticks, (unsigned long long)callsStall,
+           (unsigned long long)stallSendCalls.load(), heldDuringStall ? "on" : "off", heldAfter ? "on" : "off");
+
+    DeadlineOverrun last[4];
+    int n = deadlineRecentOverruns(last, 4);
+    for (int i = 0; i < n; i++) {
+        printf("  overrun %-10s %6lld us > %6lld us (%d in a row)\n", deadlineStageName(last[i].stage),
+               (long long)last[i].durationUs, (long long)last[i].budgetUs, last[i].consecutive);
+    }
+
+    // Unheld, every stalled tick would send: ~600 ms / (5 ms period + stall)
+    uint64_t unheld = 600000 / (uint64_t)(config.periodUs + stallUs);
+    return heldDuringStall && !heldAfter && s.sendsHeld > 0 && callsStall * 2 < unheld &&
+           s.engaged[DEADLINE_POLICY_PREDICT] >= 1 && s.predictedTicks > 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// 3. Cost
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void cost() {
+    deadlineReset();
+    const int calls = 2000000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) deadlineRecord(DEADLINE_STAGE_TRACK, i & 1023);
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    printf("deadlineRecord: %.1f ns per call (within budget)\n", (double)ns / calls);
+}
+
+int main(int argc, char** argv) {
+    int stallMs = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stall-ms") == 0 && i + 1 < argc) stallMs = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--stall-ms MS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (stallMs < 3) return 2;      // Must exceed the 2 ms send budget
+
+    submit(CORE_CMD_TELEM_INIT);
+    bool ok = scripted();
+    ok = controlRun(stallMs) && ok;
+    cost();
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+/**
+ * frame_arena_bench.cpp
+ * Per-Frame Scratch Benchmark (host)
+ *
+ * A vision frame's working set, sized by the detection count of the
+ * frame: rect copy, score table, pairwise IoU matrix (NMS), a coarse
+ * label grid (CCL) and a detection × track cost matrix (assignment).
+ * Counts vary frame to frame with occasional bursts. The same frame
+ * sequence runs with per-frame heap buffers (what new features would
+ * write by default) and with the frame arena; global operator new is
+ * counted, so the steady state of the arena must show zero heap calls.
+ *
+ *   frame_arena_bench [--frames N] [--burst MAX_DETECTIONS]
+ */
+
+#include "frame_arena.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+static std::atomic<uint64_t> heapCalls{0};
+
+void* operator new(size_t bytes) {
+    heapCalls.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(bytes ? bytes : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept {
+    heapCalls.fetch_add(1, std::memory_order_relaxed);
+    return malloc(bytes ? bytes : 1);
+}
+void* operator new[](size_t bytes, const std::nothrow_t& t) noexcept { return operator new(bytes, t); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+static const int GRID_W = 80;
+static const int GRID_H = 45;
+static const int TRACKS = 32;
+
+static uint32_t lcg(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Detections in frame f: mostly 5-40, a burst every 97 frames
+static int detectionsIn(int f, int burst, uint32_t* rng) {
+    if (f % 97 == 0) return burst;
+    return 5 + (int)(lcg(rng) % 36);
+}
+
+static float iou(const int* a, const int* b) {
+    int x0 = std::max(a[0] - a[2] / 2, b[0] - b[2] / 2);
+    int y0 = std::max(a[1] - a[3] / 2, b[1] - b[3] / 2);
+    int x1 = std::min(a[0] + a[2] / 2, b[0] + b[2] / 2);
+    int y1 = std::min(a[1] + a[3] / 2, b[1] + b[3] / 2);
+    if (x1 <= x0 || y1 <= y0) return 0.0f;
+    float inter = (float)(x1 - x0) * (float)(y1 - y0);
+    return inter / ((float)(a[2] * a[3] + b[2] * b[3]) - inter);
+}
+
+// The frame's work on caller-provided buffers. Returns a checksum
+static double frameWork(int n, uint32_t seed, int* rects, float* scores, float* overlap,
+                        int* labels, float* cost) {
+    uint32_t rng = seed;
+    for (int i = 0; i < n; i++) {
+        rects[i * 4 + 0] = (int)(lcg(&rng) % 1280);
+        rects[i * 4 + 1] = (int)(lcg(&rng) % 720);
+        rects[i * 4 + 2] = 20 + (int)(lcg(&rng) % 120);
+        rects[i * 4 + 3] = 20 + (int)(lcg(&rng) % 120);
+        scores[i] = (float)(lcg(&rng) % 1000) / 1000.0f;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) overlap[i * n + j] = iou(&rects[i * 4], &rects[j * 4]);
+    }
+    memset(labels, 0, sizeof(int) * GRID_W * GRID_H);
+    for (int i = 0; i < n; i++) {
+        int gx = rects[i * 4] * GRID_W / 1280, gy = rects[i * 4 + 1] * GRID_H / 720;
+        labels[gy * GRID_W + gx] = i + 1;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int t = 0; t < TRACKS; t++) {
+            int dx = rects[i * 4] - t * 40, dy = rects[i * 4 + 1] - t * 22;
+            cost[i * TRACKS + t] = (float)(dx * dx + dy * dy) * (1.0f - scores[i]);
+        }
+    }
+    double sum = 0;
+    for (int i = 0; i < n * n; i += n + 1) sum += overlap[i];
+    for (int i = 0; i < n * TRACKS; i += 7) sum += cost[i] * 1e-6;
+    return sum + labels[0];
+}
+
+static double heapFrame(int n, uint32_t seed) {
+    std::vector<int> rects(n * 4);
+    std::vector<float> scores(n);
+    std::vector<float> overlap((size_t)n * n);
+    std::vector<int> labels(GRID_W * GRID_H);
+    std::vector<float> cost((size_t)n * TRACKS);
+    return frameWork(n, seed, rects.data(), scores.data(), overlap.data(), labels.data(), cost.data());
+}
+
+static double arenaFrame(FrameArena* arena, int n, uint32_t seed) {
+    FrameArenaFrame frame(arena);
+    int* rects = frameArenaArray<int>(arena, n * 4);
+    float* scores = frameArenaArray<float>(arena, n);
+    float* overlap = frameArenaArray<float>(arena, (size_t)n * n);
+    int* labels = frameArenaArray<int>(arena, GRID_W * GRID_H);
+    float* cost = frameArenaArray<float>(arena, (size_t)n * TRACKS);
+    return frameWork(n, seed, rects, scores, overlap, labels, cost);
+}
+
+struct Run {
+    std::vector<int64_t> ns;
+    uint64_t heapCalls = 0;         // Measured frames only
+    double checksum = 0;
+};
+
+template <typename Fn>
+static Run run(int frames, int warmup, int burst, Fn fn) {
+    Run r;
+    r.ns.reserve(frames);
+    uint32_t rng = 12345;
+    uint64_t heapBefore = 0;
+    for (int f = 0; f < warmup + frames; f++) {
+        int n = detectionsIn(f, burst, &rng);
+        if (f == warmup) heapBefore = heapCalls.load();
+        auto t0 = std::chrono::steady_clock::now();
+        double c = fn(n, (uint32_t)f * 2654435761u);
+        if (f >= warmup) {
+            r.ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count());
+            r.checksum += c;
+        }
+    }
+    r.heapCalls = heapCalls.load() - heapBefore;
+    return r;
+}
+
+static void report(const char* name, Run& r, int frames) {
+    std::sort(r.ns.begin(), r.ns.end());
+    int64_t sum = 0;
+    for (int64_t v : r.ns) sum += v;
+    printf("%-6s | %7lld ns mean, p99 %7lld ns, max %8lld ns | heap calls %8llu (%.2f / frame)\n", name,
+           (long long)(sum / (int64_t)r.ns.size()), (long long)r.ns[(size_t)(0.99 * (double)(r.ns.size() - 1))],
+           (long long)r.ns.back(), (unsigned long long)r.heapCalls, (double)r.heapCalls / frames);
+}
+
+int main(int argc, char** argv) {
+    int frames = 20000;
+    int burst = 400;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) burst = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--frames N] [--burst MAX_DETECTIONS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 100 || burst < 1) return 2;
+    // Warm-up includes a burst frame (every 97th) so the arena has seen the largest frame
+    const int warmup = 100;
+
+    Run heap = run(frames, warmup, burst, heapFrame);
+
+    FrameArena arena;
+    if (!frameArenaInit(&arena, "bench", 16 * 1024)) return 1;
+    Run arenaRun = run(frames, warmup, burst, [&](int n, uint32_t seed) { return arenaFrame(&arena, n, seed); });
+    FrameArenaStats s;
+    frameArenaGetStats(&arena, &s);
+
+    printf("Frames: %d (+%d warm-up), 5-40 detections, burst of %d every 97 frames\n", frames, warmup, burst);
+    report("heap", heap, frames);
+    report("arena", arenaRun, frames);
+    printf("Arena: high water %llu B, block %llu B, %llu spills, %llu grows over %llu frames\n",
+           (unsigned long long)s.highWater, (unsigned long long)s.capacity, (unsigned long long)s.spills,
+           (unsigned long long)s.grows, (unsigned long long)s.frames);
+
+    bool ok = arenaRun.heapCalls == 0 && heap.checksum == arenaRun.checksum;
+    frameArenaDestroy(&arena);
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,431 @@
+/**
+ * hal_stub.c
+ * Minimal STM32L4 HAL for running firmware sources on the host
+ *
+ * One CAN (3 TX mailboxes sent in request order, 3-deep RX FIFO 0), up to
+ * four UARTs with DMA TX / ReceiveToIdle RX, the flash mapped at FLASH_BASE,
+ * GPIO output latches, a DWT cycle counter on the stub clock, and a
+ * PRIMASK-style interrupt mask with pending flags per interrupt.
+ */
+
+#define _GNU_SOURCE
+#include "hal_stub.h"
+
+#include <string.h>
+#include <sys/mman.h>
+
+#define UART_MAX 4
+
+typedef struct {
+    UART_HandleTypeDef* huart;
+    HalStubUart state;
+    uint8_t txDonePending;
+    uint8_t rxEventPending;
+    uint16_t rxEventSize;
+} UartSlot;
+
+typedef struct {
+    uint8_t used;
+    uint32_t order;
+    HalStubCanFrame frame;
+} Mailbox;
+
+static HalStubHook hook = NULL;
+static uint64_t timeUs = 0;
+static uint8_t irqMasked = 0;
+static uint64_t maskedSinceUs = 0;
+static int isrDepth = 0;
+static HalStubStats stats;
+
+DWT_Type HalStub_Dwt;
+uint32_t SystemCoreClock = 80000000u;
+GPIO_TypeDef HalStub_GpioA;
+GPIO_TypeDef HalStub_GpioB;
+
+static CAN_HandleTypeDef* canHandle = NULL;
+static Mailbox mailboxes[HAL_STUB_CAN_MAILBOXES];
+static uint32_t mailboxOrder = 0;
+static uint8_t txCompletePending = 0;    // CAN_TX_MAILBOXn bits
+static HalStubCanFrame rxFifo[HAL_STUB_CAN_RX_FIFO];
+static int rxFifoHead = 0;
+static int rxFifoCount = 0;
+
+static UartSlot uarts[UART_MAX];
+
+static uint8_t* flash = NULL;
+static uint8_t flashUnlocked = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Interrupts
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void RunPending(void) {
+    if (irqMasked || isrDepth > 0) return;
+
+    isrDepth++;
+    for (int progress = 1; progress;) {
+        progress = 0;
+
+        if (rxFifoCount > 0 && canHandle != NULL) {
+            int before = rxFifoCount;
+            HAL_CAN_RxFifo0MsgPendingCallback(canHandle);
+            progress |= rxFifoCount != before;
+        }
+
+        for (int m = 0; m < HAL_STUB_CAN_MAILBOXES; m++) {
+            uint8_t bit = (uint8_t)(1u << m);
+            if (!(txCompletePending & bit)) continue;
+            txCompletePending &= (uint8_t)~bit;
+            if (m == 0) HAL_CAN_TxMailbox0CompleteCallback(canHandle);
+            else if (m == 1) HAL_CAN_TxMailbox1CompleteCallback(canHandle);
+            else HAL_CAN_TxMailbox2CompleteCallback(canHandle);
+            progress = 1;
+        }
+
+        for (int i = 0; i < UART_MAX; i++) {
+            UartSlot* u = &uarts[i];
+            if (u->txDonePending) {
+                u->txDonePending = 0;
+                u->huart->gState = HAL_UART_STATE_READY;
+                HAL_UART_TxCpltCallback(u->huart);
+                progress = 1;
+            }
+            if (u->rxEventPending) {
+                u->rxEventPending = 0;
+                u->huart->RxState = HAL_UART_STATE_READY;
+                HAL_UARTEx_RxEventCallback(u->huart, u->rxEventSize);
+                progress = 1;
+            }
+        }
+    }
+    isrDepth--;
+}
+
+// Every HAL entry point: the simulation may advance time / raise events
+static void Preempt(void) {
+    if (hook != NULL) hook();
+    RunPending();
+}
+
+void __disable_irq(void) {
+    if (!irqMasked) {
+        irqMasked = 1;
+        maskedSinceUs = timeUs;
+        stats.irqMasks++;
+    }
+}
+
+void __enable_irq(void) {
+    if (irqMasked) {
+        irqMasked = 0;
+        if (timeUs - maskedSinceUs > stats.irqMaskedMaxUs) stats.irqMaskedMaxUs = timeUs - maskedSinceUs;
+    }
+    RunPending();
+}
+
+uint32_t __get_PRIMASK(void) { return irqMasked; }
+
+void __set_PRIMASK(uint32_t priMask) {
+    if (priMask & 1) __disable_irq();
+    else __enable_irq();
+}
+
+uint32_t HAL_GetTick(void) {
+    Preempt();
+    return (uint32_t)(timeUs / 1000);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GPIO
+// ═══════════════════════════════════════════════════════════════════════════
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    Preempt();
+    if (PinState != GPIO_PIN_RESET) GPIOx->ODR |= GPIO_Pin;
+    else GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    stats.gpioWrites++;
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    Preempt();
+    GPIOx->ODR ^= GPIO_Pin;
+    stats.gpioWrites++;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Weak Callbacks (as in the HAL)
+// ═══════════════════════════════════════════════════════════════════════════
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { (void)huart; }
+__weak void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) { (void)huart; }
+__weak void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size) { (void)huart; (void)Size; }
+__weak void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef* hcan) { (void)hcan; }
+__weak void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef* hcan) { (void)hcan; }
+__weak void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef* hcan) { (void)hcan; }
+__weak void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef* hcan) { (void)hcan; }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UART / DMA
+// ═══════════════════════════════════════════════════════════════════════════
+
+static UartSlot* Uart(const UART_HandleTypeDef* huart) {
+    for (int i = 0; i < UART_MAX; i++) {
+        if (uarts[i].huart == huart) return &uarts[i];
+    }
+    for (int i = 0; i < UART_MAX; i++) {
+        if (uarts[i].huart == NULL) {
+            uarts[i].huart = (UART_HandleTypeDef*)huart;
+            return &uarts[i];
+        }
+    }
+    return NULL;
+}
+
+void HalStub_UartInit(UART_HandleTypeDef* huart) {
+    Uart(huart);
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+}
+
+static HAL_StatusTypeDef Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    Preempt();
+    UartSlot* u = Uart(huart);
+    if (u == NULL || Size == 0 || Size > HAL_STUB_UART_TX_MAX) return HAL_ERROR;
+    if (huart->gState != HAL_UART_STATE_READY) {
+        stats.uartTxBusy++;
+        return HAL_BUSY;
+    }
+    memcpy(u->state.tx, pData, Size);
+    u->state.txLen = Size;
+    u->state.txStarts++;
+    u->state.txStartUs = timeUs;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    return Transmit(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size) {
+    return Transmit(huart, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size) {
+    Preempt();
+    UartSlot* u = Uart(huart);
+    if (u == NULL || Size == 0) return HAL_ERROR;
+    if (huart->RxState != HAL_UART_STATE_READY) return HAL_BUSY;
+    u->state.rxBuf = pData;
+    u->state.rxSize = Size;
+    u->state.rxArms++;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+void HalStub_UartTxDone(UART_HandleTypeDef* huart) {
+    UartSlot* u = Uart(huart);
+    if (u == NULL || huart->gState != HAL_UART_STATE_BUSY_TX) return;
+    u->txDonePending = 1;
+    RunPending();
+}
+
+uint16_t HalStub_UartIdle(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len) {
+    UartSlot* u = Uart(huart);
+    if (u == NULL) return 0;
+    if (u->state.rxBuf == NULL) {
+        stats.uartRxLost += len;
+        return 0;
+    }
+
+    uint16_t n = len < u->state.rxSize ? len : u->state.rxSize;
+    memcpy(u->state.rxBuf, data, n);
+    stats.uartRxLost += len - n;
+    u->state.rxBuf = NULL;
+    u->rxEventPending = 1;
+    u->rxEventSize = n;
+    RunPending();
+    return n;
+}
+
+const HalStubUart* HalStub_Uart(const UART_HandleTypeDef* huart) {
+    UartSlot* u = Uart(huart);
+    return u != NULL ? &u->state : NULL;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CAN
+// ═══════════════════════════════════════════════════════════════════════════
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, const CAN_TxHeaderTypeDef* pHeader,
+                                       const uint8_t aData[], uint32_t* pTxMailbox) {
+    Preempt();
+    canHandle = hcan;
+    for (int m = 0; m < HAL_STUB_CAN_MAILBOXES; m++) {
+        if (mailboxes[m].used) continue;
+        mailboxes[m].used = 1;
+        mailboxes[m].order = mailboxOrder++;
+        mailboxes[m].frame.stdId = pHeader->StdId;
+        mailboxes[m].frame.dlc = (uint8_t)(pHeader->DLC > 8 ? 8 : pHeader->DLC);
+        memcpy(mailboxes[m].frame.data, aData, mailboxes[m].frame.dlc);
+        *pTxMailbox = 1u << m;
+        return HAL_OK;
+    }
+    stats.canTxRejected++;
+    return HAL_ERROR;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef* hcan) {
+    (void)hcan;
+    Preempt();
+    return (uint32_t)(HAL_STUB_CAN_MAILBOXES - HalStub_CanTxPending());
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef* pHeader, uint8_t aData[]) {
+    (void)hcan;
+    Preempt();
+    if (RxFifo != CAN_RX_FIFO0 || rxFifoCount == 0) return HAL_ERROR;
+
+    const HalStubCanFrame* f = &rxFifo[rxFifoHead];
+    memset(pHeader, 0, sizeof(*pHeader));
+    pHeader->StdId = f->stdId;
+    pHeader->IDE = CAN_ID_STD;
+    pHeader->RTR = CAN_RTR_DATA;
+    pHeader->DLC = f->dlc;
+    memcpy(aData, f->data, f->dlc);
+    rxFifoHead = (rxFifoHead + 1) % HAL_STUB_CAN_RX_FIFO;
+    rxFifoCount--;
+    return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef* hcan, uint32_t RxFifo) {
+    (void)hcan;
+    Preempt();
+    return RxFifo == CAN_RX_FIFO0 ? (uint32_t)rxFifoCount : 0;
+}
+
+int HalStub_CanReceive(CAN_HandleTypeDef* hcan, uint32_t stdId, const uint8_t* data, uint8_t dlc) {
+    canHandle = hcan;
+    if (rxFifoCount == HAL_STUB_CAN_RX_FIFO) {
+        stats.canRxOverruns++;
+        return 0;
+    }
+    HalStubCanFrame* f = &rxFifo[(rxFifoHead + rxFifoCount) % HAL_STUB_CAN_RX_FIFO];
+    f->stdId = stdId;
+    f->dlc = dlc > 8 ? 8 : dlc;
+    memcpy(f->data, data, f->dlc);
+    rxFifoCount++;
+    RunPending();
+    return 1;
+}
+
+int HalStub_CanTxComplete(CAN_HandleTypeDef* hcan, HalStubCanFrame* out) {
+    canHandle = hcan;
+    int oldest = -1;
+    for (int m = 0; m < HAL_STUB_CAN_MAILBOXES; m++) {
+        if (mailboxes[m].used && (oldest < 0 || mailboxes[m].order < mailboxes[oldest].order)) oldest = m;
+    }
+    if (oldest < 0) return 0;
+
+    if (out != NULL) *out = mailboxes[oldest].frame;
+    mailboxes[oldest].used = 0;
+    txCompletePending |= (uint8_t)(1u << oldest);
+    RunPending();
+    return 1;
+}
+
+int HalStub_CanTxPending(void) {
+    int n = 0;
+    for (int m = 0; m < HAL_STUB_CAN_MAILBOXES; m++) n += mailboxes[m].used;
+    return n;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Flash
+// ═══════════════════════════════════════════════════════════════════════════
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    Preempt();
+    flashUnlocked = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    Preempt();
+    flashUnlocked = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data) {
+    Preempt();
+    if (!flashUnlocked || TypeProgram != FLASH_TYPEPROGRAM_DOUBLEWORD || (Address & 7) ||
+        Address < FLASH_BASE || Address + 8 > FLASH_BASE + FLASH_SIZE) {
+        return HAL_ERROR;
+    }
+
+    // Double words are written once per erase
+    uint8_t* dst = flash + (Address - FLASH_BASE);
+    for (int i = 0; i < 8; i++) {
+        if (dst[i] != 0xFF) return HAL_ERROR;
+    }
+    memcpy(dst, &Data, 8);
+    stats.flashWrites++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError) {
+    Preempt();
+    *PageError = 0xFFFFFFFFu;
+    if (!flashUnlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES ||
+        (pEraseInit->Page + pEraseInit->NbPages) * FLASH_PAGE_SIZE > FLASH_SIZE) {
+        return HAL_ERROR;
+    }
+    memset(flash + pEraseInit->Page * FLASH_PAGE_SIZE, 0xFF, pEraseInit->NbPages * FLASH_PAGE_SIZE);
+    stats.flashErases++;
+    return HAL_OK;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Control
+// ═══════════════════════════════════════════════════════════════════════════
+
+int HalStub_Reset(void) {
+    // Firmware reads its flash records straight from FLASH_BASE + offset
+    if (flash == NULL) {
+        void* p = mmap((void*)FLASH_BASE, FLASH_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if (p != (void*)FLASH_BASE) {
+            if (p != MAP_FAILED) munmap(p, FLASH_SIZE);
+            return 0;
+        }
+        flash = (uint8_t*)p;
+    }
+    memset(flash, 0xFF, FLASH_SIZE);
+    flashUnlocked = 0;
+
+    hook = NULL;
+    HalStub_SetTimeUs(0);
+    HalStub_GpioA.ODR = 0;
+    HalStub_GpioB.ODR = 0;
+    irqMasked = 0;
+    isrDepth = 0;
+    memset(&stats, 0, sizeof(stats));
+    memset(mailboxes, 0, sizeof(mailboxes));
+    mailboxOrder = 0;
+    txCompletePending = 0;
+    rxFifoHead = 0;
+    rxFifoCount = 0;
+    memset(uarts, 0, sizeof(uarts));
+    return 1;
+}
+
+void HalStub_SetHook(HalStubHook h) { hook = h; }
+void HalStub_SetTimeUs(uint64_t us) {
+    timeUs = us;
+    HalStub_Dwt.CYCCNT = (uint32_t)(us * (SystemCoreClock / 1000000u));
+}
+
+uint64_t HalStub_TimeUs(void) { return timeUs; }
+int HalStub_IrqMasked(void) { return irqMasked; }
+const HalStubStats* HalStub_Stats(void) { return &stats; }
@@ -0,0 +1,114 @@
+/**
+ * hal_stub.h
+ * Host side of the HAL stub (stm32l4xx_hal.h): time, interrupts, peripherals
+ *
+ * The simulation owns the clock and the peripherals' far side; the firmware
+ * runs unchanged on top. The HalStub_* event calls act like the hardware:
+ * the peripheral state changes at once and the interrupt goes pending. A
+ * pending interrupt runs as soon as interrupts are allowed: immediately,
+ * at __enable_irq, or when the running ISR returns.
+ *
+ * Every HAL call the firmware makes first calls the hook, so the simulation
+ * can advance its clock and raise events in the middle of a main loop pass
+ * (or of a masked section), not only between passes.
+ */
+
+#ifndef HAL_STUB_H
+#define HAL_STUB_H
+
+#include "stm32l4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_STUB_CAN_MAILBOXES 3
+#define HAL_STUB_CAN_RX_FIFO 3
+#define HAL_STUB_UART_TX_MAX 16
+
+typedef struct {
+    uint32_t stdId;
+    uint8_t dlc;
+    uint8_t data[8];
+} HalStubCanFrame;
+
+typedef struct {
+    // Last transmit started by the firmware (DMA or IT)
+    uint8_t tx[HAL_STUB_UART_TX_MAX];
+    uint16_t txLen;
+    uint32_t txStarts;
+    uint64_t txStartUs;
+    // ReceiveToIdle buffer, NULL while reception is not armed
+    uint8_t* rxBuf;
+    uint16_t rxSize;
+    uint32_t rxArms;
+} HalStubUart;
+
+typedef struct {
+    uint32_t canRxOverruns;     // Frames lost to a full RX FIFO
+    uint32_t canTxRejected;     // HAL_CAN_AddTxMessage with no free mailbox
+    uint32_t uartRxLost;        // Bytes that arrived with reception not armed
+    uint32_t uartTxBusy;        // Transmit started while the UART was busy
+    uint32_t irqMasks;          // __disable_irq calls
+    uint64_t irqMaskedMaxUs;    // Longest masked section
+    uint32_t flashErases;
+    uint32_t flashWrites;
+    uint32_t gpioWrites;
+} HalStubStats;
+
+// Called at the start of every HAL call made by the firmware (not the CMSIS
+// intrinsics)
+typedef void (*HalStubHook)(void);
+
+/**
+ * Empty FIFO / mailboxes / UARTs, outputs low, erased flash, clock at 0
+ * @return 0 if the flash could not be mapped at FLASH_BASE
+ */
+int HalStub_Reset(void);
+
+// MX_USARTx_UART_Init: TX and RX ready
+void HalStub_UartInit(UART_HandleTypeDef* huart);
+
+void HalStub_SetHook(HalStubHook hook);
+void HalStub_SetTimeUs(uint64_t us);
+uint64_t HalStub_TimeUs(void);
+int HalStub_IrqMasked(void);
+const HalStubStats* HalStub_Stats(void);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Interrupts (run the firmware callback as the ISR)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Frame received into FIFO 0. HAL_CAN_RxFifo0MsgPendingCallback then runs
+ * for as long as it keeps taking frames
+ * @return 0 on FIFO overrun (frame lost)
+ */
+int HalStub_CanReceive(CAN_HandleTypeDef* hcan, uint32_t stdId, const uint8_t* data, uint8_t dlc);
+
+/**
+ * Oldest pending mailbox went out on the bus: frees it, then its
+ * TxMailboxNCompleteCallback
+ * @return 0 if no mailbox was pending
+ */
+int HalStub_CanTxComplete(CAN_HandleTypeDef* hcan, HalStubCanFrame* out);
+
+int HalStub_CanTxPending(void);
+
+// Transmit finished: UART ready again, HAL_UART_TxCpltCallback
+void HalStub_UartTxDone(UART_HandleTypeDef* huart);
+
+/**
+ * Bytes followed by an idle line: copied into the armed buffer and
+ * ReceiveToIdle disarmed (as on the chip), then HAL_UARTEx_RxEventCallback
+ * @return bytes delivered (0 if reception was not armed)
+ */
+uint16_t HalStub_UartIdle(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t len);
+
+const HalStubUart* HalStub_Uart(const UART_HandleTypeDef* huart);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_STUB_H
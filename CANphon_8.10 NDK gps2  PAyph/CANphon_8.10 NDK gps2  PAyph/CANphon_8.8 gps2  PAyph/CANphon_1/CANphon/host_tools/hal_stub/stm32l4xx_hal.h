@@ -0,0 +1,190 @@
+/**
+ * stm32l4xx_hal.h
+ * Minimal STM32L4 HAL for running firmware sources on the host
+ *
+ * Shadows the ST header that the firmware's main.h includes. Only the types,
+ * constants and calls the simulated firmware modules use are declared; the
+ * behavior lives in hal_stub.c and is driven through hal_stub.h.
+ */
+
+#ifndef STM32L4XX_HAL_H
+#define STM32L4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __weak __attribute__((weak))
+
+typedef enum {
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03
+} HAL_StatusTypeDef;
+
+typedef enum {
+    DISABLE = 0,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+uint32_t HAL_GetTick(void);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Core (CMSIS)
+// ═══════════════════════════════════════════════════════════════════════════
+
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+#define __DMB() __sync_synchronize()
+
+// Cycle counter, follows the stub clock at SystemCoreClock
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type HalStub_Dwt;
+extern uint32_t SystemCoreClock;
+#define DWT (&HalStub_Dwt)
+
+// ═══════════════════════════════════════════════════════════════════════════
+// GPIO (output latch only)
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+
+extern GPIO_TypeDef HalStub_GpioA;
+extern GPIO_TypeDef HalStub_GpioB;
+#define GPIOA (&HalStub_GpioA)
+#define GPIOB (&HalStub_GpioB)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// UART / DMA
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef uint32_t HAL_UART_StateTypeDef;
+#define HAL_UART_STATE_RESET 0x00U
+#define HAL_UART_STATE_READY 0x20U
+#define HAL_UART_STATE_BUSY_TX 0x21U
+#define HAL_UART_STATE_BUSY_RX 0x22U
+
+typedef struct __UART_HandleTypeDef {
+    volatile HAL_UART_StateTypeDef gState;   // TX side
+    volatile HAL_UART_StateTypeDef RxState;
+} UART_HandleTypeDef;
+
+typedef struct {
+    uint32_t disabledIt;    // DMA_IT_* bits cleared with __HAL_DMA_DISABLE_IT
+} DMA_HandleTypeDef;
+
+#define DMA_IT_TC 0x02U
+#define DMA_IT_HT 0x04U
+#define DMA_IT_TE 0x08U
+#define __HAL_DMA_DISABLE_IT(h, it) ((h)->disabledIt |= (it))
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CAN
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t txMailboxes;   // Only the stub looks at these
+} CAN_HandleTypeDef;
+
+typedef struct {
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t TransmitGlobalTime;
+} CAN_TxHeaderTypeDef;
+
+typedef struct {
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t Timestamp;
+    uint32_t FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+#define CAN_ID_STD 0x00U
+#define CAN_ID_EXT 0x04U
+#define CAN_RTR_DATA 0x00U
+#define CAN_RTR_REMOTE 0x02U
+#define CAN_RX_FIFO0 0x00U
+#define CAN_TX_MAILBOX0 0x01U
+#define CAN_TX_MAILBOX1 0x02U
+#define CAN_TX_MAILBOX2 0x04U
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, const CAN_TxHeaderTypeDef* pHeader,
+                                       const uint8_t aData[], uint32_t* pTxMailbox);
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef* pHeader, uint8_t aData[]);
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef* hcan, uint32_t RxFifo);
+
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef* hcan);
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef* hcan);
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Flash (L431CC: 256 KB, 2 KB pages)
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define FLASH_BASE 0x08000000UL
+#define FLASH_SIZE 0x40000UL
+#define FLASH_PAGE_SIZE 0x800UL
+#define FLASH_BANK_1 0x01U
+#define FLASH_TYPEERASE_PAGES 0x00U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x00U
+#define FLASH_FLAG_ALL_ERRORS 0xFFFFU
+#define __HAL_FLASH_CLEAR_FLAG(flag) ((void)(flag))
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Page;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32L4XX_HAL_H
@@ -0,0 +1,311 @@
+/**
+ * l431_burst_sim.cpp
+ * L431 Command Burst Simulation (host)
+ *
+ * Runs the PUI firmware's protocol unit (L431 PUI/Core/Src/pui_protocol.c)
+ * unchanged on the HAL stub (hal_stub/) and feeds it bursts of
+ * back-to-back sequenced requests on a 500 kbit/s bus. The RX interrupt
+ * queues each frame (CMD_QUEUE_SIZE), the main loop (L431_ProcessQueue,
+ * every --loop us) applies it and queues the reply (TX_QUEUE_SIZE), and
+ * the TX-complete interrupt refills the mailboxes through L431_PumpTx.
+ * Each HAL call costs --hal us and is a point where pending interrupts
+ * run, so both interrupts preempt the main loop, and the TX-complete one
+ * is held off while PumpTx has interrupts masked.
+ *
+ * Requests (0x100) win arbitration over replies (0x101), so replies pile
+ * up in the mailboxes for the whole burst. Frame times include average
+ * bit stuffing.
+ *
+ * Reports per burst size: reply loss and where it happened, request →
+ * reply latency on the bus, the firmware's own RX → applied maximum
+ * (puiStats) and the longest masked section. Checks that every reply is
+ * an answer to an outstanding request, in request order, with the right
+ * counts and rails, and that bursts that fit the command queue lose
+ * nothing.
+ *
+ *   l431_burst_sim [--bursts N] [--period US] [--loop US] [--hal US]
+ *                  [--sizes 1,4,8,...]
+ */
+
+extern "C" {
+#include "hal_stub.h"
+#include "pui_protocol.h"
+}
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+static const double CAN_BIT_US = 2.0;    // 500 kbit/s
+static const int REPLY_DLC = 8;          // Status replies only (no legacy frames sent)
+
+// Standard data frame: 47 fixed bits + data, stuffing on the 34 + 8n stuffable bits
+static double frameUs(int dlc) {
+    int stuffable = 34 + 8 * dlc;
+    return (47 + 8 * dlc + stuffable / 5 + 3) * CAN_BIT_US;
+}
+
+static double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Board (main.c globals)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" {
+CAN_HandleTypeDef hcan1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Surroundings
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Request {
+    double atUs;        // Queued in the adapter
+    uint8_t seq;
+    uint8_t dlc;
+    uint8_t data[8];
+    uint8_t status;     // Expected [executed | rejected << 4]
+    uint8_t rails;      // Expected rails after the request
+};
+
+struct RunStats {
+    long requests = 0;
+    long replies = 0;
+    long lost = 0;            // Requests never answered
+    long unexpected = 0;      // Unknown, duplicate or out-of-order replies
+    long wrongStatus = 0;     // Counts / rails differ from the commands sent
+    std::vector<double> replyUs;
+};
+
+static double nowUs = 0;
+static double halCallUs = 0.5;
+static bool inHook = false;
+
+static std::deque<Request> adapter;     // Phone side TX queue (0x100)
+static std::deque<Request> outstanding; // Sent, not answered, in request order
+static bool busBusy = false;
+static bool busReply = false;
+static double busEndUs = 0;
+static double lastServiceUs = 0;
+static RunStats* stats = nullptr;
+
+static uint32_t seed = 12345;
+
+static uint32_t nextRandom() {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+// Reply left the mailbox
+static void replySent(const HalStubCanFrame& f) {
+    if (f.stdId != L431_TX_CAN_ID || f.dlc != REPLY_DLC || f.data[0] != REPLY_STATUS) {
+        stats->unexpected++;
+        return;
+    }
+
+    // Replies come in request order; requests skipped over were lost
+    uint8_t seq = f.data[1];
+    auto it = std::find_if(outstanding.begin(), outstanding.end(),
+                           [seq](const Request& r) { return r.seq == seq; });
+    if (it == outstanding.end()) {
+        stats->unexpected++;
+        return;
+    }
+    stats->lost += it - outstanding.begin();
+    outstanding.erase(outstanding.begin(), it);
+
+    const Request& r = outstanding.front();
+    if (f.data[2] != r.status || f.data[3] != r.rails) stats->wrongStatus++;
+    stats->replies++;
+    stats->replyUs.push_back(busEndUs - r.atUs);
+    outstanding.pop_front();
+}
+
+// Bus up to nowUs: the frame on the wire ends, the next one wins arbitration
+static void service() {
+    HalStub_SetTimeUs((uint64_t)nowUs);
+
+    while (true) {
+        if (busBusy) {
+            if (busEndUs > nowUs) break;
+            busBusy = false;
+            if (busReply) {
+                HalStubCanFrame f;
+                if (HalStub_CanTxComplete(&hcan1, &f)) replySent(f);
+            } else {
+                Request r = adapter.front();
+                adapter.pop_front();
+                outstanding.push_back(r);
+                HalStub_CanReceive(&hcan1, L431_RX_CAN_ID, r.data, r.dlc);
+            }
+            continue;
+        }
+
+        // A reply queued since the last look was ready no later than then
+        bool phone = !adapter.empty() && adapter.front().atUs <= nowUs;
+        bool reply = HalStub_CanTxPending() > 0;
+        if (!phone && !reply) break;
+        double phoneStart = phone ? std::max(busEndUs, adapter.front().atUs) : 1e300;
+        double replyStart = reply ? std::max(busEndUs, lastServiceUs) : 1e300;
+
+        // Lower ID wins when both are waiting at the start of the frame
+        busBusy = true;
+        busReply = replyStart < phoneStart;
+        busEndUs = busReply ? replyStart + frameUs(REPLY_DLC) : phoneStart + frameUs(adapter.front().dlc);
+    }
+    lastServiceUs = nowUs;
+}
+
+// Every HAL call from the firmware: time passes, interrupts may fire
+static void onHalCall() {
+    if (inHook) return;
+    inHook = true;
+    nowUs += halCallUs;
+    service();
+    inHook = false;
+}
+
+// One pass of main.c's while (1)
+static void mainLoopPass(double loopUs) {
+    L431_ProcessQueue();
+
+    nowUs += loopUs;
+    inHook = true;
+    service();
+    inHook = false;
+}
+
+// Random 1..4 commands, now and then an unknown byte; expected reply alongside
+static void queueRequest(uint8_t seq, uint8_t* rails) {
+    static const uint8_t commands[] = {CMD_POWER_ON, CMD_POWER_OFF, CMD_HEARTBEAT, CMD_STATUS, 0x7E};
+    Request r = {};
+    r.atUs = nowUs;
+    r.seq = seq;
+
+    int count = 1 + (int)(nextRandom() % 4);
+    int executed = 0;
+    int rejected = 0;
+    r.data[0] = (uint8_t)(REQ_FLAG_V2 | count);
+    r.data[1] = seq;
+    for (int i = 0; i < count; i++) {
+        uint8_t cmd = commands[nextRandom() % 16 == 0 ? 4 : nextRandom() % 4];
+        r.data[2 + i] = cmd;
+        switch (cmd) {
+        case CMD_POWER_ON: *rails = (uint8_t)((*rails & RAIL_PB6) | RAIL_PA9 | RAIL_PA10); break;
+        case CMD_POWER_OFF: *rails = (uint8_t)((*rails & RAIL_PB6) | RAIL_PA5); break;
+        case CMD_HEARTBEAT: *rails ^= RAIL_PB6; break;
+        case CMD_STATUS: break;
+        default: rejected++; continue;
+        }
+        executed++;
+    }
+    r.dlc = (uint8_t)(2 + count);
+    r.status = (uint8_t)(executed | (rejected << 4));
+    r.rails = *rails;
+    adapter.push_back(r);
+}
+
+static bool run(int burst, int bursts, double periodUs, double loopUs, RunStats* out) {
+    if (!HalStub_Reset()) return false;
+    HalStub_SetHook(onHalCall);
+    nowUs = 0;
+    inHook = false;
+    adapter.clear();
+    outstanding.clear();
+    busBusy = false;
+    busEndUs = 0;
+    lastServiceUs = 0;
+    stats = out;
+    seed = 12345;
+    memset((void*)&puiStats, 0, sizeof(puiStats));
+
+    uint8_t seq = 0;
+    uint8_t rails = 0;
+    for (int b = 0; b < bursts; b++) {
+        double end = (b + 1) * periodUs;
+        for (int i = 0; i < burst; i++) queueRequest(seq++, &rails);
+        out->requests += burst;
+        while (nowUs < end) mainLoopPass(loopUs);
+    }
+
+    // Last replies, then whatever never came
+    double end = nowUs + periodUs;
+    while (nowUs < end) mainLoopPass(loopUs);
+    out->lost += (long)outstanding.size();
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Main
+// ═══════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char** argv) {
+    int bursts = 1000;
+    double periodUs = 20000;
+    double loopUs = 2;
+    std::vector<int> sizes = {1, 2, 4, 8, 12, 15, 16, 24, 32};
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bursts") == 0 && i + 1 < argc) bursts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--period") == 0 && i + 1 < argc) periodUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--loop") == 0 && i + 1 < argc) loopUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--hal") == 0 && i + 1 < argc) halCallUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes.clear();
+            for (char* p = strtok(argv[++i], ","); p != nullptr; p = strtok(nullptr, ",")) sizes.push_back(atoi(p));
+        } else {
+            fprintf(stderr, "Usage: %s [--bursts N] [--period US] [--loop US] [--hal US] [--sizes 1,4,8,...]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (bursts < 1 || periodUs <= 0 || loopUs <= 0 || halCallUs < 0 || sizes.empty()) return 2;
+
+    printf("%d bursts every %.1f ms, 500 kbit/s, request 0x%03X / reply 0x%03X, main loop %.1f us, HAL call %.1f us\n",
+           bursts, periodUs / 1000, L431_RX_CAN_ID, L431_TX_CAN_ID, loopUs, halCallUs);
+    printf("%5s %8s %8s %6s %6s %6s %9s %9s %9s %9s\n",
+           "burst", "replies", "loss", "fifo", "cmdq", "txq", "reply p50", "reply p99", "apply max", "mask max");
+
+    bool ok = true;
+    for (int burst : sizes) {
+        if (burst < 1) continue;
+        RunStats s;
+        if (!run(burst, bursts, periodUs, loopUs, &s)) {
+            fprintf(stderr, "Cannot map the flash at 0x%08lX\n", (unsigned long)FLASH_BASE);
+            return 1;
+        }
+        const HalStubStats* hal = HalStub_Stats();
+        long dropped = (long)(hal->canRxOverruns + puiStats.framesDropped);
+        printf("%5d %8ld %7.2f%% %6u %6u %6u %9.0f %9.0f %9u %9.1f\n",
+               burst, s.replies, 100.0 * s.lost / s.requests, hal->canRxOverruns,
+               (unsigned)puiStats.framesDropped, (unsigned)puiStats.repliesDropped,
+               percentile(s.replyUs, 0.50), percentile(s.replyUs, 0.99),
+               (unsigned)puiStats.latencyMaxUs, (double)hal->irqMaskedMaxUs);
+
+        bool fits = burst <= CMD_QUEUE_SIZE - 1;
+        bool accounted = s.replies + s.lost == s.requests &&
+                         (long)puiStats.framesQueued + dropped == s.requests &&
+                         puiStats.framesQueued == puiStats.repliesQueued + puiStats.repliesDropped &&
+                         (long)puiStats.repliesQueued == s.replies &&
+                         hal->canTxRejected == 0;
+        // Dropped commands leave the rails of the requests after them untracked
+        bool correct = s.unexpected == 0 && (dropped > 0 || s.wrongStatus == 0);
+        if (!accounted || !correct || (fits && s.lost > 0)) {
+            printf("      unexpected %ld, wrong status %ld, tx rejected %u, accounted %s\n",
+                   s.unexpected, s.wrongStatus, hal->canTxRejected, accounted ? "yes" : "no");
+            ok = false;
+        }
+    }
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
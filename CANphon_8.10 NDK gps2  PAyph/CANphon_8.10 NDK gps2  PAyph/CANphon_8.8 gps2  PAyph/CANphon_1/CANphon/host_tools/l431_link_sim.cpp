@@ -0,0 +1,274 @@
+/**
+ * l431_link_sim.cpp
+ * L431 Power Unit Link Simulation (host)
+ *
+ * Phone side: l431_link tracker, replies received by can_rx_thread
+ * through can_dispatch, exactly as in the app.
+ * Board side: the PUI firmware's protocol unit (L431 PUI/Core/Src/
+ * pui_protocol.c) unchanged on the HAL stub (hal_stub/), on its own
+ * thread: frames that pass main.c's CAN filter go into the RX FIFO, the
+ * main loop runs after each one, and the mailboxes go out on the
+ * loopback bus. The stub clock follows the real one, so HAL_GetTick is
+ * the board tick. Optional fixed processing delay and status reply loss
+ * (the firmware sends with automatic retransmission off).
+ *
+ * Pipelines requests (several in flight), mixes multi-command, legacy,
+ * SYNC and broadcast frames, then checks every request was either
+ * answered or timed out, every legacy command and SYNC was answered,
+ * broadcasts and stray legacy bytes on the broadcast ID were handled as
+ * the firmware specifies, and the reported rails match the last command.
+ *
+ *   l431_link_sim [requests] [--rate N/s] [--loss PCT] [--delay US]
+ */
+
+extern "C" {
+#include "hal_stub.h"
+#include "pui_protocol.h"
+}
+
+#include "can_dispatch.h"
+#include "can_rx_thread.h"
+#include "can_transport.h"
+#include "l431_link.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+static const Clock::time_point epoch = Clock::now();
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Board (pui_protocol.c on the HAL stub)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" {
+CAN_HandleTypeDef hcan1;
+}
+
+struct Board {
+    int delayUs = 50;
+    std::atomic<int> lossPercent{0};   // Cleared for the final status request
+    uint32_t seed = 12345;
+    uint64_t filtered = 0;             // Frames main.c's filter would not accept
+    uint64_t dropped = 0;              // Status replies lost on the bus
+};
+
+// Every HAL call from the firmware reads the real clock
+static void onHalCall() {
+    HalStub_SetTimeUs((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - epoch).count());
+}
+
+// CAN_Filter_Config: commands, SYNC and broadcast IDs only
+static bool filterAccepts(uint32_t id) {
+    return id == L431_RX_CAN_ID || id == L431_SYNC_CAN_ID || id == L431_BROADCAST_CAN_ID;
+}
+
+static void runBoard(CanTransport* t, Board* b, std::atomic<bool>* running) {
+    WsCanFrame rx[CAN_TRANSPORT_MAX_BATCH];
+    WsCanFrame tx[CAN_TRANSPORT_MAX_BATCH];
+
+    while (running->load(std::memory_order_relaxed)) {
+        int n = canTransportReceive(t, rx, CAN_TRANSPORT_MAX_BATCH, 1);
+        onHalCall();
+        if (n > 0 && b->delayUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(b->delayUs));
+
+        // One main loop pass per frame (frames are a frame time apart on the bus)
+        int replies = 0;
+        for (int i = 0; i < n; i++) {
+            if (!filterAccepts(rx[i].id)) {
+                b->filtered++;
+                continue;
+            }
+            HalStub_CanReceive(&hcan1, rx[i].id, rx[i].data, rx[i].dlc);
+            L431_ProcessQueue();
+
+            // Mailboxes go out; TX-complete refills them from the firmware's queue
+            HalStubCanFrame f;
+            while (replies < CAN_TRANSPORT_MAX_BATCH && HalStub_CanTxComplete(&hcan1, &f)) {
+                if (f.dlc == 8 && f.data[0] == L431_REPLY_STATUS) {
+                    b->seed = b->seed * 1664525u + 1013904223u;
+                    if ((int)((b->seed >> 8) % 100) < b->lossPercent) {
+                        b->dropped++;
+                        continue;
+                    }
+                }
+                WsCanFrame* out = &tx[replies++];
+                memset(out, 0, sizeof(*out));
+                out->id = f.stdId;
+                out->dlc = f.dlc;
+                memcpy(out->data, f.data, f.dlc);
+            }
+        }
+        if (replies > 0) canTransportSend(t, tx, replies);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Phone Side
+// ═══════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char** argv) {
+    int total = 2000;
+    int rate = 1000;
+    Board board;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc) board.lossPercent = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) board.delayUs = atoi(argv[++i]);
+        else if (argv[i][0] != '-') total = atoi(argv[i]);
+        else {
+            fprintf(stderr, "Usage: %s [requests] [--rate N/s] [--loss PCT] [--delay US]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rate < 1) rate = 1;
+
+    if (!HalStub_Reset()) {
+        fprintf(stderr, "Cannot map the flash at 0x%08lX\n", (unsigned long)FLASH_BASE);
+        return 2;
+    }
+    HalStub_SetHook(onHalCall);
+
+    CanTransport* phone = nullptr;
+    CanTransport* bus = nullptr;
+    if (!canTransportOpenLoopbackPair(&phone, &bus, CAN_TRANSPORT_LOOPBACK_DEPTH)) return 2;
+
+    canDispatchReset();
+    l431LinkReset(L431_LINK_DEFAULT_TIMEOUT_MS);
+    l431LinkInstall();
+
+    std::atomic<bool> running(true);
+    std::thread boardThread(runBoard, bus, &board, &running);
+
+    // The rx thread owns the phone end for receiving; sends stay on this thread
+    CanRxThreadConfig rx;
+    canRxThreadDefaultConfig(&rx);
+    rx.timeoutMs = 20;
+    if (!canRxThreadStart(phone, &rx)) return 2;
+
+    // Pattern: ON+STATUS, HEARTBEAT, OFF+HEARTBEAT+STATUS, a bad byte, legacy ON;
+    // now and then a SYNC, a broadcast OFF, or a legacy ON on the broadcast ID
+    // (ignored by the board)
+    uint8_t lastPower = 0;
+    int legacySent = 0;
+    int syncSent = 0;
+    int broadcastSent = 0;
+    int framesSent = 0;
+    int refused = 0;
+    Clock::duration period = std::chrono::microseconds(1000000 / rate);
+    Clock::time_point next = Clock::now();
+
+    for (int i = 0; i < total; i++) {
+        std::this_thread::sleep_until(next);
+        next += period;
+
+        WsCanFrame frame;
+        if (i % 10 == 9 || i % 50 == 23) {
+            memset(&frame, 0, sizeof(frame));
+            frame.id = i % 10 == 9 ? L431_REQUEST_ID : L431_BROADCAST_ID;
+            frame.dlc = 8;
+            frame.data[0] = L431_CMD_POWER_ON;
+            if (frame.id == L431_REQUEST_ID) {
+                lastPower = L431_CMD_POWER_ON;
+                legacySent++;
+            }
+            framesSent += canTransportSend(phone, &frame, 1);
+            continue;
+        }
+        if (i % 25 == 11) {
+            memset(&frame, 0, sizeof(frame));
+            frame.id = L431_SYNC_ID;
+            frame.dlc = 1;
+            frame.data[0] = (uint8_t)syncSent++;
+            framesSent += canTransportSend(phone, &frame, 1);
+            continue;
+        }
+        if (i % 25 == 17) {
+            uint8_t off = L431_CMD_POWER_OFF;
+            l431FormatRequest(0, &off, 1, &frame);
+            frame.id = L431_BROADCAST_ID;
+            lastPower = L431_CMD_POWER_OFF;
+            broadcastSent++;
+            framesSent += canTransportSend(phone, &frame, 1);
+            continue;
+        }
+
+        uint8_t cmds[L431_MAX_COMMANDS];
+        int count = 0;
+        switch (i % 4) {
+        case 0: cmds[count++] = L431_CMD_POWER_ON; cmds[count++] = L431_CMD_STATUS; break;
+        case 1: cmds[count++] = L431_CMD_HEARTBEAT; break;
+        case 2: cmds[count++] = L431_CMD_POWER_OFF; cmds[count++] = L431_CMD_HEARTBEAT; cmds[count++] = L431_CMD_STATUS; break;
+        default: cmds[count++] = 0x7E; cmds[count++] = L431_CMD_STATUS; break;
+        }
+
+        int seq = l431LinkSubmit(cmds, count);
+        if (seq < 0) {
+            refused++;
+            continue;
+        }
+        for (int k = 0; k < count; k++) {
+            if (cmds[k] == L431_CMD_POWER_ON || cmds[k] == L431_CMD_POWER_OFF) lastPower = cmds[k];
+        }
+        l431FormatRequest((uint8_t)seq, cmds, count, &frame);
+        framesSent += canTransportSend(phone, &frame, 1);
+    }
+
+    // Let the last replies arrive and expire the rest. Then the rails must
+    // show a broadcast OFF, not the legacy ON sent after it on the broadcast
+    // ID: the board ignores that one
+    std::this_thread::sleep_for(std::chrono::milliseconds(L431_LINK_DEFAULT_TIMEOUT_MS + 50));
+    int lossPercent = board.lossPercent.exchange(0);
+    uint8_t off = L431_CMD_POWER_OFF;
+    WsCanFrame tail[3];
+    l431FormatRequest(0, &off, 1, &tail[0]);
+    tail[0].id = L431_BROADCAST_ID;
+    memset(&tail[1], 0, sizeof(tail[1]));
+    tail[1].id = L431_BROADCAST_ID;
+    tail[1].dlc = 1;
+    tail[1].data[0] = L431_CMD_POWER_ON;
+    uint8_t status = L431_CMD_STATUS;
+    l431FormatRequest((uint8_t)l431LinkSubmit(&status, 1), &status, 1, &tail[2]);
+    lastPower = L431_CMD_POWER_OFF;
+    broadcastSent++;
+    framesSent += canTransportSend(phone, tail, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    board.lossPercent = lossPercent;
+    canRxThreadStop();
+    running = false;
+    boardThread.join();
+    canTransportClose(bus);
+
+    L431LinkStats s;
+    l431LinkGetStats(&s);
+    const HalStubStats* hal = HalStub_Stats();
+    int expectRails = lastPower == L431_CMD_POWER_ON ? (L431_RAIL_PA9 | L431_RAIL_PA10) : L431_RAIL_PA5;
+    bool accounted = s.replies + s.timeouts == s.requests && s.inFlight == 0;
+    bool railsOk = s.rails >= 0 && (s.rails & 0x07) == expectRails;
+    bool legacyOk = s.legacyAcks == (uint64_t)legacySent;
+    bool syncOk = s.syncReplies == (uint64_t)syncSent;
+    bool lossOk = board.lossPercent > 0 ? s.timeouts == board.dropped : s.timeouts == 0;
+    bool boardOk = puiStats.framesQueued == (uint32_t)framesSent && puiStats.framesDropped == 0 &&
+                   puiStats.repliesDropped == 0 && hal->canRxOverruns == 0 && board.filtered == 0;
+
+    printf("Requests %llu (%d refused, window %d), replies %llu, timeouts %llu (board dropped %llu), unmatched %llu\n",
+           (unsigned long long)s.requests, refused, L431_LINK_WINDOW, (unsigned long long)s.replies,
+           (unsigned long long)s.timeouts, (unsigned long long)board.dropped, (unsigned long long)s.unmatched);
+    printf("Legacy ACKs %llu of %d, SYNC replies %llu of %d, broadcasts %d, rejected command bytes %llu\n",
+           (unsigned long long)s.legacyAcks, legacySent, (unsigned long long)s.syncReplies, syncSent,
+           broadcastSent, (unsigned long long)s.rejectedCommands);
+    printf("Board: %u frames queued of %d, %u dropped, %u replies queued, %u dropped, RX -> applied max %u us\n",
+           (unsigned)puiStats.framesQueued, framesSent, (unsigned)puiStats.framesDropped,
+           (unsigned)puiStats.repliesQueued, (unsigned)puiStats.repliesDropped, (unsigned)puiStats.latencyMaxUs);
+    printf("RTT us: min %lld  mean %lld  max %lld  last %lld\n",
+           (long long)s.rttMinUs, (long long)s.rttMeanUs, (long long)s.rttMaxUs, (long long)s.rttLastUs);
+    printf("Rails 0x%02llX (expected power bits 0x%02X), board tick %lld ms\n",
+           (unsigned long long)s.rails, expectRails, (long long)s.deviceTickMs);
+
+    bool ok = accounted && railsOk && legacyOk && syncOk && lossOk && boardOk;
+    printf("%s\n", ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
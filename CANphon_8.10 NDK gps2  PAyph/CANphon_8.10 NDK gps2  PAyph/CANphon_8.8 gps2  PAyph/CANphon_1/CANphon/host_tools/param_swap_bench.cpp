@@ -0,0 +1,241 @@
+/**
+ * param_swap_bench.cpp
+ * Parameter Store Stress Benchmark (host)
+ *
+ * A writer flips every parameter between two complete sets at a fixed
+ * rate while reader threads pin snapshots as fast as they can and a
+ * 1 kHz control loop runs guidance with a saturating error. Each pinned
+ * snapshot must be exactly one set (never a mix), generations never go
+ * back, the saturated command must be the cmdMax of a set (the change
+ * took effect, nothing was reset) and the listener sees every change.
+ * Then the binary file is saved, reloaded, and rejected when corrupt.
+ *
+ *   param_swap_bench [--seconds S] [--rate SWAPS_PER_S] [--readers N]
+ */
+
+#include "param_store.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// guidance_controller.cpp
+extern "C" {
+    void guidanceSetParams(float alpha, float cmdMax);
+    void guidanceInit();
+    void guidanceStart();
+    void guidanceUpdate(float errorX, float errorY, float dt);
+    void guidanceGetCommands(float* pitch, float* yaw);
+}
+
+static float SET_A[PARAM_COUNT];
+static float SET_B[PARAM_COUNT];
+
+static void buildSets() {
+    for (int id = 0; id < PARAM_COUNT; id++) SET_A[id] = paramInfo(id)->defaultValue;
+    const float b[PARAM_COUNT] = {
+        0.3f, 15.0f, 1.0f, 0.2f, 0.05f, 0.5f, 0.9f, 150.0f, 2.0f,
+        10, 800, 0.2f, 4.0f, 2, 300.0f, 10, 5, 150.0f,
+    };
+    memcpy(SET_B, b, sizeof(SET_B));
+}
+
+// 0 = set A, 1 = set B, -1 = a mix of both (torn)
+static int whichSet(const ParamSnapshot* s) {
+    bool a = true, b = true;
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        float v = paramInfo(id)->type == PARAM_TYPE_INT ? (float)s->values[id].i : s->values[id].f;
+        a = a && v == SET_A[id];
+        b = b && v == SET_B[id];
+    }
+    return a ? 0 : b ? 1 : -1;
+}
+
+struct ReaderResult {
+    uint64_t pins = 0;
+    uint64_t torn = 0;
+    uint64_t regressions = 0;   // Generation older than one seen before
+};
+
+static void reader(const std::atomic<bool>& running, ReaderResult* result) {
+    uint32_t last = 0;
+    while (running.load(std::memory_order_relaxed)) {
+        ParamPin pin;
+        if (whichSet(pin.snapshot) < 0) result->torn++;
+        if (pin.snapshot->generation < last) result->regressions++;
+        last = pin.snapshot->generation;
+        result->pins++;
+    }
+}
+
+struct ControlResult {
+    uint64_t ticks = 0;
+    uint64_t badCommand = 0;    // Saturated command matching neither cmdMax
+    uint64_t generationsSeen = 0;
+    std::vector<int64_t> pinNs;
+};
+
+static void control(const std::atomic<bool>& running, ControlResult* result) {
+    guidanceSetParams(SET_A[PARAM_GUIDANCE_ALPHA], SET_A[PARAM_GUIDANCE_CMD_MAX]);
+    guidanceInit();
+    guidanceStart();
+    uint32_t lastGeneration = 0;
+    auto next = std::chrono::steady_clock::now();
+    while (running.load(std::memory_order_relaxed)) {
+        // The per-tick parameter read of a control loop
+        auto t0 = std::chrono::steady_clock::now();
+        uint32_t generation;
+        {
+            ParamPin pin;
+            generation = pin.snapshot->generation;
+        }
+        result->pinNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+        if (generation != lastGeneration) result->generationsSeen++;
+        lastGeneration = generation;
+
+        // Error far past any gain: yaw saturates at the cmdMax in force
+        guidanceUpdate(1000.0f, 0.0f, 0.001f);
+        float pitch, yaw;
+        guidanceGetCommands(&pitch, &yaw);
+        if (result->ticks > 50 && yaw != SET_A[PARAM_GUIDANCE_CMD_MAX] && yaw != SET_B[PARAM_GUIDANCE_CMD_MAX]) {
+            result->badCommand++;
+        }
+        result->ticks++;
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+    }
+}
+
+static void countChange(const ParamSnapshot*, uint64_t changedMask, void* user) {
+    if (changedMask) static_cast<std::atomic<uint64_t>*>(user)->fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool persistenceChecks() {
+    const char* path = "/tmp/param_swap_bench.bin";
+    bool ok = true;
+    int ids[PARAM_COUNT];
+    for (int id = 0; id < PARAM_COUNT; id++) ids[id] = id;
+
+    paramSetMany(ids, SET_B, PARAM_COUNT);
+    if (paramSave(path) != PARAM_COUNT) ok = false;
+    paramResetDefaults();
+    int applied = paramLoad(path);
+    {
+        ParamPin pin;
+        if (applied != PARAM_COUNT || whichSet(pin.snapshot) != 1) ok = false;
+    }
+    printf("File: save + load %s (%d applied)", ok ? "ok" : "FAILED", applied);
+
+    // Flip one value byte: CRC must reject it and leave the values alone
+    FILE* f = fopen(path, "r+b");
+    if (f) {
+        fseek(f, 12, SEEK_SET);
+        int c = fgetc(f);
+        fseek(f, 12, SEEK_SET);
+        fputc(c ^ 0x40, f);
+        fclose(f);
+    }
+    paramResetDefaults();
+    bool rejected = paramLoad(path) == -1;
+    {
+        ParamPin pin;
+        rejected = rejected && whichSet(pin.snapshot) == 0;
+    }
+    printf(" | corrupt file %s", rejected ? "rejected" : "ACCEPTED");
+    bool missing = paramLoad("/tmp/param_swap_bench.none") == -1;
+    printf(" | missing file %s\n", missing ? "rejected" : "ACCEPTED");
+    remove(path);
+    return ok && rejected && missing;
+}
+
+int main(int argc, char** argv) {
+    int seconds = 3;
+    int rate = 1000;
+    int readers = 4;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) readers = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--rate SWAPS_PER_S] [--readers N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds < 1 || rate < 1 || readers < 0 || readers > 64) return 2;
+
+    buildSets();
+    std::atomic<uint64_t> notified{0};
+    int listener = paramAddListener(countChange, &notified);
+
+    std::atomic<bool> running{true};
+    std::vector<ReaderResult> readerResults(readers);
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) threads.emplace_back(reader, std::cref(running), &readerResults[r]);
+    ControlResult controlResult;
+    controlResult.pinNs.reserve((size_t)seconds * 1100);
+    std::thread controlThread(control, std::cref(running), &controlResult);
+
+    // Writer: whole set A / set B alternately
+    int ids[PARAM_COUNT];
+    for (int id = 0; id < PARAM_COUNT; id++) ids[id] = id;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uint64_t baseNotified = notified.load();
+    uint64_t swaps = 0, failed = 0;
+    std::vector<int64_t> swapNs;
+    swapNs.reserve((size_t)rate * seconds);
+    auto period = std::chrono::nanoseconds(1000000000LL / rate);
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::seconds(seconds);
+    while (next < end) {
+        auto t0 = std::chrono::steady_clock::now();
+        int generation = paramSetMany(ids, (swaps & 1) ? SET_A : SET_B, PARAM_COUNT);
+        swapNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count());
+        if (generation < 0) failed++;
+        else swaps++;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    running.store(false);
+    for (auto& t : threads) t.join();
+    controlThread.join();
+    uint64_t changes = notified.load() - baseNotified;
+    paramRemoveListener(listener);
+
+    ParamStats stats;
+    paramGetStats(&stats);
+    std::sort(swapNs.begin(), swapNs.end());
+    std::vector<int64_t>& pinNs = controlResult.pinNs;
+    std::sort(pinNs.begin(), pinNs.end());
+    auto p99 = [](const std::vector<int64_t>& v) { return v.empty() ? 0 : v[(size_t)(0.99 * (double)(v.size() - 1))]; };
+
+    printf("Writer: %llu swaps (%d/s), %llu failed, %llu notified | swap p99 %lld ns, max %lld ns | slot waits %llu\n",
+           (unsigned long long)swaps, rate, (unsigned long long)failed, (unsigned long long)changes,
+           (long long)p99(swapNs), (long long)(swapNs.empty() ? 0 : swapNs.back()),
+           (unsigned long long)stats.slotWaits);
+
+    bool ok = failed == 0 && changes == swaps && stats.pinned == 0;
+    uint64_t pins = 0, torn = 0, regressions = 0;
+    for (const ReaderResult& r : readerResults) {
+        pins += r.pins;
+        torn += r.torn;
+        regressions += r.regressions;
+    }
+    printf("Readers: %d threads, %llu pins, %llu torn, %llu generation regressions\n",
+           readers, (unsigned long long)pins, (unsigned long long)torn, (unsigned long long)regressions);
+    printf("Control: %llu ticks at 1 kHz, %llu generations seen, %llu commands off cmdMax | pin+read p99 %lld ns, max %lld ns\n",
+           (unsigned long long)controlResult.ticks, (unsigned long long)controlResult.generationsSeen,
+           (unsigned long long)controlResult.badCommand, (long long)p99(pinNs),
+           (long long)(pinNs.empty() ? 0 : pinNs.back()));
+    if (torn || regressions || controlResult.badCommand) ok = false;
+
+    if (!persistenceChecks()) ok = false;
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
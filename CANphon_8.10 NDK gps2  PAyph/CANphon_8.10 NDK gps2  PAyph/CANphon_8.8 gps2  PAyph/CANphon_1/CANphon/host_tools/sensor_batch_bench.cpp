@@ -0,0 +1,329 @@
+/**
+ * sensor_batch_bench.cpp
+ * Sensor Hub Batching Benchmark (host)
+ *
+ * Model of native_sensors' drain thread against a sensor hub:
+ *   hub     - accelerometer + gyroscope samples at a fixed rate, stamped
+ *             when taken and held in a FIFO (--fifo events) until the
+ *             batch latency is up, then written to the event channel in
+ *             one go (a pipe, standing in for the sensor event socket)
+ *   drain   - poll() on the channel (ALooper_pollOnce), read everything
+ *             buffered IMU_RING_MAX_BURST events at a time (getEvents),
+ *             push it into imu_ring, account thread CPU
+ *   reader  - pollSensors every 5 ms, takes everything pending
+ *
+ * Profiles: low    - latency 0, the hub writes every sample as it is taken
+ *           batched - latency --latency-ms (default 100)
+ *
+ * Reports the drain thread's CPU per 1000 samples, wakeups, burst size and
+ * sample age at the reader. The host has no sensor hub power states, so
+ * only the application-side CPU is modelled; the hub's own savings (AP
+ * left in suspend between bursts) come on top on the device, where
+ * getSensorBatchStats reports the same CPU figure.
+ *
+ * Usage: sensor_batch_bench [low|batched|both] [--rate HZ] [--latency-ms MS]
+ *                           [--fifo N] [--seconds S]
+ */
+
+#include "imu_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const int TYPE_ACCELEROMETER = 1;       // ASENSOR_TYPE_*
+static const int TYPE_GYROSCOPE = 4;
+static const int READER_PERIOD_MS = 5;
+static const int DRAIN_TIMEOUT_MS = 500;       // SENSOR_DRAIN_TIMEOUT_MS
+
+// Same size as ASensorEvent (104 bytes), so the channel carries as much
+struct HubEvent {
+    int32_t version;
+    int32_t sensor;
+    int32_t type;
+    int32_t reserved0;
+    int64_t timestamp;
+    float data[16];
+    uint32_t flags;
+    int32_t reserved1[3];
+};
+
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+struct BenchConfig {
+    int rateHz = 400;           // Per sensor
+    int latencyMs = 100;        // Batched profile
+    int fifoEvents = 3000;      // Hub FIFO, shared by both sensors
+    double seconds = 3.0;
+};
+
+struct ProfileResult {
+    const char* name;
+    int latencyMs;
+    ImuRingStats ring;
+    uint64_t hubWrites;
+    uint64_t hubFifoFlushes;    // FIFO full before the latency was up
+    int64_t ageP50Us, ageP99Us, ageMaxUs;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Hub
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void runHub(int fd, const BenchConfig& cfg, int latencyMs, std::atomic<uint64_t>* writes,
+                   std::atomic<uint64_t>* fifoFlushes) {
+    const int64_t periodNs = 1000000000LL / cfg.rateHz;
+    const int64_t latencyNs = (int64_t)latencyMs * 1000000;
+    const int64_t endNs = nowNs() + (int64_t)(cfg.seconds * 1e9);
+
+    std::vector<HubEvent> fifo;
+    fifo.reserve(cfg.fifoEvents);
+    int64_t oldestNs = 0;
+    uint64_t n = 0;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    auto flush = [&]() {
+        if (fifo.empty()) return;
+        const char* p = reinterpret_cast<const char*>(fifo.data());
+        size_t left = fifo.size() * sizeof(HubEvent);
+        while (left > 0) {
+            ssize_t w = write(fd, p, left);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            p += w;
+            left -= (size_t)w;
+        }
+        writes->fetch_add(1, std::memory_order_relaxed);
+        fifo.clear();
+    };
+
+    while (true) {
+        int64_t t = nowNs();
+        if (t >= endNs) break;
+
+        for (int type : {TYPE_ACCELEROMETER, TYPE_GYROSCOPE}) {
+            HubEvent e;
+            memset(&e, 0, sizeof(e));
+            e.type = type;
+            e.timestamp = t;
+            e.data[0] = (float)(n % 100) * 0.01f;
+            e.data[1] = type == TYPE_GYROSCOPE ? 0.02f : 0.0f;
+            e.data[2] = type == TYPE_ACCELEROMETER ? 9.81f : 0.0f;
+            if (fifo.empty()) oldestNs = t;
+            fifo.push_back(e);
+            if ((int)fifo.size() >= cfg.fifoEvents) {
+                if (latencyNs > 0) fifoFlushes->fetch_add(1, std::memory_order_relaxed);
+                flush();
+            }
+        }
+        n++;
+
+        if (latencyNs == 0 || t - oldestNs >= latencyNs) flush();
+
+        next.tv_nsec += periodNs;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+    }
+    flush();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Drain thread (native_sensors drainLoop)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void runDrain(int fd, std::atomic<bool>* stop) {
+    const int64_t cpuStartNs = threadCpuNs();
+    HubEvent events[IMU_RING_MAX_BURST];
+    ImuSample samples[IMU_RING_MAX_BURST];
+    struct pollfd pfd = {fd, POLLIN, 0};
+
+    while (!stop->load(std::memory_order_relaxed)) {
+        poll(&pfd, 1, DRAIN_TIMEOUT_MS);
+
+        int drained = 0;
+        bool closed = false;
+        while (true) {
+            ssize_t r = read(fd, events, sizeof(events));
+            if (r <= 0) {
+                closed = r == 0;
+                break;
+            }
+            // The pipe may split an event; finish it (getEvents never returns halves)
+            size_t partial = (size_t)r % sizeof(HubEvent);
+            while (partial != 0) {
+                ssize_t more = read(fd, reinterpret_cast<char*>(events) + r, sizeof(HubEvent) - partial);
+                if (more > 0) {
+                    r += more;
+                    partial = (size_t)r % sizeof(HubEvent);
+                } else if (more == 0) {
+                    break;
+                }
+            }
+            int n = (int)(r / sizeof(HubEvent));
+            for (int i = 0; i < n; i++) {
+                samples[i].timestampNs = events[i].timestamp;
+                samples[i].type = events[i].type;
+                memcpy(samples[i].v, events[i].data, sizeof(samples[i].v));
+            }
+            imuRingPush(samples, n);
+            drained += n;
+        }
+        imuRingNoteDrain(drained, threadCpuNs() - cpuStartNs);
+        if (closed) break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Profiles
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool runProfile(const char* name, int latencyMs, const BenchConfig& cfg, ProfileResult* out) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return false;
+    }
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[0], F_SETPIPE_SZ, 1 << 20);
+
+    imuRingReset();
+    std::atomic<bool> stopDrain(false);
+    std::atomic<bool> stopReader(false);
+    std::atomic<uint64_t> writes(0);
+    std::atomic<uint64_t> fifoFlushes(0);
+    std::vector<int64_t> agesUs;
+
+    std::thread drain(runDrain, fds[0], &stopDrain);
+    std::thread reader([&]() {
+        ImuSample batch[IMU_RING_MAX_BURST];
+        while (true) {
+            bool last = stopReader.load(std::memory_order_acquire);
+            int n;
+            while ((n = imuRingRead(batch, IMU_RING_MAX_BURST)) > 0) {
+                int64_t t = nowNs();
+                for (int i = 0; i < n; i++) agesUs.push_back((t - batch[i].timestampNs) / 1000);
+            }
+            if (last) break;
+            usleep(READER_PERIOD_MS * 1000);
+        }
+    });
+
+    runHub(fds[1], cfg, latencyMs, &writes, &fifoFlushes);
+    close(fds[1]);
+    drain.join();      // Leaves once the channel is drained and closed
+    stopReader.store(true, std::memory_order_release);
+    reader.join();
+    close(fds[0]);
+
+    out->name = name;
+    out->latencyMs = latencyMs;
+    imuRingGetStats(&out->ring);
+    out->hubWrites = writes.load();
+    out->hubFifoFlushes = fifoFlushes.load();
+    out->ageP50Us = percentile(agesUs, 0.50);
+    out->ageP99Us = percentile(agesUs, 0.99);
+    out->ageMaxUs = agesUs.empty() ? 0 : *std::max_element(agesUs.begin(), agesUs.end());
+    return true;
+}
+
+static void printResult(const ProfileResult& r) {
+    const ImuRingStats& s = r.ring;
+    double perDrain = s.drains > 0 ? (double)s.pushed / (double)s.drains : 0.0;
+    printf("%-8s latency %4d ms: %7llu samples in %llu hub writes, %6llu drains (%.1f / drain, max %u), "
+           "%llu empty, %llu dropped, %llu FIFO-full flushes\n",
+           r.name, r.latencyMs, (unsigned long long)s.pushed, (unsigned long long)r.hubWrites,
+           (unsigned long long)s.drains, perDrain, s.maxBurst, (unsigned long long)s.emptyWakeups,
+           (unsigned long long)s.dropped, (unsigned long long)r.hubFifoFlushes);
+    printf("         drain cpu %.1f ms = %.1f us / 1000 samples; sample age p50 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+           s.cpuNs / 1e6, imuRingCpuUsPer1000(&s), r.ageP50Us / 1000.0, r.ageP99Us / 1000.0,
+           r.ageMaxUs / 1000.0);
+}
+
+int main(int argc, char** argv) {
+    BenchConfig cfg;
+    const char* mode = "both";
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "low") || !strcmp(argv[i], "batched") || !strcmp(argv[i], "both")) {
+            mode = argv[i];
+        } else if (!strcmp(argv[i], "--rate") && i + 1 < argc) {
+            cfg.rateHz = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--latency-ms") && i + 1 < argc) {
+            cfg.latencyMs = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--fifo") && i + 1 < argc) {
+            cfg.fifoEvents = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+            cfg.seconds = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [low|batched|both] [--rate HZ] [--latency-ms MS] [--fifo N] [--seconds S]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.rateHz <= 0 || cfg.latencyMs <= 0 || cfg.fifoEvents < 2 || cfg.seconds <= 0) {
+        fprintf(stderr, "rate, latency, fifo and seconds must be positive\n");
+        return 2;
+    }
+
+    printf("Sensor hub: accel + gyro at %d Hz each, FIFO %d events, %.1f s per profile\n\n",
+           cfg.rateHz, cfg.fifoEvents, cfg.seconds);
+
+    std::vector<ProfileResult> results;
+    ProfileResult r;
+    if (strcmp(mode, "batched") != 0) {
+        if (!runProfile("low", 0, cfg, &r)) return 1;
+        printResult(r);
+        results.push_back(r);
+    }
+    if (strcmp(mode, "low") != 0) {
+        if (!runProfile("batched", cfg.latencyMs, cfg, &r)) return 1;
+        printResult(r);
+        results.push_back(r);
+    }
+
+    bool ok = true;
+    for (const ProfileResult& p : results) {
+        if (p.ring.pushed == 0 || p.ring.dropped != 0 || p.ring.read != p.ring.pushed) ok = false;
+    }
+    if (results.size() == 2) {
+        double low = imuRingCpuUsPer1000(&results[0].ring);
+        double batched = imuRingCpuUsPer1000(&results[1].ring);
+        printf("\nbatched / low CPU per 1000 samples: %.2fx, drains %.1fx fewer\n",
+               low > 0 ? batched / low : 0.0,
+               results[1].ring.drains > 0 ? (double)results[0].ring.drains / results[1].ring.drains : 0.0);
+    }
+    printf("%s\n", ok ? "OK" : "FAILED (samples lost between hub and reader)");
+    return ok ? 0 : 1;
+}
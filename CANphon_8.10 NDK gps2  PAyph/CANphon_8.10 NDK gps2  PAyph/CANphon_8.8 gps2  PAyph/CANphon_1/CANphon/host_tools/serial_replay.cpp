@@ -0,0 +1,309 @@
+/**
+ * serial_replay.cpp
+ * Serial Stream Replay (host)
+ *
+ * Replays a captured (or synthetic) GNSS/KCA or servo feedback byte
+ * stream through a pseudo-terminal into the native parsers, the same
+ * way the app reads the real device:
+ *
+ *   writer thread -> pty master (writev, message-aligned)
+ *   pty slave (termios raw, epoll, 16 KB reads) -> kca_parser / servo stream parser
+ *
+ * Reports parser throughput (CPU time in the parser only), end-to-end
+ * throughput, and latency from the write() that carried a message's last
+ * byte to the end of the parse call that completed it.
+ *
+ * Usage: serial_replay <gnss|servo> [capture.bin] [--paced BAUD]
+ */
+
+#include "kca_parser.h"
+#include "serial_port.h"
+#include "servo_protocol.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static const int SYNTH_KCA_FRAMES = 20000;     // ~3.3 MB
+static const int SYNTH_SERVO_FRAMES = 500000;  // ~3.5 MB
+static const int CAPTURE_CHUNK = 4096;         // Write size when replaying a file
+static const int MESSAGES_PER_WRITEV = 32;
+
+typedef std::chrono::steady_clock Clock;
+static const Clock::time_point epoch = Clock::now();
+
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Streams
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct Stream {
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> messageEnds;   // Synthetic: end offset of each message
+    long expectedMessages;             // -1 = unknown (capture)
+};
+
+static void putLE32(uint8_t* p, uint32_t v) { memcpy(p, &v, 4); }
+static void putLEf(uint8_t* p, float v) { memcpy(p, &v, 4); }
+
+static Stream synthGnss() {
+    Stream s;
+    s.expectedMessages = SYNTH_KCA_FRAMES;
+    uint8_t payload[KCA_MAX_PAYLOAD];
+
+    for (int i = 0; i < SYNTH_KCA_FRAMES; i++) {
+        memset(payload, 0, sizeof(payload));
+        payload[0] = 0x01;                       // msgType
+        payload[1] = 0x02;                       // state: 3D fix
+        payload[2] = 35;                         // temperature
+        putLE32(payload + 3, (uint32_t)(i * 100));
+        putLE32(payload + 7, 0x00FF00FFu);       // GPS visible
+        putLE32(payload + 11, 0x000F000Fu);      // GPS used (8)
+        putLE32(payload + 15, 0x3Fu);            // GLONASS visible
+        putLE32(payload + 19, 0x0Fu);            // GLONASS used (4)
+        putLEf(payload + 23 + 6 * 4, 24.7136f + i * 1e-6f);   // latitude
+        putLEf(payload + 23 + 8 * 4, 46.6753f);               // longitude
+        putLEf(payload + 23 + 10 * 4, 612.0f);                // altitude
+
+        uint16_t crc = kcaCrc16(payload, KCA_MAX_PAYLOAD);
+        s.bytes.push_back(KCA_SYNC1);
+        s.bytes.push_back(KCA_SYNC2);
+        s.bytes.insert(s.bytes.end(), payload, payload + KCA_MAX_PAYLOAD);
+        s.bytes.push_back((uint8_t)(crc & 0xFF));
+        s.bytes.push_back((uint8_t)(crc >> 8));
+        s.messageEnds.push_back(s.bytes.size());
+
+        if (i % 100 == 99) s.bytes.push_back(0x00);   // Line noise between frames
+    }
+    return s;
+}
+
+static Stream synthServo() {
+    Stream s;
+    s.expectedMessages = SYNTH_SERVO_FRAMES;
+
+    for (int i = 0; i < SYNTH_SERVO_FRAMES; i++) {
+        int id = 1 + i % 4;
+        int raw = (8191 + (i * 37) % 2000 - 1000) & 0x3FFF;
+        uint8_t f[SERVO_FEEDBACK_FRAME_SIZE];
+        f[0] = (uint8_t)(SERVO_FB_OPCODE_POSITION | ((id >> 7) & 0x03));
+        f[1] = (uint8_t)(id & 0x7F);
+        f[2] = (uint8_t)((raw >> 7) & 0x7F);
+        f[3] = (uint8_t)(raw & 0x7F);
+        f[4] = 0x00;
+        f[5] = 0x00;
+        uint8_t x = 0;
+        for (int k = 0; k < 6; k++) x ^= f[k];
+        f[6] = (uint8_t)((x & 0x7F) | 0x40);
+
+        s.bytes.insert(s.bytes.end(), f, f + SERVO_FEEDBACK_FRAME_SIZE);
+        s.messageEnds.push_back(s.bytes.size());
+        if (i % 1000 == 999) s.bytes.push_back(0x15);  // No sync bit: skipped
+    }
+    return s;
+}
+
+static bool loadCapture(const char* path, Stream* s) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return false;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) s->bytes.insert(s->bytes.end(), buf, buf + n);
+    fclose(f);
+    s->expectedMessages = -1;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Writer (device side)
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct WriteLog {
+    std::vector<size_t> endOffset;      // Stream offset after each write
+    std::vector<int64_t> timeNs;        // When that write was issued
+    std::atomic<size_t> count{0};
+};
+
+static void runWriter(SerialPort* master, const Stream* s, WriteLog* log, int pacedBaud) {
+    std::vector<size_t> cuts;
+    if (!s->messageEnds.empty()) {
+        // Message-aligned writes, several messages per writev()
+        for (size_t i = MESSAGES_PER_WRITEV - 1; i < s->messageEnds.size(); i += MESSAGES_PER_WRITEV) {
+            cuts.push_back(s->messageEnds[i]);
+        }
+    } else {
+        for (size_t off = CAPTURE_CHUNK; off < s->bytes.size(); off += CAPTURE_CHUNK) cuts.push_back(off);
+    }
+    cuts.push_back(s->bytes.size());
+
+    double bytesPerNs = pacedBaud > 0 ? pacedBaud / 10.0 / 1e9 : 0.0;
+    int64_t start = nowNs();
+    size_t pos = 0;
+    size_t msg = 0;
+    struct iovec iov[MESSAGES_PER_WRITEV + 1];
+
+    for (size_t cut : cuts) {
+        if (cut <= pos) continue;
+
+        // One iovec per message (noise bytes ride with the message before them)
+        int iovcnt = 0;
+        size_t from = pos;
+        while (msg < s->messageEnds.size() && s->messageEnds[msg] <= cut && iovcnt < MESSAGES_PER_WRITEV) {
+            iov[iovcnt].iov_base = (void*)(s->bytes.data() + from);
+            iov[iovcnt].iov_len = s->messageEnds[msg] - from;
+            from = s->messageEnds[msg++];
+            iovcnt++;
+        }
+        if (from < cut) {
+            iov[iovcnt].iov_base = (void*)(s->bytes.data() + from);
+            iov[iovcnt].iov_len = cut - from;
+            iovcnt++;
+        }
+
+        if (bytesPerNs > 0) {
+            int64_t due = start + (int64_t)(pos / bytesPerNs);
+            int64_t wait = due - nowNs();
+            if (wait > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+        }
+
+        size_t k = log->count.load(std::memory_order_relaxed);
+        log->endOffset[k] = cut;
+        log->timeNs[k] = nowNs();
+        log->count.store(k + 1, std::memory_order_release);
+
+        if (serialWritev(master, iov, iovcnt, 1000) < (int)(cut - pos)) {
+            fprintf(stderr, "pty write stalled at %zu\n", pos);
+            return;
+        }
+        pos = cut;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Reader (app side)
+// ═══════════════════════════════════════════════════════════════════════════
+
+static int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || (strcmp(argv[1], "gnss") != 0 && strcmp(argv[1], "servo") != 0)) {
+        fprintf(stderr, "Usage: %s <gnss|servo> [capture.bin] [--paced BAUD]\n", argv[0]);
+        return 2;
+    }
+    bool gnss = strcmp(argv[1], "gnss") == 0;
+    const char* capture = nullptr;
+    int pacedBaud = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--paced") == 0 && i + 1 < argc) {
+            pacedBaud = atoi(argv[++i]);
+        } else {
+            capture = argv[i];
+        }
+    }
+
+    Stream stream;
+    if (capture != nullptr) {
+        if (!loadCapture(capture, &stream)) {
+            fprintf(stderr, "Cannot read %s\n", capture);
+            return 2;
+        }
+    } else {
+        stream = gnss ? synthGnss() : synthServo();
+    }
+
+    SerialPty pty;
+    if (serialOpenPty(&pty) != 0) {
+        perror("pty");
+        return 2;
+    }
+    SerialPort* device = serialWrap(pty.masterFd, 1);
+    SerialPort* port = serialOpen(pty.slavePath, 115200);
+    if (device == nullptr || port == nullptr) return 2;
+
+    KcaParser kca;
+    kcaParserInit(&kca, nullptr, nullptr);
+    ServoStreamParser servo;
+    servoStreamInit(&servo);
+    ServoStreamEvent events[4096];
+
+    WriteLog log;
+    log.endOffset.resize(stream.bytes.size() / 64 + 16);
+    log.timeNs.resize(log.endOffset.size());
+
+    std::vector<int64_t> latencyNs;
+    std::vector<uint8_t> buf(SERIAL_READ_CHUNK);
+    size_t received = 0;
+    size_t logIndex = 0;
+    long messages = 0;
+    int64_t parseNs = 0;
+
+    std::thread writer(runWriter, device, &stream, &log, pacedBaud);
+    int64_t start = nowNs();
+
+    while (received < stream.bytes.size()) {
+        int n = serialRead(port, buf.data(), (int)buf.size(), 1000);
+        if (n <= 0) break;
+        received += n;
+
+        int64_t t0 = nowNs();
+        int completed = gnss ? kcaParse(&kca, buf.data(), n)
+                             : servoStreamParse(&servo, buf.data(), n, events, 4096);
+        int64_t t1 = nowNs();
+        parseNs += t1 - t0;
+        messages += completed;
+
+        // Latency of the newest byte: find the write that carried it
+        size_t published = log.count.load(std::memory_order_acquire);
+        while (logIndex < published && log.endOffset[logIndex] < received) logIndex++;
+        if (completed > 0 && logIndex < published) latencyNs.push_back(t1 - log.timeNs[logIndex]);
+    }
+    double elapsed = (nowNs() - start) / 1e9;
+    writer.join();
+
+    SerialStats rs, ws;
+    serialGetStats(port, &rs);
+    serialGetStats(device, &ws);
+
+    printf("Stream: %s, %zu bytes%s%s\n", gnss ? "GNSS/KCA" : "servo feedback", stream.bytes.size(),
+           capture ? " from " : " (synthetic)", capture ? capture : "");
+    if (pacedBaud > 0) printf("Paced at %d baud (%d B/s)\n", pacedBaud, pacedBaud / 10);
+    printf("Received %zu bytes in %.3f s (%.1f MB/s end-to-end)\n", received, elapsed, received / elapsed / 1e6);
+    printf("Messages: %ld", messages);
+    if (stream.expectedMessages >= 0) printf(" of %ld%s", stream.expectedMessages,
+                                             messages == stream.expectedMessages ? " (all)" : " (MISSING)");
+    printf("\n");
+    if (gnss) {
+        printf("KCA: %llu CRC-valid, %llu accepted fixes, %llu frame errors\n",
+               (unsigned long long)kca.messages, (unsigned long long)kca.navAccepted,
+               (unsigned long long)kca.frameErrors);
+    } else {
+        printf("Servo: %llu frames, %llu checksum errors\n",
+               (unsigned long long)servo.framesParsed, (unsigned long long)servo.checksumErrors);
+    }
+    printf("Parser: %.1f MB/s, %.0f ns/message (CPU time in parser)\n",
+           parseNs > 0 ? received / (parseNs / 1e9) / 1e6 : 0.0, messages > 0 ? (double)parseNs / messages : 0.0);
+    printf("Latency write->parsed (us): p50 %.1f  p99 %.1f  max %.1f  (%zu reads)\n",
+           percentile(latencyNs, 0.50) / 1e3, percentile(latencyNs, 0.99) / 1e3,
+           percentile(latencyNs, 1.0) / 1e3, latencyNs.size());
+    printf("Reader: %llu reads, %llu epoll waits (%.0f B/read); writer: %llu writev, %llu partial\n",
+           (unsigned long long)rs.readCalls, (unsigned long long)rs.waits,
+           rs.readCalls ? (double)rs.bytesRead / rs.readCalls : 0.0,
+           (unsigned long long)ws.writeCalls, (unsigned long long)ws.partialWrites);
+
+    serialClose(port);
+    serialClose(device);
+    bool ok = stream.expectedMessages < 0 || messages == stream.expectedMessages;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/**
+ * series_decimate_bench.cpp
+ * Chart Series Decimation Benchmark (host)
+ *
+ * Fills series_store with 100 Hz servo-like feedback (sweep + noise +
+ * short spikes) and times LTTB / min-max reductions to a chart width,
+ * for growing history lengths, over the 10 s chart window and over the
+ * whole history. Checks the point count, that the envelope keeps the
+ * global extremes, and that x is ordered and inside the window.
+ *
+ * Then decimates while a writer thread appends as fast as it can
+ * (overwriting the ring) to check reads never return torn windows.
+ *
+ *   series_decimate_bench [--points N] [--capacity N]
+ */
+
+#include "series_store.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static const int64_t SAMPLE_US = 10000;     // 100 Hz feedback
+static const int64_t WINDOW_US = 10000000;  // GraphActivity.VISIBLE_RANGE
+
+static float signal(int64_t i, uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    float noise = ((float)(*seed >> 8) / 16777216.0f - 0.5f) * 0.6f;
+    float v = 20.0f * sinf((float)i * 0.004f) + noise;
+    if (i % 997 == 500) v += 4.0f;   // One-sample overshoot
+    return v;
+}
+
+static bool checkOutput(const float* x, int n, int64_t fromUs, int64_t toUs) {
+    float lo = (float)(fromUs - toUs) * 1e-6f - 1e-3f;
+    for (int i = 0; i < n; i++) {
+        if (x[i] < lo || x[i] > 1e-3f) return false;
+        if (i > 0 && x[i] < x[i - 1]) return false;
+    }
+    return true;
+}
+
+static double timeUs(int repeats, const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main(int argc, char** argv) {
+    int points = 400;
+    int capacity = 1 << 20;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) points = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) capacity = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--points N] [--capacity N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (points < 4 || capacity < 1024) return 2;
+    if (!seriesStoreInit(2, capacity)) return 1;
+
+    std::vector<float> x(points), y(points);
+    bool ok = true;
+
+    printf("Decimating to %d points (chart width), 100 Hz samples\n", points);
+    printf("%9s %8s | %12s %12s | %12s %12s\n", "history", "window", "lttb 10s us", "minmax 10s us",
+           "lttb all us", "minmax all us");
+
+    const int histories[] = {1000, 10000, 100000, 1000000};
+    for (int history : histories) {
+        if (history > capacity) break;
+        seriesStoreClear();
+        uint32_t seed = 1;
+        float maxValue = -1e9f, minValue = 1e9f;
+        for (int64_t i = 0; i < history; i++) {
+            float v = signal(i, &seed);
+            seriesStoreAppend(0, i * SAMPLE_US, v);
+            maxValue = fmaxf(maxValue, v);
+            minValue = fminf(minValue, v);
+        }
+        int64_t toUs = (int64_t)(history - 1) * SAMPLE_US;
+        int64_t windowFrom = toUs - WINDOW_US;
+        int held = seriesStoreCount(0);
+
+        int n = 0;
+        double lttbWindow = timeUs(50, [&] { n = seriesStoreDecimate(0, windowFrom, toUs, SERIES_DECIMATE_LTTB,
+                                                                     points, x.data(), y.data()); });
+        int inWindow = history < WINDOW_US / SAMPLE_US ? history : (int)(WINDOW_US / SAMPLE_US) + 1;
+        int expected = inWindow < points ? inWindow : points;
+        if (n != expected || !checkOutput(x.data(), n, windowFrom, toUs)) {
+            printf("  LTTB window: %d points (expected %d)  MISMATCH\n", n, expected);
+            ok = false;
+        }
+        double minMaxWindow = timeUs(50, [&] { n = seriesStoreDecimate(0, windowFrom, toUs, SERIES_DECIMATE_MINMAX,
+                                                                       points, x.data(), y.data()); });
+        if (n > points || !checkOutput(x.data(), n, windowFrom, toUs)) ok = false;
+
+        int64_t allFrom = toUs - (int64_t)held * SAMPLE_US;
+        double lttbAll = timeUs(5, [&] { n = seriesStoreDecimate(0, allFrom, toUs, SERIES_DECIMATE_LTTB,
+                                                                  points, x.data(), y.data()); });
+        if (n != (held < points ? held : points)) {
+            printf("  LTTB all: %d points  MISMATCH\n", n);
+            ok = false;
+        }
+        double minMaxAll = timeUs(5, [&] { n = seriesStoreDecimate(0, allFrom, toUs, SERIES_DECIMATE_MINMAX,
+                                                                    points, x.data(), y.data()); });
+        float envMax = -1e9f, envMin = 1e9f;
+        for (int i = 0; i < n; i++) {
+            envMax = fmaxf(envMax, y[i]);
+            envMin = fminf(envMin, y[i]);
+        }
+        if (held == history && (envMax != maxValue || envMin != minValue)) {
+            printf("  Envelope lost an extreme (%.2f..%.2f vs %.2f..%.2f)  MISMATCH\n", envMin, envMax, minValue,
+                   maxValue);
+            ok = false;
+        }
+
+        printf("%9d %8d | %12.1f %12.1f | %12.1f %12.1f\n", history, inWindow, lttbWindow, minMaxWindow, lttbAll,
+               minMaxAll);
+    }
+
+    // Writer overwriting the ring while the chart reads
+    seriesStoreClear();
+    std::atomic<bool> stop(false);
+    std::atomic<int64_t> written(0);
+    std::thread writer([&] {
+        uint32_t seed = 7;
+        for (int64_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+            seriesStoreAppend(1, i * SAMPLE_US, signal(i, &seed));
+            written.store(i, std::memory_order_relaxed);
+        }
+    });
+    int reads = 0, bad = 0;
+    auto until = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < until) {
+        int64_t toUs = written.load(std::memory_order_relaxed) * SAMPLE_US;
+        int n = seriesStoreDecimate(1, toUs - WINDOW_US, toUs, SERIES_DECIMATE_MINMAX, points, x.data(), y.data());
+        if (!checkOutput(x.data(), n, toUs - WINDOW_US, toUs)) bad++;
+        for (int i = 0; i < n; i++) {
+            if (fabsf(y[i]) > 25.0f) bad++;
+        }
+        reads++;
+    }
+    stop = true;
+    writer.join();
+    printf("Concurrent writer: %lld samples appended, %d reads, %d bad\n", (long long)written.load(), reads, bad);
+    if (bad > 0) ok = false;
+
+    printf("%s\n", ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,507 @@
+/**
+ * servo_bus_sim.cpp
+ * Bridge Servo Bus Simulation (host)
+ *
+ * Runs the CAN-to-RS232 bridge firmware (Core/Src/servo_bus.c, can_bridge.c,
+ * node_config.c, servo_driver.c) unchanged on the HAL stub (hal_stub/) and
+ * plays its surroundings:
+ *   phone   - one position SDO per channel every period (0x600 + node),
+ *             back to back on a 500 kbit/s bus, into the CAN RX FIFO
+ *   servos  - wired as the node map says; each decodes the 5-byte packet
+ *             the firmware put on its UART and answers with a 7-byte
+ *             feedback frame, handed over on the idle line
+ *   CAN TX  - the mailboxes drain one frame time apart
+ * The main loop is main.c's: ServoBus_Process + NodeConfig_Process, every
+ * --loop us. Each HAL call costs --hal us and is a point where pending
+ * interrupts run, so the CAN RX / UART interrupts preempt the main loop.
+ *
+ * The map is written the way the phone does it: SDO writes to the bridge's
+ * base, "save", then checked live and after a reload from flash.
+ * Assignments: single (serial IDs 1..n on USART2); on the dual-bus build
+ * (servo_bus_sim_dual) the firmware default map extended to n servos, and
+ * dual-ids (the same serial IDs on both buses, base 9).
+ *
+ * Checks that every command reaches the servo of its channel, that each bus
+ * keeps its own pacing, that every feedback frame comes back on the channel
+ * of the servo that sent it, and that a single-bus build rejects a map entry
+ * naming USART3.
+ *
+ *   servo_bus_sim[_dual] [--periods N] [--period US] [--servos N]
+ *                        [--loop US] [--hal US] [--resp US]
+ */
+
+extern "C" {
+#include "can_bridge.h"
+#include "hal_stub.h"
+#include "node_config.h"
+#include "servo_bus.h"
+#include "servo_driver.h"
+}
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+static const double CAN_BIT_US = 2.0;              // 500 kbit/s
+static const double UART_CHAR_US = 10e6 / 115200;  // 8N1 at 115200 baud
+
+// Standard data frame: 47 fixed bits + data, stuffing on the 34 + 8n stuffable bits
+static double frameUs(int dlc) {
+    int stuffable = 34 + 8 * dlc;
+    return (47 + 8 * dlc + stuffable / 5 + 3) * CAN_BIT_US;
+}
+
+static double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Board (main.c globals)
+// ═══════════════════════════════════════════════════════════════════════════
+
+extern "C" {
+CAN_HandleTypeDef hcan1;
+UART_HandleTypeDef huart2;
+UART_HandleTypeDef huart3;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart3_rx;
+volatile uint8_t blinkServoId = 0;
+volatile uint8_t feedbackDebugBlink = 0;
+}
+
+static UART_HandleTypeDef* const busUart[2] = {&huart2, &huart3};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Surroundings
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct MapEntry {
+    int serialId;
+    int bus;
+};
+
+struct Assignment {
+    const char* name;
+    int nodeBase;
+    int servoCount;
+    MapEntry map[NODE_CONFIG_MAX_SERVOS];   // Also the wiring
+};
+
+struct SentCommand {
+    int position;
+    double canUs;
+};
+
+struct Reply {
+    int channel;
+    int position;
+    double canUs;       // SDO that caused it
+    double doneUs;      // Idle line after the last byte
+    uint8_t bytes[FEEDBACK_FRAME_LEN];
+};
+
+struct BusSide {
+    uint32_t txSeen = 0;
+    bool txActive = false;
+    double txEndUs = 0;
+    double rxLineFreeUs = 0;
+    std::deque<Reply> wire;
+
+    // Stats
+    long sent = 0;
+    long replies = 0;
+    long published = 0;
+    double lastTxUs = -1;
+    double minGapUs = 1e300;
+    double maxGapUs = 0;
+};
+
+struct SdoFrame {
+    double atUs;
+    uint32_t stdId;
+    uint8_t data[8];
+};
+
+struct RunStats {
+    long misdirected = 0;     // Packet for a servo not wired on that bus, or not its channel's command
+    long misrouted = 0;       // Feedback published on another servo's channel
+    long badPackets = 0;      // Sync / checksum errors on the servo side
+    int silent = 0;           // Channels that never reported
+    std::vector<double> latencyUs;    // SDO → feedback frame out of the mailbox
+    std::vector<double> updateUs;     // Feedback interval per channel
+};
+
+static double nowUs = 0;
+static double halCallUs = 1;
+static double respUs = 300;
+static bool inHook = false;
+
+static const Assignment* wiring = nullptr;
+static std::deque<SdoFrame> canRx;
+static BusSide busSide[SERVO_BUS_COUNT];
+static std::vector<std::deque<SentCommand>> pending;   // Per channel: SDOs not yet seen by a servo
+static std::vector<std::deque<Reply>> replied;         // Per channel: feedback not yet on CAN
+static std::vector<double> lastPublish;
+static std::vector<long> perChannel;
+static double canTxFreeUs = 0;
+static RunStats* stats = nullptr;
+
+static int wiredChannel(int bus, int serialId) {
+    for (int i = 0; wiring && i < wiring->servoCount; i++) {
+        if (wiring->map[i].bus == bus && wiring->map[i].serialId == serialId) return i;
+    }
+    return -1;
+}
+
+// The servo took a 5-byte packet: move, then answer after respUs
+static void servoReceive(int b, const uint8_t* p, uint16_t len) {
+    if (len != SERVO_PACKET_LEN || !(p[0] & 0x80) || p[4] != ((p[0] ^ p[1] ^ p[2] ^ p[3]) & 0x7F)) {
+        stats->badPackets++;
+        return;
+    }
+    int serialId = p[1] & 0x7F;
+    int position = ((p[2] & 0x7F) << 7) | (p[3] & 0x7F);
+
+    int ch = wiredChannel(b, serialId);
+    if (ch < 0) {
+        stats->misdirected++;
+        return;
+    }
+
+    // Commands the queue dropped never arrive; anything else out of order is misdirected
+    std::deque<SentCommand>& q = pending[ch];
+    while (!q.empty() && q.front().position != position) q.pop_front();
+    if (q.empty()) {
+        stats->misdirected++;
+        return;
+    }
+    double canUs = q.front().canUs;
+    q.pop_front();
+
+    BusSide& side = busSide[b];
+    Reply r = {};
+    r.channel = ch;
+    r.position = position;
+    r.canUs = canUs;
+    double start = std::max(nowUs + respUs, side.rxLineFreeUs);
+    side.rxLineFreeUs = start + FEEDBACK_FRAME_LEN * UART_CHAR_US;
+    r.doneUs = side.rxLineFreeUs + UART_CHAR_US;
+    r.bytes[0] = 0x80 | 0x08;
+    r.bytes[1] = (uint8_t)serialId;
+    r.bytes[2] = (position >> 7) & 0x7F;
+    r.bytes[3] = position & 0x7F;
+    r.bytes[6] = (r.bytes[0] ^ r.bytes[1] ^ r.bytes[2] ^ r.bytes[3]) & 0x7F;
+    side.wire.push_back(r);
+}
+
+// Feedback frame left the mailbox: which channel, and whose position?
+static void canPublished(const HalStubCanFrame& f) {
+    int ch = (int)f.stdId - FEEDBACK_RX_OFFSET - wiring->nodeBase;
+    if (f.dlc != 8 || ch < 0 || ch >= wiring->servoCount) {
+        stats->misrouted++;
+        return;
+    }
+    int position = f.data[0] | (f.data[1] << 8);
+
+    std::deque<Reply>& q = replied[ch];
+    while (!q.empty() && q.front().position != position) q.pop_front();
+    if (q.empty()) {
+        stats->misrouted++;
+        return;
+    }
+    busSide[wiring->map[ch].bus].published++;
+    stats->latencyUs.push_back(nowUs - q.front().canUs);
+    q.pop_front();
+
+    if (lastPublish[ch] >= 0) stats->updateUs.push_back(nowUs - lastPublish[ch]);
+    lastPublish[ch] = nowUs;
+    perChannel[ch]++;
+}
+
+// Hardware side up to nowUs: frames in, UART transfers, idle lines, mailboxes
+static void service() {
+    HalStub_SetTimeUs((uint64_t)nowUs);
+
+    while (!canRx.empty() && canRx.front().atUs <= nowUs) {
+        SdoFrame f = canRx.front();
+        canRx.pop_front();
+        HalStub_CanReceive(&hcan1, f.stdId, f.data, 8);
+    }
+
+    for (int b = 0; b < SERVO_BUS_COUNT; b++) {
+        BusSide& side = busSide[b];
+        const HalStubUart* u = HalStub_Uart(busUart[b]);
+
+        if (u->txStarts != side.txSeen) {
+            side.txSeen = u->txStarts;
+            side.txActive = true;
+            side.txEndUs = u->txStartUs + u->txLen * UART_CHAR_US;
+            side.sent++;
+            if (side.lastTxUs >= 0) {
+                double gap = u->txStartUs - side.lastTxUs;
+                side.minGapUs = std::min(side.minGapUs, gap);
+                side.maxGapUs = std::max(side.maxGapUs, gap);
+            }
+            side.lastTxUs = u->txStartUs;
+        }
+        if (side.txActive && side.txEndUs <= nowUs) {
+            side.txActive = false;
+            servoReceive(b, u->tx, u->txLen);
+            HalStub_UartTxDone(busUart[b]);
+        }
+
+        while (!side.wire.empty() && side.wire.front().doneUs <= nowUs) {
+            Reply r = side.wire.front();
+            side.wire.pop_front();
+            side.replies++;
+            replied[r.channel].push_back(r);
+            HalStub_UartIdle(busUart[b], r.bytes, FEEDBACK_FRAME_LEN);
+        }
+    }
+
+    while (HalStub_CanTxPending() > 0 && canTxFreeUs <= nowUs) {
+        HalStubCanFrame f;
+        HalStub_CanTxComplete(&hcan1, &f);
+        canTxFreeUs = nowUs + frameUs(f.dlc);
+        canPublished(f);
+    }
+}
+
+// Every HAL call from the firmware: time passes, interrupts may fire
+static void onHalCall() {
+    if (inHook) return;
+    inHook = true;
+    nowUs += halCallUs;
+    service();
+    inHook = false;
+}
+
+// One pass of main.c's while (1)
+static void mainLoopPass(double loopUs) {
+    ServoBus_Process();
+    NodeConfig_Process();
+    blinkServoId = 0;
+    feedbackDebugBlink = 0;
+
+    nowUs += loopUs;
+    inHook = true;
+    service();
+    inHook = false;
+}
+
+static void runFor(double us, double loopUs) {
+    double end = nowUs + us;
+    while (nowUs < end) mainLoopPass(loopUs);
+}
+
+static void sendSdo(int node, uint16_t index, uint8_t sub, uint32_t value) {
+    SdoFrame f = {nowUs, 0x600u + node, {0x22, (uint8_t)index, (uint8_t)(index >> 8), sub,
+                                         (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16),
+                                         (uint8_t)(value >> 24)}};
+    canRx.push_back(f);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Node Map
+// ═══════════════════════════════════════════════════════════════════════════
+
+static bool liveMapIs(const Assignment& a) {
+    if (nodeConfig.nodeBase != a.nodeBase || nodeConfig.servoCount != a.servoCount) return false;
+    for (int i = 0; i < a.servoCount; i++) {
+        if (nodeConfig.map[i].serialId != a.map[i].serialId || nodeConfig.map[i].bus != a.map[i].bus) return false;
+    }
+    return true;
+}
+
+// Map entries, count, base, then "save" to the new base
+static bool configure(const Assignment& a, double loopUs) {
+    int base = nodeConfig.nodeBase;
+    for (int i = 0; i < a.servoCount; i++) {
+        sendSdo(base, NODE_CONFIG_SDO_INDEX, NODE_CONFIG_SDO_SUB_MAP + i,
+                (uint32_t)(a.map[i].serialId | (a.map[i].bus << 4)));
+    }
+    sendSdo(base, NODE_CONFIG_SDO_INDEX, NODE_CONFIG_SDO_SUB_COUNT, (uint32_t)a.servoCount);
+    sendSdo(base, NODE_CONFIG_SDO_INDEX, NODE_CONFIG_SDO_SUB_BASE, (uint32_t)a.nodeBase);
+    sendSdo(a.nodeBase, NODE_CONFIG_SDO_STORE, 0x01, 0x65766173);  // "save"
+
+    uint32_t erases = HalStub_Stats()->flashErases;
+    runFor(2000, loopUs);
+    if (!liveMapIs(a) || HalStub_Stats()->flashErases == erases) return false;
+
+    // What the next boot loads
+    NodeConfig_Load();
+    return liveMapIs(a);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Run
+// ═══════════════════════════════════════════════════════════════════════════
+
+static void runTraffic(const Assignment& a, int periods, double periodUs, double loopUs, RunStats* s) {
+    stats = s;
+    wiring = &a;
+    pending.assign(a.servoCount, {});
+    replied.assign(a.servoCount, {});
+    lastPublish.assign(a.servoCount, -1);
+    perChannel.assign(a.servoCount, 0);
+    for (BusSide& side : busSide) {
+        uint32_t seen = side.txSeen;
+        side = BusSide();
+        side.txSeen = seen;
+    }
+
+    uint32_t seed = 12345;
+    double t0 = nowUs + 1000;
+    for (int p = 0; p < periods; p++) {
+        double t = t0 + p * periodUs;
+        for (int ch = 0; ch < a.servoCount; ch++) {
+            seed = seed * 1664525u + 1013904223u;
+            int32_t canValue = (int32_t)((seed >> 8) % 4001) - 2000;
+            t += frameUs(8);
+            SdoFrame f = {t, 0x600u + a.nodeBase + ch, {0x22, 0x03, 0x60, 0x00, (uint8_t)canValue,
+                                                         (uint8_t)(canValue >> 8), (uint8_t)(canValue >> 16),
+                                                         (uint8_t)(canValue >> 24)}};
+            canRx.push_back(f);
+            pending[ch].push_back({canValue * 4 + SERVO_CENTER_POS, t});
+        }
+    }
+
+    runFor(t0 - nowUs + periods * periodUs + 50000, loopUs);
+
+    for (int ch = 0; ch < a.servoCount; ch++) {
+        if (perChannel[ch] == 0) s->silent++;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Main
+// ═══════════════════════════════════════════════════════════════════════════
+
+int main(int argc, char** argv) {
+    int periods = 500;
+    double periodUs = 20000;
+    int servos = 4;
+    double loopUs = 20;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--periods") == 0 && i + 1 < argc) periods = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--period") == 0 && i + 1 < argc) periodUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--servos") == 0 && i + 1 < argc) servos = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--loop") == 0 && i + 1 < argc) loopUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--hal") == 0 && i + 1 < argc) halCallUs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--resp") == 0 && i + 1 < argc) respUs = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--periods N] [--period US] [--servos N] [--loop US] [--hal US] [--resp US]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (periods < 1 || periodUs <= 0 || servos < 1 || servos > NODE_CONFIG_MAX_SERVOS || loopUs <= 0 ||
+        halCallUs < 0) {
+        return 2;
+    }
+
+    if (!HalStub_Reset()) {
+        fprintf(stderr, "Cannot map the flash at 0x%08lX\n", (unsigned long)FLASH_BASE);
+        return 1;
+    }
+    HalStub_UartInit(&huart2);
+    HalStub_UartInit(&huart3);
+    HalStub_SetHook(onHalCall);
+
+    // main(): erased flash → defaults, then the servo UARTs
+    NodeConfig_Load();
+    bool ok = ServoBus_Start() == HAL_OK;
+
+    bool defaults = nodeConfig.nodeBase == 1 && nodeConfig.servoCount == 4;
+    for (int i = 0; i < 4 && defaults; i++) {
+        int bus = (SERVO_BUS_COUNT > 1 && i + 1 >= BRIDGE_BUS2_FIRST_SERVO) ? 1 : 0;
+        defaults = nodeConfig.map[i].serialId == i + 1 && nodeConfig.map[i].bus == bus;
+    }
+    if (!defaults) ok = false;
+
+    Assignment single = {"single", 1, servos, {}};
+    Assignment dual = {"dual", 1, servos, {}};
+    Assignment dualIds = {"dual-ids", 9, servos, {}};
+    int half = (servos + 1) / 2;
+    for (int i = 0; i < servos; i++) {
+        single.map[i] = {i + 1, 0};
+        dual.map[i] = {i + 1, (i + 1 >= BRIDGE_BUS2_FIRST_SERVO) ? 1 : 0};
+        dualIds.map[i] = {i % half + 1, i < half ? 0 : 1};
+    }
+    std::vector<const Assignment*> runs;
+    if (SERVO_BUS_COUNT == 1) runs = {&single};
+    else runs = {&dual, &dualIds};
+
+    printf("%d-bus build, default map %s. %d servos, one SDO each every %.1f ms, %d ms per bus pacing,\n"
+           "main loop %.0f us, HAL call %.1f us, servo reply %.0f us\n",
+           SERVO_BUS_COUNT, defaults ? "OK" : "WRONG", servos, periodUs / 1000, SERVO_BUS_MIN_CMD_INTERVAL_MS,
+           loopUs, halCallUs, respUs);
+    printf("%-9s %3s %9s %6s %8s %8s %8s %9s %9s %9s\n",
+           "map", "bus", "serial", "sent", "gap min", "gap max", "fb lost", "lat p50", "lat p99", "upd max");
+
+    for (const Assignment* a : runs) {
+        if (!configure(*a, loopUs)) {
+            printf("%-9s     map not applied / not stored\n", a->name);
+            ok = false;
+            continue;
+        }
+
+        RunStats s;
+        uint32_t dropped = bridgeStats.commandsDropped;
+        uint32_t unmapped = bridgeStats.feedbackUnmapped;
+        uint32_t canTxDropped = bridgeStats.canTxDropped;
+        runTraffic(*a, periods, periodUs, loopUs, &s);
+        dropped = bridgeStats.commandsDropped - dropped;
+        unmapped = bridgeStats.feedbackUnmapped - unmapped;
+        canTxDropped = bridgeStats.canTxDropped - canTxDropped;
+
+        double latP50 = percentile(s.latencyUs, 0.50);
+        double latP99 = percentile(s.latencyUs, 0.99);
+        double updMax = percentile(s.updateUs, 1.0);
+        for (int b = 0; b < SERVO_BUS_COUNT; b++) {
+            const BusSide& side = busSide[b];
+            char ids[32] = "";
+            for (int i = 0; i < a->servoCount; i++) {
+                if (a->map[i].bus != b) continue;
+                size_t n = strlen(ids);
+                snprintf(ids + n, sizeof(ids) - n, n ? ",%d" : "%d", a->map[i].serialId);
+            }
+            bool used = ids[0] != '\0';
+            bool paced = side.sent < 2 || side.minGapUs >= (SERVO_BUS_MIN_CMD_INTERVAL_MS - 1) * 1000.0;
+            if (!paced || used != (side.sent > 0)) ok = false;
+            printf("%-9s %3d %9s %6ld %7.2fms %7.2fms %8ld %7.2fms %7.2fms %7.2fms\n",
+                   a->name, b, used ? ids : "-", side.sent, side.sent < 2 ? 0 : side.minGapUs / 1000,
+                   side.maxGapUs / 1000, side.replies - side.published, latP50 / 1000, latP99 / 1000,
+                   updMax / 1000);
+        }
+        printf("%-9s     queue drops %u, CAN TX drops %u, misdirected %ld, misrouted %ld, unmapped %u, "
+               "bad packets %ld, silent channels %d\n",
+               a->name, dropped, canTxDropped, s.misdirected, s.misrouted, unmapped, s.badPackets, s.silent);
+        if (s.misdirected || s.misrouted || unmapped || s.badPackets || s.silent) ok = false;
+    }
+
+    // A map entry naming USART3 never goes live on a single-bus build
+    if (SERVO_BUS_COUNT == 1) {
+        sendSdo(nodeConfig.nodeBase, NODE_CONFIG_SDO_INDEX, NODE_CONFIG_SDO_SUB_MAP, 1u | (1u << 4));
+        runFor(1000, loopUs);
+        bool rejected = nodeConfig.map[0].bus == 0;
+        printf("USART3 map entry on a single-bus build: %s\n", rejected ? "rejected" : "ACCEPTED");
+        if (!rejected) ok = false;
+    }
+
+    const HalStubStats* hal = HalStub_Stats();
+    printf("HAL: CAN RX overruns %u, UART RX bytes lost %u, UART busy %u, IRQ masked max %llu us\n",
+           hal->canRxOverruns, hal->uartRxLost, hal->uartTxBusy, (unsigned long long)hal->irqMaskedMaxUs);
+    if (hal->canRxOverruns || hal->uartRxLost || hal->uartTxBusy) ok = false;
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
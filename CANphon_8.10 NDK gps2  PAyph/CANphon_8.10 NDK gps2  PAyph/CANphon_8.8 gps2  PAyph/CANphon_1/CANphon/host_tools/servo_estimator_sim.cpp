@@ -0,0 +1,207 @@
+/**
+ * servo_estimator_sim.cpp
+ * Servo Response Estimator Check (host)
+ *
+ * Drives servo_estimator with a simulated actuator: dead time, first-order
+ * response, slew limit and a fixed offset (steady-state error). Commands
+ * go through the real position command frames at the guidance rate
+ * (with SharedBusManager's 1° send filter); feedback is quantized like
+ * the bridge's 14-bit position and sampled at the feedback rate.
+ *
+ * Scenarios: triangle sweep (lag), steps (steady error), a jammed servo
+ * (stall), a command beyond travel (saturation), a fast step (rate limit).
+ * Prints estimated vs model values and exits 1 if one is off.
+ *
+ *   servo_estimator_sim [--dead MS] [--tau MS] [--slew DPS] [--offset DEG]
+ */
+
+#include "can_dispatch.h"
+#include "servo_estimator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int64_t STEP_US = 1000;            // Simulation step
+static const int64_t COMMAND_PERIOD_US = 20000; // 50 Hz guidance
+static const int64_t FEEDBACK_PERIOD_US = 10000;  // 100 Hz bridge feedback
+static const float SEND_FILTER_DEG = 1.0f;      // SharedBusManager.sendAllServoCommands
+
+struct ServoModel {
+    double deadMs = 20;
+    double tauMs = 40;
+    double slewDps = 300;
+    double offsetDeg = 0.4;
+    bool jammed = false;
+    double position = 0;
+    double pending[1024];       // Dead-time delay line, one entry per step
+    int head = 0;
+
+    void reset(double angle) {
+        position = angle;
+        for (double& p : pending) p = angle;
+    }
+
+    // Advance one step with `command` as the newest target
+    void step(double command) {
+        int delaySteps = (int)(deadMs * 1000 / STEP_US);
+        pending[head % 1024] = command;
+        double target = pending[(head - delaySteps + 1024 * 4) % 1024] + offsetDeg;
+        head++;
+        if (jammed) return;
+
+        double dt = STEP_US * 1e-6;
+        double rate = (target - position) / (tauMs * 1e-3);
+        if (rate > slewDps) rate = slewDps;
+        if (rate < -slewDps) rate = -slewDps;
+        position += rate * dt;
+        if (position > 25) position = 25;
+        if (position < -25) position = -25;
+    }
+};
+
+// CANServoProtocol.createPositionCommand
+static void positionCommand(int nodeId, float angle, WsCanFrame* f) {
+    if (angle < -25) angle = -25;
+    if (angle > 25) angle = 25;
+    int target = (int)((angle + 25) / 50 * 16383);
+    int value = (target - 8191) / 4;
+    f->id = 0x600 + nodeId;
+    f->dlc = 8;
+    f->flags = 0;
+    uint8_t d[8] = {0x22, 0x03, 0x60, 0x00, (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16),
+                    (uint8_t)(value >> 24)};
+    memcpy(f->data, d, 8);
+}
+
+struct Result {
+    CanServoEstimate estimate;
+    uint32_t flagsSeen;         // OR of flags over the last second
+    int commandsSent;
+};
+
+// Run `seconds` of the command function through the model and estimator
+template <typename CommandFn>
+static Result run(ServoModel& servo, double seconds, CommandFn commandAt) {
+    servoEstimatorReset();
+    servoEstimatorSetChannel(0x601, 0);
+    servo.reset(commandAt(0.0));
+
+    Result r = {};
+    float lastSent = 1e9f;
+    double command = commandAt(0.0);
+    int64_t endUs = (int64_t)(seconds * 1e6);
+    for (int64_t t = 0; t < endUs; t += STEP_US) {
+        if (t % COMMAND_PERIOD_US == 0) {
+            float wanted = (float)commandAt(t * 1e-6);
+            if (fabsf(wanted - lastSent) > SEND_FILTER_DEG) {
+                WsCanFrame f;
+                positionCommand(1, wanted, &f);
+                servoEstimatorCommandFrames(&f, 1, t);
+                servoEstimatorParseCommand(f.dlc, f.data, &lastSent);
+                command = lastSent;
+                r.commandsSent++;
+            }
+        }
+        servo.step(command);
+        if (t % FEEDBACK_PERIOD_US == 0) {
+            int raw = (int)((servo.position + 25) / 50 * 16383);
+            servoEstimatorFeedback(0, (float)raw / 16383.0f * 50 - 25, t);
+            if (t >= endUs - 1000000) r.flagsSeen |= canDispatchShared()->estimate[0].flags;
+        }
+    }
+    r.estimate = canDispatchShared()->estimate[0];
+    return r;
+}
+
+static bool check(const char* name, double value, double expected, double tolerance) {
+    bool ok = fabs(value - expected) <= tolerance;
+    printf("  %-22s %8.2f  (model %.2f ± %.2f)%s\n", name, value, expected, tolerance, ok ? "" : "  MISMATCH");
+    return ok;
+}
+
+static bool checkFlag(const char* name, uint32_t flags, uint32_t flag, bool expected) {
+    bool ok = ((flags & flag) != 0) == expected;
+    printf("  %-22s %8s  (expected %s)%s\n", name, flags & flag ? "set" : "clear", expected ? "set" : "clear",
+           ok ? "" : "  MISMATCH");
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    ServoModel base;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dead") == 0 && i + 1 < argc) base.deadMs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--tau") == 0 && i + 1 < argc) base.tauMs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--slew") == 0 && i + 1 < argc) base.slewDps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--offset") == 0 && i + 1 < argc) base.offsetDeg = atof(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--dead MS] [--tau MS] [--slew DPS] [--offset DEG]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (base.deadMs < 0 || base.deadMs > 500 || base.tauMs <= 0) return 2;
+    canDispatchReset();
+    bool ok = true;
+
+    printf("Servo model: dead %.0f ms, tau %.0f ms, slew %.0f deg/s, offset %.2f deg\n",
+           base.deadMs, base.tauMs, base.slewDps, base.offsetDeg);
+
+    // Triangle ±15° at 40°/s: a first-order servo trails a ramp by tau, and
+    // the 1° send filter turns the ramp into a staircase (half an update later)
+    {
+        ServoModel s = base;
+        double seconds = 12.0;
+        Result r = run(s, seconds, [](double t) {
+            double phase = fmod(t, 1.5) / 1.5;
+            return phase < 0.5 ? -15 + 60 * phase : 45 - 60 * phase;
+        });
+        double updateMs = seconds * 1000 / r.commandsSent;
+        double expected = base.deadMs + base.tauMs + updateMs / 2;
+        printf("Triangle sweep (%u lag samples, command every %.0f ms):\n", r.estimate.lagSamples, updateMs);
+        ok = check("lag ms", r.estimate.lagMs, expected, 0.2 * expected + 5) && ok;
+        ok = check("peak rate deg/s", r.estimate.peakRateDps, 40, 12) && ok;
+        ok = checkFlag("stalled", r.flagsSeen, SERVO_EST_STALLED, false) && ok;
+    }
+
+    // Steps every 1.5 s between -10° and +10°: settles with the offset
+    {
+        ServoModel s = base;
+        Result r = run(s, 9.0, [](double t) { return fmod(t, 3.0) < 1.5 ? -10.0 : 10.0; });
+        printf("Steps:\n");
+        ok = check("steady error deg", r.estimate.steadyErrorDeg, -base.offsetDeg, 0.1) && ok;
+        ok = checkFlag("settled", r.flagsSeen, SERVO_EST_SETTLED, true) && ok;
+        ok = checkFlag("stalled", r.flagsSeen, SERVO_EST_STALLED, false) && ok;
+    }
+
+    // Jammed at 0° while commanded to +12°
+    {
+        ServoModel s = base;
+        s.jammed = true;
+        Result r = run(s, 2.0, [](double t) { return t < 0.2 ? 0.0 : 12.0; });
+        printf("Jammed servo:\n");
+        ok = checkFlag("stalled", r.estimate.flags, SERVO_EST_STALLED, true) && ok;
+        ok = checkFlag("saturated", r.estimate.flags, SERVO_EST_SATURATED, false) && ok;
+    }
+
+    // Guidance asks for more than the travel
+    {
+        ServoModel s = base;
+        Result r = run(s, 2.0, [](double t) { return t < 0.2 ? 0.0 : 40.0; });
+        printf("Command beyond travel:\n");
+        ok = checkFlag("saturated", r.estimate.flags, SERVO_EST_SATURATED, true) && ok;
+        ok = checkFlag("stalled", r.estimate.flags, SERVO_EST_STALLED, false) && ok;
+    }
+
+    // Slow servo, large step: slews at its limit
+    {
+        ServoModel s = base;
+        s.slewDps = 60;
+        Result r = run(s, 1.0, [](double t) { return t < 0.5 ? -20.0 : 20.0; });
+        printf("Slew-limited step:\n");
+        ok = checkFlag("rate limited", r.flagsSeen, SERVO_EST_RATE_LIMITED, true) && ok;
+        ok = check("peak rate deg/s", r.estimate.peakRateDps, 60, 10) && ok;
+    }
+
+    printf("%s\n", ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
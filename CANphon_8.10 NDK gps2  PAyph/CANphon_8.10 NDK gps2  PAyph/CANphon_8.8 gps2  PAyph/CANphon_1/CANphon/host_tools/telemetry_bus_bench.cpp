@@ -0,0 +1,189 @@
+/**
+ * telemetry_bus_bench.cpp
+ * Telemetry Bus Stress Benchmark (host)
+ *
+ * One producer publishes records of every type at a fixed rate; eight
+ * consumers read them through their own cursors, from a busy reader to
+ * one that wakes twice a second (and so must skip). Each record carries
+ * values derived from its sequence number, so every copy is checked for
+ * tearing, order and type filtering, and an all-types consumer must
+ * account for every record as received or skipped.
+ *
+ *   telemetry_bus_bench [--seconds S] [--rate RECORDS_PER_S]
+ */
+
+#include "telemetry_bus.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double expectedValue(uint64_t sequence, int i) {
+    return (double)(sequence * 16 + (uint64_t)i);
+}
+
+struct ConsumerSpec {
+    const char* name;
+    int periodUs;           // Sleep between reads, 0 = yield only
+    uint32_t typeMask;
+};
+
+struct ConsumerResult {
+    uint64_t received = 0;
+    uint64_t reads = 0;
+    uint64_t torn = 0;          // Values not matching the record's sequence
+    uint64_t disorder = 0;      // Sequence not increasing
+    uint64_t wrongType = 0;
+    int64_t ageSumUs = 0;       // Publish → read
+    int64_t ageMaxUs = 0;
+    TelemetryBusConsumerStats stats;
+};
+
+static bool checkRecord(const TelemetryBusRecord& r, uint64_t* last, uint32_t typeMask, ConsumerResult* result) {
+    bool ok = true;
+    if (r.sequence <= *last) {
+        result->disorder++;
+        ok = false;
+    }
+    *last = r.sequence;
+    if (!(typeMask & (1u << r.type)) || r.type != r.sequence % TELEMETRY_BUS_TYPES) {
+        result->wrongType++;
+        ok = false;
+    }
+    bool torn = r.count != TELEMETRY_BUS_VALUES;
+    for (int i = 0; i < TELEMETRY_BUS_VALUES && !torn; i++) torn = r.values[i] != expectedValue(r.sequence, i);
+    if (torn) {
+        result->torn++;
+        ok = false;
+    }
+    return ok;
+}
+
+static void consume(int id, const ConsumerSpec& spec, const std::atomic<bool>& producing, ConsumerResult* result) {
+    TelemetryBusRecord batch[256];
+    uint64_t last = 0;
+    for (;;) {
+        bool more = producing.load(std::memory_order_acquire);
+        int n = telemetryBusRead(id, batch, 256);
+        result->reads++;
+        int64_t now = nowUs();
+        for (int i = 0; i < n; i++) {
+            checkRecord(batch[i], &last, spec.typeMask, result);
+            int64_t age = now - batch[i].timeUs;
+            result->ageSumUs += age;
+            result->ageMaxUs = std::max(result->ageMaxUs, age);
+        }
+        result->received += n;
+        if (!more && n == 0) break;     // Drained after the producer stopped
+        if (n == 256) continue;
+        if (spec.periodUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(spec.periodUs));
+        else std::this_thread::yield();
+    }
+    telemetryBusConsumerStats(id, &result->stats);
+}
+
+int main(int argc, char** argv) {
+    int seconds = 3;
+    int rate = 50000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) rate = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--rate RECORDS_PER_S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds < 1 || rate < 1000) return 2;
+
+    const uint32_t all = TELEMETRY_BUS_ALL_TYPES;
+    const uint32_t servoAttitude = (1u << TELEMETRY_BUS_SERVO) | (1u << TELEMETRY_BUS_ATTITUDE);
+    const ConsumerSpec specs[8] = {
+        {"usb", 0, all},
+        {"publisher", 0, all},
+        {"csv", 1000, servoAttitude},
+        {"chart", 16000, 1u << TELEMETRY_BUS_SERVO},
+        {"ui", 50000, all},
+        {"gps-view", 100000, 1u << TELEMETRY_BUS_GPS},
+        {"power", 200000, 1u << TELEMETRY_BUS_POWER},
+        {"stalled", 500000, all},
+    };
+
+    int ids[8];
+    for (int c = 0; c < 8; c++) {
+        ids[c] = telemetryBusSubscribe(specs[c].name, specs[c].typeMask, 0);
+        if (ids[c] < 0) return 1;
+    }
+
+    std::atomic<bool> producing{true};
+    std::vector<ConsumerResult> results(8);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < 8; c++) {
+        threads.emplace_back(consume, ids[c], std::cref(specs[c]), std::cref(producing), &results[c]);
+    }
+
+    // Producer: rate / 1000 records every millisecond
+    uint64_t start = telemetryBusPublished();
+    std::vector<int64_t> publishNs;
+    publishNs.reserve((size_t)rate * seconds);
+    double values[TELEMETRY_BUS_VALUES];
+    int perTick = rate / 1000;
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::seconds(seconds);
+    while (next < end) {
+        for (int k = 0; k < perTick; k++) {
+            uint64_t sequence = telemetryBusPublished() + 1;
+            for (int i = 0; i < TELEMETRY_BUS_VALUES; i++) values[i] = expectedValue(sequence, i);
+            auto t0 = std::chrono::steady_clock::now();
+            telemetryBusPublish((uint32_t)(sequence % TELEMETRY_BUS_TYPES), nowUs(), values, TELEMETRY_BUS_VALUES);
+            publishNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count());
+        }
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+    }
+    producing.store(false, std::memory_order_release);
+    for (auto& t : threads) t.join();
+    uint64_t published = telemetryBusPublished() - start;
+
+    std::sort(publishNs.begin(), publishNs.end());
+    int64_t sumNs = 0;
+    for (int64_t ns : publishNs) sumNs += ns;
+    printf("Producer: %llu records (%d/s, %d types, %d-record ring) | publish mean %lld ns, p99 %lld ns, max %lld ns\n",
+           (unsigned long long)published, rate, TELEMETRY_BUS_TYPES, TELEMETRY_BUS_CAPACITY,
+           (long long)(sumNs / (int64_t)publishNs.size()),
+           (long long)publishNs[(size_t)(0.99 * (double)(publishNs.size() - 1))], (long long)publishNs.back());
+    printf("%-10s %8s %5s | %9s %9s %7s | %8s %8s | %s\n", "consumer", "period", "types", "received", "skipped",
+           "per-read", "age mean", "age max", "checks");
+
+    bool ok = true;
+    for (int c = 0; c < 8; c++) {
+        const ConsumerResult& r = results[c];
+        bool checks = r.torn == 0 && r.disorder == 0 && r.wrongType == 0 && r.received == r.stats.received;
+        // Every record of an all-types consumer is either received or skipped
+        if (specs[c].typeMask == all && r.received + r.stats.skipped != published) checks = false;
+        if (!checks) ok = false;
+        printf("%-10s %6d us %5x | %9llu %9llu %7.1f | %5lld us %5lld us | %s",
+               specs[c].name, specs[c].periodUs, specs[c].typeMask,
+               (unsigned long long)r.received, (unsigned long long)r.stats.skipped,
+               r.reads > 0 ? (double)r.received / (double)r.reads : 0.0,
+               (long long)(r.received > 0 ? r.ageSumUs / (int64_t)r.received : 0), (long long)r.ageMaxUs,
+               checks ? "ok" : "FAILED");
+        if (r.torn || r.disorder || r.wrongType) {
+            printf(" (torn %llu, disorder %llu, type %llu)", (unsigned long long)r.torn,
+                   (unsigned long long)r.disorder, (unsigned long long)r.wrongType);
+        }
+        printf("\n");
+        telemetryBusUnsubscribe(ids[c]);
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,347 @@
+/**
+ * telemetry_subscriber.cpp
+ * Telemetry Subscriber (host)
+ *
+ * Ground-station stand-in for telemetry_publisher: receives records over
+ * UDP (unicast or a multicast group) and / or TCP, checks magic and frame
+ * checksum, and prints once per second the rate, sequence loss, reorders
+ * and publish → receive latency (wall clock, so exact on one host and as
+ * good as NTP between two).
+ *
+ *   telemetry_subscriber [--udp PORT] [--group ADDR] [--tcp HOST:PORT] [--seconds S]
+ *   telemetry_subscriber --self-test [--rate HZ] [--burst N] [--seconds S]
+ *
+ * --self-test runs the publisher in this process (UDP + TCP on localhost),
+ * fed with telemetry.cpp frames at --rate, --burst frames per tick, and
+ * fails if a TCP record is lost or any record is corrupt.
+ *
+ * Device: `adb forward tcp:14574 tcp:14574` then --tcp 127.0.0.1:14574.
+ */
+
+#include "telemetry.h"
+#include "telemetry_publisher.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct Stream {
+    const char* name;
+    int fd = -1;
+    bool synced = false;
+    uint32_t expected = 0;
+    uint64_t received = 0;
+    uint64_t lost = 0;
+    uint64_t reordered = 0;
+    uint64_t bad = 0;
+    uint64_t intervalReceived = 0;
+    std::vector<int64_t> intervalLatency;
+    std::vector<int64_t> latency;
+    std::vector<uint8_t> pending;   // TCP bytes not yet parsed
+};
+
+static int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void onRecord(Stream* s, const uint8_t* record, int length) {
+    uint32_t sequence;
+    int64_t publishUs;
+    if (!telemetryRecordParse(record, length, &sequence, &publishUs, nullptr)) {
+        s->bad++;
+        return;
+    }
+    int64_t latencyUs = telemetryPublisherClockUs() - publishUs;
+    s->received++;
+    s->intervalReceived++;
+    s->intervalLatency.push_back(latencyUs);
+    s->latency.push_back(latencyUs);
+
+    if (!s->synced) {
+        s->synced = true;
+        s->expected = sequence + 1;
+        return;
+    }
+    int32_t gap = (int32_t)(sequence - s->expected);
+    if (gap >= 0) {
+        s->lost += (uint64_t)gap;
+        s->expected = sequence + 1;
+    } else {
+        // Late arrival of a record already counted as lost
+        s->reordered++;
+        if (s->lost > 0) s->lost--;
+    }
+}
+
+static void readUdp(Stream* s) {
+    uint8_t datagram[512];
+    for (;;) {
+        ssize_t n = recv(s->fd, datagram, sizeof(datagram), MSG_DONTWAIT);
+        if (n < 0) return;
+        onRecord(s, datagram, (int)n);
+    }
+}
+
+// Records back to back; after a corrupt record, resync on the magic
+static bool readTcp(Stream* s) {
+    uint8_t chunk[8192];
+    ssize_t n = recv(s->fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) return false;
+    if (n < 0) return true;
+    s->pending.insert(s->pending.end(), chunk, chunk + n);
+
+    size_t offset = 0;
+    while (s->pending.size() - offset >= TELEMETRY_PUB_RECORD_SIZE) {
+        const uint8_t* p = s->pending.data() + offset;
+        if (telemetryRecordParse(p, TELEMETRY_PUB_RECORD_SIZE, nullptr, nullptr, nullptr)) {
+            onRecord(s, p, TELEMETRY_PUB_RECORD_SIZE);
+            offset += TELEMETRY_PUB_RECORD_SIZE;
+        } else {
+            s->bad++;
+            offset++;
+            while (s->pending.size() - offset >= 2 &&
+                   !(s->pending[offset] == (TELEMETRY_PUB_MAGIC & 0xFF) && s->pending[offset + 1] == (TELEMETRY_PUB_MAGIC >> 8))) {
+                offset++;
+            }
+        }
+    }
+    s->pending.erase(s->pending.begin(), s->pending.begin() + (long)offset);
+    return true;
+}
+
+static int openUdp(int port, const char* group) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    int buffer = 1 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (group != nullptr) {
+        struct ip_mreq mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (inet_pton(AF_INET, group, &mreq.imr_multiaddr) != 1 ||
+            setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+static int connectTcp(const char* hostPort) {
+    char host[64];
+    strncpy(host, hostPort, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    int port = TELEMETRY_PUB_DEFAULT_TCP_PORT;
+    char* colon = strchr(host, ':');
+    if (colon != nullptr) {
+        *colon = '\0';
+        port = atoi(colon + 1);
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) return -1;
+
+    // The publisher may come up a little later
+    for (int attempt = 0; attempt < 50; attempt++) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return -1;
+}
+
+static void printInterval(Stream* s) {
+    if (s->fd < 0) return;
+    printf("  %-4s %5llu rec/s  lost %llu  reordered %llu  bad %llu  latency p50 %lld p99 %lld max %lld us\n",
+           s->name, (unsigned long long)s->intervalReceived, (unsigned long long)s->lost,
+           (unsigned long long)s->reordered, (unsigned long long)s->bad,
+           (long long)percentile(s->intervalLatency, 0.5), (long long)percentile(s->intervalLatency, 0.99),
+           (long long)percentile(s->intervalLatency, 1.0));
+    s->intervalReceived = 0;
+    s->intervalLatency.clear();
+}
+
+static void printTotal(Stream* s) {
+    if (s->fd < 0) return;
+    uint64_t expected = s->received + s->lost;
+    printf("%-4s total: %llu records, lost %llu (%.3f%%), reordered %llu, bad %llu, "
+           "latency p50 %lld p99 %lld max %lld us\n",
+           s->name, (unsigned long long)s->received, (unsigned long long)s->lost,
+           expected > 0 ? 100.0 * (double)s->lost / (double)expected : 0.0, (unsigned long long)s->reordered,
+           (unsigned long long)s->bad, (long long)percentile(s->latency, 0.5),
+           (long long)percentile(s->latency, 0.99), (long long)percentile(s->latency, 1.0));
+}
+
+static std::atomic<bool> stopProducer(false);
+
+static void producer(int rate, int burst) {
+    telemetryInit();
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    auto period = std::chrono::microseconds(1000000 / rate);
+    auto next = std::chrono::steady_clock::now();
+    uint32_t tick = 0;
+    while (!stopProducer.load(std::memory_order_relaxed)) {
+        for (int b = 0; b < burst; b++) {
+            telemetrySetTimestamp(tick);
+            telemetrySetOrientation(20.0f * sinf((float)tick * 0.05f), 0, 0);
+            telemetryBuildFrame(frame, sizeof(frame));
+            telemetryPublisherPublish(frame, TELEMETRY_FRAME_SIZE);
+        }
+        tick++;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+int main(int argc, char** argv) {
+    int udpPort = 0;
+    const char* group = nullptr;
+    const char* tcpTarget = nullptr;
+    int seconds = 0;
+    bool selfTest = false;
+    int rate = 60;
+    int burst = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--udp") == 0 && i + 1 < argc) udpPort = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--group") == 0 && i + 1 < argc) group = argv[++i];
+        else if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) tcpTarget = argv[++i];
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--self-test") == 0) selfTest = true;
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) rate = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc) burst = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--udp PORT] [--group ADDR] [--tcp HOST:PORT] [--seconds S]\n"
+                            "       %s --self-test [--rate HZ] [--burst N] [--seconds S]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (selfTest) {
+        udpPort = TELEMETRY_PUB_DEFAULT_UDP_PORT;
+        tcpTarget = "127.0.0.1:14574";
+        if (seconds <= 0) seconds = 5;
+        if (rate < 1 || burst < 1) return 2;
+    }
+    if (udpPort <= 0 && tcpTarget == nullptr) udpPort = TELEMETRY_PUB_DEFAULT_UDP_PORT;
+
+    Stream udp, tcp;
+    udp.name = "udp";
+    tcp.name = "tcp";
+    if (udpPort > 0) {
+        udp.fd = openUdp(udpPort, group);
+        if (udp.fd < 0) {
+            fprintf(stderr, "UDP port %d: %s\n", udpPort, strerror(errno));
+            return 1;
+        }
+    }
+    if (selfTest) {
+        TelemetryPublisherConfig config;
+        telemetryPublisherDefaultConfig(&config);
+        if (!telemetryPublisherStart(&config)) return 1;
+    }
+    if (tcpTarget != nullptr) {
+        tcp.fd = connectTcp(tcpTarget);
+        if (tcp.fd < 0) {
+            fprintf(stderr, "TCP %s: cannot connect\n", tcpTarget);
+            return 1;
+        }
+    }
+
+    std::thread feed;
+    if (selfTest) {
+        // Let the publisher accept the TCP subscriber before the first record
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        feed = std::thread(producer, rate, burst);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(1);
+    bool tcpOpen = tcp.fd >= 0;
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        if (seconds > 0 && now - start >= std::chrono::seconds(seconds)) break;
+
+        struct pollfd fds[2];
+        int n = 0;
+        if (udp.fd >= 0) fds[n++] = {udp.fd, POLLIN, 0};
+        if (tcpOpen) fds[n++] = {tcp.fd, POLLIN, 0};
+        if (n == 0) break;
+        poll(fds, (nfds_t)n, 100);
+        if (udp.fd >= 0) readUdp(&udp);
+        if (tcpOpen && !readTcp(&tcp)) {
+            printf("TCP publisher closed the connection\n");
+            tcpOpen = false;
+        }
+
+        if (std::chrono::steady_clock::now() >= nextReport) {
+            printf("t=%llds\n", (long long)std::chrono::duration_cast<std::chrono::seconds>(nextReport - start).count());
+            printInterval(&udp);
+            printInterval(&tcp);
+            nextReport += std::chrono::seconds(1);
+        }
+    }
+
+    bool ok = true;
+    if (selfTest) {
+        stopProducer = true;
+        feed.join();
+        // Drain what is still in flight
+        for (;;) {
+            struct pollfd fds[2] = {{udp.fd, POLLIN, 0}, {tcpOpen ? tcp.fd : -1, POLLIN, 0}};
+            if (poll(fds, 2, 50) <= 0) break;
+            readUdp(&udp);
+            if (tcpOpen && !readTcp(&tcp)) tcpOpen = false;
+        }
+
+        TelemetryPublisherStats s;
+        telemetryPublisherGetStats(&s);
+        telemetryPublisherStop();
+        printf("publisher: %llu records, %llu datagrams in %llu sendmmsg calls (%.2f per call), "
+               "queue drops %llu, TCP drops %llu, queue → socket mean %lld max %lld us\n",
+               (unsigned long long)s.published, (unsigned long long)s.udpDatagrams, (unsigned long long)s.udpCalls,
+               s.udpCalls > 0 ? (double)s.udpDatagrams / (double)s.udpCalls : 0.0,
+               (unsigned long long)s.queueDrops, (unsigned long long)s.tcpDrops,
+               (long long)s.latencyMeanUs, (long long)s.latencyMaxUs);
+        ok = tcp.lost == 0 && s.tcpDrops == 0 && udp.bad == 0 && tcp.bad == 0 && tcp.received > 0 && udp.received > 0;
+    }
+    printTotal(&udp);
+    printTotal(&tcp);
+    if (udp.fd >= 0) close(udp.fd);
+    if (tcp.fd >= 0) close(tcp.fd);
+    if (selfTest) printf("%s\n", ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
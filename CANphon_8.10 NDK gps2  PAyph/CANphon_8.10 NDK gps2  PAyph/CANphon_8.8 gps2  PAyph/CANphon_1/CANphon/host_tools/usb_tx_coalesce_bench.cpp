@@ -0,0 +1,215 @@
+/**
+ * usb_tx_coalesce_bench.cpp
+ * Telemetry USB Write Benchmark (host)
+ *
+ * Feeds 73-byte telemetry frames at several rates into a modelled
+ * full-speed bulk OUT endpoint (fixed cost per transfer + 12 Mbit/s),
+ * two ways:
+ *   per-frame  - TelemetryStreamer before: one write per frame on a
+ *                worker, frames skipped while a write is in flight
+ *   coalesced  - usb_tx_coalescer (size / deadline flush)
+ * and reports transfers/s, bytes/transfer, frames lost and queueing
+ * delay. The coalesced byte stream is checked against the frames queued.
+ *
+ *   usb_tx_coalesce_bench [--seconds S] [--overhead US] [--transfer B] [--delay US]
+ */
+
+#include "telemetry.h"
+#include "usb_tx_coalescer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static int overheadUs = 500;    // URB submit + completion in the next 1 ms USB frame, on average
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Device {
+    std::mutex lock;
+    std::vector<uint8_t> received;
+    uint64_t transfers = 0;
+};
+
+static int deviceWrite(void* context, const uint8_t* data, int length, int) {
+    Device* d = (Device*)context;
+    std::this_thread::sleep_for(std::chrono::microseconds(overheadUs + length * 8 / 12));
+    std::lock_guard<std::mutex> guard(d->lock);
+    d->received.insert(d->received.end(), data, data + length);
+    d->transfers++;
+    return length;
+}
+
+static void buildFrame(uint32_t index, uint8_t* frame) {
+    telemetrySetTimestamp(index);
+    telemetrySetOrientation((float)(index % 3600) * 0.1f, 0, 0);
+    telemetryBuildFrame(frame, TELEMETRY_FRAME_SIZE);
+}
+
+struct Result {
+    uint64_t frames = 0;
+    uint64_t lost = 0;
+    uint64_t transfers = 0;
+    uint64_t bytes = 0;
+    int64_t delayMeanUs = 0;
+    int64_t delayP99Us = 0;
+    int64_t delayMaxUs = 0;
+    bool streamOk = true;
+};
+
+// One write per frame on a worker; the producer skips frames while it is busy
+static Result perFrame(int rate, int seconds) {
+    Device device;
+    std::mutex lock;
+    std::condition_variable cv;
+    bool busy = false, stop = false, ready = false;
+    uint8_t pending[TELEMETRY_FRAME_SIZE];
+    int64_t pendingUs = 0;
+    std::vector<int64_t> delays;
+
+    std::thread worker([&] {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            cv.wait(guard, [&] { return ready || stop; });
+            if (!ready) break;
+            ready = false;
+            uint8_t frame[TELEMETRY_FRAME_SIZE];
+            memcpy(frame, pending, sizeof(frame));
+            int64_t queuedUs = pendingUs;
+            guard.unlock();
+            deviceWrite(&device, frame, TELEMETRY_FRAME_SIZE, 20);
+            int64_t delayUs = nowUs() - queuedUs;
+            guard.lock();
+            delays.push_back(delayUs);
+            busy = false;
+        }
+    });
+
+    Result r;
+    auto period = std::chrono::nanoseconds(1000000000LL / rate);
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::seconds(seconds);
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    for (uint32_t i = 0; next < end; i++) {
+        buildFrame(i, frame);
+        r.frames++;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (busy) {
+                r.lost++;   // isWriting: frame skipped
+            } else {
+                busy = true;
+                ready = true;
+                memcpy(pending, frame, sizeof(frame));
+                pendingUs = nowUs();
+                cv.notify_one();
+            }
+        }
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+        cv.notify_one();
+    }
+    worker.join();
+
+    r.transfers = device.transfers;
+    r.bytes = device.received.size();
+    int64_t sum = 0;
+    for (int64_t d : delays) sum += d;
+    r.delayMeanUs = delays.empty() ? 0 : sum / (int64_t)delays.size();
+    std::sort(delays.begin(), delays.end());
+    r.delayP99Us = delays.empty() ? 0 : delays[(size_t)(0.99 * (double)(delays.size() - 1))];
+    r.delayMaxUs = delays.empty() ? 0 : delays.back();
+    return r;
+}
+
+static Result coalesced(int rate, int seconds, const UsbTxConfig* config) {
+    Device device;
+    UsbTxCoalescer* c = usbTxOpen(deviceWrite, &device, config);
+    Result r;
+    if (c == nullptr) {
+        r.streamOk = false;
+        return r;
+    }
+
+    std::vector<uint8_t> expected;
+    auto period = std::chrono::nanoseconds(1000000000LL / rate);
+    auto next = std::chrono::steady_clock::now();
+    auto end = next + std::chrono::seconds(seconds);
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    for (uint32_t i = 0; next < end; i++) {
+        buildFrame(i, frame);
+        r.frames++;
+        if (usbTxWrite(c, frame, TELEMETRY_FRAME_SIZE) == 1) expected.insert(expected.end(), frame, frame + sizeof(frame));
+        else r.lost++;
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    usbTxFlush(c, 1000);
+
+    UsbTxStats s;
+    usbTxGetStats(c, &s);
+    usbTxClose(c);
+    r.transfers = s.transfers;
+    r.bytes = s.bytes;
+    r.delayMeanUs = s.delayMeanUs;
+    r.delayP99Us = s.delayP99Us;
+    r.delayMaxUs = s.delayMaxUs;
+    r.streamOk = device.received == expected && s.framesSent == s.framesQueued;
+    return r;
+}
+
+static void print(const char* name, int rate, int seconds, const Result& r) {
+    printf("%6d Hz %-10s | %8.1f %8.1f | %6llu (%5.2f%%) | %7lld %7lld %7lld%s\n", rate, name,
+           (double)r.transfers / seconds, r.transfers > 0 ? (double)r.bytes / (double)r.transfers : 0.0,
+           (unsigned long long)r.lost, r.frames > 0 ? 100.0 * (double)r.lost / (double)r.frames : 0.0,
+           (long long)r.delayMeanUs, (long long)r.delayP99Us, (long long)r.delayMaxUs,
+           r.streamOk ? "" : "  STREAM MISMATCH");
+}
+
+int main(int argc, char** argv) {
+    int seconds = 2;
+    UsbTxConfig config;
+    usbTxDefaultConfig(&config);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--overhead") == 0 && i + 1 < argc) overheadUs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--transfer") == 0 && i + 1 < argc) config.transferSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) config.maxDelayUs = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Usage: %s [--seconds S] [--overhead US] [--transfer B] [--delay US]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seconds < 1 || overheadUs < 0) return 2;
+    telemetryInit();
+
+    printf("Modelled endpoint: %d us per transfer + 12 Mbit/s; coalescer %d B transfers, %d us deadline\n",
+           overheadUs, config.transferSize, config.maxDelayUs);
+    printf("%9s %-10s | %8s %8s | %16s | %7s %7s %7s\n", "rate", "path", "xfer/s", "B/xfer", "frames lost",
+           "mean us", "p99 us", "max us");
+
+    bool ok = true;
+    const int rates[] = {60, 250, 1000, 4000};
+    for (int rate : rates) {
+        Result a = perFrame(rate, seconds);
+        Result b = coalesced(rate, seconds, &config);
+        print("per-frame", rate, seconds, a);
+        print("coalesced", rate, seconds, b);
+        if (!b.streamOk) ok = false;
+    }
+    printf("%s\n", ok ? "OK" : "MISMATCH");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/**
+ * ws_codec_bench.cpp
+ * Waveshare Codec Benchmark (host)
+ *
+ * Generates a USB-CAN byte stream at the frame rate of a saturated
+ * 1 Mbit/s bus, decodes it in USB-sized chunks and checks that every
+ * frame comes back unchanged. Also replays the old adapter behaviour
+ * (one frame parsed per 64-byte read) to show the resulting drops.
+ *
+ * Usage: ws_codec_bench [seconds]
+ */
+
+#include "waveshare_codec.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Standard 8-byte frame ≈ 111 bits + ~19 stuff bits + 3 bits IFS at 1 Mbit/s
+static const int FRAMES_PER_SECOND = 7700;
+static const int GARBAGE_INTERVAL = 997;   // Insert one stray byte every N frames
+static const int MAX_OUT_FRAMES = 128;     // Same as WaveshareAdapter.MAX_RX_FRAMES
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedNs(Clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Stream Generation
+// ═══════════════════════════════════════════════════════════════════════════
+
+static std::vector<WsCanFrame> makeFrames(int count) {
+    std::vector<WsCanFrame> frames(count);
+    uint32_t seed = 0x12345678;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        WsCanFrame& f = frames[i];
+        memset(&f, 0, sizeof(f));
+        f.flags = (i % 50 == 0) ? WS_FLAG_EXT : 0;
+        f.id = (f.flags & WS_FLAG_EXT) ? (0x18FF0000u | (seed >> 16)) : (0x581u + (seed >> 28) % 8);
+        f.dlc = (i % 10 == 0) ? (uint8_t)((seed >> 8) % 9) : 8;
+        for (int k = 0; k < f.dlc; k++) f.data[k] = (uint8_t)(seed >> (k * 3));
+    }
+    return frames;
+}
+
+static std::vector<uint8_t> encodeStream(const std::vector<WsCanFrame>& frames, double* nsPerFrame) {
+    std::vector<uint8_t> stream(frames.size() * WS_MAX_FRAME_BYTES + frames.size() / GARBAGE_INTERVAL + 1);
+    int batch = 16;
+    size_t length = 0;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < frames.size(); i += batch) {
+        int n = (int)((frames.size() - i) < (size_t)batch ? frames.size() - i : batch);
+        length += wsEncodeFrames(&frames[i], n, stream.data() + length, (int)(stream.size() - length));
+    }
+    *nsPerFrame = elapsedNs(start) / frames.size();
+
+    // Sprinkle stray bytes (not a header) to exercise resync
+    std::vector<uint8_t> noisy;
+    noisy.reserve(length + frames.size() / GARBAGE_INTERVAL + 1);
+    size_t pos = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        const WsCanFrame& f = frames[i];
+        int size = 2 + ((f.flags & WS_FLAG_EXT) ? 4 : 2) + f.dlc + 1;
+        noisy.insert(noisy.end(), stream.begin() + pos, stream.begin() + pos + size);
+        pos += size;
+        if (i % GARBAGE_INTERVAL == GARBAGE_INTERVAL - 1) noisy.push_back(0x00);
+    }
+    return noisy;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Decode Runs
+// ═══════════════════════════════════════════════════════════════════════════
+
+struct RunResult {
+    long frames;
+    long mismatches;
+    double ns;
+    WsCodecStats stats;
+};
+
+static bool sameFrame(const WsCanFrame& a, const WsCanFrame& b) {
+    return a.id == b.id && a.dlc == b.dlc && a.flags == b.flags && memcmp(a.data, b.data, a.dlc) == 0;
+}
+
+// maxPerRead < 0: drain everything each read (new adapter)
+// maxPerRead > 0: parse at most that many frames per read (old adapter)
+static RunResult decodeRun(const std::vector<uint8_t>& stream, const std::vector<WsCanFrame>& expected,
+                           int chunk, int maxPerRead) {
+    static WsCanFrame out[MAX_OUT_FRAMES];
+    RunResult r = {0, 0, 0.0, {}};
+    size_t next = 0;
+
+    wsDecoderReset();
+    Clock::time_point start = Clock::now();
+    for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+        int len = (int)((stream.size() - pos) < (size_t)chunk ? stream.size() - pos : chunk);
+        int limit = maxPerRead > 0 ? maxPerRead : MAX_OUT_FRAMES;
+        int n = wsDecode(stream.data() + pos, len, out, limit);
+        while (true) {
+            for (int i = 0; i < n; i++) {
+                // Dropped bytes lose frames; resynchronise on the next matching one
+                while (next < expected.size() && !sameFrame(out[i], expected[next])) {
+                    next++;
+                    r.mismatches++;
+                }
+                next++;
+            }
+            r.frames += n;
+            if (maxPerRead > 0 || n < limit) break;
+            n = wsDecode(nullptr, 0, out, limit);
+        }
+    }
+    r.ns = elapsedNs(start);
+    wsGetStats(&r.stats);
+    return r;
+}
+
+static void printRun(const char* name, const RunResult& r, size_t total, double streamSeconds) {
+    double nsPerFrame = r.frames ? r.ns / r.frames : 0.0;
+    printf("%-28s %9ld/%-9zu %8.1f ns/frame %9.0fx realtime  dropped %8llu B  skipped %4llu B  bad %3llu\n",
+           name, r.frames, total, nsPerFrame, streamSeconds * 1e9 / r.ns,
+           (unsigned long long)r.stats.bytesDropped, (unsigned long long)r.stats.garbageBytes,
+           (unsigned long long)r.stats.badFrames);
+}
+
+int main(int argc, char** argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 10;
+    if (seconds <= 0) seconds = 10;
+
+    int count = FRAMES_PER_SECOND * seconds;
+    std::vector<WsCanFrame> frames = makeFrames(count);
+
+    double encodeNs = 0.0;
+    wsDecoderReset();
+    std::vector<uint8_t> stream = encodeStream(frames, &encodeNs);
+
+    printf("Stream: %d frames (%d s at %d frames/s), %zu bytes, %d stray bytes\n",
+           count, seconds, FRAMES_PER_SECOND, stream.size(), count / GARBAGE_INTERVAL);
+    printf("Encode (16-frame batches): %.1f ns/frame\n\n", encodeNs);
+
+    int failures = 0;
+    const int chunks[] = {64, 512, 4096};
+    for (int chunk : chunks) {
+        char name[64];
+        snprintf(name, sizeof(name), "decode all, %d B reads", chunk);
+        RunResult r = decodeRun(stream, frames, chunk, -1);
+        printRun(name, r, frames.size(), seconds);
+        if (r.frames != count || r.mismatches != 0 || r.stats.bytesDropped != 0) {
+            printf("  FAIL: %ld frames, %ld mismatches\n", r.frames, r.mismatches);
+            failures++;
+        }
+    }
+
+    // Old WaveshareAdapter.readFrame(): 64-byte read, one frame returned
+    RunResult legacy = decodeRun(stream, frames, 64, 1);
+    printRun("one frame per 64 B read", legacy, frames.size(), seconds);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+#ifndef BRIDGE_CONFIG_H
+#define BRIDGE_CONFIG_H
+
+// ===== BUILD PROFILES =====
+// The bridge is built from a single source tree. Select the profile with a
+// preprocessor symbol (Project > Properties > C/C++ Build > Settings >
+// MCU GCC Compiler > Preprocessor):
+//
+//   (none)                RELEASE - CAN <-> servo forwarding only
+//   BRIDGE_PROFILE_DEBUG  DEBUG   - RELEASE + UART3 mirror, LED trace, stats
+//
+// BRIDGE_FEATURE_DUAL_BUS=1 can be added to either profile (see below).
+//
+// Every feature can also be forced individually, e.g.
+// BRIDGE_FEATURE_UART3_MIRROR=1 on top of a RELEASE build.
+//
+// All debug features run on the same DMA ReceiveToIdle path as RELEASE and
+// never block the main loop, so the bus timing is identical in both builds.
+
+#if defined(BRIDGE_PROFILE_DEBUG)
+#define BRIDGE_PROFILE_FEATURES 1
+#else
+#define BRIDGE_PROFILE_FEATURES 0
+#endif
+
+// Second servo bus on USART3 (PB10/PB11). Each bus has its own DMA TX/RX,
+// command queue and feedback parser, so commands to the two halves go out in
+// parallel. The node map (node_config.h) picks the bus per channel; in the
+// default map servos below BRIDGE_BUS2_FIRST_SERVO stay on USART2 and the
+// rest move to USART3. Available in both profiles.
+#ifndef BRIDGE_FEATURE_DUAL_BUS
+#define BRIDGE_FEATURE_DUAL_BUS 0
+#endif
+
+#ifndef BRIDGE_BUS2_FIRST_SERVO
+#define BRIDGE_BUS2_FIRST_SERVO 3
+#endif
+
+// Copy every servo command to USART3 (interrupt-driven, dropped when busy).
+// USART3 belongs to the second bus when BRIDGE_FEATURE_DUAL_BUS is set.
+#ifndef BRIDGE_FEATURE_UART3_MIRROR
+#define BRIDGE_FEATURE_UART3_MIRROR                                            \
+  (BRIDGE_PROFILE_FEATURES && !BRIDGE_FEATURE_DUAL_BUS)
+#endif
+
+#if BRIDGE_FEATURE_DUAL_BUS && BRIDGE_FEATURE_UART3_MIRROR
+#error "USART3 cannot be both the UART3 mirror and the second servo bus"
+#endif
+
+// Play the FEEDBACK pulse (double flash) for feedback frames forwarded to CAN.
+// Forwarded commands play the ACTIVITY pulse (short dark) in every build;
+// both go through LED_Pulse() and are rate-limited by LED_PULSE_PERIOD_MS
+#ifndef BRIDGE_FEATURE_LED_TRACE
+#define BRIDGE_FEATURE_LED_TRACE BRIDGE_PROFILE_FEATURES
+#endif
+
+// Raw serial bytes in feedback frames + periodic stats frame on DEBUG_ID
+#ifndef BRIDGE_FEATURE_STATS
+#define BRIDGE_FEATURE_STATS BRIDGE_PROFILE_FEATURES
+#endif
+
+#define BRIDGE_STATS_PERIOD_MS 1000
+
+#endif // BRIDGE_CONFIG_H
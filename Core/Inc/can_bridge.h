@@ -1,6 +1,7 @@
 #ifndef CAN_BRIDGE_H
 #define CAN_BRIDGE_H
 
+#include "bridge_config.h"
 #include "main.h"
 
 // ===== DEFINITIONS =====
@@ -8,6 +9,19 @@
 #define FEEDBACK_FRAME_LEN 7
 #define DEBUG_ID 0x599
 
+// ===== TYPES =====
+// Counters that are cheap enough to keep in every profile; they are only
+// reported on the bus when BRIDGE_FEATURE_STATS is enabled.
+typedef struct {
+  uint32_t commandsForwarded; // Serial packets sent to the servos
+  uint32_t commandsDropped;   // CAN commands lost to a full command queue
+  uint32_t canTxDropped;      // Feedback frames lost to full TX mailboxes
+  uint32_t mirrorDropped;     // UART3 mirror packets skipped (UART busy)
+  uint32_t feedbackUnmapped;  // Feedback from servos not in the node map
+  uint32_t readyTick;         // HAL tick when CAN + servo UART were live
+  uint32_t firstCommandTick;  // HAL tick of the first forwarded command
+} BridgeStats;
+
 // ===== GLOBAL VARIABLES (Extern) =====
 extern CAN_HandleTypeDef hcan1;
 extern UART_HandleTypeDef huart2;
@@ -15,20 +29,49 @@ extern UART_HandleTypeDef huart3;
 extern volatile uint32_t feedbackFrameCount;
 extern volatile uint8_t blinkServoId;
 extern volatile uint8_t feedbackDebugBlink;
+extern volatile uint32_t uartRxCount;
+extern volatile BridgeStats bridgeStats;
 
 // ===== FUNCTION PROTOTYPES =====
 
 /**
- * @brief  Converts incoming CAN SDO (ID 0x601-0x604) to Serial Servo Protocol.
+ * @brief  Converts incoming CAN SDO (0x600 + node) to Serial Servo Protocol.
  * @param  canData: Pointer to 8-byte CAN data
- * @param  servoId: ID of the servo extracted from CAN ID
+ * @param  channel: Bridge channel (see NodeConfig_ChannelForNode)
  */
-void Bridge_ConvertSDOtoSerial(uint8_t *canData, uint8_t servoId);
+void Bridge_ConvertSDOtoSerial(uint8_t *canData, uint8_t channel);
 
 /**
- * @brief  Processes received Serial feedback and forwards it to CAN.
+ * @brief  Processes received Serial feedback and forwards it to CAN
+ *         (0x580 + node of the servo's channel).
  * @param  buffer: Pointer to the 7-byte feedback frame buffer
+ * @param  bus: Servo bus the frame arrived on
+ */
+void Bridge_ProcessFeedback(uint8_t *buffer, uint8_t bus);
+
+#if BRIDGE_FEATURE_UART3_MIRROR
+/**
+ * @brief  Copies a 5-byte servo packet to UART3 without blocking.
+ *         The packet is skipped (and counted) if the previous copy is still
+ *         being transmitted.
+ * @param  packet: Pointer to the 5-byte serial packet
+ */
+void Bridge_MirrorCommand(const uint8_t *packet);
+#endif
+
+#if BRIDGE_FEATURE_STATS
+/**
+ * @brief  Sends the stats frame on DEBUG_ID once per BRIDGE_STATS_PERIOD_MS.
+ *         Call from the main loop.
+ *
+ *         [0-1] feedback frames  [2-3] UART RX events  [4-5] commands sent
+ *         [6] commands dropped   [7] CAN TX + mirror drops (both saturate)
+ *
+ *         After the first forwarded command a one-off boot frame (DLC 4) is
+ *         sent on the same ID:
+ *         [0-1] ms reset -> ready   [2-3] ms reset -> first command
  */
-void Bridge_ProcessFeedback(uint8_t *buffer);
+void Bridge_SendStats(void);
+#endif
 
 #endif // CAN_BRIDGE_H
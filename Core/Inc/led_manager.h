@@ -3,12 +3,39 @@
 
 #include "main.h"
 
+// ===== LED PATTERNS =====
+// Patterns are step tables played by LED_Tick() from SysTick, so nothing
+// here ever blocks the main loop. A background pattern runs continuously;
+// a one-shot pattern temporarily overrides it and then hands back.
+typedef enum {
+  LED_PATTERN_OFF = 0,
+  LED_PATTERN_ON,           // Steady ON = system ready
+  LED_PATTERN_READY,        // 5 quick blinks (one-shot)
+  LED_PATTERN_ACTIVITY,     // Short dark pulse per forwarded command
+  LED_PATTERN_FEEDBACK,     // The "Double Flash" pattern
+  LED_PATTERN_ERROR,        // 10 fast blinks (one-shot)
+  LED_PATTERN_FAULT_FILTER, // CAN filter config failed (50/50 loop)
+  LED_PATTERN_FAULT_CAN,    // CAN start failed (200/200 loop)
+  LED_PATTERN_COUNT
+} LedPattern;
+
+// Event pulses (LED_Pulse) of one pattern start at most this often, so
+// steady traffic blinks the LED instead of holding it in the pattern
+#define LED_PULSE_PERIOD_MS 100
+
 // ===== LED FUNCTIONS =====
 void LED_ON(void);
 void LED_OFF(void);
 void LED_Toggle(void);
-void LED_Blink(uint32_t onTime, uint32_t offTime);
-void LED_FeedbackFlash(void); // The "Double Flash" pattern
+
+void LED_SetPattern(LedPattern pattern); // Background pattern
+void LED_Play(LedPattern pattern);       // One-shot over the background
+uint8_t LED_IsPlaying(void);             // One-shot requested or running
+uint8_t LED_Pulse(LedPattern pattern);   // LED_Play, unless one is running
+                                         // or this one ran too recently
+void LED_Tick(void);                     // Call every 1 ms from SysTick
+
+void LED_FeedbackFlash(void);
 void LED_SignalError(void);
 
 #endif // LED_MANAGER_H
@@ -0,0 +1,83 @@
+#ifndef NODE_CONFIG_H
+#define NODE_CONFIG_H
+
+#include "main.h"
+
+// ===== ADDRESSING =====
+// Each bridge owns a contiguous block of CANopen node IDs:
+//   nodeBase .. nodeBase + servoCount - 1
+// Channel i of that block is commanded on 0x600 + nodeBase + i and reports
+// feedback on 0x580 + nodeBase + i. map[i] says which serial servo (and which
+// bus) the channel drives, so several bridges can share one CAN bus.
+#define NODE_CONFIG_MAX_SERVOS 8
+#define NODE_CONFIG_MAX_NODE_ID 0x18 // 0x580 + 0x19 is DEBUG_ID
+#define NODE_CONFIG_MAX_SERIAL_ID 15 // Feedback carries a 4-bit servo ID
+
+// ===== SDO OBJECTS (written to 0x600 + nodeBase) =====
+// 0x2100 sub 0x01      node-ID base (1..NODE_CONFIG_MAX_NODE_ID)
+// 0x2100 sub 0x02      servo count (1..NODE_CONFIG_MAX_SERVOS)
+// 0x2100 sub 0x10+i    channel i: bits 0-3 serial servo ID, bit 4 bus
+//                      (0 = USART2, 1 = USART3)
+// 0x1010 sub 0x01      "save" (0x65766173) stores the config in flash
+// 0x1011 sub 0x01      "load" (0x64616F6C) restores the defaults
+// Changes apply on the next main loop pass; no SDO response is sent
+// (0x580 + node carries servo feedback). Configure one bridge at a time while
+// they share a base.
+#define NODE_CONFIG_SDO_INDEX 0x2100
+#define NODE_CONFIG_SDO_SUB_BASE 0x01
+#define NODE_CONFIG_SDO_SUB_COUNT 0x02
+#define NODE_CONFIG_SDO_SUB_MAP 0x10
+#define NODE_CONFIG_SDO_STORE 0x1010
+#define NODE_CONFIG_SDO_RESTORE 0x1011
+
+// ===== TYPES =====
+typedef struct {
+  uint8_t serialId; // Servo protocol ID (1..NODE_CONFIG_MAX_SERIAL_ID)
+  uint8_t bus;      // 0 = USART2, 1 = USART3 (BRIDGE_FEATURE_DUAL_BUS)
+} ServoMapEntry;
+
+typedef struct {
+  uint8_t nodeBase;
+  uint8_t servoCount;
+  ServoMapEntry map[NODE_CONFIG_MAX_SERVOS];
+} NodeConfig;
+
+extern volatile NodeConfig nodeConfig;
+
+// ===== FUNCTION PROTOTYPES =====
+
+/**
+ * @brief  Loads the config from flash, or the defaults (nodes 1-4 -> serial
+ *         servos 1-4) if the flash record is missing or corrupt.
+ */
+void NodeConfig_Load(void);
+
+/**
+ * @brief  Handles an SDO write addressed to the bridge itself.
+ *         Safe to call from the CAN RX interrupt; the change is staged and
+ *         goes live (and to flash) in NodeConfig_Process().
+ * @param  nodeId: Node ID the frame was sent to (StdId - 0x600)
+ * @param  data: 8-byte SDO payload
+ * @retval 1 if the frame was a config object and has been consumed
+ */
+uint8_t NodeConfig_HandleSdo(uint8_t nodeId, const uint8_t *data);
+
+/**
+ * @brief  Main loop service: applies staged SDO writes, then performs a
+ *         pending save/restore.
+ */
+void NodeConfig_Process(void);
+
+/**
+ * @brief  Maps a CAN node ID to a channel of this bridge.
+ * @retval Channel index, or -1 if the node belongs to another bridge
+ */
+int8_t NodeConfig_ChannelForNode(uint8_t nodeId);
+
+/**
+ * @brief  Maps a serial servo (as seen in its feedback) to a channel.
+ * @retval Channel index, or -1 if the servo is not in the map
+ */
+int8_t NodeConfig_ChannelForServo(uint8_t bus, uint8_t serialId);
+
+#endif // NODE_CONFIG_H
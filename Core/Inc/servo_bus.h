@@ -0,0 +1,45 @@
+#ifndef SERVO_BUS_H
+#define SERVO_BUS_H
+
+#include "bridge_config.h"
+#include "main.h"
+
+// ===== CONSTANTS =====
+#if BRIDGE_FEATURE_DUAL_BUS
+#define SERVO_BUS_COUNT 2 // USART2 + USART3
+#else
+#define SERVO_BUS_COUNT 1 // USART2 only
+#endif
+
+#define SERVO_PACKET_LEN 5
+#define SERVO_BUS_DMA_RX_SIZE 14
+#define SERVO_BUS_RING_SIZE 128
+#define SERVO_BUS_CMD_QUEUE_SIZE 8
+#define SERVO_BUS_MIN_CMD_INTERVAL_MS 5 // Per bus
+
+// ===== FUNCTION PROTOTYPES =====
+
+/**
+ * @brief  Arms DMA ReceiveToIdle on every servo bus.
+ * @retval HAL_OK, or the status of the first bus that failed
+ */
+HAL_StatusTypeDef ServoBus_Start(void);
+
+/**
+ * @brief  Queues a position command on a servo bus.
+ *         Safe to call from the CAN RX interrupt.
+ * @param  bus: 0 = USART2, 1 = USART3 (falls back to USART2 on single-bus
+ *         builds)
+ * @param  servoId: Serial servo ID
+ * @param  position: Target position in servo units
+ * @retval 1 if queued, 0 if that bus's queue is full
+ */
+uint8_t ServoBus_QueueCommand(uint8_t bus, uint8_t servoId, int32_t position);
+
+/**
+ * @brief  Main loop service: forwards parsed feedback to CAN and starts the
+ *         next DMA transmit on every idle bus.
+ */
+void ServoBus_Process(void);
+
+#endif // SERVO_BUS_H
@@ -1,12 +1,51 @@
 #include "can_bridge.h"
 #include "led_manager.h" // For LED effects
+#include "node_config.h"
+#include "servo_bus.h"
 #include "servo_driver.h"
 #include <stdio.h>
+#include <string.h>
+
+volatile BridgeStats bridgeStats = {0};
+
+#if BRIDGE_FEATURE_UART3_MIRROR
+// Must outlive the interrupt-driven transfer
+static uint8_t mirrorBuffer[5];
+#endif
+
+#if BRIDGE_FEATURE_STATS
+static uint32_t lastStatsTick = 0;
+#endif
+
+// ===== CAN RX CALLBACK =====
+// SDOs addressed to the bridge's base configure it; position SDOs for any
+// of its nodes are queued on the servo's bus
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
+  CAN_RxHeaderTypeDef RxHeader;
+  uint8_t RxData[8];
+
+  if (HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &RxHeader, RxData) == HAL_OK) {
+    if (RxHeader.StdId > 0x600 &&
+        RxHeader.StdId <= 0x600 + NODE_CONFIG_MAX_NODE_ID &&
+        RxHeader.DLC == 8) {
+      uint8_t nodeId = RxHeader.StdId - 0x600;
+
+      if (NodeConfig_HandleSdo(nodeId, RxData))
+        return;
+
+      int8_t channel = NodeConfig_ChannelForNode(nodeId);
+      if (channel >= 0)
+        Bridge_ConvertSDOtoSerial(RxData, (uint8_t)channel);
+    }
+  }
+}
 
 /**
- * @brief  Converts incoming CAN SDO (ID 0x601-0x604) to Serial Servo Protocol.
+ * @brief  Converts incoming CAN SDO (0x600 + node) to Serial Servo Protocol.
+ *         The command is queued on the servo's bus; ServoBus_Process() sends
+ *         it from the main loop.
  */
-void Bridge_ConvertSDOtoSerial(uint8_t *canData, uint8_t servoId) {
+void Bridge_ConvertSDOtoSerial(uint8_t *canData, uint8_t channel) {
   if (canData[0] == 0x22 && canData[1] == 0x03 && canData[2] == 0x60) {
     int32_t canValue = (int32_t)canData[4] | ((int32_t)canData[5] << 8) |
                        ((int32_t)canData[6] << 16) |
@@ -14,39 +53,39 @@ void Bridge_ConvertSDOtoSerial(uint8_t *canData, uint8_t servoId) {
 
     int32_t position = (canValue * 4) + SERVO_CENTER_POS;
 
-    uint8_t packet[5];
-    Servo_BuildPacket(servoId, position, packet);
-
-    HAL_UART_Transmit(&huart2, packet, 5, 10);
-
-    blinkServoId = servoId;
+    ServoMapEntry entry = nodeConfig.map[channel];
+    if (!ServoBus_QueueCommand(entry.bus, entry.serialId, position)) {
+      bridgeStats.commandsDropped++;
+    }
   }
 }
 
 /**
  * @brief  Processes received Serial feedback and forwards it to CAN.
  */
-void Bridge_ProcessFeedback(uint8_t *buffer) {
-  feedbackDebugBlink = 1;
-
+void Bridge_ProcessFeedback(uint8_t *buffer, uint8_t bus) {
   uint8_t byte1 = buffer[1];
   uint8_t byte2 = buffer[2];
   uint8_t byte3 = buffer[3];
 
-  uint8_t servoId = byte1 & 0x0F;
-  if (servoId < 1 || servoId > 4)
-    servoId = 1;
+  int8_t channel = NodeConfig_ChannelForServo(bus, byte1 & 0x0F);
+  if (channel < 0) {
+    bridgeStats.feedbackUnmapped++;
+    return;
+  }
 
   uint16_t rawPosition = Servo_ExtractPosition(byte2, byte3);
 
-  if (HAL_CAN_GetTxMailboxesFreeLevel(&hcan1) == 0)
+  if (HAL_CAN_GetTxMailboxesFreeLevel(&hcan1) == 0) {
+    bridgeStats.canTxDropped++;
     return;
+  }
 
   CAN_TxHeaderTypeDef TxHeader;
   uint8_t TxData[8] = {0};
   uint32_t TxMailbox;
 
-  TxHeader.StdId = FEEDBACK_RX_OFFSET + servoId;
+  TxHeader.StdId = FEEDBACK_RX_OFFSET + nodeConfig.nodeBase + channel;
   TxHeader.IDE = CAN_ID_STD;
   TxHeader.RTR = CAN_RTR_DATA;
   TxHeader.DLC = 8;
@@ -54,5 +93,109 @@ void Bridge_ProcessFeedback(uint8_t *buffer) {
   TxData[0] = rawPosition & 0xFF;
   TxData[1] = (rawPosition >> 8) & 0xFF;
 
+#if BRIDGE_FEATURE_STATS
+  // Raw serial bytes + frame counter (phone only parses bytes 0-1)
+  TxData[2] = buffer[0];
+  TxData[3] = byte1;
+  TxData[4] = byte2;
+  TxData[5] = byte3;
+  TxData[6] = feedbackFrameCount & 0xFF;
+  TxData[7] = (feedbackFrameCount >> 8) & 0xFF;
+#endif
+
+  // LED trace flags forwarded frames only
+  if (HAL_CAN_AddTxMessage(&hcan1, &TxHeader, TxData, &TxMailbox) == HAL_OK)
+    feedbackDebugBlink = 1;
+}
+
+#if BRIDGE_FEATURE_UART3_MIRROR
+/**
+ * @brief  Copies a 5-byte servo packet to UART3 without blocking.
+ */
+void Bridge_MirrorCommand(const uint8_t *packet) {
+  if (huart3.gState != HAL_UART_STATE_READY) {
+    bridgeStats.mirrorDropped++;
+    return;
+  }
+
+  memcpy(mirrorBuffer, packet, sizeof(mirrorBuffer));
+  if (HAL_UART_Transmit_IT(&huart3, mirrorBuffer, sizeof(mirrorBuffer)) !=
+      HAL_OK) {
+    bridgeStats.mirrorDropped++;
+  }
+}
+#endif
+
+#if BRIDGE_FEATURE_STATS
+static uint8_t Saturate8(uint32_t value) {
+  return (value > 0xFF) ? 0xFF : (uint8_t)value;
+}
+
+static uint8_t bootReportSent = 0;
+
+static void Bridge_SendBootReport(void) {
+  CAN_TxHeaderTypeDef TxHeader = {0};
+  uint8_t TxData[4];
+  uint32_t TxMailbox;
+
+  TxHeader.StdId = DEBUG_ID;
+  TxHeader.IDE = CAN_ID_STD;
+  TxHeader.RTR = CAN_RTR_DATA;
+  TxHeader.DLC = 4;
+
+  uint32_t ready = bridgeStats.readyTick;
+  uint32_t first = bridgeStats.firstCommandTick;
+  if (ready > 0xFFFF)
+    ready = 0xFFFF;
+  if (first > 0xFFFF)
+    first = 0xFFFF;
+  TxData[0] = ready & 0xFF;
+  TxData[1] = (ready >> 8) & 0xFF;
+  TxData[2] = first & 0xFF;
+  TxData[3] = (first >> 8) & 0xFF;
+
+  if (HAL_CAN_AddTxMessage(&hcan1, &TxHeader, TxData, &TxMailbox) == HAL_OK)
+    bootReportSent = 1;
+}
+
+/**
+ * @brief  Sends the stats frame on DEBUG_ID once per BRIDGE_STATS_PERIOD_MS.
+ */
+void Bridge_SendStats(void) {
+  uint32_t now = HAL_GetTick();
+  if ((now - lastStatsTick) < BRIDGE_STATS_PERIOD_MS)
+    return;
+
+  // Retry on the next pass rather than evicting feedback from the mailboxes
+  if (HAL_CAN_GetTxMailboxesFreeLevel(&hcan1) < 2)
+    return;
+
+  if (!bootReportSent && bridgeStats.commandsForwarded > 0) {
+    Bridge_SendBootReport();
+    return;
+  }
+
+  lastStatsTick = now;
+
+  CAN_TxHeaderTypeDef TxHeader = {0};
+  uint8_t TxData[8];
+  uint32_t TxMailbox;
+
+  TxHeader.StdId = DEBUG_ID;
+  TxHeader.IDE = CAN_ID_STD;
+  TxHeader.RTR = CAN_RTR_DATA;
+  TxHeader.DLC = 8;
+
+  uint32_t forwarded = bridgeStats.commandsForwarded;
+  TxData[0] = feedbackFrameCount & 0xFF;
+  TxData[1] = (feedbackFrameCount >> 8) & 0xFF;
+  TxData[2] = uartRxCount & 0xFF;
+  TxData[3] = (uartRxCount >> 8) & 0xFF;
+  TxData[4] = forwarded & 0xFF;
+  TxData[5] = (forwarded >> 8) & 0xFF;
+  TxData[6] = Saturate8(bridgeStats.commandsDropped);
+  TxData[7] = Saturate8(bridgeStats.canTxDropped + bridgeStats.mirrorDropped);
+
   HAL_CAN_AddTxMessage(&hcan1, &TxHeader, TxData, &TxMailbox);
 }
+#endif
@@ -9,27 +9,148 @@ void LED_OFF(void) { HAL_GPIO_WritePin(LED_GPIO_Port, LED_Pin, GPIO_PIN_SET); }
 
 void LED_Toggle(void) { HAL_GPIO_TogglePin(LED_GPIO_Port, LED_Pin); }
 
-void LED_Blink(uint32_t onTime, uint32_t offTime) {
-  LED_ON();
-  HAL_Delay(onTime);
-  LED_OFF();
-  HAL_Delay(offTime);
+// ===== PATTERN TABLE =====
+// Each step drives the LED to a level for a number of milliseconds.
+// A duration of 0 holds the level until the pattern is changed.
+typedef struct {
+  uint8_t on;
+  uint16_t ms;
+} LedStep;
+
+typedef struct {
+  const LedStep *steps;
+  uint8_t count;
+  uint8_t loop;
+} LedPatternDef;
+
+static const LedStep stepsOff[] = {{0, 0}};
+static const LedStep stepsOn[] = {{1, 0}};
+static const LedStep stepsReady[] = {{1, 100}, {0, 100}, {1, 100}, {0, 100},
+                                     {1, 100}, {0, 100}, {1, 100}, {0, 100},
+                                     {1, 100}, {0, 100}};
+static const LedStep stepsActivity[] = {{0, 30}};
+static const LedStep stepsFeedback[] = {{0, 20}, {1, 20}, {0, 20}, {1, 20}};
+static const LedStep stepsError[] = {{1, 30}, {0, 30}};
+static const LedStep stepsFaultFilter[] = {{1, 50}, {0, 50}};
+static const LedStep stepsFaultCan[] = {{1, 200}, {0, 200}};
+
+#define STEPS(s) (s), (uint8_t)(sizeof(s) / sizeof((s)[0]))
+
+// `loop`: 0 = play once, 1 = forever, N > 1 = play N times
+
+static const LedPatternDef patternTable[LED_PATTERN_COUNT] = {
+    [LED_PATTERN_OFF] = {STEPS(stepsOff), 0},
+    [LED_PATTERN_ON] = {STEPS(stepsOn), 0},
+    [LED_PATTERN_READY] = {STEPS(stepsReady), 0},
+    [LED_PATTERN_ACTIVITY] = {STEPS(stepsActivity), 0},
+    [LED_PATTERN_FEEDBACK] = {STEPS(stepsFeedback), 0},
+    [LED_PATTERN_ERROR] = {STEPS(stepsError), 10},
+    [LED_PATTERN_FAULT_FILTER] = {STEPS(stepsFaultFilter), 1},
+    [LED_PATTERN_FAULT_CAN] = {STEPS(stepsFaultCan), 1},
+};
+
+// ===== ENGINE STATE =====
+// Requests are written by the main loop and consumed by LED_Tick() in
+// SysTick; everything else is owned by the tick.
+#define LED_NO_REQUEST 0xFF
+
+static volatile uint8_t backgroundRequest = LED_NO_REQUEST;
+static volatile uint8_t oneShotRequest = LED_NO_REQUEST;
+
+static uint8_t background = LED_PATTERN_ON;
+static uint8_t active = LED_PATTERN_ON;
+static volatile uint8_t oneShotActive = 0; // Also read by LED_IsPlaying()
+static uint8_t stepIndex = 0;
+static uint8_t passesLeft = 0;
+static uint16_t stepRemaining = 0;
+
+// Main loop only (LED_Pulse)
+static uint32_t lastPulseTick[LED_PATTERN_COUNT];
+
+static void LED_ApplyStep(void) {
+  const LedStep *step = &patternTable[active].steps[stepIndex];
+  if (step->on)
+    LED_ON();
+  else
+    LED_OFF();
+  stepRemaining = step->ms;
+}
+
+static void LED_Start(uint8_t pattern) {
+  active = pattern;
+  stepIndex = 0;
+  passesLeft = patternTable[pattern].loop;
+  LED_ApplyStep();
+}
+
+void LED_SetPattern(LedPattern pattern) {
+  if (pattern < LED_PATTERN_COUNT)
+    backgroundRequest = (uint8_t)pattern;
 }
 
-// ===== DEBUG: Double Flash for Feedback =====
-void LED_FeedbackFlash(void) {
-  LED_OFF();
-  HAL_Delay(20);
-  LED_ON();
-  HAL_Delay(20);
-  LED_OFF();
-  HAL_Delay(20);
-  LED_ON();
-  HAL_Delay(20);
+void LED_Play(LedPattern pattern) {
+  if (pattern < LED_PATTERN_COUNT)
+    oneShotRequest = (uint8_t)pattern;
 }
 
-void LED_SignalError(void) {
-  for (int i = 0; i < 10; i++) {
-    LED_Blink(30, 30);
+uint8_t LED_IsPlaying(void) {
+  return oneShotActive || oneShotRequest != LED_NO_REQUEST;
+}
+
+uint8_t LED_Pulse(LedPattern pattern) {
+  uint32_t now = HAL_GetTick();
+  if (pattern >= LED_PATTERN_COUNT || LED_IsPlaying() ||
+      (now - lastPulseTick[pattern]) < LED_PULSE_PERIOD_MS)
+    return 0;
+  lastPulseTick[pattern] = now;
+  LED_Play(pattern);
+  return 1;
+}
+
+void LED_Tick(void) {
+  if (oneShotRequest != LED_NO_REQUEST) {
+    uint8_t pattern = oneShotRequest;
+    oneShotRequest = LED_NO_REQUEST;
+    oneShotActive = 1;
+    LED_Start(pattern);
+    return;
+  }
+
+  if (backgroundRequest != LED_NO_REQUEST) {
+    background = backgroundRequest;
+    backgroundRequest = LED_NO_REQUEST;
+    if (!oneShotActive) {
+      LED_Start(background);
+      return;
+    }
+  }
+
+  // Hold step (or nothing running)
+  if (stepRemaining == 0)
+    return;
+  if (--stepRemaining > 0)
+    return;
+
+  const LedPatternDef *def = &patternTable[active];
+  if (++stepIndex < def->count) {
+    LED_ApplyStep();
+    return;
+  }
+
+  // End of pattern
+  stepIndex = 0;
+  if (def->loop == 1) {
+    LED_ApplyStep();
+  } else if (passesLeft > 1) {
+    passesLeft--;
+    LED_ApplyStep();
+  } else if (oneShotActive) {
+    oneShotActive = 0;
+    LED_Start(background);
   }
 }
+
+// ===== CONVENIENCE WRAPPERS =====
+void LED_FeedbackFlash(void) { LED_Pulse(LED_PATTERN_FEEDBACK); }
+
+void LED_SignalError(void) { LED_Play(LED_PATTERN_ERROR); }
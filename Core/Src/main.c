@@ -4,6 +4,8 @@
  * @file           : main.c
  * @brief          : Smart CAN-to-Serial Bridge (MODULAR VERSION)
  ******************************************************************************
+ * Build profile (RELEASE / DEBUG) is selected in bridge_config.h.
+ ******************************************************************************
  */
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
@@ -11,8 +13,11 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "bridge_config.h"
 #include "can_bridge.h"
 #include "led_manager.h"
+#include "node_config.h"
+#include "servo_bus.h"
 #include "servo_driver.h"
 #include <stdio.h>
 #include <string.h>
@@ -40,27 +45,15 @@ UART_HandleTypeDef huart3;
 
 DMA_HandleTypeDef hdma_usart2_rx;
 
-#define DMA_RX_BUFFER_SIZE 14
-uint8_t dmaRxBuffer[DMA_RX_BUFFER_SIZE] = {0};
-uint8_t feedbackBuffer[FEEDBACK_FRAME_LEN + 1] = {0};
-volatile uint8_t feedbackReady = 0;
+/* USER CODE BEGIN PV */
+DMA_HandleTypeDef hdma_usart2_tx;
+#if BRIDGE_FEATURE_DUAL_BUS
+DMA_HandleTypeDef hdma_usart3_rx;
+DMA_HandleTypeDef hdma_usart3_tx;
+#endif
+
 volatile uint8_t blinkServoId = 0;
 volatile uint8_t feedbackDebugBlink = 0;
-
-volatile uint32_t uartRxCount = 0;
-volatile uint32_t feedbackFrameCount = 0;
-
-#define CMD_QUEUE_SIZE 8
-typedef struct {
-  uint8_t servoId;
-  int32_t position;
-} ServoCommand;
-static volatile ServoCommand cmdQueue[CMD_QUEUE_SIZE];
-static volatile uint8_t cmdQueueHead = 0;
-static volatile uint8_t cmdQueueTail = 0;
-
-static uint32_t lastCmdTick = 0;
-#define MIN_CMD_INTERVAL_MS 5
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -75,82 +68,8 @@ static void MX_USART3_UART_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-// ===== DMA RX EVENT CALLBACK (Robust Circular Buffer) =====
-#define RX_BUFFER_SIZE 128
-static uint8_t rxRingBuffer[RX_BUFFER_SIZE];
-static uint16_t rxRingHead = 0;
-static uint16_t rxRingTail = 0;
-
-void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
-  if (huart->Instance == USART2) {
-    uartRxCount++;
-
-    for (uint16_t i = 0; i < Size; i++) {
-      rxRingBuffer[rxRingHead] = dmaRxBuffer[i];
-      rxRingHead = (rxRingHead + 1) % RX_BUFFER_SIZE;
-    }
-
-    while (1) {
-      uint16_t available = (rxRingHead >= rxRingTail)
-                               ? (rxRingHead - rxRingTail)
-                               : (RX_BUFFER_SIZE - rxRingTail + rxRingHead);
-
-      if (available < FEEDBACK_FRAME_LEN)
-        break;
-
-      uint8_t syncByte = rxRingBuffer[rxRingTail];
-
-      if ((syncByte & 0x80) == 0x80) {
-        uint8_t tempFrame[FEEDBACK_FRAME_LEN];
-        for (int k = 0; k < FEEDBACK_FRAME_LEN; k++) {
-          tempFrame[k] = rxRingBuffer[(rxRingTail + k) % RX_BUFFER_SIZE];
-        }
-
-        for (int k = 0; k < FEEDBACK_FRAME_LEN; k++) {
-          feedbackBuffer[k] = tempFrame[k];
-        }
-
-        feedbackFrameCount++;
-        feedbackReady = 1;
-
-        rxRingTail = (rxRingTail + FEEDBACK_FRAME_LEN) % RX_BUFFER_SIZE;
-
-      } else {
-        rxRingTail = (rxRingTail + 1) % RX_BUFFER_SIZE;
-      }
-    }
-
-    HAL_UARTEx_ReceiveToIdle_DMA(&huart2, dmaRxBuffer, DMA_RX_BUFFER_SIZE);
-    __HAL_DMA_DISABLE_IT(&hdma_usart2_rx, DMA_IT_HT);
-  }
-}
-
-// ===== CAN RX CALLBACK =====
-void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) {
-  CAN_RxHeaderTypeDef RxHeader;
-  uint8_t RxData[8];
-
-  if (HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO0, &RxHeader, RxData) == HAL_OK) {
-    if (RxHeader.StdId >= 0x601 && RxHeader.StdId <= 0x604 &&
-        RxHeader.DLC == 8) {
-      uint8_t servoId = RxHeader.StdId - 0x600;
-
-      if (RxData[0] == 0x22 && RxData[1] == 0x03 && RxData[2] == 0x60) {
-        int32_t canValue = (int32_t)RxData[4] | ((int32_t)RxData[5] << 8) |
-                           ((int32_t)RxData[6] << 16) |
-                           ((int32_t)RxData[7] << 24);
-        int32_t position = (canValue * 4) + SERVO_CENTER_POS;
-
-        uint8_t nextHead = (cmdQueueHead + 1) % CMD_QUEUE_SIZE;
-        if (nextHead != cmdQueueTail) {
-          cmdQueue[cmdQueueHead].servoId = servoId;
-          cmdQueue[cmdQueueHead].position = position;
-          cmdQueueHead = nextHead;
-        }
-      }
-    }
-  }
-}
+// Servo UART RX/TX callbacks live in servo_bus.c, the CAN RX callback in
+// can_bridge.c
 
 /* USER CODE END 0 */
 
@@ -189,7 +108,27 @@ int main(void) {
   MX_USART3_UART_Init();
 
   /* USER CODE BEGIN 2 */
-  LED_Blink(200, 200);
+  // Fast boot: bring the servo UART and CAN up before any status indication.
+  // All LED patterns run from SysTick (LED_Tick), nothing here waits on them.
+
+  // Restore NVIC Enable (Required for UART and DMA to work!)
+  HAL_NVIC_EnableIRQ(USART2_IRQn);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+  HAL_NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  HAL_NVIC_EnableIRQ(CAN1_RX0_IRQn);
+#if BRIDGE_FEATURE_DUAL_BUS
+  HAL_NVIC_EnableIRQ(USART3_IRQn);
+  HAL_NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+  HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+#endif
+
+  // Node-ID base and servo map (flash, or defaults: nodes 1-4)
+  NodeConfig_Load();
+
+  // Start servo UART DMA RX with IDLE detection (every bus)
+  if (ServoBus_Start() != HAL_OK) {
+    Error_Handler();
+  }
 
   // CAN Filter - Allow Everything
   CAN_FilterTypeDef canfilterconfig = {0};
@@ -202,70 +141,51 @@ int main(void) {
   canfilterconfig.FilterScale = CAN_FILTERSCALE_32BIT;
 
   if (HAL_CAN_ConfigFilter(&hcan1, &canfilterconfig) != HAL_OK) {
+    LED_SetPattern(LED_PATTERN_FAULT_FILTER);
     while (1) {
-      LED_Blink(50, 50);
     }
   }
 
   if (HAL_CAN_Start(&hcan1) != HAL_OK) {
+    LED_SetPattern(LED_PATTERN_FAULT_CAN);
     while (1) {
-      LED_Blink(200, 200);
     }
   }
 
   HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING);
+  bridgeStats.readyTick = HAL_GetTick();
 
-  // READY SIGNAL: 5 Quick Blinks
-  for (int i = 0; i < 5; i++) {
-    LED_Blink(100, 100);
-  }
-
-  // Restore NVIC Enable (Required for UART and DMA to work!)
-  HAL_NVIC_EnableIRQ(USART2_IRQn);
-  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
-  HAL_NVIC_EnableIRQ(CAN1_RX0_IRQn);
-
-  // Start UART2 DMA RX with IDLE detection
-  if (HAL_UARTEx_ReceiveToIdle_DMA(&huart2, dmaRxBuffer, DMA_RX_BUFFER_SIZE) !=
-      HAL_OK) {
-    Error_Handler();
-  }
-  __HAL_DMA_DISABLE_IT(&hdma_usart2_rx, DMA_IT_HT); // Disable half-transfer
-
-  // LED Steady ON = System Ready
-  LED_ON();
+  // READY SIGNAL: 5 quick blinks, then LED steady ON = System Ready
+  LED_SetPattern(LED_PATTERN_ON);
+  LED_Play(LED_PATTERN_READY);
 
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1) {
-    if (cmdQueueTail != cmdQueueHead) {
-      uint32_t now = HAL_GetTick();
-      if ((now - lastCmdTick) >= MIN_CMD_INTERVAL_MS) {
-        lastCmdTick = now;
-        uint8_t sid = cmdQueue[cmdQueueTail].servoId;
-        int32_t pos = cmdQueue[cmdQueueTail].position;
-        cmdQueueTail = (cmdQueueTail + 1) % CMD_QUEUE_SIZE;
-
-        uint8_t packet[5];
-        Servo_BuildPacket(sid, pos, packet);
-        HAL_UART_Transmit(&huart2, packet, 5, 10);
-
-        blinkServoId = sid;
-      }
-    }
-
-    if (feedbackReady) {
-      Bridge_ProcessFeedback(feedbackBuffer);
-      feedbackReady = 0;
-    }
+    ServoBus_Process();
+    NodeConfig_Process();
 
+    // Pulses never restart a running one-shot: under steady traffic that
+    // held the LED in the pattern for good. Each pattern has its own
+    // period, so activity and feedback pulses take turns
     if (blinkServoId > 0) {
-      LED_Toggle();
+      LED_Pulse(LED_PATTERN_ACTIVITY);
       blinkServoId = 0;
     }
 
+#if BRIDGE_FEATURE_LED_TRACE
+    if (feedbackDebugBlink) {
+      LED_FeedbackFlash();
+    }
+#endif
+    feedbackDebugBlink = 0;
+
+#if BRIDGE_FEATURE_STATS
+    Bridge_SendStats();
+#endif
+
     uint32_t canError = HAL_CAN_GetError(&hcan1);
     if (canError != HAL_CAN_ERROR_NONE) {
       HAL_CAN_ResetError(&hcan1);
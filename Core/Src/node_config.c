@@ -0,0 +1,206 @@
+#include "node_config.h"
+#include "bridge_config.h"
+#include "servo_bus.h"
+#include <string.h>
+
+// ===== FLASH LAYOUT =====
+// Last 2 KB page of the L431CC, removed from FLASH in the linker script.
+#define NODE_CONFIG_FLASH_ADDR 0x0803F800UL
+#define NODE_CONFIG_FLASH_PAGE 127
+#define NODE_CONFIG_MAGIC 0x4746434EUL // "NCFG"
+
+#define SDO_SIGNATURE_SAVE 0x65766173UL // "save"
+#define SDO_SIGNATURE_LOAD 0x64616F6CUL // "load"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t checksum;
+  NodeConfig config;
+} NodeConfigRecord;
+
+// Flash is programmed in 64-bit double words
+typedef union {
+  NodeConfigRecord record;
+  uint64_t words[(sizeof(NodeConfigRecord) + 7) / 8];
+} NodeConfigImage;
+
+volatile NodeConfig nodeConfig;
+
+// SDO writes land in `staged` (CAN RX interrupt) and go live in
+// NodeConfig_Process() with interrupts masked, so neither the main loop
+// nor the interrupt ever sees a half-copied base / count / map
+static NodeConfig staged;
+static volatile uint8_t stagedPending = 0;
+static volatile uint8_t savePending = 0;
+
+static uint32_t NodeConfig_Checksum(const NodeConfig *config) {
+  // FNV-1a over the config bytes
+  const uint8_t *bytes = (const uint8_t *)config;
+  uint32_t hash = 2166136261UL;
+  for (uint32_t i = 0; i < sizeof(NodeConfig); i++) {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+static uint8_t NodeConfig_IsValid(const NodeConfig *config) {
+  if (config->nodeBase < 1 || config->servoCount < 1 ||
+      config->servoCount > NODE_CONFIG_MAX_SERVOS)
+    return 0;
+  if (config->nodeBase + config->servoCount - 1 > NODE_CONFIG_MAX_NODE_ID)
+    return 0;
+  for (int i = 0; i < config->servoCount; i++) {
+    if (config->map[i].serialId < 1 ||
+        config->map[i].serialId > NODE_CONFIG_MAX_SERIAL_ID ||
+        config->map[i].bus >= SERVO_BUS_COUNT) // Bus 1 only when built in
+      return 0;
+  }
+  return 1;
+}
+
+static void NodeConfig_SetDefaults(NodeConfig *config) {
+  memset(config, 0, sizeof(*config));
+  config->nodeBase = 1;
+  config->servoCount = 4;
+  for (int i = 0; i < config->servoCount; i++) {
+    config->map[i].serialId = i + 1;
+#if BRIDGE_FEATURE_DUAL_BUS
+    config->map[i].bus = (i + 1 >= BRIDGE_BUS2_FIRST_SERVO) ? 1 : 0;
+#endif
+  }
+}
+
+void NodeConfig_Load(void) {
+  const NodeConfigRecord *stored =
+      (const NodeConfigRecord *)NODE_CONFIG_FLASH_ADDR;
+
+  if (stored->magic == NODE_CONFIG_MAGIC &&
+      stored->checksum == NodeConfig_Checksum(&stored->config) &&
+      NodeConfig_IsValid(&stored->config)) {
+    memcpy((void *)&nodeConfig, &stored->config, sizeof(NodeConfig));
+  } else {
+    NodeConfig config;
+    NodeConfig_SetDefaults(&config);
+    memcpy((void *)&nodeConfig, &config, sizeof(config));
+  }
+}
+
+static HAL_StatusTypeDef NodeConfig_Save(void) {
+  NodeConfigImage image;
+  memset(&image, 0xFF, sizeof(image));
+  image.record.magic = NODE_CONFIG_MAGIC;
+  memcpy(&image.record.config, (const void *)&nodeConfig, sizeof(NodeConfig));
+  image.record.checksum = NodeConfig_Checksum(&image.record.config);
+
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+  FLASH_EraseInitTypeDef erase = {0};
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.Banks = FLASH_BANK_1;
+  erase.Page = NODE_CONFIG_FLASH_PAGE;
+  erase.NbPages = 1;
+
+  uint32_t pageError = 0;
+  HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &pageError);
+
+  for (uint32_t i = 0;
+       status == HAL_OK && i < sizeof(image.words) / sizeof(image.words[0]);
+       i++) {
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                               NODE_CONFIG_FLASH_ADDR + i * 8, image.words[i]);
+  }
+
+  HAL_FLASH_Lock();
+  return status;
+}
+
+uint8_t NodeConfig_HandleSdo(uint8_t nodeId, const uint8_t *data) {
+  // Writes not applied yet build on each other
+  const NodeConfig *effective =
+      stagedPending ? &staged : (const NodeConfig *)&nodeConfig;
+  if (nodeId != effective->nodeBase)
+    return 0;
+
+  // Expedited download (0x22, or 0x23/0x27/0x2B/0x2F with size indicated)
+  if ((data[0] & 0xF0) != 0x20)
+    return 0;
+
+  uint16_t index = (uint16_t)data[1] | ((uint16_t)data[2] << 8);
+  uint8_t sub = data[3];
+  uint32_t value = (uint32_t)data[4] | ((uint32_t)data[5] << 8) |
+                   ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+
+  if (index == NODE_CONFIG_SDO_STORE && sub == 0x01) {
+    if (value == SDO_SIGNATURE_SAVE)
+      savePending = 1;
+    return 1;
+  }
+
+  if (index == NODE_CONFIG_SDO_RESTORE && sub == 0x01) {
+    if (value == SDO_SIGNATURE_LOAD) {
+      NodeConfig_SetDefaults(&staged);
+      stagedPending = 1;
+      savePending = 1;
+    }
+    return 1;
+  }
+
+  if (index != NODE_CONFIG_SDO_INDEX)
+    return 0;
+
+  // Validate against a copy so a bad write never leaves a broken map live
+  NodeConfig candidate;
+  memcpy(&candidate, effective, sizeof(candidate));
+
+  if (sub == NODE_CONFIG_SDO_SUB_BASE) {
+    candidate.nodeBase = (uint8_t)value;
+  } else if (sub == NODE_CONFIG_SDO_SUB_COUNT) {
+    candidate.servoCount = (uint8_t)value;
+  } else if (sub >= NODE_CONFIG_SDO_SUB_MAP &&
+             sub < NODE_CONFIG_SDO_SUB_MAP + NODE_CONFIG_MAX_SERVOS) {
+    ServoMapEntry *entry = &candidate.map[sub - NODE_CONFIG_SDO_SUB_MAP];
+    entry->serialId = value & 0x0F;
+    entry->bus = (value >> 4) & 0x01;
+  }
+
+  if (NodeConfig_IsValid(&candidate)) {
+    memcpy(&staged, &candidate, sizeof(candidate));
+    stagedPending = 1;
+  }
+
+  return 1;
+}
+
+void NodeConfig_Process(void) {
+  if (stagedPending) {
+    __disable_irq();
+    memcpy((void *)&nodeConfig, &staged, sizeof(staged));
+    stagedPending = 0;
+    __enable_irq();
+  }
+
+  if (!savePending)
+    return;
+  savePending = 0;
+
+  // Erase stalls the CPU (~22 ms); commands arriving meanwhile may be lost
+  NodeConfig_Save();
+}
+
+int8_t NodeConfig_ChannelForNode(uint8_t nodeId) {
+  uint8_t base = nodeConfig.nodeBase;
+  if (nodeId < base || nodeId >= base + nodeConfig.servoCount)
+    return -1;
+  return (int8_t)(nodeId - base);
+}
+
+int8_t NodeConfig_ChannelForServo(uint8_t bus, uint8_t serialId) {
+  for (int i = 0; i < nodeConfig.servoCount; i++) {
+    if (nodeConfig.map[i].serialId == serialId &&
+        nodeConfig.map[i].bus == bus)
+      return (int8_t)i;
+  }
+  return -1;
+}
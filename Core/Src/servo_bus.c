@@ -0,0 +1,186 @@
+#include "servo_bus.h"
+#include "can_bridge.h"
+#include "servo_driver.h"
+
+// ===== BUS STATE =====
+typedef struct {
+  uint8_t servoId;
+  int32_t position;
+} ServoCommand;
+
+typedef struct {
+  UART_HandleTypeDef *huart;
+  DMA_HandleTypeDef *hdmaRx;
+
+  // RX: DMA ReceiveToIdle -> ring -> 7-byte frame parser
+  uint8_t dmaRxBuffer[SERVO_BUS_DMA_RX_SIZE];
+  uint8_t rxRing[SERVO_BUS_RING_SIZE];
+  uint16_t rxHead;
+  uint16_t rxTail;
+  uint8_t feedback[FEEDBACK_FRAME_LEN + 1];
+  volatile uint8_t feedbackReady;
+
+  // TX: command queue (CAN ISR) -> DMA transmit (main loop)
+  volatile ServoCommand cmdQueue[SERVO_BUS_CMD_QUEUE_SIZE];
+  volatile uint8_t cmdHead;
+  volatile uint8_t cmdTail;
+  uint8_t txPacket[SERVO_PACKET_LEN]; // Must outlive the DMA transfer
+  volatile uint8_t txBusy;
+  uint32_t lastCmdTick;
+} ServoBus;
+
+static ServoBus buses[SERVO_BUS_COUNT] = {
+    {.huart = &huart2, .hdmaRx = &hdma_usart2_rx},
+#if BRIDGE_FEATURE_DUAL_BUS
+    {.huart = &huart3, .hdmaRx = &hdma_usart3_rx},
+#endif
+};
+
+volatile uint32_t uartRxCount = 0;
+volatile uint32_t feedbackFrameCount = 0;
+
+static ServoBus *ServoBus_ForUart(UART_HandleTypeDef *huart) {
+  for (int i = 0; i < SERVO_BUS_COUNT; i++) {
+    if (buses[i].huart == huart)
+      return &buses[i];
+  }
+  return NULL;
+}
+
+static HAL_StatusTypeDef ServoBus_ArmRx(ServoBus *bus) {
+  HAL_StatusTypeDef status = HAL_UARTEx_ReceiveToIdle_DMA(
+      bus->huart, bus->dmaRxBuffer, SERVO_BUS_DMA_RX_SIZE);
+  __HAL_DMA_DISABLE_IT(bus->hdmaRx, DMA_IT_HT); // Disable half-transfer
+  return status;
+}
+
+HAL_StatusTypeDef ServoBus_Start(void) {
+  for (int i = 0; i < SERVO_BUS_COUNT; i++) {
+    HAL_StatusTypeDef status = ServoBus_ArmRx(&buses[i]);
+    if (status != HAL_OK)
+      return status;
+  }
+  return HAL_OK;
+}
+
+uint8_t ServoBus_QueueCommand(uint8_t busIndex, uint8_t servoId,
+                              int32_t position) {
+  ServoBus *bus = &buses[(busIndex < SERVO_BUS_COUNT) ? busIndex : 0];
+
+  uint8_t nextHead = (bus->cmdHead + 1) % SERVO_BUS_CMD_QUEUE_SIZE;
+  if (nextHead == bus->cmdTail)
+    return 0;
+
+  bus->cmdQueue[bus->cmdHead].servoId = servoId;
+  bus->cmdQueue[bus->cmdHead].position = position;
+  bus->cmdHead = nextHead;
+  return 1;
+}
+
+static void ServoBus_Transmit(ServoBus *bus) {
+  if (bus->cmdTail == bus->cmdHead || bus->txBusy)
+    return;
+
+  uint32_t now = HAL_GetTick();
+  if ((now - bus->lastCmdTick) < SERVO_BUS_MIN_CMD_INTERVAL_MS)
+    return;
+  bus->lastCmdTick = now;
+
+  uint8_t sid = bus->cmdQueue[bus->cmdTail].servoId;
+  int32_t pos = bus->cmdQueue[bus->cmdTail].position;
+  bus->cmdTail = (bus->cmdTail + 1) % SERVO_BUS_CMD_QUEUE_SIZE;
+
+  Servo_BuildPacket(sid, pos, bus->txPacket);
+
+  bus->txBusy = 1;
+  if (HAL_UART_Transmit_DMA(bus->huart, bus->txPacket, SERVO_PACKET_LEN) !=
+      HAL_OK) {
+    bus->txBusy = 0;
+    bridgeStats.commandsDropped++;
+    return;
+  }
+
+  if (bridgeStats.commandsForwarded++ == 0)
+    bridgeStats.firstCommandTick = now;
+
+#if BRIDGE_FEATURE_UART3_MIRROR
+  Bridge_MirrorCommand(bus->txPacket);
+#endif
+
+  blinkServoId = sid;
+}
+
+void ServoBus_Process(void) {
+  for (int i = 0; i < SERVO_BUS_COUNT; i++) {
+    ServoBus *bus = &buses[i];
+
+    if (bus->feedbackReady) {
+      Bridge_ProcessFeedback(bus->feedback, (uint8_t)i);
+      bus->feedbackReady = 0;
+    }
+
+    ServoBus_Transmit(bus);
+  }
+}
+
+// ===== DMA RX EVENT CALLBACK (Robust Circular Buffer) =====
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size) {
+  ServoBus *bus = ServoBus_ForUart(huart);
+  if (bus == NULL)
+    return;
+
+  uartRxCount++;
+
+  for (uint16_t i = 0; i < Size; i++) {
+    bus->rxRing[bus->rxHead] = bus->dmaRxBuffer[i];
+    bus->rxHead = (bus->rxHead + 1) % SERVO_BUS_RING_SIZE;
+  }
+
+  while (1) {
+    uint16_t available =
+        (bus->rxHead >= bus->rxTail)
+            ? (bus->rxHead - bus->rxTail)
+            : (SERVO_BUS_RING_SIZE - bus->rxTail + bus->rxHead);
+
+    if (available < FEEDBACK_FRAME_LEN)
+      break;
+
+    uint8_t syncByte = bus->rxRing[bus->rxTail];
+
+    if ((syncByte & 0x80) == 0x80) {
+      for (int k = 0; k < FEEDBACK_FRAME_LEN; k++) {
+        bus->feedback[k] =
+            bus->rxRing[(bus->rxTail + k) % SERVO_BUS_RING_SIZE];
+      }
+
+      feedbackFrameCount++;
+      bus->feedbackReady = 1;
+
+      bus->rxTail = (bus->rxTail + FEEDBACK_FRAME_LEN) % SERVO_BUS_RING_SIZE;
+
+    } else {
+      bus->rxTail = (bus->rxTail + 1) % SERVO_BUS_RING_SIZE;
+    }
+  }
+
+  ServoBus_ArmRx(bus);
+}
+
+// ===== DMA TX COMPLETE / ERROR CALLBACKS =====
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+  ServoBus *bus = ServoBus_ForUart(huart);
+  if (bus != NULL)
+    bus->txBusy = 0;
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+  ServoBus *bus = ServoBus_ForUart(huart);
+  if (bus == NULL)
+    return;
+
+  // A failed transfer never reaches TxCplt; free the bus and restart RX
+  if (huart->gState == HAL_UART_STATE_READY)
+    bus->txBusy = 0;
+  if (huart->RxState == HAL_UART_STATE_READY)
+    ServoBus_ArmRx(bus);
+}
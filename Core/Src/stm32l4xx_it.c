@@ -23,6 +23,8 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "bridge_config.h"
+#include "led_manager.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -174,6 +176,7 @@ void SysTick_Handler(void) {
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  LED_Tick();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -195,11 +198,22 @@ void CAN1_RX0_IRQHandler(void) { HAL_CAN_IRQHandler(&hcan1); }
 extern UART_HandleTypeDef huart2;
 void USART2_IRQHandler(void) { HAL_UART_IRQHandler(&huart2); }
 
-// USART3 Interrupt Handler (Debug/Backup)
+// USART3 Interrupt Handler (Second servo bus, or Debug/Backup)
 extern UART_HandleTypeDef huart3;
 void USART3_IRQHandler(void) { HAL_UART_IRQHandler(&huart3); }
 
 // DMA1 Channel6 Interrupt Handler (USART2 RX DMA)
 void DMA1_Channel6_IRQHandler(void) { HAL_DMA_IRQHandler(&hdma_usart2_rx); }
 
+// DMA1 Channel7 Interrupt Handler (USART2 TX DMA)
+void DMA1_Channel7_IRQHandler(void) { HAL_DMA_IRQHandler(&hdma_usart2_tx); }
+
+#if BRIDGE_FEATURE_DUAL_BUS
+// DMA1 Channel3 Interrupt Handler (USART3 RX DMA)
+void DMA1_Channel3_IRQHandler(void) { HAL_DMA_IRQHandler(&hdma_usart3_rx); }
+
+// DMA1 Channel2 Interrupt Handler (USART3 TX DMA)
+void DMA1_Channel2_IRQHandler(void) { HAL_DMA_IRQHandler(&hdma_usart3_tx); }
+#endif
+
 /* USER CODE END 1 */